@@ -0,0 +1,374 @@
+/*
+ * CC3PerformanceBenchmark.h
+ *
+ * Cocos3D 2.0.2
+ * Author: Bill Hollings
+ * Copyright (c) 2010-2014 The Brenwill Workshop Ltd. All rights reserved.
+ * http://www.brenwill.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+
+
+#import "CC3PerformanceScene.h"
+
+
+/** The default number of frames that each benchmark scenario is stepped through. */
+#define kCC3BenchmarkDefaultFrameCount		300
+
+/** The number of frames stepped before measurement begins, to allow the scene to reach a steady state. */
+#define kCC3BenchmarkWarmUpFrameCount		5
+
+/** The default fixed interval, in seconds, between the frames of a benchmark scenario. */
+#define kCC3BenchmarkDefaultDeltaTime		(1.0 / 60.0)
+
+/** The seed of the random numbers drawn while each benchmark scenario is run. */
+#define kCC3BenchmarkRandomSeed				1
+
+/** The size, in pixels, of the off-screen surface that benchmark scenarios are rendered to. */
+#define kCC3BenchmarkSurfaceSize			CC3IntSizeMake(1024, 768)
+
+/** The number of distinct random matrices multiplied by the matrix benchmark. */
+#define kCC3BenchmarkMatrixCount			64
+
+/** The number of matrix multiplications timed by the matrix benchmark, for each implementation. */
+#define kCC3BenchmarkMatrixIterations		1000000
+
+/** The POD file loaded by the POD loading benchmark, unless another file is named in the launch arguments. */
+#define kCC3BenchmarkPODFile				@"Dragon.pod"
+
+/** The number of times the POD loading benchmark loads the POD file, in each loading mode. */
+#define kCC3BenchmarkPODLoadIterations		5
+
+/** The interval, in microseconds, at which resident memory is sampled while a POD file is loaded. */
+#define kCC3BenchmarkMemorySampleInterval	500
+
+/** The number of animation tracks in the CAF file loaded by the CAF loading benchmark. */
+#define kCC3BenchmarkCAFTrackCount			1000
+
+/** The number of keyframes in each track of the CAF file loaded by the CAF loading benchmark. */
+#define kCC3BenchmarkCAFKeyframeCount		100
+
+/** The number of times the CAF loading benchmark loads the CAF file, with each implementation. */
+#define kCC3BenchmarkCAFLoadIterations		5
+
+/** The width and height, in pixels, of the textures decompressed by the texture decompression benchmark. */
+#define kCC3BenchmarkDecompressSize			1024
+
+/** The number of times the texture decompression benchmark decompresses each texture, in each mode. */
+#define kCC3BenchmarkDecompressIterations	10
+
+/** The width and height, in pixels, of the textures converted and flipped by the texture conversion benchmark. */
+#define kCC3BenchmarkTextureSize			2048
+
+/** The number of times the texture conversion benchmark converts and flips each texture, in each implementation. */
+#define kCC3BenchmarkTextureIterations		5
+
+
+#pragma mark -
+#pragma mark CC3BenchmarkScenario
+
+/**
+ * CC3BenchmarkScenario describes a single parameterized CC3PerformanceScene configuration
+ * to be stepped through by a CC3PerformanceBenchmark.
+ */
+@interface CC3BenchmarkScenario : NSObject {
+	NSString* _name;
+	NSString* _templateName;
+	GLuint _perSideCount;
+	GLuint _frameCount;
+	CCTime _deltaTime;
+	BOOL _shouldAnimateNodes : 1;
+	BOOL _shouldCastShadows : 1;
+	BOOL _shouldBeAllocationFree : 1;
+}
+
+/** The name of this scenario, as used to select it, and to identify it in the results. */
+@property(nonatomic, strong) NSString* name;
+
+/**
+ * The name of the template node in the availableTemplateNodes property of the
+ * CC3PerformanceScene, from which the copies in the node grid are made.
+ */
+@property(nonatomic, strong) NSString* templateName;
+
+/** The number of template node copies per side of the square node grid. */
+@property(nonatomic, assign) GLuint perSideCount;
+
+/** Indicates whether the node copies are animated. */
+@property(nonatomic, assign) BOOL shouldAnimateNodes;
+
+/** Indicates whether the node copies cast shadows using shadow volumes. */
+@property(nonatomic, assign) BOOL shouldCastShadows;
+
+/**
+ * Indicates whether the frames of this scenario are expected to make no memory allocations,
+ * once the warm-up frames have been stepped through.
+ *
+ * This is an expectation to be verified, not a guarantee. It is only checked when the benchmark
+ * is run with allocation tracking on a platform that supports counting allocations.
+ *
+ * When the benchmark is tracking allocations, a scenario with this property set to YES fails
+ * if any of its measured frames allocates memory. See the shouldTrackAllocations property of
+ * CC3PerformanceBenchmark.
+ *
+ * The initial value of this property is NO.
+ */
+@property(nonatomic, assign) BOOL shouldBeAllocationFree;
+
+/**
+ * The number of frames to step this scenario through.
+ *
+ * The initial value of this property is kCC3BenchmarkDefaultFrameCount.
+ */
+@property(nonatomic, assign) GLuint frameCount;
+
+/**
+ * The fixed interval, in seconds, used for each update of the scene.
+ *
+ * The initial value of this property is kCC3BenchmarkDefaultDeltaTime.
+ */
+@property(nonatomic, assign) CCTime deltaTime;
+
+/** Returns a dictionary of the parameters of this scenario, suitable for serializing to JSON. */
+@property(nonatomic, readonly) NSDictionary* parameters;
+
+
+#pragma mark Allocation and initialization
+
+/** Initializes this instance with the specified name, template node name and grid size. */
+-(instancetype) initWithName: (NSString*) name
+				fromTemplate: (NSString*) templateName
+					 perSide: (GLuint) perSideCount;
+
+/** Allocates and initializes an instance with the specified name, template node name and grid size. */
++(instancetype) scenarioWithName: (NSString*) name
+					fromTemplate: (NSString*) templateName
+						 perSide: (GLuint) perSideCount;
+
+/**
+ * Returns the standard collection of scenarios, covering node grids of several sizes,
+ * crowds of vertex-skinned characters, storms of point particles, and shadow-heavy scenes.
+ */
++(NSArray*) standardScenarios;
+
+@end
+
+
+#pragma mark -
+#pragma mark CC3PerformanceBenchmark
+
+/**
+ * CC3PerformanceBenchmark runs CC3PerformanceScene scenarios without a view, stepping each
+ * scene through a fixed number of frames with a fixed update interval, and collecting
+ * machine-readable results, including the per-phase timings from CC3PerformanceStatistics,
+ * node and draw call counts, the memory held by the content of the scene, and the growth
+ * in the number of live objects.
+ *
+ * Rendering is directed to an off-screen surface, and the GL engine is replaced by
+ * CC3OpenGLNull, so that the results measure the CPU cost of the Cocos3D framework itself,
+ * independent of any GPU or driver. Because no frames are displayed, the results are not
+ * throttled by the display refresh rate.
+ *
+ * Runs are deterministic. Random numbers, including those used by particle emitters, are
+ * seeded with kCC3BenchmarkRandomSeed at the start of each scenario.
+ */
+@interface CC3PerformanceBenchmark : NSObject {
+	CC3PerformanceScene* _scene;
+	BOOL _shouldTrackAllocations : 1;
+}
+
+/**
+ * Indicates whether the memory allocations made during each frame are counted, and included
+ * in the results, both per frame and per performance phase.
+ *
+ * Counting allocations requires that CC3_ALLOCATION_TRACKING_ENABLED is enabled, which it is
+ * by default in debug builds, and a platform whose memory allocator supports counting, currently
+ * iOS and OSX. If allocations cannot be counted, scenarios that are expected to be
+ * allocation-free do not succeed. See the didScenarioSucceed: method.
+ *
+ * Because counting allocations adds a small cost to each allocation, frame timings measured
+ * while tracking allocations should not be compared with those measured without tracking.
+ *
+ * The initial value of this property is NO.
+ */
+@property(nonatomic, assign) BOOL shouldTrackAllocations;
+
+/**
+ * Returns whether the specified results, as returned by the runScenario: method, show that the
+ * scenario met its expectations.
+ *
+ * If the shouldTrackAllocations property was set to YES when the scenario was run, and the scenario
+ * is expected to be allocation-free, returns NO if memory was allocated during any measured frame.
+ * Also returns NO in that case if allocations could not be counted, because CC3_ALLOCATION_TRACKING_ENABLED
+ * is disabled, or the platform does not support counting allocations, since the expectation cannot
+ * then be verified. The "tracked" entry of the allocation results indicates whether allocations
+ * were actually counted.
+ */
+-(BOOL) didScenarioSucceed: (NSDictionary*) results;
+
+/**
+ * Runs the specified scenario, and returns a dictionary of the results, suitable for
+ * serializing to JSON.
+ *
+ * The first kCC3BenchmarkWarmUpFrameCount frames of each scenario are stepped before timing
+ * begins, to ensure that lazily-initialized content, such as GL buffers, shaders and cached
+ * shadow volumes, is not included in the results.
+ */
+-(NSDictionary*) runScenario: (CC3BenchmarkScenario*) scenario;
+
+/** Runs each of the specified scenarios in turn, and returns an array of the results. */
+-(NSArray*) runScenarios: (NSArray*) scenarios;
+
+/**
+ * Checks and times the matrix functions that have CC3_SIMD implementations against scalar
+ * reference implementations, and returns a dictionary of the results, suitable for serializing
+ * to JSON. The functions checked are CC3Matrix4x4Multiply, CC3Matrix4x3Multiply,
+ * CC3Matrix4x4TransformCC3Vector4, CC3Matrix4x3TransformCC3Vector4, CC3Matrix4x4Transpose,
+ * CC3Matrix4x4InvertRigid and CC3Matrix4x4InvertAdjoint, and the results of each are reported
+ * under the multiply4x4, multiply4x3, transform4x4, transform4x3, transpose4x4, invertRigid4x4
+ * and invertAdjoint4x4 keys, respectively.
+ *
+ * Each library function is first applied to kCC3BenchmarkMatrixCount sets of random operands,
+ * and each result is compared, bit for bit, with that of the scalar reference implementation.
+ * CC3Matrix4x4InvertRigid is applied to random rotation and translation matrices. The number of
+ * results that differ is reported. Each implementation is then timed over
+ * kCC3BenchmarkMatrixIterations invocations, and the average duration of each, and the speedup
+ * of the library function over the reference implementation, are reported.
+ *
+ * When CC3_SIMD is enabled, this checks that the vector implementations of the library functions
+ * produce results identical to the scalar implementations, and measures the speedup they provide.
+ */
+-(NSDictionary*) runMatrixBenchmark;
+
+/**
+ * Returns whether the specified results, as returned by the runMatrixBenchmark method, show that
+ * every result of the library matrix functions was identical to that of the reference implementation.
+ */
+-(BOOL) didMatrixBenchmarkSucceed: (NSDictionary*) results;
+
+/**
+ * Loads the specified POD file, both memory-mapped and read into memory, and returns a dictionary
+ * of the load times and resident memory of each loading mode, suitable for serializing to JSON.
+ *
+ * The file is loaded once before measuring, so that the textures it references are cached, and
+ * the file content is in the file system cache. It is then loaded kCC3BenchmarkPODLoadIterations
+ * times in each mode, and the average and minimum load times are reported. Resident memory is
+ * sampled throughout each load. For each mode, the peak growth in resident memory during loading,
+ * and the growth that remains while the loaded nodes are retained, are reported.
+ *
+ * Returns nil if the file could not be loaded.
+ */
+-(NSDictionary*) runPODLoadBenchmarkWithFile: (NSString*) filePath;
+
+/**
+ * Checks and times the loading of CAF animation files by CC3CAFResource, which reads the keyframes
+ * of each track in bulk, against a reference implementation that reads each keyframe value
+ * individually, as CC3CAFResource did before bulk reads were available. Returns a dictionary of
+ * the results, suitable for serializing to JSON.
+ *
+ * A CAF file containing kCC3BenchmarkCAFTrackCount tracks, each of kCC3BenchmarkCAFKeyframeCount
+ * random keyframes, is written to a temporary file. The animation of each track loaded by
+ * CC3CAFResource is compared, bit for bit, with that read by the reference implementation, and the
+ * number of tracks that differ is reported. The file is then loaded kCC3BenchmarkCAFLoadIterations
+ * times by each implementation, and the average load time of each, and the speedup of
+ * CC3CAFResource over the reference implementation, are reported.
+ *
+ * Returns nil if the file could not be written or loaded.
+ */
+-(NSDictionary*) runCAFLoadBenchmark;
+
+/**
+ * Checks and times the decompression of PVRTC 4bpp, PVRTC 2bpp and ETC textures, comparing the
+ * decompression of large textures in parallel bands with decompression on a single thread, and
+ * returns a dictionary of the results, suitable for serializing to JSON.
+ *
+ * A texture of kCC3BenchmarkDecompressSize pixels square, holding random content, is decompressed
+ * in each format, both in parallel and on a single thread, and the two results are compared,
+ * byte for byte. The number of formats whose results differ is reported. Each texture is then
+ * decompressed kCC3BenchmarkDecompressIterations times in each mode, and the average duration of
+ * each, and the speedup of parallel decompression over decompression on a single thread, are
+ * reported.
+ */
+-(NSDictionary*) runDecompressionBenchmark;
+
+/**
+ * Checks and times the conversion of texture content from 32-bit RGBA pixels to each of the
+ * other supported pixel formats, and the flipping and rotating of content in each pixel format,
+ * against scalar reference implementations that process one pixel at a time, and returns a
+ * dictionary of the results, suitable for serializing to JSON.
+ *
+ * A texture of kCC3BenchmarkTextureSize pixels square, holding random pixels, is converted to
+ * each pixel format by the CC3ConvertRGBA8888Pixels function, and the converted content is then
+ * flipped vertically, flipped horizontally, and rotated by half a circle, by the
+ * CC3FlipVertically, CC3FlipHorizontally and CC3RotateHalfCircle functions. Each result is
+ * compared, byte for byte, with that of the reference implementation, and the number of results
+ * that differ is reported. Each operation is then performed kCC3BenchmarkTextureIterations times
+ * by each implementation, and the average duration of each, and the speedup of the library
+ * function over the reference implementation, are reported.
+ */
+-(NSDictionary*) runTextureConversionBenchmark;
+
+/**
+ * Returns whether the application was launched to run benchmarks, instead of interactively.
+ *
+ * Returns YES if the CC3Benchmark launch argument is present. See the runFromLaunchArguments
+ * method for a description of the launch arguments.
+ */
++(BOOL) isRequestedByLaunchArguments;
+
+/**
+ * Runs the benchmark scenarios identified by the launch arguments, writes the results
+ * as JSON, and returns whether the scenarios ran and the results were written successfully.
+ *
+ * The following launch arguments are recognized:
+ *   - -CC3Benchmark <names>:          A comma-separated list of the names of the standard
+ *                                     scenarios to run, or "all" to run all of them.
+ *   - -CC3BenchmarkFrames <count>:    The number of frames to step each scenario through.
+ *   - -CC3BenchmarkDeltaTime <secs>:  The fixed interval between frames.
+ *   - -CC3BenchmarkOutput <path>:     The file to write the JSON results to. If not
+ *                                     provided, the results are written to standard output.
+ *   - -CC3BenchmarkTrace <path>:      If provided, a trace of the engine activities during
+ *                                     the run is written to the file, in the Chrome trace
+ *                                     event format. Requires CC3_TRACING_ENABLED.
+ *   - -CC3BenchmarkLabel <label>:     A label, such as a commit identifier, that is copied
+ *                                     into the results.
+ *   - -CC3BenchmarkPODFile <path>:    The POD file loaded by the POD loading benchmark.
+ *                                     If not provided, kCC3BenchmarkPODFile is loaded.
+ *   - -CC3BenchmarkAllocations YES:   Counts the memory allocations made during each frame,
+ *                                     and fails the run if any scenario that is expected to be
+ *                                     allocation-free allocates memory during a measured frame,
+ *                                     or if allocations cannot be counted on this platform.
+ *                                     Requires CC3_ALLOCATION_TRACKING_ENABLED.
+ *
+ * The matrix, POD loading, CAF loading, texture decompression and texture conversion benchmarks
+ * are also run, and their results are included in the JSON results.
+ *
+ * Returns NO if any scenario did not succeed, as determined by the didScenarioSucceed: method,
+ * if the matrix benchmark did not succeed, as determined by the didMatrixBenchmarkSucceed: method,
+ * if the POD file could not be loaded, if the CAF file could not be loaded, or was loaded
+ * differently than by the reference implementation, if parallel texture decompression produced
+ * different pixels than decompression on a single thread, or if texture conversion or flipping
+ * produced different pixels than the reference implementation.
+ */
++(BOOL) runFromLaunchArguments;
+
+@end
@@ -0,0 +1,1387 @@
+/*
+ * CC3PerformanceBenchmark.m
+ *
+ * Cocos3D 2.0.2
+ * Author: Bill Hollings
+ * Copyright (c) 2010-2014 The Brenwill Workshop Ltd. All rights reserved.
+ * http://www.brenwill.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ *
+ * See header file CC3PerformanceBenchmark.h for full API documentation.
+ */
+
+#import "CC3PerformanceBenchmark.h"
+#import "CC3OpenGLNull.h"
+#import "CC3RenderSurfaces.h"
+#import "CC3Camera.h"
+#import "CC3MeshNode.h"
+#import "CC3Particles.h"
+#import "CC3PODResource.h"
+#import "CC3CAFResource.h"
+#import "CC3CALNode.h"
+#import "CC3PVRFoundation.h"
+#import <mach/mach.h>
+#import <pthread.h>
+
+// Launch argument keys
+#define kCC3BenchmarkKey			@"CC3Benchmark"
+#define kCC3BenchmarkFramesKey		@"CC3BenchmarkFrames"
+#define kCC3BenchmarkDeltaTimeKey	@"CC3BenchmarkDeltaTime"
+#define kCC3BenchmarkOutputKey		@"CC3BenchmarkOutput"
+#define kCC3BenchmarkTraceKey		@"CC3BenchmarkTrace"
+#define kCC3BenchmarkLabelKey		@"CC3BenchmarkLabel"
+#define kCC3BenchmarkAllocationsKey	@"CC3BenchmarkAllocations"
+#define kCC3BenchmarkPODFileKey		@"CC3BenchmarkPODFile"
+#define kCC3BenchmarkAll			@"all"
+
+
+#pragma mark -
+#pragma mark CC3BenchmarkScenario
+
+@implementation CC3BenchmarkScenario
+
+@synthesize name=_name, templateName=_templateName, perSideCount=_perSideCount;
+@synthesize shouldAnimateNodes=_shouldAnimateNodes, shouldCastShadows=_shouldCastShadows;
+@synthesize shouldBeAllocationFree=_shouldBeAllocationFree;
+@synthesize frameCount=_frameCount, deltaTime=_deltaTime;
+
+-(NSDictionary*) parameters {
+	return @{ @"name": _name,
+			  @"template": _templateName,
+			  @"perSideCount": @(_perSideCount),
+			  @"animated": @(_shouldAnimateNodes),
+			  @"shadows": @(_shouldCastShadows),
+			  @"allocationFree": @(_shouldBeAllocationFree),
+			  @"frameCount": @(_frameCount),
+			  @"deltaTime": @(_deltaTime), };
+}
+
+
+#pragma mark Allocation and initialization
+
+-(instancetype) initWithName: (NSString*) name
+				fromTemplate: (NSString*) templateName
+					 perSide: (GLuint) perSideCount {
+	if ( (self = [super init]) ) {
+		_name = name;
+		_templateName = templateName;
+		_perSideCount = perSideCount;
+		_shouldAnimateNodes = NO;
+		_shouldCastShadows = NO;
+		_shouldBeAllocationFree = NO;
+		_frameCount = kCC3BenchmarkDefaultFrameCount;
+		_deltaTime = kCC3BenchmarkDefaultDeltaTime;
+	}
+	return self;
+}
+
++(instancetype) scenarioWithName: (NSString*) name
+					fromTemplate: (NSString*) templateName
+						 perSide: (GLuint) perSideCount {
+	return [[self alloc] initWithName: name fromTemplate: templateName perSide: perSideCount];
+}
+
++(NSArray*) standardScenarios {
+	NSMutableArray* scenarios = [NSMutableArray array];
+	CC3BenchmarkScenario* scenario;
+
+	// Static and animated node grids of increasing size. Static scenes are expected not to
+	// allocate each frame, which the allocation gate checks when allocations are tracked.
+	scenario = [self scenarioWithName: @"grid-box-1" fromTemplate: kBoxTemplateName perSide: 1];
+	scenario.shouldBeAllocationFree = YES;
+	[scenarios addObject: scenario];
+
+	scenario = [self scenarioWithName: @"grid-box-10" fromTemplate: kBoxTemplateName perSide: 10];
+	scenario.shouldBeAllocationFree = YES;
+	[scenarios addObject: scenario];
+
+	scenario = [self scenarioWithName: @"grid-box-30" fromTemplate: kBoxTemplateName perSide: 30];
+	scenario.shouldBeAllocationFree = YES;
+	[scenarios addObject: scenario];
+
+	scenario = [self scenarioWithName: @"grid-box-30-animated" fromTemplate: kBoxTemplateName perSide: 30];
+	scenario.shouldAnimateNodes = YES;
+	[scenarios addObject: scenario];
+
+	scenario = [self scenarioWithName: @"grid-mascot-10" fromTemplate: kMascotTemplateName perSide: 10];
+	scenario.shouldBeAllocationFree = YES;
+	[scenarios addObject: scenario];
+
+	// Crowds of vertex-skinned characters, running bone animation
+	scenario = [self scenarioWithName: @"crowd-skinned-4" fromTemplate: kSkinnedTemplateName perSide: 4];
+	scenario.shouldAnimateNodes = YES;
+	[scenarios addObject: scenario];
+
+	scenario = [self scenarioWithName: @"crowd-skinned-8" fromTemplate: kSkinnedTemplateName perSide: 8];
+	scenario.shouldAnimateNodes = YES;
+	[scenarios addObject: scenario];
+
+	// Storms of point particles
+	[scenarios addObject: [self scenarioWithName: @"particles-4" fromTemplate: kParticleTemplateName perSide: 4]];
+	[scenarios addObject: [self scenarioWithName: @"particles-8" fromTemplate: kParticleTemplateName perSide: 8]];
+
+	// Shadow volumes, on static casters, and on moving casters that defeat shadow caching
+	scenario = [self scenarioWithName: @"shadows-mascot-5" fromTemplate: kMascotTemplateName perSide: 5];
+	scenario.shouldCastShadows = YES;
+	scenario.shouldBeAllocationFree = YES;
+	[scenarios addObject: scenario];
+
+	scenario = [self scenarioWithName: @"shadows-box-10-animated" fromTemplate: kBoxTemplateName perSide: 10];
+	scenario.shouldCastShadows = YES;
+	scenario.shouldAnimateNodes = YES;
+	[scenarios addObject: scenario];
+
+	return scenarios;
+}
+
+-(NSString*) description { return [NSString stringWithFormat: @"%@ %@", self.class, _name]; }
+
+@end
+
+
+#pragma mark -
+#pragma mark CC3PerformanceBenchmark
+
+#if CC3_GLSL
+
+/** Compares two CCTime values, for sorting with qsort. */
+static int CC3BenchmarkCompareTimes(const void* a, const void* b) {
+	CCTime ta = *(const CCTime*)a;
+	CCTime tb = *(const CCTime*)b;
+	return (ta < tb) ? -1 : ((ta > tb) ? 1 : 0);
+}
+
+/** Returns the specified percentile of the specified sorted times, using the nearest-rank method. */
+static CCTime CC3BenchmarkPercentile(const CCTime* sortedTimes, GLuint count, GLfloat percentile) {
+	if (count == 0) return 0.0;
+	GLuint rank = (GLuint)ceilf(percentile * count / 100.0f);
+	return sortedTimes[CLAMP(rank, 1, count) - 1];
+}
+
+/** Returns the specified duration, in seconds, as a number of milliseconds. */
+static NSNumber* CC3BenchmarkMillis(CCTime duration) { return @(duration * 1000.0); }
+
+/*
+ * Scalar reference implementations of the matrix functions that have CC3_SIMD implementations,
+ * accumulating in the same order as the library. As in the library, floating-point contraction is
+ * disabled, so that the compiler does not fuse the multiplies and adds into FMA instructions, which
+ * round only once.
+ */
+#pragma STDC FP_CONTRACT OFF
+
+static void CC3BenchmarkMatrix4x4Multiply(CC3Matrix4x4* mOut, const CC3Matrix4x4* mL, const CC3Matrix4x4* mR) {
+	for (NSUInteger colIdx = 0; colIdx < kCC3Matrix4x4ColumnCount; colIdx++) {
+		const GLfloat* rc = mR->colRow[colIdx];
+		for (NSUInteger rowIdx = 0; rowIdx < kCC3Matrix4x4RowCount; rowIdx++)
+			mOut->colRow[colIdx][rowIdx] = (mL->colRow[0][rowIdx] * rc[0]) + (mL->colRow[1][rowIdx] * rc[1]) +
+										   (mL->colRow[2][rowIdx] * rc[2]) + (mL->colRow[3][rowIdx] * rc[3]);
+	}
+}
+
+static void CC3BenchmarkMatrix4x3Multiply(CC3Matrix4x3* mOut, const CC3Matrix4x3* mL, const CC3Matrix4x3* mR) {
+	for (NSUInteger colIdx = 0; colIdx < kCC3Matrix4x3ColumnCount; colIdx++) {
+		const GLfloat* rc = mR->colRow[colIdx];
+		for (NSUInteger rowIdx = 0; rowIdx < kCC3Matrix4x3RowCount; rowIdx++)
+			mOut->colRow[colIdx][rowIdx] = (mL->colRow[0][rowIdx] * rc[0]) + (mL->colRow[1][rowIdx] * rc[1]) +
+										   (mL->colRow[2][rowIdx] * rc[2]);
+	}
+	for (NSUInteger rowIdx = 0; rowIdx < kCC3Matrix4x3RowCount; rowIdx++)
+		mOut->colRow[3][rowIdx] += mL->colRow[3][rowIdx];
+}
+
+static CC3Vector4 CC3BenchmarkMatrix4x4TransformCC3Vector4(const CC3Matrix4x4* mtx, CC3Vector4 v) {
+	GLfloat vOut[4];
+	for (NSUInteger rowIdx = 0; rowIdx < kCC3Matrix4x4RowCount; rowIdx++)
+		vOut[rowIdx] = (mtx->colRow[0][rowIdx] * v.x) + (mtx->colRow[1][rowIdx] * v.y) +
+					   (mtx->colRow[2][rowIdx] * v.z) + (mtx->colRow[3][rowIdx] * v.w);
+	return CC3Vector4Make(vOut[0], vOut[1], vOut[2], vOut[3]);
+}
+
+static CC3Vector4 CC3BenchmarkMatrix4x3TransformCC3Vector4(const CC3Matrix4x3* mtx, CC3Vector4 v) {
+	GLfloat vOut[3];
+	for (NSUInteger rowIdx = 0; rowIdx < kCC3Matrix4x3RowCount; rowIdx++)
+		vOut[rowIdx] = (mtx->colRow[0][rowIdx] * v.x) + (mtx->colRow[1][rowIdx] * v.y) +
+					   (mtx->colRow[2][rowIdx] * v.z) + (mtx->colRow[3][rowIdx] * v.w);
+	return CC3Vector4Make(vOut[0], vOut[1], vOut[2], v.w);
+}
+
+static void CC3BenchmarkMatrix4x4Transpose(CC3Matrix4x4* mtx) {
+	CC3Matrix4x4 mSrc = *mtx;
+	for (NSUInteger colIdx = 0; colIdx < kCC3Matrix4x4ColumnCount; colIdx++)
+		for (NSUInteger rowIdx = 0; rowIdx < kCC3Matrix4x4RowCount; rowIdx++)
+			mtx->colRow[colIdx][rowIdx] = mSrc.colRow[rowIdx][colIdx];
+}
+
+static void CC3BenchmarkMatrix4x4InvertRigid(CC3Matrix4x4* mtx) {
+	CC3Matrix4x4 mSrc = *mtx;
+	GLfloat tx = -mSrc.c4r1, ty = -mSrc.c4r2, tz = -mSrc.c4r3;
+	for (NSUInteger colIdx = 0; colIdx < 3; colIdx++) {
+		for (NSUInteger rowIdx = 0; rowIdx < 3; rowIdx++)
+			mtx->colRow[colIdx][rowIdx] = mSrc.colRow[rowIdx][colIdx];
+		mtx->colRow[colIdx][3] = 0.0f;
+	}
+	for (NSUInteger rowIdx = 0; rowIdx < 3; rowIdx++)
+		mtx->colRow[3][rowIdx] = (mtx->colRow[0][rowIdx] * tx) + (mtx->colRow[1][rowIdx] * ty) +
+								 (mtx->colRow[2][rowIdx] * tz);
+	mtx->c4r4 = 1.0f;
+}
+
+static BOOL CC3BenchmarkMatrix4x4InvertAdjoint(CC3Matrix4x4* mtx) {
+	CC3Matrix4x4 adj;
+	GLfloat minor[9];
+
+	// Each element of the adjoint is the signed determinant of the minor that excludes the
+	// column matching its row, and the row matching its column, read in column order.
+	for (NSUInteger colIdx = 0; colIdx < kCC3Matrix4x4ColumnCount; colIdx++) {
+		for (NSUInteger rowIdx = 0; rowIdx < kCC3Matrix4x4RowCount; rowIdx++) {
+			NSUInteger mIdx = 0;
+			for (NSUInteger mc = 0; mc < kCC3Matrix4x4ColumnCount; mc++) {
+				if (mc == rowIdx) continue;
+				for (NSUInteger mr = 0; mr < kCC3Matrix4x4RowCount; mr++)
+					if (mr != colIdx) minor[mIdx++] = mtx->colRow[mc][mr];
+			}
+			GLfloat cofactor = CC3Det3x3(minor[0], minor[1], minor[2], minor[3], minor[4],
+										 minor[5], minor[6], minor[7], minor[8]);
+			adj.colRow[colIdx][rowIdx] = ((colIdx + rowIdx) % 2) ? -cofactor : cofactor;
+		}
+	}
+
+	GLfloat det = (adj.c1r1 * mtx->c1r1) + (adj.c1r2 * mtx->c2r1) + (adj.c1r3 * mtx->c3r1) + (adj.c1r4 * mtx->c4r1);
+	if (det == 0.0f) return NO;
+
+	GLfloat ooDet = 1.0 / det;
+	for (NSUInteger colIdx = 0; colIdx < kCC3Matrix4x4ColumnCount; colIdx++)
+		for (NSUInteger rowIdx = 0; rowIdx < kCC3Matrix4x4RowCount; rowIdx++)
+			mtx->colRow[colIdx][rowIdx] = adj.colRow[colIdx][rowIdx] * ooDet;
+	return YES;
+}
+
+/** The random operands of the matrix benchmark. */
+typedef struct {
+	CC3Matrix4x4 l44[kCC3BenchmarkMatrixCount];
+	CC3Matrix4x4 r44[kCC3BenchmarkMatrixCount];
+	CC3Matrix4x4 rigid44[kCC3BenchmarkMatrixCount];
+	CC3Matrix4x3 l43[kCC3BenchmarkMatrixCount];
+	CC3Matrix4x3 r43[kCC3BenchmarkMatrixCount];
+	CC3Vector4 v4[kCC3BenchmarkMatrixCount];
+} CC3BenchmarkMatrixOperands;
+
+/**
+ * Applies a matrix function to the operands at the specified index, and writes the result, which
+ * may be a matrix or a vector, to the start of the specified output matrix.
+ */
+typedef void (*CC3BenchmarkMatrixOp)(const CC3BenchmarkMatrixOperands* ops, GLuint idx, CC3Matrix4x4* out);
+
+static void CC3BenchmarkLibMultiply4x4(const CC3BenchmarkMatrixOperands* ops, GLuint idx, CC3Matrix4x4* out) {
+	CC3Matrix4x4Multiply(out, &ops->l44[idx], &ops->r44[idx]);
+}
+
+static void CC3BenchmarkRefMultiply4x4(const CC3BenchmarkMatrixOperands* ops, GLuint idx, CC3Matrix4x4* out) {
+	CC3BenchmarkMatrix4x4Multiply(out, &ops->l44[idx], &ops->r44[idx]);
+}
+
+static void CC3BenchmarkLibMultiply4x3(const CC3BenchmarkMatrixOperands* ops, GLuint idx, CC3Matrix4x4* out) {
+	CC3Matrix4x3Multiply((CC3Matrix4x3*)out, &ops->l43[idx], &ops->r43[idx]);
+}
+
+static void CC3BenchmarkRefMultiply4x3(const CC3BenchmarkMatrixOperands* ops, GLuint idx, CC3Matrix4x4* out) {
+	CC3BenchmarkMatrix4x3Multiply((CC3Matrix4x3*)out, &ops->l43[idx], &ops->r43[idx]);
+}
+
+static void CC3BenchmarkLibTransform4x4(const CC3BenchmarkMatrixOperands* ops, GLuint idx, CC3Matrix4x4* out) {
+	*(CC3Vector4*)out = CC3Matrix4x4TransformCC3Vector4(&ops->l44[idx], ops->v4[idx]);
+}
+
+static void CC3BenchmarkRefTransform4x4(const CC3BenchmarkMatrixOperands* ops, GLuint idx, CC3Matrix4x4* out) {
+	*(CC3Vector4*)out = CC3BenchmarkMatrix4x4TransformCC3Vector4(&ops->l44[idx], ops->v4[idx]);
+}
+
+static void CC3BenchmarkLibTransform4x3(const CC3BenchmarkMatrixOperands* ops, GLuint idx, CC3Matrix4x4* out) {
+	*(CC3Vector4*)out = CC3Matrix4x3TransformCC3Vector4(&ops->l43[idx], ops->v4[idx]);
+}
+
+static void CC3BenchmarkRefTransform4x3(const CC3BenchmarkMatrixOperands* ops, GLuint idx, CC3Matrix4x4* out) {
+	*(CC3Vector4*)out = CC3BenchmarkMatrix4x3TransformCC3Vector4(&ops->l43[idx], ops->v4[idx]);
+}
+
+static void CC3BenchmarkLibTranspose4x4(const CC3BenchmarkMatrixOperands* ops, GLuint idx, CC3Matrix4x4* out) {
+	*out = ops->l44[idx];
+	CC3Matrix4x4Transpose(out);
+}
+
+static void CC3BenchmarkRefTranspose4x4(const CC3BenchmarkMatrixOperands* ops, GLuint idx, CC3Matrix4x4* out) {
+	*out = ops->l44[idx];
+	CC3BenchmarkMatrix4x4Transpose(out);
+}
+
+static void CC3BenchmarkLibInvertRigid4x4(const CC3BenchmarkMatrixOperands* ops, GLuint idx, CC3Matrix4x4* out) {
+	*out = ops->rigid44[idx];
+	CC3Matrix4x4InvertRigid(out);
+}
+
+static void CC3BenchmarkRefInvertRigid4x4(const CC3BenchmarkMatrixOperands* ops, GLuint idx, CC3Matrix4x4* out) {
+	*out = ops->rigid44[idx];
+	CC3BenchmarkMatrix4x4InvertRigid(out);
+}
+
+static void CC3BenchmarkLibInvertAdjoint4x4(const CC3BenchmarkMatrixOperands* ops, GLuint idx, CC3Matrix4x4* out) {
+	*out = ops->l44[idx];
+	CC3Matrix4x4InvertAdjoint(out);
+}
+
+static void CC3BenchmarkRefInvertAdjoint4x4(const CC3BenchmarkMatrixOperands* ops, GLuint idx, CC3Matrix4x4* out) {
+	*out = ops->l44[idx];
+	CC3BenchmarkMatrix4x4InvertAdjoint(out);
+}
+
+/** A library matrix function, and its reference implementation, checked by the matrix benchmark. */
+typedef struct {
+	const char* name;
+	CC3BenchmarkMatrixOp libOp;
+	CC3BenchmarkMatrixOp refOp;
+} CC3BenchmarkMatrixCheck;
+
+/** The matrix functions checked by the matrix benchmark, keyed by the name of their results. */
+static const CC3BenchmarkMatrixCheck kCC3BenchmarkMatrixChecks[] = {
+	{ "multiply4x4", CC3BenchmarkLibMultiply4x4, CC3BenchmarkRefMultiply4x4 },
+	{ "multiply4x3", CC3BenchmarkLibMultiply4x3, CC3BenchmarkRefMultiply4x3 },
+	{ "transform4x4", CC3BenchmarkLibTransform4x4, CC3BenchmarkRefTransform4x4 },
+	{ "transform4x3", CC3BenchmarkLibTransform4x3, CC3BenchmarkRefTransform4x3 },
+	{ "transpose4x4", CC3BenchmarkLibTranspose4x4, CC3BenchmarkRefTranspose4x4 },
+	{ "invertRigid4x4", CC3BenchmarkLibInvertRigid4x4, CC3BenchmarkRefInvertRigid4x4 },
+	{ "invertAdjoint4x4", CC3BenchmarkLibInvertAdjoint4x4, CC3BenchmarkRefInvertAdjoint4x4 },
+};
+
+/** Populates each of the specified number of floats with a random value. */
+static void CC3BenchmarkRandomizeFloats(GLfloat* floats, NSUInteger count) {
+	for (NSUInteger fIdx = 0; fIdx < count; fIdx++) floats[fIdx] = CC3RandomFloatBetween(-10.0f, 10.0f);
+}
+
+/** Returns the average duration, in nanoseconds, of each of the specified number of iterations. */
+static NSNumber* CC3BenchmarkNanosPer(CCTime duration, GLuint iterations) {
+	return @(duration * 1.0e9 / iterations);
+}
+
+/** Returns the specified matrix results, and the speedup of the library function over the reference. */
+static NSDictionary* CC3BenchmarkMatrixResults(GLuint mismatches, CCTime libTime, CCTime refTime) {
+	return @{ @"mismatches": @(mismatches),
+			  @"libraryNs": CC3BenchmarkNanosPer(libTime, kCC3BenchmarkMatrixIterations),
+			  @"referenceNs": CC3BenchmarkNanosPer(refTime, kCC3BenchmarkMatrixIterations),
+			  @"speedup": @((libTime > 0.0) ? (refTime / libTime) : 0.0), };
+}
+
+/** Returns the number of bytes of memory currently resident in this process, or zero if unknown. */
+static NSUInteger CC3BenchmarkResidentBytes(void) {
+	struct mach_task_basic_info info;
+	mach_msg_type_number_t infoCount = MACH_TASK_BASIC_INFO_COUNT;
+	kern_return_t rc = task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &infoCount);
+	return (rc == KERN_SUCCESS) ? (NSUInteger)info.resident_size : 0;
+}
+
+/** Returns the specified number of bytes as a number of megabytes. */
+static NSNumber* CC3BenchmarkMegabytes(NSInteger bytes) { return @(bytes / (1024.0 * 1024.0)); }
+
+/** The state shared with a thread that samples the peak resident memory of this process. */
+typedef struct {
+	volatile BOOL isSampling;
+	volatile NSUInteger peakBytes;
+} CC3BenchmarkMemorySampler;
+
+/** Records the peak resident memory in the specified sampler, until sampling is turned off. */
+static void* CC3BenchmarkSampleMemory(void* arg) {
+	CC3BenchmarkMemorySampler* sampler = arg;
+	while (sampler->isSampling) {
+		sampler->peakBytes = MAX(sampler->peakBytes, CC3BenchmarkResidentBytes());
+		usleep(kCC3BenchmarkMemorySampleInterval);
+	}
+	return NULL;
+}
+
+/** Appends the specified 32-bit value to the specified data, in little-endian byte order. */
+static void CC3BenchmarkAppendUInt32(NSMutableData* data, uint32_t value) {
+	value = CFSwapInt32HostToLittle(value);
+	[data appendBytes: &value length: sizeof(value)];
+}
+
+/** Appends the specified float to the specified data, in little-endian byte order. */
+static void CC3BenchmarkAppendFloat(NSMutableData* data, GLfloat value) {
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	CC3BenchmarkAppendUInt32(data, bits);
+}
+
+/**
+ * Returns the content of a version 1000 CAF file, holding the specified number of tracks, each
+ * containing the specified number of keyframes, evenly spaced over the specified duration, and
+ * each holding a random location and rotation.
+ */
+static NSData* CC3BenchmarkCAFContent(GLuint trackCount, GLuint frameCount, GLfloat duration) {
+	NSMutableData* data = [NSMutableData data];
+	[data appendBytes: "CAF" length: 4];				// Magic token, including the null terminator
+	CC3BenchmarkAppendUInt32(data, 1000);				// File version, without compression or flags
+	CC3BenchmarkAppendFloat(data, duration);
+	CC3BenchmarkAppendUInt32(data, trackCount);
+	for (GLuint tIdx = 0; tIdx < trackCount; tIdx++) {
+		CC3BenchmarkAppendUInt32(data, tIdx);			// CAL node index
+		CC3BenchmarkAppendUInt32(data, frameCount);
+		for (GLuint fIdx = 0; fIdx < frameCount; fIdx++) {
+			CC3BenchmarkAppendFloat(data, duration * fIdx / frameCount);
+			for (GLuint cIdx = 0; cIdx < 7; cIdx++)		// Location and quaternion components
+				CC3BenchmarkAppendFloat(data, CC3RandomFloatBetween(-1.0f, 1.0f));
+		}
+	}
+	return data;
+}
+
+/**
+ * Reference implementation of CAF file loading, which reads each keyframe value individually,
+ * as CC3CAFResource did before it read keyframes in bulk. Returns a CC3CALNode holding the
+ * animation of each track of the specified version 1000 CAF file, in track order, or returns
+ * nil if the file could not be read.
+ */
+static NSArray* CC3BenchmarkReadCAFNodes(NSString* filePath) {
+	NSData* cafData = [NSData dataWithContentsOfFile: filePath];
+	if ( !cafData ) return nil;
+
+	CC3DataReader* reader = [CC3DataReader readerOnData: cafData];
+	reader.isBigEndian = NO;
+	[reader readInteger];								// Magic token
+	[reader readInteger];								// File version
+	CCTime duration = reader.readFloat;
+	GLint trackCount = reader.readInteger;
+
+	NSMutableArray* nodes = [NSMutableArray arrayWithCapacity: MAX(trackCount, 0)];
+	for (GLint tIdx = 0; tIdx < trackCount; tIdx++) {
+		GLint calNodeIdx = reader.readInteger;
+		GLint frameCount = reader.readInteger;
+		if (reader.wasReadBeyondEOF || frameCount <= 0) return nil;
+
+		CC3ArrayNodeAnimation* anim = [CC3ArrayNodeAnimation animationWithFrameCount: (GLuint)frameCount];
+		CCTime* frameTimes = anim.allocateFrameTimes;
+		CC3Vector* locations = anim.allocateLocations;
+		CC3Quaternion* quaternions = anim.allocateQuaternions;
+		for (GLint fIdx = 0; fIdx < frameCount; fIdx++) {
+			frameTimes[fIdx] = CLAMP(reader.readFloat / duration, 0.0f, 1.0f);
+			locations[fIdx].x = reader.readFloat;
+			locations[fIdx].y = reader.readFloat;
+			locations[fIdx].z = reader.readFloat;
+			quaternions[fIdx].x = reader.readFloat;
+			quaternions[fIdx].y = reader.readFloat;
+			quaternions[fIdx].z = reader.readFloat;
+			quaternions[fIdx].w = reader.readFloat;
+		}
+
+		CC3CALNode* calNode = [CC3CALNode node];
+		calNode.calIndex = calNodeIdx;
+		calNode.animation = anim;
+		[nodes addObject: calNode];
+	}
+	return reader.wasReadBeyondEOF ? nil : nodes;
+}
+
+/** Returns whether the specified animations hold identical keyframes. */
+static BOOL CC3BenchmarkAreAnimationsEqual(CC3ArrayNodeAnimation* anim, CC3ArrayNodeAnimation* refAnim) {
+	GLuint frameCount = anim.frameCount;
+	return (refAnim.frameCount == frameCount &&
+			memcmp(anim.frameTimes, refAnim.frameTimes, frameCount * sizeof(CCTime)) == 0 &&
+			memcmp(anim.animatedLocations, refAnim.animatedLocations, frameCount * sizeof(CC3Vector)) == 0 &&
+			memcmp(anim.animatedQuaternions, refAnim.animatedQuaternions, frameCount * sizeof(CC3Quaternion)) == 0);
+}
+
+/** Returns the number of nodes whose animation differs from that of the corresponding reference node. */
+static GLuint CC3BenchmarkCountAnimationMismatches(NSArray* nodes, NSArray* refNodes) {
+	if (nodes.count != refNodes.count) return (GLuint)MAX(nodes.count, refNodes.count);
+
+	GLuint mismatches = 0;
+	for (NSUInteger nIdx = 0; nIdx < nodes.count; nIdx++) {
+		CC3ArrayNodeAnimation* anim = (CC3ArrayNodeAnimation*)[nodes[nIdx] animation];
+		CC3ArrayNodeAnimation* refAnim = (CC3ArrayNodeAnimation*)[refNodes[nIdx] animation];
+		if ( !CC3BenchmarkAreAnimationsEqual(anim, refAnim) ) mismatches++;
+	}
+	return mismatches;
+}
+
+/** The compressed texture formats decompressed by the texture decompression benchmark. */
+typedef enum {
+	kCC3BenchmarkPVRTC4bpp,
+	kCC3BenchmarkPVRTC2bpp,
+	kCC3BenchmarkETC,
+	kCC3BenchmarkCompressionCount,
+} CC3BenchmarkCompression;
+
+/** Returns the key under which the results of decompressing the specified format are reported. */
+static NSString* CC3BenchmarkCompressionName(CC3BenchmarkCompression compression) {
+	switch (compression) {
+		case kCC3BenchmarkPVRTC4bpp: return @"pvrtc4bpp";
+		case kCC3BenchmarkPVRTC2bpp: return @"pvrtc2bpp";
+		default: return @"etc";
+	}
+}
+
+/** Decompresses the specified square texture content, of the specified format and size, into the specified pixels. */
+static void CC3BenchmarkDecompress(CC3BenchmarkCompression compression, const GLvoid* content,
+								   GLint size, GLvoid* pixels, BOOL shouldAllowParallel) {
+	switch (compression) {
+		case kCC3BenchmarkPVRTC4bpp:
+			CC3DecompressPVRTC(content, NO, size, size, pixels, shouldAllowParallel);
+			break;
+		case kCC3BenchmarkPVRTC2bpp:
+			CC3DecompressPVRTC(content, YES, size, size, pixels, shouldAllowParallel);
+			break;
+		default:
+			CC3DecompressETC(content, size, size, pixels, shouldAllowParallel);
+			break;
+	}
+}
+
+/** A pixel format that the texture conversion benchmark converts 32-bit RGBA pixels to. */
+typedef struct {
+	const char* name;
+	GLenum pixelFormat;
+	GLenum pixelType;
+	GLuint bytesPerPixel;
+} CC3BenchmarkPixelFormat;
+
+/** The pixel formats checked by the texture conversion benchmark, keyed by the name of their results. */
+static const CC3BenchmarkPixelFormat kCC3BenchmarkPixelFormats[] = {
+	{ "rgba8888", GL_RGBA, GL_UNSIGNED_BYTE, 4 },
+	{ "rgb888", GL_RGB, GL_UNSIGNED_BYTE, 3 },
+	{ "alpha8", GL_ALPHA, GL_UNSIGNED_BYTE, 1 },
+	{ "luminance8", GL_LUMINANCE, GL_UNSIGNED_BYTE, 1 },
+	{ "luminanceAlpha88", GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, 2 },
+	{ "rgb565", GL_RGB, GL_UNSIGNED_SHORT_5_6_5, 2 },
+	{ "rgba4444", GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, 2 },
+	{ "rgba5551", GL_RGBA, GL_UNSIGNED_SHORT_5_5_5_1, 2 },
+};
+
+/** Returns the BT.709 luminance of the specified pixel, converted one pixel at a time through floats. */
+static GLubyte CC3BenchmarkLuminance(ccColor4B rgba) {
+	return CCColorByteFromFloat(CC3LuminosityBT709(CCColorFloatFromByte(rgba.r),
+												   CCColorFloatFromByte(rgba.g),
+												   CCColorFloatFromByte(rgba.b)));
+}
+
+/**
+ * Scalar reference implementation of CC3ConvertRGBA8888Pixels, converting one pixel at a time.
+ * Luminance-alpha pixels are written as a luminance byte followed by an alpha byte, as GL expects.
+ */
+static void CC3BenchmarkConvertRGBA8888Pixels(ccColor4B* pixels, GLuint pixelCount, GLenum pixelFormat, GLenum pixelType) {
+	GLubyte* bArray = (GLubyte*)pixels;
+	GLushort* usArray = (GLushort*)pixels;
+	for (GLuint pixIdx = 0; pixIdx < pixelCount; pixIdx++) {
+		ccColor4B rgba = pixels[pixIdx];
+		switch (pixelType) {
+			case GL_UNSIGNED_BYTE:
+				switch (pixelFormat) {
+					case GL_RGB:
+						((ccColor3B*)pixels)[pixIdx] = CCC3BFromCCC4B(rgba);
+						break;
+					case GL_ALPHA:
+						bArray[pixIdx] = rgba.a;
+						break;
+					case GL_LUMINANCE:
+						bArray[pixIdx] = CC3BenchmarkLuminance(rgba);
+						break;
+					case GL_LUMINANCE_ALPHA:
+						bArray[(pixIdx * 2)] = CC3BenchmarkLuminance(rgba);
+						bArray[(pixIdx * 2) + 1] = rgba.a;
+						break;
+					default:
+						break;
+				}
+				break;
+			case GL_UNSIGNED_SHORT_5_6_5:
+				usArray[pixIdx] = ((((GLushort)rgba.r >> 3) << 11) |
+								   (((GLushort)rgba.g >> 2) <<  5) |
+								   (((GLushort)rgba.b >> 3)));
+				break;
+			case GL_UNSIGNED_SHORT_4_4_4_4:
+				usArray[pixIdx] = ((((GLushort)rgba.r >> 4) << 12) |
+								   (((GLushort)rgba.g >> 4) <<  8) |
+								   (((GLushort)rgba.b >> 4) <<  4) |
+								   (((GLushort)rgba.a >> 4)));
+				break;
+			case GL_UNSIGNED_SHORT_5_5_5_1:
+				usArray[pixIdx] = ((((GLushort)rgba.r >> 3) << 11) |
+								   (((GLushort)rgba.g >> 3) <<  6) |
+								   (((GLushort)rgba.b >> 3) <<  1) |
+								   (((GLushort)rgba.a >> 7)));
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+/** Scalar reference implementation of CC3FlipHorizontally, swapping one pixel at a time. */
+static void CC3BenchmarkFlipHorizontally(GLubyte* rowMajorData, GLuint rowCount, GLuint bytesPerRow, GLuint bytesPerPixel) {
+	GLuint colCnt = bytesPerRow / bytesPerPixel;
+	GLubyte tmpPixel[bytesPerPixel];
+	for (GLuint rowIdx = 0; rowIdx < rowCount; rowIdx++) {
+		GLubyte* rowStart = rowMajorData + (bytesPerRow * rowIdx);
+		for (GLuint colIdx = 0; colIdx < colCnt / 2; colIdx++) {
+			GLubyte* firstPixel = rowStart + (bytesPerPixel * colIdx);
+			GLubyte* lastPixel = rowStart + (bytesPerPixel * (colCnt - 1 - colIdx));
+			memcpy(tmpPixel, firstPixel, bytesPerPixel);
+			memcpy(firstPixel, lastPixel, bytesPerPixel);
+			memcpy(lastPixel, tmpPixel, bytesPerPixel);
+		}
+	}
+}
+
+/** Scalar reference implementation of CC3FlipVertically, swapping one pixel at a time. */
+static void CC3BenchmarkFlipVertically(GLubyte* rowMajorData, GLuint rowCount, GLuint bytesPerRow, GLuint bytesPerPixel) {
+	GLuint colCnt = bytesPerRow / bytesPerPixel;
+	GLubyte tmpPixel[bytesPerPixel];
+	for (GLuint rowIdx = 0; rowIdx < rowCount / 2; rowIdx++) {
+		GLubyte* lowerRow = rowMajorData + (bytesPerRow * rowIdx);
+		GLubyte* upperRow = rowMajorData + (bytesPerRow * (rowCount - 1 - rowIdx));
+		for (GLuint colIdx = 0; colIdx < colCnt; colIdx++) {
+			GLubyte* lowerPixel = lowerRow + (bytesPerPixel * colIdx);
+			GLubyte* upperPixel = upperRow + (bytesPerPixel * colIdx);
+			memcpy(tmpPixel, lowerPixel, bytesPerPixel);
+			memcpy(lowerPixel, upperPixel, bytesPerPixel);
+			memcpy(upperPixel, tmpPixel, bytesPerPixel);
+		}
+	}
+}
+
+/** Scalar reference implementation of CC3RotateHalfCircle, as a vertical flip followed by a horizontal flip. */
+static void CC3BenchmarkRotateHalfCircle(GLubyte* rowMajorData, GLuint rowCount, GLuint bytesPerRow, GLuint bytesPerPixel) {
+	CC3BenchmarkFlipVertically(rowMajorData, rowCount, bytesPerRow, bytesPerPixel);
+	CC3BenchmarkFlipHorizontally(rowMajorData, rowCount, bytesPerRow, bytesPerPixel);
+}
+
+/** Flips the specified pixels vertically, using the library function. */
+static void CC3BenchmarkLibFlipVertically(GLubyte* rowMajorData, GLuint rowCount, GLuint bytesPerRow, GLuint bytesPerPixel) {
+	CC3FlipVertically(rowMajorData, rowCount, bytesPerRow);
+}
+
+/** Applies an in-place flip or rotation to the specified pixels. */
+typedef void (*CC3BenchmarkPixelOp)(GLubyte* rowMajorData, GLuint rowCount, GLuint bytesPerRow, GLuint bytesPerPixel);
+
+/** A library flip or rotation, and its reference implementation, checked by the texture conversion benchmark. */
+typedef struct {
+	const char* name;
+	CC3BenchmarkPixelOp libOp;
+	CC3BenchmarkPixelOp refOp;
+} CC3BenchmarkPixelCheck;
+
+/** The flips and rotations checked by the texture conversion benchmark, keyed by the name of their results. */
+static const CC3BenchmarkPixelCheck kCC3BenchmarkPixelChecks[] = {
+	{ "flipVertically", CC3BenchmarkLibFlipVertically, CC3BenchmarkFlipVertically },
+	{ "flipHorizontally", CC3FlipHorizontally, CC3BenchmarkFlipHorizontally },
+	{ "rotateHalfCircle", CC3RotateHalfCircle, CC3BenchmarkRotateHalfCircle },
+};
+
+/** Returns the specified texture results, and the speedup of the library function over the reference. */
+static NSDictionary* CC3BenchmarkTextureResults(BOOL isIdentical, CCTime libTime, CCTime refTime) {
+	return @{ @"identical": @(isIdentical),
+			  @"libraryMs": CC3BenchmarkMillis(libTime / kCC3BenchmarkTextureIterations),
+			  @"referenceMs": CC3BenchmarkMillis(refTime / kCC3BenchmarkTextureIterations),
+			  @"speedup": @((libTime > 0.0) ? (refTime / libTime) : 0.0), };
+}
+
+@implementation CC3PerformanceBenchmark
+
+@synthesize shouldTrackAllocations=_shouldTrackAllocations;
+
+
+#pragma mark Running scenarios
+
+-(NSDictionary*) runScenario: (CC3BenchmarkScenario*) scenario {
+	NSDictionary* results = nil;
+	@autoreleasepool {
+		LogInfo(@"Running benchmark %@", scenario);
+
+		CC3RandomSeed(kCC3BenchmarkRandomSeed);
+		_scene = [CC3PerformanceScene scene];
+		_scene.performanceStatistics = [CC3PerformanceStatistics statistics];
+		if ( ![_scene selectTemplateNodeNamed: scenario.templateName] ) {
+			LogError(@"%@ could not find template node named %@", scenario, scenario.templateName);
+			_scene = nil;
+			CC3RandomUnseed();
+			return nil;
+		}
+		_scene.perSideCount = scenario.perSideCount;
+		_scene.shouldCastShadows = scenario.shouldCastShadows;
+		[self attachSurfaces];
+		[_scene open];
+		_scene.shouldAnimateNodes = scenario.shouldAnimateNodes;	// After open, so actions can run
+
+		// Step a few frames to lazily create GL buffers, shaders, shadows, etc, then start counting
+		CCTime dt = scenario.deltaTime;
+		for (GLuint fIdx = 0; fIdx < kCC3BenchmarkWarmUpFrameCount; fIdx++) [self stepWithDeltaTime: dt];
+
+		CC3PerformanceStatistics* stats = _scene.performanceStatistics;
+		[stats reset];
+		CC3OpenGLNull* gl = (CC3OpenGLNull*)CC3OpenGL.sharedGL;
+		[gl resetDrawCounts];
+		GLint instanceCountAtStart = CC3Identifiable.instanceCount;
+		GLint glObjectCountAtStart = CC3OpenGLNull.liveObjectCount;
+
+		GLuint frameCount = MAX(scenario.frameCount, 1);
+		CCTime* frameTimes = calloc(frameCount, sizeof(CCTime));
+		GLuint framesAllocating = 0;
+		if (_shouldTrackAllocations) CC3AllocationTrackingStart();
+		BOOL isTrackingAllocations = CC3AllocationTrackingIsActive();	// NO if the platform cannot count
+		NSUInteger allocCountAtStart = CC3AllocationCount();
+		NSUInteger allocBytesAtStart = CC3AllocatedBytes();
+		CCTime runStart = CC3PerformanceTimestamp();
+		for (GLuint fIdx = 0; fIdx < frameCount; fIdx++) {
+			NSUInteger frameAllocCount = CC3AllocationCount();
+			CCTime frameStart = CC3PerformanceTimestamp();
+			[self stepWithDeltaTime: dt];
+			frameTimes[fIdx] = CC3PerformanceTimestamp() - frameStart;
+			if (CC3AllocationCount() != frameAllocCount) framesAllocating++;
+		}
+		CCTime runTime = CC3PerformanceTimestamp() - runStart;
+		NSUInteger allocCount = CC3AllocationCount() - allocCountAtStart;
+		NSUInteger allocBytes = CC3AllocatedBytes() - allocBytesAtStart;
+		if (_shouldTrackAllocations) CC3AllocationTrackingStop();
+
+		NSMutableDictionary* mutableResults = [NSMutableDictionary dictionary];
+		mutableResults[@"scenario"] = scenario.parameters;
+		mutableResults[@"frames"] = @(frameCount);
+		mutableResults[@"runTimeMs"] = CC3BenchmarkMillis(runTime);
+		mutableResults[@"frameTimeMs"] = [self summaryOfFrameTimes: frameTimes count: frameCount];
+		mutableResults[@"phasesMs"] = [self summaryOfPhases: stats];
+		mutableResults[@"nodes"] = [self summaryOfNodes];
+		mutableResults[@"memory"] = _scene.memoryFootprint;
+		mutableResults[@"perFrame"] = @{ @"nodesUpdated": @(stats.averageNodesUpdatedPerUpdate),
+										  @"nodesTransformed": @(stats.averageNodesTransformedPerUpdate),
+										  @"nodesVisitedForDrawing": @(stats.averageNodesVisitedForDrawingPerFrame),
+										  @"nodesDrawn": @(stats.averageNodesDrawnPerFrame),
+										  @"drawCalls": @((GLfloat)gl.drawCallCount / frameCount),
+										  @"verticesDrawn": @((GLfloat)gl.verticesDrawn / frameCount), };
+		NSMutableDictionary* allocs = [NSMutableDictionary dictionary];
+		allocs[@"identifiableGrowth"] = @(CC3Identifiable.instanceCount - instanceCountAtStart);
+		allocs[@"glObjectGrowth"] = @((GLint)CC3OpenGLNull.liveObjectCount - glObjectCountAtStart);
+		if (_shouldTrackAllocations) {
+			allocs[@"tracked"] = @(isTrackingAllocations);
+			allocs[@"framesAllocating"] = @(framesAllocating);
+			allocs[@"perFrame"] = @((GLfloat)allocCount / frameCount);
+			allocs[@"bytesPerFrame"] = @((GLfloat)allocBytes / frameCount);
+			allocs[@"phases"] = [self summaryOfPhaseAllocations: stats];
+		}
+		mutableResults[@"allocations"] = allocs;
+		results = mutableResults;
+		free(frameTimes);
+
+		[_scene close];
+		[_scene stopAllActions];
+		_scene = nil;
+		CC3RandomUnseed();
+	}
+	return results;
+}
+
+-(BOOL) didScenarioSucceed: (NSDictionary*) results {
+	NSDictionary* allocs = results[@"allocations"];
+	if ( !allocs[@"tracked"] ) return YES;		// Allocations were not requested
+	if ( ![results[@"scenario"][@"allocationFree"] boolValue] ) return YES;
+	if ( ![allocs[@"tracked"] boolValue] ) return NO;	// Requested, but could not be counted
+	return [allocs[@"framesAllocating"] unsignedIntValue] == 0;
+}
+
+-(NSArray*) runScenarios: (NSArray*) scenarios {
+	NSMutableArray* allResults = [NSMutableArray arrayWithCapacity: scenarios.count];
+	for (CC3BenchmarkScenario* scenario in scenarios) {
+		NSDictionary* results = [self runScenario: scenario];
+		if (results) [allResults addObject: results];
+	}
+	return allResults;
+}
+
+
+#pragma mark Matrix benchmark
+
+-(NSDictionary*) runMatrixBenchmark {
+	GLuint matCnt = kCC3BenchmarkMatrixCount;
+	CC3BenchmarkMatrixOperands* ops = calloc(1, sizeof(CC3BenchmarkMatrixOperands));
+
+	CC3RandomSeed(kCC3BenchmarkRandomSeed);
+	CC3BenchmarkRandomizeFloats((GLfloat*)ops->l44, matCnt * kCC3Matrix4x4ElementCount);
+	CC3BenchmarkRandomizeFloats((GLfloat*)ops->r44, matCnt * kCC3Matrix4x4ElementCount);
+	CC3BenchmarkRandomizeFloats((GLfloat*)ops->l43, matCnt * kCC3Matrix4x3ElementCount);
+	CC3BenchmarkRandomizeFloats((GLfloat*)ops->r43, matCnt * kCC3Matrix4x3ElementCount);
+	CC3BenchmarkRandomizeFloats((GLfloat*)ops->v4, matCnt * 4);
+	for (GLuint mIdx = 0; mIdx < matCnt; mIdx++) {
+		CC3Matrix4x4* rigidMtx = &ops->rigid44[mIdx];
+		CC3Matrix4x4PopulateFromRotationYXZ(rigidMtx, cc3v(CC3RandomFloatBetween(-180.0f, 180.0f),
+														   CC3RandomFloatBetween(-180.0f, 180.0f),
+														   CC3RandomFloatBetween(-180.0f, 180.0f)));
+		CC3BenchmarkRandomizeFloats(rigidMtx->colRow[3], 3);
+	}
+	CC3RandomUnseed();
+
+	NSMutableDictionary* results = [NSMutableDictionary dictionary];
+	results[@"simd"] = @(CC3_SIMD);
+	results[@"matrices"] = @(matCnt);
+	results[@"iterations"] = @(kCC3BenchmarkMatrixIterations);
+	NSUInteger checkCnt = sizeof(kCC3BenchmarkMatrixChecks) / sizeof(CC3BenchmarkMatrixCheck);
+	for (NSUInteger cIdx = 0; cIdx < checkCnt; cIdx++) {
+		const CC3BenchmarkMatrixCheck* check = &kCC3BenchmarkMatrixChecks[cIdx];
+		NSString* name = @(check->name);
+		results[name] = [self summaryOfMatrixOp: check->libOp reference: check->refOp named: name on: ops];
+	}
+	free(ops);
+	return results;
+}
+
+/**
+ * Compares the results of the specified library matrix function with those of the specified
+ * reference implementation, bit for bit, then times each implementation, and returns the results.
+ */
+-(NSDictionary*) summaryOfMatrixOp: (CC3BenchmarkMatrixOp) libOp
+						 reference: (CC3BenchmarkMatrixOp) refOp
+							 named: (NSString*) name
+								on: (const CC3BenchmarkMatrixOperands*) ops {
+	GLuint matCnt = kCC3BenchmarkMatrixCount;
+	GLuint iterCnt = kCC3BenchmarkMatrixIterations;
+	CC3Matrix4x4 libOut, refOut;
+	volatile GLfloat sink = 0.0f;	// Consumes results, so the timed loops are not optimized away
+	CCTime startTime, libTime, refTime;
+	GLuint mismatches = 0;
+
+	// Compare each library result with that of the reference implementation, bit for bit.
+	// Functions that produce vectors leave the rest of each zeroed output unchanged.
+	for (GLuint mIdx = 0; mIdx < matCnt; mIdx++) {
+		memset(&libOut, 0, sizeof(libOut));
+		memset(&refOut, 0, sizeof(refOut));
+		libOp(ops, mIdx, &libOut);
+		refOp(ops, mIdx, &refOut);
+		if (memcmp(&libOut, &refOut, sizeof(CC3Matrix4x4)) != 0) mismatches++;
+	}
+	LogErrorIf(mismatches, @"%u of %u %@ results differ from the reference implementation",
+			   mismatches, matCnt, name);
+
+	// Time each implementation
+	startTime = CC3PerformanceTimestamp();
+	for (GLuint iIdx = 0; iIdx < iterCnt; iIdx++) {
+		libOp(ops, iIdx % matCnt, &libOut);
+		sink += libOut.c1r1;
+	}
+	libTime = CC3PerformanceTimestamp() - startTime;
+
+	startTime = CC3PerformanceTimestamp();
+	for (GLuint iIdx = 0; iIdx < iterCnt; iIdx++) {
+		refOp(ops, iIdx % matCnt, &refOut);
+		sink += refOut.c1r1;
+	}
+	refTime = CC3PerformanceTimestamp() - startTime;
+
+	return CC3BenchmarkMatrixResults(mismatches, libTime, refTime);
+}
+
+-(BOOL) didMatrixBenchmarkSucceed: (NSDictionary*) results {
+	NSUInteger checkCnt = sizeof(kCC3BenchmarkMatrixChecks) / sizeof(CC3BenchmarkMatrixCheck);
+	for (NSUInteger cIdx = 0; cIdx < checkCnt; cIdx++)
+		if ([results[@(kCC3BenchmarkMatrixChecks[cIdx].name)][@"mismatches"] unsignedIntValue]) return NO;
+	return YES;
+}
+
+
+#pragma mark POD loading benchmark
+
+-(NSDictionary*) runPODLoadBenchmarkWithFile: (NSString*) filePath {
+	@autoreleasepool {
+		if ( ![self loadPODFile: filePath memoryMapped: NO] ) {
+			LogError(@"POD loading benchmark could not load %@", filePath);
+			return nil;
+		}
+	}
+	return @{ @"file": filePath.lastPathComponent,
+			  @"iterations": @(kCC3BenchmarkPODLoadIterations),
+			  @"mapped": [self summaryOfPODLoadsOfFile: filePath memoryMapped: YES],
+			  @"copied": [self summaryOfPODLoadsOfFile: filePath memoryMapped: NO], };
+}
+
+/** Loads the specified POD file, including building its nodes, and returns the loaded resource. */
+-(CC3PODResource*) loadPODFile: (NSString*) filePath memoryMapped: (BOOL) shouldMap {
+	CC3PODResource* rez = [CC3PODResource resource];
+	rez.shouldMemoryMapFile = shouldMap;
+	return [rez loadFromFile: filePath] ? rez : nil;
+}
+
+/**
+ * Loads the specified POD file repeatedly, in the specified loading mode, and returns the load times,
+ * the peak growth in resident memory during loading, and the growth that remains while the loaded
+ * resource is retained. Memory growth is the largest of any of the loads.
+ */
+-(NSDictionary*) summaryOfPODLoadsOfFile: (NSString*) filePath memoryMapped: (BOOL) shouldMap {
+	CCTime totalTime = 0.0, minTime = 0.0;
+	NSInteger peakGrowth = 0, heldGrowth = 0;
+	for (GLuint iIdx = 0; iIdx < kCC3BenchmarkPODLoadIterations; iIdx++) {
+		@autoreleasepool {
+			NSUInteger startBytes = CC3BenchmarkResidentBytes();
+			CC3BenchmarkMemorySampler sampler = { YES, startBytes };
+			pthread_t samplerThread;
+			BOOL isSampling = (pthread_create(&samplerThread, NULL, CC3BenchmarkSampleMemory, &sampler) == 0);
+
+			CCTime startTime = CC3PerformanceTimestamp();
+			CC3PODResource* rez = [self loadPODFile: filePath memoryMapped: shouldMap];
+			CCTime loadTime = CC3PerformanceTimestamp() - startTime;
+			NSUInteger heldBytes = CC3BenchmarkResidentBytes();
+
+			sampler.isSampling = NO;
+			if (isSampling) pthread_join(samplerThread, NULL);
+			LogErrorIf( !rez, @"POD loading benchmark could not load %@", filePath);
+
+			totalTime += loadTime;
+			minTime = (iIdx == 0) ? loadTime : MIN(minTime, loadTime);
+			peakGrowth = MAX(peakGrowth, (NSInteger)MAX(sampler.peakBytes, heldBytes) - (NSInteger)startBytes);
+			heldGrowth = MAX(heldGrowth, (NSInteger)heldBytes - (NSInteger)startBytes);
+		}
+	}
+	return @{ @"averageMs": CC3BenchmarkMillis(totalTime / kCC3BenchmarkPODLoadIterations),
+			  @"minMs": CC3BenchmarkMillis(minTime),
+			  @"peakResidentGrowthMB": CC3BenchmarkMegabytes(peakGrowth),
+			  @"heldResidentGrowthMB": CC3BenchmarkMegabytes(heldGrowth), };
+}
+
+
+#pragma mark CAF loading benchmark
+
+-(NSDictionary*) runCAFLoadBenchmark {
+	NSString* filePath = [NSTemporaryDirectory() stringByAppendingPathComponent: @"CC3Benchmark.caf"];
+	CC3RandomSeed(kCC3BenchmarkRandomSeed);
+	NSData* cafData = CC3BenchmarkCAFContent(kCC3BenchmarkCAFTrackCount, kCC3BenchmarkCAFKeyframeCount, 10.0f);
+	CC3RandomUnseed();
+	if ( ![cafData writeToFile: filePath atomically: YES] ) {
+		LogError(@"CAF loading benchmark could not write %@", filePath);
+		return nil;
+	}
+
+	GLuint iterCnt = kCC3BenchmarkCAFLoadIterations;
+	CCTime startTime, libTime = 0.0, refTime = 0.0;
+	GLuint mismatches = 0;
+	BOOL wasLoaded = YES;
+	for (GLuint iIdx = 0; iIdx < iterCnt && wasLoaded; iIdx++) {
+		@autoreleasepool {
+			startTime = CC3PerformanceTimestamp();
+			CC3CAFResource* rez = [CC3CAFResource resource];
+			rez.shouldSwapYZ = NO;
+			wasLoaded = [rez loadFromFile: filePath];
+			libTime += CC3PerformanceTimestamp() - startTime;
+
+			startTime = CC3PerformanceTimestamp();
+			NSArray* refNodes = CC3BenchmarkReadCAFNodes(filePath);
+			refTime += CC3PerformanceTimestamp() - startTime;
+
+			wasLoaded = wasLoaded && (refNodes != nil);
+			if (iIdx == 0) mismatches = CC3BenchmarkCountAnimationMismatches(rez.nodes, refNodes);
+		}
+	}
+	[NSFileManager.defaultManager removeItemAtPath: filePath error: NULL];
+
+	if ( !wasLoaded ) {
+		LogError(@"CAF loading benchmark could not load %@", filePath);
+		return nil;
+	}
+	LogErrorIf(mismatches, @"%u of %u CAF tracks differ from those read by the reference implementation",
+			   mismatches, kCC3BenchmarkCAFTrackCount);
+	return @{ @"tracks": @(kCC3BenchmarkCAFTrackCount),
+			  @"keyframesPerTrack": @(kCC3BenchmarkCAFKeyframeCount),
+			  @"iterations": @(iterCnt),
+			  @"mismatches": @(mismatches),
+			  @"libraryMs": CC3BenchmarkMillis(libTime / iterCnt),
+			  @"referenceMs": CC3BenchmarkMillis(refTime / iterCnt),
+			  @"speedup": @((libTime > 0.0) ? (refTime / libTime) : 0.0), };
+}
+
+
+#pragma mark Texture decompression benchmark
+
+-(NSDictionary*) runDecompressionBenchmark {
+	GLint texSize = kCC3BenchmarkDecompressSize;
+	GLuint iterCnt = kCC3BenchmarkDecompressIterations;
+	size_t contentBytes = texSize * texSize / 2;		// The largest format uses 4 bits per pixel
+	size_t pixelBytes = texSize * texSize * 4;
+	GLubyte* content = malloc(contentBytes);
+	GLubyte* pixels = malloc(pixelBytes);
+	GLubyte* refPixels = malloc(pixelBytes);
+	CCTime startTime, parTime, refTime;
+	GLuint mismatches = 0;
+
+	// Random bits are valid content in each of the compressed formats
+	CC3RandomSeed(kCC3BenchmarkRandomSeed);
+	for (size_t bIdx = 0; bIdx < contentBytes; bIdx++) content[bIdx] = (GLubyte)CC3RandomUIntBelow(256);
+	CC3RandomUnseed();
+
+	NSMutableDictionary* results = [NSMutableDictionary dictionary];
+	results[@"size"] = @(texSize);
+	results[@"iterations"] = @(iterCnt);
+	for (CC3BenchmarkCompression comp = 0; comp < kCC3BenchmarkCompressionCount; comp++) {
+		NSString* compName = CC3BenchmarkCompressionName(comp);
+
+		// Compare the parallel result with that of a single thread, byte for byte
+		CC3BenchmarkDecompress(comp, content, texSize, pixels, YES);
+		CC3BenchmarkDecompress(comp, content, texSize, refPixels, NO);
+		BOOL isIdentical = (memcmp(pixels, refPixels, pixelBytes) == 0);
+		LogErrorIf( !isIdentical, @"Parallel %@ decompression differs from decompression on a single thread", compName);
+		if ( !isIdentical ) mismatches++;
+
+		// Time each mode
+		startTime = CC3PerformanceTimestamp();
+		for (GLuint iIdx = 0; iIdx < iterCnt; iIdx++) CC3BenchmarkDecompress(comp, content, texSize, pixels, YES);
+		parTime = CC3PerformanceTimestamp() - startTime;
+
+		startTime = CC3PerformanceTimestamp();
+		for (GLuint iIdx = 0; iIdx < iterCnt; iIdx++) CC3BenchmarkDecompress(comp, content, texSize, refPixels, NO);
+		refTime = CC3PerformanceTimestamp() - startTime;
+
+		results[compName] = @{ @"identical": @(isIdentical),
+							   @"parallelMs": CC3BenchmarkMillis(parTime / iterCnt),
+							   @"singleThreadMs": CC3BenchmarkMillis(refTime / iterCnt),
+							   @"speedup": @((parTime > 0.0) ? (refTime / parTime) : 0.0), };
+	}
+	results[@"mismatches"] = @(mismatches);
+
+	free(content);
+	free(pixels);
+	free(refPixels);
+	return results;
+}
+
+
+#pragma mark Texture conversion benchmark
+
+-(NSDictionary*) runTextureConversionBenchmark {
+	GLuint texSize = kCC3BenchmarkTextureSize;
+	GLuint iterCnt = kCC3BenchmarkTextureIterations;
+	GLuint pixCnt = texSize * texSize;
+	size_t rgbaBytes = pixCnt * sizeof(ccColor4B);
+	ccColor4B* srcPixels = malloc(rgbaBytes);
+	ccColor4B* pixels = malloc(rgbaBytes);
+	ccColor4B* refPixels = malloc(rgbaBytes);
+	CCTime startTime, libTime, refTime;
+	GLuint mismatches = 0;
+
+	CC3RandomSeed(kCC3BenchmarkRandomSeed);
+	for (size_t bIdx = 0; bIdx < rgbaBytes; bIdx++) ((GLubyte*)srcPixels)[bIdx] = (GLubyte)CC3RandomUIntBelow(256);
+	CC3RandomUnseed();
+
+	NSMutableDictionary* results = [NSMutableDictionary dictionary];
+	results[@"size"] = @(texSize);
+	results[@"iterations"] = @(iterCnt);
+	NSUInteger fmtCnt = sizeof(kCC3BenchmarkPixelFormats) / sizeof(CC3BenchmarkPixelFormat);
+	for (NSUInteger fIdx = 0; fIdx < fmtCnt; fIdx++) {
+		const CC3BenchmarkPixelFormat* fmt = &kCC3BenchmarkPixelFormats[fIdx];
+		NSString* fmtName = @(fmt->name);
+		GLuint bytesPerRow = texSize * fmt->bytesPerPixel;
+		size_t fmtBytes = bytesPerRow * texSize;
+		NSMutableDictionary* fmtResults = [NSMutableDictionary dictionary];
+
+		// Conversion is performed in place, so each conversion starts from a fresh copy of the
+		// source pixels. Only the conversion itself is timed.
+		libTime = refTime = 0.0;
+		for (GLuint iIdx = 0; iIdx < iterCnt; iIdx++) {
+			memcpy(pixels, srcPixels, rgbaBytes);
+			startTime = CC3PerformanceTimestamp();
+			CC3ConvertRGBA8888Pixels(pixels, pixCnt, fmt->pixelFormat, fmt->pixelType);
+			libTime += CC3PerformanceTimestamp() - startTime;
+
+			memcpy(refPixels, srcPixels, rgbaBytes);
+			startTime = CC3PerformanceTimestamp();
+			CC3BenchmarkConvertRGBA8888Pixels(refPixels, pixCnt, fmt->pixelFormat, fmt->pixelType);
+			refTime += CC3PerformanceTimestamp() - startTime;
+		}
+		BOOL isIdentical = (memcmp(pixels, refPixels, fmtBytes) == 0);
+		LogErrorIf( !isIdentical, @"Conversion of RGBA pixels to %@ differs from the reference implementation", fmtName);
+		if ( !isIdentical ) mismatches++;
+		fmtResults[@"convert"] = CC3BenchmarkTextureResults(isIdentical, libTime, refTime);
+
+		// Flip and rotate the converted pixels. Each implementation starts from the same pixels.
+		NSUInteger checkCnt = sizeof(kCC3BenchmarkPixelChecks) / sizeof(CC3BenchmarkPixelCheck);
+		for (NSUInteger cIdx = 0; cIdx < checkCnt; cIdx++) {
+			const CC3BenchmarkPixelCheck* check = &kCC3BenchmarkPixelChecks[cIdx];
+			NSString* checkName = @(check->name);
+			memcpy(refPixels, pixels, fmtBytes);
+
+			check->libOp((GLubyte*)pixels, texSize, bytesPerRow, fmt->bytesPerPixel);
+			check->refOp((GLubyte*)refPixels, texSize, bytesPerRow, fmt->bytesPerPixel);
+			isIdentical = (memcmp(pixels, refPixels, fmtBytes) == 0);
+			LogErrorIf( !isIdentical, @"%@ of %@ pixels differs from the reference implementation", checkName, fmtName);
+			if ( !isIdentical ) mismatches++;
+
+			startTime = CC3PerformanceTimestamp();
+			for (GLuint iIdx = 0; iIdx < iterCnt; iIdx++)
+				check->libOp((GLubyte*)pixels, texSize, bytesPerRow, fmt->bytesPerPixel);
+			libTime = CC3PerformanceTimestamp() - startTime;
+
+			startTime = CC3PerformanceTimestamp();
+			for (GLuint iIdx = 0; iIdx < iterCnt; iIdx++)
+				check->refOp((GLubyte*)refPixels, texSize, bytesPerRow, fmt->bytesPerPixel);
+			refTime = CC3PerformanceTimestamp() - startTime;
+
+			fmtResults[checkName] = CC3BenchmarkTextureResults(isIdentical, libTime, refTime);
+		}
+		results[fmtName] = fmtResults;
+	}
+	results[@"mismatches"] = @(mismatches);
+
+	free(srcPixels);
+	free(pixels);
+	free(refPixels);
+	return results;
+}
+
+/**
+ * Directs drawing of the scene to a section of the shared off-screen view surface,
+ * and aligns the camera viewport with that surface, as CC3Layer would do for a view.
+ */
+-(void) attachSurfaces {
+	CC3IntSize surfSize = kCC3BenchmarkSurfaceSize;
+	CC3SceneDrawingSurfaceManager* surfMgr = [CC3SceneDrawingSurfaceManager surfaceManager];
+	surfMgr.size = surfSize;
+	_scene.viewDrawingVisitor.surfaceManager = surfMgr;
+	_scene.activeCamera.viewport = CC3ViewportMake(0, 0, surfSize.width, surfSize.height);
+}
+
+/**
+ * Steps the scene through one frame. The Cocos2D scheduler is stepped first, to run
+ * any actions, such as animations, in the same way the CCDirector does on each frame.
+ */
+-(void) stepWithDeltaTime: (CCTime) dt {
+	[CCDirector.sharedDirector.scheduler update: dt];
+	[_scene updateScene: dt];
+	[_scene drawSceneWithVisitor: _scene.viewDrawingVisitor];
+}
+
+
+#pragma mark Results
+
+-(NSDictionary*) summaryOfFrameTimes: (CCTime*) frameTimes count: (GLuint) count {
+	CCTime totalTime = 0.0;
+	for (GLuint fIdx = 0; fIdx < count; fIdx++) totalTime += frameTimes[fIdx];
+
+	qsort(frameTimes, count, sizeof(CCTime), CC3BenchmarkCompareTimes);
+	return @{ @"average": CC3BenchmarkMillis(totalTime / count),
+			  @"min": CC3BenchmarkMillis(frameTimes[0]),
+			  @"max": CC3BenchmarkMillis(frameTimes[count - 1]),
+			  @"p50": CC3BenchmarkMillis(CC3BenchmarkPercentile(frameTimes, count, 50.0f)),
+			  @"p95": CC3BenchmarkMillis(CC3BenchmarkPercentile(frameTimes, count, 95.0f)),
+			  @"p99": CC3BenchmarkMillis(CC3BenchmarkPercentile(frameTimes, count, 99.0f)), };
+}
+
+-(NSDictionary*) summaryOfPhases: (CC3PerformanceStatistics*) stats {
+	NSMutableDictionary* phases = [NSMutableDictionary dictionary];
+	for (CC3PerformancePhase phase = 0; phase < kCC3PerformancePhaseCount; phase++) {
+		GLuint count = [stats countOfPhase: phase];
+		if ( !count ) continue;
+		phases[NSStringFromCC3PerformancePhase(phase)] =
+			@{ @"count": @(count),
+			   @"total": CC3BenchmarkMillis([stats totalDurationOfPhase: phase]),
+			   @"average": CC3BenchmarkMillis([stats averageDurationOfPhase: phase]),
+			   @"min": CC3BenchmarkMillis([stats minimumDurationOfPhase: phase]),
+			   @"max": CC3BenchmarkMillis([stats maximumDurationOfPhase: phase]),
+			   @"p50": CC3BenchmarkMillis([stats durationOfPhase: phase atPercentile: 50.0f]),
+			   @"p95": CC3BenchmarkMillis([stats durationOfPhase: phase atPercentile: 95.0f]), };
+	}
+	return phases;
+}
+
+-(NSDictionary*) summaryOfPhaseAllocations: (CC3PerformanceStatistics*) stats {
+	NSMutableDictionary* phases = [NSMutableDictionary dictionary];
+	for (CC3PerformancePhase phase = 0; phase < kCC3PerformancePhaseCount; phase++) {
+		if ( ![stats countOfPhase: phase] ) continue;
+		phases[NSStringFromCC3PerformancePhase(phase)] =
+			@{ @"count": @([stats allocationCountOfPhase: phase]),
+			   @"bytes": @([stats allocatedBytesOfPhase: phase]),
+			   @"average": @([stats averageAllocationCountOfPhase: phase]), };
+	}
+	return phases;
+}
+
+-(NSDictionary*) summaryOfNodes {
+	GLuint meshNodeCount = 0;
+	GLuint particleCount = 0;
+	NSArray* allNodes = [_scene flatten];
+	for (CC3Node* aNode in allNodes) {
+		if (aNode.isMeshNode) meshNodeCount++;
+		if ( [aNode isKindOfClass: CC3ParticleEmitter.class] )
+			particleCount += ((CC3ParticleEmitter*)aNode).particleCount;
+	}
+	return @{ @"total": @(allNodes.count),
+			  @"meshNodes": @(meshNodeCount),
+			  @"particles": @(particleCount), };
+}
+
+
+#pragma mark Launch arguments
+
++(BOOL) isRequestedByLaunchArguments {
+	return [NSUserDefaults.standardUserDefaults stringForKey: kCC3BenchmarkKey] != nil;
+}
+
+/** Returns the standard scenarios selected by the launch arguments, configured by those arguments. */
++(NSArray*) scenariosFromLaunchArguments {
+	NSUserDefaults* args = NSUserDefaults.standardUserDefaults;
+	NSString* selection = [args stringForKey: kCC3BenchmarkKey];
+	NSArray* names = [selection componentsSeparatedByString: @","];
+	BOOL shouldRunAll = [selection isEqualToString: kCC3BenchmarkAll];
+	GLint frameCount = (GLint)[args integerForKey: kCC3BenchmarkFramesKey];
+	CCTime deltaTime = [args doubleForKey: kCC3BenchmarkDeltaTimeKey];
+
+	NSMutableArray* scenarios = [NSMutableArray array];
+	for (CC3BenchmarkScenario* scenario in [CC3BenchmarkScenario standardScenarios]) {
+		if ( !(shouldRunAll || [names containsObject: scenario.name]) ) continue;
+		if (frameCount > 0) scenario.frameCount = frameCount;
+		if (deltaTime > 0.0) scenario.deltaTime = deltaTime;
+		[scenarios addObject: scenario];
+	}
+	LogErrorIf(scenarios.count == 0, @"No benchmark scenarios match \"%@\"", selection);
+	return scenarios;
+}
+
++(BOOL) runFromLaunchArguments {
+	NSUserDefaults* args = NSUserDefaults.standardUserDefaults;
+	NSArray* scenarios = [self scenariosFromLaunchArguments];
+	if (scenarios.count == 0) return NO;
+
+	// Render to an off-screen surface, without invoking the GL engine
+	CC3IntSize surfSize = kCC3BenchmarkSurfaceSize;
+	[CC3OpenGL setOpenGLClass: CC3OpenGLNull.class];
+	[CC3ViewSurfaceManager setSharedViewSurfaceManager: [[CC3ViewSurfaceManager alloc] initWithSize: surfSize
+																					withColorFormat: GL_RGBA8
+																					 andDepthFormat: GL_DEPTH24_STENCIL8]];
+
+	NSString* tracePath = [args stringForKey: kCC3BenchmarkTraceKey];
+#if CC3_TRACING_ENABLED
+	if (tracePath) CC3TraceStartRecording(kCC3TraceDefaultCapacity);
+#else
+	LogErrorIf(tracePath, @"Tracing is not available. Set CC3_TRACING_ENABLED to record a trace.");
+#endif	// CC3_TRACING_ENABLED
+
+	CC3PerformanceBenchmark* benchmark = [self new];
+	benchmark.shouldTrackAllocations = [args boolForKey: kCC3BenchmarkAllocationsKey];
+	LogErrorIf(benchmark.shouldTrackAllocations && !CC3_ALLOCATION_TRACKING_ENABLED,
+			   @"Allocations cannot be counted. Set CC3_ALLOCATION_TRACKING_ENABLED to count allocations.");
+	NSArray* results = [benchmark runScenarios: scenarios];
+	NSDictionary* matrixResults = [benchmark runMatrixBenchmark];
+	NSString* podFile = [args stringForKey: kCC3BenchmarkPODFileKey];
+	NSDictionary* podLoadResults = [benchmark runPODLoadBenchmarkWithFile: (podFile ? podFile : kCC3BenchmarkPODFile)];
+	NSDictionary* cafLoadResults = [benchmark runCAFLoadBenchmark];
+	NSDictionary* decompressResults = [benchmark runDecompressionBenchmark];
+	NSDictionary* textureResults = [benchmark runTextureConversionBenchmark];
+
+	BOOL didSucceed = (results.count == scenarios.count);
+	if ( ![benchmark didMatrixBenchmarkSucceed: matrixResults] ) {
+		LogError(@"Matrix functions produced results that differ from the scalar reference implementation");
+		didSucceed = NO;
+	}
+	if ( !podLoadResults ) didSucceed = NO;
+	if ( !cafLoadResults || [cafLoadResults[@"mismatches"] unsignedIntValue] ) didSucceed = NO;
+	if ( [decompressResults[@"mismatches"] unsignedIntValue] ) didSucceed = NO;
+	if ( [textureResults[@"mismatches"] unsignedIntValue] ) didSucceed = NO;
+	for (NSDictionary* scenarioResults in results) {
+		if ( [benchmark didScenarioSucceed: scenarioResults] ) continue;
+		NSDictionary* allocs = scenarioResults[@"allocations"];
+		if ( [allocs[@"tracked"] boolValue] )
+			LogError(@"Benchmark %@ allocated memory during %@ of its frames, but is expected to be allocation-free",
+					 scenarioResults[@"scenario"][@"name"], allocs[@"framesAllocating"]);
+		else
+			LogError(@"Benchmark %@ is expected to be allocation-free, but allocations could not be counted",
+					 scenarioResults[@"scenario"][@"name"]);
+		didSucceed = NO;
+	}
+
+#if CC3_TRACING_ENABLED
+	if (tracePath) {
+		CC3TraceStopRecording();
+		CC3TraceWriteToFile(tracePath);
+	}
+#endif	// CC3_TRACING_ENABLED
+
+	NSMutableDictionary* report = [NSMutableDictionary dictionary];
+	NSString* label = [args stringForKey: kCC3BenchmarkLabelKey];
+	if (label) report[@"label"] = label;
+	report[@"surfaceSize"] = @[ @(surfSize.width), @(surfSize.height) ];
+	report[@"results"] = results;
+	report[@"matrices"] = matrixResults;
+	if (podLoadResults) report[@"podLoad"] = podLoadResults;
+	if (cafLoadResults) report[@"cafLoad"] = cafLoadResults;
+	report[@"decompression"] = decompressResults;
+	report[@"textureConversion"] = textureResults;
+
+	NSError* err = nil;
+	NSData* json = [NSJSONSerialization dataWithJSONObject: report
+												   options: NSJSONWritingPrettyPrinted
+													 error: &err];
+	if ( !json ) {
+		LogError(@"Could not serialize benchmark results: %@", err);
+		return NO;
+	}
+
+	NSString* outPath = [args stringForKey: kCC3BenchmarkOutputKey];
+	if ( !outPath ) {
+		[NSFileHandle.fileHandleWithStandardOutput writeData: json];
+		return didSucceed;
+	}
+	if ( ![json writeToFile: outPath options: NSDataWritingAtomic error: &err] ) {
+		LogError(@"Could not write benchmark results to %@: %@", outPath, err);
+		return NO;
+	}
+	LogInfo(@"Wrote results of %lu benchmarks to %@", (unsigned long)results.count, outPath);
+	return didSucceed;
+}
+
+@end
+
+#else
+
+/** CC3OpenGLNull, which the benchmarks render through, requires a programmable pipeline. */
+@implementation CC3PerformanceBenchmark
+
+@synthesize shouldTrackAllocations=_shouldTrackAllocations;
+
+-(NSDictionary*) runScenario: (CC3BenchmarkScenario*) scenario { return nil; }
+
+-(BOOL) didScenarioSucceed: (NSDictionary*) results { return NO; }
+
+-(NSArray*) runScenarios: (NSArray*) scenarios { return nil; }
+
+-(NSDictionary*) runMatrixBenchmark { return nil; }
+
+-(BOOL) didMatrixBenchmarkSucceed: (NSDictionary*) results { return NO; }
+
+-(NSDictionary*) runPODLoadBenchmarkWithFile: (NSString*) filePath { return nil; }
+
+-(NSDictionary*) runCAFLoadBenchmark { return nil; }
+
+-(NSDictionary*) runDecompressionBenchmark { return nil; }
+
+-(NSDictionary*) runTextureConversionBenchmark { return nil; }
+
++(BOOL) isRequestedByLaunchArguments {
+	return [NSUserDefaults.standardUserDefaults stringForKey: kCC3BenchmarkKey] != nil;
+}
+
++(BOOL) runFromLaunchArguments {
+	LogError(@"Benchmarks require a programmable-pipeline OpenGL engine.");
+	return NO;
+}
+
+@end
+
+#endif	// CC3_GLSL
@@ -32,6 +32,13 @@
 #import "NodeGrid.h"
 
 
+// Names of some of the template nodes, used by CC3PerformanceBenchmark to select templates.
+#define kBoxTemplateName			@"Simple box"
+#define kMascotTemplateName			@"Textured medium-poly model mesh"
+#define kSkinnedTemplateName		@"Vertex-skinned, bump-mapped mesh with matrix-animated bones."
+#define kParticleTemplateName		@"Point particle hose emitter"
+
+
 /**
  * This application-specific CC3Scene provides a platform for testing and displaying
  * various performance-related aspects of Cocos3D.
@@ -67,6 +74,7 @@
 	GLint _templateIndex;
 	GLuint _flapTrack;
 	BOOL _shouldAnimateNodes : 1;
+	BOOL _shouldCastShadows : 1;
 }
 
 @property(nonatomic, readonly) NSMutableArray* availableTemplateNodes;
@@ -106,6 +114,15 @@
  */
 @property(nonatomic, assign) BOOL shouldAnimateNodes;
 
+/**
+ * Indicates whether the node copies should cast shadows, using shadow volumes,
+ * from the light in the scene.
+ *
+ * Shadow volumes add load to both the CPU and GPU, and require a stencil buffer.
+ * The initial value of this property is NO.
+ */
+@property(nonatomic, assign) BOOL shouldCastShadows;
+
 /** Increases the number of nodes being displayed. */
 -(void) increaseNodes;
 
@@ -118,6 +135,14 @@
 /** Changes the type of nodes being displayed to the previous node type. */
 -(void) prevNodeType;
 
+/**
+ * Changes the type of nodes being displayed to the template node with the specified name.
+ *
+ * Returns whether a template node with the specified name was found in the
+ * availableTemplateNodes property. If not, the type of nodes is not changed.
+ */
+-(BOOL) selectTemplateNodeNamed: (NSString*) name;
+
 @end
 
 /**
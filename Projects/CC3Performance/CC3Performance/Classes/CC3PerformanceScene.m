@@ -40,6 +40,8 @@
 #import "CC3UtilityMeshNodes.h"
 #import "CC3VertexSkinning.h"
 #import "CC3Actions.h"
+#import "CC3PointParticleSamples.h"
+#import "CC3ShadowVolumes.h"
 
 // Model names
 #define kNodeGridName			@"NodeGrid"
@@ -62,6 +64,7 @@
 
 @synthesize availableTemplateNodes=_availableTemplateNodes, templateNode=_templateNode;
 @synthesize perSideCount=_perSideCount, shouldAnimateNodes=_shouldAnimateNodes;
+@synthesize shouldCastShadows=_shouldCastShadows;
 @synthesize playerDirectionControl=_playerDirectionControl;
 @synthesize playerLocationControl=_playerLocationControl;
 
@@ -90,6 +93,13 @@
 	[self animationWasChanged];
 }
 
+/** When shadows are turned on or off, add or remove shadow volumes from the node copies. */
+-(void) setShouldCastShadows: (BOOL) shouldCastShadows {
+	if (_shouldCastShadows == shouldCastShadows) return;
+	_shouldCastShadows = shouldCastShadows;
+	[self shadowsWereChanged];
+}
+
 /**
  * Constructs the 3D scene.
  *
@@ -112,6 +122,7 @@
 	self.drawingSequencer.allowSequenceUpdates = NO;
 
 	_shouldAnimateNodes = NO;	// Start with static nodes.
+	_shouldCastShadows = NO;	// Start without shadows.
 
 	// Create the camera, place it back a bit, and add it to the scene
 	CC3Camera* cam = [CC3Camera nodeWithName: @"Camera"];
@@ -149,7 +160,7 @@
 	[self configureAndAddTemplate: meshNode];
 	
 	// Simple box. Only 6 faces per node.
-	CC3BoxNode* boxNode = [CC3BoxNode nodeWithName: @"Simple box"];
+	CC3BoxNode* boxNode = [CC3BoxNode nodeWithName: kBoxTemplateName];
 	CC3Box box = CC3BoxFromMinMax(cc3v(-10.0, -10.0, -10.0), cc3v( 10.0,  10.0,  10.0));
 	[boxNode populateAsSolidBox: box];
 	boxNode.color = CCColorRefFromCCC4F(kCCC4FOrange);
@@ -187,7 +198,7 @@
 	rezNode = [CC3PODResourceNode nodeFromFile: kMascotPODFile
 			  expectsVerticallyFlippedTextures: YES];
 	aNode = [rezNode getNodeNamed: kMascotName];
-	aNode.name = @"Textured medium-poly model mesh";
+	aNode.name = kMascotTemplateName;
 	aNode.rotation = cc3v(0.0, -90.0, 0.0);
 	aNode.uniformScale = 5.0;
 	[self configureAndAddTemplate: aNode];
@@ -242,7 +253,7 @@
 	// from the base animation and add those distinct movement animations as separate tracks.
 	rezNode = [CC3PODResourceNode nodeFromFile: @"Dragon.pod"];
 	aNode = [rezNode getNodeNamed: @"Dragon.pod-SoftBody"];
-	aNode.name = @"Vertex-skinned, bump-mapped mesh with matrix-animated bones.";
+	aNode.name = kSkinnedTemplateName;
 	aNode.uniformScale = 0.5;
 	_flapTrack = [aNode addAnimationFromFrame: 61 toFrame: 108];
 	[self configureAndAddTemplate: aNode];
@@ -266,6 +277,17 @@
 	[aNode removeShaders];			// Clear shaders to reselect rigid bone shaders
 	[self configureAndAddTemplate: aNode];
 	
+	// Point particle emitter. Each copy builds its own dynamic particle mesh, so the
+	// template does not need GL buffers. The copies are started when the grid is laid out.
+	CC3VariegatedPointParticleHoseEmitter* emitter = [CC3VariegatedPointParticleHoseEmitter nodeWithName: kParticleTemplateName];
+	emitter.vertexContentTypes = kCC3VertexContentLocation | kCC3VertexContentColor | kCC3VertexContentPointSize;
+	emitter.texture = [CC3Texture textureFromFile: kLogoFileName];
+	emitter.emissionRate = 100.0f;
+	emitter.unityScaleDistance = 200.0;
+	emitter.boundingVolumePadding = 20.0;
+	[emitter selectShaders];
+	[_availableTemplateNodes addObject: emitter];
+	
 	// Start with one copy of the first available template node.
 	_templateIndex = 0;
 	self.templateNode = (CC3Node*)[_availableTemplateNodes objectAtIndex: _templateIndex];
@@ -286,6 +308,14 @@
 
 #pragma mark Updating
 
+/** Adds or removes shadow volumes on the node copies, using the lights in the scene. */
+-(void) shadowsWereChanged {
+	if (_shouldCastShadows)
+		[_nodeGrid addShadowVolumes];
+	else
+		[_nodeGrid removeShadowVolumes];
+}
+
 -(void) animationWasChanged {
 	if ( !_templateNode.containsAnimation) return;
 
@@ -342,8 +372,18 @@
 	}
 }
 
-/** Layout (perSideCount * perSideCount) copies of the templateNode into a grid. */
--(void) layoutGrid { [_nodeGrid populateWith: self.templateNode perSide: self.perSideCount]; }
+/**
+ * Layout (perSideCount * perSideCount) copies of the templateNode into a grid,
+ * start any particle emitters, and add shadow volumes if they are in use.
+ */
+-(void) layoutGrid {
+	[_nodeGrid populateWith: self.templateNode perSide: self.perSideCount];
+	
+	if ( [self.templateNode isKindOfClass: CC3ParticleEmitter.class] )
+		for (CC3ParticleEmitter* emitter in _nodeGrid.children) [emitter play];
+
+	if (_shouldCastShadows) [self shadowsWereChanged];
+}
 
 -(void) increaseNodes { self.perSideCount++; }
 
@@ -361,6 +401,17 @@
 	self.templateNode = [_availableTemplateNodes objectAtIndex: _templateIndex];
 }
 
+-(BOOL) selectTemplateNodeNamed: (NSString*) name {
+	NSUInteger tIdx = [_availableTemplateNodes indexOfObjectPassingTest: ^BOOL(CC3Node* aNode, NSUInteger idx, BOOL* stop) {
+		return [aNode.name isEqualToString: name];
+	}];
+	if (tIdx == NSNotFound) return NO;
+
+	_templateIndex = (GLint)tIdx;
+	self.templateNode = [_availableTemplateNodes objectAtIndex: _templateIndex];
+	return YES;
+}
+
 /**
  * Choose the update visitor class to use based on whether the nodes should be animated
  * to force the transform matrices of each node to be recalculated on each update.
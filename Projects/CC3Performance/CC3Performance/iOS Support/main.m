@@ -28,9 +28,14 @@
  */
 
 #import <UIKit/UIKit.h>
+#import "CC3PerformanceBenchmark.h"
 
 int main(int argc, char *argv[]) {
 	@autoreleasepool {
+		// When launched with the -CC3Benchmark argument, run the benchmarks headless and exit.
+		if (CC3PerformanceBenchmark.isRequestedByLaunchArguments)
+			return CC3PerformanceBenchmark.runFromLaunchArguments ? 0 : 1;
+
 		return UIApplicationMain(argc, argv, nil, @"CC3PerformanceAppDelegate");
 	}
 }
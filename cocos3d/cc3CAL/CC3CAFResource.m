@@ -162,6 +162,16 @@ static BOOL _defaultShouldSwapYZ = YES;
 	return !reader.wasReadBeyondEOF;
 }
 
+/**
+ * The structure of a single keyframe within a CAF file. Each element is a 4-byte float,
+ * allowing all of the keyframes of a track to be read in bulk.
+ */
+typedef struct {
+	GLfloat time;				/**< Time of keyframe in seconds. */
+	CC3Vector location;			/**< Translation relative to parent bone. */
+	CC3Quaternion quaternion;	/**< Rotation relative to parent bone. */
+} CC3CAFKeyframe;
+
 /** Reads a single node and its animation from the content in the specified reader. */
 -(BOOL)	readNodeFrom: (CC3DataReader*) reader {
 	//	[tracks]
@@ -178,6 +188,9 @@ static BOOL _defaultShouldSwapYZ = YES;
 	// If no animation content, skip this node
 	if (frameCount <= 0) return YES;
 
+	// Ensure the file actually contains the keyframes it claims, before allocating space for them
+	if ( ![self reader: reader containsKeyframes: (GLuint)frameCount forNodeWithCALIndex: calNodeIdx] ) return NO;
+
 	// Create and populate the animation instance
 	CC3ArrayNodeAnimation* anim = [CC3ArrayNodeAnimation animationWithFrameCount: (GLuint)frameCount];
 	if ( ![self populateAnimation: anim from: reader] ) return NO;
@@ -191,7 +204,24 @@ static BOOL _defaultShouldSwapYZ = YES;
 	return YES;
 }
 
-/** Populates the specified animation from the content in the specified reader. */
+/**
+ * Returns whether the remaining content of the specified reader is large enough to hold the
+ * specified number of keyframes, logging an error if it is not.
+ */
+-(BOOL) reader: (CC3DataReader*) reader containsKeyframes: (GLuint) frameCount forNodeWithCALIndex: (GLint) calNodeIdx {
+	if (frameCount <= (reader.bytesRemaining / sizeof(CC3CAFKeyframe))) return YES;
+
+	LogError(@"%@ node with CAL index %i claims %u keyframes, but only %lu bytes remain in the file",
+			 self, calNodeIdx, frameCount, (unsigned long)reader.bytesRemaining);
+	return NO;
+}
+
+/**
+ * Populates the specified animation from the content in the specified reader.
+ *
+ * The reader must have been checked to contain all of the keyframes of the animation,
+ * using the reader:containsKeyframes:forNodeWithCALIndex: method.
+ */
 -(BOOL)	populateAnimation: (CC3ArrayNodeAnimation*) anim from: (CC3DataReader*) reader {
 	//	[keyframes]
 	//		time                   4       float     time of keyframe in seconds
@@ -203,48 +233,46 @@ static BOOL _defaultShouldSwapYZ = YES;
 	//		rotation z             4       float
 	//		rotation w             4       float
 
+	// Read all of the keyframes of the track in bulk
+	GLuint frameCount = anim.frameCount;
+	CC3CAFKeyframe* keyframes = malloc(frameCount * sizeof(CC3CAFKeyframe));
+	if ( !keyframes ) {
+		LogError(@"%@ could not allocate space for %u keyframes", self, frameCount);
+		return NO;
+	}
+	if ( ![reader readAll: frameCount records: keyframes ofLength: sizeof(CC3CAFKeyframe)] ) {
+		free(keyframes);
+		return NO;
+	}
+
 	// Allocate the animation content arrays
 	CCTime* frameTimes = anim.allocateFrameTimes;
 	CC3Vector* locations = anim.allocateLocations;
 	CC3Quaternion* quaternions = anim.allocateQuaternions;
 
-	GLuint frameCount = anim.frameCount;
 	for (GLuint fIdx = 0; fIdx < frameCount; fIdx++) {
-		
+		CC3CAFKeyframe* kf = &keyframes[fIdx];
+
 		// Frame time, normalized to range between 0 and 1.
-		frameTimes[fIdx] = CLAMP(reader.readFloat / _animationDuration, 0.0f, 1.0f);
+		frameTimes[fIdx] = CLAMP(kf->time / _animationDuration, 0.0f, 1.0f);
 
 		// Location and rotation at frame
 		if (_shouldSwapYZ) {
-			
-			locations[fIdx].x = reader.readFloat;
-			locations[fIdx].z = -reader.readFloat;		// Swap for negated Y
-			locations[fIdx].y = reader.readFloat;		// Swap for Z
-
-			quaternions[fIdx].x = reader.readFloat;
-			quaternions[fIdx].z = -reader.readFloat;	// Swap for negated Y
-			quaternions[fIdx].y = reader.readFloat;		// Swap for Z
-			quaternions[fIdx].w = reader.readFloat;
-
+			locations[fIdx] = cc3v(kf->location.x, kf->location.z, -kf->location.y);
+			quaternions[fIdx] = CC3QuaternionMake(kf->quaternion.x, kf->quaternion.z,
+												  -kf->quaternion.y, kf->quaternion.w);
 		} else {
-
-			locations[fIdx].x = reader.readFloat;
-			locations[fIdx].y = reader.readFloat;
-			locations[fIdx].z = reader.readFloat;
-
-			quaternions[fIdx].x = reader.readFloat;
-			quaternions[fIdx].y = reader.readFloat;
-			quaternions[fIdx].z = reader.readFloat;
-			quaternions[fIdx].w = reader.readFloat;
-
+			locations[fIdx] = kf->location;
+			quaternions[fIdx] = kf->quaternion;
 		}
 
 		LogTrace(@"Time: %.4f Loc: %@ Quat: %@ in frame %i",
 				 frameTimes[fIdx], NSStringFromCC3Vector(locations[fIdx]),
 				 NSStringFromCC3Quaternion(quaternions[fIdx]), fIdx);
 	}
-	
-	return !reader.wasReadBeyondEOF;
+
+	free(keyframes);
+	return YES;
 }
 
 
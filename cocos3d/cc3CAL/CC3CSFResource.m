@@ -130,6 +130,18 @@
 	return !reader.wasReadBeyondEOF;
 }
 
+/**
+ * The structure of the transforms and parent index of a single bone within a CSF file.
+ * Each element is 4 bytes long, allowing the structure to be read in bulk.
+ */
+typedef struct {
+	CC3Vector location;				/**< Translation relative to parent bone. */
+	CC3Quaternion quaternion;		/**< Rotation relative to parent bone. */
+	CC3Vector vtxTranslation;		/**< Translation to bring a vertex from model space into bone space. */
+	CC3Quaternion vtxQuaternion;	/**< Rotation to bring a vertex from model space into bone space. */
+	int parentIndex;				/**< Index of the parent bone. */
+} CC3CSFBoneTransforms;
+
 /** Reads a single node, with the specified index, from the content. */
 -(BOOL)	readNode: (int) nodeIdx from: (CC3DataReader*) reader {
 	//	[nodes]
@@ -167,33 +179,14 @@
 		nodeName = [NSString stringWithUTF8String: cNodeName];
 	}
 
-	// Node location
-	CC3Vector location;
-	location.x = reader.readFloat;
-	location.y = reader.readFloat;
-	location.z = reader.readFloat;
-	
-	// Node rotation quaternion
-	CC3Quaternion quaternion;
-	quaternion.x = reader.readFloat;
-	quaternion.y = reader.readFloat;
-	quaternion.z = reader.readFloat;
-	quaternion.w = reader.readFloat;
-	
-	// Node vertex translation - ignored
-	CC3Vector vtxTranslation;
-	vtxTranslation.x = reader.readFloat;
-	vtxTranslation.y = reader.readFloat;
-	vtxTranslation.z = reader.readFloat;
-	
-	// Node vertex rotation quaternion - ignored
-	CC3Quaternion vtxQuaternion;
-	vtxQuaternion.x = reader.readFloat;
-	vtxQuaternion.y = reader.readFloat;
-	vtxQuaternion.z = reader.readFloat;
-	vtxQuaternion.w = reader.readFloat;
-	
-	int parentIndex = reader.readInteger;
+	// Node transforms and parent index, read in bulk
+	CC3CSFBoneTransforms xfms;
+	[reader readAll: 1 records: &xfms ofLength: sizeof(xfms)];
+	CC3Vector location = xfms.location;
+	CC3Quaternion quaternion = xfms.quaternion;
+	CC3Vector vtxTranslation = xfms.vtxTranslation;		// ignored
+	CC3Quaternion vtxQuaternion = xfms.vtxQuaternion;	// ignored
+	int parentIndex = xfms.parentIndex;
 	
 	// Create the node and populate it with content extracted from the reader.
 	CC3CALNode* calNode = [CC3CALNode nodeWithName: nodeName];
@@ -205,16 +198,14 @@
 	// Bone color
 	ccColor4F boneColor = kCCC4FBlack;
 	if (_fileVersion >= 1300) {
-		[reader readInteger];				// Lighting type - ignored
-		boneColor.r = reader.readFloat;
-		boneColor.g = reader.readFloat;
-		boneColor.b = reader.readFloat;
+		[reader skipBytes: sizeof(int)];	// Lighting type - ignored
+		[reader readAll: 3 floats: &boneColor.r];
 		calNode.diffuseColor = boneColor;
 	}
 
-	// Skip through the indexes of all the children. This content is ignored.
-	NSInteger childCount = reader.readInteger;
-	for (NSInteger i = 0; i < childCount; i++) [reader readInteger];
+	// Skip over the indexes of all the children. This content is ignored.
+	int childCount = reader.readInteger;
+	if (childCount > 0) [reader skipBytes: (childCount * sizeof(int))];
 	
 	// Add the node to the collection of unstructured nodes
 	[_allNodes addObject: calNode];
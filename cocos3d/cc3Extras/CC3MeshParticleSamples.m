@@ -244,7 +244,7 @@
 	NSUInteger tmCount = _particleTemplateMeshes.count + (_particleTemplateMesh ? 1 : 0);
 	CC3Assert(tmCount > 0, @"No particle template meshes available in %@. Use the addParticleTemplateMesh: method to add template meshes for the particles.", self);
 
-	NSUInteger tmIdx = CC3RandomUIntBelow(tmCount);
+	NSUInteger tmIdx = CC3RandomStreamUIntBelow(self.randomStream, (uint32_t)tmCount);
 	aParticle.templateMesh = (tmIdx < _particleTemplateMeshes.count)
 									? [_particleTemplateMeshes objectAtIndex: tmIdx]
 									: _particleTemplateMesh;
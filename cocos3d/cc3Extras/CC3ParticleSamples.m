@@ -58,7 +58,7 @@
 }
 
 -(void) initializeParticle: (id<CC3MortalParticleProtocol>) aParticle {
-	aParticle.lifeSpan = CC3RandomFloatBetween(_minParticleLifeSpan, _maxParticleLifeSpan);
+	aParticle.lifeSpan = CC3RandomStreamFloatBetween(self.randomStream, _minParticleLifeSpan, _maxParticleLifeSpan);
 }
 
 @end
@@ -205,15 +205,16 @@ static inline CGSize CC3DispersionAngleFromShape(CGSize anAspect) {
 	// nozzle's local coordinate system to the emitter's local coordinate system.
 	aParticle.location = [self.nozzleMatrix transformLocation: kCC3VectorZero];
 	
-	// Speed of particle is randomized.
-	GLfloat emissionSpeed = CC3RandomFloatBetween(_minParticleSpeed, _maxParticleSpeed);
-
 	// Emission direction in the nozzle's local coordinate system is towards the negative
 	// Z-axis, with randomization in the X & Y directions based on the shape of the nozzle.
 	// Randomization is performed either on the dispersion angle, or on the tangents of the
 	// dispersion angle, depending on the value of the shouldPrecalculateNozzleTangents.
-	CGSize nozzleAspect = CGSizeMake(CC3RandomFloatBetween(-_nozzleShape.width, _nozzleShape.width),
-									 CC3RandomFloatBetween(-_nozzleShape.height, _nozzleShape.height));
+	// Speed of particle is also randomized, and all three are drawn together.
+	CC3Vector emissionRand = CC3RandomStreamVectorBetween(self.randomStream,
+														  cc3v(-_nozzleShape.width, -_nozzleShape.height, _minParticleSpeed),
+														  cc3v(_nozzleShape.width, _nozzleShape.height, _maxParticleSpeed));
+	GLfloat emissionSpeed = emissionRand.z;
+	CGSize nozzleAspect = CGSizeMake(emissionRand.x, emissionRand.y);
 	if ( !_shouldPrecalculateNozzleTangents ) nozzleAspect = CC3ShapeFromDispersionAngle(nozzleAspect);
 	CC3Vector emissionDir = CC3VectorNormalize(cc3v(nozzleAspect.width, nozzleAspect.height, 1.0f));
 
@@ -284,17 +284,19 @@
 
 #pragma mark Updating
 
-/** Returns a random number between min and max, or returns alt if either min or max is negative. */
-#define CC3RandomOrAlt(min, max, alt) (((min) >= 0.0f && (max) >= 0.0f) ? CC3RandomFloatBetween((min), (max)) : (alt))
+/** Returns a random number from the stream between min and max, or returns alt if either min or max is negative. */
+#define CC3RandomOrAlt(stream, min, max, alt) (((min) >= 0.0f && (max) >= 0.0f) ? CC3RandomStreamFloatBetween((stream), (min), (max)) : (alt))
 
 -(void) initializeParticle: (id<CC3VariegatedPointParticleProtocol>) aParticle {
 	[super initializeParticle: aParticle];
 	
+	CC3RandomStream* randStream = self.randomStream;
+
 	// Set the particle's initial color and color velocity, which is calculated by taking the
 	// difference of the start and end colors. This assumes that the color changes over one second.
 	// The particle itself will figure out how the overall change should be adjusted for its lifespan.
 	if (self.mesh.hasVertexColors) {
-		ccColor4F startColor = RandomCCC4FBetween(_minParticleStartingColor, _maxParticleStartingColor);
+		ccColor4F startColor = CC3RandomStreamColorBetween(randStream, _minParticleStartingColor, _maxParticleStartingColor);
 		aParticle.color4F = startColor;
 		
 		// End color is treated differently. If any component of either min or max is negative,
@@ -304,10 +306,10 @@
 		// For exmaple, setting all color components to -1 and alpha to zero, indicates that
 		// the particle should stay the same color, but fade away.
 		ccColor4F endColor;
-		endColor.r = CC3RandomOrAlt(_minParticleEndingColor.r, _maxParticleEndingColor.r, startColor.r);
-		endColor.g = CC3RandomOrAlt(_minParticleEndingColor.g, _maxParticleEndingColor.g, startColor.g);
-		endColor.b = CC3RandomOrAlt(_minParticleEndingColor.b, _maxParticleEndingColor.b, startColor.b);
-		endColor.a = CC3RandomOrAlt(_minParticleEndingColor.a, _maxParticleEndingColor.a, startColor.a);
+		endColor.r = CC3RandomOrAlt(randStream, _minParticleEndingColor.r, _maxParticleEndingColor.r, startColor.r);
+		endColor.g = CC3RandomOrAlt(randStream, _minParticleEndingColor.g, _maxParticleEndingColor.g, startColor.g);
+		endColor.b = CC3RandomOrAlt(randStream, _minParticleEndingColor.b, _maxParticleEndingColor.b, startColor.b);
+		endColor.a = CC3RandomOrAlt(randStream, _minParticleEndingColor.a, _maxParticleEndingColor.a, startColor.a);
 		
 		// We have to do the math on each component instead of using the color math functions
 		// because the functions clamp prematurely, and we need negative values for the velocity.
@@ -321,13 +323,13 @@
 	// difference of the start and end sizes. This assumes that the color changes over one second.
 	// The particle itself will figure out how the overall change should be adjusted for its lifespan.
 	if(self.mesh.hasVertexPointSizes) {
-		GLfloat startSize = CC3RandomFloatBetween(_minParticleStartingSize, _maxParticleStartingSize);
+		GLfloat startSize = CC3RandomStreamFloatBetween(randStream, _minParticleStartingSize, _maxParticleStartingSize);
 		aParticle.size = startSize;
 		
 		// End size is treated differently. If either min or max is negative, it indicates that
 		// the start size should be used, otherwise a random value between min and max is chosen.
 		// This allows a random size to be chosen, but to have it stay constant.
-		GLfloat endSize = CC3RandomOrAlt(_minParticleEndingSize, _maxParticleEndingSize, startSize);
+		GLfloat endSize = CC3RandomOrAlt(randStream, _minParticleEndingSize, _maxParticleEndingSize, startSize);
 		
 		aParticle.sizeVelocity = (endSize - startSize);
 	}
@@ -363,10 +363,21 @@ static Class _defaultSemanticDelegateClass = nil;
 	return [semanticDelegate autorelease];
 }
 
-/** Returns the PFX vertex shader that was assigned the specified name in the PFX resource file. */
+/**
+ * Returns the PFX vertex shader that was assigned the specified name in the PFX resource file.
+ *
+ * The shader is looked up through the hashed name index of the parser. Falls back to comparing
+ * each name if the shader is unnamed, or in the unlikely event of a hash collision between names.
+ */
 -(SPVRTPFXParserShader*) getPFXVertexShaderForPFXEffect: (SPVRTPFXParserEffect*) pfxEffect
 										  fromPFXParser: (CPVRTPFXParser*) pfxParser {
 	const char* sName = pfxEffect->VertexShaderName.c_str();
+	GLint hIdx = pfxParser->FindVertexShaderByName(pfxEffect->VertexShaderName);
+	if (hIdx >= 0) {
+		SPVRTPFXParserShader& hashShader = pfxParser->GetVertexShader(hIdx);
+		if (strcmp(hashShader.Name.c_str(), sName) == 0) return &hashShader;
+	} else if (*sName) return NULL;		// Named shaders are always indexed
+
 	GLuint sCnt = pfxParser->GetNumberVertexShaders();
 	for (GLuint sIdx = 0; sIdx < sCnt; sIdx++) {
 		const SPVRTPFXParserShader& pfxShader = pfxParser->GetVertexShader(sIdx);
@@ -375,10 +386,21 @@ static Class _defaultSemanticDelegateClass = nil;
 	return NULL;
 }
 
-/** Returns the PFX fragment shader that was assigned the specified name in the PFX resource file. */
+/**
+ * Returns the PFX fragment shader that was assigned the specified name in the PFX resource file.
+ *
+ * The shader is looked up through the hashed name index of the parser. Falls back to comparing
+ * each name if the shader is unnamed, or in the unlikely event of a hash collision between names.
+ */
 -(SPVRTPFXParserShader*) getPFXFragmentShaderForPFXEffect: (SPVRTPFXParserEffect*) pfxEffect
 											fromPFXParser: (CPVRTPFXParser*) pfxParser  {
 	const char* sName = pfxEffect->FragmentShaderName.c_str();
+	GLint hIdx = pfxParser->FindFragmentShaderByName(pfxEffect->FragmentShaderName);
+	if (hIdx >= 0) {
+		SPVRTPFXParserShader& hashShader = pfxParser->GetFragmentShader(hIdx);
+		if (strcmp(hashShader.Name.c_str(), sName) == 0) return &hashShader;
+	} else if (*sName) return NULL;		// Named shaders are always indexed
+
 	GLuint sCnt = pfxParser->GetNumberFragmentShaders();
 	for (GLuint sIdx = 0; sIdx < sCnt; sIdx++) {
 		const SPVRTPFXParserShader& pfxShader = pfxParser->GetFragmentShader(sIdx);
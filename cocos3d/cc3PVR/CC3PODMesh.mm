@@ -60,6 +60,22 @@
 		
 		self.vertexIndices = [CC3VertexIndices arrayFromCPODData: &psm->sFaces fromSPODMesh: psm];
 		
+		// If the POD file was memory-mapped, vertex content may be referenced in place within
+		// the mapped file. Each vertex array referencing it retains the mapping, instead of
+		// taking over responsibility for freeing the vertex content memory.
+		if (aPODRez.mappedContentOwner) {
+			[_vertexLocations retainMappedContentFromPODResource: aPODRez];
+			[_vertexNormals retainMappedContentFromPODResource: aPODRez];
+			[_vertexTangents retainMappedContentFromPODResource: aPODRez];
+			[_vertexBitangents retainMappedContentFromPODResource: aPODRez];
+			[_vertexColors retainMappedContentFromPODResource: aPODRez];
+			[_vertexBoneWeights retainMappedContentFromPODResource: aPODRez];
+			[_vertexBoneIndices retainMappedContentFromPODResource: aPODRez];
+			for (GLuint i = 0; i < psm->nNumUVW; i++)
+				[[self textureCoordinatesForTextureUnit: i] retainMappedContentFromPODResource: aPODRez];
+			[_vertexIndices retainMappedContentFromPODResource: aPODRez];
+		}
+		
 		// Once all vertex arrays are populated, if the data is interleaved, mark it as such and
 		// swap the reference to the original data within the SPODMesh, so that CC3VertexArray
 		// can take over responsibility for managing the data memory allocated by CPVRTModelPOD.
@@ -37,6 +37,8 @@
 #import "CC3Light.h"
 #import "CC3Material.h"
 
+@class CC3PODBakedAnimation;
+
 
 /**
  * CC3PODResource is a CC3NodesResource that wraps a PVR POD data structure loaded from a file.
@@ -87,6 +89,8 @@
  */
 @interface CC3PODResource : CC3NodesResource {
 	PODClassPtr _pvrtModel;
+	id _mappedContentOwner;
+	CC3PODBakedAnimation* _bakedAnimation;
 	NSMutableArray* _allNodes;
 	NSMutableArray* _meshes;
 	NSMutableArray* _materials;
@@ -97,6 +101,8 @@
 	GLuint _animationFrameCount;
 	GLfloat _animationFrameRate;
 	BOOL _shouldAutoBuild : 1;
+	BOOL _shouldMemoryMapFile : 1;
+	BOOL _shouldBakeAnimation : 1;
 }
 
 /**
@@ -206,6 +212,114 @@
  */
 @property(nonatomic, assign) BOOL shouldAutoBuild;
 
+/**
+ * Indicates whether the POD file should be memory-mapped when it is loaded, instead of being
+ * read into memory in its entirety.
+ *
+ * When the file is memory-mapped, vertex and index content is referenced in place within the
+ * mapped file wherever the content is suitably aligned and requires no byte swapping, and is
+ * copied to the heap only where that is not the case. The resulting CC3VertexArrays reference
+ * the mapped content directly, and retain the mapping through their vertexContentOwner property,
+ * so the file content is not held in memory twice during loading. The mapping is released once
+ * all vertex arrays referencing it have released their vertex content, typically when the
+ * releaseRedundantContent method is invoked after the content has been copied to GL buffers.
+ *
+ * Memory-mapping is supported on OSX, iOS, and Linux-based platforms. On other platforms, the
+ * file is read normally, regardless of the value of this property.
+ *
+ * The initial value of this property is determined by the value of the class-side property
+ * defaultShouldMemoryMapFile at the time an instance of this class is created and initialized.
+ * This property must be set before the loadFromFile: method is invoked.
+ */
+@property(nonatomic, assign) BOOL shouldMemoryMapFile;
+
+/**
+ * This class-side property determines the initial value of the shouldMemoryMapFile
+ * property when an instance of this class is created and initialized.
+ *
+ * See the notes for that property for more information.
+ *
+ * The initial value of this class-side property is NO.
+ */
++(BOOL) defaultShouldMemoryMapFile;
+
+/**
+ * This class-side property determines the initial value of the shouldMemoryMapFile
+ * property when an instance of this class is created and initialized.
+ *
+ * See the notes for that property for more information.
+ *
+ * The initial value of this class-side property is NO.
+ */
++(void) setDefaultShouldMemoryMapFile: (BOOL) shouldMemoryMap;
+
+/**
+ * If the POD file was memory-mapped when it was loaded, returns an object that retains the
+ * file mapping for as long as it is itself retained. Otherwise, returns nil.
+ *
+ * Vertex arrays whose content is referenced in place within the mapped file retain this
+ * object in their vertexContentOwner property.
+ *
+ * This is a transient property that returns a valid value only during node building.
+ * Once node building is complete, this property will return nil.
+ */
+@property(nonatomic, retain, readonly) id mappedContentOwner;
+
+/**
+ * Returns whether the specified memory lies within the memory-mapped POD file.
+ *
+ * This is a transient method that returns a valid value only during node building.
+ * Once node building is complete, this method will always return NO.
+ */
+-(BOOL) isMappedContent: (const GLvoid*) content;
+
+/**
+ * Indicates whether the world matrix of each node should be evaluated for every frame of
+ * animation when the POD file is loaded, and held in the bakedAnimation property.
+ *
+ * Baking is useful when many copies of an animated model are displayed at different frames,
+ * or when the world matrices are needed on background threads, since the baked matrices can
+ * then be retrieved without re-evaluating the animation of each node and its ancestors.
+ *
+ * The initial value of this property is determined by the value of the class-side property
+ * defaultShouldBakeAnimation at the time an instance of this class is created and initialized.
+ * This property must be set before the loadFromFile: method is invoked.
+ */
+@property(nonatomic, assign) BOOL shouldBakeAnimation;
+
+/**
+ * This class-side property determines the initial value of the shouldBakeAnimation
+ * property when an instance of this class is created and initialized.
+ *
+ * See the notes for that property for more information.
+ *
+ * The initial value of this class-side property is NO.
+ */
++(BOOL) defaultShouldBakeAnimation;
+
+/**
+ * This class-side property determines the initial value of the shouldBakeAnimation
+ * property when an instance of this class is created and initialized.
+ *
+ * See the notes for that property for more information.
+ *
+ * The initial value of this class-side property is NO.
+ */
++(void) setDefaultShouldBakeAnimation: (BOOL) shouldBake;
+
+/**
+ * The world matrices of the nodes of this resource, evaluated for every frame of animation.
+ *
+ * If the shouldBakeAnimation property is set to YES, this property is populated when the POD
+ * file is loaded, and remains available after node building is complete.
+ *
+ * To share a single table between several resources loaded from the same POD file, set this
+ * property, to the value retrieved from another such resource, before the loadFromFile: method
+ * is invoked. If the table does not match the nodes and frames of the loaded file, a new table
+ * is baked if the shouldBakeAnimation property is set to YES, or this property is cleared.
+ */
+@property(nonatomic, retain) CC3PODBakedAnimation* bakedAnimation;
+
 /**
  * Template method that extracts and builds all components. This is automatically invoked from
  * the loadFromFile: method if the POD file was successfully loaded, and the shouldAutoBuild
@@ -701,3 +815,53 @@
 
 @end
 
+
+#pragma mark -
+#pragma mark CC3PODBakedAnimation
+
+/**
+ * CC3PODBakedAnimation holds the world matrix of each node of a POD file, evaluated for every
+ * frame of animation. Nodes whose world matrix does not change over the animation hold a single
+ * matrix. Instances are immutable, so they can be read from any thread, and shared by several
+ * CC3PODResource instances that were loaded from the same POD file.
+ *
+ * Instances are created by a CC3PODResource whose shouldBakeAnimation property is set to YES.
+ */
+@interface CC3PODBakedAnimation : NSObject {
+	PODClassPtr _bakedAnimation;
+}
+
+/**
+ * The underlying C++ CPVRTModelPODBakedAnimation class. It is defined here as a generic pointer
+ * so that it can be imported into header files without the need for the including file to
+ * support C++. This must be cast to a pointer to CPVRTModelPODBakedAnimation before accessing
+ * any elements within the class.
+ */
+@property(nonatomic, readonly) PODClassPtr pvrtBakedAnimation;
+
+/** The number of frames of animation. Frame indices beyond the last frame refer to the last frame. */
+@property(nonatomic, readonly) GLuint frameCount;
+
+/** The number of nodes. Node indices correspond to those of the CC3PODResource. */
+@property(nonatomic, readonly) GLuint nodeCount;
+
+/** The number of bytes of memory occupied by the baked matrices. */
+@property(nonatomic, readonly) NSUInteger byteSize;
+
+/** Returns whether the world matrix of the node at the specified index changes over the animation. */
+-(BOOL) isNodeAnimatedAtIndex: (GLuint) nodeIndex;
+
+/**
+ * Populates the specified matrix with the world matrix of the node at the specified index,
+ * at the specified frame of animation.
+ */
+-(void) populateMatrix: (CC3Matrix4x4*) mtx forNodeAtIndex: (GLuint) nodeIndex atFrame: (GLuint) frameIndex;
+
+/**
+ * Initializes this instance to retain the specified CPVRTModelPODBakedAnimation,
+ * which must hold world matrices.
+ */
+-(id) initWithPVRTBakedAnimation: (PODClassPtr) pvrtBakedAnimation;
+
+@end
+
@@ -45,11 +45,58 @@ extern "C" {
 #import "CC3CC2Extensions.h"
 
 
+#pragma mark CC3PODMappedContent
+
+/** Retains a memory-mapped POD file on behalf of the vertex arrays that reference its content. */
+@interface CC3PODMappedContent : NSObject {
+	CPVRTMappedFile* _mappedFile;
+}
+
+/** Initializes this instance to retain the specified file mapping. */
+-(id) initWithMappedFile: (CPVRTMappedFile*) mappedFile;
+
+/** Returns whether the specified memory lies within the mapped file. */
+-(BOOL) containsContent: (const GLvoid*) content;
+
+@end
+
+@implementation CC3PODMappedContent
+
+-(void) dealloc {
+	if (_mappedFile) _mappedFile->Release();
+	[super dealloc];
+}
+
+-(id) initWithMappedFile: (CPVRTMappedFile*) mappedFile {
+	if ( (self = [super init]) ) {
+		_mappedFile = mappedFile;
+		if (_mappedFile) _mappedFile->Retain();
+	}
+	return self;
+}
+
+-(BOOL) containsContent: (const GLvoid*) content {
+	return _mappedFile && _mappedFile->Contains(content);
+}
+
+-(NSString*) description {
+	return [NSString stringWithFormat: @"%@ mapping %lu bytes at %p", self.class,
+			(unsigned long)(_mappedFile ? _mappedFile->Size() : 0), (_mappedFile ? _mappedFile->DataPtr() : NULL)];
+}
+
+@end
+
+
+#pragma mark -
+#pragma mark CC3PODResource
+
 @implementation CC3PODResource
 
 @synthesize pvrtModel=_pvrtModel, allNodes=_allNodes, meshes=_meshes;
 @synthesize materials=_materials, textures=_textures, textureParameters=_textureParameters;
-@synthesize shouldAutoBuild = _shouldAutoBuild;
+@synthesize shouldAutoBuild = _shouldAutoBuild, shouldMemoryMapFile=_shouldMemoryMapFile;
+@synthesize mappedContentOwner=_mappedContentOwner;
+@synthesize shouldBakeAnimation=_shouldBakeAnimation, bakedAnimation=_bakedAnimation;
 @synthesize ambientLight=_ambientLight, backgroundColor=_backgroundColor;
 @synthesize animationFrameCount=_animationFrameCount, animationFrameRate=_animationFrameRate;
 
@@ -58,6 +105,7 @@ extern "C" {
 	[_meshes release];
 	[_materials release];
 	[_textures release];
+	[_bakedAnimation release];
 
 	[self deleteCPVRTModelPOD];
 
@@ -71,6 +119,14 @@ extern "C" {
 -(void) deleteCPVRTModelPOD {
 	if (_pvrtModel) delete self.pvrtModelImpl;
 	_pvrtModel = NULL;
+
+	// Vertex arrays that reference mapped content have retained the mapping themselves.
+	[_mappedContentOwner release];
+	_mappedContentOwner = nil;
+}
+
+-(BOOL) isMappedContent: (const GLvoid*) content {
+	return [(CC3PODMappedContent*)_mappedContentOwner containsContent: content];
 }
 
 
@@ -85,10 +141,24 @@ extern "C" {
 		_textures = [NSMutableArray new];		// retain
 		_textureParameters = [CC3Texture defaultTextureParameters];
 		_shouldAutoBuild = YES;
+		_shouldMemoryMapFile = self.class.defaultShouldMemoryMapFile;
+		_shouldBakeAnimation = self.class.defaultShouldBakeAnimation;
 	}
 	return self;
 }
 
+static BOOL _defaultShouldMemoryMapFile = NO;
+
++(BOOL) defaultShouldMemoryMapFile { return _defaultShouldMemoryMapFile; }
+
++(void) setDefaultShouldMemoryMapFile: (BOOL) shouldMemoryMap { _defaultShouldMemoryMapFile = shouldMemoryMap; }
+
+static BOOL _defaultShouldBakeAnimation = NO;
+
++(BOOL) defaultShouldBakeAnimation { return _defaultShouldBakeAnimation; }
+
++(void) setDefaultShouldBakeAnimation: (BOOL) shouldBake { _defaultShouldBakeAnimation = shouldBake; }
+
 -(BOOL) processFile: (NSString*) anAbsoluteFilePath {
 
 	// Split the path into directory and file names and set the PVR read path to the directory and
@@ -100,14 +170,55 @@ extern "C" {
 	CPVRTResourceFile::SetReadPath([dirName stringByAppendingString: @"/"].UTF8String);
 	
 	[self createCPVRTModelPOD];
-	BOOL wasLoaded = (self.pvrtModelImpl->ReadFromFile(fileName.UTF8String) == PVR_SUCCESS);
+	CPVRTModelPOD* pod = self.pvrtModelImpl;
+	BOOL wasLoaded;
+	if (_shouldMemoryMapFile) {
+		wasLoaded = (pod->ReadFromFileMapped(fileName.UTF8String) == PVR_SUCCESS);
+		if (wasLoaded && pod->GetMappedFile()) {
+			[_mappedContentOwner release];
+			_mappedContentOwner = [[CC3PODMappedContent alloc] initWithMappedFile: pod->GetMappedFile()];	// retained
+			LogRez(@"%@ memory-mapped %@", self, _mappedContentOwner);
+		}
+	} else {
+		wasLoaded = (pod->ReadFromFile(fileName.UTF8String) == PVR_SUCCESS);
+	}
 	
+	if (wasLoaded) [self bakeAnimation];
 	if (wasLoaded && _shouldAutoBuild) [self build];
 	
 	return wasLoaded;
 }
 
 
+/**
+ * Uses the table in the bakedAnimation property if it was set before loading, and it matches
+ * the loaded file. Otherwise, bakes a new table if the shouldBakeAnimation property is YES.
+ */
+-(void) bakeAnimation {
+	CPVRTModelPOD* pod = self.pvrtModelImpl;
+	if (_bakedAnimation) {
+		CPVRTModelPODBakedAnimation* pvrtBaked = (CPVRTModelPODBakedAnimation*)_bakedAnimation.pvrtBakedAnimation;
+		if (pod->SetBakedAnimation(pvrtBaked) == PVR_SUCCESS) {
+			LogRez(@"%@ sharing %@", self, _bakedAnimation);
+			return;
+		}
+		LogRez(@"%@ cannot share %@ because it does not match the content of the POD file", self, _bakedAnimation);
+		self.bakedAnimation = nil;
+	}
+	if ( !_shouldBakeAnimation ) return;
+
+	MarkRezActivityStart();
+	if (pod->BakeAnimation() == PVR_SUCCESS) {
+		CC3PODBakedAnimation* baked = [[CC3PODBakedAnimation alloc] initWithPVRTBakedAnimation: pod->GetBakedAnimation()];
+		self.bakedAnimation = baked;
+		[baked release];
+		LogRez(@"%@ baked %@ in %.3f ms", self, _bakedAnimation, GetRezActivityDuration() * 1000);
+	} else {
+		LogError(@"%@ could not bake the animation of the POD file", self);
+	}
+}
+
+
 #pragma mark Building
 
 -(void) build {
@@ -562,3 +673,48 @@ extern "C" {
 @end
 
 
+#pragma mark -
+#pragma mark CC3PODBakedAnimation
+
+@implementation CC3PODBakedAnimation
+
+@synthesize pvrtBakedAnimation=_bakedAnimation;
+
+-(CPVRTModelPODBakedAnimation*) pvrtBakedAnimationImpl { return (CPVRTModelPODBakedAnimation*)_bakedAnimation; }
+
+-(void) dealloc {
+	if (_bakedAnimation) self.pvrtBakedAnimationImpl->Release();
+	[super dealloc];
+}
+
+-(GLuint) frameCount { return self.pvrtBakedAnimationImpl->GetNumFrames(); }
+
+-(GLuint) nodeCount { return self.pvrtBakedAnimationImpl->GetNumNodes(); }
+
+-(NSUInteger) byteSize { return self.pvrtBakedAnimationImpl->GetSize(); }
+
+-(BOOL) isNodeAnimatedAtIndex: (GLuint) nodeIndex {
+	CC3Assert(nodeIndex < self.nodeCount, @"%@ node index %u is out of range", self, nodeIndex);
+	return self.pvrtBakedAnimationImpl->IsNodeAnimated(nodeIndex);
+}
+
+-(void) populateMatrix: (CC3Matrix4x4*) mtx forNodeAtIndex: (GLuint) nodeIndex atFrame: (GLuint) frameIndex {
+	CC3Assert(nodeIndex < self.nodeCount, @"%@ node index %u is out of range", self, nodeIndex);
+	self.pvrtBakedAnimationImpl->GetWorldMatrixAtFrame(*(PVRTMATRIX*)mtx, nodeIndex, frameIndex);
+}
+
+-(id) initWithPVRTBakedAnimation: (PODClassPtr) pvrtBakedAnimation {
+	CC3Assert(pvrtBakedAnimation, @"%@ requires a baked animation", [self class]);
+	if ( (self = [super init]) ) {
+		_bakedAnimation = pvrtBakedAnimation;
+		self.pvrtBakedAnimationImpl->Retain();
+	}
+	return self;
+}
+
+-(NSString*) description {
+	return [NSString stringWithFormat: @"%@ of %u nodes over %u frames in %lu bytes", self.class,
+			self.nodeCount, self.frameCount, (unsigned long)self.byteSize];
+}
+
+@end
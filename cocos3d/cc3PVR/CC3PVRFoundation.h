@@ -157,3 +157,35 @@ GLenum GLMinifyingFunctionFromMinAndMipETextureFilters(uint minETextureFilter, u
 /** Returns the name of the specified ETextureFilter enumeration. */
 NSString* NSStringFromETextureFilter(uint eTextureFilter);
 
+
+
+#pragma mark -
+#pragma mark Texture decompression
+
+/**
+ * Decompresses the specified PVRTC texture content, of the specified size in pixels, into the
+ * specified pixel buffer, as RGBA 8888 pixels. The pixel buffer must hold (width * height * 4)
+ * bytes. The is2bpp argument indicates whether the content is PVRTC 2bpp or PVRTC 4bpp.
+ *
+ * If shouldAllowParallel is YES, a large texture is split into bands that are decompressed on
+ * several threads. If NO, the texture is decompressed on the calling thread. Both produce the
+ * same pixels.
+ *
+ * Returns the number of bytes of compressed content that were decompressed.
+ */
+GLint CC3DecompressPVRTC(const GLvoid* content, BOOL is2bpp, GLint width, GLint height,
+						 GLvoid* pixels, BOOL shouldAllowParallel);
+
+/**
+ * Decompresses the specified ETC texture content, of the specified size in pixels, into the
+ * specified pixel buffer, as RGBA 8888 pixels. The pixel buffer must hold (width * height * 4)
+ * bytes.
+ *
+ * If shouldAllowParallel is YES, a large texture is split into bands that are decompressed on
+ * several threads. If NO, the texture is decompressed on the calling thread. Both produce the
+ * same pixels.
+ *
+ * Returns the number of bytes of compressed content that were decompressed.
+ */
+GLint CC3DecompressETC(const GLvoid* content, GLint width, GLint height,
+					   GLvoid* pixels, BOOL shouldAllowParallel);
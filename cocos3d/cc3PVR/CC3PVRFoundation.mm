@@ -37,6 +37,7 @@ extern "C" {
 #import "CC3PVRFoundation.h"
 #import "CC3PVRTModelPOD.h"
 #import "CC3PVRTPFXParser.h"
+#import "PVRTDecompress.h"
 
 
 NSString* NSStringFromSPODNode(PODStructPtr pSPODNode) {
@@ -596,3 +597,19 @@ NSString* NSStringFromETextureFilter(uint eTextureFilter) {
 	}
 }
 
+
+
+#pragma mark -
+#pragma mark Texture decompression
+
+GLint CC3DecompressPVRTC(const GLvoid* content, BOOL is2bpp, GLint width, GLint height,
+						 GLvoid* pixels, BOOL shouldAllowParallel) {
+	return PVRTDecompressPVRTC(content, (is2bpp ? 1 : 0), width, height,
+							   (unsigned char*)pixels, shouldAllowParallel);
+}
+
+GLint CC3DecompressETC(const GLvoid* content, GLint width, GLint height,
+					   GLvoid* pixels, BOOL shouldAllowParallel) {
+	return PVRTDecompressETC(content, (unsigned int)width, (unsigned int)height,
+							 pixels, 0, shouldAllowParallel);
+}
@@ -51,9 +51,18 @@
  * than the receiver of that method.
  */
 @interface CC3PVRTexture : CC3Texture {
+	NSUInteger _glMemoryBytes;
 	BOOL _isTextureCube : 1;
 }
 
+/**
+ * Returns the number of bytes of GL memory occupied by this texture, as determined from
+ * the format, size, mipmap levels and faces recorded in the PVR file from which it was loaded.
+ *
+ * This property is accurate for compressed PVR formats, such as PVRTC and ETC.
+ */
+@property(nonatomic, readonly) NSUInteger glMemoryBytes;
+
 /**
  * PVR textures cannot be flipped after loading. This property is overridden so
  * that changes are ignored, and to always return NO.
@@ -79,6 +88,7 @@
 @interface CC3PVRTextureContent : NSObject {
 	GLuint _textureID;
 	CC3IntSize _size;
+	NSUInteger _glMemoryBytes;
 	GLenum _pixelFormat;
 	GLenum _pixelType;
 	BOOL _hasMipmap : 1;
@@ -110,6 +120,9 @@
 /** Returns whether this texture contains a mipmap. */
 @property(nonatomic, readonly) BOOL hasMipmap;
 
+/** Returns the number of bytes of texture data, across all mipmap levels and faces, loaded into the GL engine. */
+@property(nonatomic, readonly) NSUInteger glMemoryBytes;
+
 /** 
  * Returns whether the alpha channel of this texture has already been multiplied
  * into each of the RGB color channels.
@@ -78,6 +78,7 @@
 	_coverage = CGSizeMake(1.0, 1.0);				// PVR textures are always POT
 	_pixelFormat = texContent.pixelFormat;
 	_pixelType = texContent.pixelType;
+	_glMemoryBytes = texContent.glMemoryBytes;
 	
 	LogTrace(@"Bound PVR texture ID %u", _textureID);
 	
@@ -87,6 +88,8 @@
 								: [CC3Texture2D class].defaultTextureParameters;
 }
 
+-(NSUInteger) glMemoryBytes { return _glMemoryBytes; }
+
 /** Replacing pixels not supported in compressed PVR textures. */
 -(void) replacePixels: (CC3Viewport) rect
 			 inTarget: (GLenum) target
@@ -119,6 +122,7 @@
 @synthesize textureID=_textureID, size=_size, isTextureCube=_isTextureCube;
 @synthesize pixelFormat=_pixelFormat, pixelType=_pixelType;
 @synthesize hasMipmap=_hasMipmap, hasPremultipliedAlpha=_hasPremultipliedAlpha;
+@synthesize glMemoryBytes=_glMemoryBytes;
 
 -(BOOL) isTexture2D { return !self.isTextureCube; }
 
@@ -156,6 +160,7 @@
 		_hasPremultipliedAlpha = ((pvrHeader.u32Flags & PVRTEX3_PREMULTIPLIED) != 0);
 		_pixelFormat = GL_ZERO;		// Unknown - could query from GL if needed
 		_pixelType = GL_ZERO;		// Unknown - could query from GL if needed
+		_glMemoryBytes = PVRTGetTextureDataSize(pvrHeader);	// All mipmap levels, surfaces and faces
 	}
 	return self;
 }
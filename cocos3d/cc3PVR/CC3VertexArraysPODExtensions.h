@@ -33,6 +33,8 @@
 #import "CC3VertexArrays.h"
 #import "CC3PVRFoundation.h"
 
+@class CC3PODResource;
+
 
 #pragma mark CC3VertexArray PVRPOD extensions
 
@@ -46,6 +48,16 @@
 /** Allocates and initialize an autoreleased instance from the specified CPODData and SPODMesh structures. */
 +(id) arrayFromCPODData: (PODClassPtr) aCPODData fromSPODMesh: (PODStructPtr) aSPODMesh;
 
+/**
+ * If the vertex content of this instance is referenced in place within the memory-mapped file
+ * of the specified POD resource, this instance relinquishes responsibility for freeing that
+ * content, and instead retains the file mapping in its vertexContentOwner property.
+ *
+ * Does nothing if the POD resource was not memory-mapped, or if the vertex content of this
+ * instance was copied out of the mapped file.
+ */
+-(void) retainMappedContentFromPODResource: (CC3PODResource*) aPODRez;
+
 @end
 
 
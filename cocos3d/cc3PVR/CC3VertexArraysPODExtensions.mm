@@ -35,6 +35,7 @@ extern "C" {
 
 #import "CC3VertexArraysPODExtensions.h"
 #import "CC3PVRTModelPOD.h"
+#import "CC3PODResource.h"
 
 
 #pragma mark CC3VertexArray PVRPOD extensions
@@ -66,6 +67,14 @@ extern "C" {
 	return [[[self alloc] initFromCPODData: aCPODData fromSPODMesh: aSPODMesh] autorelease];
 }
 
+-(void) retainMappedContentFromPODResource: (CC3PODResource*) aPODRez {
+	if ( !(_vertices && [aPODRez isMappedContent: _vertices]) ) return;
+
+	LogRez(@"\t%@ referencing vertex content in place within %@", self, aPODRez.mappedContentOwner);
+	_allocatedVertexCapacity = 0;		// Mapped content must not be freed by this instance
+	self.vertexContentOwner = aPODRez.mappedContentOwner;
+}
+
 /** Template method extracts the vertex data from the specified SPODMesh and CPODData structures.  */
 -(void) setElementsFromCPODData: (CPODData*) aCPODData fromSPODMesh: (SPODMesh*) aSPODMesh {
 	if (aSPODMesh->pInterleaved) {					// vertex data is interleaved
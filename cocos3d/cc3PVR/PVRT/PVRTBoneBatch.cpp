@@ -24,7 +24,8 @@
 //#include "PVRTContext.h"					// patched for Cocos3D by Bill Hollings
 
 #include <vector>
-#include <list>
+#include <queue>
+#include <algorithm>					// patched for Cocos3D by Bill Hollings
 
 #include "PVRTMatrix.h"
 #include "PVRTVertex.h"
@@ -34,6 +35,9 @@
 ** Defines
 ****************************************************************************/
 
+// Most bones a single triangle can reference: three vertices of up to four bones each.
+#define PVRT_BONEBATCH_TRI_BONES_MAX	12
+
 /****************************************************************************
 ** Macros
 ****************************************************************************/
@@ -41,346 +45,208 @@
 /****************************************************************************
 ** Structures
 ****************************************************************************/
+
 /*!***************************************************************************
-@Class CBatch
-@Brief Class to contain and manage batch information.
+@Class CBoneSets
+@Brief Flat storage for a collection of fixed-size bitsets of bone indices.
+		A bitset tests containment and merge cost with a few word operations,
+		independent of how many bones the sets hold.
+		(patched for Cocos3D by Bill Hollings)
 *****************************************************************************/
-class CBatch
+class CBoneSets
 {
 protected:
-	int	m_nCapacity, 		// Maximum size of the batch
-	m_nCnt, 				// Number of elements currently contained in the batch
-	*m_pnPalette;			// Array of palette indices
+	std::vector<PVRTuint64>	m_Bits;
+	std::vector<int>		m_Cnt;
+	int						m_nWords;
 
-public:
 /*!***************************************************************************
- @Function		CBatch
- @Description	The default constructor
+ @Function		PopCount
+ @Input			n				The word to count
+ @Return		int				The number of bits set in the word
 *****************************************************************************/
-	CBatch() : 	m_nCapacity(0),
-				m_nCnt(0),
-				m_pnPalette(0)
+	static int PopCount(PVRTuint64 n)
 	{
+#if defined(__GNUC__)
+		return __builtin_popcountll(n);
+#else
+		int nCnt = 0;
+		for(; n; n &= n - 1)
+			++nCnt;
+		return nCnt;
+#endif
 	}
 
+public:
 /*!***************************************************************************
- @Function		CBatch
- @Input			src				CBatch to copy
- @Description	Copy constructor
+ @Function		CBoneSets
+ @Input			nBoneNum		The number of distinct bone indices (highest index + 1)
+ @Description	Constructor
 *****************************************************************************/
-	CBatch(const CBatch &src) : m_pnPalette(0)
+	CBoneSets(const int nBoneNum) : m_nWords((nBoneNum + 63) / 64)
 	{
-		SetSize(src.m_nCapacity);
-		*this = src;
+		if(m_nWords < 1)
+			m_nWords = 1;
 	}
-	
+
 /*!***************************************************************************
- @Function		~CBatch
- @Description	Destructor
+ @Function		Add
+ @Input			pnBones			The bone indices of the new set
+ @Input			nCnt			The number of bone indices
+ @Return		int				The index of the new set
+ @Description	Appends a new set containing the specified bones.
 *****************************************************************************/
-	~CBatch()
+	int Add(const int * const pnBones, const int nCnt)
 	{
-		FREE(m_pnPalette);
+		int nSet = (int)m_Cnt.size();
+		m_Bits.resize(m_Bits.size() + m_nWords, 0);
+		m_Cnt.push_back(0);
+		for(int i = 0; i < nCnt; ++i)
+			m_Bits[nSet * m_nWords + (pnBones[i] >> 6)] |= (PVRTuint64)1 << (pnBones[i] & 63);
+		Recount(nSet);
+		return nSet;
 	}
-	
+
 /*!***************************************************************************
- @Function		operator=
- @Description	Operator overload for the '=' operand
+ @Function		Recount
+ @Input			nSet			The set to recount
+ @Description	Updates the cached bone count of the set.
 *****************************************************************************/
-	CBatch& operator= (const CBatch &src)
+	void Recount(const int nSet)
 	{
-		_ASSERT(m_nCapacity == src.m_nCapacity);
-		m_nCnt = src.m_nCnt;
-		memcpy(m_pnPalette, src.m_pnPalette, m_nCnt * sizeof(*m_pnPalette));
-		return *this;
+		int nCnt = 0;
+		const PVRTuint64 *pA = &m_Bits[nSet * m_nWords];
+		for(int w = 0; w < m_nWords; ++w)
+			nCnt += PopCount(pA[w]);
+		m_Cnt[nSet] = nCnt;
 	}
-	
-/*!***************************************************************************
- @Function		SetSize
- @Input			nSize			The new size of the batch
- @Description	Delete all current information and resizes the batch 
-				to the value that has been passed in.
-*****************************************************************************/
-	void SetSize(const int nSize)
-	{
-		FREE(m_pnPalette);
 
-		m_nCapacity	= nSize;
-		m_nCnt		= 0;
-		m_pnPalette		= (int*)malloc(m_nCapacity * sizeof(*m_pnPalette));
-	}
-	
 /*!***************************************************************************
- @Function		Clear
- @Description	Resets the count
+ @Function		Count
+ @Input			nSet			The set
+ @Return		int				The number of bones in the set
 *****************************************************************************/
-	void Clear()
+	int Count(const int nSet) const
 	{
-		m_nCnt = 0;
+		return m_Cnt[nSet];
 	}
 
 /*!***************************************************************************
- @Function		Clear
- @Input			n			The index of the new item
- Return			bool		Returns true if the item already exists or has been added.
- @Description	Adds a new item to the batch, providing it has not already
-				been added to the batch and the count doesn't exceed the
-				maximum number of bones the batch can hold.
+ @Function		Contains
+ @Input			nSet			The set to test
+ @Input			nSub			The possible subset
+ @Return		bool			True if every bone in nSub is also in nSet
 *****************************************************************************/
-	bool Add(const int n)
+	bool Contains(const int nSet, const int nSub) const
 	{
-		int i;
-
-		if(n < 0)
+		if(m_Cnt[nSub] > m_Cnt[nSet])
 			return false;
-
-		// If we already have this item, do nothing
-		for(i = 0; i < m_nCnt; ++i)
-		{
-			if(m_pnPalette[i] == n)
-				return true;
-		}
-
-		// Add the new item
-		if(m_nCnt < m_nCapacity)
-		{
-			m_pnPalette[m_nCnt] = n;
-			++m_nCnt;
-			return true;
-		}
-		else
-		{
-			return false;
-		}
+		const PVRTuint64 *pA = &m_Bits[nSet * m_nWords], *pB = &m_Bits[nSub * m_nWords];
+		for(int w = 0; w < m_nWords; ++w)
+			if(pB[w] & ~pA[w])
+				return false;
+		return true;
 	}
 
 /*!***************************************************************************
- @Function		Merge
- @Input			src				The batch to merge with
- @Description	Merges the input batch with the current batch.
+ @Function		TestMerge
+ @Input			nSet			The set to merge into
+ @Input			nSrc			The set to merge from
+ @Return		int				The number of bones in nSrc that are not in nSet
 *****************************************************************************/
-	void Merge(const CBatch &src)
+	int TestMerge(const int nSet, const int nSrc) const
 	{
-		int i;
-
-		for(i = 0; i < src.m_nCnt; ++i)
-			Add(src.m_pnPalette[i]);
+		int nCnt = 0;
+		const PVRTuint64 *pA = &m_Bits[nSet * m_nWords], *pB = &m_Bits[nSrc * m_nWords];
+		for(int w = 0; w < m_nWords; ++w)
+			nCnt += PopCount(pB[w] & ~pA[w]);
+		return nCnt;
 	}
 
 /*!***************************************************************************
- @Function		TestMerge
- @Input			src				The batch to merge with
- @Return		int				The number of items that are not already
-								present in the batch. -1 if the merge will
-								exceed the capacity of the batch
- @Description	Tests how many of the items of the input batch are not
-				already contained in the batch. This returns the number of
-				items that would need to be added, or -1 if the number
-				of additional items would exceed the capacity of the batch.
+ @Function		Copy
+ @Input			nSrc			The set to copy
+ @Return		int				The index of the new set
+ @Description	Appends a new set containing the same bones as nSrc.
 *****************************************************************************/
-	int TestMerge(const CBatch &src)
+	int Copy(const int nSrc)
 	{
-		int i, nCnt;
-
-		nCnt = 0;
-		for(i = 0; i < src.m_nCnt; ++i)
-			if(!Contains(src.m_pnPalette[i]))
-				++nCnt;
-
-		return m_nCnt+nCnt > m_nCapacity ? -1 : nCnt;
+		int nSet = (int)m_Cnt.size();
+		m_Bits.resize(m_Bits.size() + m_nWords, 0);
+		m_Cnt.push_back(0);
+		Assign(nSet, nSrc);
+		return nSet;
 	}
 
 /*!***************************************************************************
- @Function		Contains
- @Input			src				The batch to compare
- @Return		bool			Returns true if the batch and the input batch
-								have at least one item in common
- @Description	Returns true if the batch's have at least one item in common
+ @Function		Assign
+ @Input			nSet			The set to overwrite
+ @Input			nSrc			The set to copy
+ @Description	Replaces the bones in nSet with the bones in nSrc.
 *****************************************************************************/
-	bool Contains(const CBatch &batch) const
+	void Assign(const int nSet, const int nSrc)
 	{
-		int i;
-
-		for(i = 0; i < batch.m_nCnt; ++i)
-			if(!Contains(batch.m_pnPalette[i]))
-				return false;
-
-		return true;
+		for(int w = 0; w < m_nWords; ++w)
+			m_Bits[nSet * m_nWords + w] = m_Bits[nSrc * m_nWords + w];
+		m_Cnt[nSet] = m_Cnt[nSrc];
 	}
-	
-/*!***************************************************************************
- @Function		Contains
- @Input			n				The index of the new item
- @Return		bool			Returns true if the batch contains the item
- @Description	Returns true if the batch contains the item.
-*****************************************************************************/
-	bool Contains(const int n) const
-	{
-		int i;
-
-		for(i = 0; i < m_nCnt; ++i)
-			if(m_pnPalette[i] == n)
-				return true;
 
-		return false;
-	}
-	
 /*!***************************************************************************
- @Function		Write
- @Output		pn				The array of items to overwrite
- @Output		pnCnt			The number of items in the array
- @Description	Writes the array of items and the number of items to the output
-				parameters.
+ @Function		Merge
+ @Input			nSet			The set to merge into
+ @Input			nSrc			The set to merge from
+ @Description	Adds all bones in nSrc to nSet.
 *****************************************************************************/
-	void Write(
-		int * const pn,
-		int * const pnCnt) const
+	void Merge(const int nSet, const int nSrc)
 	{
-		memcpy(pn, m_pnPalette, m_nCnt * sizeof(*pn));
-		*pnCnt = m_nCnt;
+		PVRTuint64 *pA = &m_Bits[nSet * m_nWords];
+		const PVRTuint64 *pB = &m_Bits[nSrc * m_nWords];
+		for(int w = 0; w < m_nWords; ++w)
+			pA[w] |= pB[w];
+		Recount(nSet);
 	}
 
 /*!***************************************************************************
- @Function		GetVertexBoneIndices
- @Modified		pfI				Returned index
- @Input			pfW				Weight?
- @Input			n				Length of index array
- @Description	For each element of the input array, the index value is compared
-				with the palette's index value. If the values are equal, the
-				value of the current input array element is replaced with the
-				palette index, otherwise the value is set to zero.
+ @Function		Write
+ @Input			nSet			The set
+ @Output		pn				The bone indices of the set, in ascending order
+ @Output		pnCnt			The number of bone indices written
 *****************************************************************************/
-	void GetVertexBoneIndices(
-		float		* const pfI,
-		const float	* const pfW,
-		const int	n)
+	void Write(const int nSet, int * const pn, int * const pnCnt) const
 	{
-		int i, j;
-
-		for(i = 0; i < n; ++i)
-		{
-			if(pfW[i] != 0)
-			{
-				for(j = 0; j < m_nCnt; ++j)
-				{
-					if(pfI[i] != m_pnPalette[j])
-						continue;
-
-					pfI[i] = (float)j;
-					break;
-				}
-
-				// This batch *must* contain this vertex
-				_ASSERT(j != m_nCnt);
-			}
-			else
+		int nCnt = 0;
+		const PVRTuint64 *pA = &m_Bits[nSet * m_nWords];
+		for(int w = 0; w < m_nWords; ++w)
+			for(PVRTuint64 n = pA[w]; n; n &= n - 1)
 			{
-				pfI[i] = 0;
+				int nBit = 0;
+				while(!((n >> nBit) & 1))
+					++nBit;
+				pn[nCnt++] = w * 64 + nBit;
 			}
-		}
+		*pnCnt = nCnt;
 	}
 };
 
 /*!***************************************************************************
-@Class CGrowableArray
-@Brief Class that provides an array structure that can change its size dynamically.
+@Struct SBoneSetMerge
+@Brief A candidate merge of one bone set into another, ordered so that the
+		merge adding the fewest bones is at the top of a priority queue.
+		(patched for Cocos3D by Bill Hollings)
 *****************************************************************************/
-class CGrowableArray
+struct SBoneSetMerge
 {
-protected:
-	char	*m_p;
-	int		m_nSize;
-	int		m_nCnt;
-
-public:
-/*!***************************************************************************
- @Function		CGrowableArray
- @Input			nSize			The size of the data (in bytes) that the array will contain
- @Description	Initialises the size of the data the array will contain to the
-				value that has been passed in and initialises the remaining
-				data members with default values.
-*****************************************************************************/
-	CGrowableArray(const int nSize)
-	{
-		m_p		= NULL;
-		m_nSize	= nSize;
-		m_nCnt	= 0;
-	}
-	
-/*!***************************************************************************
- @Function		~CGrowableArray
- @Description	The destructor
-*****************************************************************************/
-	~CGrowableArray()
-	{
-		FREE(m_p);
-	}
-	
-/*!***************************************************************************
- @Function		Append
- @Input			pData			The data to append
- @Input			nCnt			The amount of data elements to append
- @Description	Resizes the array and appends the new data that has been passed in.
-*****************************************************************************/
-	void Append(const void * const pData, const int nCnt)
-	{
-		m_p = (char*)realloc(m_p, (m_nCnt + nCnt) * m_nSize);
-		_ASSERT(m_p);
-
-		memcpy(&m_p[m_nCnt * m_nSize], pData, nCnt * m_nSize);
-		m_nCnt += nCnt;
-	}
-
-/*!***************************************************************************
- @Function		last
- @Return		char*			The last element of the array
- @Description	Returns a pointer to the last element of the array.
-*****************************************************************************/
-	char *last()
-	{
-		return at(m_nCnt-1);
-	}
+	int		nCost;		// Number of bones the merge adds to nSet
+	int		nSet;		// The set that would grow
+	int		nSrc;		// The set that would be absorbed
+	int		nSetVer;	// Version of nSet when the candidate was found
+	int		nSrcVer;	// Version of nSrc when the candidate was found
 
-/*!***************************************************************************
- @Function		at
- @Input			nIdx			The index of the requested element
- @Return		char*			The element at the specified index of the array
- @Description	Returns a pointer to the data at the specified index of the array.
-*****************************************************************************/	
-	char *at(const int nIdx)
+	bool operator<(const SBoneSetMerge &o) const
 	{
-		return &m_p[nIdx * m_nSize];
-	}
-
-/*!***************************************************************************
- @Function		size
- @Return		int				The number of elements contained in the array
- @Description	Returns the number of elements contained in the array.
-*****************************************************************************/
-	int size() const
-	{
-		return m_nCnt;
-	}
-
-/*!***************************************************************************
- @Function		Surrender
- @Output		pData			The pointer to surrender the data to
- @Description	Assigns the memory address of the data to the pointer that has
-				been passed in. Sets the class's number of elements and 
-				data pointer back to their default values.
-*****************************************************************************/
-	int Surrender(
-		char ** const pData)
-	{
-		int nCnt;
-
-		*pData = m_p;
-		nCnt = m_nCnt;
-
-		m_p		= NULL;
-		m_nCnt	= 0;
-
-		return nCnt;
+		if(nCost != o.nCost) return nCost > o.nCost;
+		if(nSet != o.nSet) return nSet > o.nSet;
+		return nSrc > o.nSrc;
 	}
 };
 
@@ -391,9 +257,10 @@ public:
 /****************************************************************************
 ** Local function definitions
 ****************************************************************************/
-static bool FillBatch(
-	CBatch					&batch,
-	const unsigned int	* const pui32Idx,	// input AND output; index array for triangle list
+static bool GetTriangleBones(
+	int						* const pnBones,	// Output sorted, unique bone indices
+	int						* const pnCnt,		// Output number of bone indices
+	const unsigned int	* const pui32Idx,	// Index array for the triangle
 	const char				* const pVtx,	// Input vertices
 	const int				nStride,		// Size of a vertex (in bytes)
 	const int				nOffsetWeight,	// Offset in bytes to the vertex bone-weights
@@ -402,6 +269,25 @@ static bool FillBatch(
 	EPVRTDataType			eTypeIdx,		// Data type of the vertex bone-indices
 	const int				nVertexBones);	// Number of bones affecting each vertex
 
+static void FindBestMerge(
+	const CBoneSets			&sets,
+	const std::vector<int>	&vAlive,
+	const std::vector<int>	&vVer,
+	const int				nSet,
+	const int				nBatchBoneMax,
+	std::priority_queue<SBoneSetMerge>	&queue);
+
+static int FindRoot(
+	std::vector<int>		&vParent,
+	int						n);
+
+static void CreatePairwiseBatches(
+	CBoneSets				&sets,
+	const std::vector<int>	&vTriSet,
+	const int				nSetBase,
+	const int				nBatchBoneMax,
+	std::vector<int>		&vBatchSet);
+
 static bool BonesMatch(
 	const float * const pfIdx0,
 	const float * const pfIdx1);
@@ -426,7 +312,17 @@ static bool BonesMatch(
  @Input			nBatchBoneMax	Number of bones a batch can reference
  @Input			nVertexBones	Number of bones affecting each vertex
  @Returns		PVR_SUCCESS if successful
- @Description	Fills the bone batch structure
+ @Description	Fills the bone batch structure.
+
+				The distinct bone sets referenced by the triangles are
+				gathered into bitsets, and any set contained within another
+				is absorbed by it. The remaining sets are then merged
+				greedily, always performing the merge that adds the fewest
+				bones to a batch next, until no two batches can be merged
+				without exceeding nBatchBoneMax. Finally, the triangles are
+				grouped by batch, and each vertex is duplicated once for
+				each distinct bone-index palette mapping it requires.
+				(patched for Cocos3D by Bill Hollings)
 *****************************************************************************/
 EPVRTError CPVRTBoneBatches::Create(
 	int					* const pnVtxNumOut,
@@ -443,20 +339,12 @@ EPVRTError CPVRTBoneBatches::Create(
 	const int			nBatchBoneMax,
 	const int			nVertexBones)
 {
-	int							i, j, k, nTriCnt;
-	CBatch						batch;
-	std::list<CBatch>			lBatch;
-	std::list<CBatch>::iterator	iBatch, iBatch2;
-	CBatch						**ppBatch;
-	unsigned int				*pui32IdxNew;
-	const char					*pV, *pV2;
-	PVRTVECTOR4					vWeight, vIdx;
-	PVRTVECTOR4					vWeight2, vIdx2;
-	std::vector<int>			*pvDup;
-	CGrowableArray				*pVtxBuf;
-	unsigned int				ui32SrcIdx;
+	int					i, j, k, nTriCnt, nBoneNum;
+	PVRTVECTOR4			vWeight, vIdx;
 
 	memset(this, 0, sizeof(*this));
+	*pnVtxNumOut = 0;
+	*pVtxOut = NULL;
 
 	if(nVertexBones <= 0 || nVertexBones > 4)
 	{
@@ -465,186 +353,252 @@ EPVRTError CPVRTBoneBatches::Create(
 	}
 
 	memset(&vWeight, 0, sizeof(vWeight));
-	memset(&vWeight2, 0, sizeof(vWeight2));
 	memset(&vIdx, 0, sizeof(vIdx));
-	memset(&vIdx2, 0, sizeof(vIdx2));
 
-	batch.SetSize(nBatchBoneMax);
+	// Gather the bones used by each triangle, and find the number of distinct bone indices.
+	std::vector<int> vTriBones(nTriNum * PVRT_BONEBATCH_TRI_BONES_MAX);
+	std::vector<int> vTriBoneCnt(nTriNum);
+	nBoneNum = 0;
+	for(i = 0; i < nTriNum; ++i)
+	{
+		if(!GetTriangleBones(&vTriBones[i * PVRT_BONEBATCH_TRI_BONES_MAX], &vTriBoneCnt[i], &pui32Idx[i * 3],
+							 pVtx, nStride, nOffsetWeight, eTypeWeight, nOffsetIdx, eTypeIdx, nVertexBones) ||
+		   vTriBoneCnt[i] > nBatchBoneMax)
+			return PVR_FAIL;
 
-	// Allocate some working space
-	ppBatch		= (CBatch**)malloc(nTriNum * sizeof(*ppBatch));
-	pui32IdxNew	= (unsigned int*)malloc(nTriNum * 3 * sizeof(*pui32IdxNew));
-	pvDup		= new std::vector<int>[nVtxNum];
-	pVtxBuf		= new CGrowableArray(nStride);
+		if(vTriBoneCnt[i])
+			nBoneNum = PVRT_MAX(nBoneNum, vTriBones[i * PVRT_BONEBATCH_TRI_BONES_MAX + vTriBoneCnt[i] - 1] + 1);
+	}
 
-	// Check what batches are necessary
+	// Find the distinct bone sets, by sorting the triangles by bone set.
+	std::vector<int> vTriOrder(nTriNum);
 	for(i = 0; i < nTriNum; ++i)
+		vTriOrder[i] = i;
+	struct SCompareTriBones
 	{
-		// Build the batch
-		if(!FillBatch(batch, &pui32Idx[i * 3], pVtx, nStride, nOffsetWeight, eTypeWeight, nOffsetIdx, eTypeIdx, nVertexBones))
+		const int *pnBones, *pnCnt;
+		bool operator()(const int a, const int b) const
 		{
-			free(pui32IdxNew);
-			return PVR_FAIL;
+			if(pnCnt[a] != pnCnt[b]) return pnCnt[a] > pnCnt[b];		// Largest sets first
+			int c = memcmp(&pnBones[a * PVRT_BONEBATCH_TRI_BONES_MAX], &pnBones[b * PVRT_BONEBATCH_TRI_BONES_MAX], pnCnt[a] * sizeof(int));
+			if(c != 0) return c < 0;
+			return a < b;
 		}
+	} sCompare = { &vTriBones[0], &vTriBoneCnt[0] };
+	if(nTriNum > 0)
+		std::sort(vTriOrder.begin(), vTriOrder.end(), sCompare);
 
-		// Update the batch list
-		for(iBatch = lBatch.begin(); iBatch != lBatch.end(); ++iBatch)
+	CBoneSets			sets(nBoneNum);
+	std::vector<int>	vTriSet(nTriNum);
+	std::vector<int>	vParent;			// The set that absorbed each set, or itself
+	for(i = 0; i < nTriNum; ++i)
+	{
+		int nTri = vTriOrder[i];
+		if(i > 0)
 		{
-			// Do nothing if an existing batch is a superset of this new batch
-			if(iBatch->Contains(batch))
+			int nPrev = vTriOrder[i - 1];
+			if(vTriBoneCnt[nTri] == vTriBoneCnt[nPrev] &&
+			   memcmp(&vTriBones[nTri * PVRT_BONEBATCH_TRI_BONES_MAX], &vTriBones[nPrev * PVRT_BONEBATCH_TRI_BONES_MAX], vTriBoneCnt[nTri] * sizeof(int)) == 0)
 			{
-				break;
+				vTriSet[nTri] = vTriSet[nPrev];
+				continue;
 			}
+		}
+		vTriSet[nTri] = sets.Add(&vTriBones[nTri * PVRT_BONEBATCH_TRI_BONES_MAX], vTriBoneCnt[nTri]);
+		vParent.push_back(vTriSet[nTri]);
+	}
+	int nSetNum = (int)vParent.size();
 
-			// If this new batch is a superset of an existing batch, replace the old with the new
-			if(batch.Contains(*iBatch))
+	// Absorb each set into the first larger set that contains it. Sets were created largest first.
+	std::vector<int> vAlive;
+	for(i = 0; i < nSetNum; ++i)
+	{
+		for(j = 0; j < (int)vAlive.size(); ++j)
+		{
+			if(sets.Contains(vAlive[j], i))
 			{
-				*iBatch = batch;
+				vParent[i] = vAlive[j];
 				break;
 			}
 		}
-
-		// If no suitable batch exists, create a new one
-		if(iBatch == lBatch.end())
-		{
-			lBatch.push_back(batch);
-		}
+		if(j == (int)vAlive.size())
+			vAlive.push_back(i);
 	}
 
-	//	Group batches into fewer batches. This simple greedy algorithm could be improved.
-		int							nCurrent, nShortest;
-		std::list<CBatch>::iterator	iShortest;
+	// Merging modifies sets in place, so keep a copy of each distinct set, at nSetNum + set.
+	for(i = 0; i < nSetNum; ++i)
+		sets.Copy(i);
 
-		for(iBatch = lBatch.begin(); iBatch != lBatch.end(); ++iBatch)
-		{
-			for(;;)
-			{
-				nShortest	= nBatchBoneMax;
-				iBatch2		= iBatch;
-				++iBatch2;
-				for(; iBatch2 != lBatch.end(); ++iBatch2)
-				{
-					nCurrent = iBatch->TestMerge(*iBatch2);
+	// Greedily merge batches, always performing the merge that adds the fewest bones next.
+	std::vector<int> vIsAlive(nSetNum, 0), vVer(nSetNum, 0);
+	for(i = 0; i < (int)vAlive.size(); ++i)
+		vIsAlive[vAlive[i]] = 1;
 
-					if(nCurrent >= 0 && nCurrent < nShortest)
-					{
-						nShortest	= nCurrent;
-						iShortest	= iBatch2;
-					}
-				}
+	std::priority_queue<SBoneSetMerge> queue;
+	for(i = 0; i < (int)vAlive.size(); ++i)
+		FindBestMerge(sets, vIsAlive, vVer, vAlive[i], nBatchBoneMax, queue);
 
-				if(nShortest < nBatchBoneMax)
-				{
-					iBatch->Merge(*iShortest);
-					lBatch.erase(iShortest);
-				}
-				else
-				{
-					break;
-				}
-			}
-		}
-
-	// Place each triangle in a batch.
-	for(i = 0; i < nTriNum; ++i)
+	while(!queue.empty())
 	{
-		if(!FillBatch(batch, &pui32Idx[i * 3], pVtx, nStride, nOffsetWeight, eTypeWeight, nOffsetIdx, eTypeIdx, nVertexBones))
+		SBoneSetMerge sMerge = queue.top();
+		queue.pop();
+
+		if(!vIsAlive[sMerge.nSet])
+			continue;
+
+		// If either set has changed since the candidate was found, find a new candidate.
+		if(!vIsAlive[sMerge.nSrc] || sMerge.nSetVer != vVer[sMerge.nSet] || sMerge.nSrcVer != vVer[sMerge.nSrc])
 		{
-			free(pui32IdxNew);
-			return PVR_FAIL;
+			FindBestMerge(sets, vIsAlive, vVer, sMerge.nSet, nBatchBoneMax, queue);
+			continue;
 		}
 
-		for(iBatch = lBatch.begin(); iBatch != lBatch.end(); ++iBatch)
+		sets.Merge(sMerge.nSet, sMerge.nSrc);
+		_ASSERT(sets.Count(sMerge.nSet) <= nBatchBoneMax);
+		vIsAlive[sMerge.nSrc] = 0;
+		vParent[sMerge.nSrc] = sMerge.nSet;
+		++vVer[sMerge.nSet];
+		FindBestMerge(sets, vIsAlive, vVer, sMerge.nSet, nBatchBoneMax, queue);
+	}
+
+	// Number the surviving batches, in creation order, and map each distinct set to its batch.
+	std::vector<int> vSetBatch(nSetNum, -1), vBatchSet;
+	for(i = 0; i < nSetNum; ++i)
+		if(vIsAlive[i])
+		{
+			vSetBatch[i] = (int)vBatchSet.size();
+			vBatchSet.push_back(i);
+		}
+	for(i = 0; i < nSetNum; ++i)
+		vSetBatch[i] = vSetBatch[FindRoot(vParent, i)];
+
+	// The greedy merge can occasionally finish with more batches than the original pairwise
+	// pass. Unless the greedy result already uses the fewest batches possible, also run the
+	// pairwise pass, and keep whichever result has fewer batches.
+	int nBatchLowerBound = 0;
+	if(nSetNum > 0)
+	{
+		int nUnion = sets.Copy(nSetNum);
+		for(i = 1; i < nSetNum; ++i)
+			sets.Merge(nUnion, nSetNum + i);
+		nBatchLowerBound = (sets.Count(nUnion) + nBatchBoneMax - 1) / nBatchBoneMax;
+	}
+	if((int)vBatchSet.size() > nBatchLowerBound)
+	{
+		std::vector<int> vPairwiseBatchSet;
+		CreatePairwiseBatches(sets, vTriSet, nSetNum, nBatchBoneMax, vPairwiseBatchSet);
+		if(vPairwiseBatchSet.size() < vBatchSet.size())
 		{
-			if(iBatch->Contains(batch))
+			// As in the pairwise pass, each distinct set goes in the first batch that contains it
+			vBatchSet.swap(vPairwiseBatchSet);
+			for(i = 0; i < nSetNum; ++i)
 			{
-				ppBatch[i] = &*iBatch;
-				break;
+				for(j = 0; !sets.Contains(vBatchSet[j], nSetNum + i); ++j) {}
+				vSetBatch[i] = j;
 			}
 		}
+	}
+	nBatchCnt = (int)vBatchSet.size();
 
-		_ASSERT(iBatch != lBatch.end());
+	// Assign each triangle to its batch.
+	std::vector<int> vBatchTriStart(nBatchCnt + 1, 0), vBatchTris(nTriNum);
+	for(i = 0; i < nTriNum; ++i)
+	{
+		vTriSet[i] = vSetBatch[vTriSet[i]];
+		++vBatchTriStart[vTriSet[i] + 1];
 	}
+	for(i = 0; i < nBatchCnt; ++i)
+		vBatchTriStart[i + 1] += vBatchTriStart[i];
+	std::vector<int> vBatchTriNext(vBatchTriStart.begin(), vBatchTriStart.end() - 1);
+	for(i = 0; i < nTriNum; ++i)
+		vBatchTris[vBatchTriNext[vTriSet[i]]++] = i;
 
 	// Now that we know how many batches there are, we can allocate the output arrays
 	CPVRTBoneBatches::nBatchBoneMax = nBatchBoneMax;
-	pnBatches		= (int*) calloc(lBatch.size() * nBatchBoneMax, sizeof(*pnBatches));
-	pnBatchBoneCnt	= (int*) calloc(lBatch.size(), sizeof(*pnBatchBoneCnt));
-	pnBatchOffset	= (int*) calloc(lBatch.size(), sizeof(*pnBatchOffset));
+	pnBatches		= (int*) calloc(PVRT_MAX(nBatchCnt, 1) * nBatchBoneMax, sizeof(*pnBatches));
+	pnBatchBoneCnt	= (int*) calloc(PVRT_MAX(nBatchCnt, 1), sizeof(*pnBatchBoneCnt));
+	pnBatchOffset	= (int*) calloc(PVRT_MAX(nBatchCnt, 1), sizeof(*pnBatchOffset));
+
+	// Working space for splitting vertices. Each output vertex records its remapped bone
+	// indices, and links to the next output vertex duplicated from the same input vertex.
+	std::vector<int>	vDupHead(nVtxNum, -1), vDupNext;
+	std::vector<float>	vDupIdx;
+	std::vector<int>	vBonePalette(PVRT_MAX(nBoneNum, 1), -1);
+	std::vector<unsigned int> vIdxNew(nTriNum * 3);
+	std::vector<char>	vVtxBuf;
+	int					nVtxOut = 0;
 
 	// Create the new triangle index list, the new vertex list, and the batch information.
 	nTriCnt = 0;
-	nBatchCnt = 0;
-
-	for(iBatch = lBatch.begin(); iBatch != lBatch.end(); ++iBatch)
+	for(int nBatch = 0; nBatch < nBatchCnt; ++nBatch)
 	{
 		// Write pnBatches, pnBatchBoneCnt and pnBatchOffset for this batch.
-		iBatch->Write(&pnBatches[nBatchCnt * nBatchBoneMax], &pnBatchBoneCnt[nBatchCnt]);
-		pnBatchOffset[nBatchCnt] = nTriCnt;
-		++nBatchCnt;
+		int *pnPalette = &pnBatches[nBatch * nBatchBoneMax];
+		sets.Write(vBatchSet[nBatch], pnPalette, &pnBatchBoneCnt[nBatch]);
+		_ASSERT(pnBatchBoneCnt[nBatch] <= nBatchBoneMax);
+		pnBatchOffset[nBatch] = nTriCnt;
+		for(j = 0; j < pnBatchBoneCnt[nBatch]; ++j)
+			vBonePalette[pnPalette[j]] = j;
 
 		// Copy any triangle indices for this batch
-		for(i = 0; i < nTriNum; ++i)
+		for(int nTriPos = vBatchTriStart[nBatch]; nTriPos < vBatchTriStart[nBatch + 1]; ++nTriPos)
 		{
-			if(ppBatch[i] != &*iBatch)
-				continue;
-
+			i = vBatchTris[nTriPos];
 			for(j = 0; j < 3; ++j)
 			{
-				ui32SrcIdx = pui32Idx[3 * i + j];
+				unsigned int ui32SrcIdx = pui32Idx[3 * i + j];
 
 				// Get desired bone indices for this vertex/tri
-				pV = &pVtx[ui32SrcIdx * nStride];
+				const char *pV = &pVtx[ui32SrcIdx * nStride];
 
 				PVRTVertexRead(&vWeight, &pV[nOffsetWeight], eTypeWeight, nVertexBones);
 				PVRTVertexRead(&vIdx, &pV[nOffsetIdx], eTypeIdx, nVertexBones);
 
-				iBatch->GetVertexBoneIndices(&vIdx.x, &vWeight.x, nVertexBones);
+				float *pfIdx = &vIdx.x, *pfWeight = &vWeight.x;
+				for(k = 0; k < nVertexBones; ++k)
+					pfIdx[k] = (pfWeight[k] != 0) ? (float)vBonePalette[(int)pfIdx[k]] : 0;
 				_ASSERT(vIdx.x == 0 || vIdx.x != vIdx.y);
 
 				// Check the list of copies of this vertex for one with suitable bone indices
-				for(k = 0; k < (int)pvDup[ui32SrcIdx].size(); ++k)
+				for(k = vDupHead[ui32SrcIdx]; k >= 0; k = vDupNext[k])
 				{
-					pV2 = pVtxBuf->at(pvDup[ui32SrcIdx][k]);
-
-					PVRTVertexRead(&vWeight2, &pV2[nOffsetWeight], eTypeWeight, nVertexBones);
-					PVRTVertexRead(&vIdx2, &pV2[nOffsetIdx], eTypeIdx, nVertexBones);
-
-					if(BonesMatch(&vIdx2.x, &vIdx.x))
-					{
-						pui32IdxNew[3 * nTriCnt + j] = pvDup[ui32SrcIdx][k];
+					if(BonesMatch(&vDupIdx[k * 4], pfIdx))
 						break;
-					}
 				}
 
-				if(k != (int)pvDup[ui32SrcIdx].size())
-					continue;
-
-				//	Did not find a suitable duplicate of the vertex, so create one
-				pVtxBuf->Append(pV, 1);
-				pvDup[ui32SrcIdx].push_back(pVtxBuf->size() - 1);
-
-				PVRTVertexWrite(&pVtxBuf->last()[nOffsetIdx], eTypeIdx, nVertexBones, &vIdx);
+				if(k < 0)
+				{
+					//	Did not find a suitable duplicate of the vertex, so create one
+					k = nVtxOut++;
+					vVtxBuf.resize(nVtxOut * nStride);
+					memcpy(&vVtxBuf[k * nStride], pV, nStride);
+					PVRTVertexWrite(&vVtxBuf[k * nStride + nOffsetIdx], eTypeIdx, nVertexBones, &vIdx);
+
+					// Record the bone indices as written, so they compare as the stored vertex would
+					PVRTVECTOR4 vIdxWritten;
+					memset(&vIdxWritten, 0, sizeof(vIdxWritten));
+					PVRTVertexRead(&vIdxWritten, &vVtxBuf[k * nStride + nOffsetIdx], eTypeIdx, nVertexBones);
+					vDupIdx.insert(vDupIdx.end(), &vIdxWritten.x, &vIdxWritten.x + 4);
+					vDupNext.push_back(vDupHead[ui32SrcIdx]);
+					vDupHead[ui32SrcIdx] = k;
+				}
 
-				pui32IdxNew[3 * nTriCnt + j] = pVtxBuf->size() - 1;
+				vIdxNew[3 * nTriCnt + j] = k;
 			}
 			++nTriCnt;
 		}
 	}
 	_ASSERTE(nTriCnt == nTriNum);
-	_ASSERTE(nBatchCnt == (int)lBatch.size());
 
 	//	Copy indices to output
-	memcpy(pui32Idx, pui32IdxNew, nTriNum * 3 * sizeof(*pui32IdxNew));
+	if(nTriNum > 0)
+		memcpy(pui32Idx, &vIdxNew[0], nTriNum * 3 * sizeof(*pui32Idx));
 
 	//	Move vertices to output
-	*pnVtxNumOut = pVtxBuf->Surrender(pVtxOut);
-
-	//	Free working memory
-	delete [] pvDup;
-	delete pVtxBuf;
-	FREE(ppBatch);
-	FREE(pui32IdxNew);
+	*pnVtxNumOut = nVtxOut;
+	*pVtxOut = (char*)malloc(PVRT_MAX(nVtxOut * nStride, 1));
+	if(nVtxOut > 0)
+		memcpy(*pVtxOut, &vVtxBuf[0], nVtxOut * nStride);
 
 	return PVR_SUCCESS;
 }
@@ -654,8 +608,9 @@ EPVRTError CPVRTBoneBatches::Create(
 ****************************************************************************/
 
 /*!***********************************************************************
- @Function		FillBatch
- @Modified		batch 			The batch to fill
+ @Function		GetTriangleBones
+ @Output		pnBones			The sorted, unique bone indices of the triangle
+ @Output		pnCnt			The number of bone indices of the triangle
  @Input			pui32Idx		Input index array for triangle list
  @Input			pVtx			Input vertices
  @Input			nStride			Size of a vertex (in bytes)
@@ -665,10 +620,12 @@ EPVRTError CPVRTBoneBatches::Create(
  @Input			eTypeIdx		Data type of the vertex bone-indices
  @Input			nVertexBones	Number of bones affecting each vertex
  @Returns		True if successful
- @Description	Creates a bone batch from a triangle.
+ @Description	Gathers the bones with non-zero weights used by a triangle.
+				(patched for Cocos3D by Bill Hollings)
 *************************************************************************/
-static bool FillBatch(
-	CBatch					&batch,
+static bool GetTriangleBones(
+	int						* const pnBones,
+	int						* const pnCnt,
 	const unsigned int	* const pui32Idx,
 	const char				* const pVtx,
 	const int				nStride,
@@ -680,11 +637,8 @@ static bool FillBatch(
 {
 	PVRTVECTOR4	vWeight, vIdx;
 	const char	*pV;
-	int			i;
-	bool		bOk;
+	int			i, j, nCnt = 0;
 
-	bOk = true;
-	batch.Clear();
 	for(i = 0; i < 3; ++i)
 	{
 		pV = &pVtx[pui32Idx[i] * nStride];
@@ -693,12 +647,172 @@ static bool FillBatch(
 		PVRTVertexRead(&vWeight, &pV[nOffsetWeight], eTypeWeight, nVertexBones);
 		PVRTVertexRead(&vIdx, &pV[nOffsetIdx], eTypeIdx, nVertexBones);
 
-		if(nVertexBones >= 1 && vWeight.x != 0)	bOk &= batch.Add((int)vIdx.x);
-		if(nVertexBones >= 2 && vWeight.y != 0)	bOk &= batch.Add((int)vIdx.y);
-		if(nVertexBones >= 3 && vWeight.z != 0)	bOk &= batch.Add((int)vIdx.z);
-		if(nVertexBones >= 4 && vWeight.w != 0)	bOk &= batch.Add((int)vIdx.w);
+		const float *pfWeight = &vWeight.x, *pfIdx = &vIdx.x;
+		for(j = 0; j < nVertexBones; ++j)
+		{
+			if(pfWeight[j] == 0)
+				continue;
+			if((int)pfIdx[j] < 0)
+				return false;
+			pnBones[nCnt++] = (int)pfIdx[j];
+		}
+	}
+
+	std::sort(pnBones, pnBones + nCnt);
+	*pnCnt = (int)(std::unique(pnBones, pnBones + nCnt) - pnBones);
+	return true;
+}
+
+/*!***********************************************************************
+ @Function		FindBestMerge
+ @Input			sets			The bone sets
+ @Input			vAlive			Whether each set is still a batch
+ @Input			vVer			The version of each set
+ @Input			nSet			The set to find a merge for
+ @Input			nBatchBoneMax	Number of bones a batch can reference
+ @Modified		queue			The queue of candidate merges
+ @Description	Finds the batch that can be merged into nSet while adding
+				the fewest bones to it, and queues the candidate merge.
+				(patched for Cocos3D by Bill Hollings)
+*************************************************************************/
+static void FindBestMerge(
+	const CBoneSets			&sets,
+	const std::vector<int>	&vAlive,
+	const std::vector<int>	&vVer,
+	const int				nSet,
+	const int				nBatchBoneMax,
+	std::priority_queue<SBoneSetMerge>	&queue)
+{
+	SBoneSetMerge sBest;
+	sBest.nCost = nBatchBoneMax + 1;
+	sBest.nSet = nSet;
+	sBest.nSrc = -1;
+	sBest.nSetVer = vVer[nSet];
+	sBest.nSrcVer = 0;
+
+	int nRoom = nBatchBoneMax - sets.Count(nSet);
+	for(int i = 0; i < (int)vAlive.size(); ++i)
+	{
+		if(!vAlive[i] || i == nSet)
+			continue;
+
+		int nCost = sets.TestMerge(nSet, i);
+		if(nCost <= nRoom && nCost < sBest.nCost)
+		{
+			sBest.nCost = nCost;
+			sBest.nSrc = i;
+			sBest.nSrcVer = vVer[i];
+			if(nCost == 0)
+				break;
+		}
+	}
+
+	if(sBest.nSrc >= 0)
+		queue.push(sBest);
+}
+
+/*!***********************************************************************
+ @Function		FindRoot
+ @Modified		vParent			The set that absorbed each set, or itself
+ @Input			n				The set
+ @Returns		The set that is the final batch containing n
+ @Description	Follows the chain of absorbing sets, compressing the path.
+				(patched for Cocos3D by Bill Hollings)
+*************************************************************************/
+static int FindRoot(
+	std::vector<int>		&vParent,
+	int						n)
+{
+	int nRoot = n;
+	while(vParent[nRoot] != nRoot)
+		nRoot = vParent[nRoot];
+	while(vParent[n] != nRoot)
+	{
+		int nNext = vParent[n];
+		vParent[n] = nRoot;
+		n = nNext;
+	}
+	return nRoot;
+}
+
+/*!***********************************************************************
+ @Function		CreatePairwiseBatches
+ @Modified		sets			The bone sets, to which the new batches are appended
+ @Input			vTriSet			The distinct bone set of each triangle
+ @Input			nSetBase		Index of the unmodified copy of the first distinct set
+ @Input			nBatchBoneMax	Number of bones a batch can reference
+ @Output		vBatchSet		The bone set of each batch
+ @Description	Batches the bone sets using the original PowerVR algorithm.
+				The set of each triangle is visited in triangle order, and either
+				joins the first batch that contains it, or replaces the first
+				batch that it contains, or starts a new batch.
+				Then each batch in turn repeatedly absorbs the later batch that
+				adds the fewest bones to it, until no later batch fits.
+				(patched for Cocos3D by Bill Hollings)
+*************************************************************************/
+static void CreatePairwiseBatches(
+	CBoneSets				&sets,
+	const std::vector<int>	&vTriSet,
+	const int				nSetBase,
+	const int				nBatchBoneMax,
+	std::vector<int>		&vBatchSet)
+{
+	int i, j;
+
+	// Visit the set of each triangle in turn. A set can replace an earlier batch even after
+	// it has been placed, so only a repeat of the previous triangle's set can be skipped.
+	for(i = 0; i < (int)vTriSet.size(); ++i)
+	{
+		int nSet = nSetBase + vTriSet[i];
+		if(i > 0 && vTriSet[i] == vTriSet[i - 1])
+			continue;
+
+		for(j = 0; j < (int)vBatchSet.size(); ++j)
+		{
+			if(sets.Contains(vBatchSet[j], nSet))
+				break;
+			if(sets.Contains(nSet, vBatchSet[j]))
+			{
+				sets.Assign(vBatchSet[j], nSet);
+				break;
+			}
+		}
+		if(j == (int)vBatchSet.size())
+			vBatchSet.push_back(sets.Copy(nSet));
 	}
-	return bOk;
+
+	// Each batch in turn absorbs the later batch that adds the fewest bones, while one fits.
+	std::vector<char> vBatchAlive(vBatchSet.size(), 1);
+	for(i = 0; i < (int)vBatchSet.size(); ++i)
+	{
+		if(!vBatchAlive[i])
+			continue;
+		for(;;)
+		{
+			int nShortest = nBatchBoneMax, nBest = -1;
+			int nRoom = nBatchBoneMax - sets.Count(vBatchSet[i]);
+			for(j = i + 1; j < (int)vBatchSet.size(); ++j)
+			{
+				if(!vBatchAlive[j])
+					continue;
+				int nCost = sets.TestMerge(vBatchSet[i], vBatchSet[j]);
+				if(nCost <= nRoom && nCost < nShortest)
+				{
+					nShortest = nCost;
+					nBest = j;
+				}
+			}
+			if(nBest < 0)
+				break;
+			sets.Merge(vBatchSet[i], vBatchSet[nBest]);
+			vBatchAlive[nBest] = 0;
+		}
+	}
+
+	for(i = j = 0; i < (int)vBatchSet.size(); ++i)
+		if(vBatchAlive[i])
+			vBatchSet[j++] = vBatchSet[i];
+	vBatchSet.resize(j);
 }
 
 /*!***********************************************************************
@@ -726,4 +840,3 @@ static bool BonesMatch(
 /*****************************************************************************
  End of file (PVRTBoneBatch.cpp)
 *****************************************************************************/
-
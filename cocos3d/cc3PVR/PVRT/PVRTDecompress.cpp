@@ -26,6 +26,94 @@
 #include "PVRTTexture.h"
 #include "PVRTGlobal.h"
 
+#if defined(__APPLE__)								// patched for Cocos3D by Bill Hollings
+#define PVRT_PARALLEL_DECOMPRESS_GCD 1
+#include <dispatch/dispatch.h>
+#elif defined(__linux__)
+#define PVRT_PARALLEL_DECOMPRESS_PTHREADS 1
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/*****************************************************************************
+ * Parallel decompression							// patched for Cocos3D by Bill Hollings
+ *****************************************************************************/
+
+// Surfaces with fewer pixels than this are decompressed on the calling thread.
+#define PVRT_PARALLEL_DECOMPRESS_MIN_PIXELS		(256 * 256)
+
+// Maximum number of worker threads used when decompressing with pthreads.
+#define PVRT_PARALLEL_DECOMPRESS_MAX_THREADS	16
+
+// Number of rows of blocks decompressed together as one independent band.
+#define PVRT_PARALLEL_DECOMPRESS_BAND_ROWS		8
+
+typedef void (*PVRTDecompressBandFunc)(void* pContext, size_t band);
+
+#if defined(PVRT_PARALLEL_DECOMPRESS_PTHREADS)
+struct PVRTDecompressBandQueue
+{
+	PVRTDecompressBandFunc	pfnBand;
+	void*					pContext;
+	size_t					nBandCount;
+	volatile long			nNextBand;
+};
+
+static void* decompressBandWorker(void* pArg)
+{
+	PVRTDecompressBandQueue* pQueue = (PVRTDecompressBandQueue*)pArg;
+	size_t band;
+	while ((band = (size_t)__sync_fetch_and_add(&pQueue->nNextBand, 1)) < pQueue->nBandCount)
+		pQueue->pfnBand(pQueue->pContext, band);
+	return NULL;
+}
+#endif
+
+/*!***********************************************************************
+ @Function		decompressBands
+ @Input			nBandCount		Number of independent bands to decompress.
+ @Input			bParallel		Whether the bands may be run concurrently.
+ @Input			pfnBand			Function that decompresses a single band.
+ @Modified		pContext		Context passed to each invocation of pfnBand.
+ @Description	Runs pfnBand once for each band. Each band must write to a
+				region of the output that does not overlap any other band,
+				so the result is identical regardless of how many threads
+				are used. Bands are run concurrently where the platform
+				supports it, otherwise sequentially on the calling thread.
+*************************************************************************/
+static void decompressBands(size_t nBandCount, bool bParallel, PVRTDecompressBandFunc pfnBand, void* pContext)
+{
+	if(bParallel && nBandCount > 1)
+	{
+#if defined(PVRT_PARALLEL_DECOMPRESS_GCD)
+		dispatch_apply_f(nBandCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), pContext, pfnBand);
+		return;
+#elif defined(PVRT_PARALLEL_DECOMPRESS_PTHREADS)
+		long nCPUs = sysconf(_SC_NPROCESSORS_ONLN);
+		size_t nThreads = (size_t)PVRT_MIN(PVRT_MAX(nCPUs, 1L), (long)PVRT_PARALLEL_DECOMPRESS_MAX_THREADS);
+		nThreads = PVRT_MIN(nThreads, nBandCount);
+
+		PVRTDecompressBandQueue queue = { pfnBand, pContext, nBandCount, 0 };
+		pthread_t threads[PVRT_PARALLEL_DECOMPRESS_MAX_THREADS];
+		size_t nStarted = 0;
+
+		// The calling thread also works through the queue, so start one less worker.
+		for(size_t i = 1; i < nThreads; ++i)
+		{
+			if(pthread_create(&threads[nStarted], NULL, decompressBandWorker, &queue) == 0)
+				++nStarted;
+		}
+		decompressBandWorker(&queue);
+		for(size_t i = 0; i < nStarted; ++i)
+			pthread_join(threads[i], NULL);
+		return;
+#endif
+	}
+
+	for(size_t band = 0; band < nBandCount; ++band)
+		pfnBand(pContext, band);
+}
+
 /***********************************************************
 				DECOMPRESSION ROUTINES
 ************************************************************/
@@ -615,40 +703,42 @@ static void mapDecompressedData(Pixel32* pOutput, int width,
 		}
 	}
 }
+struct PVRTCDecompressContext						// patched for Cocos3D by Bill Hollings
+{
+	const PVRTuint32*	pWordMembers;
+	Pixel32*			pOutData;
+	PVRTuint32			ui32Width;
+	int					i32NumXWords;
+	int					i32NumYWords;
+	PVRTuint8			ui8Bpp;
+};
+
 /*!***********************************************************************
- @Function		pvrtcDecompress
- @Input			pCompressedData		The PVRTC texture data to decompress
- @Modified		pDecompressedData	The output buffer to decompress into.
- @Input			ui32Width			X dimension of the texture
- @Input			ui32Height			Y dimension of the texture
- @Input			ui8Bpp				number of bits per pixel
- @Description	Internally decompresses PVRTC to RGBA 8888
+ @Function		pvrtcDecompressBand
+ @Modified		pContext			The PVRTCDecompressContext of the surface.
+ @Input			band				The index of the band of word rows to decompress.
+ @Description	Decompresses one band of PVRT_PARALLEL_DECOMPRESS_BAND_ROWS
+				rows of word-sized decompression areas. Each decompression
+				area writes to pixels that no other area writes to, so bands
+				can be decompressed independently.
 *************************************************************************/
-static int pvrtcDecompress(	PVRTuint8 *pCompressedData,
-							Pixel32 *pDecompressedData,
-							PVRTuint32 ui32Width,
-							PVRTuint32 ui32Height,
-							PVRTuint8 ui8Bpp)
+static void pvrtcDecompressBand(void* pContext, size_t band)
 {
-	PVRTuint32 ui32WordWidth=4;
-	PVRTuint32 ui32WordHeight=4;
-	if (ui8Bpp==2)
-		ui32WordWidth=8;
-
-	PVRTuint32 *pWordMembers = (PVRTuint32 *)pCompressedData;
-	Pixel32 *pOutData = pDecompressedData;
-
-	// Calculate number of words
-	int i32NumXWords = (int)(ui32Width / ui32WordWidth);
-	int i32NumYWords = (int)(ui32Height / ui32WordHeight);
+	const PVRTCDecompressContext& ctx = *(const PVRTCDecompressContext*)pContext;
+	const PVRTuint32 *pWordMembers = ctx.pWordMembers;
+	const int i32NumXWords = ctx.i32NumXWords;
+	const int i32NumYWords = ctx.i32NumYWords;
 
 	// Structs used for decompression
 	PVRTCWordIndices indices;
-	Pixel32 *pPixels;
-	pPixels = (Pixel32*)malloc(ui32WordWidth*ui32WordHeight*sizeof(Pixel32));
-	
+	Pixel32 pPixels[8*4];
+
+	// Decompression areas start one word before the surface, and wrap around.
+	int wordYStart = -1 + (int)(band * PVRT_PARALLEL_DECOMPRESS_BAND_ROWS);
+	int wordYEnd = PVRT_MIN(wordYStart + PVRT_PARALLEL_DECOMPRESS_BAND_ROWS, i32NumYWords - 1);
+
 	// For each row of words
-	for(int wordY=-1; wordY < i32NumYWords-1; wordY++)
+	for(int wordY=wordYStart; wordY < wordYEnd; wordY++)
 	{
 		// for each column of words
 		for(int wordX=-1; wordX < i32NumXWords-1; wordX++)
@@ -683,13 +773,51 @@ static int pvrtcDecompress(	PVRTuint8 *pCompressedData,
 			S.u32ModulationData = pWordMembers[WordOffsets[3]];
 							
 			// assemble 4 words into struct to get decompressed pixels from
-			pvrtcGetDecompressedPixels(P,Q,R,S,pPixels,ui8Bpp);
-			mapDecompressedData(pOutData, ui32Width, pPixels, indices, ui8Bpp);
+			pvrtcGetDecompressedPixels(P,Q,R,S,pPixels,ctx.ui8Bpp);
+			mapDecompressedData(ctx.pOutData, ctx.ui32Width, pPixels, indices, ctx.ui8Bpp);
 			
 		} // for each word
 	} // for each row of words
+}
+
+/*!***********************************************************************
+ @Function		pvrtcDecompress
+ @Input			pCompressedData		The PVRTC texture data to decompress
+ @Modified		pDecompressedData	The output buffer to decompress into.
+ @Input			ui32Width			X dimension of the texture
+ @Input			ui32Height			Y dimension of the texture
+ @Input			ui8Bpp				number of bits per pixel
+ @Input			bAllowParallel		Whether a large surface may be decompressed in parallel
+ @Description	Internally decompresses PVRTC to RGBA 8888. Large surfaces are
+				split into bands of word rows that are decompressed in parallel.
+*************************************************************************/
+static int pvrtcDecompress(	PVRTuint8 *pCompressedData,
+							Pixel32 *pDecompressedData,
+							PVRTuint32 ui32Width,
+							PVRTuint32 ui32Height,
+							PVRTuint8 ui8Bpp,
+							bool bAllowParallel)
+{
+	PVRTuint32 ui32WordWidth=4;
+	PVRTuint32 ui32WordHeight=4;
+	if (ui8Bpp==2)
+		ui32WordWidth=8;
+
+	PVRTCDecompressContext ctx;
+	ctx.pWordMembers = (const PVRTuint32 *)pCompressedData;
+	ctx.pOutData = pDecompressedData;
+	ctx.ui32Width = ui32Width;
+	ctx.ui8Bpp = ui8Bpp;
+
+	// Calculate number of words
+	ctx.i32NumXWords = (int)(ui32Width / ui32WordWidth);
+	ctx.i32NumYWords = (int)(ui32Height / ui32WordHeight);
+
+	// Each band covers a run of word rows, from -1 to i32NumYWords-2 inclusive.
+	size_t nBandCount = (ctx.i32NumYWords + PVRT_PARALLEL_DECOMPRESS_BAND_ROWS - 1) / PVRT_PARALLEL_DECOMPRESS_BAND_ROWS;
+	bool bParallel = bAllowParallel && (ui32Width * ui32Height) >= PVRT_PARALLEL_DECOMPRESS_MIN_PIXELS;
+	decompressBands(nBandCount, bParallel, pvrtcDecompressBand, &ctx);
 
-	free(pPixels);
 	//Return the data size
 	return ui32Width * ui32Height / (PVRTuint32)(ui32WordWidth/2);
 }
@@ -701,6 +829,7 @@ static int pvrtcDecompress(	PVRTuint8 *pCompressedData,
  @Input			XDim X dimension of the texture
  @Input			YDim Y dimension of the texture
  @Modified		pResultImage The decompressed texture data
+ @Input			bAllowParallel Whether a large texture may be decompressed on several threads
  @Return		Returns the amount of data that was decompressed.
  @Description	Decompresses PVRTC to RGBA 8888
 *************************************************************************/
@@ -708,7 +837,8 @@ int PVRTDecompressPVRTC(const void *pCompressedData,
 				const int Do2bitMode,
 				const int XDim,
 				const int YDim,
-				unsigned char* pResultImage)
+				unsigned char* pResultImage,
+				const bool bAllowParallel)
 {
 	//Cast the output buffer to a Pixel32 pointer.
 	Pixel32* pDecompressedData = (Pixel32*)pResultImage;
@@ -724,7 +854,7 @@ int PVRTDecompressPVRTC(const void *pCompressedData,
 	}
 		
 	//Decompress the surface.
-	int retval = pvrtcDecompress((PVRTuint8*)pCompressedData,pDecompressedData,XTrueDim,YTrueDim,(Do2bitMode==1?2:4));
+	int retval = pvrtcDecompress((PVRTuint8*)pCompressedData,pDecompressedData,XTrueDim,YTrueDim,(Do2bitMode==1?2:4),bAllowParallel);
 
 	//If the dimensions were too small, then copy the new buffer back into the output buffer.
 	if(XTrueDim!=XDim || YTrueDim!=YDim)
@@ -772,23 +902,12 @@ const int mod[8][4]={{2, 8,-2,-8},
  @Input			red		Red value of pixel
  @Input			green	Green value of pixel
  @Input			blue	Blue value of pixel
- @Input			x	Pixel x position in block
- @Input			y	Pixel y position in block
- @Input			modBlock	Values for the current block
- @Input			modTable	Modulation values
+ @Input			pixelMod	Modifier to apply to each channel
  @Returns		Returns actual pixel colour
  @Description	Used by ETCTextureDecompress
 *************************************************************************/
-static unsigned int modifyPixel(int red, int green, int blue, int x, int y, unsigned int modBlock, int modTable)
+static unsigned int modifyPixel(int red, int green, int blue, int pixelMod)		// patched for Cocos3D by Bill Hollings
 {
-	int index = x*4+y, pixelMod;
-	unsigned int mostSig = modBlock<<1;
-
-	if (index<8)
-		pixelMod = mod[modTable][((modBlock>>(index+24))&0x1)+((mostSig>>(index+8))&0x2)];
-	else
-		pixelMod = mod[modTable][((modBlock>>(index+8))&0x1)+((mostSig>>(index-8))&0x2)];
-
 	red = _CLAMP_(red+pixelMod,0,255);
 	green = _CLAMP_(green+pixelMod,0,255);
 	blue = _CLAMP_(blue+pixelMod,0,255);
@@ -797,30 +916,85 @@ static unsigned int modifyPixel(int red, int green, int blue, int x, int y, unsi
 }
 
  /*!***********************************************************************
- @Function		ETCTextureDecompress
- @Input			pSrcData The ETC texture data to decompress
- @Input			x X dimension of the texture
- @Input			y Y dimension of the texture
- @Modified		pDestData The decompressed texture data
- @Input			nMode The format of the data
- @Returns		The number of bytes of ETC data decompressed
- @Description	Decompresses ETC to RGBA 8888
+ @Function		getSubblockPalette
+ @Input			red		Red value of the subblock base colour
+ @Input			green	Green value of the subblock base colour
+ @Input			blue	Blue value of the subblock base colour
+ @Input			modTable	Modulation table of the subblock
+ @Modified		pPalette	The four possible pixel colours of the subblock
+ @Description	Every pixel in an ETC subblock is one of four colours, the base
+				colour shifted by one of the entries in its modulation table.
+				Resolving these once per subblock, instead of once per pixel,
+				produces identical pixels with a quarter of the clamping.
+				// patched for Cocos3D by Bill Hollings
+*************************************************************************/
+static void getSubblockPalette(int red, int green, int blue, int modTable, unsigned int pPalette[4])
+{
+	for(int i=0;i<4;i++)
+		pPalette[i] = modifyPixel(red,green,blue,mod[modTable][i]);
+}
+
+ /*!***********************************************************************
+ @Function		getPixelIndex
+ @Input			x	Pixel x position in block
+ @Input			y	Pixel y position in block
+ @Input			modBlock	Values for the current block
+ @Returns		Returns the index into the subblock palette of the pixel
+ @Description	Used by ETCTextureDecompress	// patched for Cocos3D by Bill Hollings
 *************************************************************************/
-static int ETCTextureDecompress(const void * const pSrcData, const int &x, const int &y, const void *pDestData,const int &/*nMode*/)
+static inline unsigned int getPixelIndex(int x, int y, unsigned int modBlock)
 {
-	unsigned int blockTop, blockBot, *input = (unsigned int*)pSrcData, *output;
+	int index = x*4+y;
+	unsigned int mostSig = modBlock<<1;
+
+	if (index<8)
+		return ((modBlock>>(index+24))&0x1)+((mostSig>>(index+8))&0x2);
+	else
+		return ((modBlock>>(index+8))&0x1)+((mostSig>>(index-8))&0x2);
+}
+
+struct ETCDecompressContext						// patched for Cocos3D by Bill Hollings
+{
+	const unsigned int*	pSrcData;
+	unsigned int*		pDestData;
+	int					x;
+	int					y;
+	bool				bSwapRB;
+};
+
+ /*!***********************************************************************
+ @Function		ETCTextureDecompressBand
+ @Modified		pContext	The ETCDecompressContext of the texture.
+ @Input			band		The index of the band of block rows to decompress.
+ @Description	Decompresses one band of PVRT_PARALLEL_DECOMPRESS_BAND_ROWS rows
+				of ETC blocks, optionally swapping the red and blue channels of
+				the decompressed pixels. ETC blocks are independent, so bands
+				can be decompressed concurrently.
+				// patched for Cocos3D by Bill Hollings
+*************************************************************************/
+static void ETCTextureDecompressBand(void* pContext, size_t band)
+{
+	const ETCDecompressContext& ctx = *(const ETCDecompressContext*)pContext;
+	const int x = ctx.x;
+	const int y = ctx.y;
+	unsigned int blockTop, blockBot, *output;
 	unsigned char red1, green1, blue1, red2, green2, blue2;
 	bool bFlip, bDiff;
 	int modtable1,modtable2;
+	unsigned int palette1[4], palette2[4];
 
-	for(int i=0;i<y;i+=4)
+	int rowStart = (int)band * PVRT_PARALLEL_DECOMPRESS_BAND_ROWS * 4;
+	int rowEnd = PVRT_MIN(rowStart + PVRT_PARALLEL_DECOMPRESS_BAND_ROWS * 4, y);
+	const unsigned int *input = ctx.pSrcData + (rowStart / 4) * ((x + 3) / 4) * 2;
+
+	for(int i=rowStart;i<rowEnd;i+=4)
 	{
 		for(int m=0;m<x;m+=4)
 		{
 				blockTop = *(input++);
 				blockBot = *(input++);
 
-			output = (unsigned int*)pDestData + i*x +m;
+			output = ctx.pDestData + i*x +m;
 
 			// check flipbit
 			bFlip = (blockTop & ETC_FLIP) != 0;
@@ -872,6 +1046,18 @@ static int ETCTextureDecompress(const void * const pSrcData, const int &x, const
 			modtable1 = (blockTop>>29)&0x7;
 			modtable2 = (blockTop>>26)&0x7;
 
+			// Swapping red and blue in the base colour swaps them in every pixel of the subblock.
+			if(ctx.bSwapRB)
+			{
+				getSubblockPalette(blue1,green1,red1,modtable1,palette1);
+				getSubblockPalette(blue2,green2,red2,modtable2,palette2);
+			}
+			else
+			{
+				getSubblockPalette(red1,green1,blue1,modtable1,palette1);
+				getSubblockPalette(red2,green2,blue2,modtable2,palette2);
+			}
+
 			if(!bFlip)
 			{	// 2 2x4 blocks side by side
 
@@ -879,8 +1065,8 @@ static int ETCTextureDecompress(const void * const pSrcData, const int &x, const
 				{
 					for(int k=0;k<2;k++)	// horizontal
 					{
-						*(output+j*x+k) = modifyPixel(red1,green1,blue1,k,j,blockBot,modtable1);
-						*(output+j*x+k+2) = modifyPixel(red2,green2,blue2,k+2,j,blockBot,modtable2);
+						*(output+j*x+k) = palette1[getPixelIndex(k,j,blockBot)];
+						*(output+j*x+k+2) = palette2[getPixelIndex(k+2,j,blockBot)];
 					}
 				}
 
@@ -891,13 +1077,41 @@ static int ETCTextureDecompress(const void * const pSrcData, const int &x, const
 				{
 					for(int k=0;k<4;k++)
 					{
-						*(output+j*x+k) = modifyPixel(red1,green1,blue1,k,j,blockBot,modtable1);
-						*(output+(j+2)*x+k) = modifyPixel(red2,green2,blue2,k,j+2,blockBot,modtable2);
+						*(output+j*x+k) = palette1[getPixelIndex(k,j,blockBot)];
+						*(output+(j+2)*x+k) = palette2[getPixelIndex(k,j+2,blockBot)];
 					}
 				}
 			}
 		}
 	}
+}
+
+ /*!***********************************************************************
+ @Function		ETCTextureDecompress
+ @Input			pSrcData The ETC texture data to decompress
+ @Input			x X dimension of the texture
+ @Input			y Y dimension of the texture
+ @Modified		pDestData The decompressed texture data
+ @Input			nMode The format of the data
+ @Input			bSwapRB Whether to swap the red and blue channels of the output
+ @Input			bAllowParallel Whether a large texture may be decompressed in parallel
+ @Returns		The number of bytes of ETC data decompressed
+ @Description	Decompresses ETC to RGBA 8888. Large textures are split into
+				bands of block rows that are decompressed in parallel.
+*************************************************************************/
+static int ETCTextureDecompress(const void * const pSrcData, const int &x, const int &y, const void *pDestData,const int &/*nMode*/, bool bSwapRB, bool bAllowParallel)
+{
+	ETCDecompressContext ctx;
+	ctx.pSrcData = (const unsigned int*)pSrcData;
+	ctx.pDestData = (unsigned int*)pDestData;
+	ctx.x = x;
+	ctx.y = y;
+	ctx.bSwapRB = bSwapRB;
+
+	int nBlockRows = (y + 3) / 4;
+	size_t nBandCount = (nBlockRows + PVRT_PARALLEL_DECOMPRESS_BAND_ROWS - 1) / PVRT_PARALLEL_DECOMPRESS_BAND_ROWS;
+	bool bParallel = bAllowParallel && (x * y) >= PVRT_PARALLEL_DECOMPRESS_MIN_PIXELS;
+	decompressBands(nBandCount, bParallel, ETCTextureDecompressBand, &ctx);
 
 	return x*y/2;
 }
@@ -909,6 +1123,7 @@ static int ETCTextureDecompress(const void * const pSrcData, const int &x, const
 @Input			y Y dimension of the texture
 @Modified		pDestData The decompressed texture data
 @Input			nMode The format of the data
+@Input			bAllowParallel Whether a large texture may be decompressed on several threads
 @Returns		The number of bytes of ETC data decompressed
 @Description	Decompresses ETC to RGBA 8888
 *************************************************************************/
@@ -916,14 +1131,15 @@ int PVRTDecompressETC(const void * const pSrcData,
 						 const unsigned int &x,
 						 const unsigned int &y,
 						 void *pDestData,
-						 const int &nMode)
+						 const int &nMode,
+						 const bool bAllowParallel)
 {
 	int i32read;
 
 	if(x<ETC_MIN_TEXWIDTH || y<ETC_MIN_TEXHEIGHT)
 	{	// decompress into a buffer big enough to take the minimum size
 		char* pTempBuffer =	(char*)malloc(PVRT_MAX(x,ETC_MIN_TEXWIDTH)*PVRT_MAX(y,ETC_MIN_TEXHEIGHT)*4);
-		i32read = ETCTextureDecompress(pSrcData,PVRT_MAX(x,ETC_MIN_TEXWIDTH),PVRT_MAX(y,ETC_MIN_TEXHEIGHT),pTempBuffer,nMode);
+		i32read = ETCTextureDecompress(pSrcData,PVRT_MAX(x,ETC_MIN_TEXWIDTH),PVRT_MAX(y,ETC_MIN_TEXHEIGHT),pTempBuffer,nMode,true,bAllowParallel);
 
 		for(unsigned int i=0;i<y;i++)
 		{	// copy from larger temp buffer to output data
@@ -933,19 +1149,9 @@ int PVRTDecompressETC(const void * const pSrcData,
 		if(pTempBuffer) free(pTempBuffer);
 	}
 	else	// decompress larger MIP levels straight into the output data
-		i32read = ETCTextureDecompress(pSrcData,x,y,pDestData,nMode);
-
-	// swap r and b channels
-	unsigned char* pSwap = (unsigned char*)pDestData, swap;
+		i32read = ETCTextureDecompress(pSrcData,x,y,pDestData,nMode,true,bAllowParallel);
 
-	for(unsigned int i=0;i<y;i++)
-		for(unsigned int j=0;j<x;j++)
-		{
-			swap = pSwap[0];
-			pSwap[0] = pSwap[2];
-			pSwap[2] = swap;
-			pSwap+=4;
-		}
+	// red and blue channels are swapped during decompression	// patched for Cocos3D by Bill Hollings
 
 	return i32read;
 }
@@ -16,13 +16,15 @@
  @param[in]		XDim            X dimension of the texture
  @param[in]		YDim            Y dimension of the texture
  @param[in,out]	pResultImage    The decompressed texture data
+ @param[in]		bAllowParallel  Whether a large texture may be decompressed on several threads
  @return		Returns the amount of data that was decompressed.
 *************************************************************************/
 int PVRTDecompressPVRTC(const void *pCompressedData,
 				const int Do2bitMode,
 				const int XDim,
 				const int YDim,
-				unsigned char* pResultImage);
+				unsigned char* pResultImage,
+				const bool bAllowParallel = true);		// patched for Cocos3D by Bill Hollings
 
 /*!***********************************************************************
  @brief      	Decompresses ETC to RGBA 8888
@@ -31,13 +33,15 @@ int PVRTDecompressPVRTC(const void *pCompressedData,
  @param[in]		y               Y dimension of the texture
  @param[in,out]	pDestData       The decompressed texture data
  @param[in]		nMode           The format of the data
+ @param[in]		bAllowParallel  Whether a large texture may be decompressed on several threads
  @return		The number of bytes of ETC data decompressed
 *************************************************************************/
 int PVRTDecompressETC(const void * const pSrcData,
 						 const unsigned int &x,
 						 const unsigned int &y,
 						 void *pDestData,
-						 const int &nMode);
+						 const int &nMode,
+						 const bool bAllowParallel = true);		// patched for Cocos3D by Bill Hollings
 
 
 #endif /* _PVRTDECOMPRESS_H_ */
@@ -185,6 +185,9 @@ struct SPVRTPODImpl
 
 	bool		bFromMemory;	/*!< Was the mesh data loaded from memory? */
 
+	CPVRTMappedFile	*pMappedFile;	/*!< File mapping referenced in place by mesh data. patched for Cocos3D by Bill Hollings */
+	CPVRTModelPODBakedAnimation	*pBakedAnimation;	/*!< Baked matrices of every frame. patched for Cocos3D by Bill Hollings */
+
 #ifdef _DEBUG
 	PVRTint64 nWmTotal, nWmCacheHit, nWmZeroCacheHit;
 	float	fHitPerc, fHitPercZero;
@@ -229,6 +232,23 @@ void SafeRealloc(T* &ptr, size_t cnt)
 	_ASSERT(ptr);
 }
 
+/*!***************************************************************************
+ @Function			FreeUnlessMapped
+ @Modified			ptr
+ @Input				pMappedFile
+ @Description		Frees a block of memory, unless it is referenced in place
+					within the specified file mapping.
+					patched for Cocos3D by Bill Hollings
+*****************************************************************************/
+template <typename T>
+void FreeUnlessMapped(T* &ptr, const CPVRTMappedFile * const pMappedFile)
+{
+	if(pMappedFile && pMappedFile->Contains(ptr))
+		ptr = 0;
+	else
+		FREE(ptr);
+}
+
 /****************************************************************************
 ** Class: CPODData
 ****************************************************************************/
@@ -270,6 +290,24 @@ public:
 	virtual bool Read(void* lpBuffer, const unsigned int dwNumberOfBytesToRead) = 0;
 	virtual bool Skip(const unsigned int nBytes) = 0;
 
+	/*!***************************************************************************
+	@Function			ReadInPlace
+	@Input				nBytes		The number of bytes to read
+	@Input				nAlign		The required alignment of the returned pointer
+	@Return				A pointer to the data within the source, or NULL
+	@Description		If the source content can be referenced in place, and the
+						next nBytes are suitably aligned, returns a pointer to them
+						and advances past them. Otherwise returns NULL without
+						advancing, and the caller must fall back to a copying read.
+						patched for Cocos3D by Bill Hollings
+	*****************************************************************************/
+	virtual const void* ReadInPlace(const unsigned int nBytes, const unsigned int nAlign)
+	{
+		PVRT_UNREFERENCED_PARAMETER(nBytes);
+		PVRT_UNREFERENCED_PARAMETER(nAlign);
+		return 0;
+	}
+
 	template <typename T>
 	bool Read(T &n)
 	{
@@ -373,14 +411,19 @@ class CSourceStream : public CSource
 {
 protected:
 	CPVRTResourceFile* m_pFile;
+	CPVRTMappedFile* m_pMappedFile;		// patched for Cocos3D by Bill Hollings
 	size_t m_BytesReadCount;
 
+	size_t Size() const { return m_pMappedFile ? m_pMappedFile->Size() : m_pFile->Size(); }
+	const char* DataPtr() const { return (const char*) (m_pMappedFile ? m_pMappedFile->DataPtr() : m_pFile->DataPtr()); }
+	void Close();
+
 public:
 	/*!***************************************************************************
 	@Function			CSourceStream
 	@Description		Constructor
 	*****************************************************************************/
-	CSourceStream() : m_pFile(0), m_BytesReadCount(0) {}
+	CSourceStream() : m_pFile(0), m_pMappedFile(0), m_BytesReadCount(0) {}
 
 	/*!***************************************************************************
 	@Function			~CSourceStream
@@ -390,9 +433,17 @@ public:
 
 	bool Init(const char * const pszFileName);
 	bool Init(const char * const pData, const size_t i32Size);
+	bool InitMapped(const char * const pszFileName);
+
+	/*!***************************************************************************
+	@Function			GetMappedFile
+	@Return				The file mapping in use, or NULL if not reading from a mapping
+	*****************************************************************************/
+	CPVRTMappedFile* GetMappedFile() const { return m_pMappedFile; }
 
 	virtual bool Read(void* lpBuffer, const unsigned int dwNumberOfBytesToRead);
 	virtual bool Skip(const unsigned int nBytes);
+	virtual const void* ReadInPlace(const unsigned int nBytes, const unsigned int nAlign);
 };
 
 /*!***************************************************************************
@@ -401,7 +452,25 @@ public:
 *****************************************************************************/
 CSourceStream::~CSourceStream()
 {
+	Close();
+}
+
+/*!***************************************************************************
+@Function			Close
+@Description		Releases the file or file mapping being read.
+*****************************************************************************/
+void CSourceStream::Close()
+{
+	m_BytesReadCount = 0;
+
 	delete m_pFile;
+	m_pFile = 0;
+
+	if (m_pMappedFile)
+	{
+		m_pMappedFile->Release();
+		m_pMappedFile = 0;
+	}
 }
 
 /*!***************************************************************************
@@ -412,12 +481,7 @@ CSourceStream::~CSourceStream()
 *****************************************************************************/
 bool CSourceStream::Init(const char * const pszFileName)
 {
-	m_BytesReadCount = 0;
-	if (m_pFile)
-	{
-		delete m_pFile;
-		m_pFile = 0;
-	}
+	Close();
 
 	if(!pszFileName)
 		return false;
@@ -441,8 +505,7 @@ bool CSourceStream::Init(const char * const pszFileName)
 *****************************************************************************/
 bool CSourceStream::Init(const char * pData, size_t i32Size)
 {
-	m_BytesReadCount = 0;
-	if (m_pFile) delete m_pFile;
+	Close();
 
 	m_pFile = new CPVRTResourceFile(pData, i32Size);
 	if (!m_pFile->IsOpen())
@@ -454,6 +517,27 @@ bool CSourceStream::Init(const char * pData, size_t i32Size)
 	return true;
 }
 
+/*!***************************************************************************
+@Function			InitMapped
+@Input				pszFileName		Source file
+@Description		Initialises the source stream by mapping the file at the
+					specified directory into memory. Vertex and index blocks
+					may then be referenced in place using ReadInPlace().
+					If the platform does not support file mapping, or the file
+					cannot be mapped, falls back to reading the file normally.
+					patched for Cocos3D by Bill Hollings
+*****************************************************************************/
+bool CSourceStream::InitMapped(const char * const pszFileName)
+{
+	Close();
+
+	m_pMappedFile = CPVRTMappedFile::Open(pszFileName);
+	if (m_pMappedFile)
+		return true;
+
+	return Init(pszFileName);
+}
+
 /*!***************************************************************************
 @Function			Read
 @Modified			lpBuffer				Buffer to write the data into
@@ -464,16 +548,36 @@ bool CSourceStream::Init(const char * pData, size_t i32Size)
 bool CSourceStream::Read(void* lpBuffer, const unsigned int dwNumberOfBytesToRead)
 {
 	_ASSERT(lpBuffer);
-	_ASSERT(m_pFile);
+	_ASSERT(m_pFile || m_pMappedFile);
 
-	if (m_BytesReadCount + dwNumberOfBytesToRead > m_pFile->Size()) return false;
+	if (m_BytesReadCount + dwNumberOfBytesToRead > Size()) return false;
 
-	memcpy(lpBuffer, &((char*) m_pFile->DataPtr())[m_BytesReadCount], dwNumberOfBytesToRead);
+	memcpy(lpBuffer, &DataPtr()[m_BytesReadCount], dwNumberOfBytesToRead);
 
 	m_BytesReadCount += dwNumberOfBytesToRead;
 	return true;
 }
 
+/*!***************************************************************************
+@Function			ReadInPlace
+@Input				nBytes		The number of bytes to read
+@Input				nAlign		The required alignment of the returned pointer
+@Return				A pointer to the data within the file mapping, or NULL
+@Description		Only a file mapping can be referenced in place, since it
+					outlives this stream when retained by the model.
+*****************************************************************************/
+const void* CSourceStream::ReadInPlace(const unsigned int nBytes, const unsigned int nAlign)
+{
+	if (!m_pMappedFile || !nBytes) return 0;
+	if (m_BytesReadCount + nBytes > Size()) return 0;
+
+	const char* pData = &DataPtr()[m_BytesReadCount];
+	if (nAlign > 1 && ((size_t) pData % nAlign) != 0) return 0;
+
+	m_BytesReadCount += nBytes;
+	return pData;
+}
+
 /*!***************************************************************************
 @Function			Skip
 @Input				nBytes			The number of bytes to skip
@@ -481,7 +585,7 @@ bool CSourceStream::Read(void* lpBuffer, const unsigned int dwNumberOfBytesToRea
 *****************************************************************************/
 bool CSourceStream::Skip(const unsigned int nBytes)
 {
-	if (m_BytesReadCount + nBytes > m_pFile->Size()) return false;
+	if (m_BytesReadCount + nBytes > Size()) return false;
 	m_BytesReadCount += nBytes;
 	return true;
 }
@@ -1168,6 +1272,18 @@ static bool ReadCPODData(
 		case ePODFileData:
 			if(bValidData)
 			{
+				// Reference the data in place if the source allows it and no byte swapping is needed.
+				// patched for Cocos3D by Bill Hollings
+				if(PVRTIsLittleEndian())
+				{
+					const void* pInPlace = src.ReadInPlace(nLen, PVRTModelPODDataTypeSize(s.eType));
+					if(pInPlace)
+					{
+						s.pData = (unsigned char*) pInPlace;
+						break;
+					}
+				}
+
 				switch(PVRTModelPODDataTypeSize(s.eType))
 				{
 					case 1: if(!src.ReadAfterAlloc(s.pData, nLen)) return false; break;
@@ -1474,7 +1590,20 @@ static bool ReadMesh(
 		case ePODFileMeshNumUVW:			if(!src.Read32(s.nNumUVW)) return false;	if(!SafeAlloc(s.psUVW, s.nNumUVW)) return false;	break;
 		case ePODFileMeshStripLength:		if(!src.ReadAfterAlloc32(s.pnStripLength, nLen)) return false;								break;
 		case ePODFileMeshNumStrips:			if(!src.Read32(s.nNumStrips)) return false;													break;
-		case ePODFileMeshInterleaved:		if(!src.ReadAfterAlloc(s.pInterleaved, nLen)) return false;									break;
+		case ePODFileMeshInterleaved:
+			// Reference interleaved data in place if the source allows it and no byte swapping
+			// is needed. All interleaved elements are at most 4 bytes. patched for Cocos3D by Bill Hollings
+			if(PVRTIsLittleEndian())
+			{
+				const void* pInPlace = src.ReadInPlace(nLen, 4);
+				if(pInPlace)
+				{
+					s.pInterleaved = (unsigned char*) pInPlace;
+					break;
+				}
+			}
+			if(!src.ReadAfterAlloc(s.pInterleaved, nLen)) return false;
+			break;
 		case ePODFileMeshBoneBatches:		if(!src.ReadAfterAlloc32(s.sBoneBatches.pnBatches, nLen)) return false;						break;
 		case ePODFileMeshBoneBatchBoneCnts:	if(!src.ReadAfterAlloc32(s.sBoneBatches.pnBatchBoneCnt, nLen)) return false;					break;
 		case ePODFileMeshBoneBatchOffsets:	if(!src.ReadAfterAlloc32(s.sBoneBatches.pnBatchOffset, nLen)) return false;					break;
@@ -1881,6 +2010,46 @@ EPVRTError CPVRTModelPOD::ReadFromFile(
 	return ReadFromSourceStream(this, src, pszExpOpt, count, pszHistory, historyCount);
 }
 
+/*!***************************************************************************
+ @Function			ReadFromFileMapped
+ @Input				pszFileName		Filename to load
+ @Return			PVR_SUCCESS if successful, PVR_FAIL if not
+ @Description		Loads the specified ".POD" file by mapping it into memory.
+					Where no byte swapping is needed, and the blocks are suitably
+					aligned, vertex and index data are referenced in place within
+					the mapping, instead of being copied to the heap. The mapping
+					is retained until this model is destroyed, and can be retained
+					beyond that by retrieving it with GetMappedFile(). If file
+					mapping is not supported, this behaves like ReadFromFile().
+					patched for Cocos3D by Bill Hollings
+*****************************************************************************/
+EPVRTError CPVRTModelPOD::ReadFromFileMapped(const char * const pszFileName)
+{
+	CSourceStream src;
+
+	if(!src.InitMapped(pszFileName))
+		return PVR_FAIL;
+
+	if(ReadFromSourceStream(this, src, NULL, 0, NULL, 0) != PVR_SUCCESS)
+		return PVR_FAIL;
+
+	m_pImpl->pMappedFile = src.GetMappedFile();
+	if(m_pImpl->pMappedFile)
+		m_pImpl->pMappedFile->Retain();
+
+	return PVR_SUCCESS;
+}
+
+/*!***************************************************************************
+ @Function			GetMappedFile
+ @Return			The file mapping referenced by the mesh data, or NULL
+ @Description		patched for Cocos3D by Bill Hollings
+*****************************************************************************/
+CPVRTMappedFile* CPVRTModelPOD::GetMappedFile() const
+{
+	return m_pImpl ? m_pImpl->pMappedFile : 0;
+}
+
 /*!***************************************************************************
  @Function			ReadFromMemory
  @Input				pData			Data to load
@@ -2065,6 +2234,13 @@ EPVRTError CPVRTModelPOD::ReadFromResource(
 *************************************************************************/
 EPVRTError CPVRTModelPOD::InitImpl()
 {
+	// Retain any file mapping referenced by the mesh data. patched for Cocos3D by Bill Hollings
+	CPVRTMappedFile* pMappedFile = m_pImpl ? m_pImpl->pMappedFile : 0;
+
+	// The node data may have changed, so any baked animation is stale. patched for Cocos3D by Bill Hollings
+	if(m_pImpl && m_pImpl->pBakedAnimation)
+		m_pImpl->pBakedAnimation->Release();
+
 	// Allocate space for implementation data
 	delete m_pImpl;
 	m_pImpl = new SPVRTPODImpl;
@@ -2073,6 +2249,7 @@ EPVRTError CPVRTModelPOD::InitImpl()
 
 	// Zero implementation data
 	memset(m_pImpl, 0, sizeof(*m_pImpl));
+	m_pImpl->pMappedFile = pMappedFile;
 
 #ifdef _DEBUG
 	m_pImpl->nWmTotal = 0;
@@ -2098,6 +2275,8 @@ void CPVRTModelPOD::DestroyImpl()
 		if(m_pImpl->pfCache)		delete [] m_pImpl->pfCache;
 		if(m_pImpl->pWmCache)		delete [] m_pImpl->pWmCache;
 		if(m_pImpl->pWmZeroCache)	delete [] m_pImpl->pWmZeroCache;
+		if(m_pImpl->pMappedFile)	m_pImpl->pMappedFile->Release();	// patched for Cocos3D by Bill Hollings
+		if(m_pImpl->pBakedAnimation)	m_pImpl->pBakedAnimation->Release();	// patched for Cocos3D by Bill Hollings
 
 		delete m_pImpl;
 		m_pImpl = 0;
@@ -2178,24 +2357,27 @@ void CPVRTModelPOD::Destroy()
 			}
 			FREE(pMaterial);
 
+			// Vertex and index data may be referenced in place within a file mapping.
+			// patched for Cocos3D by Bill Hollings
+			const CPVRTMappedFile* pMap = m_pImpl->pMappedFile;
 			for(i = 0; i < nNumMesh; ++i) {
-				FREE(pMesh[i].sFaces.pData);
+				FreeUnlessMapped(pMesh[i].sFaces.pData, pMap);
 				FREE(pMesh[i].pnStripLength);
 				if(pMesh[i].pInterleaved)
 				{
-					FREE(pMesh[i].pInterleaved);
+					FreeUnlessMapped(pMesh[i].pInterleaved, pMap);
 				}
 				else
 				{
-					FREE(pMesh[i].sVertex.pData);
-					FREE(pMesh[i].sNormals.pData);
-					FREE(pMesh[i].sTangents.pData);
-					FREE(pMesh[i].sBinormals.pData);
+					FreeUnlessMapped(pMesh[i].sVertex.pData, pMap);
+					FreeUnlessMapped(pMesh[i].sNormals.pData, pMap);
+					FreeUnlessMapped(pMesh[i].sTangents.pData, pMap);
+					FreeUnlessMapped(pMesh[i].sBinormals.pData, pMap);
 					for(unsigned int j = 0; j < pMesh[i].nNumUVW; ++j)
-						FREE(pMesh[i].psUVW[j].pData);
-					FREE(pMesh[i].sVtxColours.pData);
-					FREE(pMesh[i].sBoneIdx.pData);
-					FREE(pMesh[i].sBoneWeight.pData);
+						FreeUnlessMapped(pMesh[i].psUVW[j].pData, pMap);
+					FreeUnlessMapped(pMesh[i].sVtxColours.pData, pMap);
+					FreeUnlessMapped(pMesh[i].sBoneIdx.pData, pMap);
+					FreeUnlessMapped(pMesh[i].sBoneWeight.pData, pMap);
 				}
 				FREE(pMesh[i].psUVW);
 				pMesh[i].sBoneBatches.Release();
@@ -2232,45 +2414,78 @@ void CPVRTModelPOD::Destroy()
 	memset(this, 0, sizeof(*this));
 }
 
+/****************************************************************************
+** Local code: Animation
+****************************************************************************/
+
 /*!***************************************************************************
- @Function			SetFrame
+ @Function			PODGetFrameBlend
  @Input				fFrame			Frame number
- @Description		Set the animation frame for which subsequent Get*() calls
-					should return data.
+ @Input				nNumFrame		Number of frames of animation
+ @Output			nFrame0			Frame to blend from
+ @Output			nFrame1			Frame to blend to
+ @Output			fBlend			Fraction of the way from nFrame0 to nFrame1
+ @Description		Splits the frame number into the two keyframes to blend
+					between, clamping the frame number to the animation. At the
+					last frame, both keyframes are the last frame.
+					patched for Cocos3D by Bill Hollings
 *****************************************************************************/
-void CPVRTModelPOD::SetFrame(const VERTTYPE fFrame)
+static void PODGetFrameBlend(
+	VERTTYPE			fFrame,
+	const unsigned int	nNumFrame,
+	int					&nFrame0,
+	int					&nFrame1,
+	VERTTYPE			&fBlend)
 {
-	if(nNumFrame) {
-		/*
-			Limit animation frames.
-
-			Example: If there are 100 frames of animation, the highest frame
-			number allowed is 98, since that will blend between frames 98 and
-			99. (99 being of course the 100th frame.)
-		*/
-		_ASSERT(fFrame <= f2vt((float)(nNumFrame-1)));
-		m_pImpl->nFrame = (int)vt2f(fFrame);
-		m_pImpl->fBlend = fFrame - f2vt(m_pImpl->nFrame);
+	if(nNumFrame < 2 || fFrame <= 0)
+	{
+		nFrame0 = nFrame1 = 0;
+		fBlend = 0;
+		return;
 	}
-	else
+
+	if(fFrame >= f2vt((float)(nNumFrame-1)))
 	{
-		m_pImpl->fBlend = 0;
-		m_pImpl->nFrame = 0;
+		nFrame0 = nFrame1 = (int)nNumFrame - 1;
+		fBlend = 0;
+		return;
 	}
 
-	m_pImpl->fFrame = fFrame;
+	nFrame0 = (int)vt2f(fFrame);
+	nFrame1 = nFrame0 + 1;
+	fBlend = fFrame - f2vt(nFrame0);
 }
 
 /*!***************************************************************************
- @Function			GetRotationMatrix
+ @Function			PODGetNextFrame
+ @Input				nFrame			Frame number
+ @Input				nNumFrame		Number of frames of animation
+ @Return			The frame to blend to from nFrame
+ @Description		Returns the frame after nFrame, or nFrame itself if it is
+					the last frame, so that animation data is not read beyond
+					its end. patched for Cocos3D by Bill Hollings
+*****************************************************************************/
+static int PODGetNextFrame(const int nFrame, const unsigned int nNumFrame)
+{
+	return (nFrame + 1 < (int)nNumFrame) ? nFrame + 1 : nFrame;
+}
+
+/*!***************************************************************************
+ @Function			PODGetRotationMatrix
  @Output			mOut			Rotation matrix
  @Input				node			Node to get the rotation matrix from
- @Description		Generates the world matrix for the given Mesh Instance;
-					applies the parent's transform too. Uses animation data.
+ @Input				nFrame0			Frame to blend from
+ @Input				nFrame1			Frame to blend to
+ @Input				fBlend			Fraction of the way from nFrame0 to nFrame1
+ @Description		Generates the rotation matrix of the node, blended between
+					the two frames. patched for Cocos3D by Bill Hollings
 *****************************************************************************/
-void CPVRTModelPOD::GetRotationMatrix(
+static void PODGetRotationMatrix(
 	PVRTMATRIX		&mOut,
-	const SPODNode	&node) const
+	const SPODNode	&node,
+	const int		nFrame0,
+	const int		nFrame1,
+	const VERTTYPE	fBlend)
 {
 	PVRTQUATERNION	q;
 
@@ -2282,15 +2497,15 @@ void CPVRTModelPOD::GetRotationMatrix(
 			{
 				PVRTMatrixQuaternionSlerp(
 					q,
-					(PVRTQUATERNION&)node.pfAnimRotation[node.pnAnimRotationIdx[m_pImpl->nFrame]],
-					(PVRTQUATERNION&)node.pfAnimRotation[node.pnAnimRotationIdx[m_pImpl->nFrame+1]], m_pImpl->fBlend);
+					(PVRTQUATERNION&)node.pfAnimRotation[node.pnAnimRotationIdx[nFrame0]],
+					(PVRTQUATERNION&)node.pfAnimRotation[node.pnAnimRotationIdx[nFrame1]], fBlend);
 			}
 			else
 			{
 				PVRTMatrixQuaternionSlerp(
 					q,
-					(PVRTQUATERNION&)node.pfAnimRotation[4*m_pImpl->nFrame],
-					(PVRTQUATERNION&)node.pfAnimRotation[4*(m_pImpl->nFrame+1)], m_pImpl->fBlend);
+					(PVRTQUATERNION&)node.pfAnimRotation[4*nFrame0],
+					(PVRTQUATERNION&)node.pfAnimRotation[4*nFrame1], fBlend);
 			}
 
 			PVRTMatrixRotationQuaternion(mOut, q);
@@ -2307,29 +2522,21 @@ void CPVRTModelPOD::GetRotationMatrix(
 }
 
 /*!***************************************************************************
- @Function		GetRotationMatrix
- @Input			node			Node to get the rotation matrix from
- @Returns		Rotation matrix
- @Description	Generates the world matrix for the given Mesh Instance;
-				applies the parent's transform too. Uses animation data.
-*****************************************************************************/
-PVRTMat4 CPVRTModelPOD::GetRotationMatrix(const SPODNode &node) const
-{
-	PVRTMat4 mOut;
-	GetRotationMatrix(mOut,node);
-	return mOut;
-}
-
-/*!***************************************************************************
- @Function			GetScalingMatrix
+ @Function			PODGetScalingMatrix
  @Output			mOut			Scaling matrix
- @Input				node			Node to get the rotation matrix from
- @Description		Generates the world matrix for the given Mesh Instance;
-					applies the parent's transform too. Uses animation data.
+ @Input				node			Node to get the scaling matrix from
+ @Input				nFrame0			Frame to blend from
+ @Input				nFrame1			Frame to blend to
+ @Input				fBlend			Fraction of the way from nFrame0 to nFrame1
+ @Description		Generates the scaling matrix of the node, blended between
+					the two frames. patched for Cocos3D by Bill Hollings
 *****************************************************************************/
-void CPVRTModelPOD::GetScalingMatrix(
+static void PODGetScalingMatrix(
 	PVRTMATRIX		&mOut,
-	const SPODNode	&node) const
+	const SPODNode	&node,
+	const int		nFrame0,
+	const int		nFrame1,
+	const VERTTYPE	fBlend)
 {
 	PVRTVECTOR3 v;
 
@@ -2341,15 +2548,15 @@ void CPVRTModelPOD::GetScalingMatrix(
 			{
 				PVRTMatrixVec3Lerp(
 					v,
-					(PVRTVECTOR3&)node.pfAnimScale[node.pnAnimScaleIdx[m_pImpl->nFrame+0]],
-					(PVRTVECTOR3&)node.pfAnimScale[node.pnAnimScaleIdx[m_pImpl->nFrame+1]], m_pImpl->fBlend);
+					(PVRTVECTOR3&)node.pfAnimScale[node.pnAnimScaleIdx[nFrame0]],
+					(PVRTVECTOR3&)node.pfAnimScale[node.pnAnimScaleIdx[nFrame1]], fBlend);
 			}
 			else
 			{
 				PVRTMatrixVec3Lerp(
 					v,
-					(PVRTVECTOR3&)node.pfAnimScale[7*(m_pImpl->nFrame+0)],
-					(PVRTVECTOR3&)node.pfAnimScale[7*(m_pImpl->nFrame+1)], m_pImpl->fBlend);
+					(PVRTVECTOR3&)node.pfAnimScale[7*nFrame0],
+					(PVRTVECTOR3&)node.pfAnimScale[7*nFrame1], fBlend);
 			}
 
 			PVRTMatrixScaling(mOut, v.x, v.y, v.z);
@@ -2365,6 +2572,290 @@ void CPVRTModelPOD::GetScalingMatrix(
 	}
 }
 
+/*!***************************************************************************
+ @Function			PODGetTranslationMatrix
+ @Output			mOut			Translation matrix
+ @Input				node			Node to get the translation matrix from
+ @Input				nFrame0			Frame to blend from
+ @Input				nFrame1			Frame to blend to
+ @Input				fBlend			Fraction of the way from nFrame0 to nFrame1
+ @Description		Generates the translation matrix of the node, blended
+					between the two frames. patched for Cocos3D by Bill Hollings
+*****************************************************************************/
+static void PODGetTranslationMatrix(
+	PVRTMATRIX		&mOut,
+	const SPODNode	&node,
+	const int		nFrame0,
+	const int		nFrame1,
+	const VERTTYPE	fBlend)
+{
+	PVRTVECTOR3 v;
+
+	if(node.pfAnimPosition)
+	{
+		if(node.nAnimFlags & ePODHasPositionAni)
+		{
+			if(node.pnAnimPositionIdx)
+			{
+				PVRTMatrixVec3Lerp(v,
+					(PVRTVECTOR3&)node.pfAnimPosition[node.pnAnimPositionIdx[nFrame0]],
+					(PVRTVECTOR3&)node.pfAnimPosition[node.pnAnimPositionIdx[nFrame1]], fBlend);
+			}
+			else
+			{
+				PVRTMatrixVec3Lerp(v,
+					(PVRTVECTOR3&)node.pfAnimPosition[3*nFrame0],
+					(PVRTVECTOR3&)node.pfAnimPosition[3*nFrame1], fBlend);
+			}
+
+			PVRTMatrixTranslation(mOut, v.x, v.y, v.z);
+		}
+		else
+		{
+			PVRTMatrixTranslation(mOut, node.pfAnimPosition[0], node.pfAnimPosition[1], node.pfAnimPosition[2]);
+		}
+	}
+	else
+	{
+		PVRTMatrixIdentity(mOut);
+	}
+}
+
+/*!***************************************************************************
+ @Function			PODGetTransformationMatrix
+ @Output			mOut			Transformation matrix
+ @Input				node			Node to get the transformation matrix from
+ @Input				nFrame			Frame number
+ @Description		Retrieves the transformation matrix of the node at the
+					frame. patched for Cocos3D by Bill Hollings
+*****************************************************************************/
+static void PODGetTransformationMatrix(
+	PVRTMATRIX		&mOut,
+	const SPODNode	&node,
+	const int		nFrame)
+{
+	if(node.pfAnimMatrix)
+	{
+		if(node.nAnimFlags & ePODHasMatrixAni)
+		{
+			if(node.pnAnimMatrixIdx)
+				mOut = *((PVRTMATRIX*) &node.pfAnimMatrix[node.pnAnimMatrixIdx[nFrame]]);
+			else
+				mOut = *((PVRTMATRIX*) &node.pfAnimMatrix[16*nFrame]);
+		}
+		else
+		{
+			mOut = *((PVRTMATRIX*) node.pfAnimMatrix);
+		}
+	}
+	else
+	{
+		PVRTMatrixIdentity(mOut);
+	}
+}
+
+/*!***************************************************************************
+ @Function			PODGetLocalMatrix
+ @Output			mOut			Parent-relative matrix
+ @Input				node			Node to get the matrix from
+ @Input				nFrame0			Frame to blend from
+ @Input				nFrame1			Frame to blend to
+ @Input				fBlend			Fraction of the way from nFrame0 to nFrame1
+ @Description		Generates the matrix of the node relative to its parent.
+					patched for Cocos3D by Bill Hollings
+*****************************************************************************/
+static void PODGetLocalMatrix(
+	PVRTMATRIX		&mOut,
+	const SPODNode	&node,
+	const int		nFrame0,
+	const int		nFrame1,
+	const VERTTYPE	fBlend)
+{
+	PVRTMATRIX mTmp;
+
+	if(node.pfAnimMatrix) // The transformations are stored as matrices
+	{
+		PODGetTransformationMatrix(mOut, node, nFrame0);
+		return;
+	}
+
+	// Scale
+	PODGetScalingMatrix(mOut, node, nFrame0, nFrame1, fBlend);
+
+	// Rotation
+	PODGetRotationMatrix(mTmp, node, nFrame0, nFrame1, fBlend);
+	PVRTMatrixMultiply(mOut, mOut, mTmp);
+
+	// Translation
+	PODGetTranslationMatrix(mTmp, node, nFrame0, nFrame1, fBlend);
+	PVRTMatrixMultiply(mOut, mOut, mTmp);
+}
+
+/*!***************************************************************************
+ @Function			PODGetWorldMatrix
+ @Output			mOut			World matrix
+ @Input				pNode			All nodes of the scene
+ @Input				node			Node to get the world matrix from
+ @Input				nFrame0			Frame to blend from
+ @Input				nFrame1			Frame to blend to
+ @Input				fBlend			Fraction of the way from nFrame0 to nFrame1
+ @Description		Generates the world matrix of the node; applies the
+					parent's transform too. patched for Cocos3D by Bill Hollings
+*****************************************************************************/
+static void PODGetWorldMatrix(
+	PVRTMATRIX		&mOut,
+	const SPODNode	* const pNode,
+	const SPODNode	&node,
+	const int		nFrame0,
+	const int		nFrame1,
+	const VERTTYPE	fBlend)
+{
+	PVRTMATRIX mTmp;
+
+	PODGetLocalMatrix(mOut, node, nFrame0, nFrame1, fBlend);
+
+ 	// Do we have to worry about a parent?
+	if(node.nIdxParent < 0)
+		return;
+
+	// Apply parent's transform too.
+	PODGetWorldMatrix(mTmp, pNode, pNode[node.nIdxParent], nFrame0, nFrame1, fBlend);
+	PVRTMatrixMultiply(mOut, mOut, mTmp);
+}
+
+/*!***************************************************************************
+ @Function			PODBakeWorldMatrix
+ @Input				pNode			All nodes of the scene
+ @Input				nIdx			Index of the node to get the world matrix of
+ @Input				nFrame0			Frame to blend from
+ @Input				nFrame1			Frame to blend to
+ @Modified			pWm				World matrices evaluated so far at this frame
+ @Modified			pbDone			Which of pWm have been evaluated at this frame
+ @Return			The world matrix of the node
+ @Description		Generates the world matrix of the node, evaluating each
+					ancestor only once per frame. The result is identical to
+					that of PODGetWorldMatrix(). patched for Cocos3D by Bill Hollings
+*****************************************************************************/
+static const PVRTMATRIX& PODBakeWorldMatrix(
+	const SPODNode	* const pNode,
+	const int		nIdx,
+	const int		nFrame0,
+	const int		nFrame1,
+	PVRTMATRIX		* const pWm,
+	bool			* const pbDone)
+{
+	if(pbDone[nIdx])
+		return pWm[nIdx];
+
+	const SPODNode &node = pNode[nIdx];
+	PODGetLocalMatrix(pWm[nIdx], node, nFrame0, nFrame1, 0);
+	if(node.nIdxParent >= 0)
+	{
+		const PVRTMATRIX &mParent = PODBakeWorldMatrix(pNode, node.nIdxParent, nFrame0, nFrame1, pWm, pbDone);
+		PVRTMatrixMultiply(pWm[nIdx], pWm[nIdx], mParent);
+	}
+
+	pbDone[nIdx] = true;
+	return pWm[nIdx];
+}
+
+/*!***************************************************************************
+ @Function			PODIsNodeAnimated
+ @Input				pNode			All nodes of the scene
+ @Input				nIdx			Index of the node
+ @Input				bWithAncestors	Whether animated ancestors make the node animated
+ @Modified			pnState			Per node: zero if unresolved, 1 if static, 2 if animated
+ @Return			true if the node is animated
+ @Description		patched for Cocos3D by Bill Hollings
+*****************************************************************************/
+static bool PODIsNodeAnimated(
+	const SPODNode	* const pNode,
+	const int		nIdx,
+	const bool		bWithAncestors,
+	unsigned char	* const pnState)
+{
+	if(!pnState[nIdx])
+	{
+		const SPODNode &node = pNode[nIdx];
+		bool bAnimated = (node.nAnimFlags != 0);
+		if(!bAnimated && bWithAncestors && node.nIdxParent >= 0)
+			bAnimated = PODIsNodeAnimated(pNode, node.nIdxParent, bWithAncestors, pnState);
+		pnState[nIdx] = bAnimated ? 2 : 1;
+	}
+	return pnState[nIdx] == 2;
+}
+
+/*!***************************************************************************
+ @Function			SetFrame
+ @Input				fFrame			Frame number
+ @Description		Set the animation frame for which subsequent Get*() calls
+					should return data.
+*****************************************************************************/
+void CPVRTModelPOD::SetFrame(const VERTTYPE fFrame)
+{
+	if(nNumFrame) {
+		/*
+			Limit animation frames.
+
+			Example: If there are 100 frames of animation, the highest frame
+			number allowed is 98, since that will blend between frames 98 and
+			99. (99 being of course the 100th frame.)
+		*/
+		_ASSERT(fFrame <= f2vt((float)(nNumFrame-1)));
+		m_pImpl->nFrame = (int)vt2f(fFrame);
+		m_pImpl->fBlend = fFrame - f2vt(m_pImpl->nFrame);
+	}
+	else
+	{
+		m_pImpl->fBlend = 0;
+		m_pImpl->nFrame = 0;
+	}
+
+	m_pImpl->fFrame = fFrame;
+}
+
+/*!***************************************************************************
+ @Function			GetRotationMatrix
+ @Output			mOut			Rotation matrix
+ @Input				node			Node to get the rotation matrix from
+ @Description		Generates the world matrix for the given Mesh Instance;
+					applies the parent's transform too. Uses animation data.
+*****************************************************************************/
+void CPVRTModelPOD::GetRotationMatrix(
+	PVRTMATRIX		&mOut,
+	const SPODNode	&node) const
+{
+	PODGetRotationMatrix(mOut, node, m_pImpl->nFrame, PODGetNextFrame(m_pImpl->nFrame, nNumFrame), m_pImpl->fBlend);
+}
+
+/*!***************************************************************************
+ @Function		GetRotationMatrix
+ @Input			node			Node to get the rotation matrix from
+ @Returns		Rotation matrix
+ @Description	Generates the world matrix for the given Mesh Instance;
+				applies the parent's transform too. Uses animation data.
+*****************************************************************************/
+PVRTMat4 CPVRTModelPOD::GetRotationMatrix(const SPODNode &node) const
+{
+	PVRTMat4 mOut;
+	GetRotationMatrix(mOut,node);
+	return mOut;
+}
+
+/*!***************************************************************************
+ @Function			GetScalingMatrix
+ @Output			mOut			Scaling matrix
+ @Input				node			Node to get the rotation matrix from
+ @Description		Generates the world matrix for the given Mesh Instance;
+					applies the parent's transform too. Uses animation data.
+*****************************************************************************/
+void CPVRTModelPOD::GetScalingMatrix(
+	PVRTMATRIX		&mOut,
+	const SPODNode	&node) const
+{
+	PODGetScalingMatrix(mOut, node, m_pImpl->nFrame, PODGetNextFrame(m_pImpl->nFrame, nNumFrame), m_pImpl->fBlend);
+}
+
 /*!***************************************************************************
  @Function		GetScalingMatrix
  @Input			node			Node to get the rotation matrix from
@@ -2443,36 +2934,7 @@ void CPVRTModelPOD::GetTranslationMatrix(
 	PVRTMATRIX		&mOut,
 	const SPODNode	&node) const
 {
-	PVRTVECTOR3 v;
-
-	if(node.pfAnimPosition)
-	{
-		if(node.nAnimFlags & ePODHasPositionAni)
-		{
-			if(node.pnAnimPositionIdx)
-			{
-				PVRTMatrixVec3Lerp(v,
-					(PVRTVECTOR3&)node.pfAnimPosition[node.pnAnimPositionIdx[m_pImpl->nFrame+0]],
-					(PVRTVECTOR3&)node.pfAnimPosition[node.pnAnimPositionIdx[m_pImpl->nFrame+1]], m_pImpl->fBlend);
-			}
-			else
-			{
-				PVRTMatrixVec3Lerp(v,
-					(PVRTVECTOR3&)node.pfAnimPosition[3*(m_pImpl->nFrame+0)],
-					(PVRTVECTOR3&)node.pfAnimPosition[3*(m_pImpl->nFrame+1)], m_pImpl->fBlend);
-			}
-
-			PVRTMatrixTranslation(mOut, v.x, v.y, v.z);
-		}
-		else
-		{
-			PVRTMatrixTranslation(mOut, node.pfAnimPosition[0], node.pfAnimPosition[1], node.pfAnimPosition[2]);
-		}
-	}
-	else
-	{
-		PVRTMatrixIdentity(mOut);
-	}
+	PODGetTranslationMatrix(mOut, node, m_pImpl->nFrame, PODGetNextFrame(m_pImpl->nFrame, nNumFrame), m_pImpl->fBlend);
 }
 
 /*!***************************************************************************
@@ -2498,24 +2960,7 @@ PVRTMat4 CPVRTModelPOD::GetTranslationMatrix(const SPODNode &node) const
 *****************************************************************************/
 void CPVRTModelPOD::GetTransformationMatrix(PVRTMATRIX &mOut, const SPODNode &node) const
 {
-	if(node.pfAnimMatrix)
-	{
-		if(node.nAnimFlags & ePODHasMatrixAni)
-		{
-			if(node.pnAnimMatrixIdx)
-				mOut = *((PVRTMATRIX*) &node.pfAnimMatrix[node.pnAnimMatrixIdx[m_pImpl->nFrame]]);
-			else
-				mOut = *((PVRTMATRIX*) &node.pfAnimMatrix[16*m_pImpl->nFrame]);
-		}
-		else
-		{
-			mOut = *((PVRTMATRIX*) node.pfAnimMatrix);
-		}
-	}
-	else
-	{
-		PVRTMatrixIdentity(mOut);
-	}
+	PODGetTransformationMatrix(mOut, node, m_pImpl->nFrame);
 }
 /*!***************************************************************************
  @Function			GetWorldMatrixNoCache
@@ -2528,31 +2973,7 @@ void CPVRTModelPOD::GetWorldMatrixNoCache(
 	PVRTMATRIX		&mOut,
 	const SPODNode	&node) const
 {
-	PVRTMATRIX mTmp;
-
-    if(node.pfAnimMatrix) // The transformations are stored as matrices
-		GetTransformationMatrix(mOut, node);
-	else
-	{
-		// Scale
-		GetScalingMatrix(mOut, node);
-
-		// Rotation
-		GetRotationMatrix(mTmp, node);
-		PVRTMatrixMultiply(mOut, mOut, mTmp);
-
-		// Translation
-		GetTranslationMatrix(mTmp, node);
-		PVRTMatrixMultiply(mOut, mOut, mTmp);
-	}
-
- 	// Do we have to worry about a parent?
-	if(node.nIdxParent < 0)
-		return;
-
-	// Apply parent's transform too.
-	GetWorldMatrixNoCache(mTmp, pNode[node.nIdxParent]);
-	PVRTMatrixMultiply(mOut, mOut, mTmp);
+	PODGetWorldMatrix(mOut, pNode, node, m_pImpl->nFrame, PODGetNextFrame(m_pImpl->nFrame, nNumFrame), m_pImpl->fBlend);
 }
 
 /*!***************************************************************************
@@ -2632,6 +3053,143 @@ PVRTMat4 CPVRTModelPOD::GetWorldMatrix(const SPODNode& node) const
 	return mWorld;
 }
 
+/*!***************************************************************************
+ @Function			GetWorldMatrixAtFrame
+ @Output			mOut			World matrix
+ @Input				node			Node to get the world matrix from
+ @Input				fFrame			Frame number
+ @Description		Generates the world matrix for the given node at the given
+					frame, without using the current frame or matrix cache, so
+					that it may be invoked from several threads at once. Uses
+					the baked animation for whole frame numbers, if available.
+					patched for Cocos3D by Bill Hollings
+*****************************************************************************/
+void CPVRTModelPOD::GetWorldMatrixAtFrame(
+	PVRTMATRIX		&mOut,
+	const SPODNode	&node,
+	const VERTTYPE	fFrame) const
+{
+	int nFrame0, nFrame1;
+	VERTTYPE fBlend;
+
+	PODGetFrameBlend(fFrame, nNumFrame, nFrame0, nFrame1, fBlend);
+
+	CPVRTModelPODBakedAnimation* pBaked = m_pImpl ? m_pImpl->pBakedAnimation : 0;
+	if(pBaked && fBlend == 0)
+	{
+		pBaked->GetWorldMatrixAtFrame(mOut, (unsigned int)(&node - pNode), (unsigned int)nFrame0);
+		return;
+	}
+
+	PODGetWorldMatrix(mOut, pNode, node, nFrame0, nFrame1, fBlend);
+}
+
+/*!***************************************************************************
+ @Function			BakeAnimation
+ @Input				bWorldSpace		Whether to bake world or parent-relative matrices
+ @Return			PVR_SUCCESS if successful, PVR_FAIL if not
+ @Description		Evaluates the matrix of every node at every frame into a
+					baked animation table. Nodes whose matrix does not change
+					over the animation are stored only once. In world space, a
+					node changes if it, or any of its ancestors, is animated.
+					patched for Cocos3D by Bill Hollings
+*****************************************************************************/
+EPVRTError CPVRTModelPOD::BakeAnimation(const bool bWorldSpace)
+{
+	if(!m_pImpl)
+		return PVR_FAIL;
+
+	const unsigned int nNumBakedFrame = nNumFrame ? nNumFrame : 1;
+	CPVRTModelPODBakedAnimation* pBaked = new CPVRTModelPODBakedAnimation(nNumNode, nNumBakedFrame, bWorldSpace);
+	if(!pBaked)
+		return PVR_FAIL;
+
+	// Lay out the table, storing all frames only for nodes that change
+	unsigned char* pnState = new unsigned char[nNumNode];
+	memset(pnState, 0, nNumNode * sizeof(*pnState));
+
+	unsigned int nNumMatrix = 0;
+	for(unsigned int i = 0; i < nNumNode; ++i)
+	{
+		pBaked->m_pnParent[i] = pNode[i].nIdxParent;
+		pBaked->m_pnMatrixIdx[i] = nNumMatrix;
+		nNumMatrix += PODIsNodeAnimated(pNode, i, bWorldSpace, pnState) ? nNumBakedFrame : 1;
+	}
+	pBaked->m_pnMatrixIdx[nNumNode] = nNumMatrix;
+	pBaked->m_pMatrices = new PVRTMATRIX[nNumMatrix];
+	delete [] pnState;
+
+	// Evaluate each frame, visiting each node, and each ancestor, once per frame
+	PVRTMATRIX* pWm = new PVRTMATRIX[nNumNode];
+	bool* pbDone = new bool[nNumNode];
+
+	for(unsigned int nFrame = 0; nFrame < nNumBakedFrame; ++nFrame)
+	{
+		const int nFrame1 = PODGetNextFrame((int)nFrame, nNumBakedFrame);
+		memset(pbDone, 0, nNumNode * sizeof(*pbDone));
+
+		for(unsigned int i = 0; i < nNumNode; ++i)
+		{
+			const unsigned int nIdx = pBaked->m_pnMatrixIdx[i];
+			const bool bAnimated = pBaked->m_pnMatrixIdx[i + 1] - nIdx > 1;
+			if(nFrame && !bAnimated)
+				continue;
+
+			PVRTMATRIX &mOut = pBaked->m_pMatrices[nIdx + (bAnimated ? nFrame : 0)];
+			if(bWorldSpace)
+				mOut = PODBakeWorldMatrix(pNode, i, nFrame, nFrame1, pWm, pbDone);
+			else
+				PODGetLocalMatrix(mOut, pNode[i], nFrame, nFrame1, 0);
+		}
+	}
+
+	delete [] pWm;
+	delete [] pbDone;
+
+	if(m_pImpl->pBakedAnimation)
+		m_pImpl->pBakedAnimation->Release();
+	m_pImpl->pBakedAnimation = pBaked;
+
+	return PVR_SUCCESS;
+}
+
+/*!***************************************************************************
+ @Function			GetBakedAnimation
+ @Return			The baked animation table, or NULL
+ @Description		patched for Cocos3D by Bill Hollings
+*****************************************************************************/
+CPVRTModelPODBakedAnimation* CPVRTModelPOD::GetBakedAnimation() const
+{
+	return m_pImpl ? m_pImpl->pBakedAnimation : 0;
+}
+
+/*!***************************************************************************
+ @Function			SetBakedAnimation
+ @Input				pBaked			The baked animation table to use, or NULL
+ @Return			PVR_SUCCESS if successful, PVR_FAIL if not
+ @Description		Uses a table baked by another model loaded from the same
+					file. patched for Cocos3D by Bill Hollings
+*****************************************************************************/
+EPVRTError CPVRTModelPOD::SetBakedAnimation(CPVRTModelPODBakedAnimation* pBaked)
+{
+	if(!m_pImpl)
+		return PVR_FAIL;
+
+	if(pBaked)
+	{
+		if(pBaked->GetNumNodes() != nNumNode || pBaked->GetNumFrames() != (nNumFrame ? nNumFrame : 1))
+			return PVR_FAIL;
+
+		pBaked->Retain();
+	}
+
+	if(m_pImpl->pBakedAnimation)
+		m_pImpl->pBakedAnimation->Release();
+	m_pImpl->pBakedAnimation = pBaked;
+
+	return PVR_SUCCESS;
+}
+
 /*!***************************************************************************
  @Function			GetBoneWorldMatrix
  @Output			mOut			Bone world matrix
@@ -4590,6 +5148,120 @@ EPVRTError PVRTModelPODMergeMaterials(const CPVRTModelPOD &src, CPVRTModelPOD &d
 	return PVR_SUCCESS;
 }
 
+/****************************************************************************
+** class CPVRTModelPODBakedAnimation			// patched for Cocos3D by Bill Hollings
+****************************************************************************/
+
+/*!***************************************************************************
+@Function			CPVRTModelPODBakedAnimation
+@Input				nNumNode		Number of nodes
+@Input				nNumFrame		Number of frames held for each animated node
+@Input				bWorldSpace		Whether the matrices are world matrices
+@Description		Constructor. The matrices are allocated and filled by
+					CPVRTModelPOD::BakeAnimation().
+*****************************************************************************/
+CPVRTModelPODBakedAnimation::CPVRTModelPODBakedAnimation(const unsigned int nNumNode, const unsigned int nNumFrame, const bool bWorldSpace) :
+	m_nNumNode(nNumNode),
+	m_nNumFrame(nNumFrame),
+	m_bWorldSpace(bWorldSpace),
+	m_pnParent(new int[nNumNode]),
+	m_pnMatrixIdx(new unsigned int[nNumNode + 1]),
+	m_pMatrices(0),
+	m_i32RefCount(1)
+{
+}
+
+/*!***************************************************************************
+@Function			~CPVRTModelPODBakedAnimation
+@Description		Destructor
+*****************************************************************************/
+CPVRTModelPODBakedAnimation::~CPVRTModelPODBakedAnimation()
+{
+	delete [] m_pnParent;
+	delete [] m_pnMatrixIdx;
+	delete [] m_pMatrices;
+}
+
+/*!***************************************************************************
+@Function			Retain
+@Description		Increments the reference count.
+*****************************************************************************/
+void CPVRTModelPODBakedAnimation::Retain()
+{
+#if defined(__GNUC__)
+	__sync_add_and_fetch(&m_i32RefCount, 1);
+#else
+	++m_i32RefCount;
+#endif
+}
+
+/*!***************************************************************************
+@Function			Release
+@Description		Decrements the reference count, and deletes this instance
+					when it reaches zero.
+*****************************************************************************/
+void CPVRTModelPODBakedAnimation::Release()
+{
+#if defined(__GNUC__)
+	if(__sync_sub_and_fetch(&m_i32RefCount, 1) == 0)
+#else
+	if(--m_i32RefCount == 0)
+#endif
+		delete this;
+}
+
+/*!***************************************************************************
+@Function			GetSize
+@Return				The number of bytes of memory occupied by this table
+*****************************************************************************/
+size_t CPVRTModelPODBakedAnimation::GetSize() const
+{
+	return sizeof(*this) +
+		m_nNumNode * sizeof(*m_pnParent) +
+		(m_nNumNode + 1) * sizeof(*m_pnMatrixIdx) +
+		m_pnMatrixIdx[m_nNumNode] * sizeof(*m_pMatrices);
+}
+
+/*!***************************************************************************
+@Function			GetMatrixAtFrame
+@Input				nNode			Node index
+@Input				nFrame			Frame number
+@Return				The baked matrix of the node at the frame
+@Description		Frames beyond the last are clamped to the last frame. Nodes
+					that do not change hold a single matrix for all frames.
+*****************************************************************************/
+const PVRTMATRIX& CPVRTModelPODBakedAnimation::GetMatrixAtFrame(const unsigned int nNode, const unsigned int nFrame) const
+{
+	_ASSERT(nNode < m_nNumNode);
+	const unsigned int nIdx = m_pnMatrixIdx[nNode];
+	const unsigned int nLast = m_pnMatrixIdx[nNode + 1] - nIdx - 1;
+	return m_pMatrices[nIdx + PVRT_MIN(nFrame, nLast)];
+}
+
+/*!***************************************************************************
+@Function			GetWorldMatrixAtFrame
+@Output				mOut			World matrix
+@Input				nNode			Node index
+@Input				nFrame			Frame number
+@Description		Retrieves the world matrix of the node at the frame,
+					applying the parent's transform to parent-relative matrices.
+*****************************************************************************/
+void CPVRTModelPODBakedAnimation::GetWorldMatrixAtFrame(PVRTMATRIX &mOut, const unsigned int nNode, const unsigned int nFrame) const
+{
+	const PVRTMATRIX &mNode = GetMatrixAtFrame(nNode, nFrame);
+	const int nIdxParent = m_pnParent[nNode];
+
+	if(m_bWorldSpace || nIdxParent < 0)
+	{
+		mOut = mNode;
+		return;
+	}
+
+	PVRTMATRIX mParent;
+	GetWorldMatrixAtFrame(mParent, (unsigned int)nIdxParent, nFrame);
+	PVRTMatrixMultiply(mOut, mNode, mParent);
+}
+
 /*****************************************************************************
  End of file (PVRTModelPOD.cpp)
 *****************************************************************************/
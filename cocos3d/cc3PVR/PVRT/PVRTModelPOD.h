@@ -299,6 +299,104 @@ struct SPODScene {
 };
 
 struct SPVRTPODImpl;	// Internal implementation data
+class CPVRTMappedFile;	// File mapping. patched for Cocos3D by Bill Hollings
+
+/*!***************************************************************************
+ @class CPVRTModelPODBakedAnimation
+ @brief Reference-counted, immutable table of node matrices, precomputed for
+		every frame of animation of a CPVRTModelPOD.
+ @details	Created by CPVRTModelPOD::BakeAnimation(). Depending on how it was
+			baked, the table holds either the world matrix, or the parent-relative
+			(local) matrix, of each node. Nodes whose matrix does not change over
+			the animation store a single matrix, and animated nodes store one
+			matrix per frame. Since the table is never modified once baked, all
+			accessors are stateless and may be invoked from any thread, and the
+			table may be shared by any number of models loaded from the same file.
+			patched for Cocos3D by Bill Hollings
+*****************************************************************************/
+class CPVRTModelPODBakedAnimation
+{
+public:
+	/*!***************************************************************************
+	@fn       			Retain
+	@brief      		Increments the reference count. Thread-safe.
+	*****************************************************************************/
+	void Retain();
+
+	/*!***************************************************************************
+	@fn       			Release
+	@brief      		Decrements the reference count, and deletes this instance
+						when it reaches zero. Thread-safe.
+	*****************************************************************************/
+	void Release();
+
+	/*!***************************************************************************
+	@fn       			GetNumFrames
+	@return 			The number of frames held for each animated node
+	*****************************************************************************/
+	unsigned int GetNumFrames() const { return m_nNumFrame; }
+
+	/*!***************************************************************************
+	@fn       			GetNumNodes
+	@return 			The number of nodes held in this table
+	*****************************************************************************/
+	unsigned int GetNumNodes() const { return m_nNumNode; }
+
+	/*!***************************************************************************
+	@fn       			IsWorldSpace
+	@return 			true if this table holds world matrices, or false if it
+						holds parent-relative matrices
+	*****************************************************************************/
+	bool IsWorldSpace() const { return m_bWorldSpace; }
+
+	/*!***************************************************************************
+	@fn       			IsNodeAnimated
+	@param[in]			nNode		Node index
+	@return 			true if the matrix of the node changes across frames
+	*****************************************************************************/
+	bool IsNodeAnimated(const unsigned int nNode) const { return m_pnMatrixIdx[nNode + 1] - m_pnMatrixIdx[nNode] > 1; }
+
+	/*!***************************************************************************
+	@fn       			GetSize
+	@return 			The number of bytes of memory occupied by this table
+	*****************************************************************************/
+	size_t GetSize() const;
+
+	/*!***************************************************************************
+	@fn       			GetMatrixAtFrame
+	@param[in]			nNode		Node index
+	@param[in]			nFrame		Frame number, clamped to the last frame
+	@return 			The baked matrix of the node at the frame. This is a world
+						matrix if IsWorldSpace() returns true, or a parent-relative
+						matrix otherwise.
+	*****************************************************************************/
+	const PVRTMATRIX& GetMatrixAtFrame(const unsigned int nNode, const unsigned int nFrame) const;
+
+	/*!***************************************************************************
+	@fn       			GetWorldMatrixAtFrame
+	@param[out]			mOut		World matrix
+	@param[in]			nNode		Node index
+	@param[in]			nFrame		Frame number, clamped to the last frame
+	@brief      		Retrieves the world matrix of the node at the frame. If this
+						table holds parent-relative matrices, the world matrix is
+						composed from the matrices of the node and its ancestors.
+	*****************************************************************************/
+	void GetWorldMatrixAtFrame(PVRTMATRIX &mOut, const unsigned int nNode, const unsigned int nFrame) const;
+
+protected:
+	CPVRTModelPODBakedAnimation(const unsigned int nNumNode, const unsigned int nNumFrame, const bool bWorldSpace);
+	~CPVRTModelPODBakedAnimation();
+
+	unsigned int	m_nNumNode;		/*!< Number of nodes */
+	unsigned int	m_nNumFrame;	/*!< Number of frames held for each animated node */
+	bool			m_bWorldSpace;	/*!< Whether the matrices are world or parent-relative matrices */
+	int				*m_pnParent;	/*!< Parent index of each node, used to compose parent-relative matrices */
+	unsigned int	*m_pnMatrixIdx;	/*!< Index of the first matrix of each node, with a trailing total count */
+	PVRTMATRIX		*m_pMatrices;	/*!< The baked matrices */
+	volatile int	m_i32RefCount;
+
+	friend class CPVRTModelPOD;
+};
 
 /*!***************************************************************************
 @class CPVRTModelPOD
@@ -339,6 +437,35 @@ public:
 		char			* const pszHistory = NULL,
 		const size_t	historyCount = 0);
 
+	/*!***************************************************************************
+	@fn       			ReadFromFileMapped
+	@param[in]			pszFileName		Filename to load
+	@return			    PVR_SUCCESS if successful, PVR_FAIL if not
+	@brief     		    Loads the specified ".POD" file by mapping it into memory.
+						Where no byte swapping is needed, and the blocks are suitably
+						aligned, vertex and index data are referenced in place within
+						the mapping instead of being copied to the heap, so the file
+						content is not held twice while loading. The mapping is
+						released when this model is destroyed. Since mesh data may
+						reside within the mapping, the standalone mesh conversion
+						functions (PVRTModelPODScaleAndConvertVtxData,
+						PVRTModelPODToggleInterleaved, PVRTModelPODToggleStrips, etc.)
+						must not be used on a model loaded this way. If file mapping
+						is not supported on the platform, behaves like ReadFromFile.
+						patched for Cocos3D by Bill Hollings
+	*****************************************************************************/
+	EPVRTError ReadFromFileMapped(const char * const pszFileName);
+
+	/*!***************************************************************************
+	@fn       			GetMappedFile
+	@return			    The file mapping referenced in place by the mesh data, or NULL
+						if this model was not loaded using ReadFromFileMapped, or the
+						file could not be mapped. To reference mesh data after this
+						model has been destroyed, retain the returned mapping.
+						patched for Cocos3D by Bill Hollings
+	*****************************************************************************/
+	CPVRTMappedFile* GetMappedFile() const;
+
 	/*!***************************************************************************
 	@brief     		    Loads the supplied pod data. This data can be exported
 						directly to a header using one of the pod exporters.
@@ -560,6 +687,63 @@ public:
 	*****************************************************************************/
 	PVRTMat4 GetWorldMatrix(const SPODNode& node) const;
 
+	/*!***************************************************************************
+	 @fn       		GetWorldMatrixAtFrame
+	 @param[out]	mOut			World matrix
+	 @param[in]		node			Node to get the world matrix from
+	 @param[in]		fFrame			Frame number
+	 @brief     	Generates the world matrix for the given node at the given
+					frame, independently of the frame set by SetFrame(). This
+					does not use or modify the matrix cache, and may be invoked
+					from several threads at once. The matrix is retrieved from
+					the baked animation for whole frame numbers, if a table has
+					been baked or set on this model, and is generated from the
+					animation data otherwise.
+					patched for Cocos3D by Bill Hollings
+	*****************************************************************************/
+	void GetWorldMatrixAtFrame(
+		PVRTMATRIX		&mOut,
+		const SPODNode	&node,
+		const VERTTYPE	fFrame) const;
+
+	/*!***************************************************************************
+	 @fn       		BakeAnimation
+	 @param[in]		bWorldSpace		Whether to bake world matrices (the default),
+									or parent-relative matrices
+	 @return		PVR_SUCCESS if successful, PVR_FAIL if not
+	 @brief     	Evaluates the matrix of every node, at every frame, into a
+					CPVRTModelPODBakedAnimation table, which is then used by
+					GetWorldMatrixAtFrame(). The table is retained until this
+					model is destroyed, and can be retained beyond that, or
+					shared with other models, by retrieving it with
+					GetBakedAnimation(). Parent-relative tables are smaller
+					when only a few nodes of a deep hierarchy are animated,
+					at the cost of composing the world matrix on each access.
+					patched for Cocos3D by Bill Hollings
+	*****************************************************************************/
+	EPVRTError BakeAnimation(const bool bWorldSpace = true);
+
+	/*!***************************************************************************
+	 @fn       		GetBakedAnimation
+	 @return		The baked animation table used by this model, or NULL if
+					none has been baked or set.
+					patched for Cocos3D by Bill Hollings
+	*****************************************************************************/
+	CPVRTModelPODBakedAnimation* GetBakedAnimation() const;
+
+	/*!***************************************************************************
+	 @fn       		SetBakedAnimation
+	 @param[in]		pBaked			A table baked from a model loaded from the same
+									file, or NULL to stop using a baked table
+	 @return		PVR_SUCCESS if successful, PVR_FAIL if the table does not
+					match the nodes and frames of this model
+	 @brief     	Uses an existing baked animation table, instead of baking
+					another. The table is retained until this model is
+					destroyed, or another table is set.
+					patched for Cocos3D by Bill Hollings
+	*****************************************************************************/
+	EPVRTError SetBakedAnimation(CPVRTModelPODBakedAnimation* pBaked);
+
 	/*!***************************************************************************
 	 @brief     	Generates the world matrix for the given bone.
 	 @param[out]	mOut			Bone world matrix
@@ -61,9 +61,10 @@ const char* c_ppszWraps[eWrap_Size] =
 #define NEWLINE_TOKENS "\r\n"
 #define DELIM_TOKENS " \t"
 
-#define DEFAULT_EFFECT_NUM_TEX		100
-#define DEFAULT_EFFECT_NUM_UNIFORM	100
-#define DEFAULT_EFFECT_NUM_ATTRIB	100
+// Initial capacities only. Each effect preallocates these, and the arrays grow on demand.	// patched for Cocos3D by Bill Hollings
+#define DEFAULT_EFFECT_NUM_TEX		8
+#define DEFAULT_EFFECT_NUM_UNIFORM	16
+#define DEFAULT_EFFECT_NUM_ATTRIB	8
 
 /****************************************************************************
 ** Data tables
@@ -75,22 +76,34 @@ const char* c_ppszWraps[eWrap_Size] =
 class CPVRTPFXParserReadContext
 {
 public:
+	char			*pszScript;			// Single copy of the script. Lines point into it.	// patched for Cocos3D by Bill Hollings
 	char			**ppszEffectFile;
 	int				*pnFileLineNumber;
 	unsigned int	nNumLines, nMaxLines;
 
 public:
-	CPVRTPFXParserReadContext();
+	CPVRTPFXParserReadContext(const char* pszSource);
 	~CPVRTPFXParserReadContext();
 };
 
 /*!***************************************************************************
  @Function			CPVRTPFXParserReadContext
- @Description		Initialises values.
+ @Input				pszSource		PFX script
+ @Description		Copies the script into a single buffer and sizes the line
+					tables to the number of lines it contains.
+					(patched for Cocos3D by Bill Hollings)
 *****************************************************************************/
-CPVRTPFXParserReadContext::CPVRTPFXParserReadContext()
+CPVRTPFXParserReadContext::CPVRTPFXParserReadContext(const char* pszSource)
 {
-	nMaxLines = 5000;
+	size_t nLen = strlen(pszSource);
+	pszScript = new char[nLen + 1];
+	memcpy(pszScript, pszSource, nLen + 1);
+
+	// Every newline starts a new line, and there is always at least one.
+	nMaxLines = 1;
+	for(const char* pszCurr = pszScript; (pszCurr = strchr(pszCurr, '\n')) != NULL; pszCurr++)
+		nMaxLines++;
+
 	nNumLines = 0;
 	ppszEffectFile		= new char*[nMaxLines];
 	pnFileLineNumber	= new int[nMaxLines];
@@ -102,11 +115,7 @@ CPVRTPFXParserReadContext::CPVRTPFXParserReadContext()
 *****************************************************************************/
 CPVRTPFXParserReadContext::~CPVRTPFXParserReadContext()
 {
-	// free effect file
-	for(unsigned int i = 0; i < nNumLines; i++)
-	{
-		FREE(ppszEffectFile[i]);
-	}
+	delete [] pszScript;		// Lines point into the script copy.	// patched for Cocos3D by Bill Hollings
 	delete [] ppszEffectFile;
 	delete [] pnFileLineNumber;
 }
@@ -492,6 +501,97 @@ void SPVRTPFXParserSemantic::Copy(const SPVRTPFXParserSemantic& rhs)
 /****************************************************************************
 ** CPVRTPFXParser Class
 ****************************************************************************/
+/****************************************************************************
+** CPVRTPFXParserNameIndex Class	(patched for Cocos3D by Bill Hollings)
+****************************************************************************/
+
+/*!***************************************************************************
+ @Function			CPVRTPFXParserNameIndex
+ @Description		Sets initial values.
+*****************************************************************************/
+CPVRTPFXParserNameIndex::CPVRTPFXParserNameIndex() : m_uiCount(0)
+{
+}
+
+/*!***************************************************************************
+ @Function			Rehash
+ @Input				uiSlotCount		New number of slots. Must be a power of two.
+ @Description		Reinserts all entries into a table of the given size.
+*****************************************************************************/
+void CPVRTPFXParserNameIndex::Rehash(unsigned int uiSlotCount)
+{
+	CPVRTArray<SSlot> aOldSlots(m_aSlots);
+
+	m_aSlots.Clear();
+	m_aSlots.Resize(uiSlotCount);
+	for(unsigned int i = 0; i < uiSlotCount; ++i)
+		m_aSlots[i].iIndex = -1;
+
+	unsigned int uiMask = uiSlotCount - 1;
+	for(unsigned int i = 0; i < aOldSlots.GetSize(); ++i)
+	{
+		if(aOldSlots[i].iIndex < 0)
+			continue;
+
+		unsigned int uiSlot = aOldSlots[i].uiHash & uiMask;
+		while(m_aSlots[uiSlot].iIndex >= 0)
+			uiSlot = (uiSlot + 1) & uiMask;
+		m_aSlots[uiSlot] = aOldSlots[i];
+	}
+}
+
+/*!***************************************************************************
+ @Function			Add
+ @Input				Hash		The hash of the entry name.
+ @Input				uiIndex		The index of the entry in its owning array.
+ @Description		Adds the given entry index under the given name hash. If the
+					name was already added, the earlier entry is kept.
+*****************************************************************************/
+void CPVRTPFXParserNameIndex::Add(const CPVRTHash& Hash, unsigned int uiIndex)
+{
+	// Keep the load factor at or below one half
+	if((m_uiCount + 1) * 2 > m_aSlots.GetSize())
+		Rehash(m_aSlots.GetSize() ? m_aSlots.GetSize() * 2 : 16);
+
+	unsigned int uiHash = Hash;
+	unsigned int uiMask = m_aSlots.GetSize() - 1;
+	unsigned int uiSlot = uiHash & uiMask;
+	while(m_aSlots[uiSlot].iIndex >= 0)
+	{
+		if(m_aSlots[uiSlot].uiHash == uiHash)
+			return;
+		uiSlot = (uiSlot + 1) & uiMask;
+	}
+
+	m_aSlots[uiSlot].uiHash = uiHash;
+	m_aSlots[uiSlot].iIndex = (int)uiIndex;
+	m_uiCount++;
+}
+
+/*!***************************************************************************
+ @Function			Find
+ @Input				Hash		The hash of the entry name.
+ @Return			int			The entry index, or -1 if not found.
+ @Description		Returns the index of the first entry added under the given
+					name hash.
+*****************************************************************************/
+int CPVRTPFXParserNameIndex::Find(const CPVRTHash& Hash) const
+{
+	if(m_aSlots.GetSize() == 0)
+		return -1;
+
+	unsigned int uiHash = Hash;
+	unsigned int uiMask = m_aSlots.GetSize() - 1;
+	unsigned int uiSlot = uiHash & uiMask;
+	while(m_aSlots[uiSlot].iIndex >= 0)
+	{
+		if(m_aSlots[uiSlot].uiHash == uiHash)
+			return m_aSlots[uiSlot].iIndex;
+		uiSlot = (uiSlot + 1) & uiMask;
+	}
+	return -1;
+}
+
 /*!***************************************************************************
  @Function			CPVRTPFXParser
  @Description		Sets initial values.
@@ -548,7 +648,27 @@ bool CPVRTPFXParser::Parse(CPVRTString * const pReturnError)
 
 	int nEndLine = 0;
 	int nHeaderCounter = 0, nTexturesCounter = 0;
-	unsigned int i,j,k;
+	unsigned int i,j;
+
+	// Size the block arrays up front, so that appending each parsed block does not
+	// repeatedly reallocate and copy all of the blocks parsed before it.	// patched for Cocos3D by Bill Hollings
+	unsigned int nNumEffects = 0, nNumVertexShaders = 0, nNumFragmentShaders = 0;
+	for(unsigned int nLine = 0; nLine < m_psContext->nNumLines; nLine++)
+	{
+		const char* pszLine = m_psContext->ppszEffectFile[nLine];
+		if(pszLine[0] != '[')
+			continue;
+
+		if(strcmp(pszLine, "[EFFECT]") == 0)
+			nNumEffects++;
+		else if(strcmp(pszLine, "[VERTEXSHADER]") == 0)
+			nNumVertexShaders++;
+		else if(strcmp(pszLine, "[FRAGMENTSHADER]") == 0)
+			nNumFragmentShaders++;
+	}
+	m_psEffect.SetCapacity(m_psEffect.GetSize() + nNumEffects);
+	m_psVertexShader.SetCapacity(m_psVertexShader.GetSize() + nNumVertexShaders);
+	m_psFragmentShader.SetCapacity(m_psFragmentShader.GetSize() + nNumFragmentShaders);
 
 	// Loop through the file
 	for(unsigned int nLine=0; nLine < m_psContext->nNumLines; nLine++)
@@ -634,7 +754,7 @@ bool CPVRTPFXParser::Parse(CPVRTString * const pReturnError)
 			{
 				SPVRTPFXParserShader VertexShader;
 				if(ParseShader(nLine, nEndLine, pReturnError, VertexShader, "VERTEXSHADER"))
-					m_psVertexShader.Append(VertexShader);
+					m_VertexShaderIndex.Add(VertexShader.Name.Hash(), m_psVertexShader.Append(VertexShader));	// patched for Cocos3D by Bill Hollings
 				else
 					return false;
 			}
@@ -651,7 +771,7 @@ bool CPVRTPFXParser::Parse(CPVRTString * const pReturnError)
 			{
 				SPVRTPFXParserShader FragShader;
 				if(ParseShader(nLine, nEndLine, pReturnError, FragShader, "FRAGMENTSHADER"))
-					m_psFragmentShader.Append(FragShader);
+					m_FragmentShaderIndex.Add(FragShader.Name.Hash(), m_psFragmentShader.Append(FragShader));	// patched for Cocos3D by Bill Hollings
 				else
 					return false;
 			}
@@ -668,7 +788,7 @@ bool CPVRTPFXParser::Parse(CPVRTString * const pReturnError)
 			{
 				SPVRTPFXParserEffect Effect;
 				if(ParseEffect(Effect, nLine, nEndLine, pReturnError))
-					m_psEffect.Append(Effect);
+					m_EffectIndex.Add(Effect.Name.Hash(), m_psEffect.Append(Effect));	// patched for Cocos3D by Bill Hollings
 				else
 					return false;
 			}
@@ -710,16 +830,8 @@ bool CPVRTPFXParser::Parse(CPVRTString * const pReturnError)
 		// Loop Textures in Effects
 		for(j = 0; j < m_psEffect[i].Textures.GetSize(); ++j)
 		{
-			// Loop Textures in whole PFX
-			unsigned int uiTexSize = m_psTexture.GetSize();
-			for(k = 0; k < uiTexSize; ++k)
-			{
-				if(m_psTexture[k]->Name == m_psEffect[i].Textures[j].Name)
-					break;
-			}
-
-			// Texture mismatch. Report error.
-			if(!uiTexSize || k == uiTexSize)
+			// Look up the texture in the whole PFX. Texture mismatch. Report error.	// patched for Cocos3D by Bill Hollings
+			if(m_TextureIndex.Find(m_psEffect[i].Textures[j].Name.Hash()) < 0)
 			{
 				*pReturnError = "Error: TEXTURE '" + m_psEffect[i].Textures[j].Name.String() + "' is not defined in [TEXTURES].\n";
 				return false;
@@ -746,9 +858,7 @@ bool CPVRTPFXParser::Parse(CPVRTString * const pReturnError)
 *****************************************************************************/
 EPVRTError CPVRTPFXParser::ParseFromMemory(const char * const pszScript, CPVRTString * const pReturnError)
 {
-	CPVRTPFXParserReadContext	context;
-	char			pszLine[512];
-	const char		*pszEnd, *pszCurr;
+	char			*pszEnd, *pszCurr;
 	int				nLineCounter;
 	unsigned int	nLen;
 	unsigned int	nReduce;
@@ -757,12 +867,15 @@ EPVRTError CPVRTPFXParser::ParseFromMemory(const char * const pszScript, CPVRTSt
 	if(!pszScript)
 		return PVR_FAIL;
 
+	// Lines are split and reduced in place within a single copy of the script,
+	// instead of being copied out one at a time.	// patched for Cocos3D by Bill Hollings
+	CPVRTPFXParserReadContext	context(pszScript);
 	m_psContext = &context;
 
 	// Find & process each line
 	nLineCounter	= 0;
 	bDone			= false;
-	pszCurr			= pszScript;
+	pszCurr			= context.pszScript;
 	while(!bDone)
 	{
 		nLineCounter++;
@@ -786,12 +899,8 @@ EPVRTError CPVRTPFXParser::ParseFromMemory(const char * const pszScript, CPVRTSt
 		while(nLen - nReduce > 0 && pszCurr[nLen - 1 - nReduce] == '\r')
 			nReduce++;
 
-		// Ensure pszLine will not be not overrun
-		if(nLen+1-nReduce > sizeof(pszLine) / sizeof(*pszLine))
-			nLen = sizeof(pszLine) / sizeof(*pszLine) - 1 + nReduce;
-
-		// Copy line into pszLine
-		strncpy(pszLine, pszCurr, nLen - nReduce);
+		// Terminate the line in place
+		char* pszLine = pszCurr;
 		pszLine[nLen - nReduce] = 0;
 		pszCurr += nLen + 1;
 
@@ -806,18 +915,10 @@ EPVRTError CPVRTPFXParser::ParseFromMemory(const char * const pszScript, CPVRTSt
 		ReduceWhitespace(pszLine);
 
 		// Store the line, even if blank lines (to get correct errors from GLSL compiler).
-		if(m_psContext->nNumLines < m_psContext->nMaxLines)
-		{
-			m_psContext->pnFileLineNumber[m_psContext->nNumLines] = nLineCounter;
-			m_psContext->ppszEffectFile[m_psContext->nNumLines] = (char *)malloc((strlen(pszLine) + 1) * sizeof(char));
-			strcpy(m_psContext->ppszEffectFile[m_psContext->nNumLines], pszLine);
-			m_psContext->nNumLines++;
-		}
-		else
-		{
-			*pReturnError = PVRTStringFromFormattedStr("Too many lines of text in file (maximum is %d)\n", m_psContext->nMaxLines);
-			return PVR_FAIL;
-		}
+		_ASSERT(m_psContext->nNumLines < m_psContext->nMaxLines);
+		m_psContext->pnFileLineNumber[m_psContext->nNumLines] = nLineCounter;
+		m_psContext->ppszEffectFile[m_psContext->nNumLines] = pszLine;
+		m_psContext->nNumLines++;
 	}
 
 	return Parse(pReturnError) ? PVR_SUCCESS : PVR_FAIL;
@@ -886,7 +987,7 @@ bool CPVRTPFXParser::SetViewportSize(unsigned int uiWidth, unsigned int uiHeight
 *****************************************************************************/
 bool CPVRTPFXParser::RetrieveRenderPassDependencies(CPVRTArray<SPVRTPFXRenderPass*> &aRequiredRenderPasses, CPVRTArray<CPVRTStringHash> &aszActiveEffectStrings)
 {
-	unsigned int ui(0), uj(0), uk(0), ul(0);
+	unsigned int ui(0), uj(0), uk(0);
 	const SPVRTPFXParserEffect* pTempEffect(NULL);
 	
 	if(aRequiredRenderPasses.GetSize() > 0)
@@ -903,22 +1004,14 @@ bool CPVRTPFXParser::RetrieveRenderPassDependencies(CPVRTArray<SPVRTPFXRenderPas
 			return false;
 		}
 
-		// Find the specified effect
-		for(uj = 0, pTempEffect = NULL; uj < (unsigned int)m_psEffect.GetSize(); ++uj)
-		{
-			if(aszActiveEffectStrings[ui] == m_psEffect[uj].Name)
-			{
-				// Effect found
-				pTempEffect = &m_psEffect[uj];
-				break;
-			}
-		}
-
-		if(pTempEffect == NULL)
+		// Find the specified effect	// patched for Cocos3D by Bill Hollings
+		int iEffect = m_EffectIndex.Find(aszActiveEffectStrings[ui].Hash());
+		if(iEffect < 0)
 		{
 			// Effect not found
 			return false;
 		}
+		pTempEffect = &m_psEffect[iEffect];
 		
 		for(uj = 0; uj < m_renderPassSkipGraph.GetNumNodes(); ++uj)
 		{
@@ -933,26 +1026,19 @@ bool CPVRTPFXParser::RetrieveRenderPassDependencies(CPVRTArray<SPVRTPFXRenderPas
 			The effect wasn't a post-process. Check to see if it has any non-post-process dependencies,
 			e.g. RENDER CAMERA textures.
 		*/
-		// Loop Effects
-		for(uj = 0; uj < (unsigned int)m_psEffect.GetSize(); ++uj)
+		// Loop Textures in Effect	// patched for Cocos3D by Bill Hollings
+		for(uj = 0; uj < pTempEffect->Textures.GetSize(); ++uj)
 		{
-			if(aszActiveEffectStrings[ui] != m_psEffect[uj].Name)
-				continue;
-
-			// Loop Textures in Effect
-			for(uk = 0; uk < m_psEffect[uj].Textures.GetSize();++uk)
+			// Loop Render Passes for whole PFX
+			for(uk = 0; uk < m_RenderPasses.GetSize(); ++uk)
 			{
-				// Loop Render Passes for whole PFX
-				for(ul = 0; ul < m_RenderPasses.GetSize(); ++ul)
-				{
-					// Check that the name of this render pass output texture matches a provided texture in an Effect
-					if(m_RenderPasses[ul].pTexture->Name == m_psEffect[uj].Textures[uk].Name)
-						aRequiredRenderPasses.Append(&m_RenderPasses[ul]);
-				}
+				// Check that the name of this render pass output texture matches a provided texture in an Effect
+				if(m_RenderPasses[uk].pTexture->Name == pTempEffect->Textures[uj].Name)
+					aRequiredRenderPasses.Append(&m_RenderPasses[uk]);
 			}
-			
-			return true;
 		}
+
+		return true;
 	}
 
 	return false;
@@ -995,62 +1081,27 @@ bool CPVRTPFXParser::GetEndTag(const char* pszTagName, int nStartLine, int *pnEn
 *****************************************************************************/
 void CPVRTPFXParser::ReduceWhitespace(char *line)
 {
-	// convert tabs and newlines to ' '
-	char *tmp = strpbrk (line, "\t\n");
-	while(tmp != NULL)
+	// Single pass that converts tabs and newlines to ' ', drops leading and trailing
+	// whitespace, and collapses each interior run of whitespace to one blank.	// patched for Cocos3D by Bill Hollings
+	char *pszDst = line;
+	bool bPendingSpace = false;
+	for(const char *pszSrc = line; *pszSrc; pszSrc++)
 	{
-		*tmp = ' ';
-		tmp = strpbrk (line, "\t\n");
-	}
-
-	// remove all whitespace at start
-	while(line[0] == ' ')
-	{
-		// move chars along to omit whitespace
-		int counter = 0;
-		do{
-			line[counter] = line[counter+1];
-			counter++;
-		}while(line[counter] != '\0');
-	}
-
-	// step through chars of line remove multiple whitespace
-	for(int i=0; i < (int)strlen(line); i++)
-	{
-		// whitespace found
-		if(line[i] == ' ')
+		char c = *pszSrc;
+		if(c == ' ' || c == '\t' || c == '\n')
 		{
-			// count number of whitespace chars
-			int numWhiteChars = 0;
-			while(line[i+1+numWhiteChars] == ' ')
-			{
-				numWhiteChars++;
-			}
-
-			// multiple whitespace chars found
-			if(numWhiteChars>0)
-			{
-				// move chars along to omit whitespace
-				int counter=1;
-				while(line[i+counter] != '\0')
-				{
-					line[i+counter] = line[i+numWhiteChars+counter];
-					counter++;
-				}
-			}
+			bPendingSpace = (pszDst != line);
+			continue;
 		}
-	}
-
-	// If there is no string then do not remove terminating white symbols
-	if(!strlen(line))
-	    return;
 
-	// remove all whitespace from end
-	while(line[strlen(line)-1] == ' ')
-	{
-		// move chars along to omit whitespace
-		line[strlen(line)-1] = '\0';
+		if(bPendingSpace)
+		{
+			*pszDst++ = ' ';
+			bPendingSpace = false;
+		}
+		*pszDst++ = c;
 	}
+	*pszDst = '\0';
 }
 
 /*!***************************************************************************
@@ -1102,19 +1153,15 @@ bool CPVRTPFXParser::ReadStringToken(char* pszSource, CPVRTString& output, CPVRT
 	if(*pszSource == '\"')		// Quote marks. Continue parsing until end mark or NULL
 	{	
 		pszSource++;		// Skip past first quote
-		while(*pszSource != '\"')
+		char* pszEndQuote = strchr(pszSource, '\"');
+		if(!pszEndQuote)
 		{
-			if(*pszSource == '\0')
-			{
-				ErrorStr = PVRTStringFromFormattedStr("Incomplete argument in [%s] on line %d: %s\n", pCaller,m_psContext->pnFileLineNumber[i],  m_psContext->ppszEffectFile[i]);
-				return false;
-			}
-
-			output.push_back(*pszSource);
-			pszSource++;
+			ErrorStr = PVRTStringFromFormattedStr("Incomplete argument in [%s] on line %d: %s\n", pCaller,m_psContext->pnFileLineNumber[i],  m_psContext->ppszEffectFile[i]);
+			return false;
 		}
 
-		pszSource++;		// Skip past final quote.
+		output.append(pszSource, (size_t)(pszEndQuote - pszSource));	// patched for Cocos3D by Bill Hollings
+		pszSource = pszEndQuote + 1;		// Skip past final quote.
 	}
 	else		// No quotes. Read until space
 	{
@@ -1294,18 +1341,21 @@ bool CPVRTPFXParser::ParseGenericSurface(int nStartLine, int nEndLine, SPVRTPFXP
 
 		CPVRTHash Cmd(str);
 		const char** ppFilters  = NULL;
+		unsigned int uiNumFilters = 0;		// patched for Cocos3D by Bill Hollings
 		bool bKnown = false;
 
 		// --- Verbose filtering flags
 		if(Cmd == GenericSurfCommands[eCmds_Min] || Cmd == GenericSurfCommands[eCmds_Mag] || Cmd == GenericSurfCommands[eCmds_Mip])
 		{
 			ppFilters = c_ppszFilters;
+			uiNumFilters = eFilter_Size;
 			bKnown     = true;
 		}
 		// --- Verbose wrapping flags
 		else if(Cmd == GenericSurfCommands[eCmds_WrapS] || Cmd == GenericSurfCommands[eCmds_WrapT] || Cmd == GenericSurfCommands[eCmds_WrapR])
 		{
 			ppFilters = c_ppszWraps;
+			uiNumFilters = eWrap_Size;
 			bKnown     = true;
 		}
 		// --- Inline filtering flags
@@ -1429,7 +1479,7 @@ bool CPVRTPFXParser::ParseGenericSurface(int nStartLine, int nEndLine, SPVRTPFXP
 			}
 
 			unsigned int Type = INVALID_TYPE;
-			for(unsigned int uiIndex = 0; uiIndex < 3; ++uiIndex)
+			for(unsigned int uiIndex = 0; uiIndex < uiNumFilters; ++uiIndex)	// Wraps table is shorter than filters	// patched for Cocos3D by Bill Hollings
 			{
 				if(strcmp(pszRemaining, ppFilters[uiIndex]) == 0)	
 				{
@@ -1639,7 +1689,7 @@ bool CPVRTPFXParser::ParseTexture(int nStartLine, int nEndLine, CPVRTString * co
 	pTex->uiWidth			= TexDesc.uiWidth;
 	pTex->uiHeight			= TexDesc.uiHeight;
 	pTex->uiFlags			= TexDesc.uiFlags;
-	m_psTexture.Append(pTex);
+	m_TextureIndex.Add(pTex->Name.Hash(), m_psTexture.Append(pTex));	// patched for Cocos3D by Bill Hollings
 
 	if(bRTT)
 	{
@@ -1773,7 +1823,7 @@ bool CPVRTPFXParser::ParseTarget(int nStartLine, int nEndLine, CPVRTString * con
 	pTex->uiWidth			= TexDesc.uiWidth;
 	pTex->uiHeight			= TexDesc.uiHeight;
 	pTex->uiFlags			= TexDesc.uiFlags;
-	m_psTexture.Append(pTex);
+	m_TextureIndex.Add(pTex->Name.Hash(), m_psTexture.Append(pTex));	// patched for Cocos3D by Bill Hollings
 
 	// Copy to render pass struct
 	unsigned int uiPassIdx = m_RenderPasses.Append();
@@ -1927,7 +1977,7 @@ bool CPVRTPFXParser::ParseTextures(int nStartLine, int nEndLine, CPVRTString * c
 				pTex->uiWidth			= uiWidth;
 				pTex->uiHeight			= uiHeight;
 				pTex->uiFlags			= uiFlags;
-				m_psTexture.Append(pTex);
+				m_TextureIndex.Add(pTex->Name.Hash(), m_psTexture.Append(pTex));	// patched for Cocos3D by Bill Hollings
 			}
 			else
 			{
@@ -2654,14 +2704,26 @@ bool CPVRTPFXParser::DetermineRenderPassDependencies(CPVRTString * const pReturn
 	if(m_RenderPasses.GetSize() == 0)
 		return true;
 
+	// Index the effects by the names of their TARGETs, so that each pass below only
+	// searches the effect that declares its first possible match.	// patched for Cocos3D by Bill Hollings
+	CPVRTPFXParserNameIndex TargetIndex;
+	for(ui = 0; ui < m_psEffect.GetSize(); ++ui)
+	{
+		for(uj = 0; uj < m_psEffect[ui].Targets.GetSize(); ++uj)
+			TargetIndex.Add(CPVRTHash(m_psEffect[ui].Targets[uj].TargetName), ui);
+	}
+
 	// --- Add all render pass nodes to the skip graph.
 	for(ui = 0; ui < m_RenderPasses.GetSize(); ++ui)
 	{
 		SPVRTPFXRenderPass& Pass = m_RenderPasses[ui];
 		bool bFound = false;
 
-		// Search all EFFECT blocks for matching TARGET. This is for post-processes behavior.
-		for(unsigned int uiEffect = 0; uiEffect < m_psEffect.GetSize(); ++uiEffect)
+		// Search EFFECT blocks for matching TARGET. This is for post-processes behavior.
+		// Start at the first effect with a TARGET of the same name hash. Effects before it cannot match.
+		int iFirstEffect = TargetIndex.Find(CPVRTHash(Pass.SemanticName));
+		unsigned int uiFirstEffect = (iFirstEffect < 0) ? m_psEffect.GetSize() : (unsigned int)iFirstEffect;
+		for(unsigned int uiEffect = uiFirstEffect; uiEffect < m_psEffect.GetSize(); ++uiEffect)
 		{
 			SPVRTPFXParserEffect& Effect = m_psEffect[uiEffect];
 
@@ -2900,15 +2962,7 @@ int CPVRTPFXParser::FindEffectByName(const CPVRTStringHash& Name) const
 	if(Name.Hash() == 0)
 		return -1;
 
-	for(unsigned int uiIndex = 0; uiIndex < GetNumberEffects(); ++uiIndex)
-	{
-		if(GetEffect(uiIndex).Name == Name)
-		{
-			return (int)uiIndex;
-		}
-	}
-	
-	return -1;
+	return m_EffectIndex.Find(Name.Hash());		// patched for Cocos3D by Bill Hollings
 }
 
 /*!***************************************************************************
@@ -2922,15 +2976,37 @@ int CPVRTPFXParser::FindTextureByName(const CPVRTStringHash& Name) const
 	if(Name.Hash() == 0)
 		return -1;
 
-	for(unsigned int uiIndex = 0; uiIndex < GetNumberTextures(); ++uiIndex)
-	{
-		if(GetTexture(uiIndex)->Name == Name)
-		{
-			return (int)uiIndex;
-		}
-	}
+	return m_TextureIndex.Find(Name.Hash());	// patched for Cocos3D by Bill Hollings
+}
 
-	return -1;
+/*!***************************************************************************
+@Function		FindVertexShaderByName
+@Input			Name		Name of the vertex shader.
+@Return			int	
+@Description	Returns the index of the given vertex shader. Returns -1 on failure.
+				(patched for Cocos3D by Bill Hollings)
+*****************************************************************************/
+int CPVRTPFXParser::FindVertexShaderByName(const CPVRTStringHash& Name) const
+{
+	if(Name.Hash() == 0)
+		return -1;
+
+	return m_VertexShaderIndex.Find(Name.Hash());
+}
+
+/*!***************************************************************************
+@Function		FindFragmentShaderByName
+@Input			Name		Name of the fragment shader.
+@Return			int	
+@Description	Returns the index of the given fragment shader. Returns -1 on failure.
+				(patched for Cocos3D by Bill Hollings)
+*****************************************************************************/
+int CPVRTPFXParser::FindFragmentShaderByName(const CPVRTStringHash& Name) const
+{
+	if(Name.Hash() == 0)
+		return -1;
+
+	return m_FragmentShaderIndex.Find(Name.Hash());
 }
 
 /*!***************************************************************************
@@ -281,6 +281,48 @@ const static SPVRTSemanticDefaultDataTypeInfo c_psSemanticDefaultDataTypeInfo[]
 	{ eDataTypeBool,		"bool",			1,		eBoolean },
 };
 
+/*!**************************************************************************
+@class CPVRTPFXParserNameIndex
+@brief Open-addressed hash table mapping a name hash to the index of the first
+       entry appended under that name. Lookups match on hash alone, in the same
+       way as CPVRTStringHash comparisons. (patched for Cocos3D by Bill Hollings)
+****************************************************************************/
+class CPVRTPFXParserNameIndex
+{
+public:
+	/*!***************************************************************************
+	@brief     		Sets initial values.
+	*****************************************************************************/
+	CPVRTPFXParserNameIndex();
+
+	/*!***************************************************************************
+	@brief     		Adds the given entry index under the given name hash. If the
+					name was already added, the earlier entry is kept.
+	@param[in]		Hash		The hash of the entry name.
+	@param[in]		uiIndex		The index of the entry in its owning array.
+	*****************************************************************************/
+	void Add(const CPVRTHash& Hash, unsigned int uiIndex);
+
+	/*!***************************************************************************
+	@brief     		Returns the index of the first entry added under the given
+					name hash, or -1 if no such entry exists.
+	@param[in]		Hash		The hash of the entry name.
+	@return			int
+	*****************************************************************************/
+	int Find(const CPVRTHash& Hash) const;
+
+private:
+	struct SSlot
+	{
+		unsigned int	uiHash;
+		int				iIndex;
+	};
+
+	CPVRTArray<SSlot>	m_aSlots;
+	unsigned int		m_uiCount;
+
+	void Rehash(unsigned int uiSlotCount);
+};
 
 class CPVRTPFXParserReadContext;
 
@@ -436,6 +478,22 @@ public:
 	*****************************************************************************/
 	int FindTextureByName(const CPVRTStringHash& Name) const;
 
+	/*!***************************************************************************
+	@fn      		FindVertexShaderByName
+	@param[in]		Name		Name of the vertex shader.
+	@return			int	
+	@brief     	    Returns the index of the given vertex shader. Returns -1 on failure.
+	*****************************************************************************/
+	int FindVertexShaderByName(const CPVRTStringHash& Name) const;	// patched for Cocos3D by Bill Hollings
+
+	/*!***************************************************************************
+	@fn      		FindFragmentShaderByName
+	@param[in]		Name		Name of the fragment shader.
+	@return			int	
+	@brief     	    Returns the index of the given fragment shader. Returns -1 on failure.
+	*****************************************************************************/
+	int FindFragmentShaderByName(const CPVRTStringHash& Name) const;	// patched for Cocos3D by Bill Hollings
+
 	/*!***************************************************************************
 	@fn      		GetNumberTextures
 	@return			Number of effects.
@@ -477,6 +535,11 @@ private:
 	CPVRTArray<SPVRTPFXParserEffect>					m_psEffect;
 	CPVRTArray<SPVRTPFXRenderPass>						m_RenderPasses;
 
+	CPVRTPFXParserNameIndex								m_TextureIndex;			// patched for Cocos3D by Bill Hollings
+	CPVRTPFXParserNameIndex								m_FragmentShaderIndex;	// patched for Cocos3D by Bill Hollings
+	CPVRTPFXParserNameIndex								m_VertexShaderIndex;	// patched for Cocos3D by Bill Hollings
+	CPVRTPFXParserNameIndex								m_EffectIndex;			// patched for Cocos3D by Bill Hollings
+
 	CPVRTString											m_szFileName;
 	CPVRTPFXParserReadContext*							m_psContext;
 	CPVRTArray<CPVRTString>								m_aszPostProcessNames;
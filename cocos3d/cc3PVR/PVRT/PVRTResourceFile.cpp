@@ -18,6 +18,14 @@
 #include <stdio.h>
 #include <string.h>
 
+#if defined(__APPLE__) || defined(__linux__)		// patched for Cocos3D by Bill Hollings
+#define PVRT_MAPPED_FILE_SUPPORTED 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #include "PVRTResourceFile.h"
 #include "PVRTString.h"
 #include "PVRTMemoryFileSystem.h"
@@ -220,6 +228,120 @@ void CPVRTResourceFile::Close()
 	}
 }
 
+/****************************************************************************
+** class CPVRTMappedFile						// patched for Cocos3D by Bill Hollings
+****************************************************************************/
+
+/*!***************************************************************************
+@Function			IsSupported
+@Returns			true if file mapping is available on this platform
+*****************************************************************************/
+bool CPVRTMappedFile::IsSupported()
+{
+#if defined(PVRT_MAPPED_FILE_SUPPORTED)
+	return true;
+#else
+	return false;
+#endif
+}
+
+/*!***************************************************************************
+@Function			Open
+@Input				pszFilename Name of the file to map, relative to the read path
+@Returns			A new mapping with a reference count of one, or NULL
+@Description		Maps the contents of the specified file into memory. The
+					pages are mapped privately and are writable, so that the
+					content can be modified in place (eg- endian fixes) without
+					affecting the file.
+*****************************************************************************/
+CPVRTMappedFile* CPVRTMappedFile::Open(const char* pszFilename)
+{
+#if defined(PVRT_MAPPED_FILE_SUPPORTED)
+	if(!pszFilename)
+		return 0;
+
+	CPVRTString Path(CPVRTResourceFile::GetReadPath());
+	Path += pszFilename;
+
+	int fd = open(Path.c_str(), O_RDONLY);
+	if(fd < 0)
+		return 0;
+
+	struct stat sStat;
+	if(fstat(fd, &sStat) != 0 || sStat.st_size <= 0)
+	{
+		close(fd);
+		return 0;
+	}
+
+	size_t Size = (size_t) sStat.st_size;
+	void* pData = mmap(0, Size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);		// The mapping remains valid after the descriptor is closed
+
+	if(pData == MAP_FAILED)
+		return 0;
+
+	return new CPVRTMappedFile((char*) pData, Size);
+#else
+	return 0;
+#endif
+}
+
+/*!***************************************************************************
+@Function			CPVRTMappedFile
+@Input				pData The mapped content
+@Input				Size The size of the mapped content
+@Description		Constructor
+*****************************************************************************/
+CPVRTMappedFile::CPVRTMappedFile(char* pData, size_t Size) :
+	m_pData(pData),
+	m_Size(Size),
+	m_i32RefCount(1)
+{
+}
+
+/*!***************************************************************************
+@Function			~CPVRTMappedFile
+@Description		Destructor. Unmaps the file content.
+*****************************************************************************/
+CPVRTMappedFile::~CPVRTMappedFile()
+{
+#if defined(PVRT_MAPPED_FILE_SUPPORTED)
+	if(m_pData)
+		munmap(m_pData, m_Size);
+#endif
+	m_pData = 0;
+	m_Size = 0;
+}
+
+/*!***************************************************************************
+@Function			Retain
+@Description		Increments the reference count.
+*****************************************************************************/
+void CPVRTMappedFile::Retain()
+{
+#if defined(PVRT_MAPPED_FILE_SUPPORTED)
+	__sync_add_and_fetch(&m_i32RefCount, 1);
+#else
+	++m_i32RefCount;
+#endif
+}
+
+/*!***************************************************************************
+@Function			Release
+@Description		Decrements the reference count, and deletes this instance
+					when it reaches zero.
+*****************************************************************************/
+void CPVRTMappedFile::Release()
+{
+#if defined(PVRT_MAPPED_FILE_SUPPORTED)
+	if(__sync_sub_and_fetch(&m_i32RefCount, 1) == 0)
+#else
+	if(--m_i32RefCount == 0)
+#endif
+		delete this;
+}
+
 /****************************************************************************
 ** class CPVRTMemoryFileSystem
 ****************************************************************************/
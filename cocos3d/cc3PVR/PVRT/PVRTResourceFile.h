@@ -110,6 +110,78 @@ protected:
 	static PFNReleaseFileFunc s_pReleaseFileFunc;
 };
 
+/*!***************************************************************************
+ @class CPVRTMappedFile
+ @brief Reference-counted, read-only memory mapping of a file.
+ @details	Used to reference file content in place, without copying it to
+			the heap. The mapping is private, so any modifications made to
+			the mapped content are copy-on-write, and never reach the file.
+			Mapping is only available on POSIX platforms (Linux & Darwin).
+			The mapping is unmapped when the last reference is released.
+			patched for Cocos3D by Bill Hollings
+*****************************************************************************/
+class CPVRTMappedFile
+{
+public:
+	/*!***************************************************************************
+	@fn       			Open
+	@param[in]			pszFilename Name of the file to map, relative to the read path
+	@return 			A new mapping with a reference count of one, or NULL if the
+						file could not be mapped on this platform.
+	@brief      		Maps the contents of the specified file into memory.
+	*****************************************************************************/
+	static CPVRTMappedFile* Open(const char* pszFilename);
+
+	/*!***************************************************************************
+	@fn       			IsSupported
+	@return 			true if file mapping is available on this platform
+	*****************************************************************************/
+	static bool IsSupported();
+
+	/*!***************************************************************************
+	@fn       			Retain
+	@brief      		Increments the reference count. Thread-safe.
+	*****************************************************************************/
+	void Retain();
+
+	/*!***************************************************************************
+	@fn       			Release
+	@brief      		Decrements the reference count, and unmaps and deletes
+						this instance when it reaches zero. Thread-safe.
+	*****************************************************************************/
+	void Release();
+
+	/*!***************************************************************************
+	@fn       			Size
+	@return 			The size of the mapped file
+	*****************************************************************************/
+	size_t Size() const { return m_Size; }
+
+	/*!***************************************************************************
+	@fn       			DataPtr
+	@return 			A pointer to the start of the mapped file content
+	*****************************************************************************/
+	const void* DataPtr() const { return m_pData; }
+
+	/*!***************************************************************************
+	@fn       			Contains
+	@param[in]			pData A memory address
+	@return 			true if the specified address lies within the mapped content
+	*****************************************************************************/
+	bool Contains(const void* pData) const
+	{
+		return (const char*)pData >= m_pData && (const char*)pData < m_pData + m_Size;
+	}
+
+protected:
+	CPVRTMappedFile(char* pData, size_t Size);
+	~CPVRTMappedFile();
+
+	char* m_pData;
+	size_t m_Size;
+	volatile int m_i32RefCount;
+};
+
 #endif // _PVRTRESOURCEFILE_H_
 
 /*****************************************************************************
@@ -21,11 +21,17 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 
 #include "PVRTFixedPoint.h"
 #include "PVRTMatrix.h"
 #include "PVRTVertex.h"
 
+#if defined(__APPLE__)					// patched for Cocos3D by Bill Hollings
+#define PVRT_VERTEX_PARALLEL_GCD 1
+#include <dispatch/dispatch.h>
+#endif
+
 /****************************************************************************
 ** Defines
 ****************************************************************************/
@@ -33,12 +39,33 @@
 /****************************************************************************
 ** Macros
 ****************************************************************************/
-#define MAX_VERTEX_OUT (3*nVtxNum)
+
+// Number of triangles or vertices processed together as one independent range.
+#define PVRT_VERTEX_PARALLEL_RANGE		1024
 
 /****************************************************************************
 ** Structures
 ****************************************************************************/
 
+// Working state shared by the stages of PVRTVertexGenerateTangentSpace.
+struct SPVRTTangentSpaceGen				// patched for Cocos3D by Bill Hollings
+{
+	const unsigned int	*pui32Idx;
+	const char			*pVtx;
+	unsigned int		nStride;
+	unsigned int		nOffsetPos, nOffsetNor, nOffsetTex;
+	EPVRTDataType		eTypePos, eTypeNor, eTypeTex;
+	unsigned int		nTriNum, nVtxNum;
+	float				fSplitDifference;
+
+	PVRTVECTOR3f		*pvCornerTan;		// Desired tangent, one per triangle corner
+	PVRTVECTOR3f		*pvCornerBin;		// Desired bitangent, one per triangle corner
+	unsigned int		*pnVtxCornerStart;	// Start of each vertex's run in pnVtxCorners (nVtxNum+1 entries)
+	unsigned int		*pnVtxCorners;		// Corners referencing each vertex, in triangle order
+	unsigned int		*pnCornerSplit;		// Index of the split vertex chosen for each corner, within its vertex
+	unsigned int		*pnVtxSplitNum;		// Number of split vertices required by each vertex
+};
+
 /****************************************************************************
 ** Constants
 ****************************************************************************/
@@ -557,6 +584,211 @@ void PVRTVertexTangentBitangent(
 	}
 }
 
+/*!***************************************************************************
+ @Function			PVRTVertexParallelFor
+ @Input				nCount				Number of items to process
+ @Input				pfnRange			Function that processes one range of items
+ @Modified			pContext			Context passed to each invocation of pfnRange
+ @Description		Invokes pfnRange once for each range of PVRT_VERTEX_PARALLEL_RANGE
+					items. Ranges must write to disjoint data. Ranges are run
+					concurrently where the platform supports it, otherwise
+					sequentially on the calling thread.
+					// patched for Cocos3D by Bill Hollings
+*****************************************************************************/
+static void PVRTVertexParallelFor(
+	const unsigned int	nCount,
+	void				* const pContext,
+	void				(*pfnRange)(void*, size_t))
+{
+	size_t nRangeNum = (nCount + PVRT_VERTEX_PARALLEL_RANGE - 1) / PVRT_VERTEX_PARALLEL_RANGE;
+#if defined(PVRT_VERTEX_PARALLEL_GCD)
+	if(nRangeNum > 1)
+	{
+		dispatch_apply_f(nRangeNum, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), pContext, pfnRange);
+		return;
+	}
+#endif
+	for(size_t nRange = 0; nRange < nRangeNum; ++nRange)
+		pfnRange(pContext, nRange);
+}
+
+/*!***************************************************************************
+ @Function			PVRTVertexTangentSpaceCorners
+ @Modified			pContext			The SPVRTTangentSpaceGen working state
+ @Input				nRange				Index of the range of triangles to process
+ @Description		Calculates the tangent and bitangent desired by each corner
+					of a range of triangles.
+					// patched for Cocos3D by Bill Hollings
+*****************************************************************************/
+static void PVRTVertexTangentSpaceCorners(void* pContext, size_t nRange)
+{
+	const SPVRTTangentSpaceGen &gen = *(const SPVRTTangentSpaceGen*)pContext;
+	const char * const pVtx = gen.pVtx;
+	const unsigned int nStride = gen.nStride;
+	float pfPos[3][4], pfTex[3][4], pfNor[3][4];
+
+	unsigned int nTriEnd = PVRT_MIN((unsigned int)(nRange + 1) * PVRT_VERTEX_PARALLEL_RANGE, gen.nTriNum);
+	for(unsigned int nTri = (unsigned int)nRange * PVRT_VERTEX_PARALLEL_RANGE; nTri < nTriEnd; ++nTri)
+	{
+		for(unsigned int k = 0; k < 3; ++k)
+		{
+			const char *pV = &pVtx[gen.pui32Idx[3*nTri+k] * nStride];
+			PVRTVertexRead((PVRTVECTOR4f*) &pfPos[k][0], pV + gen.nOffsetPos, gen.eTypePos, 3);
+			PVRTVertexRead((PVRTVECTOR4f*) &pfNor[k][0], pV + gen.nOffsetNor, gen.eTypeNor, 3);
+			PVRTVertexRead((PVRTVECTOR4f*) &pfTex[k][0], pV + gen.nOffsetTex, gen.eTypeTex, 3);
+		}
+
+		for(unsigned int k = 0; k < 3; ++k)
+		{
+			unsigned int k1 = (k + 1) % 3, k2 = (k + 2) % 3;
+			PVRTVertexTangentBitangent(
+				&gen.pvCornerTan[3*nTri+k],
+				&gen.pvCornerBin[3*nTri+k],
+				(PVRTVECTOR3f*) &pfNor[k][0],
+				pfPos[k], pfPos[k1], pfPos[k2],
+				pfTex[k], pfTex[k1], pfTex[k2]);
+		}
+	}
+}
+
+/*!***************************************************************************
+ @Function			PVRTVertexAngleBetween
+ @Input				vA					First vector
+ @Input				vB					Second vector
+ @Return			The angle between the vectors, in radians, or NaN if either
+					vector has no length
+ @Description		Calculates the angle between two vectors in double precision,
+					so that it bounds the single precision DP3 of the vectors.
+					// patched for Cocos3D by Bill Hollings
+*****************************************************************************/
+static double PVRTVertexAngleBetween(const PVRTVECTOR3f &vA, const PVRTVECTOR3f &vB)
+{
+	double dDot = (double)vA.x * vB.x + (double)vA.y * vB.y + (double)vA.z * vB.z;
+	double dLenSq = ((double)vA.x * vA.x + (double)vA.y * vA.y + (double)vA.z * vA.z) *
+					((double)vB.x * vB.x + (double)vB.y * vB.y + (double)vB.z * vB.z);
+	if(!(dLenSq > 0.0))
+		return nan("");
+	return acos(PVRT_CLAMP(dDot / sqrt(dLenSq), -1.0, 1.0));
+}
+
+/*!***************************************************************************
+ @Function			PVRTVertexTangentSpaceSplits
+ @Modified			pContext			The SPVRTTangentSpaceGen working state
+ @Input				nRange				Index of the range of vertices to process
+ @Description		For each vertex in a range, groups the corners that reference
+					the vertex into split vertices. In triangle order, each corner
+					joins the first split vertex whose corners all have tangents
+					and bitangents within fSplitDifference of its own, or starts
+					a new split vertex. Split vertices are numbered in the
+					triangle order of their first corner.
+
+					Each corner is compared with the first corner of a split
+					vertex before any other, so a split vertex that does not
+					match is usually rejected by one comparison. Each split
+					vertex also records the widest angle between its first
+					corner and any other, so that when the triangle inequality
+					shows that every corner must match, with a margin for
+					rounding, the remaining comparisons are skipped.
+					// patched for Cocos3D by Bill Hollings
+*****************************************************************************/
+static void PVRTVertexTangentSpaceSplits(void* pContext, size_t nRange)
+{
+	const SPVRTTangentSpaceGen &gen = *(const SPVRTTangentSpaceGen*)pContext;
+	const unsigned int nEnd = (unsigned int)-1;
+	const double dPi = 3.14159265358979323846;
+	const double dMargin = 1.0e-5;		// Exceeds the rounding error of a single precision DP3
+	unsigned int *pnSplitFirst = NULL;	// First corner of each split vertex, within the vertex
+	unsigned int *pnSplitLast = NULL;	// Last corner of each split vertex, within the vertex
+	unsigned int *pnCornerNext = NULL;	// Next corner of the same split vertex, within the vertex
+	double *pdSplitSpread = NULL;		// Widest tangent & bitangent angles from the first corner, two per split vertex
+	unsigned int nWorkLen = 0;
+
+	unsigned int nVtxEnd = PVRT_MIN((unsigned int)(nRange + 1) * PVRT_VERTEX_PARALLEL_RANGE, gen.nVtxNum);
+	for(unsigned int nVert = (unsigned int)nRange * PVRT_VERTEX_PARALLEL_RANGE; nVert < nVtxEnd; ++nVert)
+	{
+		const unsigned int *pnCorners = &gen.pnVtxCorners[gen.pnVtxCornerStart[nVert]];
+		unsigned int nCornerNum = gen.pnVtxCornerStart[nVert+1] - gen.pnVtxCornerStart[nVert];
+		unsigned int nSplitNum = 0;
+
+		if(nCornerNum > nWorkLen)
+		{
+			FREE(pnSplitFirst);
+			FREE(pnSplitLast);
+			FREE(pnCornerNext);
+			FREE(pdSplitSpread);
+			nWorkLen = nCornerNum;
+			pnSplitFirst = (unsigned int*)malloc(nWorkLen * sizeof(*pnSplitFirst));
+			pnSplitLast = (unsigned int*)malloc(nWorkLen * sizeof(*pnSplitLast));
+			pnCornerNext = (unsigned int*)malloc(nWorkLen * sizeof(*pnCornerNext));
+			pdSplitSpread = (double*)malloc(nWorkLen * 2 * sizeof(*pdSplitSpread));
+			_ASSERT(pnSplitFirst && pnSplitLast && pnCornerNext && pdSplitSpread);
+		}
+
+		for(unsigned int i = 0; i < nCornerNum; ++i)
+		{
+			const PVRTVECTOR3f &vTan = gen.pvCornerTan[pnCorners[i]];
+			const PVRTVECTOR3f &vBin = gen.pvCornerBin[pnCorners[i]];
+			double dTanAngle = 0.0, dBinAngle = 0.0;
+			unsigned int nSplit, j;
+
+			// Run through the split vertices to find one whose corners all match this corner
+			for(nSplit = 0; nSplit < nSplitNum; ++nSplit)
+			{
+				j = pnSplitFirst[nSplit];
+				if(PVRTMatrixVec3DotProductF(vTan, gen.pvCornerTan[pnCorners[j]]) < gen.fSplitDifference)
+					continue;
+				if(PVRTMatrixVec3DotProductF(vBin, gen.pvCornerBin[pnCorners[j]]) < gen.fSplitDifference)
+					continue;
+
+				// Skip the other corners if they are all close enough to the first to be sure to match
+				dTanAngle = PVRTVertexAngleBetween(vTan, gen.pvCornerTan[pnCorners[j]]);
+				dBinAngle = PVRTVertexAngleBetween(vBin, gen.pvCornerBin[pnCorners[j]]);
+				double dTanReach = dTanAngle + pdSplitSpread[2 * nSplit + 0];
+				double dBinReach = dBinAngle + pdSplitSpread[2 * nSplit + 1];
+				if(dTanReach < dPi && cos(dTanReach) - dMargin >= gen.fSplitDifference &&
+				   dBinReach < dPi && cos(dBinReach) - dMargin >= gen.fSplitDifference)
+					break;
+
+				for(j = pnCornerNext[j]; j != nEnd; j = pnCornerNext[j])
+				{
+					if(PVRTMatrixVec3DotProductF(vTan, gen.pvCornerTan[pnCorners[j]]) < gen.fSplitDifference)
+						break;
+					if(PVRTMatrixVec3DotProductF(vBin, gen.pvCornerBin[pnCorners[j]]) < gen.fSplitDifference)
+						break;
+				}
+				if(j == nEnd)
+					break;
+			}
+
+			if(nSplit == nSplitNum)
+			{
+				pnSplitFirst[nSplitNum++] = i;
+				pdSplitSpread[2 * nSplit + 0] = 0.0;
+				pdSplitSpread[2 * nSplit + 1] = 0.0;
+			}
+			else
+			{
+				// A NaN angle spreads the split vertex to NaN, so its corners are always compared
+				pnCornerNext[pnSplitLast[nSplit]] = i;
+				if(!(dTanAngle <= pdSplitSpread[2 * nSplit + 0]))
+					pdSplitSpread[2 * nSplit + 0] = dTanAngle;
+				if(!(dBinAngle <= pdSplitSpread[2 * nSplit + 1]))
+					pdSplitSpread[2 * nSplit + 1] = dBinAngle;
+			}
+			pnSplitLast[nSplit] = i;
+			pnCornerNext[i] = nEnd;
+			gen.pnCornerSplit[pnCorners[i]] = nSplit;
+		}
+
+		gen.pnVtxSplitNum[nVert] = nSplitNum;
+	}
+
+	FREE(pnSplitFirst);
+	FREE(pnSplitLast);
+	FREE(pnCornerNext);
+	FREE(pdSplitSpread);
+}
+
 /*!***************************************************************************
  @Function			PVRTVertexGenerateTangentSpace
  @Output			pnVtxNumOut			Output vertex count
@@ -587,6 +819,14 @@ void PVRTVertexTangentBitangent(
 					uses fSplitDifference - of the DP3 of two desired
 					tangents or two desired bitangents is higher than this,
 					the vertex will be split.
+
+					There is no limit on the number of triangles that may
+					share a vertex, or on the number of times a vertex may
+					be split. Tangents are calculated per triangle corner,
+					and split decisions are made independently per vertex,
+					so both stages are run across ranges of triangles and
+					vertices concurrently where the platform supports it.
+					// patched for Cocos3D by Bill Hollings
 *****************************************************************************/
 EPVRTError PVRTVertexGenerateTangentSpace(
 	unsigned int	* const pnVtxNumOut,
@@ -608,219 +848,143 @@ EPVRTError PVRTVertexGenerateTangentSpace(
 	const unsigned int	nTriNum,
 	const float		fSplitDifference)
 {
-	const int cnMaxSharedVtx = 32;
-	struct SVtxData
-	{
-		int				n;							// Number of items in following arrays, AKA number of tris using this vtx
-		PVRTVECTOR3f	pvTan[cnMaxSharedVtx];		// Tangent (one per triangle referencing this vtx)
-		PVRTVECTOR3f	pvBin[cnMaxSharedVtx];		// Bitangent (one per triangle referencing this vtx)
-		int				pnTri[cnMaxSharedVtx];		// Triangle index (one per triangle referencing this vtx)
-	};
-	SVtxData		*psVtxData;		// Array of desired tangent spaces per vertex
-	SVtxData		*psTSpass;		// Array of *different* tangent spaces desired for current vertex
-	unsigned int	nTSpassLen;
-	SVtxData		*psVtx, *psCmp;
-	unsigned int	nVert, nCurr, i, j;	// Loop counters
-	unsigned int	nIdx0, nIdx1, nIdx2;
-	float			pfPos0[4], pfPos1[4], pfPos2[4];
-	float			pfTex0[4], pfTex1[4], pfTex2[4];
-	float			pfNor0[4], pfNor1[4], pfNor2[4];
-	unsigned int	*pui32IdxNew;		// New index array, this will be copied over the input array
+	SPVRTTangentSpaceGen	gen;
+	unsigned int			*pnVtxSplitStart;	// Index of the first output vertex of each input vertex
+	PVRTVECTOR3f			*pvSplitSum;		// Tangent & bitangent sums, two per output vertex
+	unsigned int			nVert, nCorner, nCornerNum = nTriNum * 3;
+	float					pfTan[4], pfBin[4];
 
 	// Initialise the outputs
 	*pnVtxNumOut	= 0;
-	*pVtxOut		= (char*)malloc(MAX_VERTEX_OUT * nStride);
-	if(!*pVtxOut)
-	{
-		return PVR_FAIL;
-	}
-
-	// Allocate some work space
-	pui32IdxNew		= (unsigned int*)calloc(nTriNum * 3, sizeof(*pui32IdxNew));
-	_ASSERT(pui32IdxNew);
-	psVtxData		= (SVtxData*)calloc(nVtxNum, sizeof(*psVtxData));
-	_ASSERT(psVtxData);
-	psTSpass		= (SVtxData*)calloc(cnMaxSharedVtx, sizeof(*psTSpass));
-	_ASSERT(psTSpass);
-	if(!pui32IdxNew || !psVtxData || !psTSpass)
-	{
-		free(pui32IdxNew);
-		free(psVtxData);
-		free(psTSpass);
-		return PVR_FAIL;
-	}
-
-	for(nCurr = 0; nCurr < nTriNum; ++nCurr) {
-		nIdx0 = pui32Idx[3*nCurr+0];
-		nIdx1 = pui32Idx[3*nCurr+1];
-		nIdx2 = pui32Idx[3*nCurr+2];
+	*pVtxOut		= NULL;
 
-		_ASSERT(nIdx0 < nVtxNum);
-		_ASSERT(nIdx1 < nVtxNum);
-		_ASSERT(nIdx2 < nVtxNum);
+	for(nCorner = 0; nCorner < nCornerNum; nCorner += 3) {
+		_ASSERT(pui32Idx[nCorner+0] < nVtxNum);
+		_ASSERT(pui32Idx[nCorner+1] < nVtxNum);
+		_ASSERT(pui32Idx[nCorner+2] < nVtxNum);
 
-		if(nIdx0 == nIdx1 || nIdx1 == nIdx2 || nIdx0 == nIdx2) {
+		if(pui32Idx[nCorner+0] == pui32Idx[nCorner+1] || pui32Idx[nCorner+1] == pui32Idx[nCorner+2] || pui32Idx[nCorner+0] == pui32Idx[nCorner+2]) {
 			_RPT0(_CRT_WARN,"GenerateTangentSpace(): Degenerate triangle found.\n");
 			return PVR_FAIL;
 		}
-
-		if(
-			psVtxData[nIdx0].n >= cnMaxSharedVtx ||
-			psVtxData[nIdx1].n >= cnMaxSharedVtx ||
-			psVtxData[nIdx2].n >= cnMaxSharedVtx)
-		{
-			_RPT0(_CRT_WARN,"GenerateTangentSpace(): Too many tris sharing a vtx.\n");
-			return PVR_FAIL;
-		}
-
-		PVRTVertexRead((PVRTVECTOR4f*) &pfPos0[0], (char*)&pVtx[nIdx0 * nStride] + nOffsetPos, eTypePos, 3);
-		PVRTVertexRead((PVRTVECTOR4f*) &pfPos1[0], (char*)&pVtx[nIdx1 * nStride] + nOffsetPos, eTypePos, 3);
-		PVRTVertexRead((PVRTVECTOR4f*) &pfPos2[0], (char*)&pVtx[nIdx2 * nStride] + nOffsetPos, eTypePos, 3);
-
-		PVRTVertexRead((PVRTVECTOR4f*) &pfNor0[0], (char*)&pVtx[nIdx0 * nStride] + nOffsetNor, eTypeNor, 3);
-		PVRTVertexRead((PVRTVECTOR4f*) &pfNor1[0], (char*)&pVtx[nIdx1 * nStride] + nOffsetNor, eTypeNor, 3);
-		PVRTVertexRead((PVRTVECTOR4f*) &pfNor2[0], (char*)&pVtx[nIdx2 * nStride] + nOffsetNor, eTypeNor, 3);
-
-		PVRTVertexRead((PVRTVECTOR4f*) &pfTex0[0], (char*)&pVtx[nIdx0 * nStride] + nOffsetTex, eTypeTex, 3);
-		PVRTVertexRead((PVRTVECTOR4f*) &pfTex1[0], (char*)&pVtx[nIdx1 * nStride] + nOffsetTex, eTypeTex, 3);
-		PVRTVertexRead((PVRTVECTOR4f*) &pfTex2[0], (char*)&pVtx[nIdx2 * nStride] + nOffsetTex, eTypeTex, 3);
-
-		PVRTVertexTangentBitangent(
-			&psVtxData[nIdx0].pvTan[psVtxData[nIdx0].n],
-			&psVtxData[nIdx0].pvBin[psVtxData[nIdx0].n],
-			(PVRTVECTOR3f*) &pfNor0[0],
-			pfPos0, pfPos1, pfPos2,
-			pfTex0, pfTex1, pfTex2);
-
-		PVRTVertexTangentBitangent(
-			&psVtxData[nIdx1].pvTan[psVtxData[nIdx1].n],
-			&psVtxData[nIdx1].pvBin[psVtxData[nIdx1].n],
-			(PVRTVECTOR3f*) &pfNor1[0],
-			pfPos1, pfPos2, pfPos0,
-			pfTex1, pfTex2, pfTex0);
-
-		PVRTVertexTangentBitangent(
-			&psVtxData[nIdx2].pvTan[psVtxData[nIdx2].n],
-			&psVtxData[nIdx2].pvBin[psVtxData[nIdx2].n],
-			(PVRTVECTOR3f*) &pfNor2[0],
-			pfPos2, pfPos0, pfPos1,
-			pfTex2, pfTex0, pfTex1);
-
-		psVtxData[nIdx0].pnTri[psVtxData[nIdx0].n] = nCurr;
-		psVtxData[nIdx1].pnTri[psVtxData[nIdx1].n] = nCurr;
-		psVtxData[nIdx2].pnTri[psVtxData[nIdx2].n] = nCurr;
-
-		++psVtxData[nIdx0].n;
-		++psVtxData[nIdx1].n;
-		++psVtxData[nIdx2].n;
 	}
 
-	// Now let's go through the vertices calculating avg tangent-spaces; create new vertices if necessary
-	for(nVert = 0; nVert < nVtxNum; ++nVert) {
-		psVtx = &psVtxData[nVert];
-
-		// Start out with no output vertices required for this input vertex
-		nTSpassLen = 0;
-
-		// Run through each desired tangent space for this vertex
-		for(nCurr = 0; nCurr < (unsigned int) psVtx->n; ++nCurr) {
-			// Run through the possible vertices we can share with to see if we match
-			for(i = 0; i < nTSpassLen; ++i) {
-				psCmp = &psTSpass[i];
-
-				// Check all the shared vertices which match
-				for(j = 0; j < (unsigned int) psCmp->n; ++j) {
-					if(PVRTMatrixVec3DotProductF(psVtx->pvTan[nCurr], psCmp->pvTan[j]) < fSplitDifference)
-						break;
-					if(PVRTMatrixVec3DotProductF(psVtx->pvBin[nCurr], psCmp->pvBin[j]) < fSplitDifference)
-						break;
-				}
-
-				// Did all the existing vertices match?
-				if(j == (unsigned int) psCmp->n) {
-					// Yes, so add to list
-					_ASSERT(psCmp->n < cnMaxSharedVtx);
-					psCmp->pvTan[psCmp->n] = psVtx->pvTan[nCurr];
-					psCmp->pvBin[psCmp->n] = psVtx->pvBin[nCurr];
-					psCmp->pnTri[psCmp->n] = psVtx->pnTri[nCurr];
-					++psCmp->n;
-					break;
-				}
-			}
+	gen.pui32Idx			= pui32Idx;
+	gen.pVtx				= pVtx;
+	gen.nStride				= nStride;
+	gen.nOffsetPos			= nOffsetPos;
+	gen.nOffsetNor			= nOffsetNor;
+	gen.nOffsetTex			= nOffsetTex;
+	gen.eTypePos			= eTypePos;
+	gen.eTypeNor			= eTypeNor;
+	gen.eTypeTex			= eTypeTex;
+	gen.nTriNum				= nTriNum;
+	gen.nVtxNum				= nVtxNum;
+	gen.fSplitDifference	= fSplitDifference;
 
-			if(i == nTSpassLen) {
-				// We never found another matching matrix, so let's add this as a different one
-				_ASSERT(nTSpassLen < cnMaxSharedVtx);
-				psTSpass[nTSpassLen].pvTan[0] = psVtx->pvTan[nCurr];
-				psTSpass[nTSpassLen].pvBin[0] = psVtx->pvBin[nCurr];
-				psTSpass[nTSpassLen].pnTri[0] = psVtx->pnTri[nCurr];
-				psTSpass[nTSpassLen].n = 1;
-				++nTSpassLen;
-			}
+	// Allocate some work space
+	gen.pvCornerTan			= (PVRTVECTOR3f*)malloc(nCornerNum * sizeof(*gen.pvCornerTan));
+	gen.pvCornerBin			= (PVRTVECTOR3f*)malloc(nCornerNum * sizeof(*gen.pvCornerBin));
+	gen.pnVtxCornerStart	= (unsigned int*)calloc(nVtxNum + 1, sizeof(*gen.pnVtxCornerStart));
+	gen.pnVtxCorners		= (unsigned int*)malloc(nCornerNum * sizeof(*gen.pnVtxCorners));
+	gen.pnCornerSplit		= (unsigned int*)malloc(nCornerNum * sizeof(*gen.pnCornerSplit));
+	gen.pnVtxSplitNum		= (unsigned int*)malloc(nVtxNum * sizeof(*gen.pnVtxSplitNum));
+	pnVtxSplitStart			= (unsigned int*)malloc((nVtxNum + 1) * sizeof(*pnVtxSplitStart));
+	pvSplitSum				= NULL;
+
+	if(!gen.pvCornerTan || !gen.pvCornerBin || !gen.pnVtxCornerStart || !gen.pnVtxCorners ||
+	   !gen.pnCornerSplit || !gen.pnVtxSplitNum || !pnVtxSplitStart)
+		goto fail;
+
+	// Calculate the tangent space desired by each triangle corner
+	PVRTVertexParallelFor(nTriNum, &gen, PVRTVertexTangentSpaceCorners);
+
+	// Bucket the corners by vertex, keeping the corners of each vertex in triangle order
+	for(nCorner = 0; nCorner < nCornerNum; ++nCorner)
+		++gen.pnVtxCornerStart[pui32Idx[nCorner] + 1];
+	for(nVert = 0; nVert < nVtxNum; ++nVert)
+		gen.pnVtxCornerStart[nVert + 1] += gen.pnVtxCornerStart[nVert];
+	for(nCorner = 0; nCorner < nCornerNum; ++nCorner)
+		gen.pnVtxCorners[gen.pnVtxCornerStart[pui32Idx[nCorner]]++] = nCorner;
+	for(nVert = nVtxNum; nVert > 0; --nVert)
+		gen.pnVtxCornerStart[nVert] = gen.pnVtxCornerStart[nVert - 1];
+	gen.pnVtxCornerStart[0] = 0;
+
+	// Decide how each vertex is split
+	PVRTVertexParallelFor(nVtxNum, &gen, PVRTVertexTangentSpaceSplits);
+
+	// Lay out the output vertices. Vertices not referenced by any triangle are dropped.
+	pnVtxSplitStart[0] = 0;
+	for(nVert = 0; nVert < nVtxNum; ++nVert)
+		pnVtxSplitStart[nVert + 1] = pnVtxSplitStart[nVert] + gen.pnVtxSplitNum[nVert];
+	*pnVtxNumOut = pnVtxSplitStart[nVtxNum];
+
+	*pVtxOut	= (char*)malloc(*pnVtxNumOut * nStride);
+	pvSplitSum	= (PVRTVECTOR3f*)calloc(*pnVtxNumOut * 2, sizeof(*pvSplitSum));
+	if(!*pVtxOut || !pvSplitSum)
+		goto fail;
+
+	// Sum the tangents & bitangents of each split vertex, in triangle order, so we can average them
+	for(nVert = 0; nVert < nVtxNum; ++nVert) {
+		for(unsigned int i = gen.pnVtxCornerStart[nVert]; i < gen.pnVtxCornerStart[nVert + 1]; ++i) {
+			nCorner = gen.pnVtxCorners[i];
+			PVRTVECTOR3f *pvSum = &pvSplitSum[2 * (pnVtxSplitStart[nVert] + gen.pnCornerSplit[nCorner])];
+			pvSum[0].x += gen.pvCornerTan[nCorner].x;
+			pvSum[0].y += gen.pvCornerTan[nCorner].y;
+			pvSum[0].z += gen.pvCornerTan[nCorner].z;
+			pvSum[1].x += gen.pvCornerBin[nCorner].x;
+			pvSum[1].y += gen.pvCornerBin[nCorner].y;
+			pvSum[1].z += gen.pvCornerBin[nCorner].z;
 		}
+	}
 
-		// OK, now we have 'nTSpassLen' different desired matrices, so we need to add that many to output
-		_ASSERT(nTSpassLen >= 1);
-		for(nCurr = 0; nCurr < nTSpassLen; ++nCurr) {
-			psVtx = &psTSpass[nCurr];
-
-			memset(&pfPos0, 0, sizeof(pfPos0));
-			memset(&pfPos1, 0, sizeof(pfPos1));
-
-			for(i = 0; i < (unsigned int) psVtx->n; ++i) {
-				// Sum the tangent & bitangents, so we can average them
-				pfPos0[0] += psVtx->pvTan[i].x;
-				pfPos0[1] += psVtx->pvTan[i].y;
-				pfPos0[2] += psVtx->pvTan[i].z;
-
-				pfPos1[0] += psVtx->pvBin[i].x;
-				pfPos1[1] += psVtx->pvBin[i].y;
-				pfPos1[2] += psVtx->pvBin[i].z;
-
-				// Update triangle indices to use this vtx
-				if(pui32Idx[3 * psVtx->pnTri[i] + 0] == nVert) {
-					pui32IdxNew[3 * psVtx->pnTri[i] + 0] = *pnVtxNumOut;
-
-				} else if(pui32Idx[3 * psVtx->pnTri[i] + 1] == nVert) {
-					pui32IdxNew[3 * psVtx->pnTri[i] + 1] = *pnVtxNumOut;
-
-				} else if(pui32Idx[3 * psVtx->pnTri[i] + 2] == nVert) {
-					pui32IdxNew[3 * psVtx->pnTri[i] + 2] = *pnVtxNumOut;
-
-				} else {
-					_ASSERT(0);
-				}
-			}
-
-			PVRTMatrixVec3NormalizeF(*(PVRTVECTOR3f*) &pfPos0[0], *(PVRTVECTOR3f*) &pfPos0[0]);
-			PVRTMatrixVec3NormalizeF(*(PVRTVECTOR3f*) &pfPos1[0], *(PVRTVECTOR3f*) &pfPos1[0]);
-
-			if(*pnVtxNumOut >= MAX_VERTEX_OUT) {
-				_RPT0(_CRT_WARN,"PVRTVertexGenerateTangentSpace() ran out of working space! (Too many split vertices)\n");
-				return PVR_FAIL;
-			}
-
-			memcpy(&(*pVtxOut)[(*pnVtxNumOut) * nStride], &pVtx[nVert*nStride], nStride);
-			PVRTVertexWrite((char*)&(*pVtxOut)[(*pnVtxNumOut) * nStride] + nOffsetTan, eTypeTan, 3, (PVRTVECTOR4f*) &pfPos0[0]);
-			PVRTVertexWrite((char*)&(*pVtxOut)[(*pnVtxNumOut) * nStride] + nOffsetBin, eTypeBin, 3, (PVRTVECTOR4f*) &pfPos1[0]);
-
-			++*pnVtxNumOut;
+	// Write the output vertices
+	for(nVert = 0; nVert < nVtxNum; ++nVert) {
+		for(unsigned int nOut = pnVtxSplitStart[nVert]; nOut < pnVtxSplitStart[nVert + 1]; ++nOut) {
+			memset(&pfTan, 0, sizeof(pfTan));
+			memset(&pfBin, 0, sizeof(pfBin));
+			memcpy(&pfTan[0], &pvSplitSum[2 * nOut + 0], sizeof(PVRTVECTOR3f));
+			memcpy(&pfBin[0], &pvSplitSum[2 * nOut + 1], sizeof(PVRTVECTOR3f));
+
+			PVRTMatrixVec3NormalizeF(*(PVRTVECTOR3f*) &pfTan[0], *(PVRTVECTOR3f*) &pfTan[0]);
+			PVRTMatrixVec3NormalizeF(*(PVRTVECTOR3f*) &pfBin[0], *(PVRTVECTOR3f*) &pfBin[0]);
+
+			memcpy(&(*pVtxOut)[nOut * nStride], &pVtx[nVert*nStride], nStride);
+			PVRTVertexWrite((char*)&(*pVtxOut)[nOut * nStride] + nOffsetTan, eTypeTan, 3, (PVRTVECTOR4f*) &pfTan[0]);
+			PVRTVertexWrite((char*)&(*pVtxOut)[nOut * nStride] + nOffsetBin, eTypeBin, 3, (PVRTVECTOR4f*) &pfBin[0]);
 		}
 	}
 
-	FREE(psTSpass);
-	FREE(psVtxData);
-
-	*pVtxOut = (char*)realloc(*pVtxOut, *pnVtxNumOut * nStride);
-	_ASSERT(*pVtxOut);
+	// Update triangle indices to use the split vertices
+	for(nCorner = 0; nCorner < nCornerNum; ++nCorner)
+		pui32Idx[nCorner] = pnVtxSplitStart[pui32Idx[nCorner]] + gen.pnCornerSplit[nCorner];
 
-	memcpy(pui32Idx, pui32IdxNew, nTriNum * 3 * sizeof(*pui32IdxNew));
-	FREE(pui32IdxNew);
+	FREE(gen.pvCornerTan);
+	FREE(gen.pvCornerBin);
+	FREE(gen.pnVtxCornerStart);
+	FREE(gen.pnVtxCorners);
+	FREE(gen.pnCornerSplit);
+	FREE(gen.pnVtxSplitNum);
+	FREE(pnVtxSplitStart);
+	FREE(pvSplitSum);
 
 	_RPT3(_CRT_WARN, "GenerateTangentSpace(): %d tris, %d vtx in, %d vtx out\n", nTriNum, nVtxNum, *pnVtxNumOut);
 	_ASSERT(*pnVtxNumOut >= nVtxNum);
 
 	return PVR_SUCCESS;
+
+fail:
+	FREE(gen.pvCornerTan);
+	FREE(gen.pvCornerBin);
+	FREE(gen.pnVtxCornerStart);
+	FREE(gen.pnVtxCorners);
+	FREE(gen.pnCornerSplit);
+	FREE(gen.pnVtxSplitNum);
+	FREE(pnVtxSplitStart);
+	FREE(pvSplitSum);
+	FREE(*pVtxOut);
+	*pnVtxNumOut = 0;
+	return PVR_FAIL;
 }
 
 /*****************************************************************************
@@ -149,6 +149,9 @@ void PVRTVertexTangentBitangent(
 					uses fSplitDifference - of the DP3 of two desired
 					tangents or two desired bitangents is higher than this,
 					the vertex will be split.
+					There is no limit on the number of triangles that may
+					share a vertex, or on the number of splits per vertex.
+					(patched for Cocos3D by Bill Hollings)
 *****************************************************************************/
 EPVRTError PVRTVertexGenerateTangentSpace(
 	unsigned int	* const pnVtxNumOut,
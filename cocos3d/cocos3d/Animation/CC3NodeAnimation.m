@@ -30,6 +30,7 @@
  */
 
 #import "CC3NodeAnimation.h"
+#import "CC3FrameRecording.h"
 
 
 #pragma mark -
@@ -592,6 +593,7 @@ static CCTime _interpolationEpsilon = 0.1f;
 -(void) setIsEnabled: (BOOL) isEnabled {
 	_isEnabled = isEnabled;
 	[self markDirty];
+	CC3FrameRecord(kCC3FrameEventAnimationEnabled, _node, _trackID, isEnabled);
 }
 
 -(void) enable { self.isEnabled = YES; }
@@ -603,6 +605,7 @@ static CCTime _interpolationEpsilon = 0.1f;
 -(void) setBlendingWeight: (GLfloat) blendingWeight {
 	_blendingWeight = CLAMP(blendingWeight, 0.0f, 1.0f);
 	[self markDirty];
+	CC3FrameRecord(kCC3FrameEventAnimationBlendingWeight, _node, _trackID, _blendingWeight);
 }
 
 -(CC3Vector) location { return _location; }
@@ -648,6 +651,7 @@ static CCTime _interpolationEpsilon = 0.1f;
 -(void) establishFrameAt: (CCTime) t {
 	_animationTime = t;
 	if (self.isEnabled) [_animation establishFrameAt: t inNodeAnimationState: self];
+	CC3FrameRecord(kCC3FrameEventAnimationTime, _node, _trackID, t);
 }
 
 
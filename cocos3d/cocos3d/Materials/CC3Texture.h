@@ -36,6 +36,24 @@
 #import "CC3CC2Extensions.h"
 
 
+/**
+ * Enumeration of the filters that can be used to generate the levels of a mipmap.
+ *
+ * The box, Kaiser and Lanczos filters generate the mipmap on the CPU, using the texture
+ * content in main memory. The Kaiser and Lanczos filters are windowed sinc filters that
+ * retain more detail in each level than a box filter, at a higher processing cost.
+ */
+typedef enum {
+	kCC3MipmapFilterGL,				/**< The mipmap is generated by the GL engine. */
+	kCC3MipmapFilterBox,			/**< Each pixel is the average of a 2x2 block of the level above. */
+	kCC3MipmapFilterKaiser,			/**< A Kaiser-windowed sinc filter, with a radius of three pixels. */
+	kCC3MipmapFilterLanczos,		/**< A three-lobed Lanczos filter. */
+} CC3MipmapFilter;
+
+/** Returns a string representation of the specified mipmap filter. */
+NSString* NSStringFromCC3MipmapFilter(CC3MipmapFilter filter);
+
+
 #pragma mark -
 #pragma mark CC3Texture
 
@@ -376,6 +394,10 @@
  *
  * Mipmaps can only be generated for textures whose width and height are are a power-of-two
  * (see the isPOT property).
+ *
+ * Because the texture content is no longer held in main memory once it has been loaded into
+ * the GL engine, this method always generates the mipmap within the GL engine. To generate
+ * the mipmap on the CPU, see the class-side mipmapFilter property.
  */
 -(void) generateMipmap;
 
@@ -409,6 +431,92 @@
  */
 +(void) setShouldGenerateMipmaps: (BOOL) shouldMipmap;
 
+/**
+ * Returns the filter used to generate the mipmap for each instance when the texture is loaded,
+ * if the class-side shouldGenerateMipmaps property is YES.
+ *
+ * If this property is set to kCC3MipmapFilterGL, the mipmap is generated by the GL engine, using
+ * a filter chosen by the GL driver. Otherwise, the levels of the mipmap are generated on the CPU
+ * from the texture content, using the specified filter, as the texture content is loaded. This
+ * allows the mipmap to be generated on the thread that loads the texture, which may be a background
+ * thread, and produces the same mipmap on all platforms. CPU mipmap generation is supported for
+ * content whose pixel type is GL_UNSIGNED_BYTE. Mipmaps for textures with other pixel types, and
+ * mipmaps created by invoking the generateMipmap method, are generated by the GL engine.
+ *
+ * The value of this property affects all textures loaded while that value is in effect.
+ * You can set this property to the desired value prior to loading one or more textures.
+ *
+ * The default value of this class-side property is kCC3MipmapFilterGL.
+ */
++(CC3MipmapFilter) mipmapFilter;
+
+/**
+ * Sets the filter used to generate the mipmap for each instance when the texture is loaded.
+ *
+ * See the notes of the mipmapFilter property for more information.
+ */
++(void) setMipmapFilter: (CC3MipmapFilter) filter;
+
+/**
+ * Returns whether the color content of textures is treated as sRGB-encoded when mipmaps are
+ * generated on the CPU.
+ *
+ * If this property is set to YES, color components are converted to linear space before being
+ * filtered, and converted back to sRGB afterwards. This avoids the darkening of successive mipmap
+ * levels that results from averaging gamma-encoded colors. Alpha components are always filtered
+ * linearly.
+ *
+ * Only textures that hold sRGB-encoded color content, such as diffuse color maps, should be loaded
+ * while this property is set to YES. Textures that hold linear or non-color content, such as normal
+ * maps, roughness maps and other data maps, would be filtered incorrectly. To generate sRGB mipmaps
+ * for color textures, set this property to YES before loading those textures, and set it back to
+ * NO before loading any other textures.
+ *
+ * This property has no effect if the class-side mipmapFilter property is kCC3MipmapFilterGL.
+ *
+ * The value of this property affects all textures loaded while that value is in effect.
+ * You can set this property to the desired value prior to loading one or more textures.
+ *
+ * The default value of this class-side property is NO.
+ */
++(BOOL) shouldGenerateSRGBMipmaps;
+
+/**
+ * Sets whether the color content of textures is treated as sRGB-encoded when mipmaps are
+ * generated on the CPU.
+ *
+ * See the notes of the shouldGenerateSRGBMipmaps property for more information.
+ */
++(void) setShouldGenerateSRGBMipmaps: (BOOL) shouldGenerateSRGB;
+
+/**
+ * Returns the alpha test cutoff value whose coverage is preserved when mipmaps are generated
+ * on the CPU.
+ *
+ * Filtering the alpha component of alpha-tested content, such as foliage or fences, reduces the
+ * fraction of pixels that pass the alpha test in each successive mipmap level, causing that
+ * content to thin out and disappear in the distance. If this property is set to a value greater
+ * than zero, the alpha values of each mipmap level are scaled so that the same fraction of pixels
+ * in each level has an alpha value above this cutoff as in the original texture content.
+ *
+ * This property has no effect if the class-side mipmapFilter property is kCC3MipmapFilterGL.
+ *
+ * The value of this property affects all textures loaded while that value is in effect.
+ * You can set this property to the desired value prior to loading one or more textures.
+ *
+ * The default value of this class-side property is zero, indicating that alpha coverage is not
+ * preserved, and the alpha component is filtered in the same way as the color components.
+ */
++(GLfloat) mipmapAlphaCoverageCutoff;
+
+/**
+ * Sets the alpha test cutoff value whose coverage is preserved when mipmaps are generated
+ * on the CPU.
+ *
+ * See the notes of the mipmapAlphaCoverageCutoff property for more information.
+ */
++(void) setMipmapAlphaCoverageCutoff: (GLfloat) alphaCutoff;
+
 
 #pragma mark Texture parameters
 
@@ -1268,6 +1376,34 @@
 /** Removes this texture instance from the cache. */
 -(void) remove;
 
+/**
+ * Returns the number of bytes of application memory occupied by this texture.
+ *
+ * Once loaded into the GL engine, texture content is not retained in application memory,
+ * so this property returns zero.
+ */
+@property(nonatomic, readonly) NSUInteger applicationMemoryBytes;
+
+/**
+ * Returns an estimate of the number of bytes of GL memory occupied by this texture,
+ * taking into consideration the size and pixel format of the texture, the faces of a
+ * cube-map texture, and the full chain of mipmap levels, if this texture has a mipmap.
+ *
+ * Block-compressed pixel formats, such as PVRTC and ETC, are sized from their compression blocks.
+ * Textures loaded from PVR files report the exact size of the texture data in the PVR file.
+ */
+@property(nonatomic, readonly) NSUInteger glMemoryBytes;
+
+/**
+ * Returns an estimate of the number of bytes of memory occupied by this texture.
+ *
+ * This value is the sum of the applicationMemoryBytes and glMemoryBytes properties, and is
+ * used by the texture cache to track memory usage and enforce any byteBudget that has been
+ * set on the cache. The texture cache is notified automatically when this value changes as
+ * a result of loading content, generating a mipmap, or resizing this texture.
+ */
+@property(nonatomic, readonly) NSUInteger cacheCost;
+
 /**
  * Adds the specified texture to the collection of loaded textures.
  *
@@ -1340,6 +1476,17 @@
  */
 +(NSString*) cachedTexturesDescription;
 
+/**
+ * Returns the cache holding the loaded textures.
+ *
+ * You can use the returned cache to set a byteBudget on the memory used by cached textures,
+ * and to retrieve statistics about the effectiveness of the cache. While the cache has a budget,
+ * it also retains recently used textures, so that they remain cached after they have been released
+ * elsewhere, and releases the least recently used of them, along with strongly cached
+ * (pre-loaded) textures, to remain within the budget.
+ */
++(CC3Cache*) textureCache;
+
 @end
 
 
@@ -1446,7 +1593,9 @@
  * of the instance returned by an instance creation or initialization method may be different
  * than the receiver of that method.
  */
-@interface CC3TextureCube : CC3Texture
+@interface CC3TextureCube : CC3Texture {
+	GLubyte _facesWithMipmap;
+}
 
 
 #pragma mark Texture file loading
@@ -1504,6 +1653,10 @@
  * If this instance has not been assigned a name, it is set to the unqualified file name
  * of the specified posXFilePath file path.
  *
+ * The six files are decoded concurrently by the worker pool of the CC3Backgrounder, and
+ * the decoded content is then loaded into OpenGL on the thread that invokes this method.
+ * This method must therefore not be invoked from within a CC3BackgroundTask.
+ *
  * If the class-side shouldGenerateMipmaps property is set to YES, a mipmap will be generated
  * for the texture automatically.
  *
@@ -1792,6 +1945,35 @@
 -(void) deleteImageData;
 
 
+#pragma mark Mipmaps
+
+/**
+ * Generates the levels of a mipmap from the image content of this instance, on the CPU, and
+ * returns an array of CC3Texture2DContent instances, one for each mipmap level below this one,
+ * ordered from largest to smallest, and ending with a level that is one pixel in size.
+ *
+ * Each level is half the width and height of the level above it, and is filtered from the
+ * level above it using the specified filter. Pixels beyond the edges of each level are treated
+ * as repeating the edge pixels. The rows of each level are filtered concurrently.
+ *
+ * If isSRGB is YES, color components are converted to linear space for filtering, and back
+ * to sRGB afterwards. If alphaCutoff is greater than zero, the alpha values of each level are
+ * scaled so that each level contains the same fraction of pixels with alpha values above that
+ * cutoff as this content does. See the shouldGenerateSRGBMipmaps and mipmapAlphaCoverageCutoff
+ * class-side properties of CC3Texture for more information.
+ *
+ * This method does not access the GL engine, and may be invoked on any thread. The returned
+ * levels can be loaded into the GL engine using the loadTexureImage:intoTarget:onMipmapLevel:...
+ * method of CC3OpenGL.
+ *
+ * Returns nil if this instance has no image content, if the pixel type is not GL_UNSIGNED_BYTE,
+ * or if the specified filter is kCC3MipmapFilterGL.
+ */
+-(NSArray*) mipmapContentWithFilter: (CC3MipmapFilter) filter
+							 isSRGB: (BOOL) isSRGB
+				alphaCoverageCutoff: (GLfloat) alphaCutoff;
+
+
 #pragma mark Allocation and Initialization
 
 /**
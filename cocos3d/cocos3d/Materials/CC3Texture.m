@@ -34,6 +34,18 @@
 #import "CC3CC2Extensions.h"
 #import "CC3ShaderSemantics.h"
 #import "CC3STBImage.h"
+#import "CC3Backgrounder.h"
+
+
+NSString* NSStringFromCC3MipmapFilter(CC3MipmapFilter filter) {
+	switch (filter) {
+		case kCC3MipmapFilterGL: return @"kCC3MipmapFilterGL";
+		case kCC3MipmapFilterBox: return @"kCC3MipmapFilterBox";
+		case kCC3MipmapFilterKaiser: return @"kCC3MipmapFilterKaiser";
+		case kCC3MipmapFilterLanczos: return @"kCC3MipmapFilterLanczos";
+		default: return [NSString stringWithFormat: @"Unknown mipmap filter (%u)", filter];
+	}
+}
 
 
 #pragma mark -
@@ -164,7 +176,9 @@
 			   withType: _pixelType
 	  withByteAlignment: self.byteAlignment
 					 at: tuIdx];
+	[self loadMipmapFromContent: texContent intoTarget: target at: tuIdx usingGL: gl];
 	[self bindTextureParametersAt: tuIdx usingGL: gl];
+	[self updateCacheCost];
 }
 
 -(GLuint) byteAlignment {
@@ -232,10 +246,65 @@
 	_hasMipmap = YES;
 
 	[self markTextureParametersDirty];
+	[self updateCacheCost];
 
 	LogRez(@"%@ generated mipmap in %.3f ms", self, GetRezActivityDuration() * 1000);
 }
 
+/** Returns the GL byte alignment of rows containing the specified number of bytes. */
+static GLint CC3ByteAlignmentForRowLength(GLuint bytesPerRow) {
+	return CC3IntIsEven(bytesPerRow) ? (CC3IntIsEven(bytesPerRow / 2) ? 4 : 2) : 1;
+}
+
+/**
+ * Records whether mipmap levels were generated on the CPU and loaded into the specified target.
+ * For a texture with a single target, this sets the hasMipmap property directly. Subclasses with
+ * several targets, such as cube maps, will override to combine the result across the targets.
+ */
+-(void) setHasMipmap: (BOOL) hasMipmap forTarget: (GLenum) target { _hasMipmap = hasMipmap; }
+
+/**
+ * If mipmaps are to be generated on the CPU when the texture is loaded, generates the levels
+ * of the mipmap from the specified content, and loads them into the specified target.
+ *
+ * If the mipmap levels cannot be generated from the content, the hasMipmap property is left
+ * set to NO, so that a subsequent invocation of the generateMipmap method will generate the
+ * mipmap within the GL engine instead.
+ */
+-(void) loadMipmapFromContent: (CCTexture*) texContent
+				   intoTarget: (GLenum) target
+						   at: (GLuint) tuIdx
+					  usingGL: (CC3OpenGL*) gl {
+	CC3MipmapFilter filter = CC3Texture.mipmapFilter;
+	if ( !CC3Texture.shouldGenerateMipmaps || filter == kCC3MipmapFilterGL || !self.isPOT ) return;
+	if ( ![texContent isKindOfClass: CC3Texture2DContent.class] ) return;
+
+	MarkRezActivityStart();
+
+	NSArray* mipLevels = [(CC3Texture2DContent*)texContent mipmapContentWithFilter: filter
+																		   isSRGB: CC3Texture.shouldGenerateSRGBMipmaps
+															  alphaCoverageCutoff: CC3Texture.mipmapAlphaCoverageCutoff];
+	[self setHasMipmap: (mipLevels != nil) forTarget: target];
+	if ( !mipLevels ) return;
+
+	GLint mipLevel = 0;
+	for (CC3Texture2DContent* levelContent in mipLevels) {
+		CC3IntSize levelSize = CC3IntSizeMake((GLint)levelContent.pixelWidth, (GLint)levelContent.pixelHeight);
+		[gl loadTexureImage: levelContent.imageData
+				 intoTarget: target
+			  onMipmapLevel: ++mipLevel
+				   withSize: levelSize
+				 withFormat: _pixelFormat
+				   withType: _pixelType
+		  withByteAlignment: CC3ByteAlignmentForRowLength(levelSize.width * levelContent.bytesPerPixel)
+						 at: tuIdx];
+	}
+	[self markTextureParametersDirty];
+
+	LogRez(@"%@ generated %lu mipmap levels using %@ in %.3f ms", self, (unsigned long)mipLevels.count,
+		   NSStringFromCC3MipmapFilter(filter), GetRezActivityDuration() * 1000);
+}
+
 /** Indicates whether Mipmaps should automatically be generated for any loaded textures. */
 static BOOL _shouldGenerateMipmaps = YES;
 
@@ -243,6 +312,24 @@ static BOOL _shouldGenerateMipmaps = YES;
 
 +(void) setShouldGenerateMipmaps: (BOOL) shouldMipmap  { _shouldGenerateMipmaps = shouldMipmap; }
 
+static CC3MipmapFilter _mipmapFilter = kCC3MipmapFilterGL;
+
++(CC3MipmapFilter) mipmapFilter { return _mipmapFilter; }
+
++(void) setMipmapFilter: (CC3MipmapFilter) filter { _mipmapFilter = filter; }
+
+static BOOL _shouldGenerateSRGBMipmaps = NO;
+
++(BOOL) shouldGenerateSRGBMipmaps { return _shouldGenerateSRGBMipmaps; }
+
++(void) setShouldGenerateSRGBMipmaps: (BOOL) shouldGenerateSRGB { _shouldGenerateSRGBMipmaps = shouldGenerateSRGB; }
+
+static GLfloat _mipmapAlphaCoverageCutoff = 0.0f;
+
++(GLfloat) mipmapAlphaCoverageCutoff { return _mipmapAlphaCoverageCutoff; }
+
++(void) setMipmapAlphaCoverageCutoff: (GLfloat) alphaCutoff { _mipmapAlphaCoverageCutoff = alphaCutoff; }
+
 
 #pragma mark Texture parameters
 
@@ -454,89 +541,13 @@ static ccTexParams _defaultTextureParameters = { GL_LINEAR_MIPMAP_NEAREST, GL_LI
  * the pixels in the incoming 32-bit RGBA format, the conversion is perfomed in-place.
  */
 -(void) convertContent: (ccColor4B*) colorArray ofLength: (GLuint) pixCount {
-	switch (_pixelType) {
-		case GL_UNSIGNED_BYTE:
-			switch (_pixelFormat) {
-				case GL_RGB: {
-					ccColor3B* rgbArray = (ccColor3B*)colorArray;
-					for (GLuint pixIdx = 0; pixIdx < pixCount; pixIdx++)
-						rgbArray[pixIdx] = CCC3BFromCCC4B(colorArray[pixIdx]);
-					break;
-				}
-				case GL_ALPHA: {
-					GLubyte* bArray = (GLubyte*)colorArray;
-					for (GLuint pixIdx = 0; pixIdx < pixCount; pixIdx++)
-						bArray[pixIdx] = colorArray[pixIdx].a;
-					break;
-				}
-				case GL_LUMINANCE: {
-					GLubyte* bArray = (GLubyte*)colorArray;
-					for (GLuint pixIdx = 0; pixIdx < pixCount; pixIdx++) {
-						ccColor4B* pRGBA = colorArray + pixIdx;
-						GLfloat luma = CC3LuminosityBT709(CCColorFloatFromByte(pRGBA->r),
-														  CCColorFloatFromByte(pRGBA->g),
-														  CCColorFloatFromByte(pRGBA->b));
-						bArray[pixIdx] = CCColorByteFromFloat(luma);
-					}
-					break;
-				}
-				case GL_LUMINANCE_ALPHA: {
-					GLushort* usArray = (GLushort*)colorArray;
-					for (GLuint pixIdx = 0; pixIdx < pixCount; pixIdx++) {
-						ccColor4B* pRGBA = colorArray + pixIdx;
-						GLfloat luma = CC3LuminosityBT709(CCColorFloatFromByte(pRGBA->r),
-														  CCColorFloatFromByte(pRGBA->g),
-														  CCColorFloatFromByte(pRGBA->b));
-						usArray[pixIdx] = (((GLushort)CCColorByteFromFloat(luma)  << 8) |
-										   ((GLushort)pRGBA->a));
-					}
-					break;
-				}
-				case GL_RGBA:		// Already in RGBA format so do nothing!
-				default:
-					break;
-			}
-			break;
-		case GL_UNSIGNED_SHORT_5_6_5: {
-			GLushort* usArray = (GLushort*)colorArray;
-			for (GLuint pixIdx = 0; pixIdx < pixCount; pixIdx++) {
-				ccColor4B* pRGBA = colorArray + pixIdx;
-				usArray[pixIdx] = ((((GLushort)pRGBA->r >> 3) << 11) |
-								   (((GLushort)pRGBA->g >> 2) <<  5) |
-								   (((GLushort)pRGBA->b >> 3)));
-			}
-			break;
-		}
-		case GL_UNSIGNED_SHORT_4_4_4_4: {
-			GLushort* usArray = (GLushort*)colorArray;
-			for (GLuint pixIdx = 0; pixIdx < pixCount; pixIdx++) {
-				ccColor4B* pRGBA = colorArray + pixIdx;
-				usArray[pixIdx] = ((((GLushort)pRGBA->r >> 4) << 12) |
-								   (((GLushort)pRGBA->g >> 4) <<  8) |
-								   (((GLushort)pRGBA->b >> 4) <<  4) |
-								   (((GLushort)pRGBA->a >> 4)));
-			}
-			break;
-		}
-		case GL_UNSIGNED_SHORT_5_5_5_1: {
-			GLushort* usArray = (GLushort*)colorArray;
-			for (GLuint pixIdx = 0; pixIdx < pixCount; pixIdx++) {
-				ccColor4B* pRGBA = colorArray + pixIdx;
-				usArray[pixIdx] = ((((GLushort)pRGBA->r >> 3) << 11) |
-								   (((GLushort)pRGBA->g >> 3) <<  6) |
-								   (((GLushort)pRGBA->b >> 3) <<  1) |
-								   (((GLushort)pRGBA->a >> 7)));
-			}
-			break;
-		}
-		default:
-			break;
-	}
+	CC3ConvertRGBA8888Pixels(colorArray, pixCount, _pixelFormat, _pixelType);
 }
 
 -(void) resizeTo: (CC3IntSize) size {
 	_size = size;
 	_hasMipmap = NO;
+	[self updateCacheCost];
 }
 
 
@@ -847,6 +858,28 @@ static GLuint _lastAssignedTextureTag;
 
 static CC3Cache* _textureCache = nil;
 
+-(NSUInteger) applicationMemoryBytes { return 0; }
+
+-(NSUInteger) glMemoryBytes {
+	GLenum pixFmt = self.pixelFormat;
+	GLenum pixType = self.pixelType;
+	CC3IntSize levelSize = self.size;
+	NSUInteger byteCnt = CC3GLImageSize(pixFmt, pixType, levelSize.width, levelSize.height);
+
+	// Add each level of the mipmap chain, since compressed block sizes make levels larger than a quarter of their parent
+	while (self.hasMipmap && (levelSize.width > 1 || levelSize.height > 1)) {
+		levelSize = CC3IntSizeMake(MAX(levelSize.width / 2, 1), MAX(levelSize.height / 2, 1));
+		byteCnt += CC3GLImageSize(pixFmt, pixType, levelSize.width, levelSize.height);
+	}
+	if (self.isTextureCube) byteCnt *= 6;
+	return byteCnt;
+}
+
+-(NSUInteger) cacheCost { return self.applicationMemoryBytes + self.glMemoryBytes; }
+
+/** Notifies the texture cache that the cacheCost of this texture may have changed. */
+-(void) updateCacheCost { [_textureCache updateCostOfObject: self]; }
+
 +(void) ensureCache {
 	if ( !_textureCache ) _textureCache = [[CC3Cache weakCacheForType: @"texture"] retain];
 }
@@ -873,6 +906,11 @@ static CC3Cache* _textureCache = nil;
 	_textureCache.isWeak = !isPreloading;
 }
 
++(CC3Cache*) textureCache {
+	[self ensureCache];
+	return _textureCache;
+}
+
 +(NSString*) cachedTexturesDescription {
 	NSMutableString* desc = [NSMutableString stringWithCapacity: 500];
 	[_textureCache enumerateObjectsUsingBlock: ^(CC3Texture* tex, BOOL* stop) {
@@ -1031,6 +1069,28 @@ static BOOL _defaultShouldFlip2DHorizontallyOnLoad = NO;
 
 -(Class) textureContentClass { return CC3Texture2DContent.class; }
 
+/** Bitmask indicating that all six cube faces have a mipmap. */
+#define kCC3TextureCubeAllFacesMipmapMask	0x3F
+
+/**
+ * Mipmap levels are generated for each face as it is loaded. The cube map has a mipmap only
+ * if every face has one, so the result for each face is tracked separately, and combined.
+ */
+-(void) setHasMipmap: (BOOL) hasMipmap forTarget: (GLenum) target {
+	GLubyte faceBit = 1 << (target - GL_TEXTURE_CUBE_MAP_POSITIVE_X);
+	if (hasMipmap)
+		_facesWithMipmap |= faceBit;
+	else
+		_facesWithMipmap &= ~faceBit;
+	_hasMipmap = (_facesWithMipmap == kCC3TextureCubeAllFacesMipmapMask);
+}
+
+/** Generating the mipmap within the GL engine covers all six faces. */
+-(void) generateMipmap {
+	[super generateMipmap];
+	if (_hasMipmap) _facesWithMipmap = kCC3TextureCubeAllFacesMipmapMask;
+}
+
 /** Default texture parameters for cube maps are different. */
 static ccTexParams _defaultCubeMapTextureParameters = { GL_LINEAR_MIPMAP_NEAREST, GL_LINEAR, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE };
 
@@ -1068,17 +1128,60 @@ static ccTexParams _defaultCubeMapTextureParameters = { GL_LINEAR_MIPMAP_NEAREST
 	return [self loadTarget: faceTarget fromFile: filePath];
 }
 
+#define kCC3TextureCubeFaceCount	6
+
+/**
+ * Decodes the six face files concurrently on the worker pool of the CC3Backgrounder, then binds
+ * the decoded content to the cube faces on this thread, which owns the OpenGL context. A final
+ * task that depends on all six decoding tasks signals this thread once all faces are decoded.
+ */
 -(BOOL) loadFromFilesPosX: (NSString*) posXFilePath negX: (NSString*) negXFilePath
 					 posY: (NSString*) posYFilePath negY: (NSString*) negYFilePath
 					 posZ: (NSString*) posZFilePath negZ: (NSString*) negZFilePath {
+	NSString* filePaths[kCC3TextureCubeFaceCount] = { posXFilePath, negXFilePath,
+													  posYFilePath, negYFilePath,
+													  posZFilePath, negZFilePath };
+	GLenum faceTargets[kCC3TextureCubeFaceCount] = { GL_TEXTURE_CUBE_MAP_POSITIVE_X, GL_TEXTURE_CUBE_MAP_NEGATIVE_X,
+													 GL_TEXTURE_CUBE_MAP_POSITIVE_Y, GL_TEXTURE_CUBE_MAP_NEGATIVE_Y,
+													 GL_TEXTURE_CUBE_MAP_POSITIVE_Z, GL_TEXTURE_CUBE_MAP_NEGATIVE_Z };
+	id faceContents[kCC3TextureCubeFaceCount] = { nil, nil, nil, nil, nil, nil };
+	id* faceContentSlots = faceContents;	// Each decoding task fills its own slot
+	Class contentClass = self.textureContentClass;
+
+	if (!_name) self.name = [self.class textureNameFromFilePath: posXFilePath];
+
+	MarkRezActivityStart();
+
+	CC3Backgrounder* backgrounder = CC3Backgrounder.sharedBackgrounder;
+	NSMutableArray* decodingTasks = [NSMutableArray arrayWithCapacity: kCC3TextureCubeFaceCount];
+	for (NSUInteger faceIdx = 0; faceIdx < kCC3TextureCubeFaceCount; faceIdx++) {
+		NSString* filePath = filePaths[faceIdx];
+		[decodingTasks addObject: [backgrounder runTask: ^(CC3BackgroundTask* task) {
+			faceContentSlots[faceIdx] = [[contentClass alloc] initFromFile: filePath];	// retained
+		} withPriority: kCC3BackgroundTaskPriorityHigh]];
+	}
+
+	dispatch_semaphore_t facesDecoded = dispatch_semaphore_create(0);
+	[backgrounder runTask: ^(CC3BackgroundTask* task) { dispatch_semaphore_signal(facesDecoded); }
+			 withPriority: kCC3BackgroundTaskPriorityHigh
+			  dependingOn: decodingTasks
+			 onCompletion: nil];
+	dispatch_semaphore_wait(facesDecoded, DISPATCH_TIME_FOREVER);
+	dispatch_release(facesDecoded);
+
 	BOOL success = YES;
+	for (NSUInteger faceIdx = 0; faceIdx < kCC3TextureCubeFaceCount; faceIdx++) {
+		id content = faceContents[faceIdx];
+		if (content) {
+			[self bindTextureContent: content toTarget: faceTargets[faceIdx]];
+			[content release];		// Could be big, so get rid of it immediately
+		} else {
+			LogError(@"%@ could not load texture from file %@", self, filePaths[faceIdx]);
+			success = NO;
+		}
+	}
 
-	success &= [self loadCubeFace: GL_TEXTURE_CUBE_MAP_POSITIVE_X fromFile: posXFilePath];
-	success &= [self loadCubeFace: GL_TEXTURE_CUBE_MAP_NEGATIVE_X fromFile: negXFilePath];
-	success &= [self loadCubeFace: GL_TEXTURE_CUBE_MAP_POSITIVE_Y fromFile: posYFilePath];
-	success &= [self loadCubeFace: GL_TEXTURE_CUBE_MAP_NEGATIVE_Y fromFile: negYFilePath];
-	success &= [self loadCubeFace: GL_TEXTURE_CUBE_MAP_POSITIVE_Z fromFile: posZFilePath];
-	success &= [self loadCubeFace: GL_TEXTURE_CUBE_MAP_NEGATIVE_Z fromFile: negZFilePath];
+	LogRez(@"%@ loaded from files %@ to %@ in %.3f ms", self, posXFilePath, negZFilePath, GetRezActivityDuration() * 1000);
 
 	if (success && self.class.shouldGenerateMipmaps) [self generateMipmap];
 	[self checkGLDebugLabel];
@@ -1505,6 +1608,202 @@ static CGFloat _dummyContentScale;
 #	define CC2_TEX_CONTENT_SCALE _dummyContentScale
 #endif	// COCOS2D_VERSION >= 0x030000
 
+/** The radius of the Kaiser and Lanczos mipmap filters, in pixels of the destination level. */
+#define kCC3MipmapSincFilterRadius			3.0f
+
+/** The shape parameter of the Kaiser window used by the Kaiser mipmap filter. */
+#define kCC3MipmapKaiserAlpha				4.0f
+
+/** Mipmap levels holding at least this many floats are filtered concurrently, in groups of rows. */
+#define kCC3MipmapConcurrentFloatCount		(64 * 1024)
+
+/** The number of steps used to search for the alpha scale that preserves alpha-test coverage. */
+#define kCC3MipmapAlphaCoverageSearchSteps	16
+
+static GLfloat CC3Sinc(GLfloat x) {
+	if (fabsf(x) < 1.0e-6f) return 1.0f;
+	x *= (GLfloat)M_PI;
+	return sinf(x) / x;
+}
+
+/** Returns the zeroth-order modified Bessel function of the first kind, which shapes the Kaiser window. */
+static GLfloat CC3BesselI0(GLfloat x) {
+	GLfloat halfX = x * 0.5f;
+	GLfloat sum = 1.0f;
+	GLfloat term = 1.0f;
+	for (GLuint k = 1; k < 32; k++) {
+		term *= (halfX / k) * (halfX / k);
+		sum += term;
+		if (term < sum * 1.0e-8f) break;
+	}
+	return sum;
+}
+
+/** Returns the radius of the specified mipmap filter, in pixels of the destination level. */
+static GLfloat CC3MipmapFilterRadius(CC3MipmapFilter filter) {
+	return (filter == kCC3MipmapFilterBox) ? 0.5f : kCC3MipmapSincFilterRadius;
+}
+
+/** Returns the weight of the specified mipmap filter at the specified distance, in pixels of the destination level. */
+static GLfloat CC3MipmapFilterWeight(CC3MipmapFilter filter, GLfloat x) {
+	GLfloat radius = CC3MipmapFilterRadius(filter);
+	x = fabsf(x);
+	if (x > radius) return 0.0f;
+	switch (filter) {
+		case kCC3MipmapFilterKaiser: {
+			GLfloat t = x / radius;
+			return CC3Sinc(x) * CC3BesselI0(kCC3MipmapKaiserAlpha * sqrtf(1.0f - (t * t))) / CC3BesselI0(kCC3MipmapKaiserAlpha);
+		}
+		case kCC3MipmapFilterLanczos:
+			return CC3Sinc(x) * CC3Sinc(x / radius);
+		default:
+			return 1.0f;
+	}
+}
+
+/** The source pixels, and their weights, that contribute to each destination pixel along one axis. */
+typedef struct {
+	GLint* firstIndices;		/**< The index of the first contributing source pixel of each destination pixel. */
+	GLfloat* weights;			/**< The normalized weights of the tapCount source pixels of each destination pixel. */
+	GLuint tapCount;			/**< The number of source pixels contributing to each destination pixel. */
+} CC3MipmapFilterTaps;
+
+static CC3MipmapFilterTaps CC3MipmapFilterTapsCreate(CC3MipmapFilter filter, GLuint srcLength, GLuint dstLength) {
+	CC3MipmapFilterTaps taps;
+	GLfloat scale = (GLfloat)srcLength / (GLfloat)dstLength;
+	GLfloat srcRadius = CC3MipmapFilterRadius(filter) * scale;
+	taps.tapCount = (GLuint)ceilf(srcRadius * 2.0f) + 1;
+	taps.firstIndices = malloc(dstLength * sizeof(GLint));
+	taps.weights = malloc(dstLength * taps.tapCount * sizeof(GLfloat));
+
+	for (GLuint dstIdx = 0; dstIdx < dstLength; dstIdx++) {
+		GLfloat srcCenter = ((dstIdx + 0.5f) * scale) - 0.5f;
+		GLint firstIdx = (GLint)ceilf(srcCenter - srcRadius);
+		GLfloat* weights = taps.weights + (dstIdx * taps.tapCount);
+		GLfloat weightSum = 0.0f;
+		for (GLuint tapIdx = 0; tapIdx < taps.tapCount; tapIdx++) {
+			weights[tapIdx] = CC3MipmapFilterWeight(filter, ((firstIdx + (GLint)tapIdx) - srcCenter) / scale);
+			weightSum += weights[tapIdx];
+		}
+		for (GLuint tapIdx = 0; tapIdx < taps.tapCount; tapIdx++) weights[tapIdx] /= weightSum;
+		taps.firstIndices[dstIdx] = firstIdx;
+	}
+	return taps;
+}
+
+static void CC3MipmapFilterTapsFree(CC3MipmapFilterTaps taps) {
+	free(taps.firstIndices);
+	free(taps.weights);
+}
+
+/**
+ * Invokes the specified block once for each of the specified number of rows, each of which
+ * involves processing the specified number of floats. Large levels are processed concurrently,
+ * in groups of rows, and this function returns once all rows have been processed.
+ */
+static void CC3MipmapApplyToRows(GLuint rowCount, GLuint floatsPerRow, void (^block)(GLuint rowIdx)) {
+	GLuint rowsPerChunk = MAX(kCC3MipmapConcurrentFloatCount / MAX(floatsPerRow, 1), 1);
+	if (rowsPerChunk >= rowCount) {
+		for (GLuint rowIdx = 0; rowIdx < rowCount; rowIdx++) block(rowIdx);
+		return;
+	}
+	size_t chunkCnt = (rowCount + rowsPerChunk - 1) / rowsPerChunk;
+	dispatch_apply(chunkCnt, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t chunkIdx) {
+		GLuint endIdx = MIN((GLuint)(chunkIdx + 1) * rowsPerChunk, rowCount);
+		for (GLuint rowIdx = (GLuint)chunkIdx * rowsPerChunk; rowIdx < endIdx; rowIdx++) block(rowIdx);
+	});
+}
+
+/** Filters each row of the source texels horizontally into the corresponding row of the destination texels. */
+static void CC3MipmapFilterRows(const GLfloat* srcTexels, GLuint srcWidth, GLuint rowCount,
+								GLfloat* dstTexels, GLuint dstWidth, GLuint compCount,
+								CC3MipmapFilterTaps taps) {
+	CC3MipmapApplyToRows(rowCount, dstWidth * compCount * taps.tapCount, ^(GLuint rowIdx) {
+		const GLfloat* srcRow = srcTexels + (rowIdx * srcWidth * compCount);
+		GLfloat* dstPixel = dstTexels + (rowIdx * dstWidth * compCount);
+		for (GLuint dstIdx = 0; dstIdx < dstWidth; dstIdx++, dstPixel += compCount) {
+			const GLfloat* weights = taps.weights + (dstIdx * taps.tapCount);
+			for (GLuint compIdx = 0; compIdx < compCount; compIdx++) dstPixel[compIdx] = 0.0f;
+			for (GLuint tapIdx = 0; tapIdx < taps.tapCount; tapIdx++) {
+				GLint srcIdx = CLAMP(taps.firstIndices[dstIdx] + (GLint)tapIdx, 0, (GLint)srcWidth - 1);
+				const GLfloat* srcPixel = srcRow + (srcIdx * compCount);
+				for (GLuint compIdx = 0; compIdx < compCount; compIdx++)
+					dstPixel[compIdx] += weights[tapIdx] * srcPixel[compIdx];
+			}
+		}
+	});
+}
+
+/** Filters the rows of the source texels vertically into the rows of the destination texels. */
+static void CC3MipmapFilterColumns(const GLfloat* srcTexels, GLuint srcHeight,
+								   GLfloat* dstTexels, GLuint dstHeight, GLuint floatsPerRow,
+								   CC3MipmapFilterTaps taps) {
+	CC3MipmapApplyToRows(dstHeight, floatsPerRow * taps.tapCount, ^(GLuint dstIdx) {
+		GLfloat* dstRow = dstTexels + (dstIdx * floatsPerRow);
+		const GLfloat* weights = taps.weights + (dstIdx * taps.tapCount);
+		memset(dstRow, 0, floatsPerRow * sizeof(GLfloat));
+		for (GLuint tapIdx = 0; tapIdx < taps.tapCount; tapIdx++) {
+			GLint srcIdx = CLAMP(taps.firstIndices[dstIdx] + (GLint)tapIdx, 0, (GLint)srcHeight - 1);
+			const GLfloat* srcRow = srcTexels + (srcIdx * floatsPerRow);
+			GLfloat weight = weights[tapIdx];
+			for (GLuint fltIdx = 0; fltIdx < floatsPerRow; fltIdx++) dstRow[fltIdx] += weight * srcRow[fltIdx];
+		}
+	});
+}
+
+/** Returns the fraction of the specified texels whose alpha component exceeds the specified cutoff. */
+static GLfloat CC3MipmapAlphaCoverage(const GLfloat* texels, GLuint texelCount, GLuint compCount,
+									  GLuint alphaIdx, GLfloat alphaCutoff) {
+	GLuint passCnt = 0;
+	for (GLuint texIdx = 0; texIdx < texelCount; texIdx++)
+		if (texels[(texIdx * compCount) + alphaIdx] > alphaCutoff) passCnt++;
+	return (GLfloat)passCnt / (GLfloat)texelCount;
+}
+
+/**
+ * Returns the scale that, when applied to the alpha components of the specified texels, results
+ * in the specified fraction of those texels having an alpha component that exceeds the cutoff.
+ */
+static GLfloat CC3MipmapAlphaCoverageScale(const GLfloat* texels, GLuint texelCount, GLuint compCount,
+										   GLuint alphaIdx, GLfloat alphaCutoff, GLfloat coverage) {
+	// Search for the unscaled alpha value that is exceeded by the required fraction of texels
+	GLfloat minAlpha = 0.0f;
+	GLfloat maxAlpha = 1.0f;
+	GLfloat alpha = alphaCutoff;
+	for (GLuint step = 0; step < kCC3MipmapAlphaCoverageSearchSteps; step++) {
+		alpha = (minAlpha + maxAlpha) * 0.5f;
+		if (CC3MipmapAlphaCoverage(texels, texelCount, compCount, alphaIdx, alpha) > coverage)
+			minAlpha = alpha;
+		else
+			maxAlpha = alpha;
+	}
+	return alphaCutoff / MAX(alpha, kCC3OneOver255);
+}
+
+static GLfloat CC3LinearFromSRGB(GLfloat c) {
+	return (c <= 0.04045f) ? (c / 12.92f) : powf((c + 0.055f) / 1.055f, 2.4f);
+}
+
+static GLfloat CC3SRGBFromLinear(GLfloat c) {
+	return (c <= 0.0031308f) ? (c * 12.92f) : ((1.055f * powf(c, 1.0f / 2.4f)) - 0.055f);
+}
+
+/**
+ * Returns the number of components in each pixel of the specified format, and sets the alphaIdx
+ * to the index of the alpha component, or to -1 if there is no alpha component. Returns zero if
+ * the format is not supported for mipmap generation on the CPU.
+ */
+static GLuint CC3MipmapComponentCount(GLenum pixelFormat, GLint* alphaIdx) {
+	switch (pixelFormat) {
+		case GL_RGBA: *alphaIdx = 3; return 4;
+		case GL_RGB: *alphaIdx = -1; return 3;
+		case GL_LUMINANCE_ALPHA: *alphaIdx = 1; return 2;
+		case GL_LUMINANCE: *alphaIdx = -1; return 1;
+		case GL_ALPHA: *alphaIdx = 0; return 1;
+		default: *alphaIdx = -1; return 0;
+	}
+}
+
 @implementation CC3Texture2DContent
 
 -(void) dealloc {
@@ -1546,53 +1845,21 @@ static CGFloat _dummyContentScale;
 -(void) flipHorizontally {
 	if ( !_imageData ) return;		// If no data, nothing to flip!
 
-	GLuint rowCnt = (GLuint)self.pixelHeight;
-	GLuint colCnt = (GLuint)self.pixelWidth;
-	GLuint lastColIdx = colCnt - 1;
-	GLuint halfColCnt = colCnt / 2;
-
-	GLubyte* rowStart = (GLubyte*)_imageData;
 	GLuint bytesPerPixel = self.bytesPerPixel;
-	GLuint bytesPerRow = bytesPerPixel * colCnt;
-	GLubyte tmpPixel[bytesPerPixel];
-	
-	for (GLuint rowIdx = 0; rowIdx < rowCnt; rowIdx++) {
-		for (GLuint colIdx = 0; colIdx < halfColCnt; colIdx++) {
-			GLubyte* firstPixel = rowStart + (bytesPerPixel * colIdx);
-			GLubyte* lastPixel = rowStart + (bytesPerPixel * (lastColIdx - colIdx));
-			memcpy(tmpPixel, firstPixel, bytesPerPixel);
-			memcpy(firstPixel, lastPixel, bytesPerPixel);
-			memcpy(lastPixel, tmpPixel, bytesPerPixel);
-		}
-		rowStart += bytesPerRow;
-	}
+	CC3FlipHorizontally((GLubyte*)_imageData,
+						(GLuint)self.pixelHeight,
+						(GLuint)self.pixelWidth * bytesPerPixel,
+						bytesPerPixel);
 }
 
 -(void) rotateHalfCircle {
 	if ( !_imageData ) return;		// If no data, nothing to rotate!
 	
-	GLuint rowCnt = (GLuint)self.pixelHeight;
-	GLuint lastRowIdx = rowCnt - 1;
-	GLuint halfRowCnt = (rowCnt + 1) / 2;		// Use ceiling to capture any middle row: (A+B-1)/B
-	GLuint colCnt = (GLuint)self.pixelWidth;
-	GLuint lastColIdx = colCnt - 1;
-	
-	GLubyte* pixData = (GLubyte*)_imageData;
 	GLuint bytesPerPixel = self.bytesPerPixel;
-	GLuint bytesPerRow = bytesPerPixel * colCnt;
-	GLubyte tmpPixel[bytesPerPixel];
-	
-	for (GLuint rowIdx = 0; rowIdx < halfRowCnt; rowIdx++) {
-		GLubyte* lowerRow = pixData + (bytesPerRow * rowIdx);
-		GLubyte* upperRow = pixData + (bytesPerRow * (lastRowIdx - rowIdx));
-		for (GLuint colIdx = 0; colIdx < colCnt; colIdx++) {
-			GLubyte* firstPixel = lowerRow + (bytesPerPixel * colIdx);
-			GLubyte* lastPixel = upperRow + (bytesPerPixel * (lastColIdx - colIdx));
-			memcpy(tmpPixel, firstPixel, bytesPerPixel);
-			memcpy(firstPixel, lastPixel, bytesPerPixel);
-			memcpy(lastPixel, tmpPixel, bytesPerPixel);
-		}
-	}
+	CC3RotateHalfCircle((GLubyte*)_imageData,
+						(GLuint)self.pixelHeight,
+						(GLuint)self.pixelWidth * bytesPerPixel,
+						bytesPerPixel);
 	
 	_isUpsideDown = !_isUpsideDown;		// Orientation has changed
 }
@@ -1603,6 +1870,101 @@ static CGFloat _dummyContentScale;
 }
 
 
+#pragma mark Mipmaps
+
+-(NSArray*) mipmapContentWithFilter: (CC3MipmapFilter) filter
+							 isSRGB: (BOOL) isSRGB
+				alphaCoverageCutoff: (GLfloat) alphaCutoff {
+	GLint alphaIdx;
+	GLuint compCnt = CC3MipmapComponentCount(_pixelGLFormat, &alphaIdx);
+	if ( !_imageData || !compCnt || _pixelGLType != GL_UNSIGNED_BYTE || filter == kCC3MipmapFilterGL ) return nil;
+
+	GLuint width = (GLuint)self.pixelWidth;
+	GLuint height = (GLuint)self.pixelHeight;
+	if ( !width || !height ) return nil;
+
+	// Decode the content to floats, converting sRGB color components to linear space
+	GLfloat linearLUT[256];
+	GLfloat srgbLUT[256];
+	for (GLuint byteVal = 0; byteVal < 256; byteVal++) {
+		linearLUT[byteVal] = CCColorFloatFromByte(byteVal);
+		srgbLUT[byteVal] = CC3LinearFromSRGB(linearLUT[byteVal]);
+	}
+	const GLfloat* compLUTs[4];
+	GLuint srgbCompMask = 0;		// Bitmask of the sRGB-encoded color components
+	for (GLuint compIdx = 0; compIdx < compCnt; compIdx++) {
+		if (isSRGB && (GLint)compIdx != alphaIdx) srgbCompMask |= (1 << compIdx);
+		compLUTs[compIdx] = (srgbCompMask & (1 << compIdx)) ? srgbLUT : linearLUT;
+	}
+
+	const GLubyte* srcBytes = _imageData;
+	GLfloat* srcTexels = malloc(width * height * compCnt * sizeof(GLfloat));
+	for (GLuint texIdx = 0, fltIdx = 0; texIdx < width * height; texIdx++)
+		for (GLuint compIdx = 0; compIdx < compCnt; compIdx++, fltIdx++)
+			srcTexels[fltIdx] = compLUTs[compIdx][srcBytes[fltIdx]];
+
+	BOOL shouldPreserveCoverage = (alphaIdx >= 0 && alphaCutoff > 0.0f);
+	GLfloat coverage = shouldPreserveCoverage
+							? CC3MipmapAlphaCoverage(srcTexels, width * height, compCnt, alphaIdx, alphaCutoff)
+							: 1.0f;
+
+	// Each level is filtered from the unquantized floats of the level above it
+	NSMutableArray* mipLevels = [NSMutableArray array];
+	while (width > 1 || height > 1) {
+		GLuint dstWidth = MAX(width / 2, 1);
+		GLuint dstHeight = MAX(height / 2, 1);
+
+		CC3MipmapFilterTaps xTaps = CC3MipmapFilterTapsCreate(filter, width, dstWidth);
+		CC3MipmapFilterTaps yTaps = CC3MipmapFilterTapsCreate(filter, height, dstHeight);
+		GLfloat* rowTexels = malloc(height * dstWidth * compCnt * sizeof(GLfloat));
+		GLfloat* dstTexels = malloc(dstHeight * dstWidth * compCnt * sizeof(GLfloat));
+		CC3MipmapFilterRows(srcTexels, width, height, rowTexels, dstWidth, compCnt, xTaps);
+		CC3MipmapFilterColumns(rowTexels, height, dstTexels, dstHeight, dstWidth * compCnt, yTaps);
+		CC3MipmapFilterTapsFree(xTaps);
+		CC3MipmapFilterTapsFree(yTaps);
+		free(rowTexels);
+		free(srcTexels);
+
+		srcTexels = dstTexels;
+		width = dstWidth;
+		height = dstHeight;
+
+		GLfloat alphaScale = shouldPreserveCoverage
+								? CC3MipmapAlphaCoverageScale(srcTexels, width * height, compCnt,
+															  alphaIdx, alphaCutoff, coverage)
+								: 1.0f;
+
+		// Encode the level back to bytes, converting color components back to sRGB
+		GLuint floatsPerRow = width * compCnt;
+		GLubyte* levelBytes = malloc(height * floatsPerRow);
+		const GLfloat* levelTexels = srcTexels;
+		CC3MipmapApplyToRows(height, floatsPerRow, ^(GLuint rowIdx) {
+			const GLfloat* rowFloats = levelTexels + (rowIdx * floatsPerRow);
+			GLubyte* rowBytes = levelBytes + (rowIdx * floatsPerRow);
+			for (GLuint fltIdx = 0; fltIdx < floatsPerRow; fltIdx++) {
+				GLuint compIdx = fltIdx % compCnt;
+				GLfloat val = CLAMP(rowFloats[fltIdx], 0.0f, 1.0f);
+				if (srgbCompMask & (1 << compIdx)) val = CC3SRGBFromLinear(val);
+				if ((GLint)compIdx == alphaIdx) val = MIN(val * alphaScale, 1.0f);
+				rowBytes[fltIdx] = (GLubyte)((val * 255.0f) + 0.5f);
+			}
+		});
+
+		CC3Texture2DContent* levelContent = [[CC3Texture2DContent alloc] initWithSize: CC3IntSizeMake((GLint)width, (GLint)height)
+																	  withPixelFormat: _pixelGLFormat
+																		withPixelType: _pixelGLType];
+		levelContent->_imageData = levelBytes;
+		levelContent->_isUpsideDown = _isUpsideDown;
+		levelContent->CC2_TEX_HAS_PREMULT_ALPHA = CC2_TEX_HAS_PREMULT_ALPHA;
+		[mipLevels addObject: levelContent];
+		[levelContent release];
+	}
+	free(srcTexels);
+
+	return mipLevels;
+}
+
+
 #pragma mark Allocation and Initialization
 
 #if CC3_CC2_CLASSIC
@@ -29,6 +29,14 @@
  * See header file CC3Matrix3x3.h for full API documentation.
  */
 
+/*
+ * Floating-point contraction is disabled throughout this file, so that the compiler never fuses
+ * a multiply and an add into a single FMA instruction, which rounds only once. The scalar
+ * operations here are used by the scalar implementations of CC3Matrix4x3 and CC3Matrix4x4,
+ * which must produce results identical to their CC3_SIMD implementations on all architectures.
+ */
+#pragma STDC FP_CONTRACT OFF
+
 #import "CC3Matrix3x3.h"
 
 
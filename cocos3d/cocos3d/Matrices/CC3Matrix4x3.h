@@ -351,7 +351,15 @@ static inline CC3Vector CC3Matrix4x3ExtractTranslation(const CC3Matrix4x3* mtx)
 
 #pragma mark Matrix transformations
 
-/** Multiplies mL on the left by mR on the right, and stores the result in mOut. */
+/**
+ * Multiplies mL on the left by mR on the right, and stores the result in mOut.
+ *
+ * When CC3_SIMD is enabled, this function uses NEON or SSE vector instructions. Because
+ * floating-point contraction is disabled when compiling both this function and its scalar
+ * implementation, neither fuses multiplies and adds into FMA instructions, and the result is
+ * bit-for-bit identical to that of the scalar implementation used when CC3_SIMD is disabled.
+ * The CC3Performance benchmark verifies this equivalence, and measures the speedup.
+ */
 void CC3Matrix4x3Multiply(CC3Matrix4x3* mOut, const CC3Matrix4x3* mL, const CC3Matrix4x3* mR);
 
 /**
@@ -402,6 +410,9 @@ static inline void CC3Matrix4x3RotateZYXBy(CC3Matrix4x3* mtx, CC3Vector aRotatio
  *
  * In mathematical terms, the incoming rotation is converted to matrix form, and is
  * left-multiplied to the specified matrix elements.
+ *
+ * Only the multiplication uses the CC3_SIMD path of the CC3Matrix4x3Multiply function.
+ * Converting the quaternion to matrix form remains scalar.
  */
 static inline void CC3Matrix4x3RotateByQuaternion(CC3Matrix4x3* mtx, CC3Quaternion aQuaternion) {
 	CC3Matrix4x3 rotMtx, mRslt;
@@ -453,6 +464,30 @@ CC3Vector CC3Matrix4x3TransformLocation(const CC3Matrix4x3* mtx, CC3Vector v);
  */
 CC3Vector CC3Matrix4x3TransformDirection(const CC3Matrix4x3* mtx, CC3Vector v);
 
+/**
+ * Transforms the specified number of 3D location vectors in place, using the specified matrix.
+ * Each location is transformed as if it was a 4D vector with a W value of 1.
+ *
+ * Consecutive locations are separated by the specified stride, in bytes, allowing the locations
+ * to be interleaved with other vertex content. A stride of zero indicates that the locations are
+ * tightly packed CC3Vectors. Only the first three GLfloats of each location are changed.
+ *
+ * Each transformed location is identical to that returned by CC3Matrix4x3TransformLocation.
+ */
+void CC3Matrix4x3TransformLocations(const CC3Matrix4x3* mtx, GLvoid* locations, GLuint stride, GLuint locationCount);
+
+/**
+ * Transforms the specified number of 3D direction vectors in place, using the specified matrix.
+ * Each direction is transformed as if it was a 4D vector with a W value of 0.
+ *
+ * Consecutive directions are separated by the specified stride, in bytes, allowing the directions
+ * to be interleaved with other vertex content. A stride of zero indicates that the directions are
+ * tightly packed CC3Vectors. Only the first three GLfloats of each direction are changed.
+ *
+ * Each transformed direction is identical to that returned by CC3Matrix4x3TransformDirection.
+ */
+void CC3Matrix4x3TransformDirections(const CC3Matrix4x3* mtx, GLvoid* directions, GLuint stride, GLuint directionCount);
+
 /**
  * Orthonormalizes the rotation component of the specified matrix, using a Gram-Schmidt process,
  * and using the column indicated by the specified column number as the starting point of the
@@ -505,6 +540,9 @@ static inline void CC3Matrix4x3Transpose(CC3Matrix4x3* mtx) {
  * Matrix inversion using the classical adjoint algorithm is computationally-expensive. If it is
  * known that the matrix contains only rotation and translation, use the CC3Matrix4x3InvertRigid
  * function instead, which is some 10 to 100 times faster than this function.
+ *
+ * This function has no CC3_SIMD implementation. It operates on the 3x3 linear matrix, whose
+ * three-element columns do not map onto four-element vector registers without staging.
  */
 static inline BOOL CC3Matrix4x3InvertAdjoint(CC3Matrix4x3* mtx) {
 	CC3Matrix3x3* linMtx = (CC3Matrix3x3*)mtx;
@@ -534,6 +572,9 @@ static inline BOOL CC3Matrix4x3InvertAdjoint(CC3Matrix4x3* mtx) {
  *
  * where LT is the transposed 3x3 linear matrix, and t is the translation vector, both extracted
  * from the 4x3 matrix. For a matrix containing only rigid transforms: L(-1) = LT,
+ *
+ * Unlike CC3Matrix4x4InvertRigid, this function has no CC3_SIMD implementation, for the same
+ * reason as the CC3Matrix4x3InvertAdjoint function.
  */
 static inline void CC3Matrix4x3InvertRigid(CC3Matrix4x3* mtx) {
 	CC3Matrix3x3* linMtx = (CC3Matrix3x3*)mtx;
@@ -29,6 +29,14 @@
  * See header file CC3Matrix4x3.h for full API documentation.
  */
 
+/*
+ * Floating-point contraction is disabled throughout this file, so that the compiler never fuses
+ * a multiply and an add into a single FMA instruction, which rounds only once. Both the scalar
+ * and the CC3_SIMD implementations therefore round each multiply and add separately, and produce
+ * identical results on all architectures, including arm64, where clang contracts by default.
+ */
+#pragma STDC FP_CONTRACT OFF
+
 #import "CC3Matrix4x3.h"
 
 
@@ -101,7 +109,33 @@ void CC3Matrix4x3PopulateInfiniteOrthoFrustum(CC3Matrix4x3* mtx,
 #pragma mark Matrix transformations
 
 void CC3Matrix4x3Multiply(CC3Matrix4x3* mOut, const CC3Matrix4x3* mL, const CC3Matrix4x3* mR) {
-	
+#if CC3_SIMD
+	// Each output column is the sum of the left columns, scaled by the elements of the
+	// corresponding right column, accumulated in the same order as the scalar code. Columns
+	// are three GLfloats, so the fourth element of each load and store spills into the next
+	// column, and is ignored. The last column is staged through four GLfloats to avoid
+	// accessing memory beyond the end of the matrix.
+	GLfloat lastCol[4];
+	CC3SIMDFloat4 lc1 = CC3SIMDFloat4Load(mL->colRow[0]);
+	CC3SIMDFloat4 lc2 = CC3SIMDFloat4Load(mL->colRow[1]);
+	CC3SIMDFloat4 lc3 = CC3SIMDFloat4Load(mL->colRow[2]);
+	CC3SIMDFloat4 oc[kCC3Matrix4x3ColumnCount];
+	for (NSUInteger colIdx = 0; colIdx < kCC3Matrix4x3ColumnCount; colIdx++) {
+		const GLfloat* rc = mR->colRow[colIdx];
+		CC3SIMDFloat4 sum = CC3SIMDFloat4Multiply(lc1, CC3SIMDFloat4Splat(rc[0]));
+		sum = CC3SIMDFloat4Add(sum, CC3SIMDFloat4Multiply(lc2, CC3SIMDFloat4Splat(rc[1])));
+		oc[colIdx] = CC3SIMDFloat4Add(sum, CC3SIMDFloat4Multiply(lc3, CC3SIMDFloat4Splat(rc[2])));
+	}
+	memcpy(lastCol, mL->colRow[3], sizeof(mL->colRow[3]));
+	lastCol[3] = 0.0f;
+	oc[3] = CC3SIMDFloat4Add(oc[3], CC3SIMDFloat4Load(lastCol));
+
+	CC3SIMDFloat4Store(mOut->colRow[0], oc[0]);
+	CC3SIMDFloat4Store(mOut->colRow[1], oc[1]);
+	CC3SIMDFloat4Store(mOut->colRow[2], oc[2]);
+	CC3SIMDFloat4Store(lastCol, oc[3]);
+	memcpy(mOut->colRow[3], lastCol, sizeof(mOut->colRow[3]));
+#else
 	mOut->c1r1 = (mL->c1r1 * mR->c1r1) + (mL->c2r1 * mR->c1r2) + (mL->c3r1 * mR->c1r3);
 	mOut->c1r2 = (mL->c1r2 * mR->c1r1) + (mL->c2r2 * mR->c1r2) + (mL->c3r2 * mR->c1r3);
 	mOut->c1r3 = (mL->c1r3 * mR->c1r1) + (mL->c2r3 * mR->c1r2) + (mL->c3r3 * mR->c1r3);
@@ -117,6 +151,7 @@ void CC3Matrix4x3Multiply(CC3Matrix4x3* mOut, const CC3Matrix4x3* mL, const CC3M
 	mOut->c4r1 = (mL->c1r1 * mR->c4r1) + (mL->c2r1 * mR->c4r2) + (mL->c3r1 * mR->c4r3) + mL->c4r1;
 	mOut->c4r2 = (mL->c1r2 * mR->c4r1) + (mL->c2r2 * mR->c4r2) + (mL->c3r2 * mR->c4r3) + mL->c4r2;
 	mOut->c4r3 = (mL->c1r3 * mR->c4r1) + (mL->c2r3 * mR->c4r2) + (mL->c3r3 * mR->c4r3) + mL->c4r3;
+#endif	// CC3_SIMD
 }
 
 
@@ -124,9 +159,20 @@ void CC3Matrix4x3Multiply(CC3Matrix4x3* mOut, const CC3Matrix4x3* mL, const CC3M
 
 CC3Vector4 CC3Matrix4x3TransformCC3Vector4(const CC3Matrix4x3* mtx, CC3Vector4 v) {
 	CC3Vector4 vOut;
+#if CC3_SIMD
+	GLfloat lastCol[4];
+	memcpy(lastCol, mtx->colRow[3], sizeof(mtx->colRow[3]));
+	lastCol[3] = 0.0f;
+	CC3SIMDFloat4 sum = CC3SIMDFloat4Multiply(CC3SIMDFloat4Load(mtx->colRow[0]), CC3SIMDFloat4Splat(v.x));
+	sum = CC3SIMDFloat4Add(sum, CC3SIMDFloat4Multiply(CC3SIMDFloat4Load(mtx->colRow[1]), CC3SIMDFloat4Splat(v.y)));
+	sum = CC3SIMDFloat4Add(sum, CC3SIMDFloat4Multiply(CC3SIMDFloat4Load(mtx->colRow[2]), CC3SIMDFloat4Splat(v.z)));
+	sum = CC3SIMDFloat4Add(sum, CC3SIMDFloat4Multiply(CC3SIMDFloat4Load(lastCol), CC3SIMDFloat4Splat(v.w)));
+	CC3SIMDFloat4Store(&vOut.x, sum);
+#else
 	vOut.x = (mtx->c1r1 * v.x) + (mtx->c2r1 * v.y) + (mtx->c3r1 * v.z) + (mtx->c4r1 * v.w);
 	vOut.y = (mtx->c1r2 * v.x) + (mtx->c2r2 * v.y) + (mtx->c3r2 * v.z) + (mtx->c4r2 * v.w);
 	vOut.z = (mtx->c1r3 * v.x) + (mtx->c2r3 * v.y) + (mtx->c3r3 * v.z) + (mtx->c4r3 * v.w);
+#endif	// CC3_SIMD
 	vOut.w = v.w;
 	return vOut;
 }
@@ -147,4 +193,45 @@ CC3Vector CC3Matrix4x3TransformDirection(const CC3Matrix4x3* mtx, CC3Vector v) {
 	return vOut;
 }
 
+/**
+ * Transforms the specified vectors in place. If isLocation is YES, the translation column
+ * of the matrix is added to each transformed vector. Four GLfloats are staged for each
+ * vector, but only the first three are written back, leaving interleaved content intact.
+ */
+static inline void CC3Matrix4x3TransformVectors(const CC3Matrix4x3* mtx, GLvoid* vectors,
+												GLuint stride, GLuint vectorCount, BOOL isLocation) {
+	if (stride == 0) stride = sizeof(CC3Vector);
+	GLbyte* pVec = vectors;
+#if CC3_SIMD
+	GLfloat lastCol[4];
+	memcpy(lastCol, mtx->colRow[3], sizeof(mtx->colRow[3]));
+	lastCol[3] = 0.0f;
+	CC3SIMDFloat4 c1 = CC3SIMDFloat4Load(mtx->colRow[0]);
+	CC3SIMDFloat4 c2 = CC3SIMDFloat4Load(mtx->colRow[1]);
+	CC3SIMDFloat4 c3 = CC3SIMDFloat4Load(mtx->colRow[2]);
+	CC3SIMDFloat4 c4 = CC3SIMDFloat4Load(lastCol);
+	CC3Vector4 vOut;
+	for (GLuint vecIdx = 0; vecIdx < vectorCount; vecIdx++, pVec += stride) {
+		CC3Vector* pv = (CC3Vector*)pVec;
+		CC3SIMDFloat4 sum = CC3SIMDFloat4Multiply(c1, CC3SIMDFloat4Splat(pv->x));
+		sum = CC3SIMDFloat4Add(sum, CC3SIMDFloat4Multiply(c2, CC3SIMDFloat4Splat(pv->y)));
+		sum = CC3SIMDFloat4Add(sum, CC3SIMDFloat4Multiply(c3, CC3SIMDFloat4Splat(pv->z)));
+		if (isLocation) sum = CC3SIMDFloat4Add(sum, c4);
+		CC3SIMDFloat4Store(&vOut.x, sum);
+		*pv = vOut.v;
+	}
+#else
+	for (GLuint vecIdx = 0; vecIdx < vectorCount; vecIdx++, pVec += stride) {
+		CC3Vector* pv = (CC3Vector*)pVec;
+		*pv = isLocation ? CC3Matrix4x3TransformLocation(mtx, *pv) : CC3Matrix4x3TransformDirection(mtx, *pv);
+	}
+#endif	// CC3_SIMD
+}
+
+void CC3Matrix4x3TransformLocations(const CC3Matrix4x3* mtx, GLvoid* locations, GLuint stride, GLuint locationCount) {
+	CC3Matrix4x3TransformVectors(mtx, locations, stride, locationCount, YES);
+}
 
+void CC3Matrix4x3TransformDirections(const CC3Matrix4x3* mtx, GLvoid* directions, GLuint stride, GLuint directionCount) {
+	CC3Matrix4x3TransformVectors(mtx, directions, stride, directionCount, NO);
+}
@@ -29,6 +29,14 @@
  * See header file CC3Matrix4x4.h for full API documentation.
  */
 
+/*
+ * Floating-point contraction is disabled throughout this file, so that the compiler never fuses
+ * a multiply and an add into a single FMA instruction, which rounds only once. Both the scalar
+ * and the CC3_SIMD implementations therefore round each multiply and add separately, and produce
+ * identical results on all architectures, including arm64, where clang contracts by default.
+ */
+#pragma STDC FP_CONTRACT OFF
+
 #import "CC3Matrix4x4.h"
 
 
@@ -287,7 +295,24 @@ void CC3Matrix4x4PopulateInfiniteOrthoFrustum(CC3Matrix4x4* mtx,
 #pragma mark Matrix transformations
 
 void CC3Matrix4x4Multiply(CC3Matrix4x4* mOut, const CC3Matrix4x4* mL, const CC3Matrix4x4* mR) {
-	
+#if CC3_SIMD
+	// Each output column is the sum of the left columns, scaled by the elements of the
+	// corresponding right column, accumulated in the same order as the scalar code.
+	CC3SIMDFloat4 lc1 = CC3SIMDFloat4Load(mL->colRow[0]);
+	CC3SIMDFloat4 lc2 = CC3SIMDFloat4Load(mL->colRow[1]);
+	CC3SIMDFloat4 lc3 = CC3SIMDFloat4Load(mL->colRow[2]);
+	CC3SIMDFloat4 lc4 = CC3SIMDFloat4Load(mL->colRow[3]);
+	CC3SIMDFloat4 oc[kCC3Matrix4x4ColumnCount];
+	for (NSUInteger colIdx = 0; colIdx < kCC3Matrix4x4ColumnCount; colIdx++) {
+		const GLfloat* rc = mR->colRow[colIdx];
+		CC3SIMDFloat4 sum = CC3SIMDFloat4Multiply(lc1, CC3SIMDFloat4Splat(rc[0]));
+		sum = CC3SIMDFloat4Add(sum, CC3SIMDFloat4Multiply(lc2, CC3SIMDFloat4Splat(rc[1])));
+		sum = CC3SIMDFloat4Add(sum, CC3SIMDFloat4Multiply(lc3, CC3SIMDFloat4Splat(rc[2])));
+		oc[colIdx] = CC3SIMDFloat4Add(sum, CC3SIMDFloat4Multiply(lc4, CC3SIMDFloat4Splat(rc[3])));
+	}
+	for (NSUInteger colIdx = 0; colIdx < kCC3Matrix4x4ColumnCount; colIdx++)
+		CC3SIMDFloat4Store(mOut->colRow[colIdx], oc[colIdx]);
+#else
 	mOut->c1r1 = (mL->c1r1 * mR->c1r1) + (mL->c2r1 * mR->c1r2) + (mL->c3r1 * mR->c1r3) + (mL->c4r1 * mR->c1r4);
 	mOut->c1r2 = (mL->c1r2 * mR->c1r1) + (mL->c2r2 * mR->c1r2) + (mL->c3r2 * mR->c1r3) + (mL->c4r2 * mR->c1r4);
 	mOut->c1r3 = (mL->c1r3 * mR->c1r1) + (mL->c2r3 * mR->c1r2) + (mL->c3r3 * mR->c1r3) + (mL->c4r3 * mR->c1r4);
@@ -307,6 +332,7 @@ void CC3Matrix4x4Multiply(CC3Matrix4x4* mOut, const CC3Matrix4x4* mL, const CC3M
 	mOut->c4r2 = (mL->c1r2 * mR->c4r1) + (mL->c2r2 * mR->c4r2) + (mL->c3r2 * mR->c4r3) + (mL->c4r2 * mR->c4r4);
 	mOut->c4r3 = (mL->c1r3 * mR->c4r1) + (mL->c2r3 * mR->c4r2) + (mL->c3r3 * mR->c4r3) + (mL->c4r3 * mR->c4r4);
 	mOut->c4r4 = (mL->c1r4 * mR->c4r1) + (mL->c2r4 * mR->c4r2) + (mL->c3r4 * mR->c4r3) + (mL->c4r4 * mR->c4r4);
+#endif	// CC3_SIMD
 }
 
 
@@ -314,10 +340,18 @@ void CC3Matrix4x4Multiply(CC3Matrix4x4* mOut, const CC3Matrix4x4* mL, const CC3M
 
 CC3Vector4 CC3Matrix4x4TransformCC3Vector4(const CC3Matrix4x4* mtx, CC3Vector4 v) {
 	CC3Vector4 vOut;
+#if CC3_SIMD
+	CC3SIMDFloat4 sum = CC3SIMDFloat4Multiply(CC3SIMDFloat4Load(mtx->colRow[0]), CC3SIMDFloat4Splat(v.x));
+	sum = CC3SIMDFloat4Add(sum, CC3SIMDFloat4Multiply(CC3SIMDFloat4Load(mtx->colRow[1]), CC3SIMDFloat4Splat(v.y)));
+	sum = CC3SIMDFloat4Add(sum, CC3SIMDFloat4Multiply(CC3SIMDFloat4Load(mtx->colRow[2]), CC3SIMDFloat4Splat(v.z)));
+	sum = CC3SIMDFloat4Add(sum, CC3SIMDFloat4Multiply(CC3SIMDFloat4Load(mtx->colRow[3]), CC3SIMDFloat4Splat(v.w)));
+	CC3SIMDFloat4Store(&vOut.x, sum);
+#else
 	vOut.x = (mtx->c1r1 * v.x) + (mtx->c2r1 * v.y) + (mtx->c3r1 * v.z) + (mtx->c4r1 * v.w);
 	vOut.y = (mtx->c1r2 * v.x) + (mtx->c2r2 * v.y) + (mtx->c3r2 * v.z) + (mtx->c4r2 * v.w);
 	vOut.z = (mtx->c1r3 * v.x) + (mtx->c2r3 * v.y) + (mtx->c3r3 * v.z) + (mtx->c4r3 * v.w);
 	vOut.w = (mtx->c1r4 * v.x) + (mtx->c2r4 * v.y) + (mtx->c3r4 * v.z) + (mtx->c4r4 * v.w);
+#endif	// CC3_SIMD
 	return vOut;
 }
 
@@ -338,6 +372,17 @@ CC3Vector CC3Matrix4x4TransformDirection(const CC3Matrix4x4* mtx, CC3Vector v) {
 }
 
 void CC3Matrix4x4Transpose(CC3Matrix4x4* mtx) {
+#if CC3_SIMD
+	CC3SIMDFloat4 c1 = CC3SIMDFloat4Load(mtx->colRow[0]);
+	CC3SIMDFloat4 c2 = CC3SIMDFloat4Load(mtx->colRow[1]);
+	CC3SIMDFloat4 c3 = CC3SIMDFloat4Load(mtx->colRow[2]);
+	CC3SIMDFloat4 c4 = CC3SIMDFloat4Load(mtx->colRow[3]);
+	CC3SIMDFloat4Transpose(&c1, &c2, &c3, &c4);
+	CC3SIMDFloat4Store(mtx->colRow[0], c1);
+	CC3SIMDFloat4Store(mtx->colRow[1], c2);
+	CC3SIMDFloat4Store(mtx->colRow[2], c3);
+	CC3SIMDFloat4Store(mtx->colRow[3], c4);
+#else
 	GLfloat tmp;
 	tmp = mtx->c1r2;   mtx->c1r2 = mtx->c2r1;   mtx->c2r1 = tmp;
 	tmp = mtx->c1r3;   mtx->c1r3 = mtx->c3r1;   mtx->c3r1 = tmp;
@@ -345,6 +390,7 @@ void CC3Matrix4x4Transpose(CC3Matrix4x4* mtx) {
 	tmp = mtx->c2r3;   mtx->c2r3 = mtx->c3r2;   mtx->c3r2 = tmp;
 	tmp = mtx->c2r4;   mtx->c2r4 = mtx->c4r2;   mtx->c4r2 = tmp;
 	tmp = mtx->c3r4;   mtx->c3r4 = mtx->c4r3;   mtx->c4r3 = tmp;
+#endif	// CC3_SIMD
 }
 
 BOOL CC3Matrix4x4InvertAdjoint(CC3Matrix4x4* m) {
@@ -380,6 +426,11 @@ BOOL CC3Matrix4x4InvertAdjoint(CC3Matrix4x4* m) {
 	
 	// Divide the classical adjoint matrix by the determinant and set back into original matrix.
 	GLfloat ooDet = 1.0 / det;		// Turn div into mult for speed
+#if CC3_SIMD
+	CC3SIMDFloat4 ooDetV = CC3SIMDFloat4Splat(ooDet);
+	for (NSUInteger colIdx = 0; colIdx < kCC3Matrix4x4ColumnCount; colIdx++)
+		CC3SIMDFloat4Store(m->colRow[colIdx], CC3SIMDFloat4Multiply(CC3SIMDFloat4Load(adj.colRow[colIdx]), ooDetV));
+#else
 	m->c1r1 = adj.c1r1 * ooDet;
 	m->c1r2 = adj.c1r2 * ooDet;
 	m->c1r3 = adj.c1r3 * ooDet;
@@ -396,11 +447,31 @@ BOOL CC3Matrix4x4InvertAdjoint(CC3Matrix4x4* m) {
 	m->c4r2 = adj.c4r2 * ooDet;
 	m->c4r3 = adj.c4r3 * ooDet;
 	m->c4r4 = adj.c4r4 * ooDet;
+#endif	// CC3_SIMD
 	
 	return YES;
 }
 
 void CC3Matrix4x4InvertRigid(CC3Matrix4x4* mtx) {
+#if CC3_SIMD
+	// Transpose the 3x3 linear matrix, using a fourth unit column to clear the bottom row
+	CC3SIMDFloat4 c1 = CC3SIMDFloat4Load(mtx->colRow[0]);
+	CC3SIMDFloat4 c2 = CC3SIMDFloat4Load(mtx->colRow[1]);
+	CC3SIMDFloat4 c3 = CC3SIMDFloat4Load(mtx->colRow[2]);
+	CC3SIMDFloat4 c4 = CC3SIMDFloat4Load(&kCC3Vector4ZeroLocation.x);
+	CC3SIMDFloat4Transpose(&c1, &c2, &c3, &c4);
+
+	// Transform the negated translation by the transposed linear matrix
+	CC3SIMDFloat4 t = CC3SIMDFloat4Multiply(c1, CC3SIMDFloat4Splat(-mtx->c4r1));
+	t = CC3SIMDFloat4Add(t, CC3SIMDFloat4Multiply(c2, CC3SIMDFloat4Splat(-mtx->c4r2)));
+	t = CC3SIMDFloat4Add(t, CC3SIMDFloat4Multiply(c3, CC3SIMDFloat4Splat(-mtx->c4r3)));
+
+	CC3SIMDFloat4Store(mtx->colRow[0], c1);
+	CC3SIMDFloat4Store(mtx->colRow[1], c2);
+	CC3SIMDFloat4Store(mtx->colRow[2], c3);
+	CC3SIMDFloat4Store(mtx->colRow[3], t);
+	mtx->c4r4 = 1.0f;
+#else
 	// Extract and transpose the 3x3 linear matrix 
 	CC3Matrix3x3 linMtx;
 	CC3Matrix3x3PopulateFrom4x4(&linMtx, mtx);
@@ -415,6 +486,5 @@ void CC3Matrix4x4InvertRigid(CC3Matrix4x4* mtx) {
 	mtx->c4r1 = t.x;
 	mtx->c4r2 = t.y;
 	mtx->c4r3 = t.z;
+#endif	// CC3_SIMD
 }
-
-
@@ -196,6 +196,75 @@ static inline CC3MeshIntersection* CC3NearestMeshIntersection(CC3MeshIntersectio
 }
 
 
+#pragma mark Vertex cache optimization
+
+/**
+ * The default number of vertices in the post-transform vertex cache, as assumed when optimizing
+ * the order of mesh triangles, and when simulating the cache to measure the effect.
+ */
+#define kCC3DefaultVertexCacheSize	16
+
+/**
+ * Describes how effectively a sequence of triangle vertex indices reuses the post-transform
+ * vertex cache of the GPU, as measured by simulating a FIFO vertex cache of a particular size.
+ */
+typedef struct {
+	GLuint cacheSize;						/**< The number of vertices held by the simulated cache. */
+	GLuint triangleCount;					/**< The number of triangles drawn. */
+	GLuint vertexCount;						/**< The number of distinct vertices referenced by the triangles. */
+	GLuint cacheMissCount;					/**< The number of vertices transformed because they were not in the cache. */
+	GLfloat averageCacheMissRatio;			/**< ACMR: vertices transformed per triangle. Between 0.5 and 3.0. Lower is better. */
+	GLfloat averageTransformedVertexRatio;	/**< ATVR: vertices transformed per distinct vertex. 1.0 is ideal. */
+} CC3VertexCacheStatistics;
+
+/** Returns a string description of the specified CC3VertexCacheStatistics struct. */
+static inline NSString* NSStringFromCC3VertexCacheStatistics(CC3VertexCacheStatistics vcStats) {
+	return [NSString stringWithFormat: @"(ACMR: %.3f, ATVR: %.3f, %u misses drawing %u triangles using %u vertices with cache size %u)",
+			vcStats.averageCacheMissRatio, vcStats.averageTransformedVertexRatio, vcStats.cacheMissCount,
+			vcStats.triangleCount, vcStats.vertexCount, vcStats.cacheSize];
+}
+
+/**
+ * Returns the vertex cache statistics for drawing the triangles defined by the specified indices,
+ * as measured by simulating a FIFO post-transform vertex cache holding the specified number of vertices.
+ *
+ * The indexCount parameter is the number of indices in the indices array, and should be a multiple
+ * of three. The vertexCount parameter indicates the number of vertices that can be referenced by the
+ * indices. Any index that is not less than vertexCount is ignored.
+ */
+CC3VertexCacheStatistics CC3VertexCacheStatisticsFromIndices(const GLuint* indices, GLuint indexCount,
+															 GLuint vertexCount, GLuint cacheSize);
+
+/**
+ * Reorders the triangles defined by the specified indices, in place, to improve the reuse of the
+ * post-transform vertex cache of the GPU, assuming a cache that holds the specified number of vertices.
+ *
+ * This function uses the Tipsify algorithm (Sander, Nehab & Barczak, 2007), which runs in time linear
+ * in the number of triangles. The winding of each triangle is not changed, and each triangle remains
+ * in the array exactly once.
+ *
+ * The indexCount parameter is the number of indices in the indices array. Any trailing indices beyond
+ * the last whole triangle are left in place. The vertexCount parameter indicates the number of vertices
+ * that can be referenced by the indices, and every index must be less than vertexCount.
+ */
+void CC3OptimizeTriangleOrder(GLuint* indices, GLuint indexCount, GLuint vertexCount, GLuint cacheSize);
+
+/**
+ * Renumbers the vertices referenced by the specified indices, in place, so that vertices are numbered
+ * in the order in which they are first used by the indices. This improves the locality of vertex
+ * fetching when the vertex content is reordered to match.
+ *
+ * On return, the vertexRemap array, which must have room for vertexCount elements, contains the
+ * new position of each vertex, indexed by its original position. Vertices that are not referenced
+ * by any index are moved to the end, and retain their original relative order.
+ *
+ * The indexCount parameter is the number of indices in the indices array. The vertexCount parameter
+ * indicates the number of vertices that can be referenced by the indices, and every index must be
+ * less than vertexCount.
+ */
+void CC3OptimizeVertexOrder(GLuint* indices, GLuint indexCount, GLuint vertexCount, GLuint* vertexRemap);
+
+
 #pragma mark CC3Mesh
 
 /**
@@ -1617,6 +1686,33 @@ static inline CC3MeshIntersection* CC3NearestMeshIntersection(CC3MeshIntersectio
 
 #pragma mark Buffering content to GL engine
 
+/**
+ * Returns the number of bytes of application memory occupied by the vertex content of this
+ * mesh that is managed by the vertex arrays of this mesh.
+ *
+ * Vertex content that has been released by the releaseRedundantContent method, and vertex
+ * content that is managed externally, such as content referenced in place within a
+ * memory-mapped file, is not included.
+ */
+@property(nonatomic, readonly) NSUInteger applicationMemoryBytes;
+
+/**
+ * Returns an estimate of the number of bytes of GL memory occupied by the GL vertex buffer
+ * objects holding the vertex content of this mesh.
+ *
+ * Vertex content that is shared by interleaved vertex arrays is only counted once.
+ */
+@property(nonatomic, readonly) NSUInteger glMemoryBytes;
+
+/**
+ * Returns an estimate of the number of bytes of memory occupied by the vertex content of
+ * this mesh, including both vertex content held in application memory, and vertex content
+ * that has been copied to GL buffers.
+ *
+ * This is the sum of the applicationMemoryBytes and glMemoryBytes properties.
+ */
+@property(nonatomic, readonly) NSUInteger cacheCost;
+
 /**
  * Convenience method to create GL buffers for all vertex arrays used by this mesh.
  *
@@ -2036,6 +2132,26 @@ static inline CC3MeshIntersection* CC3NearestMeshIntersection(CC3MeshIntersectio
  */
 -(void) moveMeshOriginToCenterOfGeometry;
 
+/**
+ * Transforms the vertex locations, normals, tangents and bitangents of this mesh by the
+ * specified matrix. Locations are transformed as locations, normals are transformed by the
+ * inverse-transpose of the matrix, and tangents and bitangents are transformed as directions.
+ * Normals, tangents and bitangents are normalized after being transformed.
+ *
+ * This method can be used to bake a transform into the mesh content, for example to
+ * pre-transform a mesh that will be combined with other meshes. Vertex content is processed
+ * directly in memory, including interleaved content, using vector instructions when available,
+ * and very large meshes are split across several threads. See the transformVertices:startingAt:by:
+ * method of CC3VertexArray for the requirements of the vertex content.
+ *
+ * As with the moveMeshOriginTo: method, this method can be costly, and should not be used to
+ * move your model around. If this mesh is being used by any mesh nodes, be sure to invoke the
+ * markBoundingVolumeDirty method on all nodes that use this mesh.
+ *
+ * This method ensures that the GL VBOs that hold the vertex content are updated.
+ */
+-(void) transformVerticesBy: (CC3Matrix*) aMatrix;
+
 /** @deprecated Renamed to moveMeshOriginTo:. */
 -(void) movePivotTo: (CC3Vector) aLocation __deprecated;
 
@@ -2043,6 +2159,110 @@ static inline CC3MeshIntersection* CC3NearestMeshIntersection(CC3MeshIntersectio
 -(void) movePivotToCenterOfGeometry __deprecated;
 
 
+#pragma mark Vertex cache optimization
+
+/**
+ * Returns statistics describing how effectively the triangles of this mesh reuse the post-transform
+ * vertex cache of the GPU, as measured by simulating a FIFO vertex cache holding the specified number
+ * of vertices. The simulation runs entirely on the CPU.
+ *
+ * The statistics are only meaningful for a mesh that uses vertex indices and whose drawingMode is
+ * GL_TRIANGLES. For any other mesh, or if the vertex index content has been released from memory,
+ * all of the fields of the returned structure will be zero.
+ */
+-(CC3VertexCacheStatistics) vertexCacheStatisticsForCacheSize: (GLuint) cacheSize;
+
+/**
+ * Reorders the triangles of this mesh to improve reuse of the post-transform vertex cache of the GPU,
+ * assuming a cache holding the specified number of vertices, and then reorders the vertices of this
+ * mesh into the order in which they are first used by the triangles, to improve vertex fetch locality.
+ *
+ * Triangles are reordered using the CC3OptimizeTriangleOrder function. The content of all vertex
+ * arrays, including interleaved content, is moved to match the new vertex order, and the vertex
+ * indices are renumbered accordingly. The shape, winding, and bounding volume of the mesh are unchanged.
+ *
+ * Each NSValue in the indexRanges array wraps an NSRange that identifies a run of vertex indices within
+ * which triangles may be reordered. Triangles are never moved from one range to another. This allows
+ * the mesh to be optimized without disturbing index ranges that are drawn separately, such as the skin
+ * sections of a skinned mesh. If indexRanges is nil, the triangles may be reordered across all of the
+ * vertex indices of this mesh.
+ *
+ * The vertex cache statistics of this mesh before and after the optimization are logged at the
+ * resource loading logging level, and are available via the vertexCacheStatisticsForCacheSize: method.
+ *
+ * This method has no effect unless this mesh uses vertex indices, the drawingMode of this mesh is
+ * GL_TRIANGLES, and the vertex content has not been released from memory. This method should be
+ * invoked once, when the mesh is loaded or built, and ensures that the GL buffers that hold the
+ * vertex content and the vertex indices are updated.
+ */
+-(void) optimizeVertexCacheOrderForCacheSize: (GLuint) cacheSize inIndexRanges: (NSArray*) indexRanges;
+
+/**
+ * Reorders the triangles and vertices of this mesh to improve reuse of the post-transform vertex
+ * cache of the GPU, assuming a cache holding kCC3DefaultVertexCacheSize vertices.
+ *
+ * This is a convenience method that invokes the optimizeVertexCacheOrderForCacheSize:inIndexRanges:
+ * method, allowing triangles to be reordered across all of the vertex indices of this mesh.
+ */
+-(void) optimizeVertexCacheOrder;
+
+
+#pragma mark Vertex quantization
+
+/**
+ * Converts the vertex content of this mesh to the specified compact formats, and returns the total
+ * number of bytes of vertex content saved.
+ *
+ * The vertex locations, normals, texture coordinates and bone weights are each converted to the
+ * corresponding format. Vertex tangents and bitangents are converted using the same format as the
+ * vertex normals, and all texture coordinates, including overlay texture coordinates, use the same
+ * format. Vertex content that this mesh does not contain, or whose format is specified here as
+ * kCC3VertexQuantizationNone, is left in its current format. Vertex colors, bone indices and point
+ * sizes are not changed.
+ *
+ * See the quantizeAs: method of CC3VertexArray for a description of each format, and the formats
+ * supported by each type of vertex content. The bytes saved and the maximum reconstruction error of
+ * each vertex array are logged at the resource loading logging level.
+ *
+ * Interleaved vertex content is separated during quantization, and is then re-interleaved using the
+ * smaller vertex stride. If this mesh is using GL buffers, they are recreated to hold the new content.
+ *
+ * Quantized vertex content requires OpenGL ES 2 or OpenGL. Under OpenGL ES 1, this method does nothing.
+ *
+ * Vertex locations are remapped to fit the range of their format, and texture coordinates that extend
+ * outside the range 0 to 1 are remapped to fit that range, so the vertex shader must reconstruct them
+ * using the kCC3SemanticVertexLocationScale, kCC3SemanticVertexLocationOffset,
+ * kCC3SemanticVertexTexCoordScale and kCC3SemanticVertexTexCoordOffset uniform semantics. Similarly,
+ * octahedral-encoded normals and tangents must be decoded by the vertex shader, as indicated by the
+ * kCC3SemanticVertexNormalIsOctahedral uniform semantic. The stock Cocos3D shaders do not decode
+ * quantized content, so any of these formats requires a custom shader. See the
+ * requiresDecodingForQuantization: method of CC3VertexArray for the formats that require decoding.
+ *
+ * This method has no effect if the vertex content has been released from memory. It should be invoked
+ * once, after all vertex content has been populated and transformed, since vertex content that is
+ * written after quantization is clamped to the range of the quantized format.
+ */
+-(NSInteger) quantizeVertexLocationsAs: (CC3VertexQuantization) locQuantization
+							 normalsAs: (CC3VertexQuantization) normalQuantization
+				  textureCoordinatesAs: (CC3VertexQuantization) texCoordQuantization
+						 boneWeightsAs: (CC3VertexQuantization) weightQuantization;
+
+/**
+ * Converts the vertex content of this mesh to compact formats that can be drawn by any shader,
+ * including the stock Cocos3D shaders, and returns the total number of bytes of vertex content saved.
+ *
+ * This is a convenience method that behaves like the quantizeVertexLocationsAs:normalsAs:
+ * textureCoordinatesAs:boneWeightsAs: method, using kCC3VertexQuantizationByte for vertex normals
+ * and tangents, kCC3VertexQuantizationShort for texture coordinates, and kCC3VertexQuantizationByte
+ * for bone weights, each of which is converted back to its original values by the GL engine.
+ * Vertex locations are not quantized. Texture coordinates that extend outside the range 0 to 1,
+ * and would therefore be remapped, are not quantized either. See that method for more information.
+ *
+ * Under OpenGL ES 1, this method does nothing.
+ */
+-(NSInteger) quantizeVertexContent;
+
+
 #pragma mark CCRGBAProtocol and CCBlendProtocol support
 
 /**
@@ -2568,6 +2788,7 @@ static inline CC3MeshIntersection* CC3NearestMeshIntersection(CC3MeshIntersectio
 	BOOL _normalsAreDirty;
 	BOOL _planesAreDirty;
 	BOOL _neighboursAreDirty;
+	GLuint _vertexLocationsVersion;
 }
 
 /**
@@ -2610,6 +2831,10 @@ static inline CC3MeshIntersection* CC3NearestMeshIntersection(CC3MeshIntersectio
  * access through the indicesAt:, centerAt:, normalAt:, or planeAt:, methods will
  * be cleared.
  *
+ * Centers, normals and planes that are cached in memory allocated by this instance are
+ * automatically repopulated on the next access after the contentVersion of the vertex
+ * locations of the mesh changes.
+ *
  * Because the face neighbour data returned by the neighboursAt: method is
  * a function of the relationship between faces, that data is always cached,
  * and is not affected by the setting of this property.
@@ -85,6 +85,140 @@ NSString* NSStringFromCC3VertexContent(CC3VertexContent vtxContent) {
 }
 
 
+#pragma mark Vertex cache optimization
+
+/** Indicates that a vertex has not yet been assigned a position, or that no vertex is available. */
+#define kCC3VertexNone		((GLuint)~0)
+
+CC3VertexCacheStatistics CC3VertexCacheStatisticsFromIndices(const GLuint* indices, GLuint indexCount,
+															 GLuint vertexCount, GLuint cacheSize) {
+	CC3VertexCacheStatistics vcStats;
+	memset(&vcStats, 0, sizeof(vcStats));
+	vcStats.cacheSize = cacheSize;
+	vcStats.triangleCount = indexCount / 3;
+	if ( !indexCount || !vertexCount || !cacheSize ) return vcStats;
+
+	// Each vertex is stamped with the miss count at which it entered the FIFO cache. The vertex
+	// has been pushed out of the cache once cacheSize other vertices have entered after it.
+	GLuint* entryStamps = calloc(vertexCount, sizeof(GLuint));
+	GLuint missCount = 0;
+	for (GLuint i = 0; i < indexCount; i++) {
+		GLuint vtxIdx = indices[i];
+		if (vtxIdx >= vertexCount) continue;
+		GLuint entryStamp = entryStamps[vtxIdx];
+		if ( !entryStamp ) vcStats.vertexCount++;
+		if ( !entryStamp || (missCount - entryStamp) >= cacheSize ) entryStamps[vtxIdx] = ++missCount;
+	}
+	free(entryStamps);
+
+	vcStats.cacheMissCount = missCount;
+	if (vcStats.triangleCount) vcStats.averageCacheMissRatio = (GLfloat)missCount / (GLfloat)vcStats.triangleCount;
+	if (vcStats.vertexCount) vcStats.averageTransformedVertexRatio = (GLfloat)missCount / (GLfloat)vcStats.vertexCount;
+	return vcStats;
+}
+
+void CC3OptimizeTriangleOrder(GLuint* indices, GLuint indexCount, GLuint vertexCount, GLuint cacheSize) {
+	GLuint triCount = indexCount / 3;
+	GLuint triIdxCount = triCount * 3;
+	if (triCount < 2 || !vertexCount) return;
+
+	// Build the list of triangles that use each vertex, bucketed by vertex with a counting sort.
+	// Each vertex also tracks how many of its triangles have not yet been emitted.
+	GLuint* adjOffsets = calloc(vertexCount + 1, sizeof(GLuint));
+	GLuint* liveCounts = calloc(vertexCount, sizeof(GLuint));
+	GLuint* adjTris = malloc(triIdxCount * sizeof(GLuint));
+	for (GLuint i = 0; i < triIdxCount; i++) liveCounts[indices[i]]++;
+	for (GLuint v = 0; v < vertexCount; v++) adjOffsets[v + 1] = adjOffsets[v] + liveCounts[v];
+	GLuint* adjFill = malloc(vertexCount * sizeof(GLuint));
+	memcpy(adjFill, adjOffsets, vertexCount * sizeof(GLuint));
+	for (GLuint i = 0; i < triIdxCount; i++) adjTris[adjFill[indices[i]]++] = i / 3;
+	free(adjFill);
+
+	GLuint* cacheStamps = calloc(vertexCount, sizeof(GLuint));
+	GLubyte* isEmitted = calloc(triCount, sizeof(GLubyte));
+	GLuint* deadEnds = malloc(triIdxCount * sizeof(GLuint));
+	GLuint* candidates = malloc(triIdxCount * sizeof(GLuint));
+	GLuint* outIndices = malloc(triIdxCount * sizeof(GLuint));
+	GLuint deadEndCount = 0;
+	GLuint outCount = 0;
+	GLuint timeStamp = cacheSize + 1;	// All vertices start outside the cache
+	GLuint scanIdx = 0;
+
+	GLuint fanVtx = 0;
+	while (fanVtx < vertexCount && !liveCounts[fanVtx]) fanVtx++;
+	while (fanVtx < vertexCount) {
+
+		// Emit all remaining triangles around the fanning vertex
+		GLuint candCount = 0;
+		for (GLuint adjIdx = adjOffsets[fanVtx]; adjIdx < adjOffsets[fanVtx + 1]; adjIdx++) {
+			GLuint triIdx = adjTris[adjIdx];
+			if (isEmitted[triIdx]) continue;
+			isEmitted[triIdx] = YES;
+			for (GLuint k = 0; k < 3; k++) {
+				GLuint vtxIdx = indices[(triIdx * 3) + k];
+				outIndices[outCount++] = vtxIdx;
+				deadEnds[deadEndCount++] = vtxIdx;
+				candidates[candCount++] = vtxIdx;
+				liveCounts[vtxIdx]--;
+				if ((timeStamp - cacheStamps[vtxIdx]) > cacheSize) cacheStamps[vtxIdx] = timeStamp++;
+			}
+		}
+
+		// Choose the next fanning vertex from the vertices just emitted, preferring the oldest
+		// vertex that will still be in the cache once all of its remaining triangles are emitted.
+		GLuint nextVtx = kCC3VertexNone;
+		GLint bestPriority = -1;
+		for (GLuint c = 0; c < candCount; c++) {
+			GLuint vtxIdx = candidates[c];
+			if ( !liveCounts[vtxIdx] ) continue;
+			GLuint age = timeStamp - cacheStamps[vtxIdx];
+			GLint priority = ((age + (2 * liveCounts[vtxIdx])) <= cacheSize) ? (GLint)age : 0;
+			if (priority > bestPriority) {
+				bestPriority = priority;
+				nextVtx = vtxIdx;
+			}
+		}
+
+		// At a dead end, back up to the most recently emitted vertex that still has triangles,
+		// and failing that, continue with the next vertex in index order that still has triangles.
+		while (nextVtx == kCC3VertexNone && deadEndCount) {
+			GLuint vtxIdx = deadEnds[--deadEndCount];
+			if (liveCounts[vtxIdx]) nextVtx = vtxIdx;
+		}
+		if (nextVtx == kCC3VertexNone) {
+			while (scanIdx < vertexCount && !liveCounts[scanIdx]) scanIdx++;
+			nextVtx = scanIdx;
+		}
+		fanVtx = nextVtx;
+	}
+	memcpy(indices, outIndices, triIdxCount * sizeof(GLuint));
+
+	free(outIndices);
+	free(candidates);
+	free(deadEnds);
+	free(isEmitted);
+	free(cacheStamps);
+	free(adjTris);
+	free(liveCounts);
+	free(adjOffsets);
+}
+
+void CC3OptimizeVertexOrder(GLuint* indices, GLuint indexCount, GLuint vertexCount, GLuint* vertexRemap) {
+	for (GLuint v = 0; v < vertexCount; v++) vertexRemap[v] = kCC3VertexNone;
+
+	GLuint nextVtx = 0;
+	for (GLuint i = 0; i < indexCount; i++) {
+		GLuint vtxIdx = indices[i];
+		if (vertexRemap[vtxIdx] == kCC3VertexNone) vertexRemap[vtxIdx] = nextVtx++;
+		indices[i] = vertexRemap[vtxIdx];
+	}
+
+	// Unreferenced vertices follow, in their original order
+	for (GLuint v = 0; v < vertexCount; v++)
+		if (vertexRemap[v] == kCC3VertexNone) vertexRemap[v] = nextVtx++;
+}
+
+
 #pragma mark CC3Mesh
 
 @implementation CC3Mesh
@@ -637,7 +771,11 @@ NSString* NSStringFromCC3VertexContent(CC3VertexContent vtxContent) {
 	if (self.hasVertexTangents) [self setVertexTangent: [srcMesh vertexTangentAt: srcIdx] at: dstIdx];
 	if (self.hasVertexBitangents) [self setVertexBitangent: [srcMesh vertexBitangentAt: srcIdx] at: dstIdx];
 	if (self.hasVertexColors) [self setVertexColor4F: [srcMesh vertexColor4FAt: srcIdx] at: dstIdx];
-	if (self.hasVertexBoneWeights) [self setVertexBoneWeights: [srcMesh vertexBoneWeightsAt: srcIdx] at: dstIdx];
+	if (self.hasVertexBoneWeights) {
+		GLuint boneCount = self.vertexBoneCount;
+		for (GLuint i = 0; i < boneCount; i++)
+			[self setVertexWeight: [srcMesh vertexWeightForBoneInfluence: i at: srcIdx] forBoneInfluence: i at: dstIdx];
+	}
 	if (self.hasVertexBoneIndices) [self setVertexBoneIndices: [srcMesh vertexBoneIndicesAt: srcIdx] at: dstIdx];
 	if (self.hasVertexPointSizes) [self setVertexPointSize: [srcMesh vertexPointSizeAt: srcIdx] at: dstIdx];
 	GLuint tcCount = self.textureCoordinatesArrayCount;
@@ -958,6 +1096,41 @@ NSString* NSStringFromCC3VertexContent(CC3VertexContent vtxContent) {
 
 #pragma mark Buffering content to GL engine
 
+/**
+ * Returns the number of bytes of memory occupied by the vertex content of the specified vertex
+ * array, in either application memory, or GL memory. GL memory is not included if the array is
+ * sharing the GL buffer of another array.
+ */
+static NSUInteger CC3VertexArrayByteCount(CC3VertexArray* va, BOOL isGLMemory, BOOL isSharingBuffer) {
+	if ( !va ) return 0;
+	if ( !isGLMemory ) return va.applicationMemoryBytes;
+	return isSharingBuffer ? 0 : va.glMemoryBytes;
+}
+
+/** Returns the number of bytes of either application memory or GL memory occupied by the vertex arrays. */
+-(NSUInteger) vertexContentByteCountInGLMemory: (BOOL) isGLMemory {
+	BOOL isIlv = isGLMemory && _shouldInterleaveVertices;
+	NSUInteger byteCnt = CC3VertexArrayByteCount(_vertexLocations, isGLMemory, NO);
+	byteCnt += CC3VertexArrayByteCount(_vertexNormals, isGLMemory, isIlv);
+	byteCnt += CC3VertexArrayByteCount(_vertexTangents, isGLMemory, isIlv);
+	byteCnt += CC3VertexArrayByteCount(_vertexBitangents, isGLMemory, isIlv);
+	byteCnt += CC3VertexArrayByteCount(_vertexColors, isGLMemory, isIlv);
+	byteCnt += CC3VertexArrayByteCount(_vertexBoneIndices, isGLMemory, isIlv);
+	byteCnt += CC3VertexArrayByteCount(_vertexBoneWeights, isGLMemory, isIlv);
+	byteCnt += CC3VertexArrayByteCount(_vertexPointSizes, isGLMemory, isIlv);
+	byteCnt += CC3VertexArrayByteCount(_vertexTextureCoordinates, isGLMemory, isIlv);
+	for (CC3VertexTextureCoordinates* otc in _overlayTextureCoordinates)
+		byteCnt += CC3VertexArrayByteCount(otc, isGLMemory, isIlv);
+	byteCnt += CC3VertexArrayByteCount(_vertexIndices, isGLMemory, NO);
+	return byteCnt;
+}
+
+-(NSUInteger) applicationMemoryBytes { return [self vertexContentByteCountInGLMemory: NO]; }
+
+-(NSUInteger) glMemoryBytes { return [self vertexContentByteCountInGLMemory: YES]; }
+
+-(NSUInteger) cacheCost { return self.applicationMemoryBytes + self.glMemoryBytes; }
+
 /**
  * If the interleavesVertices property is set to NO, creates GL vertex buffer objects for all
  * vertex arrays used by this mesh by invoking createGLBuffer on each contained vertex array.
@@ -1231,11 +1404,279 @@ NSString* NSStringFromCC3VertexContent(CC3VertexContent vtxContent) {
 
 -(void) moveMeshOriginToCenterOfGeometry { [_vertexLocations moveMeshOriginToCenterOfGeometry]; }
 
+-(void) transformVerticesBy: (CC3Matrix*) aMatrix {
+	[_vertexLocations transformBy: aMatrix];
+	[_vertexNormals transformBy: aMatrix];
+	[_vertexTangents transformBy: aMatrix];
+	[_vertexBitangents transformBy: aMatrix];
+	[self updateGLBuffers];
+}
+
 // Deprecated methods
 -(void) movePivotTo: (CC3Vector) aLocation { [self moveMeshOriginTo: aLocation]; }
 -(void) movePivotToCenterOfGeometry { [self moveMeshOriginToCenterOfGeometry]; }
 
 
+#pragma mark Vertex cache optimization
+
+/**
+ * Returns a malloc'ed copy of the vertex indices of this mesh, widened to GLuint, or NULL if this
+ * mesh does not draw indexed triangles, if the index content is not in memory, or if any index
+ * lies outside the vertex content. The caller is responsible for freeing the returned array.
+ */
+-(GLuint*) copyTriangleIndices {
+	if ( !(_vertexIndices.vertices && self.drawingMode == GL_TRIANGLES) ) return NULL;
+
+	GLuint idxCount = _vertexIndices.vertexCount;
+	GLuint vtxCount = self.vertexCount;
+	GLuint* indices = malloc(idxCount * sizeof(GLuint));
+	for (GLuint i = 0; i < idxCount; i++) {
+		indices[i] = [_vertexIndices indexAt: i];
+		if (indices[i] >= vtxCount) {
+			LogError(@"%@ vertex index %u at %u lies beyond the %u vertices of the mesh.", self, indices[i], i, vtxCount);
+			free(indices);
+			return NULL;
+		}
+	}
+	return indices;
+}
+
+/** Moves the content of each vertex in the specified vertex array to the position indicated by vertexRemap. */
+static void CC3VertexArrayRemapVertices(CC3VertexArray* va, const GLuint* vertexRemap, GLuint vtxCount) {
+	GLbyte* vtxs = va.vertices;
+	if ( !vtxs ) return;
+
+	GLuint vtxStride = va.vertexStride;
+	GLbyte* remappedVtxs = malloc(vtxCount * vtxStride);
+	for (GLuint v = 0; v < vtxCount; v++)
+		memcpy(remappedVtxs + (vertexRemap[v] * vtxStride), vtxs + (v * vtxStride), vtxStride);
+	memcpy(vtxs, remappedVtxs, vtxCount * vtxStride);
+	free(remappedVtxs);
+}
+
+-(CC3VertexCacheStatistics) vertexCacheStatisticsForCacheSize: (GLuint) cacheSize {
+	CC3VertexCacheStatistics vcStats;
+	memset(&vcStats, 0, sizeof(vcStats));
+	GLuint* indices = [self copyTriangleIndices];
+	if (indices) {
+		vcStats = CC3VertexCacheStatisticsFromIndices(indices, _vertexIndices.vertexCount, self.vertexCount, cacheSize);
+		free(indices);
+	}
+	return vcStats;
+}
+
+-(void) optimizeVertexCacheOrderForCacheSize: (GLuint) cacheSize inIndexRanges: (NSArray*) indexRanges {
+	GLuint* indices = [self copyTriangleIndices];
+	if ( !indices ) {
+		LogRez(@"%@ does not contain indexed triangles in memory and cannot be optimized for vertex caching.", self);
+		return;
+	}
+	if ( !_vertexLocations.vertices ) {
+		LogRez(@"%@ does not contain vertex content in memory and cannot be optimized for vertex caching.", self);
+		free(indices);
+		return;
+	}
+
+	GLuint idxCount = _vertexIndices.vertexCount;
+	GLuint vtxCount = self.vertexCount;
+	LogRez(@"%@ vertex cache before optimization %@", self,
+		   NSStringFromCC3VertexCacheStatistics(CC3VertexCacheStatisticsFromIndices(indices, idxCount, vtxCount, cacheSize)));
+
+	// Reorder the triangles within each index range, then renumber the vertices to first use
+	if (indexRanges) {
+		for (NSValue* rangeVal in indexRanges) {
+			NSRange idxRange = rangeVal.rangeValue;
+			if (idxRange.location >= idxCount) continue;
+			GLuint rangeCount = (GLuint)MIN(idxRange.length, idxCount - idxRange.location);
+			CC3OptimizeTriangleOrder(indices + idxRange.location, rangeCount, vtxCount, cacheSize);
+		}
+	} else {
+		CC3OptimizeTriangleOrder(indices, idxCount, vtxCount, cacheSize);
+	}
+	GLuint* vertexRemap = malloc(vtxCount * sizeof(GLuint));
+	CC3OptimizeVertexOrder(indices, idxCount, vtxCount, vertexRemap);
+
+	// Move the vertex content. Interleaved content is moved as a whole, via the vertex locations.
+	CC3VertexArrayRemapVertices(_vertexLocations, vertexRemap, vtxCount);
+	if ( !_shouldInterleaveVertices ) {
+		CC3VertexArrayRemapVertices(_vertexNormals, vertexRemap, vtxCount);
+		CC3VertexArrayRemapVertices(_vertexTangents, vertexRemap, vtxCount);
+		CC3VertexArrayRemapVertices(_vertexBitangents, vertexRemap, vtxCount);
+		CC3VertexArrayRemapVertices(_vertexColors, vertexRemap, vtxCount);
+		CC3VertexArrayRemapVertices(_vertexBoneIndices, vertexRemap, vtxCount);
+		CC3VertexArrayRemapVertices(_vertexBoneWeights, vertexRemap, vtxCount);
+		CC3VertexArrayRemapVertices(_vertexPointSizes, vertexRemap, vtxCount);
+		CC3VertexArrayRemapVertices(_vertexTextureCoordinates, vertexRemap, vtxCount);
+		for (CC3VertexTextureCoordinates* otc in _overlayTextureCoordinates)
+			CC3VertexArrayRemapVertices(otc, vertexRemap, vtxCount);
+	}
+	free(vertexRemap);
+
+	for (GLuint i = 0; i < idxCount; i++) [_vertexIndices setIndex: indices[i] at: i];
+
+	LogRez(@"%@ vertex cache after optimization %@", self,
+		   NSStringFromCC3VertexCacheStatistics(CC3VertexCacheStatisticsFromIndices(indices, idxCount, vtxCount, cacheSize)));
+	free(indices);
+
+	_faces.mesh = self;		// Clears face caches built from the old vertex order
+	[self updateGLBuffers];
+	[self updateVertexIndicesGLBuffer];
+}
+
+-(void) optimizeVertexCacheOrder {
+	[self optimizeVertexCacheOrderForCacheSize: kCC3DefaultVertexCacheSize inIndexRanges: nil];
+}
+
+
+#pragma mark Vertex quantization
+
+/** Returns the vertex arrays of this mesh that hold per-vertex content, excluding the vertex indices. */
+-(NSArray*) vertexContentArrays {
+	NSMutableArray* vtxArrays = [NSMutableArray array];
+	if (_vertexLocations) [vtxArrays addObject: _vertexLocations];
+	if (_vertexNormals) [vtxArrays addObject: _vertexNormals];
+	if (_vertexTangents) [vtxArrays addObject: _vertexTangents];
+	if (_vertexBitangents) [vtxArrays addObject: _vertexBitangents];
+	if (_vertexColors) [vtxArrays addObject: _vertexColors];
+	if (_vertexBoneIndices) [vtxArrays addObject: _vertexBoneIndices];
+	if (_vertexBoneWeights) [vtxArrays addObject: _vertexBoneWeights];
+	if (_vertexPointSizes) [vtxArrays addObject: _vertexPointSizes];
+	if (_vertexTextureCoordinates) [vtxArrays addObject: _vertexTextureCoordinates];
+	if (_overlayTextureCoordinates) [vtxArrays addObjectsFromArray: _overlayTextureCoordinates];
+	return vtxArrays;
+}
+
+/**
+ * Moves the content of the specified vertex arrays into newly allocated memory. If shouldInterleave
+ * is YES, the content is interleaved, using the vertex stride derived from the current element lengths.
+ * Otherwise, each vertex array is given its own tightly packed content.
+ */
+-(void) repackVertexArrays: (NSArray*) vtxArrays interleaving: (BOOL) shouldInterleave {
+	GLuint vtxCount = self.vertexCount;
+	NSUInteger vaCount = vtxArrays.count;
+
+	// Extract all content before releasing any, because interleaved vertex arrays share memory
+	GLbyte** packedContent = malloc(vaCount * sizeof(GLbyte*));
+	for (NSUInteger vaIdx = 0; vaIdx < vaCount; vaIdx++) {
+		CC3VertexArray* va = [vtxArrays objectAtIndex: vaIdx];
+		GLuint elemLen = va.elementLength;
+		packedContent[vaIdx] = malloc(vtxCount * elemLen);
+		for (GLuint vtxIdx = 0; vtxIdx < vtxCount; vtxIdx++)
+			memcpy(packedContent[vaIdx] + (vtxIdx * elemLen), [va addressOfElement: vtxIdx], elemLen);
+	}
+	for (CC3VertexArray* va in vtxArrays) va.allocatedVertexCapacity = 0;
+
+	if (shouldInterleave) {
+		[self updateVertexStride];
+		self.allocatedVertexCapacity = vtxCount;
+	} else {
+		for (CC3VertexArray* va in vtxArrays) {
+			va.elementOffset = 0;
+			va.vertexStride = 0;
+			va.allocatedVertexCapacity = vtxCount;
+		}
+	}
+
+	for (NSUInteger vaIdx = 0; vaIdx < vaCount; vaIdx++) {
+		CC3VertexArray* va = [vtxArrays objectAtIndex: vaIdx];
+		GLuint elemLen = va.elementLength;
+		for (GLuint vtxIdx = 0; vtxIdx < vtxCount; vtxIdx++)
+			memcpy([va addressOfElement: vtxIdx], packedContent[vaIdx] + (vtxIdx * elemLen), elemLen);
+		free(packedContent[vaIdx]);
+	}
+	free(packedContent);
+}
+
+/**
+ * Quantizes the specified vertex array, if it exists and the quantization is neither
+ * kCC3VertexQuantizationNone nor the current quantization, and returns the number of bytes saved.
+ * Skipping the current quantization ensures that a mesh that is shared by several nodes is not
+ * degraded by being quantized more than once.
+ *
+ * If shouldAllowDecoding is NO, the vertex array is not quantized if the quantized content
+ * would need to be decoded by the vertex shader.
+ */
+static NSInteger CC3QuantizeVertexArray(CC3VertexArray* va, CC3VertexQuantization quantization, BOOL shouldAllowDecoding) {
+	if ( !va || quantization == kCC3VertexQuantizationNone || quantization == va.quantization ) return 0;
+	if ( ![va supportsQuantization: quantization] ) {
+		LogRez(@"%@ does not support %@ and will not be quantized", va, NSStringFromCC3VertexQuantization(quantization));
+		return 0;
+	}
+	if ( !shouldAllowDecoding && [va requiresDecodingForQuantization: quantization] ) {
+		LogRez(@"%@ would require shader decoding as %@ and will not be quantized",
+			   va, NSStringFromCC3VertexQuantization(quantization));
+		return 0;
+	}
+	CC3VertexQuantizationStatistics vqStats = [va quantizeAs: quantization];
+	return (NSInteger)vqStats.originalByteCount - (NSInteger)vqStats.quantizedByteCount;
+}
+
+-(NSInteger) quantizeVertexLocationsAs: (CC3VertexQuantization) locQuantization
+							 normalsAs: (CC3VertexQuantization) normalQuantization
+				  textureCoordinatesAs: (CC3VertexQuantization) texCoordQuantization
+						 boneWeightsAs: (CC3VertexQuantization) weightQuantization {
+	return [self quantizeVertexLocationsAs: locQuantization
+								 normalsAs: normalQuantization
+					  textureCoordinatesAs: texCoordQuantization
+							 boneWeightsAs: weightQuantization
+						 allowingDecoding: YES];
+}
+
+/**
+ * Quantizes the vertex content using the specified formats. If shouldAllowDecoding is NO, any
+ * vertex array whose quantized content would need to be decoded by the vertex shader is left
+ * in its current format.
+ */
+-(NSInteger) quantizeVertexLocationsAs: (CC3VertexQuantization) locQuantization
+							 normalsAs: (CC3VertexQuantization) normalQuantization
+				  textureCoordinatesAs: (CC3VertexQuantization) texCoordQuantization
+						 boneWeightsAs: (CC3VertexQuantization) weightQuantization
+					  allowingDecoding: (BOOL) shouldAllowDecoding {
+#if CC3_OGLES_1
+	LogRez(@"%@ cannot quantize vertex content under OpenGL ES 1.", self);
+	return 0;
+#else
+	if ( !_vertexLocations.vertices || (_vertexIndices && !_vertexIndices.vertices) ) {
+		LogRez(@"%@ does not contain vertex content in memory and cannot be quantized.", self);
+		return 0;
+	}
+
+	BOOL wasUsingGLBuffers = self.isUsingGLBuffers;
+	if (wasUsingGLBuffers) [self deleteGLBuffers];
+
+	// Element lengths change during quantization, so give each vertex array its own content
+	NSArray* vtxArrays = self.vertexContentArrays;
+	[self repackVertexArrays: vtxArrays interleaving: NO];
+
+	NSInteger bytesSaved = CC3QuantizeVertexArray(_vertexLocations, locQuantization, shouldAllowDecoding);
+	bytesSaved += CC3QuantizeVertexArray(_vertexNormals, normalQuantization, shouldAllowDecoding);
+	bytesSaved += CC3QuantizeVertexArray(_vertexTangents, normalQuantization, shouldAllowDecoding);
+	bytesSaved += CC3QuantizeVertexArray(_vertexBitangents, normalQuantization, shouldAllowDecoding);
+	bytesSaved += CC3QuantizeVertexArray(_vertexTextureCoordinates, texCoordQuantization, shouldAllowDecoding);
+	for (CC3VertexTextureCoordinates* otc in _overlayTextureCoordinates)
+		bytesSaved += CC3QuantizeVertexArray(otc, texCoordQuantization, shouldAllowDecoding);
+	bytesSaved += CC3QuantizeVertexArray(_vertexBoneWeights, weightQuantization, shouldAllowDecoding);
+
+	if (_shouldInterleaveVertices) [self repackVertexArrays: vtxArrays interleaving: YES];
+	if (wasUsingGLBuffers) [self createGLBuffers];
+
+	_faces.mesh = self;		// Clears face caches built from the original vertex content
+
+	LogRez(@"%@ quantized vertex content to %u bytes per vertex, saving %li bytes",
+		   self, self.vertexStride, (long)bytesSaved);
+	return bytesSaved;
+#endif	// CC3_OGLES_1
+}
+
+-(NSInteger) quantizeVertexContent {
+	return [self quantizeVertexLocationsAs: kCC3VertexQuantizationNone
+								 normalsAs: kCC3VertexQuantizationByte
+					  textureCoordinatesAs: kCC3VertexQuantizationShort
+							 boneWeightsAs: kCC3VertexQuantizationByte
+						  allowingDecoding: NO];
+}
+
+
 #pragma mark CCRGBAProtocol support
 
 -(CCColorRef) color { return _vertexColors ? _vertexColors.color : CCColorRefFromCCC4F(kCCC4FBlackTransparent); }
@@ -1779,10 +2220,24 @@ static GLuint lastAssignedMeshTag;
 
 -(void) markIndicesDirty { _indicesAreDirty = YES; }
 
+/**
+ * If the vertex locations of the mesh have changed since the face centers, normals and planes
+ * were cached, marks those that are held in memory allocated by this instance as dirty.
+ */
+-(void) checkVertexLocationsVersion {
+	GLuint locVersion = _mesh.vertexLocations.contentVersion;
+	if (locVersion == _vertexLocationsVersion) return;
+	_vertexLocationsVersion = locVersion;
+	if (_centersAreRetained) _centersAreDirty = YES;
+	if (_normalsAreRetained) _normalsAreDirty = YES;
+	if (_planesAreRetained) _planesAreDirty = YES;
+}
+
 
 #pragma mark Centers
 
 -(CC3Vector*) centers {
+	[self checkVertexLocationsVersion];
 	if (_centersAreDirty || !_centers) [self populateCenters];
 	return _centers;
 }
@@ -1838,6 +2293,7 @@ static GLuint lastAssignedMeshTag;
 #pragma mark Normals
 
 -(CC3Vector*) normals {
+	[self checkVertexLocationsVersion];
 	if (_normalsAreDirty || !_normals) [self populateNormals];
 	return _normals;
 }
@@ -1893,6 +2349,7 @@ static GLuint lastAssignedMeshTag;
 #pragma mark Planes
 
 -(CC3Plane*) planes {
+	[self checkVertexLocationsVersion];
 	if (_planesAreDirty || !_planes) [self populatePlanes];
 	return _planes;
 }
@@ -34,6 +34,8 @@
 #import "CC3NodeVisitor.h"
 #import "CC3ShaderSemantics.h"
 
+@class CC3Matrix;
+
 
 #pragma mark -
 #pragma mark CC3VertexArrayContent
@@ -70,6 +72,43 @@
 @end
 
 
+#pragma mark -
+#pragma mark Vertex quantization
+
+/**
+ * Enumeration of the compact formats in which the content of a vertex array can be stored.
+ *
+ * Quantized vertex content requires OpenGL ES 2 or OpenGL. Some formats remap or encode the
+ * content, and require a shader that decodes it, using the quantizationScale and quantizationOffset
+ * properties of the vertex array. The stock Cocos3D shaders do not decode quantized content.
+ * Use the requiresDecodingForQuantization: method of CC3VertexArray to determine whether
+ * a particular format requires decoding.
+ */
+typedef enum {
+	kCC3VertexQuantizationNone = 0,		/**< Full-precision GL_FLOAT content. */
+	kCC3VertexQuantizationByte,			/**< Normalized 8-bit integer components. */
+	kCC3VertexQuantizationShort,		/**< Normalized 16-bit integer components, remapped to cover the range of the content. */
+	kCC3VertexQuantizationOctahedral,	/**< Unit vectors encoded as two normalized 16-bit components, using an octahedral mapping. */
+	kCC3VertexQuantizationHalfFloat,	/**< 16-bit IEEE 754 half-precision floating point components. */
+} CC3VertexQuantization;
+
+/** Returns a string description of the specified vertex quantization. */
+NSString* NSStringFromCC3VertexQuantization(CC3VertexQuantization quantization);
+
+/** Describes the effect of quantizing the content of a vertex array. */
+typedef struct {
+	GLuint originalByteCount;		/**< The number of bytes occupied by the vertex content before quantization. */
+	GLuint quantizedByteCount;		/**< The number of bytes occupied by the vertex content after quantization. */
+	GLfloat maximumError;			/**< The largest difference between any original and reconstructed component. */
+} CC3VertexQuantizationStatistics;
+
+/** Returns a string description of the specified vertex quantization statistics. */
+static inline NSString* NSStringFromCC3VertexQuantizationStatistics(CC3VertexQuantizationStatistics stats) {
+	return [NSString stringWithFormat: @"(bytes: %u -> %u, max error: %.6f)",
+			stats.originalByteCount, stats.quantizedByteCount, stats.maximumError];
+}
+
+
 #pragma mark -
 #pragma mark CC3VertexArray
 
@@ -139,9 +178,13 @@
 	GLint _elementSize;
 	GLenum _elementType;
 	GLuint _allocatedVertexCapacity;
+	CC3Vector _quantizationScale;
+	CC3Vector _quantizationOffset;
+	CC3VertexQuantization _quantization;
 
 //	NSRange _dirtyVertexRange;
 	GLvoid* _vertices;
+	id _vertexContentOwner;
 	GLuint _vertexCount;
 	GLuint _bufferID;
 	GLenum _bufferUsage;
@@ -205,6 +248,23 @@
 /** @deprecated Renamed to vertices. */
 @property(nonatomic, assign) GLvoid* elements __deprecated;
 
+/**
+ * An optional object that owns the externally managed memory referenced by the vertices property.
+ *
+ * When the vertices property references memory that is neither allocated nor managed by this
+ * instance, such as vertex content that is referenced in place within a memory-mapped file,
+ * the object that owns that memory can be assigned to this property. That object will be
+ * retained for as long as this instance references the vertex content, and will be released
+ * automatically when the vertices property is changed, when the vertex content is released
+ * by the releaseRedundantContent method, or when this instance is deallocated.
+ *
+ * When interleaving content with another vertex array, or copying another vertex array,
+ * the value of this property is copied along with the vertices reference.
+ *
+ * Set this property after setting the vertices property. The initial value is nil.
+ */
+@property(nonatomic, retain) id vertexContentOwner;
+
 /**
  * The number of vertices in the underlying content referenced by the vertices property.
  * The vertices property must point to an underlying memory space that is large enough
@@ -346,6 +406,104 @@
 @property(nonatomic, assign) GLenum bufferUsage;
 
 
+#pragma mark Quantization
+
+/**
+ * Indicates the compact format in which the content of this vertex array is currently stored.
+ *
+ * This property is set by the quantizeAs: method. The initial value is kCC3VertexQuantizationNone.
+ */
+@property(nonatomic, readonly) CC3VertexQuantization quantization;
+
+/**
+ * The scale that is applied to each of the first three stored components of each vertex, after
+ * any normalization, and before adding the quantizationOffset, to reconstruct the original content.
+ *
+ * Quantized content that was remapped to fit the range of its format must be decoded by the
+ * vertex shader. The kCC3SemanticVertexLocationScale and kCC3SemanticVertexTexCoordScale
+ * uniform semantics make this value available to the shader.
+ *
+ * The initial value is kCC3VectorUnitCube, indicating that the content is not remapped.
+ */
+@property(nonatomic, readonly) CC3Vector quantizationScale;
+
+/**
+ * The offset that is added to each of the first three stored components of each vertex, after
+ * applying the quantizationScale, to reconstruct the original content.
+ *
+ * The kCC3SemanticVertexLocationOffset and kCC3SemanticVertexTexCoordOffset uniform semantics
+ * make this value available to the shader.
+ *
+ * The initial value is kCC3VectorZero, indicating that the content is not remapped.
+ */
+@property(nonatomic, readonly) CC3Vector quantizationOffset;
+
+/**
+ * Returns whether the content of this vertex array can be stored in the specified format.
+ *
+ * Vertex locations support kCC3VertexQuantizationShort and kCC3VertexQuantizationHalfFloat.
+ * Vertex normals and tangents support kCC3VertexQuantizationByte, kCC3VertexQuantizationOctahedral
+ * and kCC3VertexQuantizationHalfFloat. Texture coordinates support kCC3VertexQuantizationShort and
+ * kCC3VertexQuantizationHalfFloat. Bone weights support kCC3VertexQuantizationByte. Each of these
+ * also supports kCC3VertexQuantizationNone, which restores full-precision content. Other vertex
+ * arrays do not support quantization.
+ */
+-(BOOL) supportsQuantization: (CC3VertexQuantization) quantization;
+
+/**
+ * Returns whether storing the content of this vertex array in the specified format requires the
+ * vertex shader to decode it, because the content is remapped to fit the range of the format, or
+ * is encoded.
+ *
+ * Content that does not require decoding is converted back to its original values by the GL
+ * engine, within the precision of the format, and can be drawn by any shader, including the stock
+ * Cocos3D shaders. Content that requires decoding can only be drawn by a shader that decodes it.
+ *
+ * Vertex locations require decoding in all quantized formats. Vertex normals and tangents require
+ * decoding only for kCC3VertexQuantizationOctahedral. Texture coordinates require decoding for
+ * kCC3VertexQuantizationShort only if they extend outside the range 0 to 1. Bone weights never
+ * require decoding.
+ */
+-(BOOL) requiresDecodingForQuantization: (CC3VertexQuantization) quantization;
+
+/**
+ * Converts the vertex content of this vertex array to the specified compact format, and returns
+ * statistics describing the memory saved and the accuracy of the reconstructed content.
+ *
+ * The elementType, elementSize and shouldNormalizeContent properties are set to suit the format,
+ * and the quantizationScale and quantizationOffset properties are set to the values needed to
+ * reconstruct the original content from the stored components:
+ *   - kCC3VertexQuantizationShort and kCC3VertexQuantizationHalfFloat locations are remapped so
+ *     that the bounding box of the vertices spans the range -1 to +1 in each dimension, and are
+ *     padded to four components, with a w component of one, to keep each element word-aligned.
+ *   - kCC3VertexQuantizationByte normals and tangents are stored as four normalized GL_BYTE
+ *     components, and can be used as is by any shader.
+ *   - kCC3VertexQuantizationOctahedral normals and tangents are stored as two normalized GL_SHORT
+ *     components, which the shader must decode into a unit vector.
+ *   - kCC3VertexQuantizationShort texture coordinates are stored as normalized GL_UNSIGNED_SHORT
+ *     components. They are remapped only if they extend outside the range 0 to 1, so texture
+ *     coordinates that lie within a single texture tile can be used as is by any shader.
+ *   - kCC3VertexQuantizationByte bone weights are stored as normalized GL_UNSIGNED_BYTE components,
+ *     rounded so that the weights of each vertex continue to add up to one.
+ *
+ * Signed normalized components are encoded to match the conversion performed by the GL engine
+ * when drawing, which maps a component c of b bits to the value (2c + 1) / (2^b - 1).
+ *
+ * The accessor methods of each vertex array subclass continue to read and write the content in
+ * its original form. However, content that is written after quantization is clamped to the range
+ * of the quantized format, so quantization should be performed after all vertex content has been
+ * populated and transformed. The transformVertices:startingAt:by: method does not support
+ * quantized content.
+ *
+ * This vertex array must contain vertex content that is not interleaved with the content of any
+ * other vertex array. To quantize interleaved content, use the quantization methods of CC3Mesh,
+ * which separate and re-interleave the content of all of the vertex arrays of the mesh.
+ *
+ * Quantized vertex content is only supported under OpenGL ES 2 and OpenGL.
+ */
+-(CC3VertexQuantizationStatistics) quantizeAs: (CC3VertexQuantization) quantization;
+
+
 #pragma mark Allocation and initialization
 
 /**
@@ -592,6 +750,26 @@
 /** @deprecated Renamed to releaseRedundantContent. */
 -(void) releaseRedundantData __deprecated;
 
+/**
+ * Returns the number of bytes of application memory occupied by vertex content that has
+ * been allocated, and is managed, by this instance, via the allocatedVertexCapacity property.
+ *
+ * Vertex content that is managed externally, such as content referenced in place within a
+ * memory-mapped file, is not included. Once the vertex content has been released by the
+ * releaseRedundantContent method, this property returns zero.
+ */
+@property(nonatomic, readonly) NSUInteger applicationMemoryBytes;
+
+/**
+ * Returns an estimate of the number of bytes of GL memory occupied by the GL vertex buffer
+ * object holding the vertex content of this instance, or zero if the vertex content has not
+ * been buffered to the GL engine using the createGLBuffer method.
+ *
+ * When interleaved vertex content is shared by several vertex arrays, each of those vertex
+ * arrays reports the size of the same GL buffer.
+ */
+@property(nonatomic, readonly) NSUInteger glMemoryBytes;
+
 /**
  * Binds the vertex content to the vertex attribute at the specified index in the GL engine.
  *
@@ -708,6 +886,39 @@
 /** @deprecated Renamed to describeVertices:startingAt:. */
 -(NSString*) describeElements: (GLuint) vtxCount startingAt: (GLuint) startElem __deprecated;
 
+
+#pragma mark Transforming vertices
+
+/**
+ * Transforms the content of the specified number of vertices, starting at the specified
+ * vertex index, by the specified matrix.
+ *
+ * How the content is transformed depends on the kind of content held by this vertex array.
+ * CC3VertexLocations transforms its content as locations. CC3VertexNormals transforms its
+ * content by the inverse-transpose of the matrix, so that normals remain perpendicular to
+ * the surface under non-uniform scaling. CC3VertexTangents transforms its content as directions.
+ * Normals and tangents are normalized after being transformed. Other vertex arrays do not
+ * contain content that can be transformed by a matrix, and raise an assertion error.
+ *
+ * Vertex content is transformed directly in memory, taking into consideration the vertexStride
+ * and elementOffset properties, so interleaved content can be transformed without disturbing the
+ * other vertex content. Vector instructions are used when available, and very large vertex ranges
+ * are split across several threads. The elementType property must be GL_FLOAT, and the elementSize
+ * property must be at least three. If not, such as when the content has been quantized, an error is
+ * logged and the content is left unchanged. Only the first three components of each element are changed.
+ *
+ * This method does not update the GL buffer. Once all changes have been made, invoke the
+ * updateGLBuffer method to copy the transformed vertex content to the GL engine.
+ */
+-(void) transformVertices: (GLuint) vtxCount startingAt: (GLuint) startIdx by: (CC3Matrix*) aMatrix;
+
+/**
+ * Transforms the content of all vertices in this vertex array by the specified matrix.
+ *
+ * See the transformVertices:startingAt:by: method for more information.
+ */
+-(void) transformBy: (CC3Matrix*) aMatrix;
+
 @end
 
 
@@ -879,6 +1090,7 @@
 	CC3Box _boundingBox;
 	CC3Vector _centerOfGeometry;
 	GLfloat _radius;
+	GLuint _contentVersion;
 	BOOL _boundaryIsDirty : 1;
 	BOOL _radiusIsDirty : 1;
 }
@@ -911,9 +1123,47 @@
  */
 @property(nonatomic, readonly) GLfloat radius;
 
-/** Marks the boundary, including bounding box and radius, as dirty, and need of recalculation. */
+/**
+ * Marks the boundary, including bounding box and radius, as dirty, and need of recalculation.
+ *
+ * Since the boundary is marked dirty whenever the vertex locations change, this method also
+ * increments the value of the contentVersion property.
+ */
 -(void) markBoundaryDirty;
 
+/**
+ * Returns a number that changes each time the vertex locations are changed, either through the
+ * methods of this instance, or by invoking one of the updateGLBuffer methods after changing the
+ * vertex content directly.
+ *
+ * Content that is derived from the vertex locations, such as the shadow volume of a mesh node,
+ * can compare this value with the value at the time the content was derived, to determine
+ * whether the content must be rebuilt.
+ */
+@property(nonatomic, readonly) GLuint contentVersion;
+
+/**
+ * Returns the axially-aligned bounding box of the specified number of vertices,
+ * starting at the specified vertex index.
+ *
+ * Vertex locations are read directly from memory, taking into consideration the vertexStride
+ * property. Vector instructions are used when available, and very large vertex ranges are
+ * split across several threads. The elementType property must be GL_FLOAT.
+ *
+ * If the vertex count is zero, returns the null bounding box.
+ */
+-(CC3Box) boundingBoxOfVertices: (GLuint) vtxCount startingAt: (GLuint) startIdx;
+
+/**
+ * Returns the spherical boundary, centered on the specified location, that encompasses
+ * the specified number of vertices, starting at the specified vertex index.
+ *
+ * Vertex locations are read directly from memory, taking into consideration the vertexStride
+ * property. Vector instructions are used when available, and very large vertex ranges are
+ * split across several threads. The elementType property must be GL_FLOAT.
+ */
+-(CC3Sphere) boundingSphereAround: (CC3Vector) center ofVertices: (GLuint) vtxCount startingAt: (GLuint) startIdx;
+
 /**
  * Returns the location element at the specified index in the underlying vertex content.
  *
@@ -1814,7 +2064,9 @@ static const CGRect kCC3UnitTextureRectangle = { {0.0, 0.0}, {1.0, 1.0} };
  * must not be larger than the maximum number of available bone influences allowed by the 
  * platform, which can be retreived from CC3OpenGL.sharedGL.maxNumberOfBoneInfluencesPerVertex.
 */
-@interface CC3VertexBoneWeights : CC3VertexArray
+@interface CC3VertexBoneWeights : CC3VertexArray {
+	GLfloat* _decodedBoneWeights;
+}
 
 /**
  * Returns the weight value, for the specified influence index within the vertex, for the
@@ -1861,6 +2113,11 @@ static const CGRect kCC3UnitTextureRectangle = { {0.0, 0.0}, {1.0, 1.0} };
  * The vertex index refers to vertices, not bytes. The implementation takes into consideration
  * the vertexStride and elementOffset properties to access the correct vertices.
  *
+ * If the elementType property is GL_FLOAT, the returned array references the underlying vertex
+ * content directly. If the bone weights have been quantized, the weights are decoded into an array
+ * that is held by this instance, and is overwritten on the next invocation of this method. In that
+ * case, changing the values in the returned array does not change the underlying vertex content.
+ *
  * If the releaseRedundantContent method has been invoked and the underlying
  * vertex content has been released, this method will raise an assertion exception.
  */
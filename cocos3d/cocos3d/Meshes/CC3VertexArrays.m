@@ -32,6 +32,7 @@
 #import "CC3VertexArrays.h"
 #import "CC3Mesh.h"
 #import "CC3OpenGLUtility.h"
+#import "CC3Matrix.h"
 
 
 #pragma mark -
@@ -62,6 +63,224 @@
 #pragma mark -
 #pragma mark CC3VertexArray
 
+/** Vertex ranges of at least this many vertices are processed concurrently, in chunks. */
+#define kCC3VertexArrayConcurrentVertexCount	(64 * 1024)
+
+/** The number of vertices in each chunk of a vertex range that is processed concurrently. */
+#define kCC3VertexArrayConcurrentChunkSize		(16 * 1024)
+
+/**
+ * Per-chunk results of vertex ranges split into no more than this many chunks are gathered
+ * into buffers on the stack, instead of allocating those buffers on the heap each frame.
+ */
+#define kCC3VertexArrayStackChunkCount			16
+
+/** Returns the number of chunks that a vertex range of the specified size will be split into. */
+static GLuint CC3VertexChunkCount(GLuint vtxCount) {
+	if (vtxCount < kCC3VertexArrayConcurrentVertexCount) return 1;
+	return (vtxCount + kCC3VertexArrayConcurrentChunkSize - 1) / kCC3VertexArrayConcurrentChunkSize;
+}
+
+/**
+ * Invokes the specified block once for each chunk of a vertex range of the specified size,
+ * passing the index of the chunk, and the offset and size of the chunk within the range.
+ * Small ranges are processed as a single chunk on the current thread. Large ranges are
+ * split into chunks that are processed concurrently, and this function returns once
+ * all chunks have been processed.
+ */
+static void CC3VertexChunksApply(GLuint vtxCount, void (^block)(GLuint chunkIdx, GLuint chunkOffset, GLuint chunkVtxCount)) {
+	GLuint chunkCnt = CC3VertexChunkCount(vtxCount);
+	if (chunkCnt == 1) {
+		block(0, 0, vtxCount);
+		return;
+	}
+	dispatch_apply(chunkCnt, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t chunkIdx) {
+		GLuint chunkOffset = (GLuint)chunkIdx * kCC3VertexArrayConcurrentChunkSize;
+		block((GLuint)chunkIdx, chunkOffset, MIN(kCC3VertexArrayConcurrentChunkSize, vtxCount - chunkOffset));
+	});
+}
+
+NSString* NSStringFromCC3VertexQuantization(CC3VertexQuantization quantization) {
+	switch (quantization) {
+		case kCC3VertexQuantizationNone: return @"kCC3VertexQuantizationNone";
+		case kCC3VertexQuantizationByte: return @"kCC3VertexQuantizationByte";
+		case kCC3VertexQuantizationShort: return @"kCC3VertexQuantizationShort";
+		case kCC3VertexQuantizationOctahedral: return @"kCC3VertexQuantizationOctahedral";
+		case kCC3VertexQuantizationHalfFloat: return @"kCC3VertexQuantizationHalfFloat";
+		default: return [NSString stringWithFormat: @"Unknown vertex quantization (%u)", quantization];
+	}
+}
+
+/**
+ * Returns the float value of the specified signed normalized integer component, whose type spans
+ * the specified number of distinct steps (2^b - 1, for a type of b bits). As the GL engine does
+ * when drawing, the value is (2c + 1) / (2^b - 1), so the extremes of the type map to -1 and +1.
+ */
+static inline GLfloat CC3FloatFromSignedNormalized(GLfloat comp, GLfloat stepCount) {
+	return ((2.0f * comp) + 1.0f) / stepCount;
+}
+
+/**
+ * Returns the signed normalized integer component, before rounding, whose float value, as
+ * returned by CC3FloatFromSignedNormalized, is the specified value, clamped to the range -1 to +1.
+ */
+static inline GLfloat CC3SignedNormalizedFromFloat(GLfloat value, GLfloat stepCount) {
+	return ((CLAMP(value, -1.0f, 1.0f) * stepCount) - 1.0f) * 0.5f;
+}
+
+/**
+ * Returns the value of the specified component of the vertex element at the specified address,
+ * converted to a float. Normalized integer components are converted to the range 0 to 1 for
+ * unsigned types, or -1 to 1 for signed types, as the GL engine does when drawing.
+ */
+static GLfloat CC3VertexComponentAt(const GLvoid* elem, GLuint compIdx, GLenum type, BOOL isNormalized) {
+	switch (type) {
+		case GL_FLOAT:
+			return ((GLfloat*)elem)[compIdx];
+		case GL_HALF_FLOAT_OES:
+			return CC3FloatFromHalfFloat(((GLushort*)elem)[compIdx]);
+		case GL_BYTE: {
+			GLfloat comp = ((GLbyte*)elem)[compIdx];
+			return isNormalized ? CC3FloatFromSignedNormalized(comp, 255.0f) : comp;
+		}
+		case GL_UNSIGNED_BYTE: {
+			GLfloat comp = ((GLubyte*)elem)[compIdx];
+			return isNormalized ? (comp / 255.0f) : comp;
+		}
+		case GL_SHORT: {
+			GLfloat comp = ((GLshort*)elem)[compIdx];
+			return isNormalized ? CC3FloatFromSignedNormalized(comp, 65535.0f) : comp;
+		}
+		case GL_UNSIGNED_SHORT: {
+			GLfloat comp = ((GLushort*)elem)[compIdx];
+			return isNormalized ? (comp / 65535.0f) : comp;
+		}
+		case GL_FIXED:
+			return ((GLfixed*)elem)[compIdx] / 65536.0f;
+		default:
+			CC3Assert(NO, @"Vertex element type %@ cannot be converted to a float", NSStringFromGLEnum(type));
+			return 0.0f;
+	}
+}
+
+/**
+ * Sets the specified component of the vertex element at the specified address from the specified
+ * float value, rounding the value to the nearest value that the component type can represent,
+ * and clamping it to the range of that type.
+ */
+static void CC3VertexComponentSet(GLvoid* elem, GLuint compIdx, GLenum type, BOOL isNormalized, GLfloat value) {
+	switch (type) {
+		case GL_FLOAT:
+			((GLfloat*)elem)[compIdx] = value;
+			break;
+		case GL_HALF_FLOAT_OES:
+			((GLushort*)elem)[compIdx] = CC3HalfFloatFromFloat(value);
+			break;
+		case GL_BYTE:
+			((GLbyte*)elem)[compIdx] = (GLbyte)roundf(isNormalized ? CC3SignedNormalizedFromFloat(value, 255.0f)
+																	: CLAMP(value, -128.0f, 127.0f));
+			break;
+		case GL_UNSIGNED_BYTE:
+			((GLubyte*)elem)[compIdx] = (GLubyte)roundf(isNormalized ? (CLAMP(value, 0.0f, 1.0f) * 255.0f)
+																	 : CLAMP(value, 0.0f, 255.0f));
+			break;
+		case GL_SHORT:
+			((GLshort*)elem)[compIdx] = (GLshort)roundf(isNormalized ? CC3SignedNormalizedFromFloat(value, 65535.0f)
+																	 : CLAMP(value, -32768.0f, 32767.0f));
+			break;
+		case GL_UNSIGNED_SHORT:
+			((GLushort*)elem)[compIdx] = (GLushort)roundf(isNormalized ? (CLAMP(value, 0.0f, 1.0f) * 65535.0f)
+																	   : CLAMP(value, 0.0f, 65535.0f));
+			break;
+		case GL_FIXED:
+			((GLfixed*)elem)[compIdx] = (GLfixed)roundf(value * 65536.0f);
+			break;
+		default:
+			CC3Assert(NO, @"Vertex element type %@ cannot be set from a float", NSStringFromGLEnum(type));
+			break;
+	}
+}
+
+/** Returns the sign of the specified value, treating zero as positive. */
+static inline GLfloat CC3OctahedralSign(GLfloat value) { return (value >= 0.0f) ? 1.0f : -1.0f; }
+
+/**
+ * Returns the unit vector identified by the specified octahedral coordinates, each in the range
+ * -1 to 1. The upper hemisphere maps to the inner diamond of the square, and the lower hemisphere
+ * is folded over into the corners.
+ */
+static CC3Vector CC3UnitVectorFromOctahedral(GLfloat octX, GLfloat octY) {
+	CC3Vector v = cc3v(octX, octY, (1.0f - fabsf(octX) - fabsf(octY)));
+	if (v.z < 0.0f) {
+		v.x = (1.0f - fabsf(octY)) * CC3OctahedralSign(octX);
+		v.y = (1.0f - fabsf(octX)) * CC3OctahedralSign(octY);
+	}
+	return CC3VectorNormalize(v);
+}
+
+/**
+ * Stores the specified direction in the vertex element at the specified address, as two normalized
+ * GL_SHORT octahedral coordinates. Of the four nearest representable coordinate pairs, the pair
+ * that reconstructs the direction most accurately is chosen.
+ */
+static void CC3VertexSetOctahedral(GLvoid* elem, CC3Vector v) {
+	GLfloat octX = 0.0f, octY = 0.0f;
+	GLfloat l1Len = fabsf(v.x) + fabsf(v.y) + fabsf(v.z);
+	if (l1Len > 0.0f) {
+		octX = v.x / l1Len;
+		octY = v.y / l1Len;
+		if (v.z < 0.0f) {
+			GLfloat foldX = (1.0f - fabsf(octY)) * CC3OctahedralSign(octX);
+			octY = (1.0f - fabsf(octX)) * CC3OctahedralSign(octY);
+			octX = foldX;
+		}
+	}
+	CC3Vector unitV = CC3VectorNormalize(v);
+	GLfloat baseX = floorf(CC3SignedNormalizedFromFloat(octX, 65535.0f));
+	GLfloat baseY = floorf(CC3SignedNormalizedFromFloat(octY, 65535.0f));
+	GLshort* octComps = elem;
+	GLfloat bestDistSq = kCC3MaxGLfloat;
+	for (GLuint candIdx = 0; candIdx < 4; candIdx++) {
+		GLfloat candX = MIN(baseX + (candIdx & 1), 32767.0f);
+		GLfloat candY = MIN(baseY + (candIdx >> 1), 32767.0f);
+		GLfloat distSq = CC3VectorDistanceSquared(unitV, CC3UnitVectorFromOctahedral(CC3FloatFromSignedNormalized(candX, 65535.0f),
+																					 CC3FloatFromSignedNormalized(candY, 65535.0f)));
+		if (distSq < bestDistSq) {
+			bestDistSq = distSq;
+			octComps[0] = (GLshort)candX;
+			octComps[1] = (GLshort)candY;
+		}
+	}
+}
+
+/**
+ * Returns the per-component scale that maps the range between the specified minimum and maximum onto
+ * the range -1 to +1. Components that do not vary are given a scale of one, to avoid dividing by zero.
+ */
+static CC3Vector CC3VertexQuantizationScaleToUnitRange(CC3Vector minComps, CC3Vector maxComps) {
+	CC3Vector halfRange = CC3VectorScaleUniform(CC3VectorDifference(maxComps, minComps), 0.5f);
+	return cc3v((halfRange.x > 0.0f ? halfRange.x : 1.0f),
+				(halfRange.y > 0.0f ? halfRange.y : 1.0f),
+				(halfRange.z > 0.0f ? halfRange.z : 1.0f));
+}
+
+@interface CC3VertexArray (TemplateMethods)
+-(void) transformVertices: (GLuint) vtxCount
+			   startingAt: (GLuint) startIdx
+		   byCC3Matrix4x3: (const CC3Matrix4x3*) mtx
+			  asLocations: (BOOL) isLocation
+			  normalizing: (BOOL) shouldNormalize;
+@property(nonatomic, readonly) GLuint quantizableComponentCount;
+@property(nonatomic, readonly) GLfloat quantizationPaddingValue;
+-(void) getQuantizableComponents: (GLfloat*) comps at: (GLuint) vtxIdx;
+-(void) setQuantizableComponents: (const GLfloat*) comps at: (GLuint) vtxIdx;
+-(void) configureQuantization: (CC3VertexQuantization) quantization
+				  withMinimum: (CC3Vector) minComps
+					  maximum: (CC3Vector) maxComps;
+-(void) configureDirectionQuantization: (CC3VertexQuantization) quantization;
+-(BOOL) supportsDirectionQuantization: (CC3VertexQuantization) quantization;
+@end
+
 @implementation CC3VertexArray
 
 @synthesize vertexCount=_vertexCount, bufferID=_bufferID, bufferUsage=_bufferUsage;
@@ -69,10 +288,13 @@
 @synthesize shouldAllowVertexBuffering=_shouldAllowVertexBuffering;
 @synthesize shouldReleaseRedundantContent=_shouldReleaseRedundantContent;
 @synthesize shouldNormalizeContent=_shouldNormalizeContent;
+@synthesize vertexContentOwner=_vertexContentOwner;
+@synthesize quantization=_quantization, quantizationScale=_quantizationScale;
+@synthesize quantizationOffset=_quantizationOffset;
 
 -(void) dealloc {
 	[self deleteGLBuffer];
-	self.allocatedVertexCapacity = 0;
+	self.allocatedVertexCapacity = 0;		// Also releases any vertex content owner
 //	[_vertexContent release];
 
 	[super dealloc];
@@ -182,6 +404,9 @@
 		_shouldNormalizeContent = NO;
 		_shouldAllowVertexBuffering = YES;
 		_shouldReleaseRedundantContent = YES;
+		_quantization = kCC3VertexQuantizationNone;
+		_quantizationScale = kCC3VectorUnitCube;
+		_quantizationOffset = kCC3VectorZero;
 		_semantic = self.class.defaultSemantic;
 	}
 	return self;
@@ -202,6 +427,7 @@
 	self.vertexCount = otherVtxArray.vertexCount;
 	self.elementOffset = elemOffset;
 	self.vertices = otherVtxArray.vertices;		// Must do last, because can be cleared by other setters.
+	self.vertexContentOwner = otherVtxArray.vertexContentOwner;
 	return (GLbyte*)self.vertices  + self.elementOffset;
 }
 
@@ -221,6 +447,9 @@
 	_shouldNormalizeContent = another.shouldNormalizeContent;
 	_shouldAllowVertexBuffering = another.shouldAllowVertexBuffering;
 	_shouldReleaseRedundantContent = another.shouldReleaseRedundantContent;
+	_quantization = another.quantization;
+	_quantizationScale = another.quantizationScale;
+	_quantizationOffset = another.quantizationOffset;
 
 	[self deleteGLBuffer];		// Data has yet to be buffered. Get rid of old buffer if necessary.
 
@@ -232,6 +461,7 @@
 		memcpy(_vertices, another.vertices, (_allocatedVertexCapacity * self.vertexStride));
 	} else {
 		_vertices = another.vertices;
+		self.vertexContentOwner = another.vertexContentOwner;
 	}
 	_vertexCount = another.vertexCount;
 }
@@ -257,7 +487,11 @@
 
 	// If current capacity is zero, we may still have an externally set pointer. clear it now so that
 	// we don't reallocate it, or in case of reverting back to zero, we don't leave the pointer hanging.
-	if (_allocatedVertexCapacity == 0) _vertices = NULL;
+	// Since the external content is no longer referenced, release any object that owns it.
+	if (_allocatedVertexCapacity == 0) {
+		_vertices = NULL;
+		self.vertexContentOwner = nil;
+	}
 
 	// If nothing is changing, we don't need to do anything else.
 	// Do this after testing for current zero capacity and clearing pointer.
@@ -400,6 +634,10 @@ static GLuint lastAssignedVertexArrayTag;
 // Deprecated
 -(void) releaseRedundantData { [self releaseRedundantContent]; }
 
+-(NSUInteger) applicationMemoryBytes { return (NSUInteger)_allocatedVertexCapacity * self.vertexStride; }
+
+-(NSUInteger) glMemoryBytes { return _bufferID ? ((NSUInteger)self.availableVertexCount * self.vertexStride) : 0; }
+
 -(void) bindContentToAttributeAt: (GLint) vaIdx withVisitor: (CC3NodeDrawingVisitor*) visitor {
 	if (_bufferID) {											// use GL buffer if it exists
 		LogTrace(@"%@ binding GL buffer containing %u vertices", self, _vertexCount);
@@ -515,6 +753,227 @@ static GLuint lastAssignedVertexArrayTag;
 	return [self describeVertices: vtxCount startingAt: startElem];
 }
 
+
+#pragma mark Quantization
+
+/** Returns the number of components per vertex that are quantized. Subclasses that support quantization will override. */
+-(GLuint) quantizableComponentCount { return 0; }
+
+/** Returns the value stored in any element components beyond the quantizable components. */
+-(GLfloat) quantizationPaddingValue { return 0.0f; }
+
+-(BOOL) supportsQuantization: (CC3VertexQuantization) quantization { return NO; }
+
+-(BOOL) requiresDecodingForQuantization: (CC3VertexQuantization) quantization {
+	return (quantization == kCC3VertexQuantizationOctahedral);
+}
+
+/** Returns whether the specified quantization can be used to store unit direction vectors. */
+-(BOOL) supportsDirectionQuantization: (CC3VertexQuantization) quantization {
+	switch (quantization) {
+		case kCC3VertexQuantizationNone:
+		case kCC3VertexQuantizationByte:
+		case kCC3VertexQuantizationOctahedral:
+		case kCC3VertexQuantizationHalfFloat:
+			return YES;
+		default:
+			return NO;
+	}
+}
+
+/**
+ * Reads the quantizable components of the vertex at the specified index into the specified array,
+ * reconstructing the original content from the stored components.
+ */
+-(void) getQuantizableComponents: (GLfloat*) comps at: (GLuint) vtxIdx {
+	GLvoid* elem = [self addressOfElement: vtxIdx];
+
+	if (_quantization == kCC3VertexQuantizationOctahedral) {
+		CC3Vector v = CC3UnitVectorFromOctahedral(CC3VertexComponentAt(elem, 0, _elementType, _shouldNormalizeContent),
+												  CC3VertexComponentAt(elem, 1, _elementType, _shouldNormalizeContent));
+		comps[0] = v.x;
+		comps[1] = v.y;
+		comps[2] = v.z;
+		return;
+	}
+
+	GLfloat* scale = (GLfloat*)&_quantizationScale;
+	GLfloat* offset = (GLfloat*)&_quantizationOffset;
+	GLuint compCnt = self.quantizableComponentCount;
+	for (GLuint compIdx = 0; compIdx < compCnt; compIdx++) {
+		GLfloat comp = (compIdx < _elementSize) ? CC3VertexComponentAt(elem, compIdx, _elementType, _shouldNormalizeContent) : 0.0f;
+		comps[compIdx] = (compIdx < 3) ? ((comp * scale[compIdx]) + offset[compIdx]) : comp;
+	}
+}
+
+/**
+ * Writes the quantizable components in the specified array to the vertex at the specified index,
+ * encoding them into the stored format. Any further components in the element are padded with
+ * the value of the quantizationPaddingValue property.
+ */
+-(void) setQuantizableComponents: (const GLfloat*) comps at: (GLuint) vtxIdx {
+	GLvoid* elem = [self addressOfElement: vtxIdx];
+
+	if (_quantization == kCC3VertexQuantizationOctahedral) {
+		CC3VertexSetOctahedral(elem, cc3v(comps[0], comps[1], comps[2]));
+		return;
+	}
+
+	GLfloat* scale = (GLfloat*)&_quantizationScale;
+	GLfloat* offset = (GLfloat*)&_quantizationOffset;
+	GLuint compCnt = self.quantizableComponentCount;
+	GLfloat padVal = self.quantizationPaddingValue;
+	for (GLuint compIdx = 0; compIdx < _elementSize; compIdx++) {
+		GLfloat comp = padVal;
+		if (compIdx < compCnt) comp = (compIdx < 3) ? ((comps[compIdx] - offset[compIdx]) / scale[compIdx]) : comps[compIdx];
+		CC3VertexComponentSet(elem, compIdx, _elementType, _shouldNormalizeContent, comp);
+	}
+}
+
+/**
+ * Sets the quantization, elementType, elementSize, shouldNormalizeContent, quantizationScale and
+ * quantizationOffset properties to suit the specified quantization of content that covers the
+ * specified range. Does not allocate vertex memory.
+ *
+ * This implementation configures full-precision content. Subclasses will override.
+ */
+-(void) configureQuantization: (CC3VertexQuantization) quantization
+				  withMinimum: (CC3Vector) minComps
+					  maximum: (CC3Vector) maxComps {
+	_quantization = quantization;
+	_quantizationScale = kCC3VectorUnitCube;
+	_quantizationOffset = kCC3VectorZero;
+	_elementType = GL_FLOAT;
+	_elementSize = self.quantizableComponentCount;
+	_shouldNormalizeContent = NO;
+}
+
+/** Configures the element format to hold unit direction vectors using the specified quantization. */
+-(void) configureDirectionQuantization: (CC3VertexQuantization) quantization {
+	switch (quantization) {
+		case kCC3VertexQuantizationByte:
+			_elementType = GL_BYTE;
+			_elementSize = 4;			// Keep element word-aligned
+			_shouldNormalizeContent = YES;
+			break;
+		case kCC3VertexQuantizationOctahedral:
+			_elementType = GL_SHORT;
+			_elementSize = 2;
+			_shouldNormalizeContent = YES;
+			break;
+		case kCC3VertexQuantizationHalfFloat:
+			_elementType = GL_HALF_FLOAT_OES;
+			_elementSize = 4;			// Keep element word-aligned
+			break;
+		default:
+			break;
+	}
+}
+
+-(CC3VertexQuantizationStatistics) quantizeAs: (CC3VertexQuantization) quantization {
+	CC3VertexQuantizationStatistics stats = { 0, 0, 0.0f };
+	CC3Assert([self supportsQuantization: quantization], @"%@ does not support %@",
+			  self, NSStringFromCC3VertexQuantization(quantization));
+	CC3Assert(_elementOffset == 0 && self.vertexStride == self.elementLength,
+			  @"%@ cannot quantize vertex content that is interleaved with other vertex content."
+			  @" Use the quantization methods of CC3Mesh instead.", self);
+
+	GLuint vtxCnt = _vertexCount;
+	GLuint compCnt = self.quantizableComponentCount;
+	stats.originalByteCount = vtxCnt * self.elementLength;
+
+	// Extract the original content, along with its range
+	GLfloat* origComps = malloc(((vtxCnt + 1) * compCnt) * sizeof(GLfloat));
+	if ( !origComps ) {
+		LogError(@"%@ could not allocate space to quantize %u vertices", self, vtxCnt);
+		return stats;
+	}
+	CC3Vector minComps = kCC3VectorZero;
+	CC3Vector maxComps = kCC3VectorZero;
+	for (GLuint vtxIdx = 0; vtxIdx < vtxCnt; vtxIdx++) {
+		GLfloat* comps = origComps + (vtxIdx * compCnt);
+		[self getQuantizableComponents: comps at: vtxIdx];
+		CC3Vector v = cc3v(comps[0], (compCnt > 1 ? comps[1] : 0.0f), (compCnt > 2 ? comps[2] : 0.0f));
+		minComps = (vtxIdx == 0) ? v : CC3VectorMinimize(minComps, v);
+		maxComps = (vtxIdx == 0) ? v : CC3VectorMaximize(maxComps, v);
+	}
+
+	// Replace the content with new content in the quantized format
+	self.allocatedVertexCapacity = 0;
+	_vertexStride = 0;
+	[self configureQuantization: quantization withMinimum: minComps maximum: maxComps];
+	self.allocatedVertexCapacity = vtxCnt;
+	for (GLuint vtxIdx = 0; vtxIdx < vtxCnt; vtxIdx++)
+		[self setQuantizableComponents: (origComps + (vtxIdx * compCnt)) at: vtxIdx];
+
+	// Measure how accurately the quantized content reconstructs the original content.
+	// The extra space at the end of the original content is used to hold each reconstruction.
+	GLfloat* qComps = origComps + (vtxCnt * compCnt);
+	for (GLuint vtxIdx = 0; vtxIdx < vtxCnt; vtxIdx++) {
+		GLfloat* comps = origComps + (vtxIdx * compCnt);
+		[self getQuantizableComponents: qComps at: vtxIdx];
+		for (GLuint compIdx = 0; compIdx < compCnt; compIdx++)
+			stats.maximumError = MAX(stats.maximumError, fabsf(qComps[compIdx] - comps[compIdx]));
+	}
+	free(origComps);
+
+	stats.quantizedByteCount = vtxCnt * self.elementLength;
+
+	// The size of the content may have changed, so a new GL buffer is needed
+	if (self.isUsingGLBuffer) {
+		[self deleteGLBuffer];
+		[self createGLBuffer];
+	}
+
+	LogRez(@"%@ quantized as %@ %@", self, NSStringFromCC3VertexQuantization(quantization),
+		   NSStringFromCC3VertexQuantizationStatistics(stats));
+	return stats;
+}
+
+
+#pragma mark Transforming vertices
+
+-(void) transformVertices: (GLuint) vtxCount startingAt: (GLuint) startIdx by: (CC3Matrix*) aMatrix {
+	CC3Assert(NO, @"%@ does not contain vertex content that can be transformed by a matrix.", self);
+}
+
+-(void) transformBy: (CC3Matrix*) aMatrix { [self transformVertices: _vertexCount startingAt: 0 by: aMatrix]; }
+
+/**
+ * Transforms the first three components of each of the specified vertices, as either locations
+ * or directions, by the specified matrix, and optionally normalizes each transformed vector.
+ */
+-(void) transformVertices: (GLuint) vtxCount
+			   startingAt: (GLuint) startIdx
+		   byCC3Matrix4x3: (const CC3Matrix4x3*) mtx
+			  asLocations: (BOOL) isLocation
+			  normalizing: (BOOL) shouldNormalize {
+	if (vtxCount == 0) return;
+	if ( !(_elementType == GL_FLOAT && _elementSize >= 3) ) {
+		LogError(@"%@ must have elementType GL_FLOAT and elementSize of at least 3 to be transformed", self);
+		return;
+	}
+	CC3Assert(startIdx + vtxCount <= _vertexCount, @"%@ cannot transform %u vertices starting at %u because it only contains %u vertices",
+			  self, vtxCount, startIdx, _vertexCount);
+
+	GLbyte* firstVtx = [self addressOfElement: startIdx];
+	GLuint vtxStride = self.vertexStride;
+	CC3Matrix4x3 xfmMtx = *mtx;		// Copied so the block captures the matrix contents
+	CC3VertexChunksApply(vtxCount, ^(GLuint chunkIdx, GLuint chunkOffset, GLuint chunkVtxCount) {
+		GLbyte* chunkVtx = firstVtx + (chunkOffset * vtxStride);
+		if (isLocation)
+			CC3Matrix4x3TransformLocations(&xfmMtx, chunkVtx, vtxStride, chunkVtxCount);
+		else
+			CC3Matrix4x3TransformDirections(&xfmMtx, chunkVtx, vtxStride, chunkVtxCount);
+		if (shouldNormalize) {
+			for (GLuint vtxIdx = 0; vtxIdx < chunkVtxCount; vtxIdx++) {
+				CC3Vector* pv = (CC3Vector*)(chunkVtx + (vtxIdx * vtxStride));
+				*pv = CC3VectorNormalize(*pv);
+			}
+		}
+	});
+}
+
 @end
 
 
@@ -754,7 +1213,7 @@ static GLuint lastAssignedVertexArrayTag;
 
 @implementation CC3VertexLocations
 
-@synthesize firstVertex=_firstVertex;
+@synthesize firstVertex=_firstVertex, contentVersion=_contentVersion;
 
 // Deprecated
 -(GLuint) firstElement { return self.firstVertex; }
@@ -763,6 +1222,13 @@ static GLuint lastAssignedVertexArrayTag;
 -(void) markBoundaryDirty {
 	_boundaryIsDirty = YES;
 	_radiusIsDirty = YES;
+	_contentVersion++;
+}
+
+/** The vertex content may have been changed directly before the GL buffer is updated. */
+-(void) updateGLBufferStartingAt: (GLuint) offsetIndex forLength: (GLuint) vtxCount {
+	[super updateGLBufferStartingAt: offsetIndex forLength: vtxCount];
+	_contentVersion++;
 }
 
 // Mark boundary dirty, but only if vertices are valid (to avoid marking dirty on dealloc)
@@ -791,6 +1257,11 @@ static GLuint lastAssignedVertexArrayTag;
 }
 
 -(CC3Vector) locationAt: (GLuint) index {
+	if (_elementType != GL_FLOAT) {
+		CC3Vector qLoc;
+		[self getQuantizableComponents: (GLfloat*)&qLoc at: index];
+		return qLoc;
+	}
 	CC3Vector loc = *(CC3Vector*)[self addressOfElement: index];
 	switch (_elementSize) {
 		case 2:
@@ -804,6 +1275,11 @@ static GLuint lastAssignedVertexArrayTag;
 }
 
 -(void) setLocation: (CC3Vector) aLocation at: (GLuint) index {
+	if (_elementType != GL_FLOAT) {
+		[self setQuantizableComponents: (GLfloat*)&aLocation at: index];
+		[self markBoundaryDirty];
+		return;
+	}
 	GLvoid* elemAddr = [self addressOfElement: index];
 	switch (_elementSize) {
 		case 2:		// Just store X & Y
@@ -821,6 +1297,7 @@ static GLuint lastAssignedVertexArrayTag;
 }
 
 -(CC3Vector4) homogeneousLocationAt: (GLuint) index {
+	if (_elementType != GL_FLOAT) return CC3Vector4FromLocation([self locationAt: index]);
 	CC3Vector4 hLoc = *(CC3Vector4*)[self addressOfElement: index];
 	switch (_elementSize) {
 		case 2:
@@ -835,6 +1312,10 @@ static GLuint lastAssignedVertexArrayTag;
 }
 
 -(void) setHomogeneousLocation: (CC3Vector4) aLocation at: (GLuint) index {
+	if (_elementType != GL_FLOAT) {
+		[self setLocation: aLocation.v at: index];
+		return;
+	}
 	GLvoid* elemAddr = [self addressOfElement: index];
 	switch (_elementSize) {
 		case 2:		// Just store X & Y
@@ -893,19 +1374,8 @@ static GLuint lastAssignedVertexArrayTag;
 -(void) buildBoundingBox {
 	// If we don't have vertices, but do have a non-zero vertexCount, raise an assertion
 	CC3Assert( !( !_vertices && _vertexCount ), @"%@ bounding box requested after vertex data have been released", self);
-	CC3Assert(_elementType == GL_FLOAT, @"%@ must have elementType GLFLOAT to build the bounding box", self);
-
-	CC3Vector vl, vlMin, vlMax;
-	vl = (_vertexCount > 0) ? [self locationAt: 0] : kCC3VectorZero;
-	vlMin = vl;
-	vlMax = vl;
-	for (GLuint i = 1; i < _vertexCount; i++) {
-		vl = [self locationAt: i];
-		vlMin = CC3VectorMinimize(vlMin, vl);
-		vlMax = CC3VectorMaximize(vlMax, vl);
-	}
-	_boundingBox.minimum = vlMin;
-	_boundingBox.maximum = vlMax;
+
+	_boundingBox = (_vertexCount > 0) ? [self boundingBoxOfVertices: _vertexCount startingAt: 0] : kCC3BoxZero;
 	_centerOfGeometry = CC3BoxCenter(_boundingBox);
 	_boundaryIsDirty = NO;
 	LogTrace(@"%@ bounding box: (%@, %@) and center of geometry: %@", self,
@@ -922,24 +1392,65 @@ static GLuint lastAssignedVertexArrayTag;
  * for the first time after the boundary has been marked dirty.
  */
 -(void) calcRadius {
-	CC3Assert(_elementType == GL_FLOAT, @"%@ must have elementType GLFLOAT to calculate mesh radius", [self class]);
-
 	CC3Vector cog = self.centerOfGeometry;		// Will measure it if necessary
 	if (_vertices && _vertexCount) {
-		// Work with the square of the radius so that all distances can be compared
-		// without having to run expensive square-root calculations.
-		GLfloat radiusSq = 0.0;
-		for (GLuint i=0; i < _vertexCount; i++) {
-			CC3Vector vl = [self locationAt: i];
-			GLfloat distSq = CC3VectorDistanceSquared(vl, cog);
-			radiusSq = MAX(radiusSq, distSq);
-		}
-		_radius = sqrtf(radiusSq);		// Now finally take the square-root
+		_radius = [self boundingSphereAround: cog ofVertices: _vertexCount startingAt: 0].radius;
 		_radiusIsDirty = NO;
 		LogTrace(@"%@ setting radius to %.2f", self, _radius);
 	}
 }
 
+-(CC3Box) boundingBoxOfVertices: (GLuint) vtxCount startingAt: (GLuint) startIdx {
+	if (vtxCount == 0) return kCC3BoxNull;
+
+	// Two-dimensional and quantized locations cannot be read directly, so use the slower per-vertex access
+	if (_elementSize < 3 || _elementType != GL_FLOAT) {
+		CC3Box bb = kCC3BoxNull;
+		for (GLuint vtxIdx = 0; vtxIdx < vtxCount; vtxIdx++)
+			bb = CC3BoxEngulfLocation(bb, [self locationAt: (startIdx + vtxIdx)]);
+		return bb;
+	}
+
+	GLbyte* firstVtx = [self addressOfElement: startIdx];
+	GLuint vtxStride = self.vertexStride;
+	GLuint chunkCnt = CC3VertexChunkCount(vtxCount);
+	CC3Box stackBoxes[kCC3VertexArrayStackChunkCount];
+	CC3Box* chunkBoxes = (chunkCnt <= kCC3VertexArrayStackChunkCount) ? stackBoxes : malloc(chunkCnt * sizeof(CC3Box));
+	CC3VertexChunksApply(vtxCount, ^(GLuint chunkIdx, GLuint chunkOffset, GLuint chunkVtxCount) {
+		chunkBoxes[chunkIdx] = CC3BoxFromLocations(firstVtx + (chunkOffset * vtxStride), vtxStride, chunkVtxCount);
+	});
+	CC3Box bb = chunkBoxes[0];
+	for (GLuint chunkIdx = 1; chunkIdx < chunkCnt; chunkIdx++) bb = CC3BoxUnion(bb, chunkBoxes[chunkIdx]);
+	if (chunkBoxes != stackBoxes) free(chunkBoxes);
+	return bb;
+}
+
+-(CC3Sphere) boundingSphereAround: (CC3Vector) center ofVertices: (GLuint) vtxCount startingAt: (GLuint) startIdx {
+	if (vtxCount == 0) return CC3SphereMake(center, 0.0f);
+
+	// Two-dimensional and quantized locations cannot be read directly, so use the slower per-vertex access
+	if (_elementSize < 3 || _elementType != GL_FLOAT) {
+		GLfloat radiusSq = 0.0f;
+		for (GLuint vtxIdx = 0; vtxIdx < vtxCount; vtxIdx++)
+			radiusSq = MAX(radiusSq, CC3VectorDistanceSquared([self locationAt: (startIdx + vtxIdx)], center));
+		return CC3SphereMake(center, sqrtf(radiusSq));
+	}
+
+	GLbyte* firstVtx = [self addressOfElement: startIdx];
+	GLuint vtxStride = self.vertexStride;
+	GLuint chunkCnt = CC3VertexChunkCount(vtxCount);
+	GLfloat stackRadii[kCC3VertexArrayStackChunkCount];
+	GLfloat* chunkRadii = (chunkCnt <= kCC3VertexArrayStackChunkCount) ? stackRadii : malloc(chunkCnt * sizeof(GLfloat));
+	CC3VertexChunksApply(vtxCount, ^(GLuint chunkIdx, GLuint chunkOffset, GLuint chunkVtxCount) {
+		chunkRadii[chunkIdx] = CC3SphereAroundLocations(center, firstVtx + (chunkOffset * vtxStride),
+														vtxStride, chunkVtxCount).radius;
+	});
+	GLfloat radius = 0.0f;
+	for (GLuint chunkIdx = 0; chunkIdx < chunkCnt; chunkIdx++) radius = MAX(radius, chunkRadii[chunkIdx]);
+	if (chunkRadii != stackRadii) free(chunkRadii);
+	return CC3SphereMake(center, radius);
+}
+
 -(void) moveMeshOriginTo: (CC3Vector) aLocation {
 	for (GLuint i = 0; i < _vertexCount; i++) {
 		CC3Vector locOld = [self locationAt: i];
@@ -952,11 +1463,56 @@ static GLuint lastAssignedVertexArrayTag;
 
 -(void) moveMeshOriginToCenterOfGeometry { [self moveMeshOriginTo: self.centerOfGeometry]; }
 
+-(void) transformVertices: (GLuint) vtxCount startingAt: (GLuint) startIdx by: (CC3Matrix*) aMatrix {
+	CC3Matrix4x3 mtx;
+	[aMatrix populateCC3Matrix4x3: &mtx];
+	[self transformVertices: vtxCount startingAt: startIdx byCC3Matrix4x3: &mtx asLocations: YES normalizing: NO];
+	[self markBoundaryDirty];
+}
+
 // Deprecated methods
 -(void) movePivotTo: (CC3Vector) aLocation { [self moveMeshOriginTo: aLocation]; }
 -(void) movePivotToCenterOfGeometry { [self moveMeshOriginToCenterOfGeometry]; }
 
 
+#pragma mark Quantization
+
+-(GLuint) quantizableComponentCount { return 3; }
+
+/** Quantized locations are padded with a w component of one. */
+-(GLfloat) quantizationPaddingValue { return 1.0f; }
+
+-(BOOL) supportsQuantization: (CC3VertexQuantization) quantization {
+	switch (quantization) {
+		case kCC3VertexQuantizationNone:
+		case kCC3VertexQuantizationShort:
+		case kCC3VertexQuantizationHalfFloat:
+			return YES;
+		default:
+			return NO;
+	}
+}
+
+/** All quantized locations are remapped to the bounding box. */
+-(BOOL) requiresDecodingForQuantization: (CC3VertexQuantization) quantization {
+	return (quantization != kCC3VertexQuantizationNone);
+}
+
+/** Quantized locations are remapped so that the bounding box spans the range -1 to +1. */
+-(void) configureQuantization: (CC3VertexQuantization) quantization
+				  withMinimum: (CC3Vector) minComps
+					  maximum: (CC3Vector) maxComps {
+	[super configureQuantization: quantization withMinimum: minComps maximum: maxComps];
+	if (quantization == kCC3VertexQuantizationNone) return;
+
+	_elementType = (quantization == kCC3VertexQuantizationShort) ? GL_SHORT : GL_HALF_FLOAT_OES;
+	_shouldNormalizeContent = (quantization == kCC3VertexQuantizationShort);
+	_elementSize = 4;		// Keep element word-aligned
+	_quantizationScale = CC3VertexQuantizationScaleToUnitRange(minComps, maxComps);
+	_quantizationOffset = CC3VectorAverage(minComps, maxComps);
+}
+
+
 #pragma mark Drawing
 
 /** Overridden to ensure the bounding box and radius are built before releasing the vertices. */
@@ -1016,18 +1572,57 @@ static GLuint lastAssignedVertexArrayTag;
 
 @implementation CC3VertexNormals
 
--(CC3Vector) normalAt: (GLuint) index { return *(CC3Vector*)[self addressOfElement: index]; }
+-(CC3Vector) normalAt: (GLuint) index {
+	if (_elementType != GL_FLOAT) {
+		CC3Vector qNorm;
+		[self getQuantizableComponents: (GLfloat*)&qNorm at: index];
+		return qNorm;
+	}
+	return *(CC3Vector*)[self addressOfElement: index];
+}
 
 -(void) setNormal: (CC3Vector) aNormal at: (GLuint) index {
+	if (_elementType != GL_FLOAT) {
+		[self setQuantizableComponents: (GLfloat*)&aNormal at: index];
+		return;
+	}
 	*(CC3Vector*)[self addressOfElement: index] = aNormal;
 }
 
 -(void) flipNormals {
 	GLuint vtxCnt = self.vertexCount;
-	for (GLuint vtxIdx = 0; vtxIdx < vtxCnt; vtxIdx++) {
-		CC3Vector* pn = [self addressOfElement: vtxIdx];
-		*pn = CC3VectorNegate(*pn);
-	}
+	for (GLuint vtxIdx = 0; vtxIdx < vtxCnt; vtxIdx++)
+		[self setNormal: CC3VectorNegate([self normalAt: vtxIdx]) at: vtxIdx];
+}
+
+/**
+ * Normals are transformed by the inverse-transpose of the linear component of the matrix,
+ * so that they remain perpendicular to the surface when the matrix contains non-uniform
+ * scaling. If the linear component cannot be inverted, it is used as is.
+ */
+-(void) transformVertices: (GLuint) vtxCount startingAt: (GLuint) startIdx by: (CC3Matrix*) aMatrix {
+	CC3Matrix3x3 linMtx;
+	CC3Matrix4x3 mtx;
+	[aMatrix populateCC3Matrix3x3: &linMtx];
+	CC3Matrix3x3InvertAdjointTranspose(&linMtx);
+	CC3Matrix4x3PopulateFrom3x3(&mtx, &linMtx);
+	[self transformVertices: vtxCount startingAt: startIdx byCC3Matrix4x3: &mtx asLocations: NO normalizing: YES];
+}
+
+
+#pragma mark Quantization
+
+-(GLuint) quantizableComponentCount { return 3; }
+
+-(BOOL) supportsQuantization: (CC3VertexQuantization) quantization {
+	return [self supportsDirectionQuantization: quantization];
+}
+
+-(void) configureQuantization: (CC3VertexQuantization) quantization
+				  withMinimum: (CC3Vector) minComps
+					  maximum: (CC3Vector) maxComps {
+	[super configureQuantization: quantization withMinimum: minComps maximum: maxComps];
+	[self configureDirectionQuantization: quantization];
 }
 
 
@@ -1045,12 +1640,45 @@ static GLuint lastAssignedVertexArrayTag;
 
 @implementation CC3VertexTangents
 
--(CC3Vector) tangentAt: (GLuint) index { return *(CC3Vector*)[self addressOfElement: index]; }
+-(CC3Vector) tangentAt: (GLuint) index {
+	if (_elementType != GL_FLOAT) {
+		CC3Vector qTan;
+		[self getQuantizableComponents: (GLfloat*)&qTan at: index];
+		return qTan;
+	}
+	return *(CC3Vector*)[self addressOfElement: index];
+}
 
 -(void) setTangent: (CC3Vector) aTangent at: (GLuint) index {
+	if (_elementType != GL_FLOAT) {
+		[self setQuantizableComponents: (GLfloat*)&aTangent at: index];
+		return;
+	}
 	*(CC3Vector*)[self addressOfElement: index] = aTangent;
 }
 
+-(void) transformVertices: (GLuint) vtxCount startingAt: (GLuint) startIdx by: (CC3Matrix*) aMatrix {
+	CC3Matrix4x3 mtx;
+	[aMatrix populateCC3Matrix4x3: &mtx];
+	[self transformVertices: vtxCount startingAt: startIdx byCC3Matrix4x3: &mtx asLocations: NO normalizing: YES];
+}
+
+
+#pragma mark Quantization
+
+-(GLuint) quantizableComponentCount { return 3; }
+
+-(BOOL) supportsQuantization: (CC3VertexQuantization) quantization {
+	return [self supportsDirectionQuantization: quantization];
+}
+
+-(void) configureQuantization: (CC3VertexQuantization) quantization
+				  withMinimum: (CC3Vector) minComps
+					  maximum: (CC3Vector) maxComps {
+	[super configureQuantization: quantization withMinimum: minComps maximum: maxComps];
+	[self configureDirectionQuantization: quantization];
+}
+
 
 #pragma mark Allocation and initialization
 
@@ -1240,9 +1868,20 @@ static BOOL defaultExpectsVerticallyFlippedTextures = NO;
 	defaultExpectsVerticallyFlippedTextures = expectsFlipped;
 }
 
--(ccTex2F) texCoord2FAt: (GLuint) index { return *(ccTex2F*)[self addressOfElement: index]; }
+-(ccTex2F) texCoord2FAt: (GLuint) index {
+	if (_elementType != GL_FLOAT) {
+		ccTex2F qTC;
+		[self getQuantizableComponents: (GLfloat*)&qTC at: index];
+		return qTC;
+	}
+	return *(ccTex2F*)[self addressOfElement: index];
+}
 
 -(void) setTexCoord2F: (ccTex2F) aTex2F at: (GLuint) index {
+	if (_elementType != GL_FLOAT) {
+		[self setQuantizableComponents: (GLfloat*)&aTex2F at: index];
+		return;
+	}
 	*(ccTex2F*)[self addressOfElement: index] = aTex2F;
 }
 
@@ -1275,19 +1914,20 @@ static BOOL defaultExpectsVerticallyFlippedTextures = NO;
 	// the mapSize and the old texture rectangle. Then, convert to the new coordinate, taking into
 	// consideration the mapSize and the new texture rectangle.
 	for (GLuint i = 0; i < _vertexCount; i++) {
-		ccTex2F* ptc = (ccTex2F*)[self addressOfElement: i];
+		ccTex2F tc = [self texCoord2FAt: i];
 		
-		GLfloat origU = ((ptc->u / mw) - ox) / ow;			// Revert to original value
-		ptc->u = (nx + (origU * nw)) * mw;					// Calc new value
+		GLfloat origU = ((tc.u / mw) - ox) / ow;			// Revert to original value
+		tc.u = (nx + (origU * nw)) * mw;					// Calc new value
 		
 		// Take into consideration whether the texture is flipped.
 		if (_expectsVerticallyFlippedTextures) {
-			GLfloat origV = (1.0f - (ptc->v / mh) - oy) / oh;	// Revert to original value
-			ptc->v = (1.0f - (ny + (origV * nh))) * mh;			// Calc new value
+			GLfloat origV = (1.0f - (tc.v / mh) - oy) / oh;	// Revert to original value
+			tc.v = (1.0f - (ny + (origV * nh))) * mh;			// Calc new value
 		} else {
-			GLfloat origV = (((ptc->v - hx) / mh) - oy) / oh;	// Revert to original value
-			ptc->v = (ny + (origV * nh)) * mh + hx;				// Calc new value
+			GLfloat origV = (((tc.v - hx) / mh) - oy) / oh;	// Revert to original value
+			tc.v = (ny + (origV * nh)) * mh + hx;				// Calc new value
 		}
+		[self setTexCoord2F: tc at: i];
 	}
 	[self updateGLBuffer];
 }
@@ -1312,9 +1952,10 @@ static BOOL defaultExpectsVerticallyFlippedTextures = NO;
 	GLfloat newVertXln = 1.0f - texCoverage.height;
 	
 	for (GLuint i = 0; i < _vertexCount; i++) {
-		ccTex2F* ptc = (ccTex2F*)[self addressOfElement: i];
-		ptc->u *= mapRatio.width;
-		ptc->v = (ptc->v - currVertXln) * mapRatio.height + newVertXln;
+		ccTex2F tc = [self texCoord2FAt: i];
+		tc.u *= mapRatio.width;
+		tc.v = (tc.v - currVertXln) * mapRatio.height + newVertXln;
+		[self setTexCoord2F: tc at: i];
 	}
 	_mapSize = texCoverage;	// Remember what we've set the map size to
 	[self updateGLBuffer];
@@ -1333,9 +1974,10 @@ static BOOL defaultExpectsVerticallyFlippedTextures = NO;
 	CGSize mapRatio = CGSizeMake(texCoverage.width / _mapSize.width, texCoverage.height / _mapSize.height);
 	
 	for (GLuint i = 0; i < _vertexCount; i++) {
-		ccTex2F* ptc = (ccTex2F*)[self addressOfElement: i];
-		ptc->u *= mapRatio.width;
-		ptc->v = texCoverage.height - (ptc->v * mapRatio.height);
+		ccTex2F tc = [self texCoord2FAt: i];
+		tc.u *= mapRatio.width;
+		tc.v = texCoverage.height - (tc.v * mapRatio.height);
+		[self setTexCoord2F: tc at: i];
 	}
 
 	// Remember that we've flipped and what we've set the map size to
@@ -1367,13 +2009,14 @@ static BOOL defaultExpectsVerticallyFlippedTextures = NO;
 	GLfloat minV = kCC3MaxGLfloat;
 	GLfloat maxV = -kCC3MaxGLfloat;
 	for (GLuint i = 0; i < _vertexCount; i++) {
-		ccTex2F* ptc = (ccTex2F*)[self addressOfElement: i];
-		minV = MIN(ptc->v, minV);
-		maxV = MAX(ptc->v, maxV);
+		GLfloat v = [self texCoord2FAt: i].v;
+		minV = MIN(v, minV);
+		maxV = MAX(v, maxV);
 	}
 	for (GLuint i = 0; i < _vertexCount; i++) {
-		ccTex2F* ptc = (ccTex2F*)[self addressOfElement: i];
-		ptc->v = minV + maxV - ptc->v;
+		ccTex2F tc = [self texCoord2FAt: i];
+		tc.v = minV + maxV - tc.v;
+		[self setTexCoord2F: tc at: i];
 	}
 	[self updateGLBuffer];
 }
@@ -1382,13 +2025,14 @@ static BOOL defaultExpectsVerticallyFlippedTextures = NO;
 	GLfloat minU = kCC3MaxGLfloat;
 	GLfloat maxU = -kCC3MaxGLfloat;
 	for (GLuint i = 0; i < _vertexCount; i++) {
-		ccTex2F* ptc = (ccTex2F*)[self addressOfElement: i];
-		minU = MIN(ptc->u, minU);
-		maxU = MAX(ptc->u, maxU);
+		GLfloat u = [self texCoord2FAt: i].u;
+		minU = MIN(u, minU);
+		maxU = MAX(u, maxU);
 	}
 	for (GLuint i = 0; i < _vertexCount; i++) {
-		ccTex2F* ptc = (ccTex2F*)[self addressOfElement: i];
-		ptc->u = minU + maxU - ptc->u;
+		ccTex2F tc = [self texCoord2FAt: i];
+		tc.u = minU + maxU - tc.u;
+		[self setTexCoord2F: tc at: i];
 	}
 	[self updateGLBuffer];
 }
@@ -1399,6 +2043,58 @@ static BOOL defaultExpectsVerticallyFlippedTextures = NO;
 }
 
 
+#pragma mark Quantization
+
+-(GLuint) quantizableComponentCount { return 2; }
+
+-(BOOL) supportsQuantization: (CC3VertexQuantization) quantization {
+	switch (quantization) {
+		case kCC3VertexQuantizationNone:
+		case kCC3VertexQuantizationShort:
+		case kCC3VertexQuantizationHalfFloat:
+			return YES;
+		default:
+			return NO;
+	}
+}
+
+/** Short texture coordinates require decoding only if they extend outside the range 0 to 1. */
+-(BOOL) requiresDecodingForQuantization: (CC3VertexQuantization) quantization {
+	if (quantization != kCC3VertexQuantizationShort) return NO;
+	for (GLuint vIdx = 0; vIdx < _vertexCount; vIdx++) {
+		ccTex2F tc = [self texCoord2FAt: vIdx];
+		if (tc.u < 0.0f || tc.v < 0.0f || tc.u > 1.0f || tc.v > 1.0f) return YES;
+	}
+	return NO;
+}
+
+/**
+ * Texture coordinates that lie within a single texture tile can be stored without remapping.
+ * Only texture coordinates that extend outside the range 0 to 1 are remapped to fit that range.
+ */
+-(void) configureQuantization: (CC3VertexQuantization) quantization
+				  withMinimum: (CC3Vector) minComps
+					  maximum: (CC3Vector) maxComps {
+	[super configureQuantization: quantization withMinimum: minComps maximum: maxComps];
+	switch (quantization) {
+		case kCC3VertexQuantizationShort:
+			_elementType = GL_UNSIGNED_SHORT;
+			_shouldNormalizeContent = YES;
+			if (minComps.x < 0.0f || minComps.y < 0.0f || maxComps.x > 1.0f || maxComps.y > 1.0f) {
+				CC3Vector halfScale = CC3VertexQuantizationScaleToUnitRange(minComps, maxComps);
+				_quantizationScale = cc3v(halfScale.x * 2.0f, halfScale.y * 2.0f, 1.0f);
+				_quantizationOffset = cc3v(minComps.x, minComps.y, 0.0f);
+			}
+			break;
+		case kCC3VertexQuantizationHalfFloat:
+			_elementType = GL_HALF_FLOAT_OES;
+			break;
+		default:
+			break;
+	}
+}
+
+
 #pragma mark Allocation and initialization
 
 -(NSString*) nameSuffix { return @"TexCoords"; }
@@ -1610,20 +2306,73 @@ static BOOL defaultExpectsVerticallyFlippedTextures = NO;
 
 @implementation CC3VertexBoneWeights
 
+-(void) dealloc {
+	free(_decodedBoneWeights);
+	[super dealloc];
+}
+
 -(GLfloat) weightForBoneInfluence: (GLuint) influenceIndex at: (GLuint) vtxIndex {
-	return [self boneWeightsAt: vtxIndex][influenceIndex];
+	return CC3VertexComponentAt([self addressOfElement: vtxIndex], influenceIndex, _elementType, _shouldNormalizeContent);
 }
 
 -(void) setWeight: (GLfloat) weight forBoneInfluence: (GLuint) influenceIndex at: (GLuint) vtxIndex {
-	[self boneWeightsAt: vtxIndex][influenceIndex] = weight;
+	CC3VertexComponentSet([self addressOfElement: vtxIndex], influenceIndex, _elementType, _shouldNormalizeContent, weight);
 }
 
--(GLfloat*) boneWeightsAt: (GLuint) vtxIndex { return (GLfloat*)[self addressOfElement: vtxIndex]; }
+-(GLfloat*) boneWeightsAt: (GLuint) vtxIndex {
+	if (_elementType == GL_FLOAT) return (GLfloat*)[self addressOfElement: vtxIndex];
+
+	// Quantized weights are decoded into a reusable array, sized to the current element size
+	_decodedBoneWeights = realloc(_decodedBoneWeights, _elementSize * sizeof(GLfloat));
+	for (GLint wtIdx = 0; wtIdx < _elementSize; wtIdx++)
+		_decodedBoneWeights[wtIdx] = [self weightForBoneInfluence: wtIdx at: vtxIndex];
+	return _decodedBoneWeights;
+}
 
 -(void) setBoneWeights: (GLfloat*) weights at: (GLuint) vtxIndex {
-	GLfloat* vtxWeights = [self boneWeightsAt: vtxIndex];
 	GLint numWts = self.elementSize;
-	for (int i = 0; i < numWts; i++) vtxWeights[i] = weights[i];
+	for (int i = 0; i < numWts; i++) [self setWeight: weights[i] forBoneInfluence: i at: vtxIndex];
+}
+
+
+#pragma mark Quantization
+
+-(GLuint) quantizableComponentCount { return _elementSize; }
+
+-(BOOL) supportsQuantization: (CC3VertexQuantization) quantization {
+	return (quantization == kCC3VertexQuantizationNone || quantization == kCC3VertexQuantizationByte);
+}
+
+-(void) configureQuantization: (CC3VertexQuantization) quantization
+				  withMinimum: (CC3Vector) minComps
+					  maximum: (CC3Vector) maxComps {
+	[super configureQuantization: quantization withMinimum: minComps maximum: maxComps];
+	if (quantization == kCC3VertexQuantizationByte) {
+		_elementType = GL_UNSIGNED_BYTE;
+		_shouldNormalizeContent = YES;
+	}
+}
+
+/**
+ * Rounding each weight individually can cause the quantized weights of a vertex to no longer
+ * add up to one. If the original weights add up to one, the rounding error is absorbed by the
+ * largest weight, so that the quantized weights add up to exactly one as well.
+ */
+-(void) setQuantizableComponents: (const GLfloat*) comps at: (GLuint) vtxIdx {
+	[super setQuantizableComponents: comps at: vtxIdx];
+	if (_quantization != kCC3VertexQuantizationByte) return;
+
+	GLubyte* qWts = [self addressOfElement: vtxIdx];
+	GLfloat wtSum = 0.0f;
+	GLint qWtSum = 0;
+	GLuint maxWtIdx = 0;
+	for (GLuint wtIdx = 0; wtIdx < _elementSize; wtIdx++) {
+		wtSum += comps[wtIdx];
+		qWtSum += qWts[wtIdx];
+		if (qWts[wtIdx] > qWts[maxWtIdx]) maxWtIdx = wtIdx;
+	}
+	if (fabsf(wtSum - 1.0f) < 0.01f)
+		qWts[maxWtIdx] = (GLubyte)CLAMP((GLint)qWts[maxWtIdx] + (255 - qWtSum), 0, 255);
 }
 
 
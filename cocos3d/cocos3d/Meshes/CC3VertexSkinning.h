@@ -603,6 +603,7 @@
 @interface CC3DeformedFaceArray : CC3FaceArray {
 	CC3SkinMeshNode* _node;
 	CC3Vector* _deformedVertexLocations;
+	GLuint _deformationVersion;
 	BOOL _deformedVertexLocationsAreRetained : 1;
 	BOOL _deformedVertexLocationsAreDirty : 1;
 }
@@ -694,9 +695,18 @@
 /**
  * Clears any caches that contain deformable information, including deformed vertices, 
  * plus face centers, normals, and planes.
+ *
+ * Also increments the value of the deformationVersion property.
  */
 -(void) clearDeformableCaches;
 
+/**
+ * A number that changes each time the deformed faces may have changed, because the node or
+ * any of the bones moved, or the node property was changed. Shadow volumes use this property
+ * to determine whether faces they copied from this instance earlier can be used again.
+ */
+@property(nonatomic, readonly) GLuint deformationVersion;
+
 @end
 
 
@@ -145,6 +145,21 @@
 }
 
 
+#pragma mark Vertex cache optimization
+
+/** Triangles are only reordered within each skin section, since each section is drawn separately. */
+-(void) optimizeVertexCacheOrder {
+	NSMutableArray* idxRanges = [NSMutableArray arrayWithCapacity: _skinSections.count];
+	for (CC3SkinSection* skinSctn in _skinSections)
+		[idxRanges addObject: [NSValue valueWithRange: NSMakeRange(skinSctn.vertexStart, skinSctn.vertexCount)]];
+	[_mesh optimizeVertexCacheOrderForCacheSize: kCC3DefaultVertexCacheSize inIndexRanges: idxRanges];
+	_deformedFaces.node = self;		// Clears deformed face caches built from the old vertex order
+
+	// Skip the mesh node implementation, which would reorder across skin sections
+	for (CC3Node* child in _children) [child optimizeVertexCacheOrder];
+}
+
+
 #pragma mark Allocation and initialization
 
 -(id) initWithTag: (GLuint) aTag withName: (NSString*) aName {
@@ -606,6 +621,7 @@
 	_node = aNode;								// weak reference
 	self.mesh = aNode.mesh;
 	[self deallocateDeformedVertexLocations];
+	_deformationVersion++;
 }
 
 /**
@@ -622,8 +638,11 @@
 	[self markNormalsDirty];
 	[self markPlanesDirty];
 	[self markDeformedVertexLocationsDirty];
+	_deformationVersion++;
 }
 
+-(GLuint) deformationVersion { return _deformationVersion; }
+
 -(GLuint) vertexCount { return _mesh ? _mesh.vertexCount : 0;}
 
 -(CC3Face) faceAt: (GLuint) faceIndex {
@@ -648,6 +667,7 @@
 	if ( (self = [super initWithTag: aTag withName: aName]) ) {
 		_node = nil;
 		_deformedVertexLocations = NULL;
+		_deformationVersion = 0;
 		_deformedVertexLocationsAreRetained = NO;
 		_deformedVertexLocationsAreDirty = YES;
 	}
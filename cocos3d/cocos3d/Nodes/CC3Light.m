@@ -405,7 +405,7 @@
 
 -(BOOL) hasShadows { return _shadows && _shadows.count > 0; }
 
--(void) updateShadows { for (id<CC3ShadowProtocol> sv in _shadows) [sv updateShadow]; }
+-(void) updateShadows { [CC3ShadowVolumeMeshNode updateShadows: _shadows withStatistics: nil]; }
 
 -(CC3ShadowCastingVolume*) shadowCastingVolume { return _shadowCastingVolume; }
 
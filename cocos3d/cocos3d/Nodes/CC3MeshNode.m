@@ -627,6 +627,16 @@
 	[super releaseRedundantContent];
 }
 
+-(void) optimizeVertexCacheOrder {
+	[_mesh optimizeVertexCacheOrder];
+	[super optimizeVertexCacheOrder];
+}
+
+-(void) quantizeVertexContent {
+	[_mesh quantizeVertexContent];
+	[super quantizeVertexContent];
+}
+
 -(void) retainVertexContent {
 	[_mesh retainVertexContent];
 	[super retainVertexContent];
@@ -1906,6 +1906,26 @@ typedef enum {
 /** @deprecated Renamed to releaseRedundantContent. */
 -(void) releaseRedundantData __deprecated;
 
+/**
+ * Reorders the triangles and vertices of the meshes of all descendant mesh nodes to improve reuse
+ * of the post-transform vertex cache of the GPU. See the optimizeVertexCacheOrder method of CC3Mesh
+ * for more information. Skinned mesh nodes only reorder triangles within each of their skin sections.
+ *
+ * Because the vertex content must be available in main memory, this method should be invoked
+ * once, after the nodes are loaded, and before the releaseRedundantContent method is invoked.
+ */
+-(void) optimizeVertexCacheOrder;
+
+/**
+ * Converts the vertex content of the meshes of all descendant mesh nodes to compact formats that
+ * can be drawn by any shader, including the stock Cocos3D shaders. See the quantizeVertexContent
+ * method of CC3Mesh for more information. Under OpenGL ES 1, this method does nothing.
+ *
+ * Because the vertex content must be available in main memory, this method should be invoked
+ * once, after the nodes are loaded, and before the releaseRedundantContent method is invoked.
+ */
+-(void) quantizeVertexContent;
+
 /**
  * Convenience method to cause all vertex content to be retained in application
  * memory when releaseRedundantContent is invoked, even if it has been buffered to a GL VBO.
@@ -3910,6 +3930,21 @@ typedef enum {
  */
 @property(nonatomic, assign) BOOL shouldLogIntersectionMisses;
 
+/**
+ * Returns a breakdown of the memory held by the content of this node and its descendants,
+ * as a dictionary that can be serialized to JSON using NSJSONSerialization.
+ *
+ * The dictionary contains the number of nodes and mesh nodes in this node assembly, and,
+ * for each of the distinct meshes, textures and shader programs used by those nodes, the
+ * number of objects, and the total applicationMemoryBytes and glMemoryBytes of those objects.
+ * Content that is shared by several nodes is only counted once. The dictionary also contains
+ * the total application and GL memory held by all of that content.
+ *
+ * This method traverses the entire node assembly, and is intended for development-time
+ * reporting, such as tracking memory budgets, and detecting leaks in automated tests.
+ */
+-(NSDictionary*) memoryFootprint;
+
 /**
  * Returns a marker string that is pushed onto the GL render stream prior to rendering
  * this node. The group is popped from the GL render stream after this node is rendered.
@@ -42,6 +42,9 @@
 #import "CC3LinearMatrix.h"
 #import "CC3CC2Extensions.h"
 #import "CC3Texture.h"
+#import "CC3MeshNode.h"
+#import "CC3Shaders.h"
+#import "CC3FrameRecording.h"
 
 
 #pragma mark CC3Node
@@ -87,6 +90,7 @@
 -(void) setLocation: (CC3Vector) aLocation {
 	_location = aLocation;
 	[self markTransformDirty];
+	CC3FrameRecord(kCC3FrameEventLocation, self, 0, aLocation.x, aLocation.y, aLocation.z);
 }
 
 // Use parent to transform local location. Don't use this node, as globalLocation
@@ -106,6 +110,7 @@
 
 	self.mutableRotator.rotation = aRotation;
 	[self markTransformDirty];
+	CC3FrameRecord(kCC3FrameEventRotation, self, 0, aRotation.x, aRotation.y, aRotation.z);
 }
 
 -(CC3Vector) globalRotation { return [self.globalRotationMatrix extractRotation]; }
@@ -115,6 +120,7 @@
 
 	[self.mutableRotator rotateBy: aRotation];
 	[self markTransformDirty];
+	CC3FrameRecord(kCC3FrameEventRotateBy, self, 0, aRotation.x, aRotation.y, aRotation.z);
 }
 
 -(CC3Quaternion) quaternion { return _rotator.quaternion; }
@@ -124,6 +130,7 @@
 
 	self.mutableRotator.quaternion = aQuaternion;
 	[self markTransformDirty];
+	CC3FrameRecord(kCC3FrameEventQuaternion, self, 0, aQuaternion.x, aQuaternion.y, aQuaternion.z, aQuaternion.w);
 }
 
 -(void) rotateByQuaternion: (CC3Quaternion) aQuaternion {
@@ -131,6 +138,7 @@
 
 	[self.mutableRotator rotateByQuaternion: aQuaternion];
 	[self markTransformDirty];
+	CC3FrameRecord(kCC3FrameEventRotateByQuaternion, self, 0, aQuaternion.x, aQuaternion.y, aQuaternion.z, aQuaternion.w);
 }
 
 -(CC3Vector) rotationAxis { return _rotator.rotationAxis; }
@@ -140,6 +148,7 @@
 
 	self.mutableRotator.rotationAxis = aDirection;
 	[self markTransformDirty];
+	CC3FrameRecord(kCC3FrameEventRotationAxis, self, 0, aDirection.x, aDirection.y, aDirection.z);
 }
 
 -(GLfloat) rotationAngle { return _rotator.rotationAngle; }
@@ -149,6 +158,7 @@
 
 	self.mutableRotator.rotationAngle = anAngle;
 	[self markTransformDirty];
+	CC3FrameRecord(kCC3FrameEventRotationAngle, self, 0, anAngle);
 }
 
 -(void) rotateByAngle: (GLfloat) angle aroundAxis: (CC3Vector) axis {
@@ -156,6 +166,7 @@
 
 	[self.mutableRotator rotateByAngle: angle aroundAxis: axis];
 	[self markTransformDirty];
+	CC3FrameRecord(kCC3FrameEventRotateByAngleAroundAxis, self, 0, angle, axis.x, axis.y, axis.z);
 }
 
 /**
@@ -180,6 +191,7 @@
 
 	self.directionalRotator.forwardDirection = aDirection;
 	[self markTransformDirty];
+	CC3FrameRecord(kCC3FrameEventForwardDirection, self, 0, aDirection.x, aDirection.y, aDirection.z);
 }
 
 -(CC3Vector) globalForwardDirection { return [self.globalRotationMatrix extractForwardDirection]; }
@@ -208,6 +220,7 @@
 -(void) setScale: (CC3Vector) aScale {
 	_scale = aScale;
 	[self markTransformDirty];
+	CC3FrameRecord(kCC3FrameEventScale, self, 0, aScale.x, aScale.y, aScale.z);
 }
 
 -(GLfloat) uniformScale {
@@ -266,6 +279,7 @@
 -(void) setTargetLocation: (CC3Vector) aLocation {
 	self.targettingRotator.targetLocation = aLocation;
 	[self markTransformDirty];
+	CC3FrameRecord(kCC3FrameEventTargetLocation, self, 0, aLocation.x, aLocation.y, aLocation.z);
 }
 
 -(CC3Node*) target { return _rotator.target; }
@@ -1120,6 +1134,10 @@
 // Deprecated
 -(void) releaseRedundantData { [self releaseRedundantContent]; }
 
+-(void) optimizeVertexCacheOrder { for (CC3Node* child in _children) [child optimizeVertexCacheOrder]; }
+
+-(void) quantizeVertexContent { for (CC3Node* child in _children) [child quantizeVertexContent]; }
+
 -(void) retainVertexContent { for (CC3Node* child in _children) [child retainVertexContent]; }
 
 -(void) retainVertexLocations { for (CC3Node* child in _children) [child retainVertexLocations]; }
@@ -2343,6 +2361,60 @@ static ccColor4F directionMarkerColor = { 1.0, 0.0, 0.0, 1.0 };		// kCCC4FRed
 	for (CC3Node* child in _children) child.shouldLogIntersectionMisses = shouldLog;
 }
 
+/**
+ * Returns a dictionary containing the number of the specified objects, and the total
+ * applicationMemoryBytes and glMemoryBytes of those objects.
+ */
+static NSDictionary* CC3MemoryFootprintOf(NSSet* objects, NSUInteger* totalAppBytes, NSUInteger* totalGLBytes) {
+	NSUInteger appBytes = 0;
+	NSUInteger glBytes = 0;
+	for (id<CC3Cacheable> obj in objects) {
+		appBytes += obj.applicationMemoryBytes;
+		glBytes += obj.glMemoryBytes;
+	}
+	*totalAppBytes += appBytes;
+	*totalGLBytes += glBytes;
+	return [NSDictionary dictionaryWithObjectsAndKeys:
+			[NSNumber numberWithUnsignedInteger: objects.count], @"count",
+			[NSNumber numberWithUnsignedInteger: appBytes], @"applicationBytes",
+			[NSNumber numberWithUnsignedInteger: glBytes], @"glBytes",
+			nil];
+}
+
+-(NSDictionary*) memoryFootprint {
+	NSMutableSet* meshes = [NSMutableSet set];
+	NSMutableSet* textures = [NSMutableSet set];
+	NSMutableSet* programs = [NSMutableSet set];
+	NSUInteger meshNodeCnt = 0;
+	NSArray* allNodes = [self flatten];
+	for (CC3Node* aNode in allNodes) {
+		if ( !aNode.isMeshNode ) continue;
+		CC3MeshNode* mn = (CC3MeshNode*)aNode;
+		meshNodeCnt++;
+		if (mn.mesh) [meshes addObject: mn.mesh];
+		if (mn.shaderContext.program) [programs addObject: mn.shaderContext.program];	// Don't trigger selection
+		CC3Material* mat = mn.material;
+		GLuint texCnt = mat.textureCount;
+		for (GLuint texIdx = 0; texIdx < texCnt; texIdx++) {
+			CC3Texture* tex = [mat textureForTextureUnit: texIdx];
+			if ( [tex isKindOfClass: CC3TextureUnitTexture.class] ) tex = ((CC3TextureUnitTexture*)tex).texture;
+			if (tex) [textures addObject: tex];
+		}
+	}
+
+	NSUInteger appBytes = 0;
+	NSUInteger glBytes = 0;
+	NSMutableDictionary* footprint = [NSMutableDictionary dictionary];
+	[footprint setObject: [NSNumber numberWithUnsignedInteger: allNodes.count] forKey: @"nodes"];
+	[footprint setObject: [NSNumber numberWithUnsignedInteger: meshNodeCnt] forKey: @"meshNodes"];
+	[footprint setObject: CC3MemoryFootprintOf(meshes, &appBytes, &glBytes) forKey: @"meshes"];
+	[footprint setObject: CC3MemoryFootprintOf(textures, &appBytes, &glBytes) forKey: @"textures"];
+	[footprint setObject: CC3MemoryFootprintOf(programs, &appBytes, &glBytes) forKey: @"shaderPrograms"];
+	[footprint setObject: [NSNumber numberWithUnsignedInteger: appBytes] forKey: @"applicationBytes"];
+	[footprint setObject: [NSNumber numberWithUnsignedInteger: glBytes] forKey: @"glBytes"];
+	return footprint;
+}
+
 -(const char*) renderStreamGroupMarker { return NULL; }
 
 @end
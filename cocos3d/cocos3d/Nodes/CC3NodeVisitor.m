@@ -37,6 +37,7 @@
 #import "CC3EnvironmentNodes.h"
 #import "CC3NodeSequencer.h"
 #import "CC3VertexSkinning.h"
+#import <objc/runtime.h>
 
 #if CC3_CC2_RENDER_QUEUE
 #	import "CCRenderer_private.h"
@@ -86,6 +87,7 @@
 
 	if (!_startingNode) {				// If this is the first node, start up
 		_startingNode = aNode;			// Not retained
+		CC3TraceBegin(class_getName(self.class), "visitor", aNode.name.UTF8String);
 		[self open];					// Open the visitor
 	}
 
@@ -93,6 +95,7 @@
 
 	if (aNode == _startingNode) {		// If we're back to the first node, finish up
 		[self close];					// Close the visitor
+		CC3TraceEnd(class_getName(self.class), "visitor");
 		_startingNode = nil;			// Not retained
 	}
 	
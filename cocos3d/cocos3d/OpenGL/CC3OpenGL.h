@@ -1358,6 +1358,26 @@ typedef struct {
  */
 +(CC3OpenGL*) sharedGL;
 
+/**
+ * Returns the concrete CC3OpenGL subclass that is instantiated by the sharedGL method.
+ *
+ * Unless changed using the setOpenGLClass: method, this is the subclass that is
+ * appropriate to the OpenGL platform being built.
+ */
++(Class) openGLClass;
+
+/**
+ * Sets the concrete CC3OpenGL subclass that is instantiated by the sharedGL method.
+ *
+ * This can be used to run Cocos3D without a GL engine, by setting this property to the
+ * CC3OpenGLNull class. To take effect, this property must be set before the sharedGL
+ * method is first invoked, or after OpenGL has been terminated.
+ *
+ * Setting this property to nil restores the subclass that is appropriate to the OpenGL
+ * platform being built.
+ */
++(void) setOpenGLClass: (Class) openGLClass;
+
 /** Returns the thread that is being used for primary rendering. */
 +(NSThread*) renderThread;
 
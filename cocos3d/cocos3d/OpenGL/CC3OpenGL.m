@@ -1294,9 +1294,19 @@ static NSObject<CC3OpenGLDelegate>* _delegate = nil;
 	LogInfoIfPrimary(@"GL extensions supported by this platform: %@", self.extensionsDescription);
 }
 
+static Class _openGLClass = nil;
+
++(Class) openGLClass { return _openGLClass ? _openGLClass : [CC3OpenGLClass class]; }
+
++(void) setOpenGLClass: (Class) openGLClass {
+	CC3Assert( !openGLClass || ([openGLClass isSubclassOfClass: [CC3OpenGL class]] && openGLClass != [CC3OpenGL class]),
+			  @"%@ is not a concrete subclass of CC3OpenGL.", openGLClass);
+	_openGLClass = openGLClass;
+}
+
 /** Returns the appropriate class cluster subclass instance. */
 +(id) alloc {
-	if (self == [CC3OpenGL class]) return [CC3OpenGLClass alloc];
+	if (self == [CC3OpenGL class]) return [self.openGLClass alloc];
 	return [super alloc];
 }
 
@@ -0,0 +1,92 @@
+/*
+ * CC3OpenGLNull.h
+ *
+ * Cocos3D 2.0.2
+ * Author: Bill Hollings
+ * Copyright (c) 2010-2014 The Brenwill Workshop Ltd. All rights reserved.
+ * http://www.brenwill.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+
+/** @file */	// Doxygen marker
+
+#import "CC3OpenGLProgPipeline.h"
+
+#if CC3_GLSL
+
+/**
+ * CC3OpenGLNull tracks the OpenGL state for a GL context that does not exist, allowing
+ * 3D scenes to be loaded, updated and drawn without a GL engine, such as when running
+ * automated tests or benchmarks on a machine that does not have a GPU.
+ *
+ * To use this class, set the CC3OpenGL openGLClass class-side property to this class,
+ * before the CC3OpenGL sharedGL method is first invoked:
+ *
+ *   CC3OpenGL.openGLClass = CC3OpenGLNull.class;
+ *
+ * Every request is accepted, and the resulting state is tracked exactly as it would be for
+ * a real GL engine, but no calls are made to the GL engine. Buffers, textures, framebuffers,
+ * renderbuffers, shaders and shader programs are assigned unique fake names. Shaders always
+ * compile, and shader programs always link. Reading pixels returns transparent black.
+ *
+ * When a shader program is linked, the uniform and attribute declarations in the GLSL source
+ * code of its shaders are reported as the active variables of the program, so that shader
+ * programs configure and populate their variables as they would with a real GL engine. Unlike
+ * a real GL engine, every declared variable is reported, whether or not the shader uses it, and
+ * declarations within inactive conditional compilation blocks are included. Array sizes may be
+ * integer literals, or names defined as integer literals by a #define directive. Uniforms whose
+ * types are structures are not reported.
+ *
+ * The number of draw calls and vertices that would have been drawn are counted, and can be
+ * used to verify the drawing of a scene.
+ */
+@interface CC3OpenGLNull : CC3OpenGLProgPipeline {
+	NSMutableDictionary* _renderbufferSizes;
+	NSMutableDictionary* _shaderSources;
+	NSMutableDictionary* _programShaders;
+	NSMutableDictionary* _programUniforms;
+	NSMutableDictionary* _programAttributes;
+	GLuint _drawCallCount;
+	GLuint _verticesDrawn;
+}
+
+/** Returns the number of draw calls made since this instance was created, or the counts were reset. */
+@property(nonatomic, readonly) GLuint drawCallCount;
+
+/** Returns the number of vertices drawn since this instance was created, or the counts were reset. */
+@property(nonatomic, readonly) GLuint verticesDrawn;
+
+/** Resets the values of the drawCallCount and verticesDrawn properties to zero. */
+-(void) resetDrawCounts;
+
+/**
+ * Returns the number of fake GL objects (buffers, textures, framebuffers, renderbuffers,
+ * shaders and shader programs) that have been generated and not yet deleted, across all
+ * instances of this class.
+ *
+ * This can be used to detect the leaking of GL objects.
+ */
++(GLuint) liveObjectCount;
+
+@end
+
+#endif	// CC3_GLSL
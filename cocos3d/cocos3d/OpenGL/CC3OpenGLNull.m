@@ -0,0 +1,853 @@
+/*
+ * CC3OpenGLNull.m
+ *
+ * Cocos3D 2.0.2
+ * Author: Bill Hollings
+ * Copyright (c) 2010-2014 The Brenwill Workshop Ltd. All rights reserved.
+ * http://www.brenwill.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+
+
+#import "CC3OpenGLNull.h"
+
+#if CC3_GLSL
+
+#import "CC3Shaders.h"
+
+/** The platform limits reported by the null GL engine. */
+#define kCC3OpenGLNullMaxTextureSize			4096
+#define kCC3OpenGLNullMaxTextureUnits			8
+#define kCC3OpenGLNullMaxVertexAttributes		16
+#define kCC3OpenGLNullMaxUniformVectors			256
+#define kCC3OpenGLNullMaxVaryingVectors			16
+
+/** Macro for setting the cached value of a single state, without updating the GL engine. */
+#define cc3_SetNullGLState(val, var, isKnown)	\
+	var = (val);								\
+	isKnown = YES;
+
+@interface CC3OpenGL (TemplateMethods)
+-(void) initGLContext;
+-(void) initPlatformLimits;
+-(void) clearTextureBinding: (GLuint) texID;
+-(BOOL) checkGLFramebuffer: (GLuint) fbID;
+-(BOOL) checkGLFramebufferTarget: (GLenum) fbTarg;
+-(void) align2DStateCacheWithVisitor: (CC3NodeDrawingVisitor*) visitor;
+@end
+
+@interface CC3GLSLVariable (OpenGLNull)
+-(void) populateFromNullGLDescription: (NSDictionary*) varDesc atLocation: (GLint) location;
+@end
+
+
+#pragma mark -
+#pragma mark GLSL declaration parsing
+
+/** Keys of the descriptions of the variables declared in GLSL source code. */
+#define kCC3OpenGLNullVarNameKey		@"name"
+#define kCC3OpenGLNullVarTypeKey		@"type"
+#define kCC3OpenGLNullVarSizeKey		@"size"
+
+/** The GL type of each GLSL type that a uniform or attribute may be declared with. */
+static const struct { const char* glslType; GLenum glType; } kCC3OpenGLNullGLSLTypes[] = {
+	{ "float", GL_FLOAT },
+	{ "vec2", GL_FLOAT_VEC2 },
+	{ "vec3", GL_FLOAT_VEC3 },
+	{ "vec4", GL_FLOAT_VEC4 },
+	{ "int", GL_INT },
+	{ "ivec2", GL_INT_VEC2 },
+	{ "ivec3", GL_INT_VEC3 },
+	{ "ivec4", GL_INT_VEC4 },
+	{ "bool", GL_BOOL },
+	{ "bvec2", GL_BOOL_VEC2 },
+	{ "bvec3", GL_BOOL_VEC3 },
+	{ "bvec4", GL_BOOL_VEC4 },
+	{ "mat2", GL_FLOAT_MAT2 },
+	{ "mat3", GL_FLOAT_MAT3 },
+	{ "mat4", GL_FLOAT_MAT4 },
+	{ "sampler2D", GL_SAMPLER_2D },
+	{ "samplerCube", GL_SAMPLER_CUBE },
+};
+
+/** Returns the GL type of the specified GLSL type name, or GL_ZERO if it is not a basic GLSL type. */
+static GLenum CC3OpenGLNullGLTypeFromGLSLType(NSString* glslType) {
+	const char* cType = glslType.UTF8String;
+	GLuint typeCnt = sizeof(kCC3OpenGLNullGLSLTypes) / sizeof(kCC3OpenGLNullGLSLTypes[0]);
+	for (GLuint tIdx = 0; tIdx < typeCnt; tIdx++)
+		if (strcmp(cType, kCC3OpenGLNullGLSLTypes[tIdx].glslType) == 0) return kCC3OpenGLNullGLSLTypes[tIdx].glType;
+	return GL_ZERO;
+}
+
+/** Returns whether the specified token is a GLSL precision qualifier. */
+static BOOL CC3OpenGLNullIsPrecisionQualifier(NSString* token) {
+	return ([token isEqualToString: @"lowp"] ||
+			[token isEqualToString: @"mediump"] ||
+			[token isEqualToString: @"highp"]);
+}
+
+/** Returns the specified GLSL source code, with each comment replaced by spaces. Line breaks are retained. */
+static NSString* CC3OpenGLNullStripComments(NSString* glslSource) {
+	NSUInteger srcLen = glslSource.length;
+	unichar* chars = malloc(srcLen * sizeof(unichar));
+	[glslSource getCharacters: chars range: NSMakeRange(0, srcLen)];
+
+	BOOL isLineComment = NO, isBlockComment = NO;
+	for (NSUInteger cIdx = 0; cIdx < srcLen; cIdx++) {
+		unichar nextChar = (cIdx + 1 < srcLen) ? chars[cIdx + 1] : 0;
+		if (isLineComment) {
+			if (chars[cIdx] == '\n') isLineComment = NO;
+			else chars[cIdx] = ' ';
+		} else if (isBlockComment) {
+			if (chars[cIdx] == '*' && nextChar == '/') {
+				isBlockComment = NO;
+				chars[cIdx++] = ' ';
+			}
+			if (chars[cIdx] != '\n') chars[cIdx] = ' ';
+		} else if (chars[cIdx] == '/' && (nextChar == '/' || nextChar == '*')) {
+			isLineComment = (nextChar == '/');
+			isBlockComment = (nextChar == '*');
+			chars[cIdx++] = ' ';
+			chars[cIdx] = ' ';
+		}
+	}
+	NSString* stripped = [NSString stringWithCharacters: chars length: srcLen];
+	free(chars);
+	return stripped;
+}
+
+/** Returns the whitespace-separated tokens in the specified string. */
+static NSArray* CC3OpenGLNullTokens(NSString* str) {
+	NSMutableArray* tokens = [NSMutableArray array];
+	for (NSString* token in [str componentsSeparatedByCharactersInSet: NSCharacterSet.whitespaceAndNewlineCharacterSet])
+		if (token.length) [tokens addObject: token];
+	return tokens;
+}
+
+/**
+ * Returns the number of elements in the specified GLSL array size expression, which may be an
+ * integer literal, or a name defined as an integer literal in the specified definitions.
+ */
+static GLint CC3OpenGLNullArraySize(NSString* sizeExpr, NSDictionary* defines) {
+	NSString* definedSize = [defines objectForKey: sizeExpr];
+	GLint size = (GLint)(definedSize ? definedSize : sizeExpr).integerValue;
+	LogErrorIf(size <= 0, @"The null GL engine could not determine the array size [%@] of a shader variable", sizeExpr);
+	return MAX(size, 1);
+}
+
+/**
+ * Adds a description of each uniform and attribute declared in the specified GLSL source code,
+ * whose name is not in the specified set of names, to the specified uniforms or attributes array,
+ * in the order they are declared, and adds the name to the set.
+ *
+ * As with a real GL engine, an array variable is named with a [0] subscript.
+ */
+static void CC3OpenGLNullAddGLSLVariables(NSString* glslSource, NSMutableArray* uniforms,
+										  NSMutableArray* attributes, NSMutableSet* names) {
+	NSMutableDictionary* defines = [NSMutableDictionary dictionary];
+	NSMutableString* declarations = [NSMutableString string];
+
+	// Record integer definitions, and separate the declarations from the preprocessor directives
+	NSString* src = CC3OpenGLNullStripComments(glslSource);
+	for (NSString* line in [src componentsSeparatedByCharactersInSet: NSCharacterSet.newlineCharacterSet]) {
+		NSArray* tokens = CC3OpenGLNullTokens(line);
+		if (tokens.count && [[tokens objectAtIndex: 0] hasPrefix: @"#"]) {
+			if (tokens.count == 3 && [[tokens objectAtIndex: 0] isEqualToString: @"#define"])
+				[defines setObject: [tokens objectAtIndex: 2] forKey: [tokens objectAtIndex: 1]];
+			continue;
+		}
+		[declarations appendFormat: @"%@\n", line];
+	}
+
+	NSCharacterSet* stmtEnds = [NSCharacterSet characterSetWithCharactersInString: @";{}"];
+	for (NSString* stmt in [declarations componentsSeparatedByCharactersInSet: stmtEnds]) {
+		NSArray* tokens = CC3OpenGLNullTokens(stmt);
+		NSUInteger tokCnt = tokens.count;
+		if ( !tokCnt ) continue;
+
+		NSString* storage = [tokens objectAtIndex: 0];
+		NSMutableArray* vars = nil;
+		if ([storage isEqualToString: @"uniform"]) vars = uniforms;
+		if ([storage isEqualToString: @"attribute"]) vars = attributes;
+		if ( !vars ) continue;
+
+		NSUInteger tIdx = 1;
+		while (tIdx < tokCnt && CC3OpenGLNullIsPrecisionQualifier([tokens objectAtIndex: tIdx])) tIdx++;
+		if (tIdx >= tokCnt) continue;
+		GLenum type = CC3OpenGLNullGLTypeFromGLSLType([tokens objectAtIndex: tIdx++]);
+		if ( !type ) continue;
+
+		// Each declarator is a name, optionally followed by an array size
+		NSString* declarators = [[tokens subarrayWithRange: NSMakeRange(tIdx, tokCnt - tIdx)] componentsJoinedByString: @""];
+		for (NSString* declarator in [declarators componentsSeparatedByString: @","]) {
+			NSRange bracket = [declarator rangeOfString: @"["];
+			NSString* name = declarator;
+			GLint size = 1;
+			if (bracket.location != NSNotFound) {
+				name = [declarator substringToIndex: bracket.location];
+				NSString* sizeExpr = [[declarator substringFromIndex: NSMaxRange(bracket)]
+									  stringByTrimmingCharactersInSet: [NSCharacterSet characterSetWithCharactersInString: @"]"]];
+				size = CC3OpenGLNullArraySize(sizeExpr, defines);
+			}
+			if ( !name.length || [names containsObject: name] ) continue;
+			[names addObject: name];
+
+			NSString* glName = (bracket.location != NSNotFound) ? [name stringByAppendingString: @"[0]"] : name;
+			[vars addObject: [NSDictionary dictionaryWithObjectsAndKeys:
+							  glName, kCC3OpenGLNullVarNameKey,
+							  [NSNumber numberWithUnsignedInt: type], kCC3OpenGLNullVarTypeKey,
+							  [NSNumber numberWithInt: size], kCC3OpenGLNullVarSizeKey, nil]];
+		}
+	}
+}
+
+/** Returns the length of the longest variable name in the specified descriptions, including the null terminator. */
+static GLint CC3OpenGLNullMaxNameLength(NSArray* vars) {
+	GLint maxLen = 0;
+	for (NSDictionary* var in vars)
+		maxLen = MAX(maxLen, (GLint)[[var objectForKey: kCC3OpenGLNullVarNameKey] lengthOfBytesUsingEncoding: NSUTF8StringEncoding] + 1);
+	return maxLen;
+}
+
+/** Extension to populate a GLSL variable from a description of its declaration. */
+@implementation CC3GLSLVariable (OpenGLNull)
+
+-(void) populateFromNullGLDescription: (NSDictionary*) varDesc atLocation: (GLint) location {
+	[_name release];
+	_name = [[varDesc objectForKey: kCC3OpenGLNullVarNameKey] retain];
+	_type = [[varDesc objectForKey: kCC3OpenGLNullVarTypeKey] unsignedIntValue];
+	_size = [[varDesc objectForKey: kCC3OpenGLNullVarSizeKey] intValue];
+	_location = location;
+}
+
+@end
+
+
+#pragma mark -
+#pragma mark CC3OpenGLNull
+
+@implementation CC3OpenGLNull
+
+@synthesize drawCallCount=_drawCallCount, verticesDrawn=_verticesDrawn;
+
+-(void) dealloc {
+	[_renderbufferSizes release];
+	[_shaderSources release];
+	[_programShaders release];
+	[_programUniforms release];
+	[_programAttributes release];
+	[super dealloc];
+}
+
+-(void) resetDrawCounts {
+	_drawCallCount = 0;
+	_verticesDrawn = 0;
+}
+
+
+#pragma mark Fake GL object names
+
+static volatile int32_t _lastObjectName = 0;
+static volatile int32_t _liveObjectCount = 0;
+
++(GLuint) liveObjectCount { return MAX(_liveObjectCount, 0); }
+
+/** 
+ * Returns a new unique fake GL object name. Names are unique across all instances,
+ * since GL objects are shared between the rendering and background GL contexts.
+ */
+-(GLuint) generateObjectName {
+	__sync_add_and_fetch(&_liveObjectCount, 1);
+	return (GLuint)__sync_add_and_fetch(&_lastObjectName, 1);
+}
+
+/** Marks the fake GL object with the specified name as deleted. */
+-(void) deleteObjectName: (GLuint) objName {
+	if (objName) __sync_sub_and_fetch(&_liveObjectCount, 1);
+}
+
+
+#pragma mark Capabilities
+
+-(void) enableBlend: (BOOL) onOff { cc3_SetNullGLState(onOff, valueCap_GL_BLEND, isKnownCap_GL_BLEND); }
+
+-(void) enableCullFace: (BOOL) onOff { cc3_SetNullGLState(onOff, valueCap_GL_CULL_FACE, isKnownCap_GL_CULL_FACE); }
+
+-(void) enableDepthTest: (BOOL) onOff { cc3_SetNullGLState(onOff, valueCap_GL_DEPTH_TEST, isKnownCap_GL_DEPTH_TEST); }
+
+-(void) enableDither: (BOOL) onOff { cc3_SetNullGLState(onOff, valueCap_GL_DITHER, isKnownCap_GL_DITHER); }
+
+-(void) enablePolygonOffset: (BOOL) onOff { cc3_SetNullGLState(onOff, valueCap_GL_POLYGON_OFFSET_FILL, isKnownCap_GL_POLYGON_OFFSET_FILL); }
+
+-(void) enableSampleAlphaToCoverage: (BOOL) onOff { cc3_SetNullGLState(onOff, valueCap_GL_SAMPLE_ALPHA_TO_COVERAGE, isKnownCap_GL_SAMPLE_ALPHA_TO_COVERAGE); }
+
+-(void) enableSampleCoverage: (BOOL) onOff { cc3_SetNullGLState(onOff, valueCap_GL_SAMPLE_COVERAGE, isKnownCap_GL_SAMPLE_COVERAGE); }
+
+-(void) enableScissorTest: (BOOL) onOff { cc3_SetNullGLState(onOff, valueCap_GL_SCISSOR_TEST, isKnownCap_GL_SCISSOR_TEST); }
+
+-(void) enableStencilTest: (BOOL) onOff { cc3_SetNullGLState(onOff, valueCap_GL_STENCIL_TEST, isKnownCap_GL_STENCIL_TEST); }
+
+
+#pragma mark Vertex attribute arrays
+
+-(void) setVertexAttributeEnablementAt: (GLint) vaIdx {}
+
+-(void) bindVertexContentToAttributeAt: (GLint) vaIdx {}
+
+-(GLuint) generateBuffer { return [self generateObjectName]; }
+
+-(void) deleteBuffer: (GLuint) buffID  {
+	if ( !buffID ) return;		// Silently ignore zero ID
+	[self deleteObjectName: buffID];
+	if (value_GL_ARRAY_BUFFER_BINDING == buffID)
+		value_GL_ARRAY_BUFFER_BINDING = 0;
+	if (value_GL_ELEMENT_ARRAY_BUFFER_BINDING == buffID)
+		value_GL_ELEMENT_ARRAY_BUFFER_BINDING = 0;
+}
+
+-(void) bindBuffer: (GLuint) buffId  toTarget: (GLenum) target {
+	if (target == GL_ELEMENT_ARRAY_BUFFER) {
+		cc3_CheckGLPrim(buffId, value_GL_ELEMENT_ARRAY_BUFFER_BINDING, isKnown_GL_ELEMENT_ARRAY_BUFFER_BINDING);
+		if ( !needsUpdate ) return;
+	} else {
+		cc3_CheckGLPrim(buffId, value_GL_ARRAY_BUFFER_BINDING, isKnown_GL_ARRAY_BUFFER_BINDING);
+		if ( !needsUpdate ) return;
+	}
+	[self bindVertexArrayObject: 0];
+}
+
+-(void) loadBufferTarget: (GLenum) target
+				withData: (GLvoid*) buffPtr
+				ofLength: (GLsizeiptr) buffLen
+				  forUse: (GLenum) buffUsage {}
+
+-(void) updateBufferTarget: (GLenum) target
+				  withData: (GLvoid*) buffPtr
+				startingAt: (GLintptr) offset
+				 forLength: (GLsizeiptr) length {}
+
+-(void) bindVertexArrayObject: (GLuint) vaoId {
+	if ( !self.isRenderingContext ) return;
+	cc3_SetNullGLState(vaoId, value_GL_VERTEX_ARRAY_BINDING, isKnown_GL_VERTEX_ARRAY_BINDING);
+}
+
+-(void) drawVerticiesAs: (GLenum) drawMode startingAt: (GLuint) start withLength: (GLuint) len {
+	_drawCallCount++;
+	_verticesDrawn += len;
+}
+
+-(void) drawIndicies: (GLvoid*) indicies ofLength: (GLuint) len andType: (GLenum) type as: (GLenum) drawMode {
+	_drawCallCount++;
+	_verticesDrawn += len;
+}
+
+
+#pragma mark State
+
+-(void) setClearColor: (ccColor4F) color {
+	cc3_SetNullGLState(color, value_GL_COLOR_CLEAR_VALUE, isKnown_GL_COLOR_CLEAR_VALUE);
+}
+
+-(void) setClearDepth: (GLfloat) val {
+	cc3_SetNullGLState(val, value_GL_DEPTH_CLEAR_VALUE, isKnown_GL_DEPTH_CLEAR_VALUE);
+}
+
+-(void) setClearStencil: (GLint) val {
+	cc3_SetNullGLState(val, value_GL_STENCIL_CLEAR_VALUE, isKnown_GL_STENCIL_CLEAR_VALUE);
+}
+
+-(void) setColorMask: (ccColor4B) mask {
+	ccColor4B maskBools = ccc4(mask.r != 0, mask.g != 0, mask.b != 0, mask.a != 0);
+	cc3_SetNullGLState(maskBools, value_GL_COLOR_WRITEMASK, isKnown_GL_COLOR_WRITEMASK);
+}
+
+-(void) setCullFace: (GLenum) val {
+	cc3_SetNullGLState(val, value_GL_CULL_FACE_MODE, isKnown_GL_CULL_FACE_MODE);
+}
+
+-(void) setDepthFunc: (GLenum) val {
+	cc3_SetNullGLState(val, value_GL_DEPTH_FUNC, isKnown_GL_DEPTH_FUNC);
+}
+
+-(void) setDepthMask: (BOOL) writable {
+	cc3_SetNullGLState(writable, value_GL_DEPTH_WRITEMASK, isKnown_GL_DEPTH_WRITEMASK);
+}
+
+-(void) setFrontFace: (GLenum) val {
+	cc3_SetNullGLState(val, value_GL_FRONT_FACE, isKnown_GL_FRONT_FACE);
+}
+
+-(void) setLineWidth: (GLfloat) val {
+	cc3_SetNullGLState(val, value_GL_LINE_WIDTH, isKnown_GL_LINE_WIDTH);
+}
+
+-(void) setPolygonOffsetFactor: (GLfloat) factor units: (GLfloat) units {
+	value_GL_POLYGON_OFFSET_FACTOR = factor;
+	value_GL_POLYGON_OFFSET_UNITS = units;
+	isKnownPolygonOffset = YES;
+}
+
+-(void) setScissor: (CC3Viewport) vp {
+	cc3_SetNullGLState(vp, value_GL_SCISSOR_BOX, isKnown_GL_SCISSOR_BOX);
+}
+
+-(void) setStencilFunc: (GLenum) func reference: (GLint) ref mask: (GLuint) mask {
+	value_GL_STENCIL_FUNC = func;
+	value_GL_STENCIL_REF = ref;
+	value_GL_STENCIL_VALUE_MASK = mask;
+	isKnownStencilFunc = YES;
+}
+
+-(void) setStencilMask: (GLuint) mask {
+	cc3_SetNullGLState(mask, value_GL_STENCIL_WRITEMASK, isKnown_GL_STENCIL_WRITEMASK);
+}
+
+-(void) setOpOnStencilFail: (GLenum) sFail onDepthFail: (GLenum) zFail onDepthPass: (GLenum) zPass {
+	value_GL_STENCIL_FAIL = sFail;
+	value_GL_STENCIL_PASS_DEPTH_FAIL = zFail;
+	value_GL_STENCIL_PASS_DEPTH_PASS = zPass;
+	isKnownStencilOp = YES;
+}
+
+-(void) setViewport: (CC3Viewport) vp {
+	cc3_SetNullGLState(vp, value_GL_VIEWPORT, isKnown_GL_VIEWPORT);
+}
+
+
+#pragma mark Materials
+
+-(void) setBlendFuncSrcRGB: (GLenum) srcRGB dstRGB: (GLenum) dstRGB
+				  srcAlpha: (GLenum) srcAlpha dstAlpha: (GLenum) dstAlpha {
+	value_GL_BLEND_SRC_RGB = srcRGB;
+	value_GL_BLEND_DST_RGB = dstRGB;
+	value_GL_BLEND_SRC_ALPHA = srcAlpha;
+	value_GL_BLEND_DST_ALPHA = dstAlpha;
+	isKnownBlendFunc = YES;
+}
+
+
+#pragma mark Textures
+
+-(GLuint) generateTexture { return [self generateObjectName]; }
+
+-(void) deleteTexture: (GLuint) texID {
+	if ( !texID ) return;		// Silently ignore zero texture ID
+	[self deleteObjectName: texID];
+	[self clearTextureBinding: texID];
+}
+
+-(void) loadTexureImage: (const GLvoid*) imageData
+			 intoTarget: (GLenum) target
+		  onMipmapLevel: (GLint) mipmapLevel
+			   withSize: (CC3IntSize) size
+			 withFormat: (GLenum) texelFormat
+			   withType: (GLenum) texelType
+	  withByteAlignment: (GLint) byteAlignment
+					 at: (GLuint) tuIdx {
+	
+	CC3Assert(size.width <= [self maxTextureSizeForTarget: target] && size.height <= [self maxTextureSizeForTarget: target],
+			  @"%@ exceeds the maximum texture size, %u per side, for target %@",
+			  NSStringFromCC3IntSize(size), [self maxTextureSizeForTarget: target], NSStringFromGLEnum(target));
+	
+	[self activateTextureUnit: tuIdx];
+	[self setPixelUnpackingAlignment: byteAlignment];
+}
+
+-(void) loadTexureSubImage: (const GLvoid*) imageData
+				intoTarget: (GLenum) target
+			 onMipmapLevel: (GLint) mipmapLevel
+			 intoRectangle: (CC3Viewport) rect
+				withFormat: (GLenum) texelFormat
+				  withType: (GLenum) texelType
+		 withByteAlignment: (GLint) byteAlignment
+						at: (GLuint) tuIdx {
+	[self activateTextureUnit: tuIdx];
+	[self setPixelUnpackingAlignment: byteAlignment];
+}
+
+-(void) activateTextureUnit: (GLuint) tuIdx {
+	cc3_CheckGLPrim(tuIdx, value_GL_ACTIVE_TEXTURE, isKnown_GL_ACTIVE_TEXTURE);
+	if ( !needsUpdate ) return;
+	value_MaxTextureUnitsUsed = MAX(value_MaxTextureUnitsUsed, tuIdx + 1);
+}
+
+-(void) disableTexturingAt: (GLuint) tuIdx {
+	[self bindTexture: 0 toTarget: GL_TEXTURE_2D at: tuIdx];
+	[self bindTexture: 0 toTarget: GL_TEXTURE_CUBE_MAP at: tuIdx];
+}
+
+-(void) bindTexture: (GLuint) texID toTarget: (GLenum) target at: (GLuint) tuIdx {
+	GLuint* stateArray;
+	GLbitfield* isKnownBits;
+	
+	switch (target) {
+		case GL_TEXTURE_2D:
+			stateArray = value_GL_TEXTURE_BINDING_2D;
+			isKnownBits = &isKnown_GL_TEXTURE_BINDING_2D;
+			break;
+		case GL_TEXTURE_CUBE_MAP:
+			stateArray = value_GL_TEXTURE_BINDING_CUBE_MAP;
+			isKnownBits = &isKnown_GL_TEXTURE_BINDING_CUBE_MAP;
+			break;
+		default:
+			CC3Assert(NO, @"Texture target %@ is not a valid binding target.", NSStringFromGLEnum(target));
+			return;
+	}
+	
+	if (CC3CheckGLuintAt(tuIdx, texID, stateArray, isKnownBits)) {
+		[self activateTextureUnit: tuIdx];
+		if (texID) [self unbindTexturesExceptTarget: target at: tuIdx];
+	}
+}
+
+-(void) unbindTexturesExceptTarget: (GLenum) target at: (GLuint) tuIdx {
+	GLenum otherTarget = (target == GL_TEXTURE_2D) ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D;
+	[self bindTexture: 0 toTarget: otherTarget at: tuIdx];
+}
+
+-(void) setTexParamEnum: (GLenum) pName inTarget: (GLenum) target to: (GLenum) val at: (GLuint) tuIdx {
+	[self activateTextureUnit: tuIdx];
+}
+
+-(void) generateMipmapForTarget: (GLenum)target at: (GLuint) tuIdx {
+	[self activateTextureUnit: tuIdx];
+}
+
+-(NSString*) dumpTextureBindingsAt: (GLuint) tuIdx {
+	return [NSString stringWithFormat: @"%@: %u, %@: %u",
+			NSStringFromGLEnum(GL_TEXTURE_2D), value_GL_TEXTURE_BINDING_2D[tuIdx],
+			NSStringFromGLEnum(GL_TEXTURE_CUBE_MAP), value_GL_TEXTURE_BINDING_CUBE_MAP[tuIdx]];
+}
+
+
+#pragma mark Hints
+
+-(void) setGenerateMipmapHint: (GLenum) hint {
+	cc3_SetNullGLState(hint, value_GL_GENERATE_MIPMAP_HINT, isKnown_GL_GENERATE_MIPMAP_HINT);
+}
+
+
+#pragma mark Framebuffers
+
+-(GLuint) generateFramebuffer { return [self generateObjectName]; }
+
+-(void) deleteFramebuffer: (GLuint) fbID {
+	if ( !fbID ) return;		// Silently ignore zero ID
+	[self deleteObjectName: fbID];
+	if (value_GL_FRAMEBUFFER_BINDING == fbID) value_GL_FRAMEBUFFER_BINDING = 0;
+}
+
+-(void) bindFramebuffer: (GLuint) fbID toTarget: (GLenum) fbTarget {
+	[self checkGLFramebuffer: fbID];
+	[self checkGLFramebufferTarget: fbTarget];
+}
+
+-(GLuint) generateRenderbuffer { return [self generateObjectName]; }
+
+-(void) deleteRenderbuffer: (GLuint) rbID {
+	if ( !rbID ) return;		// Silently ignore zero ID
+	[self deleteObjectName: rbID];
+	[_renderbufferSizes removeObjectForKey: [NSNumber numberWithUnsignedInt: rbID]];
+	if (value_GL_RENDERBUFFER_BINDING == rbID) value_GL_RENDERBUFFER_BINDING = 0;
+}
+
+-(void) bindRenderbuffer: (GLuint) rbID {
+	cc3_SetNullGLState(rbID, value_GL_RENDERBUFFER_BINDING, isKnown_GL_RENDERBUFFER_BINDING);
+}
+
+/** Records the size and format of the storage allocated to the renderbuffer, so it can be retrieved later. */
+-(void) allocateStorageForRenderbuffer: (GLuint) rbID
+							  withSize: (CC3IntSize) size
+							 andFormat: (GLenum) format
+							andSamples: (GLuint) pixelSamples {
+	
+	CC3Assert(size.width <= self.maxRenderbufferSize && size.height <= self.maxRenderbufferSize,
+			  @"%@ exceeds the maximum renderbuffer size, %u per side",
+			  NSStringFromCC3IntSize(size), self.maxRenderbufferSize);
+	
+	[self bindRenderbuffer: rbID];
+	
+	if ( !_renderbufferSizes ) _renderbufferSizes = [NSMutableDictionary new];	// retained
+	GLint storage[3] = { size.width, size.height, (GLint)format };
+	[_renderbufferSizes setObject: [NSData dataWithBytes: storage length: sizeof(storage)]
+						   forKey: [NSNumber numberWithUnsignedInt: rbID]];
+}
+
+-(GLint) getRenderbufferParameterInteger: (GLenum) param {
+	NSData* storageData = [_renderbufferSizes objectForKey: [NSNumber numberWithUnsignedInt: value_GL_RENDERBUFFER_BINDING]];
+	if ( !storageData ) return 0;
+	
+	const GLint* storage = storageData.bytes;
+	switch (param) {
+		case GL_RENDERBUFFER_WIDTH: return storage[0];
+		case GL_RENDERBUFFER_HEIGHT: return storage[1];
+		case GL_RENDERBUFFER_INTERNAL_FORMAT: return storage[2];
+		default: return 0;
+	}
+}
+
+-(void) bindRenderbuffer: (GLuint) rbID toFrameBuffer: (GLuint) fbID asAttachment: (GLenum) attachment {
+	[self bindFramebuffer: fbID];
+	[self bindRenderbuffer: rbID];
+}
+
+-(void) bindTexture2D: (GLuint) texID
+				 face: (GLenum) face
+		  mipmapLevel: (GLint) mipmapLevel
+		toFrameBuffer: (GLuint) fbID
+		 asAttachment: (GLenum) attachment {
+	[self bindFramebuffer: fbID];
+}
+
+-(BOOL) checkFramebufferStatus: (GLuint) fbID {
+	[self bindFramebuffer: fbID];
+	return YES;
+}
+
+-(void) clearBuffers: (GLbitfield) mask {}
+
+-(void) readPixelsIn: (CC3Viewport) rect  fromFramebuffer: (GLuint) fbID into: (ccColor4B*) colorArray {
+	memset(colorArray, 0, rect.w * rect.h * sizeof(ccColor4B));
+}
+
+-(void) setPixelPackingAlignment: (GLint) byteAlignment {
+	cc3_SetNullGLState(byteAlignment, value_GL_PACK_ALIGNMENT, isKnown_GL_PACK_ALIGNMENT);
+}
+
+-(void) setPixelUnpackingAlignment: (GLint) byteAlignment {
+	cc3_SetNullGLState(byteAlignment, value_GL_UNPACK_ALIGNMENT, isKnown_GL_UNPACK_ALIGNMENT);
+}
+
+
+#pragma mark Platform limits & info
+
+-(void) flush {}
+
+-(void) finish {}
+
+/** Returns the tracked state for the binding parameters, and the platform limits of the null GL engine. */
+-(GLint) getInteger: (GLenum) param {
+	switch (param) {
+		case GL_MAX_TEXTURE_SIZE:
+		case GL_MAX_CUBE_MAP_TEXTURE_SIZE:
+		case GL_MAX_RENDERBUFFER_SIZE:
+			return kCC3OpenGLNullMaxTextureSize;
+		case GL_MAX_TEXTURE_IMAGE_UNITS:
+			return kCC3OpenGLNullMaxTextureUnits;
+		case GL_MAX_VERTEX_ATTRIBS:
+			return kCC3OpenGLNullMaxVertexAttributes;
+		case GL_TEXTURE_BINDING_2D:
+			return value_GL_TEXTURE_BINDING_2D[value_GL_ACTIVE_TEXTURE];
+		case GL_TEXTURE_BINDING_CUBE_MAP:
+			return value_GL_TEXTURE_BINDING_CUBE_MAP[value_GL_ACTIVE_TEXTURE];
+		case GL_ARRAY_BUFFER_BINDING:
+			return value_GL_ARRAY_BUFFER_BINDING;
+		case GL_ELEMENT_ARRAY_BUFFER_BINDING:
+			return value_GL_ELEMENT_ARRAY_BUFFER_BINDING;
+		case GL_CURRENT_PROGRAM:
+			return value_GL_CURRENT_PROGRAM;
+		default:
+			return 0;
+	}
+}
+
+-(GLfloat) getFloat: (GLenum) param { return 0.0f; }
+
+-(NSString*) getString: (GLenum) param {
+	switch (param) {
+		case GL_VENDOR: return @"Cocos3D";
+		case GL_RENDERER: return @"Null GL engine";
+		case GL_VERSION: return @"OpenGL ES 2.0 (Null)";
+		case GL_SHADING_LANGUAGE_VERSION: return @"OpenGL ES GLSL ES 1.00 (Null)";
+		default: return @"";
+	}
+}
+
+
+#pragma mark Shaders
+
+-(GLuint) createShader: (GLenum) shaderType { return [self generateObjectName]; }
+
+-(void) deleteShader: (GLuint) shaderID {
+	[self deleteObjectName: shaderID];
+	[_shaderSources removeObjectForKey: [NSNumber numberWithUnsignedInt: shaderID]];
+}
+
+/** Records the source code, so the variables it declares can be reported when a shader program is linked. */
+-(void) compileShader: (GLuint) shaderID
+				 from: (GLuint) srcStrCount
+	sourceCodeStrings: (const GLchar**) srcCodeStrings {
+	NSMutableString* glslSource = [NSMutableString string];
+	for (GLuint sIdx = 0; sIdx < srcStrCount; sIdx++)
+		[glslSource appendString: [NSString stringWithUTF8String: srcCodeStrings[sIdx]]];
+
+	if ( !_shaderSources ) _shaderSources = [NSMutableDictionary new];		// retained
+	[_shaderSources setObject: glslSource forKey: [NSNumber numberWithUnsignedInt: shaderID]];
+}
+
+/** Shaders always compile successfully. */
+-(GLint) getIntegerParameter: (GLenum) param forShader: (GLuint) shaderID {
+	return (param == GL_COMPILE_STATUS) ? GL_TRUE : 0;
+}
+
+-(NSString*) getLogForShader: (GLuint) shaderID { return nil; }
+
+-(NSString*) getSourceCodeForShader: (GLuint) shaderID {
+	return [_shaderSources objectForKey: [NSNumber numberWithUnsignedInt: shaderID]];
+}
+
+-(NSString*) defaultShaderPreamble {
+	return
+		@"#define CC3_PLATFORM_IOS 0\n"
+		@"#define CC3_PLATFORM_OSX 0\n"
+		@"#define CC3_PLATFORM_ANDROID 0\n";
+}
+
+-(GLuint) createShaderProgram { return [self generateObjectName]; }
+
+-(void) deleteShaderProgram: (GLuint) programID {
+	if ( !programID ) return;		// Silently ignore zero ID
+	if (value_GL_CURRENT_PROGRAM == programID) [self useShaderProgram: 0];
+	[self deleteObjectName: programID];
+
+	NSNumber* progKey = [NSNumber numberWithUnsignedInt: programID];
+	[_programShaders removeObjectForKey: progKey];
+	[_programUniforms removeObjectForKey: progKey];
+	[_programAttributes removeObjectForKey: progKey];
+}
+
+-(void) attachShader: (GLuint) shaderID toShaderProgram: (GLuint) programID {
+	if ( !_programShaders ) _programShaders = [NSMutableDictionary new];		// retained
+	NSNumber* progKey = [NSNumber numberWithUnsignedInt: programID];
+	NSMutableArray* shaderIDs = [_programShaders objectForKey: progKey];
+	if ( !shaderIDs ) {
+		shaderIDs = [NSMutableArray array];
+		[_programShaders setObject: shaderIDs forKey: progKey];
+	}
+	NSNumber* shaderKey = [NSNumber numberWithUnsignedInt: shaderID];
+	if ( ![shaderIDs containsObject: shaderKey] ) [shaderIDs addObject: shaderKey];
+}
+
+-(void) detachShader: (GLuint) shaderID fromShaderProgram: (GLuint) programID {
+	[[_programShaders objectForKey: [NSNumber numberWithUnsignedInt: programID]]
+	 removeObject: [NSNumber numberWithUnsignedInt: shaderID]];
+}
+
+/** Reports the uniforms and attributes declared in the source code of the attached shaders as active. */
+-(void) linkShaderProgram: (GLuint) programID {
+	NSNumber* progKey = [NSNumber numberWithUnsignedInt: programID];
+	NSMutableArray* uniforms = [NSMutableArray array];
+	NSMutableArray* attributes = [NSMutableArray array];
+	NSMutableSet* names = [NSMutableSet set];
+	for (NSNumber* shaderKey in [_programShaders objectForKey: progKey]) {
+		NSString* glslSource = [_shaderSources objectForKey: shaderKey];
+		if (glslSource) CC3OpenGLNullAddGLSLVariables(glslSource, uniforms, attributes, names);
+	}
+
+	if ( !_programUniforms ) _programUniforms = [NSMutableDictionary new];		// retained
+	if ( !_programAttributes ) _programAttributes = [NSMutableDictionary new];	// retained
+	[_programUniforms setObject: uniforms forKey: progKey];
+	[_programAttributes setObject: attributes forKey: progKey];
+}
+
+/**
+ * Shader programs always link and validate successfully. The active variables of a shader program
+ * are those declared in the source code of its shaders.
+ */
+-(GLint) getIntegerParameter: (GLenum) param forShaderProgram: (GLuint) programID {
+	NSNumber* progKey = [NSNumber numberWithUnsignedInt: programID];
+	switch (param) {
+		case GL_LINK_STATUS:
+		case GL_VALIDATE_STATUS:
+			return GL_TRUE;
+		case GL_ACTIVE_UNIFORMS:
+			return (GLint)[[_programUniforms objectForKey: progKey] count];
+		case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+			return CC3OpenGLNullMaxNameLength([_programUniforms objectForKey: progKey]);
+		case GL_ACTIVE_ATTRIBUTES:
+			return (GLint)[[_programAttributes objectForKey: progKey] count];
+		case GL_ACTIVE_ATTRIBUTE_MAX_LENGTH:
+			return CC3OpenGLNullMaxNameLength([_programAttributes objectForKey: progKey]);
+		default:
+			return 0;
+	}
+}
+
+-(void) useShaderProgram: (GLuint) programID {
+	cc3_SetNullGLState(programID, value_GL_CURRENT_PROGRAM, isKnown_GL_CURRENT_PROGRAM);
+}
+
+-(NSString*) getLogForShaderProgram: (GLuint) programID { return nil; }
+
+/**
+ * Populates the variable from the declaration at its index in the shader program. The location
+ * of each variable is its index, which is unique within the uniforms or attributes of the program.
+ */
+-(void) populateShaderProgramVariable: (CC3GLSLVariable*) var {
+	NSDictionary* progVars = [var isKindOfClass: CC3GLSLAttribute.class] ? _programAttributes : _programUniforms;
+	NSArray* vars = [progVars objectForKey: [NSNumber numberWithUnsignedInt: var.program.programID]];
+	if (var.index >= vars.count) return;
+	[var populateFromNullGLDescription: [vars objectAtIndex: var.index] atLocation: var.index];
+}
+
+-(void) setShaderProgramUniformValue: (CC3GLSLUniform*) uniform {
+	[self useShaderProgram: uniform.program.programID];
+}
+
+
+#pragma mark Debugging support
+
+-(void) pushGroupMarkerC: (const char*) marker {}
+
+-(void) popGroupMarker {}
+
+-(void) insertEventMarkerC: (const char*) marker {}
+
+-(void) setDebugLabel: (NSString*) label forObject: (GLuint) objID ofType: (GLenum) objType {}
+
+
+#pragma mark Aligning 2D & 3D state
+
+/** There is no Cocos2D GL state to align with. */
+-(void) align2DStateCacheWithVisitor: (CC3NodeDrawingVisitor*) visitor {}
+
+
+#pragma mark Allocation and initialization
+
+/** There is no GL engine context. */
+-(void) initGLContext {}
+
+-(void) initPlatformLimits {
+	[super initPlatformLimits];
+
+	value_GL_MAX_VERTEX_UNIFORM_VECTORS = kCC3OpenGLNullMaxUniformVectors;
+	value_GL_MAX_FRAGMENT_UNIFORM_VECTORS = kCC3OpenGLNullMaxUniformVectors;
+	value_GL_MAX_VARYING_VECTORS = kCC3OpenGLNullMaxVaryingVectors;
+	value_GL_MAX_CUBE_MAP_TEXTURE_SIZE = [self getInteger: GL_MAX_CUBE_MAP_TEXTURE_SIZE];
+}
+
+/** Shader programs are not prewarmed, since nothing is actually rendered. */
+-(void) initShaderProgramPrewarmer {}
+
+@end
+
+#endif	// CC3_GLSL
@@ -61,6 +61,22 @@ char* CC3GLEnumName(GLenum gle);
  */
 size_t CC3GLElementTypeSize(GLenum dataType);
 
+/**
+ * Returns the number of bytes in each texel of texture content having the specified GL pixel
+ * format and type, or zero if the combination is not recognized, or is a compressed format.
+ */
+GLuint CC3GLTexelSize(GLenum pixelFormat, GLenum pixelType);
+
+/**
+ * Returns the number of bytes occupied by a single image of the specified width and height,
+ * in pixels, having the specified GL pixel format and type.
+ *
+ * Block-compressed formats, including the PVRTC, ETC1, ETC2/EAC and S3TC formats, are sized
+ * from the dimensions and byte size of their compression blocks, including the minimum image
+ * dimensions imposed by the PVRTC formats. Returns zero if the format is not recognized.
+ */
+size_t CC3GLImageSize(GLenum pixelFormat, GLenum pixelType, GLint width, GLint height);
+
 /** Returns the GL color format enum corresponding to the specified number of color and alpha bit planes. */
 GLenum CC3GLColorFormatFromBitPlanes(GLint colorCount, GLint alphaCount);
 
@@ -142,6 +142,7 @@ char* CC3GLEnumName(GLenum gle) {
 		case GL_SHORT: return "GL_SHORT";
 		case GL_UNSIGNED_SHORT: return "GL_UNSIGNED_SHORT";
 		case GL_FIXED: return "GL_FIXED";
+		case GL_HALF_FLOAT_OES: return "GL_HALF_FLOAT_OES";
 		case GL_UNSIGNED_INT: return "GL_UNSIGNED_INT";
 
 		case GL_INT_VEC2: return "GL_INT_VEC2";
@@ -573,6 +574,7 @@ size_t CC3GLElementTypeSize(GLenum dataType) {
 		case GL_SHORT: return sizeof(GLshort);
 		case GL_UNSIGNED_SHORT: return sizeof(GLushort);
 		case GL_FIXED: return sizeof(GLfixed);
+		case GL_HALF_FLOAT_OES: return sizeof(GLushort);
 
 #if CC3_GLSL
 		case GL_UNSIGNED_INT: return sizeof(GLuint);
@@ -637,6 +639,107 @@ GLenum CC3GLColorFormatFromBitPlanes(GLint colorCount, GLint alphaCount) {
 	return GL_ZERO;
 }
 
+GLuint CC3GLTexelSize(GLenum pixelFormat, GLenum pixelType) {
+	switch (pixelFormat) {
+		case GL_RGBA:
+			switch (pixelType) {
+				case GL_UNSIGNED_BYTE: return 4;
+				case GL_UNSIGNED_SHORT_4_4_4_4:
+				case GL_UNSIGNED_SHORT_5_5_5_1: return 2;
+				default: return 0;
+			}
+		case GL_RGB:
+			switch (pixelType) {
+				case GL_UNSIGNED_BYTE: return 3;
+				case GL_UNSIGNED_SHORT_5_6_5: return 2;
+				default: return 0;
+			}
+		case GL_LUMINANCE_ALPHA: return 2;
+		case GL_LUMINANCE:
+		case GL_ALPHA: return 1;
+		case GL_DEPTH_COMPONENT:
+			switch (pixelType) {
+				case GL_UNSIGNED_INT: return 4;
+				case GL_UNSIGNED_SHORT: return 2;
+				default: return 0;
+			}
+		case GL_DEPTH_STENCIL: return 4;
+		default: return 0;
+	}
+}
+
+// Compressed texture formats, which are not declared by the GL headers of every platform
+#ifndef GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG
+#	define GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG			0x8C00
+#	define GL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG			0x8C01
+#	define GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG			0x8C02
+#	define GL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG			0x8C03
+#endif
+#ifndef GL_ETC1_RGB8_OES
+#	define GL_ETC1_RGB8_OES								0x8D64
+#endif
+#ifndef GL_COMPRESSED_R11_EAC
+#	define GL_COMPRESSED_R11_EAC						0x9270
+#	define GL_COMPRESSED_SIGNED_R11_EAC					0x9271
+#	define GL_COMPRESSED_RG11_EAC						0x9272
+#	define GL_COMPRESSED_SIGNED_RG11_EAC				0x9273
+#	define GL_COMPRESSED_RGB8_ETC2						0x9274
+#	define GL_COMPRESSED_SRGB8_ETC2						0x9275
+#	define GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2	0x9276
+#	define GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2	0x9277
+#	define GL_COMPRESSED_RGBA8_ETC2_EAC					0x9278
+#	define GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC			0x9279
+#endif
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#	define GL_COMPRESSED_RGB_S3TC_DXT1_EXT				0x83F0
+#	define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT				0x83F1
+#	define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT				0x83F2
+#	define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT				0x83F3
+#endif
+
+/** Returns the number of bytes in an image of the specified size, compressed into blocks of the specified size. */
+static size_t CC3GLBlockCompressedImageSize(GLint width, GLint height,
+											GLint blockWidth, GLint blockHeight, GLuint blockSize) {
+	size_t blocksWide = (MAX(width, 1) + blockWidth - 1) / blockWidth;
+	size_t blocksHigh = (MAX(height, 1) + blockHeight - 1) / blockHeight;
+	return blocksWide * blocksHigh * blockSize;
+}
+
+size_t CC3GLImageSize(GLenum pixelFormat, GLenum pixelType, GLint width, GLint height) {
+	switch (pixelFormat) {
+
+		// PVRTC images are at least two blocks wide and two blocks high
+		case GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG:
+		case GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG:
+			return CC3GLBlockCompressedImageSize(MAX(width, 8), MAX(height, 8), 4, 4, 8);
+		case GL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG:
+		case GL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG:
+			return CC3GLBlockCompressedImageSize(MAX(width, 16), MAX(height, 8), 8, 4, 8);
+
+		case GL_ETC1_RGB8_OES:
+		case GL_COMPRESSED_R11_EAC:
+		case GL_COMPRESSED_SIGNED_R11_EAC:
+		case GL_COMPRESSED_RGB8_ETC2:
+		case GL_COMPRESSED_SRGB8_ETC2:
+		case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+			return CC3GLBlockCompressedImageSize(width, height, 4, 4, 8);
+
+		case GL_COMPRESSED_RG11_EAC:
+		case GL_COMPRESSED_SIGNED_RG11_EAC:
+		case GL_COMPRESSED_RGBA8_ETC2_EAC:
+		case GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
+		case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+			return CC3GLBlockCompressedImageSize(width, height, 4, 4, 16);
+
+		default:
+			return (size_t)MAX(width, 0) * MAX(height, 0) * CC3GLTexelSize(pixelFormat, pixelType);
+	}
+}
+
 GLenum CC3GLDepthFormatFromBitPlanes(GLint depthCount, GLint stencilCount) {
 	LogTrace(@"Depth buffer size: %i, stencil size: %i", depthCount, stencilCount);
 	
@@ -255,6 +255,10 @@
 #define GL_TEXTURE_CUBE_MAP               0x8513
 #endif
 
+#ifndef GL_HALF_FLOAT_OES
+#define GL_HALF_FLOAT_OES				  0x8D61
+#endif
+
 // Android compatibility
 
 #if APPORTABLE
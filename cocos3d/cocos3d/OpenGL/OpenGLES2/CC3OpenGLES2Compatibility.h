@@ -52,6 +52,10 @@
 #define GL_STACK_UNDERFLOW                0x0504
 #endif
 
+#ifndef GL_HALF_FLOAT_OES
+#define GL_HALF_FLOAT_OES				  0x8D61
+#endif
+
 
 // Color, depth and stencil buffers
 
@@ -391,6 +391,8 @@ static const GLuint kCC3ParticlesNoMax = kCC3MaxGLuint;
 	CCTime _elapsedTime;
 	CCTime _emissionInterval;
 	CCTime _timeSinceEmission;
+	CC3RandomStream _randomStream;
+	uint64_t _randomSeed;
 	BOOL _shouldRemoveOnFinish : 1;
 	BOOL _isEmitting : 1;
 	BOOL _wasStarted : 1;
@@ -524,6 +526,52 @@ static const GLuint kCC3ParticlesNoMax = kCC3MaxGLuint;
  */
 @property(nonatomic, assign) BOOL shouldRemoveOnFinish;
 
+/**
+ * The seed of the stream of random numbers, available through the randomStream property,
+ * that is used to randomize the characteristics of the particles emitted by this emitter.
+ *
+ * Setting this property reseeds the random stream, so that the particles subsequently emitted
+ * by this emitter are randomized identically each time this property is set to the same value.
+ * This allows particle effects to be reproduced exactly, for example when testing.
+ *
+ * When this emitter is initialized, this property is set from a value drawn from CC3RandomUInt,
+ * using the reseedRandomStream method. That value is itself reproducible if CC3RandomUInt has been
+ * seeded using the CC3RandomSeed function. Because the seeded sequence of CC3RandomUInt is not
+ * thread-safe, emitters should be created on the main thread if their emission is to be reproduced.
+ * Reading this property returns a seed that can be used to reproduce the emission.
+ *
+ * A copy of this emitter does not copy the value of this property. Each copy is seeded when it
+ * is initialized, so that copies of an emitter produce different particles, unless this property
+ * is set on each copy.
+ */
+@property(nonatomic, assign) uint64_t randomSeed;
+
+/**
+ * Sets the randomSeed property to a value drawn from CC3RandomUInt, reseeding the stream of random
+ * numbers available through the randomStream property.
+ *
+ * This method is invoked automatically when this emitter is initialized. A CC3FrameRecorder or
+ * CC3FrameReplayer also invokes this method on each emitter in the scene, after seeding CC3RandomUInt,
+ * when recording starts, or the replay is reset, so that the replay reproduces the recorded emission.
+ *
+ * Because the seeded sequence of CC3RandomUInt is not thread-safe, this method should only be
+ * invoked from the main thread.
+ */
+-(void) reseedRandomStream;
+
+/**
+ * Returns the stream of random numbers used to randomize the characteristics of the particles
+ * emitted by this emitter, as seeded by the randomSeed property.
+ *
+ * Subclasses, and the particle navigator, should use this stream, instead of the CC3RandomUInt
+ * family of functions, when initializing particles, by passing it to the CC3RandomStream family
+ * of functions, such as CC3RandomStreamFloatBetween, CC3RandomStreamVectorBetween and
+ * CC3RandomStreamColorBetween. Because the stream belongs to this emitter, the particles of this
+ * emitter are randomized independently of the activity of other emitters, and without contention
+ * if emitters are updated on different threads.
+ */
+@property(nonatomic, readonly) CC3RandomStream* randomStream;
+
 
 #pragma mark Allocation and initialization
 
@@ -978,6 +1026,14 @@ static const GLuint kCC3ParticlesNoMax = kCC3MaxGLuint;
  */
 @property(nonatomic, retain, readonly) Protocol* requiredParticleProtocol;
 
+/**
+ * Returns the stream of random numbers that this navigator should use to randomize the
+ * characteristics of particles during initialization.
+ *
+ * This implementation returns the randomStream property of the emitter.
+ */
+@property(nonatomic, readonly) CC3RandomStream* randomStream;
+
 /**
  * Template method that initializes the particle. For particles that follow a planned life-cycle
  * and trajectory, this navigator configures that life-cycle and trajectory for the particle
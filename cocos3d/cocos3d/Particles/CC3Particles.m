@@ -33,6 +33,7 @@
 #import "CC3UtilityMeshNodes.h"
 #import "CC3CC2Extensions.h"
 #import "CC3Scene.h"
+#import "CC3FrameRecording.h"
 #import <objc/runtime.h>
 
 
@@ -82,6 +83,18 @@
 
 -(CC3ParticleNavigator*) particleNavigator { return _particleNavigator; }
 
+-(uint64_t) randomSeed { return _randomSeed; }
+
+-(void) setRandomSeed: (uint64_t) aSeed {
+	_randomSeed = aSeed;
+	CC3RandomStreamSeed(&_randomStream, aSeed, 0);
+}
+
+/** Seed from the global sequence, so that seeding the global sequence reproduces emission. */
+-(void) reseedRandomStream { self.randomSeed = ((uint64_t)CC3RandomUInt() << 32) | CC3RandomUInt(); }
+
+-(CC3RandomStream*) randomStream { return &_randomStream; }
+
 -(void) setParticleNavigator: (CC3ParticleNavigator*) aNavigator {
 	if (aNavigator == _particleNavigator) return;
 
@@ -103,6 +116,7 @@
 
 -(void) setEmissionInterval: (CCTime) anInterval {
 	_emissionInterval = MAX(anInterval, 0.0);		// Force it to non-negative.
+	CC3FrameRecord(kCC3FrameEventEmissionInterval, self, 0, _emissionInterval);
 }
 
 -(GLfloat) emissionRate {
@@ -118,6 +132,7 @@
 	if (aRatePerSecond <= 0.0f) _emissionInterval = kCC3ParticleInfiniteInterval;
 	if (aRatePerSecond == kCC3ParticleInfiniteEmissionRate) _emissionInterval = 0.0f;
 	_emissionInterval = 1.0f / aRatePerSecond;
+	CC3FrameRecord(kCC3FrameEventEmissionInterval, self, 0, _emissionInterval);
 }
 
 
@@ -140,6 +155,7 @@
 		_shouldUpdateParticlesBeforeTransform = YES;
 		_shouldUpdateParticlesAfterTransform = NO;
 		_particleClass = nil;
+		[self reseedRandomStream];
 	}
 	return self;
 }
@@ -248,6 +264,7 @@
 }
 
 -(id<CC3ParticleProtocol>) emitParticle {
+	CC3FrameRecord(kCC3FrameEventEmitParticle, self, 0);
 	id<CC3ParticleProtocol> particle = [self acquireParticle];
 	return [self emitParticle: particle] ? particle : nil;
 }
@@ -375,6 +392,7 @@
 		_wasStarted = YES;
 	}
 	_isEmitting = shouldEmit;
+	CC3FrameRecord(kCC3FrameEventEmitting, self, 0, shouldEmit);
 }
 
 -(void) play { self.isEmitting = YES; }
@@ -382,6 +400,7 @@
 -(void) pause { self.isEmitting = NO; }
 
 -(void) stop {
+	CC3FrameRecord(kCC3FrameEventStopEmitting, self, 0);
 	[self pause];						// Stop emitting particles...
 	[self removeAllParticles];			// ...and kill those already emitted.
 	[_particles removeAllObjects];
@@ -487,6 +506,8 @@
 
 -(Protocol*) requiredParticleProtocol { return @protocol(CC3ParticleProtocol); }
 
+-(CC3RandomStream*) randomStream { return _emitter.randomStream; }
+
 -(void) initializeParticle: (id<CC3ParticleProtocol>) aParticle {}
 
 
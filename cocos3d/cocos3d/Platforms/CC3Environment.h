@@ -96,3 +96,32 @@
 #ifndef CC3_GLSL
 #	define CC3_GLSL			!(CC3_OGLES_1)
 #endif
+
+/**
+ * Compiling for a CPU with ARM NEON vector instructions. Matrix operations use NEON
+ * when this is set. Set to zero as a build setting to force the scalar code paths.
+ */
+#ifndef CC3_NEON
+#	if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#		define CC3_NEON			1
+#	else
+#		define CC3_NEON			0
+#	endif
+#endif
+
+/**
+ * Compiling for a CPU with Intel SSE vector instructions. Matrix operations use SSE
+ * when this is set. Set to zero as a build setting to force the scalar code paths.
+ */
+#ifndef CC3_SSE
+#	if defined(__SSE__) && !CC3_NEON
+#		define CC3_SSE			1
+#	else
+#		define CC3_SSE			0
+#	endif
+#endif
+
+/** Matrix operations are using either NEON or SSE vector instructions. */
+#ifndef CC3_SIMD
+#	define CC3_SIMD			((CC3_NEON) || (CC3_SSE))
+#endif
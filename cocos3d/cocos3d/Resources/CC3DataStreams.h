@@ -160,4 +160,77 @@
  */
 -(unsigned short) readUnsignedShort;
 
+
+#pragma mark Reading arrays of stream content
+
+/**
+ * Advances the stream position by the specified number of bytes, without reading them.
+ *
+ * If ALL of the bytes cannot be skipped, the stream position is not advanced.
+ *
+ * Returns YES if the stream position was advanced, otherwise returns NO.
+ */
+-(BOOL) skipBytes: (NSUInteger) count;
+
+/**
+ * Reads the specified number of floats into the specified array, converting the byte order
+ * of each from the byte order of the content, as indicated by the isBigEndian property, to
+ * the byte order of the platform, and advances the stream position.
+ *
+ * This is much faster than invoking the readFloat method once for each element.
+ *
+ * If ALL of the floats cannot be read, then the entire array is zeroed,
+ * and the stream position, as returned by the postion property, is not advanced.
+ *
+ * Returns YES if the requested number of floats was successfully read, otherwise returns NO.
+ */
+-(BOOL) readAll: (NSUInteger) count floats: (float*) floats;
+
+/**
+ * Reads the specified number of integers into the specified array, converting the byte order
+ * of each from the byte order of the content, as indicated by the isBigEndian property, to
+ * the byte order of the platform, and advances the stream position.
+ *
+ * This is much faster than invoking the readInteger method once for each element.
+ *
+ * If ALL of the integers cannot be read, then the entire array is zeroed,
+ * and the stream position, as returned by the postion property, is not advanced.
+ *
+ * Returns YES if the requested number of integers was successfully read, otherwise returns NO.
+ */
+-(BOOL) readAll: (NSUInteger) count integers: (int*) ints;
+
+/**
+ * Reads the specified number of shorts into the specified array, converting the byte order
+ * of each from the byte order of the content, as indicated by the isBigEndian property, to
+ * the byte order of the platform, and advances the stream position.
+ *
+ * This is much faster than invoking the readShort method once for each element.
+ *
+ * If ALL of the shorts cannot be read, then the entire array is zeroed,
+ * and the stream position, as returned by the postion property, is not advanced.
+ *
+ * Returns YES if the requested number of shorts was successfully read, otherwise returns NO.
+ */
+-(BOOL) readAll: (NSUInteger) count shorts: (short*) shorts;
+
+/**
+ * Reads the specified number of records into the specified array, and advances the stream position.
+ *
+ * Each record is a structure of the specified length, composed entirely of 4-byte elements, such
+ * as floats and integers (for example, a structure containing a float followed by a CC3Vector and
+ * a CC3Quaternion). The recordLength must be a multiple of 4. The byte order of each 4-byte
+ * element is converted from the byte order of the content, as indicated by the isBigEndian
+ * property, to the byte order of the platform.
+ *
+ * This allows an array of structured records, such as animation keyframes, to be read with
+ * a single bulk copy, instead of reading each element of each record individually.
+ *
+ * If ALL of the records cannot be read, then the entire array is zeroed,
+ * and the stream position, as returned by the postion property, is not advanced.
+ *
+ * Returns YES if the requested number of records was successfully read, otherwise returns NO.
+ */
+-(BOOL) readAll: (NSUInteger) count records: (GLvoid*) records ofLength: (NSUInteger) recordLength;
+
 @end
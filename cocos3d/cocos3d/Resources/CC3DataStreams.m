@@ -129,4 +129,51 @@
 	return _isBigEndian ? NSSwapBigShortToHost(value) : NSSwapLittleShortToHost(value);
 }
 
+
+#pragma mark Reading arrays of stream content
+
+/** Returns whether the byte order of the content differs from that of the platform. */
+-(BOOL) isSwappingByteOrder { return _isBigEndian != (NSHostByteOrder() == NS_BigEndian); }
+
+/** Reverses the byte order of each of the specified number of 4-byte words, in place. */
+static void CC3SwapByteOrder32(uint32_t* words, NSUInteger count) {
+	for (NSUInteger i = 0; i < count; i++) words[i] = NSSwapInt(words[i]);
+}
+
+/** Reverses the byte order of each of the specified number of 2-byte words, in place. */
+static void CC3SwapByteOrder16(uint16_t* words, NSUInteger count) {
+	for (NSUInteger i = 0; i < count; i++) words[i] = NSSwapShort(words[i]);
+}
+
+-(BOOL) skipBytes: (NSUInteger) count {
+	NSUInteger endRange = _readRange.location + count;
+	_wasReadBeyondEOF |= (endRange > _data.length);
+	if (_wasReadBeyondEOF) return NO;
+	_readRange.location = endRange;
+	return YES;
+}
+
+-(BOOL) readAll: (NSUInteger) count floats: (float*) floats {
+	return [self readAll: count records: floats ofLength: sizeof(*floats)];
+}
+
+-(BOOL) readAll: (NSUInteger) count integers: (int*) ints {
+	return [self readAll: count records: ints ofLength: sizeof(*ints)];
+}
+
+-(BOOL) readAll: (NSUInteger) count shorts: (short*) shorts {
+	if ( ![self readAll: (count * sizeof(*shorts)) bytes: (char*)shorts] ) return NO;
+	if (self.isSwappingByteOrder) CC3SwapByteOrder16((uint16_t*)shorts, count);
+	return YES;
+}
+
+-(BOOL) readAll: (NSUInteger) count records: (GLvoid*) records ofLength: (NSUInteger) recordLength {
+	CC3Assert((recordLength % sizeof(uint32_t)) == 0,
+			  @"%@ record length %lu must be a multiple of 4 bytes", self, (unsigned long)recordLength);
+	NSUInteger byteCount = count * recordLength;
+	if ( ![self readAll: byteCount bytes: (char*)records] ) return NO;
+	if (self.isSwappingByteOrder) CC3SwapByteOrder32((uint32_t*)records, (byteCount / sizeof(uint32_t)));
+	return YES;
+}
+
 @end
@@ -117,6 +117,22 @@
  */
 -(CC3Node*) getNodeMatching: (CC3Node*) node;
 
+/**
+ * Returns the number of bytes of application memory occupied by the content of this resource.
+ *
+ * This implementation returns the sum of the applicationMemoryBytes property of each distinct
+ * mesh contained within the nodes in the nodes array, or their descendants.
+ */
+@property(nonatomic, readonly) NSUInteger applicationMemoryBytes;
+
+/**
+ * Returns an estimate of the number of bytes of GL memory occupied by the content of this resource.
+ *
+ * This implementation returns the sum of the glMemoryBytes property of each distinct
+ * mesh contained within the nodes in the nodes array, or their descendants.
+ */
+@property(nonatomic, readonly) NSUInteger glMemoryBytes;
+
 /**
  * Adds the specified node to the collection of nodes loaded by this resource.
  *
@@ -30,6 +30,7 @@
  */
 
 #import "CC3NodesResource.h"
+#import "CC3MeshNode.h"
 
 @implementation CC3NodesResource
 
@@ -50,6 +51,28 @@
 	return nil;
 }
 
+/** Returns the distinct meshes contained within the nodes in the nodes array, or their descendants. */
+-(NSSet*) distinctMeshes {
+	NSMutableSet* meshes = [NSMutableSet set];
+	for (CC3Node* rezNode in self.nodes)
+		for (CC3Node* node in rezNode.flatten)
+			if ( [node isKindOfClass: CC3MeshNode.class] && ((CC3MeshNode*)node).mesh )
+				[meshes addObject: ((CC3MeshNode*)node).mesh];
+	return meshes;
+}
+
+-(NSUInteger) applicationMemoryBytes {
+	NSUInteger byteCnt = 0;
+	for (CC3Mesh* mesh in self.distinctMeshes) byteCnt += mesh.applicationMemoryBytes;
+	return byteCnt;
+}
+
+-(NSUInteger) glMemoryBytes {
+	NSUInteger byteCnt = 0;
+	for (CC3Mesh* mesh in self.distinctMeshes) byteCnt += mesh.glMemoryBytes;
+	return byteCnt;
+}
+
 -(void) addNode: (CC3Node*) node { [_nodes addObject: node]; }
 
 -(void) removeNode: (CC3Node*) node { [_nodes removeObjectIdenticalTo: node]; }
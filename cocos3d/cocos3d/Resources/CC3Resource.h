@@ -254,6 +254,30 @@
 /** Removes this resource instance from the cache. */
 -(void) remove;
 
+/**
+ * Returns the number of bytes of application memory occupied by the content of this resource.
+ *
+ * This implementation returns zero. Subclasses that hold significant content will override.
+ */
+@property(nonatomic, readonly) NSUInteger applicationMemoryBytes;
+
+/**
+ * Returns an estimate of the number of bytes of GL memory occupied by the content of this resource.
+ *
+ * This implementation returns zero. Subclasses that hold significant content will override.
+ */
+@property(nonatomic, readonly) NSUInteger glMemoryBytes;
+
+/**
+ * Returns an estimate of the number of bytes of memory occupied by the content of this resource.
+ *
+ * This value is used by the resource cache to track memory usage and enforce any byteBudget
+ * that has been set on the cache.
+ *
+ * This implementation returns the sum of the applicationMemoryBytes and glMemoryBytes properties.
+ */
+@property(nonatomic, readonly) NSUInteger cacheCost;
+
 /**
  * Adds the specified resource to the collection of loaded resources.
  *
@@ -329,6 +353,17 @@
  */
 +(NSString*) cachedResourcesDescription;
 
+/**
+ * Returns the cache holding the loaded resources.
+ *
+ * You can use the returned cache to set a byteBudget on the memory used by cached resources,
+ * and to retrieve statistics about the effectiveness of the cache. While the cache has a budget,
+ * it also retains recently used resources, so that they remain cached after they have been released
+ * elsewhere, and releases the least recently used of them, along with strongly cached
+ * (pre-loaded) resources, to remain within the budget.
+ */
++(CC3Cache*) resourceCache;
+
 
 #pragma mark Deprecated functionality
 
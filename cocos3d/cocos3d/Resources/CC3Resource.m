@@ -31,6 +31,8 @@
 
 #import "CC3Resource.h"
 #import "CC3NodesResource.h"
+#import "CC3PerformanceStatistics.h"
+#import <objc/runtime.h>
 
 
 @implementation CC3Resource
@@ -61,9 +63,12 @@
 	if (!_directory) self.directory = [absFilePath stringByDeletingLastPathComponent];
 	
 	MarkRezActivityStart();
+	CC3TraceBegin(class_getName(self.class), "resource", filePath.lastPathComponent.UTF8String);
 	
 	_wasLoaded = [self processFile: absFilePath];	// Main subclass loading method
 	
+	CC3TraceEnd(class_getName(self.class), "resource");
+	
 	if (_wasLoaded)
 		LogRez(@"Loaded resources from file '%@' in %.3f seconds", filePath, GetRezActivityDuration() * 1000);
 	else
@@ -124,6 +129,12 @@
 
 -(void) remove { [self.class removeResource: self]; }
 
+-(NSUInteger) applicationMemoryBytes { return 0; }
+
+-(NSUInteger) glMemoryBytes { return 0; }
+
+-(NSUInteger) cacheCost { return self.applicationMemoryBytes + self.glMemoryBytes; }
+
 static CC3Cache* _resourceCache = nil;
 
 +(void) ensureCache {
@@ -152,6 +163,11 @@ static CC3Cache* _resourceCache = nil;
 	_resourceCache.isWeak = !isPreloading;
 }
 
++(CC3Cache*) resourceCache {
+	[self ensureCache];
+	return _resourceCache;
+}
+
 +(NSString*) cachedResourcesDescription {
 	NSMutableString* desc = [NSMutableString stringWithCapacity: 500];
 	[_resourceCache enumerateObjectsUsingBlock: ^(CC3Resource* rez, BOOL* stop) {
@@ -0,0 +1,341 @@
+/*
+ * CC3FrameRecording.h
+ *
+ * Cocos3D 2.0.2
+ * Author: Bill Hollings
+ * Copyright (c) 2010-2014 The Brenwill Workshop Ltd. All rights reserved.
+ * http://www.brenwill.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+
+/** @file */	// Doxygen marker
+
+#import "CC3Node.h"
+
+@class CC3Scene;
+
+
+/**
+ * Set this switch to enable or disable the ability to record the changes made to a scene
+ * between frames. This can be set either here or via the compiler build setting
+ * GCC_PREPROCESSOR_DEFINITIONS in your build configuration.
+ *
+ * When this switch is enabled, changes are only recorded while a CC3FrameRecorder is recording.
+ * While no recorder is recording, each recording hook costs only the test of a single global
+ * flag. When this switch is disabled, the recording hooks are completely removed from the
+ * compiled code.
+ */
+#ifndef CC3_FRAME_RECORDING_ENABLED
+#	define CC3_FRAME_RECORDING_ENABLED		1
+#endif
+
+/** The magic number that begins each frame recording file. The characters "CC3F", read as a little-endian integer. */
+#define kCC3FrameRecordingMagic			0x46334343
+
+/** The version of the frame recording file format. */
+#define kCC3FrameRecordingVersion		1
+
+/**
+ * The changes to a scene, made between frames, that are captured by a CC3FrameRecorder,
+ * and reproduced by a CC3FrameReplayer.
+ *
+ * Each change applies to a node, and carries a fixed number of values.
+ */
+typedef enum {
+	kCC3FrameEventNone,							/**< No change. */
+	kCC3FrameEventLocation,						/**< The location property of the node was set. */
+	kCC3FrameEventRotation,						/**< The rotation property of the node was set. */
+	kCC3FrameEventRotateBy,						/**< The rotateBy: method of the node was invoked. */
+	kCC3FrameEventQuaternion,					/**< The quaternion property of the node was set. */
+	kCC3FrameEventRotateByQuaternion,			/**< The rotateByQuaternion: method of the node was invoked. */
+	kCC3FrameEventRotationAxis,					/**< The rotationAxis property of the node was set. */
+	kCC3FrameEventRotationAngle,				/**< The rotationAngle property of the node was set. */
+	kCC3FrameEventRotateByAngleAroundAxis,		/**< The rotateByAngle:aroundAxis: method of the node was invoked. */
+	kCC3FrameEventForwardDirection,				/**< The forwardDirection property of the node was set. */
+	kCC3FrameEventTargetLocation,				/**< The targetLocation property of the node was set. */
+	kCC3FrameEventScale,						/**< The scale property of the node was set. */
+	kCC3FrameEventAnimationEnabled,				/**< The isEnabled property of an animation track of the node was set. */
+	kCC3FrameEventAnimationBlendingWeight,		/**< The blendingWeight property of an animation track of the node was set. */
+	kCC3FrameEventAnimationTime,				/**< An animation track of the node was established at a frame time. */
+	kCC3FrameEventEmitting,						/**< The isEmitting property of the particle emitter was set. */
+	kCC3FrameEventEmissionInterval,				/**< The emission interval or rate of the particle emitter was set. */
+	kCC3FrameEventEmitParticle,					/**< The particle emitter was asked to emit a particle. */
+	kCC3FrameEventStopEmitting,					/**< The stop method of the particle emitter was invoked. */
+	kCC3FrameEventCount,						/**< The number of frame events. */
+} CC3FrameEvent;
+
+/** Returns a string description of the specified frame event. */
+NSString* NSStringFromCC3FrameEvent(CC3FrameEvent event);
+
+/** Returns the number of values carried by the specified frame event. */
+GLuint CC3FrameEventValueCount(CC3FrameEvent event);
+
+/**
+ * Indicates whether changes to nodes are currently being recorded by a CC3FrameRecorder.
+ *
+ * This flag is cleared while the recorded scene is being updated, so that only the changes
+ * made between frames, and not the changes that are derived from them during the update,
+ * are recorded.
+ *
+ * Do not set this flag directly. Use the start and stop methods of CC3FrameRecorder.
+ */
+extern volatile BOOL CC3FrameRecordingIsActive;
+
+/**
+ * Records the specified event for the specified node, if changes are being recorded by a
+ * CC3FrameRecorder, and the node is part of the scene being recorded.
+ *
+ * The trackID identifies the animation track for animation events, and is ignored for other
+ * events. The values must contain the number of values returned by CC3FrameEventValueCount.
+ *
+ * Rather than invoking this function directly, you should use the CC3FrameRecord macro,
+ * which avoids invoking this function when not recording.
+ */
+void CC3FrameRecordEvent(CC3FrameEvent event, CC3Node* node, GLuint trackID, const double* values);
+
+/**
+ * Records the specified event for the specified node, with the values that follow, if changes
+ * are being recorded by a CC3FrameRecorder. The values are not evaluated unless changes are
+ * being recorded.
+ */
+#if CC3_FRAME_RECORDING_ENABLED
+#	define CC3FrameRecord(event, node, trackID, ...)	\
+		do { if (CC3FrameRecordingIsActive) { double __vals[] = { 0, ##__VA_ARGS__ }; CC3FrameRecordEvent((event), (node), (trackID), __vals + 1); } } while (0)
+#else
+#	define CC3FrameRecord(event, node, trackID, ...)
+#endif
+
+
+#pragma mark -
+#pragma mark CC3FrameRecorder
+
+/**
+ * CC3FrameRecorder records the inputs to each frame of a CC3Scene into a compact binary log,
+ * so that a CC3FrameReplayer can later drive an identical scene through exactly the same
+ * sequence of frames. This allows a bug or a performance problem that only appears after a
+ * particular sequence of node movements, animation blending and particle emission to be
+ * reproduced, and then profiled or bisected one frame at a time.
+ *
+ * While recording, each invocation of the updateScene: method of the scene is recorded with
+ * its interval, and with the state of the reproducible random sequence of CC3RandomUInt, which
+ * the recorder seeds when recording starts. In addition, each change made between frames to
+ * the transform properties of a node, to the animation tracks of a node, or to the emission
+ * of a particle emitter, is recorded, as identified by the CC3FrameEvent enumeration.
+ *
+ * Changes made during the update of the scene are not recorded, because they are derived from
+ * the recorded changes, and will be derived again when the update is replayed. This includes
+ * changes made by the updateBeforeTransform: and updateAfterTransform: methods, and the particles
+ * emitted by the emitter itself. Changes made to nodes that are not part of the scene are also
+ * not recorded, so a node that is created and configured before it is added to the scene is
+ * reproduced by the replay only if the same node is added to the replayed scene.
+ *
+ * Nodes are identified in the log by their position within the structure of the scene, and
+ * are verified by name during replay. If a node is removed from the scene while recording, and
+ * a different node is later found at the same position, the identification of that position is
+ * recorded again, with the name of the new node. The replayed scene must therefore be constructed in
+ * the same way as the recorded scene, and any nodes added to, or removed from, the scene
+ * while recording must be added or removed in the same way during replay.
+ *
+ * Only one recorder may be recording at a time. The recorder must be used from the main thread,
+ * and changes made on other threads are not recorded.
+ *
+ * The log is held in memory while recording, and can be written to a file using the
+ * writeToFile: method. The log begins with a header containing kCC3FrameRecordingMagic,
+ * kCC3FrameRecordingVersion and the random seed, followed by a sequence of records, each
+ * consisting of a one-byte record type, followed by its content. All values are written
+ * in little-endian byte order, so the log may be replayed on a platform other than the
+ * one on which it was recorded.
+ */
+@interface CC3FrameRecorder : NSObject {
+	CC3Scene* _scene;
+	NSMutableData* _log;
+	NSMutableDictionary* _targetIndices;
+	NSMutableArray* _targetNodes;
+	NSMutableArray* _targetNames;
+	NSMutableDictionary* _nodeTargetIndices;
+	uint64_t _randomSeed;
+	GLuint _frameCount;
+	GLuint _eventCount;
+	BOOL _isRecording : 1;
+}
+
+/** The scene whose frames are recorded. */
+@property(nonatomic, retain, readonly) CC3Scene* scene;
+
+/**
+ * The seed used to initialize the reproducible random sequence of CC3RandomUInt when recording starts.
+ *
+ * The initial value of this property is a random value.
+ */
+@property(nonatomic, assign) uint64_t randomSeed;
+
+/** Returns whether this instance is currently recording. */
+@property(nonatomic, readonly) BOOL isRecording;
+
+/** Returns the number of frames that have been recorded. */
+@property(nonatomic, readonly) GLuint frameCount;
+
+/** Returns the number of changes to nodes that have been recorded. */
+@property(nonatomic, readonly) GLuint eventCount;
+
+/** Returns the content of the log that has been recorded. */
+@property(nonatomic, retain, readonly) NSData* log;
+
+/**
+ * Starts recording, discarding anything that was previously recorded by this instance.
+ *
+ * The reproducible random sequence of CC3RandomUInt is seeded with the value of the randomSeed
+ * property, and remains seeded after recording stops. The random stream of each particle emitter
+ * in the scene is then reseeded from that sequence, using the reseedRandomStream method of
+ * CC3ParticleEmitter, so that the replay reproduces the particles of each emitter.
+ *
+ * If another instance is currently recording, it is stopped.
+ */
+-(void) start;
+
+/** Stops recording. The log that has been recorded is retained. */
+-(void) stop;
+
+/** Writes the log that has been recorded to the file at the specified path, and returns whether the file was written successfully. */
+-(BOOL) writeToFile: (NSString*) filePath;
+
+/** Returns the instance that is currently recording, or nil if no instance is recording. */
++(CC3FrameRecorder*) activeRecorder;
+
+/**
+ * Invoked automatically by the updateScene: method of the scene, to record the update, and to
+ * update the scene with recording suspended. Returns whether the update was recorded. Returns
+ * NO if the specified scene is not the scene being recorded, in which case the scene is not updated.
+ */
+-(BOOL) recordUpdateOfScene: (CC3Scene*) scene forInterval: (CCTime) dt;
+
+/**
+ * Invoked automatically when a node is added to, or removed from, the specified scene.
+ *
+ * The index used to identify each node in the log is remembered for the node, so that the path
+ * to the node need not be rebuilt for each change. If the specified scene is the scene being
+ * recorded, the remembered indices are discarded, because the paths to the nodes may have changed.
+ */
+-(void) structureDidChangeInScene: (CC3Scene*) scene;
+
+
+#pragma mark Allocation and initialization
+
+/** Initializes this instance to record the frames of the specified scene. */
+-(id) initWithScene: (CC3Scene*) scene;
+
+/** Allocates and initializes an autoreleased instance to record the frames of the specified scene. */
++(id) recorderWithScene: (CC3Scene*) scene;
+
+@end
+
+
+#pragma mark -
+#pragma mark CC3FrameReplayer
+
+/**
+ * CC3FrameReplayer drives a scene through a sequence of frames that was recorded by a
+ * CC3FrameRecorder, reproducing the recorded changes to the nodes of the scene before each
+ * frame, and updating the scene with the recorded interval, and random state.
+ *
+ * The scene must be constructed in the same way as the scene that was recorded, and must be
+ * running, but need not be displayed. The changes that drove the recorded scene between frames,
+ * such as those made by CCActions, or by the app in response to touch events, are reproduced
+ * from the recording, and should not also be made to the replayed scene. Because replay does not depend on the display, frames
+ * may be stepped as quickly as they can be updated, and drawn, if needed, to an off-screen
+ * surface, including with CC3OpenGLNull, for profiling without a GPU.
+ *
+ * The replayer must be used from the main thread.
+ */
+@interface CC3FrameReplayer : NSObject {
+	CC3Scene* _scene;
+	NSData* _log;
+	NSMutableArray* _targetPaths;
+	NSMutableArray* _targetNames;
+	NSUInteger _position;
+	uint64_t _randomSeed;
+	GLuint _frameIndex;
+	GLuint _unresolvedEventCount;
+}
+
+/** The scene that is driven by the replay. */
+@property(nonatomic, retain, readonly) CC3Scene* scene;
+
+/** The seed that was used by the recording, and that is used to seed CC3RandomUInt when the replay is reset. */
+@property(nonatomic, readonly) uint64_t randomSeed;
+
+/** Returns the number of frames that have been replayed. */
+@property(nonatomic, readonly) GLuint frameIndex;
+
+/**
+ * Returns the number of recorded changes that could not be replayed, because the node they
+ * apply to could not be found in the scene, or had a different name than when it was recorded.
+ * A non-zero value indicates that the replayed scene has diverged from the recorded scene.
+ */
+@property(nonatomic, readonly) GLuint unresolvedEventCount;
+
+/** Returns whether all of the recorded frames have been replayed. */
+@property(nonatomic, readonly) BOOL isFinished;
+
+/**
+ * Replays the next recorded frame, by applying the changes that were recorded before it,
+ * and then updating the scene. Returns NO if all of the recorded frames have been replayed.
+ *
+ * The scene is not drawn. If needed, the app can draw the scene after this method returns.
+ */
+-(BOOL) replayNextFrame;
+
+/**
+ * Replays the recorded frames until the specified number of frames have been replayed, and
+ * returns the number of frames that were replayed by this invocation. This can be used to
+ * advance to the frame at which a problem appears.
+ */
+-(GLuint) replayToFrame: (GLuint) frameIndex;
+
+/** Replays all remaining recorded frames, and returns the number of frames that were replayed. */
+-(GLuint) replayAll;
+
+/**
+ * Returns to the beginning of the recording, and reseeds the reproducible random sequence of
+ * CC3RandomUInt with the recorded seed. The random stream of each particle emitter in the scene
+ * is then reseeded from that sequence, as it was when recording started. This does not restore
+ * the scene to its initial state.
+ */
+-(void) reset;
+
+
+#pragma mark Allocation and initialization
+
+/**
+ * Initializes this instance to replay the specified recording into the specified scene.
+ *
+ * Returns nil if the log is not a frame recording, or was recorded with an unsupported version.
+ */
+-(id) initWithLog: (NSData*) log forScene: (CC3Scene*) scene;
+
+/**
+ * Allocates and initializes an autoreleased instance to replay the recording in the file at the
+ * specified path into the specified scene. Returns nil if the file cannot be loaded.
+ */
++(id) replayerWithFile: (NSString*) filePath forScene: (CC3Scene*) scene;
+
+@end
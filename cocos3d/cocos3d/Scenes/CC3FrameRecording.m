@@ -0,0 +1,682 @@
+/*
+ * CC3FrameRecording.m
+ *
+ * Cocos3D 2.0.2
+ * Author: Bill Hollings
+ * Copyright (c) 2010-2014 The Brenwill Workshop Ltd. All rights reserved.
+ * http://www.brenwill.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ *
+ * See header file CC3FrameRecording.h for full API documentation.
+ */
+
+#import "CC3FrameRecording.h"
+#import "CC3Scene.h"
+#import "CC3NodeAnimation.h"
+#import "CC3Particles.h"
+
+
+/** The record type of the update of the scene for a frame. */
+#define kCC3FrameRecordUpdate		0xFE
+
+/** The record type that defines the index used to identify a node in subsequent event records. */
+#define kCC3FrameRecordTarget		0xFF
+
+/** The size of the header at the start of the log. */
+#define kCC3FrameRecordingHeaderLength	(sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint64_t))
+
+
+#pragma mark -
+#pragma mark Frame events
+
+NSString* NSStringFromCC3FrameEvent(CC3FrameEvent event) {
+	switch (event) {
+		case kCC3FrameEventNone: return @"None";
+		case kCC3FrameEventLocation: return @"Location";
+		case kCC3FrameEventRotation: return @"Rotation";
+		case kCC3FrameEventRotateBy: return @"RotateBy";
+		case kCC3FrameEventQuaternion: return @"Quaternion";
+		case kCC3FrameEventRotateByQuaternion: return @"RotateByQuaternion";
+		case kCC3FrameEventRotationAxis: return @"RotationAxis";
+		case kCC3FrameEventRotationAngle: return @"RotationAngle";
+		case kCC3FrameEventRotateByAngleAroundAxis: return @"RotateByAngleAroundAxis";
+		case kCC3FrameEventForwardDirection: return @"ForwardDirection";
+		case kCC3FrameEventTargetLocation: return @"TargetLocation";
+		case kCC3FrameEventScale: return @"Scale";
+		case kCC3FrameEventAnimationEnabled: return @"AnimationEnabled";
+		case kCC3FrameEventAnimationBlendingWeight: return @"AnimationBlendingWeight";
+		case kCC3FrameEventAnimationTime: return @"AnimationTime";
+		case kCC3FrameEventEmitting: return @"Emitting";
+		case kCC3FrameEventEmissionInterval: return @"EmissionInterval";
+		case kCC3FrameEventEmitParticle: return @"EmitParticle";
+		case kCC3FrameEventStopEmitting: return @"StopEmitting";
+		default: return [NSString stringWithFormat: @"Unknown frame event (%u)", event];
+	}
+}
+
+GLuint CC3FrameEventValueCount(CC3FrameEvent event) {
+	switch (event) {
+		case kCC3FrameEventQuaternion:
+		case kCC3FrameEventRotateByQuaternion:
+		case kCC3FrameEventRotateByAngleAroundAxis:
+			return 4;
+		case kCC3FrameEventLocation:
+		case kCC3FrameEventRotation:
+		case kCC3FrameEventRotateBy:
+		case kCC3FrameEventRotationAxis:
+		case kCC3FrameEventForwardDirection:
+		case kCC3FrameEventTargetLocation:
+		case kCC3FrameEventScale:
+			return 3;
+		case kCC3FrameEventRotationAngle:
+		case kCC3FrameEventAnimationEnabled:
+		case kCC3FrameEventAnimationBlendingWeight:
+		case kCC3FrameEventAnimationTime:
+		case kCC3FrameEventEmitting:
+		case kCC3FrameEventEmissionInterval:
+			return 1;
+		default:
+			return 0;
+	}
+}
+
+/** Returns whether the values of the specified event are times, which are held in the log as doubles, instead of as floats. */
+static BOOL CC3FrameEventHasTimeValues(CC3FrameEvent event) {
+	return (event == kCC3FrameEventAnimationTime || event == kCC3FrameEventEmissionInterval);
+}
+
+/** Returns whether the specified event applies to an animation track, which is identified in the log. */
+static BOOL CC3FrameEventHasTrack(CC3FrameEvent event) {
+	return (event == kCC3FrameEventAnimationEnabled ||
+			event == kCC3FrameEventAnimationBlendingWeight ||
+			event == kCC3FrameEventAnimationTime);
+}
+
+
+#pragma mark -
+#pragma mark Little-endian log content
+
+static void CC3FrameLogAppendUInt8(NSMutableData* log, uint8_t value) { [log appendBytes: &value length: sizeof(value)]; }
+
+static void CC3FrameLogAppendUInt16(NSMutableData* log, uint16_t value) {
+	value = CFSwapInt16HostToLittle(value);
+	[log appendBytes: &value length: sizeof(value)];
+}
+
+static void CC3FrameLogAppendUInt32(NSMutableData* log, uint32_t value) {
+	value = CFSwapInt32HostToLittle(value);
+	[log appendBytes: &value length: sizeof(value)];
+}
+
+static void CC3FrameLogAppendUInt64(NSMutableData* log, uint64_t value) {
+	value = CFSwapInt64HostToLittle(value);
+	[log appendBytes: &value length: sizeof(value)];
+}
+
+static void CC3FrameLogAppendFloat(NSMutableData* log, float value) {
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	CC3FrameLogAppendUInt32(log, bits);
+}
+
+static void CC3FrameLogAppendDouble(NSMutableData* log, double value) {
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	CC3FrameLogAppendUInt64(log, bits);
+}
+
+/** Appends the specified string, preceded by its length. */
+static void CC3FrameLogAppendString(NSMutableData* log, NSString* str) {
+	const char* utf8 = str ? str.UTF8String : "";
+	size_t len = MIN(strlen(utf8), (size_t)UINT16_MAX);
+	CC3FrameLogAppendUInt16(log, (uint16_t)len);
+	[log appendBytes: utf8 length: len];
+}
+
+/** Reads content from a log, tracking the position, and refusing to read beyond the end of the log. */
+typedef struct {
+	const uint8_t* bytes;		/**< The content of the log. */
+	NSUInteger length;			/**< The length of the log. */
+	NSUInteger position;		/**< The position of the next content to read. */
+} CC3FrameLogReader;
+
+static BOOL CC3FrameLogRead(CC3FrameLogReader* reader, void* value, NSUInteger length) {
+	if (reader->position + length > reader->length) return NO;
+	memcpy(value, reader->bytes + reader->position, length);
+	reader->position += length;
+	return YES;
+}
+
+static BOOL CC3FrameLogReadUInt8(CC3FrameLogReader* reader, uint8_t* value) {
+	return CC3FrameLogRead(reader, value, sizeof(*value));
+}
+
+static BOOL CC3FrameLogReadUInt16(CC3FrameLogReader* reader, uint16_t* value) {
+	if ( !CC3FrameLogRead(reader, value, sizeof(*value)) ) return NO;
+	*value = CFSwapInt16LittleToHost(*value);
+	return YES;
+}
+
+static BOOL CC3FrameLogReadUInt32(CC3FrameLogReader* reader, uint32_t* value) {
+	if ( !CC3FrameLogRead(reader, value, sizeof(*value)) ) return NO;
+	*value = CFSwapInt32LittleToHost(*value);
+	return YES;
+}
+
+static BOOL CC3FrameLogReadUInt64(CC3FrameLogReader* reader, uint64_t* value) {
+	if ( !CC3FrameLogRead(reader, value, sizeof(*value)) ) return NO;
+	*value = CFSwapInt64LittleToHost(*value);
+	return YES;
+}
+
+static BOOL CC3FrameLogReadFloat(CC3FrameLogReader* reader, float* value) {
+	uint32_t bits;
+	if ( !CC3FrameLogReadUInt32(reader, &bits) ) return NO;
+	memcpy(value, &bits, sizeof(bits));
+	return YES;
+}
+
+static BOOL CC3FrameLogReadDouble(CC3FrameLogReader* reader, double* value) {
+	uint64_t bits;
+	if ( !CC3FrameLogReadUInt64(reader, &bits) ) return NO;
+	memcpy(value, &bits, sizeof(bits));
+	return YES;
+}
+
+/** Reads a string that is preceded by its length. Returns nil if the log ends before the string does. */
+static NSString* CC3FrameLogReadString(CC3FrameLogReader* reader) {
+	uint16_t len;
+	if ( !CC3FrameLogReadUInt16(reader, &len) ) return nil;
+	if (reader->position + len > reader->length) return nil;
+	NSString* str = [[[NSString alloc] initWithBytes: reader->bytes + reader->position
+											  length: len
+											encoding: NSUTF8StringEncoding] autorelease];
+	reader->position += len;
+	return str;
+}
+
+
+#pragma mark -
+#pragma mark CC3FrameRecorder
+
+volatile BOOL CC3FrameRecordingIsActive = NO;
+
+static CC3FrameRecorder* _activeRecorder = nil;
+
+/**
+ * Reseeds the random stream of each particle emitter within the specified node structure from
+ * CC3RandomUInt, visiting the nodes in the order of their children. When invoked immediately after
+ * CC3RandomUInt is seeded, each emitter is given the same seed during recording and replay, even
+ * though the emitters were created, and first seeded, before recording started.
+ */
+static void CC3FrameReseedParticleEmitters(CC3Node* node) {
+	if ( [node isKindOfClass: [CC3ParticleEmitter class]] ) [(CC3ParticleEmitter*)node reseedRandomStream];
+	for (CC3Node* child in node.children) CC3FrameReseedParticleEmitters(child);
+}
+
+@interface CC3FrameRecorder (TemplateMethods)
+-(void) recordEvent: (CC3FrameEvent) event forNode: (CC3Node*) node onTrack: (GLuint) trackID withValues: (const double*) values;
+@end
+
+void CC3FrameRecordEvent(CC3FrameEvent event, CC3Node* node, GLuint trackID, const double* values) {
+	if ( ![NSThread isMainThread] ) return;		// Only changes made on the main thread are recorded
+	[_activeRecorder recordEvent: event forNode: node onTrack: trackID withValues: values];
+}
+
+@implementation CC3FrameRecorder
+
+@synthesize scene=_scene, randomSeed=_randomSeed, isRecording=_isRecording;
+@synthesize frameCount=_frameCount, eventCount=_eventCount;
+
+-(void) dealloc {
+	[_scene release];
+	[_log release];
+	[_targetIndices release];
+	[_targetNodes release];
+	[_targetNames release];
+	[_nodeTargetIndices release];
+	[super dealloc];
+}
+
+-(NSData*) log { return _log; }
+
+-(void) start {
+	[_activeRecorder stop];
+
+	[_log setLength: 0];
+	[_targetIndices removeAllObjects];
+	[_targetNodes removeAllObjects];
+	[_targetNames removeAllObjects];
+	[_nodeTargetIndices removeAllObjects];
+	_frameCount = 0;
+	_eventCount = 0;
+
+	CC3FrameLogAppendUInt32(_log, kCC3FrameRecordingMagic);
+	CC3FrameLogAppendUInt32(_log, kCC3FrameRecordingVersion);
+	CC3FrameLogAppendUInt64(_log, _randomSeed);
+	CC3RandomSeed(_randomSeed);
+	CC3FrameReseedParticleEmitters(_scene);
+
+	_activeRecorder = [self retain];		// Released when recording stops
+	_isRecording = YES;
+	CC3FrameRecordingIsActive = YES;
+	LogInfo(@"%@ started recording with random seed %llu", self, (unsigned long long)_randomSeed);
+}
+
+-(void) stop {
+	if ( !_isRecording ) return;
+
+	CC3FrameRecordingIsActive = NO;
+	_isRecording = NO;
+	if (_activeRecorder == self) {
+		_activeRecorder = nil;
+		[self autorelease];
+	}
+	LogInfo(@"%@ stopped recording after %u frames and %u events in %lu bytes",
+			self, _frameCount, _eventCount, (unsigned long)_log.length);
+}
+
+-(BOOL) writeToFile: (NSString*) filePath {
+	if ( ![_log writeToFile: filePath atomically: YES] ) {
+		LogError(@"%@ could not write frame recording to %@", self, filePath);
+		return NO;
+	}
+	return YES;
+}
+
++(CC3FrameRecorder*) activeRecorder { return _activeRecorder; }
+
+/**
+ * Returns the path to the specified node from the scene, as the index of each node within
+ * the children of its parent, separated by slashes. Returns nil if the node is not in the scene.
+ */
+-(NSString*) pathToNode: (CC3Node*) node {
+	NSMutableString* path = [NSMutableString string];
+	while (node.parent) {
+		CC3Node* parent = node.parent;
+		NSUInteger childIdx = [parent.children indexOfObjectIdenticalTo: node];
+		if (childIdx == NSNotFound) return nil;
+		[path insertString: [NSString stringWithFormat: (path.length ? @"%lu/" : @"%lu"), (unsigned long)childIdx]
+				   atIndex: 0];
+		node = parent;
+	}
+	return (node == _scene) ? path : nil;
+}
+
+/** Returns whether the specified index was last defined in the log with the specified node and name. */
+-(BOOL) isTargetIndex: (NSUInteger) tgtIdx definedForNode: (NSValue*) nodeID withName: (NSString*) name {
+	return ([[_targetNodes objectAtIndex: tgtIdx] isEqualToValue: nodeID] &&
+			[[_targetNames objectAtIndex: tgtIdx] isEqualToString: name]);
+}
+
+/**
+ * Returns the index that identifies the specified node in the log, defining the index in the log
+ * the first time the node is encountered. Returns NSNotFound if the node is not in the scene.
+ *
+ * Each index identifies a path within the scene. If the node at a known path is not the node,
+ * or does not have the name, that the index was last defined with, a different node has replaced
+ * it, and the index is defined again in the log, so that the replay verifies the new node.
+ * Nodes are not retained, so the identity of a node is only compared, and never dereferenced.
+ *
+ * The index is remembered for the node, so that the path to the node is only built the first
+ * time the node is encountered after the structure of the scene changes.
+ */
+-(NSUInteger) targetIndexOfNode: (CC3Node*) node {
+	NSString* name = node.name ? node.name : @"";
+	NSValue* nodeID = [NSValue valueWithNonretainedObject: node];
+	NSNumber* tgtIdxNum = [_nodeTargetIndices objectForKey: nodeID];
+	NSUInteger tgtIdx;
+	if (tgtIdxNum) {
+		tgtIdx = tgtIdxNum.unsignedIntegerValue;
+		if ( [self isTargetIndex: tgtIdx definedForNode: nodeID withName: name] ) return tgtIdx;
+	}
+
+	NSString* path = [self pathToNode: node];
+	if ( !path ) return NSNotFound;
+
+	tgtIdxNum = [_targetIndices objectForKey: path];
+	if (tgtIdxNum) {
+		tgtIdx = tgtIdxNum.unsignedIntegerValue;
+		if ( [self isTargetIndex: tgtIdx definedForNode: nodeID withName: name] ) {
+			[_nodeTargetIndices setObject: tgtIdxNum forKey: nodeID];
+			return tgtIdx;
+		}
+
+		[_targetNodes replaceObjectAtIndex: tgtIdx withObject: nodeID];
+		[_targetNames replaceObjectAtIndex: tgtIdx withObject: name];
+	} else {
+		tgtIdx = _targetIndices.count;
+		if (tgtIdx > UINT16_MAX) {
+			LogError(@"%@ cannot record changes to more than %u distinct nodes", self, UINT16_MAX + 1);
+			return NSNotFound;
+		}
+		tgtIdxNum = [NSNumber numberWithUnsignedInteger: tgtIdx];
+		[_targetIndices setObject: tgtIdxNum forKey: path];
+		[_targetNodes addObject: nodeID];
+		[_targetNames addObject: name];
+	}
+	[_nodeTargetIndices setObject: tgtIdxNum forKey: nodeID];
+
+	CC3FrameLogAppendUInt8(_log, kCC3FrameRecordTarget);
+	CC3FrameLogAppendUInt16(_log, (uint16_t)tgtIdx);
+	CC3FrameLogAppendString(_log, path);
+	CC3FrameLogAppendString(_log, name);
+	return tgtIdx;
+}
+
+-(void) recordEvent: (CC3FrameEvent) event forNode: (CC3Node*) node onTrack: (GLuint) trackID withValues: (const double*) values {
+	if ( !_isRecording ) return;
+
+	NSUInteger tgtIdx = [self targetIndexOfNode: node];
+	if (tgtIdx == NSNotFound) return;
+
+	CC3FrameLogAppendUInt8(_log, event);
+	CC3FrameLogAppendUInt16(_log, (uint16_t)tgtIdx);
+	if (CC3FrameEventHasTrack(event)) CC3FrameLogAppendUInt32(_log, trackID);
+
+	GLuint valCnt = CC3FrameEventValueCount(event);
+	BOOL isTime = CC3FrameEventHasTimeValues(event);
+	for (GLuint vIdx = 0; vIdx < valCnt; vIdx++) {
+		if (isTime)
+			CC3FrameLogAppendDouble(_log, values[vIdx]);
+		else
+			CC3FrameLogAppendFloat(_log, (float)values[vIdx]);
+	}
+	_eventCount++;
+}
+
+-(BOOL) recordUpdateOfScene: (CC3Scene*) scene forInterval: (CCTime) dt {
+	if ( !_isRecording || scene != _scene ) return NO;
+
+	CC3FrameLogAppendUInt8(_log, kCC3FrameRecordUpdate);
+	CC3FrameLogAppendDouble(_log, dt);
+	CC3FrameLogAppendUInt64(_log, CC3RandomGetState());
+	_frameCount++;
+
+	// Changes made during the update are derived from the recorded changes, so don't record them
+	CC3FrameRecordingIsActive = NO;
+	[scene updateScene: dt];
+	CC3FrameRecordingIsActive = (_activeRecorder != nil);
+
+	return YES;
+}
+
+-(void) structureDidChangeInScene: (CC3Scene*) scene {
+	if (scene == _scene) [_nodeTargetIndices removeAllObjects];
+}
+
+
+#pragma mark Allocation and initialization
+
+-(id) init { return [self initWithScene: nil]; }
+
+-(id) initWithScene: (CC3Scene*) scene {
+	CC3Assert(scene, @"%@ must be created with a scene to record", [self class]);
+	if ( (self = [super init]) ) {
+		_scene = [scene retain];
+		_log = [NSMutableData new];					// retained
+		_targetIndices = [NSMutableDictionary new];	// retained
+		_targetNodes = [NSMutableArray new];		// retained
+		_targetNames = [NSMutableArray new];		// retained
+		_nodeTargetIndices = [NSMutableDictionary new];	// retained
+		_randomSeed = ((uint64_t)arc4random() << 32) | arc4random();
+		_frameCount = 0;
+		_eventCount = 0;
+		_isRecording = NO;
+	}
+	return self;
+}
+
++(id) recorderWithScene: (CC3Scene*) scene { return [[[self alloc] initWithScene: scene] autorelease]; }
+
+-(NSString*) description { return [NSString stringWithFormat: @"%@ for %@", [self class], _scene]; }
+
+@end
+
+
+#pragma mark -
+#pragma mark CC3FrameReplayer
+
+@implementation CC3FrameReplayer
+
+@synthesize scene=_scene, randomSeed=_randomSeed, frameIndex=_frameIndex;
+@synthesize unresolvedEventCount=_unresolvedEventCount;
+
+-(void) dealloc {
+	[_scene release];
+	[_log release];
+	[_targetPaths release];
+	[_targetNames release];
+	[super dealloc];
+}
+
+-(BOOL) isFinished { return _position >= _log.length; }
+
+-(void) reset {
+	[_targetPaths removeAllObjects];
+	[_targetNames removeAllObjects];
+	_position = kCC3FrameRecordingHeaderLength;
+	_frameIndex = 0;
+	_unresolvedEventCount = 0;
+	CC3RandomSeed(_randomSeed);
+	CC3FrameReseedParticleEmitters(_scene);
+}
+
+/** Returns the node at the specified path of child indices from the scene, or nil if there is no such node. */
+-(CC3Node*) nodeAtPath: (NSArray*) path {
+	CC3Node* node = _scene;
+	for (NSNumber* childIdx in path) {
+		NSArray* children = node.children;
+		NSUInteger ci = childIdx.unsignedIntegerValue;
+		if (ci >= children.count) return nil;
+		node = [children objectAtIndex: ci];
+	}
+	return node;
+}
+
+/** Reads the definition of the index used to identify a node in subsequent events. */
+-(BOOL) readTarget: (CC3FrameLogReader*) reader {
+	uint16_t tgtIdx;
+	if ( !CC3FrameLogReadUInt16(reader, &tgtIdx) ) return NO;
+	NSString* pathStr = CC3FrameLogReadString(reader);
+	NSString* name = CC3FrameLogReadString(reader);
+	if ( !pathStr || !name ) return NO;
+
+	NSMutableArray* path = [NSMutableArray array];
+	if (pathStr.length)
+		for (NSString* idxStr in [pathStr componentsSeparatedByString: @"/"])
+			[path addObject: [NSNumber numberWithInteger: idxStr.integerValue]];
+
+	// Indices are defined in order, but guard against a malformed log
+	while (_targetPaths.count <= tgtIdx) {
+		[_targetPaths addObject: [NSNull null]];
+		[_targetNames addObject: [NSNull null]];
+	}
+	[_targetPaths replaceObjectAtIndex: tgtIdx withObject: path];
+	[_targetNames replaceObjectAtIndex: tgtIdx withObject: name];
+	return YES;
+}
+
+/** Applies the specified event to the specified node, and returns whether the event could be applied. */
+-(BOOL) applyEvent: (CC3FrameEvent) event toNode: (CC3Node*) node onTrack: (GLuint) trackID withValues: (const double*) v {
+	CC3Vector vec = cc3v(v[0], v[1], v[2]);
+	CC3Quaternion quat = CC3QuaternionMake(v[0], v[1], v[2], v[3]);
+	switch (event) {
+		case kCC3FrameEventLocation: node.location = vec; return YES;
+		case kCC3FrameEventRotation: node.rotation = vec; return YES;
+		case kCC3FrameEventRotateBy: [node rotateBy: vec]; return YES;
+		case kCC3FrameEventQuaternion: node.quaternion = quat; return YES;
+		case kCC3FrameEventRotateByQuaternion: [node rotateByQuaternion: quat]; return YES;
+		case kCC3FrameEventRotationAxis: node.rotationAxis = vec; return YES;
+		case kCC3FrameEventRotationAngle: node.rotationAngle = v[0]; return YES;
+		case kCC3FrameEventRotateByAngleAroundAxis: [node rotateByAngle: v[0] aroundAxis: cc3v(v[1], v[2], v[3])]; return YES;
+		case kCC3FrameEventForwardDirection: node.forwardDirection = vec; return YES;
+		case kCC3FrameEventTargetLocation: node.targetLocation = vec; return YES;
+		case kCC3FrameEventScale: node.scale = vec; return YES;
+		default: break;
+	}
+
+	if (CC3FrameEventHasTrack(event)) {
+		CC3NodeAnimationState* animState = [node getAnimationStateOnTrack: trackID];
+		if ( !animState ) return NO;
+		switch (event) {
+			case kCC3FrameEventAnimationEnabled: animState.isEnabled = (v[0] != 0.0); return YES;
+			case kCC3FrameEventAnimationBlendingWeight: animState.blendingWeight = v[0]; return YES;
+			case kCC3FrameEventAnimationTime: [animState establishFrameAt: v[0]]; return YES;
+			default: return NO;
+		}
+	}
+
+	if ( ![node isKindOfClass: [CC3ParticleEmitter class]] ) return NO;
+	CC3ParticleEmitter* emitter = (CC3ParticleEmitter*)node;
+	switch (event) {
+		case kCC3FrameEventEmitting: emitter.isEmitting = (v[0] != 0.0); return YES;
+		case kCC3FrameEventEmissionInterval: emitter.emissionInterval = v[0]; return YES;
+		case kCC3FrameEventEmitParticle: [emitter emitParticle]; return YES;
+		case kCC3FrameEventStopEmitting: [emitter stop]; return YES;
+		default: return NO;
+	}
+}
+
+/** Reads the specified event, and applies it to the node it identifies. */
+-(BOOL) readEvent: (CC3FrameEvent) event fromReader: (CC3FrameLogReader*) reader {
+	uint16_t tgtIdx;
+	uint32_t trackID = 0;
+	double values[4] = { 0.0, 0.0, 0.0, 0.0 };
+	if ( !CC3FrameLogReadUInt16(reader, &tgtIdx) ) return NO;
+	if (CC3FrameEventHasTrack(event) && !CC3FrameLogReadUInt32(reader, &trackID) ) return NO;
+
+	GLuint valCnt = CC3FrameEventValueCount(event);
+	BOOL isTime = CC3FrameEventHasTimeValues(event);
+	for (GLuint vIdx = 0; vIdx < valCnt; vIdx++) {
+		if (isTime) {
+			if ( !CC3FrameLogReadDouble(reader, &values[vIdx]) ) return NO;
+		} else {
+			float fVal;
+			if ( !CC3FrameLogReadFloat(reader, &fVal) ) return NO;
+			values[vIdx] = fVal;
+		}
+	}
+
+	NSArray* path = (tgtIdx < _targetPaths.count) ? [_targetPaths objectAtIndex: tgtIdx] : nil;
+	NSString* name = (tgtIdx < _targetNames.count) ? [_targetNames objectAtIndex: tgtIdx] : nil;
+	CC3Node* node = [path isKindOfClass: [NSArray class]] ? [self nodeAtPath: path] : nil;
+	NSString* nodeName = node.name ? node.name : @"";
+	if (node && [nodeName isEqualToString: name] && [self applyEvent: event toNode: node onTrack: trackID withValues: values])
+		return YES;
+
+	LogErrorIf(_unresolvedEventCount == 0,
+			   @"%@ could not replay %@ event for node %@ in frame %u. The replayed scene has diverged from the recording.",
+			   self, NSStringFromCC3FrameEvent(event), name, _frameIndex);
+	_unresolvedEventCount++;
+	return YES;
+}
+
+-(BOOL) replayNextFrame {
+	CC3FrameLogReader reader = { _log.bytes, _log.length, _position };
+	uint8_t recType;
+	while (CC3FrameLogReadUInt8(&reader, &recType)) {
+		BOOL wasRead;
+		switch (recType) {
+			case kCC3FrameRecordUpdate: {
+				double dt;
+				uint64_t randState;
+				if ( !CC3FrameLogReadDouble(&reader, &dt) || !CC3FrameLogReadUInt64(&reader, &randState) ) {
+					wasRead = NO;
+					break;
+				}
+				_position = reader.position;
+				CC3RandomSetState(randState);
+				[_scene updateScene: dt];
+				_frameIndex++;
+				return YES;
+			}
+			case kCC3FrameRecordTarget:
+				wasRead = [self readTarget: &reader];
+				break;
+			default:
+				wasRead = (recType > kCC3FrameEventNone && recType < kCC3FrameEventCount &&
+						   [self readEvent: recType fromReader: &reader]);
+				break;
+		}
+		if ( !wasRead ) {
+			LogError(@"%@ encountered a malformed record at position %lu of the recording", self, (unsigned long)_position);
+			break;
+		}
+		_position = reader.position;
+	}
+	_position = _log.length;
+	return NO;
+}
+
+-(GLuint) replayToFrame: (GLuint) frameIndex {
+	GLuint startIdx = _frameIndex;
+	while (_frameIndex < frameIndex && [self replayNextFrame]) {}
+	return _frameIndex - startIdx;
+}
+
+-(GLuint) replayAll { return [self replayToFrame: UINT32_MAX]; }
+
+
+#pragma mark Allocation and initialization
+
+-(id) init { return [self initWithLog: nil forScene: nil]; }
+
+-(id) initWithLog: (NSData*) log forScene: (CC3Scene*) scene {
+	CC3Assert(scene, @"%@ must be created with a scene to replay into", [self class]);
+	if ( (self = [super init]) ) {
+		CC3FrameLogReader reader = { log.bytes, log.length, 0 };
+		uint32_t magic = 0, version = 0;
+		uint64_t seed = 0;
+		if ( !(CC3FrameLogReadUInt32(&reader, &magic) && magic == kCC3FrameRecordingMagic &&
+			   CC3FrameLogReadUInt32(&reader, &version) && CC3FrameLogReadUInt64(&reader, &seed)) ) {
+			LogError(@"%@ cannot replay content that is not a frame recording", [self class]);
+			[self release];
+			return nil;
+		}
+		if (version != kCC3FrameRecordingVersion) {
+			LogError(@"%@ cannot replay a frame recording of version %u", [self class], version);
+			[self release];
+			return nil;
+		}
+		_scene = [scene retain];
+		_log = [log retain];
+		_targetPaths = [NSMutableArray new];		// retained
+		_targetNames = [NSMutableArray new];		// retained
+		_randomSeed = seed;
+		[self reset];
+	}
+	return self;
+}
+
++(id) replayerWithFile: (NSString*) filePath forScene: (CC3Scene*) scene {
+	NSData* log = [NSData dataWithContentsOfFile: filePath];
+	if ( !log ) {
+		LogError(@"%@ could not load frame recording from %@", self, filePath);
+		return nil;
+	}
+	return [[[self alloc] initWithLog: log forScene: scene] autorelease];
+}
+
+-(NSString*) description { return [NSString stringWithFormat: @"%@ for %@", [self class], _scene]; }
+
+@end
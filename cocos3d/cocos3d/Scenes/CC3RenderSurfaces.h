@@ -1848,13 +1848,37 @@
 /** Initializes this instance for the specified view. */
 -(instancetype) initFromView: (CCGLView*) view;
 
+/**
+ * Initializes this instance with an off-screen view surface of the specified size, holding
+ * color and depth renderbuffers of the specified formats, instead of the surface of a CCGLView.
+ *
+ * The depthFormat may be GL_ZERO, in which case no depth buffer is attached to the surface.
+ *
+ * This is useful for headless runs, such as automated benchmarks, that render a CC3Scene
+ * without an OS view. To have Cocos3D render to the surface of the new instance, install it
+ * using the setSharedViewSurfaceManager: method.
+ */
+-(instancetype) initWithSize: (CC3IntSize) size
+			 withColorFormat: (GLenum) colorFormat
+			  andDepthFormat: (GLenum) depthFormat;
+
 /**
  * Returns a singleton instance.
  *
- * This method must be invoked after the view has been established in the CCDirector.
+ * This method must be invoked after the view has been established in the CCDirector,
+ * unless a singleton instance has been installed using the setSharedViewSurfaceManager: method.
  */
 +(CC3ViewSurfaceManager*) sharedViewSurfaceManager;
 
+/**
+ * Sets the singleton instance, in place of the instance that is otherwise created lazily
+ * from the view in the CCDirector.
+ *
+ * Typically, this is used to install an instance created with the
+ * initWithSize:withColorFormat:andDepthFormat: method for headless rendering.
+ */
++(void) setSharedViewSurfaceManager: (CC3ViewSurfaceManager*) surfaceManager;
+
 @end
 
 
@@ -857,6 +857,9 @@
 	GLuint facesToGenerate = self.facesToGenerate;
 	if ( !facesToGenerate ) return;
 	
+	CC3PerformanceStatistics* perfStats = scene.performanceStatistics;
+	[perfStats beginPhase: kCC3PerformancePhaseEnvironmentMapSnapshot];
+
 	// Get the scene and the cube-map visitor, and set the render surface to that of this texture.
 	CC3NodeDrawingVisitor* envMapVisitor = scene.envMapDrawingVisitor;
 	envMapVisitor.renderSurface = self.renderSurface;
@@ -894,6 +897,8 @@
 
 //		[self paintFace];		// Uncomment to identify the faces
 	}
+
+	[perfStats endPhase: kCC3PerformancePhaseEnvironmentMapSnapshot];
 }
 
 /** 
@@ -1415,6 +1420,20 @@
     return self;
 }
 
+-(instancetype) initWithSize: (CC3IntSize) size
+			 withColorFormat: (GLenum) colorFormat
+			  andDepthFormat: (GLenum) depthFormat {
+    if ( (self = [super init]) ) {
+		CC3GLFramebuffer* vSurf = [CC3GLFramebuffer surface];
+		vSurf.name = @"Off-screen display surface";
+		vSurf.colorAttachment = [CC3GLRenderbuffer renderbufferWithPixelFormat: colorFormat];
+		if (depthFormat) vSurf.depthAttachment = [CC3GLRenderbuffer renderbufferWithPixelFormat: depthFormat];
+		self.viewSurface = vSurf;
+		self.size = size;			// Resize after the surface has been added
+	}
+    return self;
+}
+
 static CC3ViewSurfaceManager* _sharedViewSurfaceManager = nil;
 
 +(CC3ViewSurfaceManager*) sharedViewSurfaceManager {
@@ -1427,6 +1446,12 @@ static CC3ViewSurfaceManager* _sharedViewSurfaceManager = nil;
 	return _sharedViewSurfaceManager;
 }
 
++(void) setSharedViewSurfaceManager: (CC3ViewSurfaceManager*) surfaceManager {
+	if (surfaceManager == _sharedViewSurfaceManager) return;
+	[_sharedViewSurfaceManager release];
+	_sharedViewSurfaceManager = [surfaceManager retain];
+}
+
 @end
 
 
@@ -231,6 +231,7 @@ static const ccColor4F kCC3DefaultLightColorAmbientScene = { 0.2f, 0.2f, 0.2f, 1
 	NSMutableArray* _lights;
 	NSMutableArray* _lightProbes;
 	NSMutableArray* _billboards;
+	NSMutableArray* _shadowsToUpdate;
 	CC3Layer* _cc3Layer;
 	CC3Camera* _activeCamera;
 	CC3NodeSequencer* _drawingSequencer;
@@ -1100,6 +1101,25 @@ static const ccColor4F kCC3DefaultLightColorAmbientScene = { 0.2f, 0.2f, 0.2f, 1
 @property(nonatomic, assign) BOOL shouldDisplayPickingRender;
 
 
+#pragma mark Memory reporting
+
+/**
+ * Returns a report of the memory held by this scene, and by the resources, textures and
+ * shader programs that have been loaded, as a dictionary that can be serialized to JSON
+ * using NSJSONSerialization.
+ *
+ * The report contains the memoryFootprint of this scene, under the "scene" key, and an array
+ * containing the memoryFootprint of each of the resource, texture and shader program caches,
+ * under the "caches" key. The caches are global, and may hold content that is not used by this
+ * scene, and content that is used by this scene may appear both in the scene and in the caches.
+ *
+ * This method traverses the entire scene and each of the caches, and is intended for
+ * development-time reporting, such as tracking memory budgets, and detecting leaks in
+ * automated tests.
+ */
+-(NSDictionary*) memoryReport;
+
+
 #pragma mark Deprecated
 
 /**
@@ -37,6 +37,9 @@
 #import "CC3EnvironmentNodes.h"
 #import "CC3Billboard.h"
 #import "CC3ShadowVolumes.h"
+#import "CC3Resource.h"
+#import "CC3Shaders.h"
+#import "CC3FrameRecording.h"
 #import "CC3AffineMatrix.h"
 #import "CC3CC2Extensions.h"
 #import "CGPointExtension.h"
@@ -95,6 +98,7 @@
 	_lightProbes = nil;						// Make nil so won't be referenced during parent dealloc
 	[_billboards release];
 	_billboards = nil;						// Make nil so won't be referenced during parent dealloc
+	[_shadowsToUpdate release];
 	
 	[super dealloc];
 }
@@ -213,6 +217,7 @@
 		_lights = [NSMutableArray new];			// retained
 		_lightProbes = [NSMutableArray new];	// retained
 		_billboards = [NSMutableArray new];		// retained
+		_shadowsToUpdate = [NSMutableArray new];	// retained
 		self.drawingSequenceVisitor = [CC3NodeSequencerVisitor visitorWithScene: self];
 		self.drawingSequencer = [CC3BTreeNodeSequencer sequencerLocalContentOpaqueFirst];
 		self.viewDrawingVisitor = [[self viewDrawVisitorClass] visitor];
@@ -312,10 +317,17 @@
  * Does nothing except update times if this instance is not running.
  */
 -(void) updateScene: (CCTime) dt {
+#if CC3_FRAME_RECORDING_ENABLED
+	// If recording, record the update, and perform it with recording suspended
+	if (CC3FrameRecordingIsActive && [CC3FrameRecorder.activeRecorder recordUpdateOfScene: self forInterval: dt]) return;
+#endif
+
 	[self updateTimes: dt];
 
 	if( !self.isRunning) return;
 
+	[_performanceStatistics beginPhase: kCC3PerformancePhaseUpdateScene];
+
 	// Clamp the specified interval to a range defined by the minimum and maximum
 	// update intervals. If the maximum update interval limit is zero or negative,
 	// its value is ignored, and the dt value is not limited to a maximum value.
@@ -328,13 +340,28 @@
 	[_touchedNodePicker dispatchPickedNode];
 	
 	_updateVisitor.deltaTime = _deltaFrameTime;
+	[_performanceStatistics beginPhase: kCC3PerformancePhaseUpdateNodes];
 	[_updateVisitor visit: self];
+	[_performanceStatistics endPhase: kCC3PerformancePhaseUpdateNodes];
 	
+	[_performanceStatistics beginPhase: kCC3PerformancePhaseUpdateCamera];
 	[self updateCamera: _deltaFrameTime];
+	[_performanceStatistics endPhase: kCC3PerformancePhaseUpdateCamera];
+
+	[_performanceStatistics beginPhase: kCC3PerformancePhaseUpdateBillboards];
 	[self updateBillboards: _deltaFrameTime];
+	[_performanceStatistics endPhase: kCC3PerformancePhaseUpdateBillboards];
+
+	[_performanceStatistics beginPhase: kCC3PerformancePhaseUpdateShadows];
 	[self updateShadows: _deltaFrameTime];
+	[_performanceStatistics endPhase: kCC3PerformancePhaseUpdateShadows];
+
+	[_performanceStatistics beginPhase: kCC3PerformancePhaseUpdateDrawSequence];
 	[self updateDrawSequence];
+	[_performanceStatistics endPhase: kCC3PerformancePhaseUpdateDrawSequence];
 	
+	[_performanceStatistics endPhase: kCC3PerformancePhaseUpdateScene];
+
 	LogTrace(@"******* %@ exiting update", self);
 }
 
@@ -349,13 +376,26 @@
 -(void) updateTimes: (CCTime) dt {
 	_elapsedTimeSinceOpened = NSDate.timeIntervalSinceReferenceDate - _timeAtOpen;
 	[_performanceStatistics addUpdateTime: dt];
+	if (_performanceStatistics) [CC3Backgrounder.sharedBackgrounder collectStatisticsInto: _performanceStatistics];
 }
 
 /** Template method to update the camera. */
 -(void) updateCamera: (CCTime) dt {}
 
-/** Template method to update shadows cast by the lights. */
--(void) updateShadows: (CCTime) dt { for (CC3Light* lgt in _lights) [lgt updateShadows]; }
+/**
+ * Template method to update shadows cast by the lights.
+ *
+ * The shadows of all lights are updated together, so that the shadow volumes
+ * of all lights that need rebuilding can be built concurrently.
+ */
+-(void) updateShadows: (CCTime) dt {
+	for (CC3Light* lgt in _lights)
+		if (lgt.hasShadows) [_shadowsToUpdate addObjectsFromArray: lgt.shadows];
+	if (_shadowsToUpdate.count == 0) return;
+
+	[CC3ShadowVolumeMeshNode updateShadows: _shadowsToUpdate withStatistics: _performanceStatistics];
+	[_shadowsToUpdate removeAllObjects];	// Reused on each update, to avoid allocating each frame
+}
 
 /**
  * Template method to update any billboards.
@@ -390,6 +430,8 @@
 	
 	[self collectFrameInterval];	// Collect the frame interval in the performance statistics.
 
+	[_performanceStatistics beginPhase: kCC3PerformancePhaseDrawScene];
+
 	[self open3DWithVisitor: visitor];
 	
 	[_touchedNodePicker pickTouchedNodeWithVisitor: visitor];
@@ -399,20 +441,26 @@
 	[self close3DWithVisitor: visitor];
 	[self draw2DBillboardsWithVisitor: visitor];	// Back to 2D now
 
+	[_performanceStatistics endPhase: kCC3PerformancePhaseDrawScene];
+
 	// Check and clear any GL error that occurred during 3D code
 	LogGLErrorState(@"after drawing %@", self);
 	LogTrace(@"******* %@ exiting drawing visit", self);
 }
 
 -(void) drawSceneContentWithVisitor: (CC3NodeDrawingVisitor*) visitor {
+	[_performanceStatistics beginPhase: kCC3PerformancePhaseDrawNodes];
 	[self illuminateWithVisitor: visitor];		// Light up your world!
 	[self drawBackdropWithVisitor: visitor];	// Draw the backdrop if it exists
 
 	[visitor visit: self];						// Draw the scene components
+	[_performanceStatistics endPhase: kCC3PerformancePhaseDrawNodes];
 	
 	// Shadows are drawn with a specialized visitor
+	[_performanceStatistics beginPhase: kCC3PerformancePhaseDrawShadows];
 	[_shadowVisitor alignShotWith: visitor];
 	[self drawShadowsWithVisitor: _shadowVisitor];
+	[_performanceStatistics endPhase: kCC3PerformancePhaseDrawShadows];
 }
 
 -(void) drawSceneContentForEnvironmentMapWithVisitor: (CC3NodeDrawingVisitor*) visitor {
@@ -623,6 +671,11 @@
  */
 -(void) didAddDescendant: (CC3Node*) aNode {
 	LogTrace(@"Adding %@ as descendant to %@", aNode, self);
+
+#if CC3_FRAME_RECORDING_ENABLED
+	// The paths to nodes may have changed, so the recorder must rebuild them
+	[CC3FrameRecorder.activeRecorder structureDidChangeInScene: self];
+#endif
 	
 	// Collect all the nodes being added, including all descendants,
 	// and see if they require special treatment
@@ -657,6 +710,11 @@
  */
 -(void) didRemoveDescendant: (CC3Node*) aNode {
 	LogTrace(@"Removing %@ as descendant of %@", aNode, self);
+
+#if CC3_FRAME_RECORDING_ENABLED
+	// The paths to nodes may have changed, so the recorder must rebuild them
+	[CC3FrameRecorder.activeRecorder structureDidChangeInScene: self];
+#endif
 	
 	// Collect all the nodes being removed, including all descendants,
 	// and see if they require special treatment
@@ -722,6 +780,16 @@
 -(Class) pickVisitorClass { return [CC3NodePickingVisitor class]; }
 
 
+#pragma mark Memory reporting
+
+-(NSDictionary*) memoryReport {
+	NSArray* caches = [NSArray arrayWithObjects: CC3Resource.resourceCache.memoryFootprint,
+											   CC3Texture.textureCache.memoryFootprint,
+											   CC3ShaderProgram.programCache.memoryFootprint, nil];
+	return [NSDictionary dictionaryWithObjectsAndKeys: self.memoryFootprint, @"scene", caches, @"caches", nil];
+}
+
+
 #pragma mark Deprecated
 
 -(CC3ViewSurfaceManager*) viewSurfaceManager { return CC3ViewSurfaceManager.sharedViewSurfaceManager; }
@@ -830,6 +830,12 @@ NSString* NSStringFromCC3GLSLVariableScope(CC3GLSLVariableScope scope);
 /** Returns a string description of the current value of this uniform. */
 -(NSString*) valueDescription;
 
+/**
+ * Returns the number of bytes of application memory occupied by the value of this uniform,
+ * including the copy of the value most recently set in the GL engine.
+ */
+@property(nonatomic, readonly) NSUInteger applicationMemoryBytes;
+
 #pragma mark Updating the GL engine
 
 
@@ -542,6 +542,8 @@ NSString* NSStringFromCC3GLSLVariableScope(CC3GLSLVariableScope scope) {
 	memcpy(_varValue, uniform.varValue, _varLen);
 }
 
+-(NSUInteger) applicationMemoryBytes { return (_varValue ? _varLen : 0) + (_glVarValue ? _varLen : 0); }
+
 -(NSString*) valueDescription {
 	NSMutableString* desc = [NSMutableString stringWithCapacity: 100];
 	[desc appendString: @"["];
@@ -86,6 +86,11 @@ typedef enum {
 	kCC3SemanticIsDrawingPoints,				/**< (bool) Whether the vertices are being drawn as points. */
 	kCC3SemanticShouldDrawFrontFaces,			/**< (bool) Whether the front side of each face is to be drawn. */
 	kCC3SemanticShouldDrawBackFaces,			/**< (bool) Whether the back side of each face is to be drawn. */
+	kCC3SemanticVertexLocationScale,			/**< (vec3) Scale to apply to quantized vertex locations before the offset. */
+	kCC3SemanticVertexLocationOffset,			/**< (vec3) Offset to add to scaled quantized vertex locations. */
+	kCC3SemanticVertexNormalIsOctahedral,		/**< (bool) Whether vertex normals, tangents and bitangents are octahedral-encoded. */
+	kCC3SemanticVertexTexCoordScale,			/**< (vec2) Scale to apply to the quantized texture coordinates of a texture unit before the offset. */
+	kCC3SemanticVertexTexCoordOffset,			/**< (vec2) Offset to add to the scaled quantized texture coordinates of a texture unit. */
 	
 	// ENVIRONMENT MATRICES --------------
 	kCC3SemanticModelLocalMatrix,				/**< (mat4) Current model-to-parent matrix. */
@@ -71,6 +71,11 @@ NSString* NSStringFromCC3Semantic(CC3Semantic semantic) {
 		case kCC3SemanticIsDrawingPoints: return @"kCC3SemanticIsDrawingPoints";
 		case kCC3SemanticShouldDrawFrontFaces: return @"kCC3SemanticShouldDrawFrontFaces";
 		case kCC3SemanticShouldDrawBackFaces: return @"kCC3SemanticShouldDrawBackFaces";
+		case kCC3SemanticVertexLocationScale: return @"kCC3SemanticVertexLocationScale";
+		case kCC3SemanticVertexLocationOffset: return @"kCC3SemanticVertexLocationOffset";
+		case kCC3SemanticVertexNormalIsOctahedral: return @"kCC3SemanticVertexNormalIsOctahedral";
+		case kCC3SemanticVertexTexCoordScale: return @"kCC3SemanticVertexTexCoordScale";
+		case kCC3SemanticVertexTexCoordOffset: return @"kCC3SemanticVertexTexCoordOffset";
 
 			// ENVIRONMENT MATRICES --------------
 		case kCC3SemanticModelLocalMatrix: return @"kCC3SemanticModelLocalMatrix";
@@ -429,6 +434,29 @@ NSString* NSStringFromCC3Semantic(CC3Semantic semantic) {
 		case kCC3SemanticShouldDrawBackFaces:
 			[uniform setBoolean: !visitor.currentMeshNode.shouldCullBackFaces];
 			return YES;
+		case kCC3SemanticVertexLocationScale:
+			[uniform setVector: (visitor.currentMesh.vertexLocations ? visitor.currentMesh.vertexLocations.quantizationScale : kCC3VectorUnitCube)];
+			return YES;
+		case kCC3SemanticVertexLocationOffset:
+			[uniform setVector: (visitor.currentMesh.vertexLocations ? visitor.currentMesh.vertexLocations.quantizationOffset : kCC3VectorZero)];
+			return YES;
+		case kCC3SemanticVertexNormalIsOctahedral:
+			[uniform setBoolean: (visitor.currentMesh.vertexNormals.quantization == kCC3VertexQuantizationOctahedral)];
+			return YES;
+		case kCC3SemanticVertexTexCoordScale:
+			for (GLuint i = 0; i < uniformSize; i++) {
+				CC3VertexTextureCoordinates* vtc = [visitor.currentMesh textureCoordinatesForTextureUnit: (semanticIndex + i)];
+				CC3Vector tcScale = vtc ? vtc.quantizationScale : kCC3VectorUnitCube;
+				[uniform setPoint: CGPointMake(tcScale.x, tcScale.y) at: i];
+			}
+			return YES;
+		case kCC3SemanticVertexTexCoordOffset:
+			for (GLuint i = 0; i < uniformSize; i++) {
+				CC3VertexTextureCoordinates* vtc = [visitor.currentMesh textureCoordinatesForTextureUnit: (semanticIndex + i)];
+				CC3Vector tcOffset = vtc ? vtc.quantizationOffset : kCC3VectorZero;
+				[uniform setPoint: CGPointMake(tcOffset.x, tcOffset.y) at: i];
+			}
+			return YES;
 
 #pragma mark Setting environment matrix semantics
 		// ENVIRONMENT MATRICES --------------
@@ -1281,6 +1309,11 @@ NSString* NSStringFromCC3Semantic(CC3Semantic semantic) {
 	[self mapVarName: @"u_cc3VertexShouldRescaleNormal" toSemantic: kCC3SemanticShouldRescaleVertexNormal];		/**< (bool) Whether vertex normals should be rescaled. */
 	[self mapVarName: @"u_cc3VertexShouldDrawFrontFaces" toSemantic: kCC3SemanticShouldDrawFrontFaces];			/**< (bool) Whether the front side of each face is to be drawn. */
 	[self mapVarName: @"u_cc3VertexShouldDrawBackFaces" toSemantic: kCC3SemanticShouldDrawBackFaces];			/**< (bool) Whether the back side of each face is to be drawn. */
+	[self mapVarName: @"u_cc3VertexLocationScale" toSemantic: kCC3SemanticVertexLocationScale];				/**< (vec3) Scale to apply to quantized vertex locations before the offset. */
+	[self mapVarName: @"u_cc3VertexLocationOffset" toSemantic: kCC3SemanticVertexLocationOffset];				/**< (vec3) Offset to add to scaled quantized vertex locations. */
+	[self mapVarName: @"u_cc3VertexNormalIsOctahedral" toSemantic: kCC3SemanticVertexNormalIsOctahedral];		/**< (bool) Whether vertex normals, tangents and bitangents are octahedral-encoded. */
+	[self mapVarName: @"u_cc3VertexTexCoordScale" toSemantic: kCC3SemanticVertexTexCoordScale];				/**< (vec2[]) Scale to apply to the quantized texture coordinates of each texture unit. */
+	[self mapVarName: @"u_cc3VertexTexCoordOffset" toSemantic: kCC3SemanticVertexTexCoordOffset];				/**< (vec2[]) Offset to add to the scaled quantized texture coordinates of each texture unit. */
 	
 	// ENVIRONMENT MATRICES --------------
 	[self mapVarName: @"u_cc3MatrixModelLocal" toSemantic: kCC3SemanticModelLocalMatrix];						/**< (mat4) Current model-to-parent matrix. */
@@ -1489,6 +1522,11 @@ NSString* NSStringFromCC3Semantic(CC3Semantic semantic) {
 	[self mapVarName: @"u_cc3Vertex.isDrawingPoints" toSemantic: kCC3SemanticIsDrawingPoints];					/**< (bool) Whether the vertices are being drawn as points. */
 	[self mapVarName: @"u_cc3Vertex.shouldNormalizeNormal" toSemantic: kCC3SemanticShouldNormalizeVertexNormal];	/**< (bool) Whether vertex normals should be normalized. */
 	[self mapVarName: @"u_cc3Vertex.shouldRescaleNormal" toSemantic: kCC3SemanticShouldRescaleVertexNormal];	/**< (bool) Whether vertex normals should be rescaled. */
+	[self mapVarName: @"u_cc3Vertex.locationScale" toSemantic: kCC3SemanticVertexLocationScale];				/**< (vec3) Scale to apply to quantized vertex locations before the offset. */
+	[self mapVarName: @"u_cc3Vertex.locationOffset" toSemantic: kCC3SemanticVertexLocationOffset];				/**< (vec3) Offset to add to scaled quantized vertex locations. */
+	[self mapVarName: @"u_cc3Vertex.isNormalOctahedral" toSemantic: kCC3SemanticVertexNormalIsOctahedral];		/**< (bool) Whether vertex normals, tangents and bitangents are octahedral-encoded. */
+	[self mapVarName: @"u_cc3Vertex.texCoordScale" toSemantic: kCC3SemanticVertexTexCoordScale];				/**< (vec2[]) Scale to apply to the quantized texture coordinates of each texture unit. */
+	[self mapVarName: @"u_cc3Vertex.texCoordOffset" toSemantic: kCC3SemanticVertexTexCoordOffset];				/**< (vec2[]) Offset to add to the scaled quantized texture coordinates of each texture unit. */
 	
 	// ENVIRONMENT MATRICES --------------
 	[self mapVarName: @"u_cc3Matrices.modelLocal" toSemantic: kCC3SemanticModelLocalMatrix];					/**< (mat4) Current model-to-parent matrix. */
@@ -1007,6 +1007,20 @@
 /** Removes this program instance from the cache. */
 -(void) remove;
 
+/**
+ * Returns the number of bytes of application memory occupied by the values of the uniforms
+ * of this program, including the copies used to avoid redundant updates to the GL engine.
+ */
+@property(nonatomic, readonly) NSUInteger applicationMemoryBytes;
+
+/**
+ * Returns an estimate of the number of bytes of GL memory occupied by this program.
+ *
+ * The GL engine does not report the memory occupied by a linked program, so this property
+ * returns zero. It is provided for consistency with other cached GL content.
+ */
+@property(nonatomic, readonly) NSUInteger glMemoryBytes;
+
 /**
  * Adds the specified program to the collection of loaded programs.
  *
@@ -1152,6 +1166,14 @@
  */
 +(NSString*) loadedProgramsDescription;
 
+/**
+ * Returns the cache holding the loaded programs.
+ *
+ * You can use the returned cache to retrieve statistics about the effectiveness of the cache,
+ * and the memory held by the programs within it.
+ */
++(CC3Cache*) programCache;
+
 
 #pragma mark Shader matching
 
@@ -531,10 +531,13 @@ static BOOL _defaultShouldAllowDefaultVariableValues = NO;
 	CC3Assert(_semanticDelegate, @"%@ requires the semanticDelegate property be set before linking.", self);
 	
 	MarkRezActivityStart();
+	CC3TraceBegin("CC3ShaderProgram link", "shader", self.name.UTF8String);
 	
 	CC3OpenGL* gl = CC3OpenGL.sharedGL;
 	[gl linkShaderProgram: self.programID];
 	
+	CC3TraceEnd("CC3ShaderProgram link", "shader");
+	
 	CC3Assert([gl getShaderProgramWasLinked: self.programID],
 			  @"%@ could not be linked because:\n%@", self,
 			  [gl getLogForShaderProgram: self.programID]);
@@ -863,6 +866,16 @@ static GLuint _lastAssignedProgramTag = 0;
 
 -(void) remove { [self.class removeProgram: self]; }
 
+-(NSUInteger) applicationMemoryBytes {
+	NSUInteger byteCnt = 0;
+	for (CC3GLSLUniform* var in _uniformsSceneScope) byteCnt += var.applicationMemoryBytes;
+	for (CC3GLSLUniform* var in _uniformsNodeScope) byteCnt += var.applicationMemoryBytes;
+	for (CC3GLSLUniform* var in _uniformsDrawScope) byteCnt += var.applicationMemoryBytes;
+	return byteCnt;
+}
+
+-(NSUInteger) glMemoryBytes { return 0; }
+
 static CC3Cache* _programCache = nil;
 
 +(void) ensureCache {
@@ -927,6 +940,11 @@ static BOOL _shouldAutomaticallyPreloadMatchingPureColorPrograms = YES;
 	return desc;
 }
 
++(CC3Cache*) programCache {
+	[self ensureCache];
+	return _programCache;
+}
+
 
 #pragma mark Program matching
 
@@ -35,9 +35,24 @@
 #import "CC3Billboard.h"
 #import "CC3UtilityMeshNodes.h"
 
+@class CC3PerformanceStatistics, CC3BackgroundTask;
+
 /** The suggested default shadow volume vertex offset factor. */
 static const GLfloat kCC3DefaultShadowVolumeVertexOffsetFactor = 0.001f;
 
+/**
+ * The values that determine the shape of a shadow volume mesh. A shadow volume whose
+ * key has not changed since its mesh was last built can reuse that mesh unchanged.
+ */
+typedef struct {
+	CC3Vector4 lightPosition;		/**< The light position, in the local coordinates of the shadow caster. */
+	GLfloat vertexOffsetFactor;		/**< The shadowVolumeVertexOffsetFactor of the shadow volume. */
+	GLfloat expansionLimitFactor;	/**< The shadowExpansionLimitFactor of the shadow volume. */
+	GLuint deformationVersion;		/**< The deformation version of the faces of the shadow caster. */
+	GLuint faceCount;				/**< The number of faces in the shadow caster. */
+	GLuint options;					/**< Flags indicating how the terminator is extruded and capped. */
+} CC3ShadowVolumeKey;
+
 
 #pragma mark -
 #pragma mark CC3ShadowVolumeMeshNode
@@ -71,6 +86,20 @@ static const GLfloat kCC3DefaultShadowVolumeVertexOffsetFactor = 0.001f;
  */
 @interface CC3ShadowVolumeMeshNode : CC3MeshNode <CC3ShadowProtocol> {
 	CC3Light* _light;
+	CC3Face* _casterFaces;
+	CC3Plane* _casterFacePlanes;
+	GLuint* _litFaceBits;
+	GLuint* _previousLitFaceBits;
+	GLuint* _silhouetteRecords;
+	CC3FaceNeighbours* _casterFaceNeighbours;
+	CC3ShadowVolumeKey _shadowVolumeKey;
+	GLuint _casterFaceCapacity;
+	GLuint _casterFacesVersion;
+	GLuint _silhouetteRecordCount;
+	GLuint _classifiedFaceCount;
+	GLuint _silhouetteEdgeCount;
+	GLuint _shadowBuildCount;
+	NSTimeInterval _shadowBuildDuration;
 	GLushort _shadowLagFactor;
 	GLushort _shadowLagCount;
 	GLfloat _shadowVolumeVertexOffsetFactor;
@@ -81,6 +110,11 @@ static const GLfloat kCC3DefaultShadowVolumeVertexOffsetFactor = 0.001f;
 	BOOL _shouldShadowBackFaces : 1;
 	BOOL _useDepthFailAlgorithm : 1;
 	BOOL _shouldAddEndCapsOnlyWhenNeeded : 1;
+	BOOL _hasShadowVolumeKey : 1;
+	BOOL _areCasterFacesGathered : 1;
+	BOOL _isSilhouetteCached : 1;
+	BOOL _didReuseShadowVolume : 1;
+	BOOL _didReuseSilhouette : 1;
 }
 
 /**
@@ -105,6 +139,95 @@ static const GLfloat kCC3DefaultShadowVolumeVertexOffsetFactor = 0.001f;
  */
 -(void) drawToStencilWithVisitor: (CC3NodeDrawingVisitor*) visitor;
 
+
+#pragma mark Building shadow volumes
+
+/**
+ * The number of faces of the shadow-casting node that were classified as facing towards
+ * or away from the light, the last time the shadow volume mesh was built.
+ */
+@property(nonatomic, readonly) GLuint classifiedFaceCount;
+
+/**
+ * The number of terminator edges that were extruded to form the sides of the shadow volume,
+ * the last time the shadow volume mesh was built.
+ */
+@property(nonatomic, readonly) GLuint silhouetteEdgeCount;
+
+/** The time taken to build the shadow volume mesh, the last time it was built. */
+@property(nonatomic, readonly) NSTimeInterval shadowBuildDuration;
+
+/**
+ * Invokes the updateShadow method on each of the specified shadows, building the meshes
+ * of any shadow volumes that need to be rebuilt together, and adding the classifiedFaceCount,
+ * silhouetteEdgeCount and shadowBuildDuration of each shadow volume that was rebuilt to the
+ * specified performance statistics, which may be nil.
+ *
+ * The faces of each shadow-casting node are gathered on the current thread. Each shadow volume
+ * then classifies all of those faces against its light at once, extrudes only the terminator
+ * edges between lit and dark faces, and writes the resulting vertices directly into its mesh.
+ * When enough faces are involved, these shadow volumes are built concurrently, and this method
+ * returns once all of them have been built.
+ *
+ * This method is invoked automatically by the light, and by the scene, during each update.
+ */
++(void) updateShadows: (id<NSFastEnumeration>) shadows withStatistics: (CC3PerformanceStatistics*) stats;
+
+
+#pragma mark Caching shadow volumes
+
+/**
+ * Indicates whether the last update of this shadow volume found that it needed to be rebuilt,
+ * but that the light position relative to the shadow caster, the deformation of the shadow
+ * caster, and the options that affect the shape of the shadow volume were all unchanged since
+ * the mesh was last built, and so reused the existing mesh without rebuilding it.
+ *
+ * This is typical of level geometry lit by a light that does not move. Such a shadow volume
+ * is built once, and is reused from then on. The offset applied by the value of the
+ * shadowVolumeVertexOffsetFactor property is not part of this comparison, so camera movement
+ * alone does not cause the shadow volume to be rebuilt.
+ */
+@property(nonatomic, readonly) BOOL didReuseShadowVolume;
+
+/**
+ * Indicates whether the last rebuild of this shadow volume found that every face of the shadow
+ * caster faced towards or away from the light exactly as it did during the previous rebuild,
+ * and so reused the previous terminator, and only rewrote the shadow volume vertices.
+ *
+ * This is typical of a shadow caster, or light, that is moving slowly. Faces of rigid shadow
+ * casters are only retrieved from the shadow caster again if the shadow caster deforms.
+ */
+@property(nonatomic, readonly) BOOL didReuseSilhouette;
+
+/**
+ * Builds the shadow volume for the current light position in the background, using the
+ * shared CC3Backgrounder, and returns the background task that was submitted, or returns
+ * nil if the shadow volume does not need to be built.
+ *
+ * The faces of the shadow caster are gathered immediately, and then classified against the
+ * light, and the terminator found, in the background. Once the task has finished, the shadow
+ * volume mesh is populated on the main thread. From then on, this shadow volume will be reused
+ * during updates, until the light, or the shadow caster, moves. If this shadow volume is rebuilt
+ * during an update before the task has finished, the result of the task is discarded.
+ *
+ * This method can be used while loading a scene, to prepare the shadows of static shadow
+ * casters lit by static lights, so that they do not need to be built during the first update.
+ *
+ * This method must be invoked on the main thread, once this shadow volume has been added
+ * to the shadow caster and the light.
+ */
+-(CC3BackgroundTask*) precomputeShadowVolume;
+
+/**
+ * Clears the record of the shape of the current shadow volume mesh, so that the shadow
+ * volume mesh will be completely rebuilt the next time it is updated.
+ *
+ * Faces of rigid shadow casters are retrieved from the shadow caster only when the shadow volume
+ * is first built. If the vertex locations of a rigid shadow caster are changed directly, invoke
+ * this method, and mark the shadow caster transform dirty, to have the shadow volume rebuilt.
+ */
+-(void) clearShadowVolumeCache;
+
 /**
  * Returns the default value to which the visible property will be set when an instance is
  * created and initialized.
@@ -670,6 +793,14 @@ static const GLfloat kCC3DefaultShadowVolumeVertexOffsetFactor = 0.001f;
  */
 -(void) prewarmForShadowVolumes;
 
+/**
+ * Invokes the precomputeShadowVolume method on each shadow volume of this node
+ * and all descendant nodes, to build the shadow volumes in the background.
+ *
+ * This method must be invoked on the main thread, once the shadow volumes have been added.
+ */
+-(void) precomputeShadowVolumes;
+
 /**
  * If this node is a shadow volume, returns whether the shadow cast by the shadow
  * volume will be visible. Returns NO if this node is not a shadow volume node.
@@ -29,9 +29,19 @@
  * See header file CC3ShadowVolumes.h for full API documentation.
  */
 
+/*
+ * Floating-point contraction is disabled throughout this file, including within the inline
+ * functions of the imported headers, so that the scalar and CC3_SIMD face classification of
+ * CC3ShadowVolumeBuildClassifyFaces round each multiply and add separately, and classify faces
+ * that lie very close to the light identically on all architectures.
+ */
+#pragma STDC FP_CONTRACT OFF
+
 #import "CC3ShadowVolumes.h"
 #import "CC3Scene.h"
 #import "CC3ParametricMeshNodes.h"
+#import "CC3PerformanceStatistics.h"
+#import "CC3Backgrounder.h"
 
 
 @interface CC3Node (TemplateMethods)
@@ -41,9 +51,320 @@
 
 @interface CC3MeshNode (TemplateMethods)
 -(id) shadowVolumeClass;
+-(GLuint) deformedFacesVersion;
 -(void) configureDrawingParameters: (CC3NodeDrawingVisitor*) visitor;
 @end
 
+@interface CC3SkinMeshNode (TemplateMethods)
+@property(nonatomic, retain) CC3DeformedFaceArray* deformedFaces;
+@end
+
+
+#pragma mark -
+#pragma mark Shadow volume construction
+
+/** Shadow volumes whose shadow casters hold at least this many faces in total are built concurrently. */
+#define kCC3ShadowVolumeConcurrentFaceCount		4096
+
+/**
+ * Updates that rebuild no more than this many shadow volumes gather their builds into buffers
+ * on the stack, instead of allocating those buffers on the heap each frame.
+ */
+#define kCC3ShadowVolumeStackBuildCount			32
+
+/** The kind of a terminator record that adds an end-cap face, instead of extruding an edge. */
+#define kCC3ShadowVolumeCapRecord				3
+
+/** Flags held in the options of a CC3ShadowVolumeKey. */
+#define kCC3ShadowVolumeOptionCapping			(1 << 0)
+#define kCC3ShadowVolumeOptionAddCaps			(1 << 1)
+#define kCC3ShadowVolumeOptionFrontFaces		(1 << 2)
+#define kCC3ShadowVolumeOptionBackFaces			(1 << 3)
+#define kCC3ShadowVolumeOptionTerminatorLines	(1 << 4)
+#define kCC3ShadowVolumeOptionDirectional		(1 << 5)
+
+/** Returns whether the specified shadow volume keys are identical. */
+static inline BOOL CC3ShadowVolumeKeysAreEqual(const CC3ShadowVolumeKey* k1, const CC3ShadowVolumeKey* k2) {
+	return memcmp(k1, k2, sizeof(CC3ShadowVolumeKey)) == 0;
+}
+
+/**
+ * The working state used to build the mesh of a single shadow volume.
+ *
+ * The inputs are gathered from the shadow caster on the update thread, by the prepareShadowBuild:
+ * method. The face classification, terminator walk and vertex writing performed by the
+ * CC3ShadowVolumeBuildRun function only read and write this structure, and can therefore be
+ * performed on any thread, concurrently with the builds of other shadow volumes.
+ */
+typedef struct {
+	const CC3Face* faces;					/**< The faces of the shadow caster, in local coordinates. */
+	const CC3Plane* planes;					/**< The planes of the faces of the shadow caster. */
+	const CC3FaceNeighbours* neighbours;	/**< The neighbours of the faces of the shadow caster. */
+	GLuint faceCount;						/**< The number of faces in the shadow caster. */
+	CC3ShadowVolumeKey key;					/**< The values that determine the shape of the shadow volume. */
+	CC3Vector4 lightPosition;				/**< The light position, in the local coordinates of the shadow caster. */
+	CC3Vector4 vertexNudge;					/**< The offset added to each shadow volume vertex. */
+	GLfloat expansionLimitFactor;			/**< The shadowExpansionLimitFactor of the shadow volume. */
+	BOOL isNudgingVertices;					/**< Whether the vertexNudge is added to each vertex. */
+	BOOL doesRequireCapping;				/**< Whether the shadow volume is closed at both ends. */
+	BOOL shouldAddCaps;						/**< Whether end-cap faces are added. */
+	BOOL shouldShadowFrontFaces;			/**< The shouldShadowFrontFaces of the shadow volume. */
+	BOOL shouldShadowBackFaces;				/**< The shouldShadowBackFaces of the shadow volume. */
+	BOOL shouldDrawTerminatorLines;			/**< Whether terminator lines are drawn instead of the volume. */
+	GLuint* litFaceBits;					/**< One bit per face, set if the face is lit. */
+	const GLuint* previousLitFaceBits;		/**< The litFaceBits of the previous build, if hasPreviousSilhouette. */
+	BOOL hasPreviousSilhouette;				/**< Whether the records of the previous build can be reused. */
+	BOOL wasSilhouetteReused;				/**< Whether the records of the previous build were reused. */
+	BOOL isCacheHit;						/**< Whether the existing shadow volume mesh can be reused unchanged. */
+	GLuint* records;						/**< The terminator records, each (faceIndex << 2) | edgeIndex-or-cap. */
+	GLuint recordCount;						/**< The number of terminator records. */
+	GLuint silhouetteEdgeCount;				/**< The number of terminator edges extruded. */
+	CC3Vector4* vertices;					/**< The vertex content of the shadow volume mesh. */
+	GLuint vertexCapacity;					/**< The number of vertices that fit in the vertex content. */
+	GLuint vertexCount;						/**< The number of vertices needed for the shadow volume. */
+	BOOL wasPopulated;						/**< Whether the vertices were written. */
+	NSTimeInterval buildDuration;			/**< The time taken to build the shadow volume. */
+} CC3ShadowVolumeBuild;
+
+/** Returns whether the face at the specified index was classified as facing towards the light. */
+static inline BOOL CC3ShadowVolumeBuildIsFaceLit(const CC3ShadowVolumeBuild* build, GLuint faceIdx) {
+	return (build->litFaceBits[faceIdx >> 5] >> (faceIdx & 31)) & 1;
+}
+
+/**
+ * Classifies every face of the shadow caster as lit or dark, by testing which side of the plane
+ * of the face the light lies on, and records the results as a bit per face in the litFaceBits.
+ *
+ * Where SIMD is available, four face planes are tested against the light at once. The dot product
+ * is evaluated in the same order as CC3Vector4IsInFrontOfPlane, and floating-point contraction is
+ * disabled at the top of this file, so the result is identical.
+ */
+static void CC3ShadowVolumeBuildClassifyFaces(CC3ShadowVolumeBuild* build) {
+	const CC3Plane* planes = build->planes;
+	GLuint* litBits = build->litFaceBits;
+	GLuint faceCnt = build->faceCount;
+	CC3Vector4 lgtPos = build->lightPosition;
+	GLuint faceIdx = 0;
+
+	memset(litBits, 0, ((faceCnt + 31) >> 5) * sizeof(GLuint));
+
+#if CC3_SIMD
+	CC3SIMDFloat4 lx = CC3SIMDFloat4Splat(lgtPos.x);
+	CC3SIMDFloat4 ly = CC3SIMDFloat4Splat(lgtPos.y);
+	CC3SIMDFloat4 lz = CC3SIMDFloat4Splat(lgtPos.z);
+	CC3SIMDFloat4 lw = CC3SIMDFloat4Splat(lgtPos.w);
+	for (; faceIdx + 4 <= faceCnt; faceIdx += 4) {
+		CC3SIMDFloat4 a = CC3SIMDFloat4Load(&planes[faceIdx].a);
+		CC3SIMDFloat4 b = CC3SIMDFloat4Load(&planes[faceIdx + 1].a);
+		CC3SIMDFloat4 c = CC3SIMDFloat4Load(&planes[faceIdx + 2].a);
+		CC3SIMDFloat4 d = CC3SIMDFloat4Load(&planes[faceIdx + 3].a);
+		CC3SIMDFloat4Transpose(&a, &b, &c, &d);		// Now holds the a, b, c & d of four planes
+		CC3SIMDFloat4 dist = CC3SIMDFloat4Add(CC3SIMDFloat4Add(CC3SIMDFloat4Add(CC3SIMDFloat4Multiply(a, lx),
+																				CC3SIMDFloat4Multiply(b, ly)),
+															   CC3SIMDFloat4Multiply(c, lz)),
+											  CC3SIMDFloat4Multiply(d, lw));
+		litBits[faceIdx >> 5] |= CC3SIMDFloat4PositiveMask(dist) << (faceIdx & 31);
+	}
+#endif	// CC3_SIMD
+
+	for (; faceIdx < faceCnt; faceIdx++)
+		if (CC3Vector4IsInFrontOfPlane(lgtPos, planes[faceIdx]))
+			litBits[faceIdx >> 5] |= (1U << (faceIdx & 31));
+}
+
+/**
+ * Walks the faces of the shadow caster, looking for all pairs of neighbouring faces where one face
+ * is illuminated (facing towards the light) and the other is dark (facing away from the light).
+ * The set of edges between these pairs forms the terminator of the mesh.
+ *
+ * Each terminator edge, and each end-cap face, is recorded in the order in which the shadow
+ * volume vertices will be written, and the number of vertices required is accumulated.
+ */
+static void CC3ShadowVolumeBuildFindTerminator(CC3ShadowVolumeBuild* build) {
+	const CC3FaceNeighbours* neighbours = build->neighbours;
+	GLuint* records = build->records;
+	GLuint faceCnt = build->faceCount;
+	GLuint recCnt = 0, edgeCnt = 0, vtxCnt = 0;
+
+	// Terminator lines need two vertices, a side extruded from a directional light needs a
+	// single triangle, and a side extruded from a locational light needs two triangles,
+	// plus another triangle if it is to be extended out to infinity as a capped volume.
+	GLuint sideVtxCnt;
+	if (build->shouldDrawTerminatorLines)
+		sideVtxCnt = 2;
+	else if (CC3Vector4IsDirectional(build->lightPosition))
+		sideVtxCnt = 3;
+	else
+		sideVtxCnt = build->doesRequireCapping ? 9 : 6;
+
+	for (GLuint faceIdx = 0; faceIdx < faceCnt; faceIdx++) {
+		BOOL isFaceLit = CC3ShadowVolumeBuildIsFaceLit(build, faceIdx);
+
+		// The face is part of an end-cap if it's a dark face and shadowing is based on front
+		// faces (typical), or it's a lit face and shadowing is (also) based on back faces.
+		if (build->shouldAddCaps &&
+			(isFaceLit ? build->shouldShadowBackFaces : build->shouldShadowFrontFaces)) {
+			records[recCnt++] = (faceIdx << 2) | kCC3ShadowVolumeCapRecord;
+			vtxCnt += 3;
+		}
+
+		// An edge is part of the terminator if either:
+		//   - There is no neighbouring face on this edge, and either the face is lit
+		//     and front faces are being shadowed, or the face is dark and back faces
+		//     are being shadowed.
+		//   - The neighbour has the opposite illumination than the current face, and the
+		//     neighbour has a larger index than the current face (ie- don't double count).
+		CC3FaceNeighbours faceNeighbours = neighbours[faceIdx];
+		for (GLuint edgeIdx = 0; edgeIdx < 3; edgeIdx++) {
+			GLuint neighbourFaceIdx = faceNeighbours.edges[edgeIdx];
+			BOOL isTerminatorEdge = NO;
+			if (neighbourFaceIdx == kCC3FaceNoNeighbour)
+				isTerminatorEdge = isFaceLit ? build->shouldShadowFrontFaces : build->shouldShadowBackFaces;
+			else if (neighbourFaceIdx > faceIdx)
+				isTerminatorEdge = (CC3ShadowVolumeBuildIsFaceLit(build, neighbourFaceIdx) != isFaceLit);
+
+			if (isTerminatorEdge) {
+				records[recCnt++] = (faceIdx << 2) | edgeIdx;
+				edgeCnt++;
+				vtxCnt += sideVtxCnt;
+			}
+		}
+	}
+	build->recordCount = recCnt;
+	build->silhouetteEdgeCount = edgeCnt;
+	build->vertexCount = vtxCnt;
+}
+
+/**
+ * Expands the location of a terminator edge vertex away from the locational light, along the
+ * vector from the light to the vertex, a distance equal to the distance between the light and
+ * the vertex, multiplied by the shadowExpansionLimitFactor of the shadow volume.
+ */
+static inline CC3Vector4 CC3ShadowVolumeBuildExpand(const CC3ShadowVolumeBuild* build, CC3Vector4 edgeLoc) {
+	CC3Vector4 extDir = CC3Vector4Difference(edgeLoc, build->lightPosition);
+	return CC3Vector4Add(edgeLoc, CC3Vector4ScaleUniform(extDir, build->expansionLimitFactor));
+}
+
+/**
+ * Writes the shadow volume vertices for the recorded terminator edges and end-cap faces
+ * directly into the vertex content, which must have room for the vertexCount vertices.
+ *
+ * Each terminator edge is extruded out to infinity in the direction away from the light,
+ * with the same winding as the dark face of the pair, so the shadow volume faces point outwards.
+ *
+ * For a directional light, the sides of the shadow volume are parallel and meet at a single
+ * point at infinity, in the opposite direction of the light, so a single triangle is added.
+ *
+ * For a locational light, each side is formed by projecting a vector from the light through
+ * each edge vertex. If the shadow volume does not need to be capped, the side expands out to
+ * infinity. Otherwise, the side expands only as far as determined by the shadowExpansionLimitFactor,
+ * and is then extended out to infinity at that size, as if the light was directional.
+ *
+ * End-cap faces use the winding of the shadow caster face if it is lit, and the opposite
+ * winding if it is dark.
+ */
+static void CC3ShadowVolumeBuildWriteVertices(CC3ShadowVolumeBuild* build) {
+	const GLuint* records = build->records;
+	GLuint recCnt = build->recordCount;
+	CC3Vector4* vertices = build->vertices;
+	CC3Vector4 lgtPos = build->lightPosition;
+	CC3Vector4 farLoc = CC3Vector4HomogeneousNegate(lgtPos);
+	BOOL isDirectional = CC3Vector4IsDirectional(lgtPos);
+	GLuint vtxIdx = 0;
+
+	GLuint currFaceIdx = kCC3FaceNoNeighbour;
+	BOOL isFaceLit = NO;
+	CC3Vector4 vertices4d[3];
+
+	for (GLuint recIdx = 0; recIdx < recCnt; recIdx++) {
+		GLuint faceIdx = records[recIdx] >> 2;
+		GLuint recKind = records[recIdx] & 3;
+
+		// Records for the same face are consecutive, so only convert each face once.
+		if (faceIdx != currFaceIdx) {
+			CC3Face face = build->faces[faceIdx];
+			for (GLuint i = 0; i < 3; i++) {
+				vertices4d[i] = CC3Vector4FromLocation(face.vertices[i]);
+				if (build->isNudgingVertices) vertices4d[i] = CC3Vector4Add(vertices4d[i], build->vertexNudge);
+			}
+			isFaceLit = CC3ShadowVolumeBuildIsFaceLit(build, faceIdx);
+			currFaceIdx = faceIdx;
+		}
+
+		if (recKind == kCC3ShadowVolumeCapRecord) {
+			vertices[vtxIdx++] = vertices4d[0];
+			vertices[vtxIdx++] = vertices4d[isFaceLit ? 1 : 2];
+			vertices[vtxIdx++] = vertices4d[isFaceLit ? 2 : 1];
+			continue;
+		}
+
+		// Choose the start and end of the edge based on which face of the pair is illuminated.
+		GLuint edgeIdx = recKind;
+		GLuint nextIdx = (edgeIdx < 2) ? (edgeIdx + 1) : 0;
+		CC3Vector4 edgeStartLoc = vertices4d[isFaceLit ? edgeIdx : nextIdx];
+		CC3Vector4 edgeEndLoc = vertices4d[isFaceLit ? nextIdx : edgeIdx];
+
+		if (build->shouldDrawTerminatorLines) {
+			vertices[vtxIdx++] = edgeStartLoc;
+			vertices[vtxIdx++] = edgeEndLoc;
+		} else if (isDirectional) {
+			vertices[vtxIdx++] = edgeStartLoc;
+			vertices[vtxIdx++] = farLoc;
+			vertices[vtxIdx++] = edgeEndLoc;
+		} else {
+			// The W component of each difference will be zero, indicating a point at infinity.
+			CC3Vector4 farStartLoc, farEndLoc;
+			if (build->doesRequireCapping) {
+				farStartLoc = CC3ShadowVolumeBuildExpand(build, edgeStartLoc);
+				farEndLoc = CC3ShadowVolumeBuildExpand(build, edgeEndLoc);
+			} else {
+				farStartLoc = CC3Vector4Difference(edgeStartLoc, lgtPos);
+				farEndLoc = CC3Vector4Difference(edgeEndLoc, lgtPos);
+			}
+
+			vertices[vtxIdx++] = edgeStartLoc;
+			vertices[vtxIdx++] = farStartLoc;
+			vertices[vtxIdx++] = farEndLoc;
+
+			vertices[vtxIdx++] = edgeStartLoc;
+			vertices[vtxIdx++] = farEndLoc;
+			vertices[vtxIdx++] = edgeEndLoc;
+
+			if (build->doesRequireCapping) {
+				vertices[vtxIdx++] = farStartLoc;
+				vertices[vtxIdx++] = farLoc;
+				vertices[vtxIdx++] = farEndLoc;
+			}
+		}
+	}
+	CC3AssertC(vtxIdx == build->vertexCount, @"Shadow volume wrote %u vertices instead of %u", vtxIdx, build->vertexCount);
+}
+
+/**
+ * Classifies the faces of the shadow caster, finds the terminator, and, if the vertex content
+ * of the shadow volume mesh is large enough, writes the shadow volume vertices into it.
+ *
+ * If the existing shadow volume mesh can be reused unchanged, nothing is done. If every face
+ * is classified exactly as it was during the previous build, the terminator records of the
+ * previous build, which are held in the records buffer, are reused, and only the vertices
+ * are rewritten.
+ *
+ * This function does not access any Objective-C objects, and can be invoked on any thread.
+ */
+static void CC3ShadowVolumeBuildRun(CC3ShadowVolumeBuild* build) {
+	if (build->isCacheHit) return;
+
+	NSTimeInterval startTime = NSDate.timeIntervalSinceReferenceDate;
+	CC3ShadowVolumeBuildClassifyFaces(build);
+	build->wasSilhouetteReused = (build->hasPreviousSilhouette &&
+								  memcmp(build->litFaceBits, build->previousLitFaceBits,
+										 ((build->faceCount + 31) >> 5) * sizeof(GLuint)) == 0);
+	if ( !build->wasSilhouetteReused ) CC3ShadowVolumeBuildFindTerminator(build);
+	build->wasPopulated = (build->vertexCount <= build->vertexCapacity);
+	if (build->wasPopulated) CC3ShadowVolumeBuildWriteVertices(build);
+	build->buildDuration = NSDate.timeIntervalSinceReferenceDate - startTime;
+}
+
 
 #pragma mark -
 #pragma mark CC3ShadowVolumeMeshNode
@@ -51,12 +372,15 @@
 @implementation CC3ShadowVolumeMeshNode
 
 @synthesize light=_light, shouldDrawTerminator=_shouldDrawTerminator;
+@synthesize classifiedFaceCount=_classifiedFaceCount, silhouetteEdgeCount=_silhouetteEdgeCount;
+@synthesize shadowBuildDuration=_shadowBuildDuration;
 
 -(void) dealloc {
 	[_light removeShadow: self];		// Will also set light to nil
 	LogTrace(@"Removed %@ from %@ leaving %lu shadows", self, _light, (unsigned long)_light.shadows.count);
 
 	_light = nil;			// weak reference
+	[self deallocateShadowBuildBuffers];
 	[super dealloc];
 }
 
@@ -161,6 +485,24 @@
 -(id) initWithTag: (GLuint) aTag withName: (NSString*) aName {
 	if ( (self = [super initWithTag: aTag withName: aName]) ) {
 		_light = nil;
+		_casterFaces = NULL;
+		_casterFacePlanes = NULL;
+		_litFaceBits = NULL;
+		_previousLitFaceBits = NULL;
+		_silhouetteRecords = NULL;
+		_casterFaceNeighbours = NULL;
+		_casterFaceCapacity = 0;
+		_casterFacesVersion = 0;
+		_silhouetteRecordCount = 0;
+		_shadowBuildCount = 0;
+		_hasShadowVolumeKey = NO;
+		_areCasterFacesGathered = NO;
+		_isSilhouetteCached = NO;
+		_didReuseShadowVolume = NO;
+		_didReuseSilhouette = NO;
+		_classifiedFaceCount = 0;
+		_silhouetteEdgeCount = 0;
+		_shadowBuildDuration = 0.0;
 		_isShadowDirty = YES;
 		_shouldDrawTerminator = NO;
 		_shouldShadowFrontFaces = YES;
@@ -270,176 +612,185 @@
 }
 
 /**
- * Populates the shadow volume mesh by iterating through all the faces in the mesh of
- * the shadow casting node, looking for all pairs of neighbouring faces where one face
- * is in illuminated (facing towards the light) and the other is dark (facing away from
- * the light). The set of edges between these pairs forms the terminator of the mesh,
- * where the mesh on one side of the terminator is illuminated and the other is dark.
+ * Ensures the working buffers used to build this shadow volume are large
+ * enough to hold a shadow caster with the specified number of faces.
+ */
+-(void) ensureShadowBuildCapacity: (GLuint) faceCount {
+	if (faceCount <= _casterFaceCapacity) return;
+
+	[self deallocateShadowBuildBuffers];
+	GLuint bitWordCount = (faceCount + 31) >> 5;
+	_casterFaces = malloc(faceCount * sizeof(CC3Face));
+	_casterFacePlanes = malloc(faceCount * sizeof(CC3Plane));
+	_litFaceBits = malloc(bitWordCount * sizeof(GLuint));
+	_previousLitFaceBits = malloc(bitWordCount * sizeof(GLuint));
+	_silhouetteRecords = malloc(faceCount * 4 * sizeof(GLuint));		// An end-cap and three edges per face
+	_casterFaceCapacity = faceCount;
+	LogTrace(@"%@ allocated shadow build buffers for %u faces", self, faceCount);
+}
+
+/** Releases the working buffers used to build this shadow volume. */
+-(void) deallocateShadowBuildBuffers {
+	free(_casterFaces);
+	_casterFaces = NULL;
+	free(_casterFacePlanes);
+	_casterFacePlanes = NULL;
+	free(_litFaceBits);
+	_litFaceBits = NULL;
+	free(_previousLitFaceBits);
+	_previousLitFaceBits = NULL;
+	free(_silhouetteRecords);
+	_silhouetteRecords = NULL;
+	_casterFaceCapacity = 0;
+	_areCasterFacesGathered = NO;
+	_isSilhouetteCached = NO;
+}
+
+-(void) clearShadowVolumeCache {
+	_hasShadowVolumeKey = NO;
+	_areCasterFacesGathered = NO;
+	_isSilhouetteCached = NO;
+}
+
+-(BOOL) didReuseShadowVolume { return _didReuseShadowVolume; }
+
+-(BOOL) didReuseSilhouette { return _didReuseSilhouette; }
+
+/**
+ * Gathers everything needed to build this shadow volume into the specified build structure.
  *
- * The shadow volume is then constructed by extruding each edge line segment in the
- * terminator out to infinity in the direction away from the light source, forming a
- * tube of infinite length.
+ * The light position is transformed into the local coordinates of the shadow caster, and,
+ * together with the deformation of the shadow caster and the options that affect the shape
+ * of the shadow volume, forms the key of the shadow volume. If the key is the same as when the
+ * mesh was last built, the existing mesh can be reused, and nothing further is gathered.
  *
- * Uses the 4D homogeneous location of the light in the global coordinate system.
- * When using the light location this method transforms this location to the local
- * coordinates system of the shadow caster.
+ * The deformed faces of the shadow caster are lazily calculated and cached by skinned meshes,
+ * so they are copied into the working buffers of this shadow volume here, on the update thread.
+ * The faces of a rigid shadow caster are copied again only when its vertex locations change.
+ * The vertex content of the shadow volume mesh is made available to be written directly.
  */
--(void) populateShadowMesh {
-	
+-(void) prepareShadowBuild: (CC3ShadowVolumeBuild*) build {
 	CC3MeshNode* scNode = self.shadowCaster;
 	GLuint faceCnt = scNode.faceCount;
-	GLuint shdwVtxIdx = 0;
-	BOOL wasMeshExpanded = NO;
-	BOOL doesRequireCapping = _useDepthFailAlgorithm || !_shouldAddEndCapsOnlyWhenNeeded;
-	
+	CC3FaceNeighbours* neighbours = scNode.mesh.faces.neighbours;
+
+	memset(build, 0, sizeof(CC3ShadowVolumeBuild));
+
 	// Transform the 4D position of the light into the local coordinates of the shadow caster.
 	CC3Vector4 lightPosition = _light.globalHomogeneousPosition;
-	CC3Vector4 localLightPosition = [scNode.globalTransformMatrixInverted
-									 transformHomogeneousVector: lightPosition];
-	
+	build->lightPosition = [scNode.globalTransformMatrixInverted transformHomogeneousVector: lightPosition];
+
+	build->expansionLimitFactor = _shadowExpansionLimitFactor;
+	build->doesRequireCapping = _useDepthFailAlgorithm || !_shouldAddEndCapsOnlyWhenNeeded;
+	build->shouldAddCaps = build->doesRequireCapping && !_shouldDrawTerminator;
+	build->shouldShadowFrontFaces = _shouldShadowFrontFaces;
+	build->shouldShadowBackFaces = _shouldShadowBackFaces;
+	build->shouldDrawTerminatorLines = _shouldDrawTerminator && self.visible;
+
+	// Build the key of this shadow volume, and reuse the existing mesh if the key has not changed.
+	CC3ShadowVolumeKey* key = &build->key;
+	key->lightPosition = build->lightPosition;
+	key->vertexOffsetFactor = _shadowVolumeVertexOffsetFactor;
+	key->expansionLimitFactor = _shadowExpansionLimitFactor;
+	key->deformationVersion = scNode.deformedFacesVersion;
+	key->faceCount = faceCnt;
+	key->options = ((build->doesRequireCapping ? kCC3ShadowVolumeOptionCapping : 0) |
+					(build->shouldAddCaps ? kCC3ShadowVolumeOptionAddCaps : 0) |
+					(build->shouldShadowFrontFaces ? kCC3ShadowVolumeOptionFrontFaces : 0) |
+					(build->shouldShadowBackFaces ? kCC3ShadowVolumeOptionBackFaces : 0) |
+					(build->shouldDrawTerminatorLines ? kCC3ShadowVolumeOptionTerminatorLines : 0) |
+					(CC3Vector4IsDirectional(build->lightPosition) ? kCC3ShadowVolumeOptionDirectional : 0));
+
+	BOOL isSameCaster = (_casterFaceNeighbours == neighbours && _shadowVolumeKey.faceCount == faceCnt);
+	build->isCacheHit = (_hasShadowVolumeKey && isSameCaster && CC3ShadowVolumeKeysAreEqual(key, &_shadowVolumeKey));
+	if (build->isCacheHit) {
+		LogTrace(@"%@ reusing shadow volume for light at %@", self, NSStringFromCC3Vector4(build->lightPosition));
+		return;
+	}
+
+	// Gather the faces, unless they were already gathered from the same caster and deformation.
+	[self ensureShadowBuildCapacity: faceCnt];
+	if ( !(_areCasterFacesGathered && isSameCaster && _casterFacesVersion == key->deformationVersion) ) {
+		for (GLuint faceIdx = 0; faceIdx < faceCnt; faceIdx++) {
+			_casterFaces[faceIdx] = [scNode deformedFaceAt: faceIdx];
+			_casterFacePlanes[faceIdx] = [scNode deformedFacePlaneAt: faceIdx];
+		}
+		_casterFacesVersion = key->deformationVersion;
+		_areCasterFacesGathered = YES;
+	}
+
+	build->faces = _casterFaces;
+	build->planes = _casterFacePlanes;
+	build->neighbours = neighbours;
+	build->faceCount = faceCnt;
+	build->litFaceBits = _litFaceBits;
+	build->records = _silhouetteRecords;
+
+	// If the terminator was found under the same options, it can be reused if the faces are lit the same.
+	build->hasPreviousSilhouette = (_isSilhouetteCached && isSameCaster &&
+									key->options == _shadowVolumeKey.options);
+	if (build->hasPreviousSilhouette) {
+		build->previousLitFaceBits = _previousLitFaceBits;
+		build->recordCount = _silhouetteRecordCount;
+		build->silhouetteEdgeCount = _silhouetteEdgeCount;
+		build->vertexCount = _mesh.vertexCount;
+	}
+
 	// Determine whether we want to nudge the shadow volume vertices away from the shadow caster
-	BOOL isNudgingVertices = (_shadowVolumeVertexOffsetFactor != 0.0f);
-	CC3Vector4 svVtxNudge = isNudgingVertices
-								? [self shadowVolumeVertexOffsetForLightAt: localLightPosition]
-								: kCC3Vector4Zero;
-	
-	//	if (doesRequireCapping) LogDebug(@"Populating %@ with end caps", self);
-	
-	//	if ( [scNode.name isEqualToString: @"GeoSphere01"] ) {
-	//		LogDebug(@"Populating %@ with %i faces for light at %@ and %@ end caps",
-	//					  self, faceCnt, NSStringFromCC3Vector4(lightPosition),
-	//					  (doesRequireCapping ? @"including" : @"excluding"));
-	//	}
-	
-	LogTrace(@"Populating %@ with %i faces for light at %@ and %@ end caps",
+	build->isNudgingVertices = (_shadowVolumeVertexOffsetFactor != 0.0f);
+	build->vertexNudge = build->isNudgingVertices
+							? [self shadowVolumeVertexOffsetForLightAt: build->lightPosition]
+							: kCC3Vector4Zero;
+
+	CC3VertexLocations* vtxLocs = _mesh.vertexLocations;
+	CC3Assert(vtxLocs.elementType == GL_FLOAT && vtxLocs.elementSize == 4 && vtxLocs.vertexStride == sizeof(CC3Vector4),
+			  @"%@ requires shadow volume vertex locations to be held as separate 4D GL_FLOAT locations", self);
+	build->vertices = vtxLocs.vertices;
+	build->vertexCapacity = vtxLocs.allocatedVertexCapacity;
+
+	LogTrace(@"Populating %@ with %i faces for light at %@ (local %@) and %@ end caps",
 				  self, faceCnt, NSStringFromCC3Vector4(lightPosition),
-				  (doesRequireCapping ? @"including" : @"excluding"));
-	
-	LogTrace(@"%@ global light location: %@ shadow local light: %@ %@ inverted: %@",
-				  self, NSStringFromCC3Vector4(lightPosition),
-				  NSStringFromCC3Vector4(localLightPosition),
-				  scNode.globalTransformMatrix,
-				  scNode.globalTransformMatrixInverted);
-	
-	// Iterate through all the faces in the mesh of the shadow caster.
-	for (GLuint faceIdx = 0; faceIdx < faceCnt; faceIdx++) {
-		
-		// Retrieve the current face, convert it to 4D homogeneous locations
-		CC3Face face = [scNode deformedFaceAt: faceIdx];
-		CC3Vector4 vertices4d[3];
-		vertices4d[0] = CC3Vector4FromLocation(face.vertices[0]);
-		vertices4d[1] = CC3Vector4FromLocation(face.vertices[1]);
-		vertices4d[2] = CC3Vector4FromLocation(face.vertices[2]);
-		
-		// If needed, nudge the shadow volume face away from the
-		// shadow caster face in the direction away from the light
-		if (isNudgingVertices) {
-			vertices4d[0] = CC3Vector4Add(vertices4d[0], svVtxNudge);
-			vertices4d[1] = CC3Vector4Add(vertices4d[1], svVtxNudge);
-			vertices4d[2] = CC3Vector4Add(vertices4d[2], svVtxNudge);
-		}
-		
-		// Determine whether the face is illuminated.
-		BOOL isFaceLit = CC3Vector4IsInFrontOfPlane(localLightPosition, [scNode deformedFacePlaneAt: faceIdx]);
-		
-		LogTrace(@"Face %i of %@ is %@. Indices: %@, Vertices: %@, plane: %@, neighbours: %@",
-					  faceIdx, scNode, (isFaceLit ? @"illuminated" : @"dark"),
-					  NSStringFromCC3FaceIndices([scNode faceIndicesAt: faceIdx]),
-					  NSStringFromCC3Face([scNode deformedFaceAt: faceIdx]),
-					  NSStringFromCC3Plane([scNode deformedFacePlaneAt: faceIdx]),
-					  NSStringFromCC3FaceNeighbours([scNode faceNeighboursAt: faceIdx]));
-		
-		// If we're drawing end-caps, and this face is part of an end-cap, draw it.
-		// It's part of an end-cap if it's a dark face and shadowing is based on front
-		// faces (typical), or it's a lit face and shadowing is (also) based on back faces
-		// (as with some open meshes).
-		if (doesRequireCapping &&
-			(isFaceLit ? _shouldShadowBackFaces : _shouldShadowFrontFaces) &&
-			!_shouldDrawTerminator) {
-			LogTrace(@"%@ adding end cap for face %i", self, faceIdx);
-			wasMeshExpanded |= [self addShadowVolumeCapFor: isFaceLit
-													  face: vertices4d
-												forLightAt: localLightPosition
-										   startingAtIndex: &shdwVtxIdx];
-		}
-		
-		// Now check the neighbouring face on the other side of each edge of this face.
-		CC3FaceNeighbours neighbours = [scNode faceNeighboursAt: faceIdx];
-		for (int edgeIdx = 0; edgeIdx < 3; edgeIdx++) {
-			
-			// Get the index of the face on the other side of this edge
-			GLuint neighbourFaceIdx = neighbours.edges[edgeIdx];
-			
-			// Check if this edge is part of the terminator. It is if either:
-			//   - There is no neighbouring face on this edge, and either the face is lit
-			//     and front faces are being shadowed, or the face is dark and back faces
-			//     are being shadowed.
-			//   - The neighbour has the opposite illumination than the current face
-			//     (ie- lit/dark or dark/lit) AND we haven't encountered this edge before
-			//     during this iteration, (ie- don't double count). The double-count test
-			//     is accomplished by only accepting the neighbouring face if it has a
-			//     larger index than the current face.
-			BOOL isTerminatorEdge = NO;
-			if (neighbourFaceIdx == kCC3FaceNoNeighbour) {
-				isTerminatorEdge = isFaceLit ? _shouldShadowFrontFaces : _shouldShadowBackFaces;
-			} else if (neighbourFaceIdx > faceIdx) {		// Don't double count edges
-				BOOL isNeighbourFaceLit = CC3Vector4IsInFrontOfPlane(localLightPosition, [scNode deformedFacePlaneAt: neighbourFaceIdx]);
-				isTerminatorEdge = (isNeighbourFaceLit != isFaceLit);
-			}
-			
-			if (isTerminatorEdge) {
-				
-				// We've found a terminator edge!
-				LogTrace(@"\tNeighbouring face %u is %@. We have a terminator edge.",
-							  neighbourFaceIdx, ((neighbourFaceIdx == kCC3FaceNoNeighbour)
-												 ? @"missing" 
-												 : (isFaceLit ? @"dark" : @"illuminated")));
-				
-				// Get the end points of the terminator edge that we will be extruding.
-				// To have the normals of the shadow volume mesh point outwards, we want the
-				// winding of the extruded face to be the same as the dark face. So, choose
-				// the start and end of the edge based on which face of this pair is illuminated.
-				CC3Vector4 edgeStartLoc, edgeEndLoc;
-				if (isFaceLit) {
-					edgeStartLoc = vertices4d[edgeIdx];
-					edgeEndLoc = vertices4d[(edgeIdx < 2) ? (edgeIdx + 1) : 0];
-				} else {
-					edgeStartLoc = vertices4d[(edgeIdx < 2) ? (edgeIdx + 1) : 0];
-					edgeEndLoc = vertices4d[edgeIdx];
-				}
-				
-				if (self.shouldDrawTerminator && self.visible) {
-					// Draw the terminator line instead of a shadow
-					wasMeshExpanded |= [self addTerminatorLineFrom: edgeStartLoc
-																to: edgeEndLoc
-												   startingAtIndex: &shdwVtxIdx];
-				} else if (CC3Vector4IsDirectional(localLightPosition)) {
-					// Draw the shadow from a directional light
-					wasMeshExpanded |= [self addShadowVolumeSideFrom: edgeStartLoc
-																  to: edgeEndLoc
-											   forDirectionalLightAt: localLightPosition
-													 startingAtIndex: &shdwVtxIdx];
-				} else {
-					// Draw the shadow from a locational light, possibly closing off the far end
-					wasMeshExpanded |= [self addShadowVolumeSideFrom: edgeStartLoc
-																  to: edgeEndLoc
-															 withCap: doesRequireCapping
-												forLocationalLightAt: localLightPosition
-													 startingAtIndex: &shdwVtxIdx];
-				}
-			} else {
-				LogTrace(@"\tNeighbouring face %u is %@. Not a terminator edge.",
-							  neighbourFaceIdx, (isFaceLit ? @"illuminated" : @"dark"));
-			}
+				  NSStringFromCC3Vector4(build->lightPosition),
+				  (build->doesRequireCapping ? @"including" : @"excluding"));
+}
+
+/**
+ * Completes the build of this shadow volume from the specified build structure.
+ *
+ * If the shadow volume mesh was not large enough to hold the shadow volume vertices,
+ * the mesh is expanded, and the vertices are written. The vertex count of the mesh
+ * is then updated, and, if the mesh is using GL VBO's, they are updated, or recreated
+ * if the mesh was expanded.
+ *
+ * The key, face classification and terminator of the build are retained,
+ * so that they can be reused by later builds.
+ */
+-(void) finishShadowBuild: (CC3ShadowVolumeBuild*) build {
+	_didReuseShadowVolume = build->isCacheHit;
+	if (build->isCacheHit) return;
+
+	BOOL wasMeshExpanded = NO;
+	if ( !build->wasPopulated ) {
+		NSTimeInterval startTime = NSDate.timeIntervalSinceReferenceDate;
+		wasMeshExpanded = [_mesh ensureVertexCapacity: build->vertexCount];
+		if (_mesh.allocatedVertexCapacity < build->vertexCount) {
+			_mesh.allocatedVertexCapacity = build->vertexCount;
+			wasMeshExpanded = YES;
 		}
+		CC3VertexLocations* vtxLocs = _mesh.vertexLocations;
+		build->vertices = vtxLocs.vertices;
+		build->vertexCapacity = vtxLocs.allocatedVertexCapacity;
+		CC3ShadowVolumeBuildWriteVertices(build);
+		build->wasPopulated = YES;
+		build->buildDuration += NSDate.timeIntervalSinceReferenceDate - startTime;
 	}
-	
+
 	// Update the vertex count of the shadow volume mesh, based on how many sides we've added.
-	_mesh.vertexCount = shdwVtxIdx;
-	LogTrace(@"%@ setting vertex count to %u", self, shdwVtxIdx);
-	
-	// If the mesh is using GL VBO's, update them. If the mesh was expanded,
-	// recreate the VBO's, otherwise update them.
+	_mesh.vertexCount = build->vertexCount;
+	[_mesh.vertexLocations markBoundaryDirty];
+	LogTrace(@"%@ setting vertex count to %u from %u terminator edges",
+			 self, build->vertexCount, build->silhouetteEdgeCount);
+
 	if (_mesh.isUsingGLBuffers) {
 		if (wasMeshExpanded) {
 			[_mesh deleteGLBuffers];
@@ -448,184 +799,168 @@
 			[_mesh updateVertexLocationsGLBuffer];
 		}
 	}
-	LogTrace(@"Finshed populating %@", self);
-}
 
-/**
- * Adds a side to the shadow volume, by extruding the specified terminator edge of
- * the specified shadow caster mesh to infinity. The light source is directional
- * at the specified position. The shadow volume vertices are added starting at the
- * specified vertex index.
- * 
- * For a directional light, the shadow volume sides are parallel and can therefore
- * be described as meeting at a single point at infinity. We therefore only need to
- * add a single triangle, whose far point is in the opposite direction of the light.
- */
--(BOOL) addShadowVolumeSideFrom: (CC3Vector4) edgeStartLoc
-							 to: (CC3Vector4) edgeEndLoc
-		  forDirectionalLightAt: (CC3Vector4) lightPosition
-				startingAtIndex: (GLuint*) shdwVtxIdx {
-	
-	// Get the location of the single point at infinity from the light direction.
-	CC3Vector4 farLoc = CC3Vector4HomogeneousNegate(lightPosition);
-	
-	// Ensure the mesh has enough capacity for another triangle.
-	BOOL wasMeshExpanded = [self.mesh ensureVertexCapacity: (*shdwVtxIdx + 3)];
-	
-	// Add a single triangle from the edge to a single point at infinity,
-	// with the same winding as the dark face.
-	[_mesh setVertexHomogeneousLocation: edgeStartLoc at: (*shdwVtxIdx)++];
-	[_mesh setVertexHomogeneousLocation: farLoc at: (*shdwVtxIdx)++];
-	[_mesh setVertexHomogeneousLocation: edgeEndLoc at: (*shdwVtxIdx)++];
-	
-	LogTrace(@"%@ drawing shadow volume side face for directional light", self);
-	
-	return wasMeshExpanded;
+	// Retain the key, and swap the classification buffers so the latest becomes the previous.
+	_shadowVolumeKey = build->key;
+	_hasShadowVolumeKey = YES;
+	_casterFaceNeighbours = (CC3FaceNeighbours*)build->neighbours;
+	GLuint* litBits = _previousLitFaceBits;
+	_previousLitFaceBits = _litFaceBits;
+	_litFaceBits = litBits;
+	_silhouetteRecordCount = build->recordCount;
+	_isSilhouetteCached = YES;
+	_didReuseSilhouette = build->wasSilhouetteReused;
+	_shadowBuildCount++;
+
+	_classifiedFaceCount = build->faceCount;
+	_silhouetteEdgeCount = build->silhouetteEdgeCount;
+	_shadowBuildDuration = build->buildDuration;
+	LogTrace(@"Finshed populating %@", self);
 }
 
 /**
- * Adds a side to the shadow volume, by extruding the specified terminator edge of
- * the specified shadow caster mesh to infinity. The light source is positional at
- * the specified position. The shadow volume vertices are added starting at the
- * specified vertex index.
- * 
- * For a locational light, the shadow volume sides are not parallel and expand as
- * they extend away from the shadow casting object. If the shadow volume does not
- * need to be capped off at the far end, the shadow expands to infinity.
+ * Populates the shadow volume mesh by classifying all the faces in the mesh of the shadow
+ * casting node as either illuminated (facing towards the light) or dark (facing away from
+ * the light), and then looking for all pairs of neighbouring faces where one face is lit
+ * and the other is dark. The set of edges between these pairs forms the terminator of the
+ * mesh, where the mesh on one side of the terminator is illuminated and the other is dark.
  *
- * However, if the shadow volume needs to be capped off at the far end, the shadow
- * is allowed to expand behind the shadow-caster to a distance equivalent to the
- * distance from the light to the shadow-caster, multiplied by the value of the
- * shadowExpansionLimitFactor property. At that point, the shadow volume will
- * extend out to infinity at that same size.
- * 
- * For the shadow volume segment that expands in size, each side is a trapezoid
- * formed by projecting a vector from the light, through each terminator edge
- * vertex, out to either infinity of the distance determined by the value of the
- * shadowExpansionLimitFactor property. Then, from that distance to infinity,
- * the shadow volume side behaves as if it originated from a directional light,
- * and is constructed from a single triangle, extending out to infinity in the
- * opposite direction of the light.
+ * The shadow volume is then constructed by extruding each edge line segment in the
+ * terminator out to infinity in the direction away from the light source, forming a
+ * tube of infinite length.
+ *
+ * Uses the 4D homogeneous location of the light in the global coordinate system.
+ * When using the light location this method transforms this location to the local
+ * coordinates system of the shadow caster.
  */
--(BOOL) addShadowVolumeSideFrom: (CC3Vector4) edgeStartLoc
-							 to: (CC3Vector4) edgeEndLoc
-						withCap: (BOOL) doesRequireCapping
-		   forLocationalLightAt: (CC3Vector4) lightPosition
-				startingAtIndex: (GLuint*) shdwVtxIdx {
-
-	CC3Vector4 farStartLoc, farEndLoc;
-
-	if (doesRequireCapping) {
-		// We need to cap this shadow volume at infinity, so allow the shadow volume
-		// to expand only for a distance equivalent to the distance from the light to
-		// the vertex, mulitiplied by the shadowExpansionLimitFactor property.
-		farStartLoc = [self expand: edgeStartLoc awayFromLocationalLightAt: lightPosition];
-		farEndLoc = [self expand: edgeEndLoc awayFromLocationalLightAt: lightPosition];
-	} else {
-		// We don't need to cap this shadow volume, so allow the shadow volume to expand
-		// to infinity in a direction away from the light, through the edge points.
-		// The W component of the result of each subtraction will be zero, indicating
-		// a point at infinity.
-		farStartLoc = CC3Vector4Difference(edgeStartLoc, lightPosition);
-		farEndLoc = CC3Vector4Difference(edgeEndLoc, lightPosition);
-	}
-	
-	// Ensure the mesh has enough capacity for another two triangles.
-	BOOL wasMeshExpanded = [self.mesh ensureVertexCapacity: (*shdwVtxIdx + 6)];
-	
-	// The shadow volume faces have the same winding as the dark face.
-	// First triangular face:
-	[_mesh setVertexHomogeneousLocation: edgeStartLoc at: (*shdwVtxIdx)++];
-	[_mesh setVertexHomogeneousLocation: farStartLoc at: (*shdwVtxIdx)++];
-	[_mesh setVertexHomogeneousLocation: farEndLoc at: (*shdwVtxIdx)++];
-	
-	// Second triangular face:
-	[_mesh setVertexHomogeneousLocation: edgeStartLoc at: (*shdwVtxIdx)++];
-	[_mesh setVertexHomogeneousLocation: farEndLoc at: (*shdwVtxIdx)++];
-	[_mesh setVertexHomogeneousLocation: edgeEndLoc at: (*shdwVtxIdx)++];
-
-	if (doesRequireCapping) {
-		// To cap, extend from the limited expansion points out to infinity in
-		// a direction away from the light, as if the light was directional.
-		// These segments will be parallel to each other, and the shadow will
-		// expand no further.
-		wasMeshExpanded |= [self addShadowVolumeSideFrom: farStartLoc
-													  to: farEndLoc
-								   forDirectionalLightAt: lightPosition
-										 startingAtIndex: shdwVtxIdx];
+-(void) populateShadowMesh {
+	CC3ShadowVolumeBuild build;
+	[self prepareShadowBuild: &build];
+	CC3ShadowVolumeBuildRun(&build);
+	[self finishShadowBuild: &build];
+}
+
+-(CC3BackgroundTask*) precomputeShadowVolume {
+	if ( !_light || !self.shadowCaster ) return nil;
+
+	CC3ShadowVolumeBuild build;
+	[self prepareShadowBuild: &build];
+	if (build.isCacheHit) return nil;
+
+	// The background task works on its own copies of the faces, so that they remain valid
+	// even if this shadow volume is rebuilt, or the shadow caster changes, in the meantime.
+	GLuint faceCnt = build.faceCount;
+	GLuint bitWordCount = (faceCnt + 31) >> 5;
+	NSMutableData* buildData = [NSMutableData dataWithBytes: &build length: sizeof(CC3ShadowVolumeBuild)];
+	NSData* faceData = [NSData dataWithBytes: build.faces length: faceCnt * sizeof(CC3Face)];
+	NSData* planeData = [NSData dataWithBytes: build.planes length: faceCnt * sizeof(CC3Plane)];
+	NSData* neighbourData = [NSData dataWithBytes: build.neighbours length: faceCnt * sizeof(CC3FaceNeighbours)];
+	NSMutableData* litBitData = [NSMutableData dataWithLength: bitWordCount * sizeof(GLuint)];
+	NSMutableData* recordData = [NSMutableData dataWithLength: faceCnt * 4 * sizeof(GLuint)];
+	CC3FaceNeighbours* neighbours = (CC3FaceNeighbours*)build.neighbours;
+	GLuint buildCount = _shadowBuildCount;
+
+	CC3BackgroundTask* task = [CC3BackgroundTask taskWithBlock: ^(CC3BackgroundTask* aTask) {
+		CC3ShadowVolumeBuild* bgBuild = buildData.mutableBytes;
+		bgBuild->faces = faceData.bytes;
+		bgBuild->planes = planeData.bytes;
+		bgBuild->neighbours = neighbourData.bytes;
+		bgBuild->litFaceBits = litBitData.mutableBytes;
+		bgBuild->records = recordData.mutableBytes;
+		bgBuild->hasPreviousSilhouette = NO;
+		bgBuild->vertices = NULL;
+		bgBuild->vertexCapacity = 0;
+		CC3ShadowVolumeBuildRun(bgBuild);		// Classify and find terminator, but don't write
+	}];
+
+	// Once finished, if no other build has happened, and the shadow caster
+	// still has the same faces, populate the mesh from the terminator.
+	task.completionBlock = ^{
+		CC3MeshNode* scNode = self.shadowCaster;
+		if (_shadowBuildCount != buildCount || !_light ||
+			scNode.faceCount != faceCnt || scNode.mesh.faces.neighbours != neighbours) return;
+
+		[self ensureShadowBuildCapacity: faceCnt];
+		CC3ShadowVolumeBuild* bgBuild = buildData.mutableBytes;
+		memcpy(_litFaceBits, litBitData.bytes, bitWordCount * sizeof(GLuint));
+		memcpy(_silhouetteRecords, recordData.bytes, bgBuild->recordCount * sizeof(GLuint));
+		bgBuild->faces = faceData.bytes;
+		bgBuild->litFaceBits = _litFaceBits;
+		bgBuild->records = _silhouetteRecords;
+		bgBuild->neighbours = neighbours;
+		[self finishShadowBuild: bgBuild];
+		LogTrace(@"%@ precomputed shadow volume with %u terminator edges", self, _silhouetteEdgeCount);
+	};
+
+	[CC3Backgrounder.sharedBackgrounder submitTask: task];
+	return task;
+}
+
++(void) updateShadows: (id<NSFastEnumeration>) shadows withStatistics: (CC3PerformanceStatistics*) stats {
+
+	// Update each shadow, and collect the shadow volumes that need to be rebuilt.
+	// The shadow volumes are retained by the shadows collection for the duration.
+	CC3ShadowVolumeMeshNode* stackSVs[kCC3ShadowVolumeStackBuildCount];
+	CC3ShadowVolumeMeshNode** svsToBuild = stackSVs;
+	NSUInteger svCap = kCC3ShadowVolumeStackBuildCount;
+	NSUInteger svCnt = 0;
+	for (id<CC3ShadowProtocol> shadow in shadows) {
+		if ( [shadow isKindOfClass: [CC3ShadowVolumeMeshNode class]] ) {
+			CC3ShadowVolumeMeshNode* sv = (CC3ShadowVolumeMeshNode*)shadow;
+			if ( [sv checkShadowUpdate] ) {
+				if (svCnt == svCap) {
+					svCap *= 2;
+					if (svsToBuild == stackSVs) {
+						svsToBuild = malloc(svCap * sizeof(CC3ShadowVolumeMeshNode*));
+						memcpy(svsToBuild, stackSVs, svCnt * sizeof(CC3ShadowVolumeMeshNode*));
+					} else {
+						svsToBuild = realloc(svsToBuild, svCap * sizeof(CC3ShadowVolumeMeshNode*));
+					}
+				}
+				svsToBuild[svCnt++] = sv;
+			}
+		} else {
+			[shadow updateShadow];
+		}
 	}
-	
-	LogTrace(@"%@ drawing shadow volume side face for positional light", self);
-	
-	return wasMeshExpanded;
-}
 
-/** 
- * Expands the location of an terminator edge vertex in the direction away from the locational
- * light at the specified location. The vertex is moved away from the light along the vector
- * from the light to the vertex, a distance equal to the distance between the light and the
- * vertex, multiplied by the value of the shadowExpansionLimitFactor property.
- */
--(CC3Vector4) expand: (CC3Vector4) edgeLoc awayFromLocationalLightAt: (CC3Vector4) lightLoc {
-	CC3Vector4 extDir = CC3Vector4Difference(edgeLoc, lightLoc);
-	CC3Vector4 extrusion = CC3Vector4ScaleUniform(extDir, _shadowExpansionLimitFactor);
-	return CC3Vector4Add(edgeLoc, extrusion);
-}
+	if (svCnt == 0) return;
+
+	CC3ShadowVolumeBuild stackBuilds[kCC3ShadowVolumeStackBuildCount];
+	CC3ShadowVolumeBuild* builds = (svCnt <= kCC3ShadowVolumeStackBuildCount)
+										? stackBuilds
+										: malloc(svCnt * sizeof(CC3ShadowVolumeBuild));
+	memset(builds, 0, svCnt * sizeof(CC3ShadowVolumeBuild));
+	GLuint totalFaceCnt = 0;
+	for (NSUInteger svIdx = 0; svIdx < svCnt; svIdx++) {
+		[svsToBuild[svIdx] prepareShadowBuild: &builds[svIdx]];
+		totalFaceCnt += builds[svIdx].faceCount;		// Zero for shadow volumes being reused
+	}
 
-/**
- * Adds a face to the cap at the near end of the shadow volume.
- *
- * The winding order of the end-cap faces is determined from the winding order of
- * the model face, taking into consideration whether the face is lit or not.
- */
--(BOOL) addShadowVolumeCapFor: (BOOL) isFaceLit
-						 face: (CC3Vector4*) vertices
-				   forLightAt: (CC3Vector4) lightPosition
-			  startingAtIndex: (GLuint*) shdwVtxIdx {
-	
-	// Ensure the mesh has enough capacity for another triangle.
-	BOOL wasMeshExpanded = [self.mesh ensureVertexCapacity: (*shdwVtxIdx + 3)];
-	
-	// Add a single triangle face to the cap at the near end, built from the vertices
-	// of the shadow caster face at the specified index. If the face is lit, use the
-	// same winding order. If the face is dark, use the opposite winding.
-	if (isFaceLit) {
-		[_mesh setVertexHomogeneousLocation: vertices[0] at: (*shdwVtxIdx)++];
-		[_mesh setVertexHomogeneousLocation: vertices[1] at: (*shdwVtxIdx)++];
-		[_mesh setVertexHomogeneousLocation: vertices[2] at: (*shdwVtxIdx)++];
+	// Each build touches only its own structure, buffers and mesh content,
+	// so several shadow volumes with enough faces can be built concurrently.
+	if (svCnt > 1 && totalFaceCnt >= kCC3ShadowVolumeConcurrentFaceCount) {
+		dispatch_apply(svCnt, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t svIdx) {
+			CC3ShadowVolumeBuildRun(&builds[svIdx]);
+		});
 	} else {
-		[_mesh setVertexHomogeneousLocation: vertices[0] at: (*shdwVtxIdx)++];
-		[_mesh setVertexHomogeneousLocation: vertices[2] at: (*shdwVtxIdx)++];
-		[_mesh setVertexHomogeneousLocation: vertices[1] at: (*shdwVtxIdx)++];
+		for (NSUInteger svIdx = 0; svIdx < svCnt; svIdx++) CC3ShadowVolumeBuildRun(&builds[svIdx]);
 	}
 
-	LogTrace(@"%@ drawing shadow volume near %@end cap face (%@, %@, %@)",
-				  self, (CC3Vector4IsLocational(lightPosition) ? @"and far " : @""),
-				  NSStringFromCC3Vector4(vertices[0]),
-				  NSStringFromCC3Vector4(vertices[1]),
-				  NSStringFromCC3Vector4(vertices[2]));
-	
-	return wasMeshExpanded;
-}
-
-/**
- * When drawing the terminator line of the mesh, just add the two line
- * endpoints, and don't make use of infinitely extruded endpoints.
- */
--(BOOL) addTerminatorLineFrom: (CC3Vector4) edgeStartLoc
-						   to: (CC3Vector4) edgeEndLoc
-			  startingAtIndex: (GLuint*) shdwVtxIdx {
-	
-	// Ensure the mesh has enough capacity for another line
-	BOOL wasMeshExpanded = [self.mesh ensureVertexCapacity: (*shdwVtxIdx + 2)];
-	
-	// Add just the two end points of the terminator edge
-	[_mesh setVertexHomogeneousLocation: edgeStartLoc at: (*shdwVtxIdx)++];
-	[_mesh setVertexHomogeneousLocation: edgeEndLoc at: (*shdwVtxIdx)++];
-	
-	LogTrace(@"%@ drawing terminator line", self);
-	
-	return wasMeshExpanded;
+	for (NSUInteger svIdx = 0; svIdx < svCnt; svIdx++) {
+		CC3ShadowVolumeMeshNode* sv = svsToBuild[svIdx];
+		[sv finishShadowBuild: &builds[svIdx]];
+		if (sv.didReuseShadowVolume) {
+			[stats incrementShadowVolumesReused];
+		} else {
+			[stats addShadowVolumeBuildWithFacesClassified: sv.classifiedFaceCount
+										   silhouetteEdges: sv.silhouetteEdgeCount
+												  duration: sv.shadowBuildDuration];
+			if (sv.didReuseSilhouette) [stats incrementShadowSilhouettesReused];
+		}
+	}
+	if (builds != stackBuilds) free(builds);
+	if (svsToBuild != stackSVs) free(svsToBuild);
 }
 
 
@@ -652,27 +987,34 @@
 -(BOOL) isReadyToUpdate { return (_shadowLagCount == 0); }
 
 /**
- * If the shadow is ready to be updated, check if the shadow is both
- * visible and dirty, and re-populate the shadow mesh if needed.
+ * If the shadow is ready to be updated, check if the shadow is both visible and dirty,
+ * and returns whether the shadow mesh needs to be re-populated. The shadow is marked
+ * as no longer dirty, in anticipation of the shadow mesh being re-populated.
  *
  * To keep the shadow lag count synchronized across all shadow-casting nodes,
  * the shadow lag count will be reset to the value of the shadow lag factor
  * if the shadow is ready to be updated, even if it is not actually updated
  * due to it being invisible, or not dirty.
  */
--(void) updateShadow {
+-(BOOL) checkShadowUpdate {
 	LogTrace(@"Testing to update %@ with shadow lag count %i", self, _shadowLagCount);
+	BOOL needsUpdate = NO;
 	if (self.isReadyToUpdate) {
 		if (self.isShadowVisible) {
 			[self updateStencilAlgorithm];
-			if (_isShadowDirty) {
-				LogTrace(@"Updating %@", self);
-				[self populateShadowMesh];
-				_isShadowDirty = NO;
-			}
+			needsUpdate = _isShadowDirty;
+			_isShadowDirty = NO;
 		}
 		_shadowLagCount = _shadowLagFactor;
 	}
+	return needsUpdate;
+}
+
+-(void) updateShadow {
+	if ( [self checkShadowUpdate] ) {
+		LogTrace(@"Updating %@", self);
+		[self populateShadowMesh];
+	}
 }
 
 /**
@@ -1004,6 +1346,11 @@ static BOOL _shadowVolumeDefaultVisible = NO;
 	for (CC3Node* child in _children) [child prewarmForShadowVolumes];
 }
 
+-(void) precomputeShadowVolumes {
+	for (CC3ShadowVolumeMeshNode* sv in self.shadowVolumes) [sv precomputeShadowVolume];
+	for (CC3Node* child in _children) if ( !child.isShadowVolume ) [child precomputeShadowVolumes];
+}
+
 -(BOOL) isShadowVisible { return NO; }
 
 @end
@@ -1042,6 +1389,9 @@ static BOOL _shadowVolumeDefaultVisible = NO;
 
 -(id) shadowVolumeClass { return [CC3ShadowVolumeMeshNode class]; }
 
+/** The faces of a rigid mesh node change only when its vertex locations change. */
+-(GLuint) deformedFacesVersion { return _mesh.vertexLocations.contentVersion; }
+
 -(void) prewarmForShadowVolumes {
 	if (self.faceCount == 0) return;
 
@@ -1089,6 +1439,8 @@ static BOOL _shadowVolumeDefaultVisible = NO;
 	[self retainVertexBoneWeights];
 }
 
+-(GLuint) deformedFacesVersion { return self.deformedFaces.deformationVersion; }
+
 @end
 
 #pragma mark -
@@ -31,6 +31,135 @@
 
 #import "CC3Foundation.h"
 
+@class CC3PerformanceStatistics;
+
+
+#pragma mark CC3BackgroundTask
+
+/**
+ * Enumeration of the priority lanes of the CC3Backgrounder worker pool.
+ *
+ * When a worker becomes available, the oldest ready task in the highest-priority
+ * non-empty lane is run next.
+ */
+typedef enum {
+	kCC3BackgroundTaskPriorityHigh = 0,		/**< Tasks that other activity is waiting on. */
+	kCC3BackgroundTaskPriorityDefault,		/**< General background work. */
+	kCC3BackgroundTaskPriorityLow,			/**< Speculative or deferrable work. */
+	kCC3BackgroundTaskPriorityCount			/**< The number of priority lanes. */
+} CC3BackgroundTaskPriority;
+
+/** Returns a string description of the specified task priority. */
+NSString* NSStringFromCC3BackgroundTaskPriority(CC3BackgroundTaskPriority priority);
+
+/**
+ * CC3BackgroundTask is a handle on a unit of work that is run by the worker pool of
+ * the CC3Backgrounder.
+ *
+ * A task can be cancelled, can depend on other tasks, and can continue on the main
+ * thread once it has finished, by setting its completionBlock property.
+ *
+ * Tasks are created using the taskWithBlock: or taskWithBlock:withPriority: methods,
+ * configured, and then submitted to the backgrounder using the submitTask: method of
+ * the CC3Backgrounder. Dependencies must be added before the task is submitted.
+ *
+ * Tasks in the worker pool run concurrently, and must not access the OpenGL engine. Activity
+ * that requires OpenGL must be run using the runBlock: method of the CC3Backgrounder instead.
+ */
+@interface CC3BackgroundTask : NSObject {
+	void (^_block)(CC3BackgroundTask* task);
+	void (^_completionBlock)(void);
+	NSMutableArray* _dependencies;
+	NSMutableArray* _dependents;
+	NSTimeInterval _timeSubmitted;
+	GLuint _unfinishedDependencyCount;
+	CC3BackgroundTaskPriority _priority;
+	BOOL _isCancelled;
+	BOOL _isSubmitted;
+	BOOL _isExecuting;
+	BOOL _isFinished;
+}
+
+/** The priority lane in which this task will be run. */
+@property(nonatomic, readonly) CC3BackgroundTaskPriority priority;
+
+/**
+ * A block of code to run on the main thread once this task has finished running.
+ *
+ * The completion block is not run if the task was cancelled.
+ *
+ * This property must be set before the task is submitted to the backgrounder.
+ * The initial value of this property is nil.
+ */
+@property(nonatomic, copy) void (^completionBlock)(void);
+
+/** The tasks on which this task depends. */
+@property(nonatomic, readonly) NSArray* dependencies;
+
+/**
+ * Adds the specified task as a dependency of this task. This task will not be run until
+ * the specified task has finished running. If the specified task is cancelled, this task
+ * is cancelled as well, and will not be run.
+ *
+ * The specified task must also be submitted to the backgrounder. Dependencies must be added
+ * before this task is submitted to the backgrounder.
+ */
+-(void) addDependency: (CC3BackgroundTask*) task;
+
+/**
+ * Cancels this task.
+ *
+ * If this task has not yet started running, it will not be run. If this task is already
+ * running, the running block can test the value of the isCancelled property periodically,
+ * and stop early. In either case, the completionBlock will not be run.
+ *
+ * Cancellation propagates to any tasks that depend on this task, which are cancelled in turn
+ * when this task is removed from the worker pool, so that work never runs after a prerequisite
+ * has been abandoned. A running task can cancel itself to indicate that it has failed, so that
+ * the tasks that depend on its results are not run.
+ */
+-(void) cancel;
+
+/** Returns whether this task has been cancelled. */
+@property(nonatomic, readonly) BOOL isCancelled;
+
+/** Returns whether this task has been submitted to the backgrounder. */
+@property(nonatomic, readonly) BOOL isSubmitted;
+
+/** Returns whether this task is currently running. */
+@property(nonatomic, readonly) BOOL isExecuting;
+
+/** Returns whether this task has finished running, or was cancelled before it was run. */
+@property(nonatomic, readonly) BOOL isFinished;
+
+
+#pragma mark Allocation and initialization
+
+/**
+ * Initializes this instance to run the specified block at the specified priority.
+ *
+ * The block is passed this task when it is run, so that it can test whether it has been cancelled.
+ */
+-(id) initWithBlock: (void (^)(CC3BackgroundTask* task)) block withPriority: (CC3BackgroundTaskPriority) priority;
+
+/**
+ * Allocates and initializes an autoreleased instance to run the specified block at the
+ * specified priority.
+ *
+ * The block is passed this task when it is run, so that it can test whether it has been cancelled.
+ */
++(id) taskWithBlock: (void (^)(CC3BackgroundTask* task)) block withPriority: (CC3BackgroundTaskPriority) priority;
+
+/**
+ * Allocates and initializes an autoreleased instance to run the specified block at
+ * kCC3BackgroundTaskPriorityDefault priority.
+ *
+ * The block is passed this task when it is run, so that it can test whether it has been cancelled.
+ */
++(id) taskWithBlock: (void (^)(CC3BackgroundTask* task)) block;
+
+@end
+
 
 #pragma mark CC3Backgrounder
 
@@ -44,9 +173,26 @@
  * from which the tasks are queued. This behaviour can be useful when loading OpenGL objects
  * that need to be subsequently deleted. It is important that OpenGL objects are deleted
  * from the same thread on which they are loaded.
+ *
+ * Because there is a single background OpenGL context, tasks submitted using the runBlock:
+ * methods are run one at a time, in the order in which they were submitted. In addition,
+ * CC3Backgrounder manages a pool of workers that run CC3BackgroundTasks concurrently.
+ * Worker pool tasks are selected by priority, can be cancelled, can depend on other tasks,
+ * and can continue on the main thread when done, but must not access the OpenGL engine.
+ * Resource loaders can use the worker pool to fan out CPU-intensive work, such as decoding
+ * images or parsing files, and then use the runBlock: method to submit the resulting content
+ * to the OpenGL engine.
  */
 @interface CC3Backgrounder : NSObject {
 	dispatch_queue_t _taskQueue;
+	dispatch_queue_t _schedulerQueue;
+	NSMutableArray* _readyTasks[kCC3BackgroundTaskPriorityCount];
+	NSUInteger _workerCount;
+	NSUInteger _runningTaskCount;
+	volatile NSUInteger _taskQueueDepth;
+	volatile uint32_t _tasksStartedSinceCollection;
+	volatile uint64_t _taskLatencySinceCollection;
+	volatile uint64_t _peakTaskLatencySinceCollection;
 	long _queuePriority;
 	BOOL _shouldRunTasksOnRequestingThread : 1;
 }
@@ -93,6 +239,77 @@
  */
 -(void) runBlock: (void (^)(void))block after: (NSTimeInterval) seconds;
 
+
+#pragma mark Worker pool
+
+/**
+ * The maximum number of worker pool tasks that may run concurrently.
+ *
+ * Changing this property does not affect tasks that are already running.
+ *
+ * The initial value of this property is the number of active processors on the device.
+ */
+@property(nonatomic, assign) NSUInteger workerCount;
+
+/**
+ * Submits the specified task to the worker pool.
+ *
+ * The task will be run once all of its dependencies have finished, and a worker is available.
+ * If any of its dependencies has been cancelled, the task is cancelled, and is not run.
+ * Ready tasks are run in order of priority, and in the order they were submitted within each
+ * priority lane. Once the task has finished, its completionBlock, if set, is run on the main thread.
+ *
+ * If the value of the shouldRunTasksOnRequestingThread property is YES, the task, and its
+ * completion block, are run immediately on the current thread. In that case, all dependencies
+ * of the task must already have finished.
+ *
+ * A task may only be submitted once.
+ */
+-(void) submitTask: (CC3BackgroundTask*) task;
+
+/**
+ * Convenience method that creates a task to run the specified block at the specified priority,
+ * submits it to the worker pool using the submitTask: method, and returns the task, which can
+ * be used to cancel the task, or as a dependency of other tasks.
+ */
+-(CC3BackgroundTask*) runTask: (void (^)(CC3BackgroundTask* task)) block
+				 withPriority: (CC3BackgroundTaskPriority) priority;
+
+/**
+ * Convenience method that creates a task to run the specified block at the specified priority
+ * once all of the CC3BackgroundTasks in the specified dependencies array have finished, and
+ * to run the specified completion block on the main thread once the task has finished.
+ * The new task is submitted to the worker pool using the submitTask: method, and returned.
+ *
+ * The dependencies and completion block may be nil.
+ */
+-(CC3BackgroundTask*) runTask: (void (^)(CC3BackgroundTask* task)) block
+				 withPriority: (CC3BackgroundTaskPriority) priority
+				  dependingOn: (NSArray*) dependencies
+				 onCompletion: (void (^)(void)) completionBlock;
+
+/**
+ * Returns the number of worker pool tasks that have been submitted, but have not yet finished.
+ * This includes tasks that are running, tasks that are ready to run, and tasks that are waiting
+ * for their dependencies to finish.
+ */
+@property(nonatomic, readonly) NSUInteger taskQueueDepth;
+
+/**
+ * Adds the current queue depth, and the latency of the worker pool tasks that have started
+ * since the previous invocation of this method, to the specified performance statistics.
+ * Task latency is the time between when a task is submitted, and when it starts running.
+ *
+ * The latency counters are published atomically by the worker pool scheduler, and this
+ * method reads and resets them without waiting on the scheduler, so it does not block the
+ * rendering thread while tasks are being scheduled.
+ *
+ * This method is invoked automatically on each update of a CC3Scene whose performanceStatistics
+ * property is set. If more than one scene is collecting statistics, the task latencies will be
+ * collected by whichever scene is updated first.
+ */
+-(void) collectStatisticsInto: (CC3PerformanceStatistics*) stats;
+
 /**
  * Indicates that tasks should be run on the same thread as the invocator of the task requests.
  *
@@ -31,10 +31,96 @@
 
 #import "CC3Backgrounder.h"
 #import "CC3OpenGL.h"
+#import "CC3PerformanceStatistics.h"
 
 /** The default backgrounder task queue name. */
 #define kCC3BackgrounderDefaultTaskQueueName	"org.cocos3d.backgrounder.default"
 
+/** The backgrounder worker pool scheduling queue name. */
+#define kCC3BackgrounderSchedulerQueueName		"org.cocos3d.backgrounder.scheduler"
+
+
+#pragma mark CC3BackgroundTask
+
+NSString* NSStringFromCC3BackgroundTaskPriority(CC3BackgroundTaskPriority priority) {
+	switch (priority) {
+		case kCC3BackgroundTaskPriorityHigh: return @"kCC3BackgroundTaskPriorityHigh";
+		case kCC3BackgroundTaskPriorityDefault: return @"kCC3BackgroundTaskPriorityDefault";
+		case kCC3BackgroundTaskPriorityLow: return @"kCC3BackgroundTaskPriorityLow";
+		default: return [NSString stringWithFormat: @"Unknown task priority (%u)", priority];
+	}
+}
+
+@implementation CC3BackgroundTask
+
+@synthesize priority=_priority, completionBlock=_completionBlock, dependencies=_dependencies;
+@synthesize isCancelled=_isCancelled, isSubmitted=_isSubmitted;
+@synthesize isExecuting=_isExecuting, isFinished=_isFinished;
+
+-(void) dealloc {
+	[_block release];
+	[_completionBlock release];
+	[_dependencies release];
+	[_dependents release];
+	[super dealloc];
+}
+
+-(void) addDependency: (CC3BackgroundTask*) task {
+	CC3Assert( !_isSubmitted, @"%@ cannot add a dependency after it has been submitted.", self);
+	CC3Assert(task != self, @"%@ cannot depend on itself.", self);
+	if ( !task ) return;
+	if ( !_dependencies ) _dependencies = [NSMutableArray new];		// retained
+	[_dependencies addObject: task];
+}
+
+-(void) cancel { _isCancelled = YES; }
+
+/** Runs the block of this task within an autorelease pool, unless this task has been cancelled. */
+-(void) run {
+	if (_isCancelled) return;
+	_isExecuting = YES;
+	CC3TraceBegin("CC3BackgroundTask", "backgrounder", NULL);
+	@autoreleasepool { _block(self); }
+	CC3TraceEnd("CC3BackgroundTask", "backgrounder");
+	_isExecuting = NO;
+}
+
+
+#pragma mark Allocation and initialization
+
+-(id) initWithBlock: (void (^)(CC3BackgroundTask* task)) block withPriority: (CC3BackgroundTaskPriority) priority {
+	CC3Assert(block, @"%@ requires a block to run.", self.class);
+	if ( (self = [super init]) ) {
+		_block = [block copy];
+		_completionBlock = nil;
+		_dependencies = nil;
+		_dependents = nil;
+		_timeSubmitted = 0.0;
+		_unfinishedDependencyCount = 0;
+		_priority = CLAMP(priority, kCC3BackgroundTaskPriorityHigh, kCC3BackgroundTaskPriorityLow);
+		_isCancelled = NO;
+		_isSubmitted = NO;
+		_isExecuting = NO;
+		_isFinished = NO;
+	}
+	return self;
+}
+
++(id) taskWithBlock: (void (^)(CC3BackgroundTask* task)) block withPriority: (CC3BackgroundTaskPriority) priority {
+	return [[[self alloc] initWithBlock: block withPriority: priority] autorelease];
+}
+
++(id) taskWithBlock: (void (^)(CC3BackgroundTask* task)) block {
+	return [self taskWithBlock: block withPriority: kCC3BackgroundTaskPriorityDefault];
+}
+
+-(NSString*) description {
+	return [NSString stringWithFormat: @"%@ %p at %@%@", self.class, self,
+			NSStringFromCC3BackgroundTaskPriority(_priority), (_isCancelled ? @" (cancelled)" : @"")];
+}
+
+@end
+
 
 #pragma mark CC3Backgrounder
 
@@ -44,6 +130,7 @@
 
 -(void) dealloc {
 	[self deleteTaskQueue];
+	[self deleteWorkerPool];
 	[super dealloc];
 }
 
@@ -100,7 +187,195 @@
 	}
 }
 
--(void) runBlockNow: (void (^)(void)) block { @autoreleasepool { block(); } }
+-(void) runBlockNow: (void (^)(void)) block {
+	CC3TraceBegin("CC3Backgrounder runBlock", "backgrounder", NULL);
+	@autoreleasepool { block(); }
+	CC3TraceEnd("CC3Backgrounder runBlock", "backgrounder");
+}
+
+
+#pragma mark Worker pool
+
+-(NSUInteger) workerCount { return _workerCount; }
+
+-(void) setWorkerCount: (NSUInteger) workerCount {
+	dispatch_async(_schedulerQueue, ^{
+		_workerCount = MAX(workerCount, 1);
+		[self dispatchReadyTasks];
+	});
+}
+
+-(NSUInteger) taskQueueDepth { return _taskQueueDepth; }
+
+/** Initialize the worker pool scheduling queue and priority lanes. */
+-(void) initWorkerPool {
+	_schedulerQueue = dispatch_queue_create(kCC3BackgrounderSchedulerQueueName, NULL);
+	for (NSUInteger pIdx = 0; pIdx < kCC3BackgroundTaskPriorityCount; pIdx++)
+		_readyTasks[pIdx] = [NSMutableArray new];		// retained
+	_workerCount = MAX(NSProcessInfo.processInfo.activeProcessorCount, 1);
+	_runningTaskCount = 0;
+	_taskQueueDepth = 0;
+	_tasksStartedSinceCollection = 0;
+	_taskLatencySinceCollection = 0;
+	_peakTaskLatencySinceCollection = 0;
+}
+
+/** Delete the worker pool scheduling queue and priority lanes. */
+-(void) deleteWorkerPool {
+	dispatch_release(_schedulerQueue);
+	_schedulerQueue = NULL;
+	for (NSUInteger pIdx = 0; pIdx < kCC3BackgroundTaskPriorityCount; pIdx++) {
+		[_readyTasks[pIdx] release];
+		_readyTasks[pIdx] = nil;
+	}
+}
+
+/** Returns the GCD global queue priority that corresponds to the specified task priority. */
+static long CC3DispatchQueuePriorityFromTaskPriority(CC3BackgroundTaskPriority priority) {
+	switch (priority) {
+		case kCC3BackgroundTaskPriorityHigh: return DISPATCH_QUEUE_PRIORITY_HIGH;
+		case kCC3BackgroundTaskPriorityLow: return DISPATCH_QUEUE_PRIORITY_LOW;
+		default: return DISPATCH_QUEUE_PRIORITY_DEFAULT;
+	}
+}
+
+-(void) submitTask: (CC3BackgroundTask*) task {
+	CC3Assert( !task.isSubmitted, @"%@ has already been submitted.", task);
+	task->_isSubmitted = YES;
+	task->_timeSubmitted = NSDate.timeIntervalSinceReferenceDate;
+
+	if (_shouldRunTasksOnRequestingThread) {
+		for (CC3BackgroundTask* dep in task.dependencies) if (dep.isCancelled) [task cancel];
+		[task run];
+		task->_isFinished = YES;
+		if (task.completionBlock && !task.isCancelled) task.completionBlock();
+		return;
+	}
+
+	[task retain];		// Released when the task has finished
+	dispatch_async(_schedulerQueue, ^{
+		_taskQueueDepth++;
+
+		// Register as a dependent of each dependency that has not yet finished.
+		// If a dependency has already been cancelled, this task is cancelled too.
+		for (CC3BackgroundTask* dep in task.dependencies) {
+			if (dep.isFinished) {
+				if (dep.isCancelled) [task cancel];
+				continue;
+			}
+			if ( !dep->_dependents ) dep->_dependents = [NSMutableArray new];		// retained
+			[dep->_dependents addObject: task];
+			task->_unfinishedDependencyCount++;
+		}
+
+		if (task->_unfinishedDependencyCount == 0) [_readyTasks[task.priority] addObject: task];
+		[self dispatchReadyTasks];
+	});
+}
+
+/** Returns the oldest ready task in the highest priority lane, removing it from that lane. Runs on the scheduler queue. */
+-(CC3BackgroundTask*) dequeueReadyTask {
+	for (NSUInteger pIdx = 0; pIdx < kCC3BackgroundTaskPriorityCount; pIdx++) {
+		NSMutableArray* lane = _readyTasks[pIdx];
+		if (lane.count) {
+			CC3BackgroundTask* task = [[lane objectAtIndex: 0] retain];
+			[lane removeObjectAtIndex: 0];
+			return [task autorelease];
+		}
+	}
+	return nil;
+}
+
+/** Dispatches ready tasks to workers, while workers are available. Runs on the scheduler queue. */
+-(void) dispatchReadyTasks {
+	while (_runningTaskCount < _workerCount) {
+		CC3BackgroundTask* task = [self dequeueReadyTask];
+		if ( !task ) return;
+
+		// Cancelled tasks are not run, but must still be finished, to release their dependents.
+		if (task.isCancelled) {
+			[self finishTask: task];
+			continue;
+		}
+
+		// Publish the latency counters atomically, so collectStatisticsInto: can read them from any thread
+		uint64_t latency = (uint64_t)((NSDate.timeIntervalSinceReferenceDate - task->_timeSubmitted) * 1.0e6);
+		__sync_fetch_and_add(&_tasksStartedSinceCollection, 1);
+		__sync_fetch_and_add(&_taskLatencySinceCollection, latency);
+		uint64_t peakLatency;
+		do {
+			peakLatency = _peakTaskLatencySinceCollection;
+			if (latency <= peakLatency) break;
+		} while ( !__sync_bool_compare_and_swap(&_peakTaskLatencySinceCollection, peakLatency, latency) );
+
+		_runningTaskCount++;
+		dispatch_async(dispatch_get_global_queue(CC3DispatchQueuePriorityFromTaskPriority(task.priority), 0), ^{
+			[task run];
+			dispatch_async(_schedulerQueue, ^{
+				_runningTaskCount--;
+				[self finishTask: task];
+				[self dispatchReadyTasks];
+			});
+		});
+	}
+}
+
+/**
+ * Marks the specified task as finished, makes ready any dependent tasks that are no longer
+ * waiting on dependencies, and runs the completion block on the main thread.
+ *
+ * If the specified task was cancelled, its dependents are cancelled too. Since cancelled
+ * tasks are finished without being run, the cancellation cascades through the dependency graph.
+ * Runs on the scheduler queue.
+ */
+-(void) finishTask: (CC3BackgroundTask*) task {
+	task->_isFinished = YES;
+	_taskQueueDepth--;
+
+	BOOL isCancelled = task.isCancelled;
+	for (CC3BackgroundTask* dependent in task->_dependents) {
+		if (isCancelled) [dependent cancel];
+		if (--dependent->_unfinishedDependencyCount == 0) [_readyTasks[dependent.priority] addObject: dependent];
+	}
+	[task->_dependents release];
+	task->_dependents = nil;
+
+	void (^completionBlock)(void) = task.completionBlock;
+	if (completionBlock && !isCancelled)
+		dispatch_async(dispatch_get_main_queue(), ^{ [self runBlockNow: completionBlock]; });
+
+	[task release];		// Retained when submitted
+}
+
+-(CC3BackgroundTask*) runTask: (void (^)(CC3BackgroundTask* task)) block
+				 withPriority: (CC3BackgroundTaskPriority) priority {
+	return [self runTask: block withPriority: priority dependingOn: nil onCompletion: nil];
+}
+
+-(CC3BackgroundTask*) runTask: (void (^)(CC3BackgroundTask* task)) block
+				 withPriority: (CC3BackgroundTaskPriority) priority
+				  dependingOn: (NSArray*) dependencies
+				 onCompletion: (void (^)(void)) completionBlock {
+	CC3BackgroundTask* task = [CC3BackgroundTask taskWithBlock: block withPriority: priority];
+	for (CC3BackgroundTask* dep in dependencies) [task addDependency: dep];
+	task.completionBlock = completionBlock;
+	[self submitTask: task];
+	return task;
+}
+
+-(void) collectStatisticsInto: (CC3PerformanceStatistics*) stats {
+	if ( !stats ) return;
+	[stats addBackgroundTaskQueueDepth: (GLuint)_taskQueueDepth];
+
+	// Swap each counter with zero, without waiting on the scheduler queue. A task that starts
+	// between the swaps is attributed partly to this collection and partly to the next.
+	GLuint taskCount = __sync_lock_test_and_set(&_tasksStartedSinceCollection, 0);
+	uint64_t totalLatency = __sync_lock_test_and_set(&_taskLatencySinceCollection, 0);
+	uint64_t peakLatency = __sync_lock_test_and_set(&_peakTaskLatencySinceCollection, 0);
+	if (taskCount) [stats addBackgroundTasksStarted: taskCount
+										withLatency: (totalLatency / 1.0e6)
+									 andPeakLatency: (peakLatency / 1.0e6)];
+}
 
 
 #pragma mark Allocation and initialization
@@ -115,6 +390,7 @@
 		
 		[self initTaskQueue];
 		[self initQueuePriority];
+		[self initWorkerPool];
 	}
 	return self;
 }
@@ -48,11 +48,62 @@
 /** A unique name to be used by the cache to store and retrieve this object. */
 @property(nonatomic, retain, readonly) NSString* name;
 
+@optional
+
+/**
+ * Returns the approximate number of bytes of memory held by this object.
+ *
+ * A cache reads the value of this property when this object is added to the cache, and uses
+ * it to track the residentBytes of the cache, and to enforce the byteBudget of the cache.
+ * The cache re-reads this property whenever it checks its byteBudget, and when notified of
+ * a change using the updateCostOfObject: method of the cache.
+ *
+ * Objects that do not implement this property are assigned a cost of zero.
+ */
+@property(nonatomic, readonly) NSUInteger cacheCost;
+
+/**
+ * Returns the number of bytes of application (CPU) memory held by this object.
+ *
+ * This property is read by the memoryFootprint method of the cache. Objects that do not
+ * implement this property are reported as holding no application memory.
+ */
+@property(nonatomic, readonly) NSUInteger applicationMemoryBytes;
+
+/**
+ * Returns an estimate of the number of bytes of GL (GPU) memory held by this object.
+ *
+ * This property is read by the memoryFootprint method of the cache. Objects that do not
+ * implement this property are reported as holding no GL memory.
+ */
+@property(nonatomic, readonly) NSUInteger glMemoryBytes;
+
 @end
 
 
 #pragma mark CC3Cache
 
+/** The number of independently locked shards into which the contents of each CC3Cache are divided. */
+#define kCC3CacheShardCount		16
+
+/**
+ * A single partition of the contents of a CC3Cache.
+ *
+ * The entries are held in an immutable dictionary, which is read without locking. Changes are
+ * made to a copy of the dictionary, while holding the write lock, and the copy then replaces
+ * the original. The original is released once no reader that started before the replacement
+ * is still using it. Readers register in one of two counts, selected by the epoch in which they
+ * started, so that a writer only waits for readers that may still be using the original.
+ */
+typedef struct {
+	pthread_mutex_t writeLock;					/**< The lock serializing changes to the entries. */
+	NSDictionary* volatile entriesByName;		/**< The entries in this shard, keyed by name. */
+	volatile int32_t readerCounts[2];			/**< The number of active readers in each epoch. */
+	volatile uint32_t epoch;					/**< Incremented each time the entries are replaced. */
+} CC3CacheShard;
+
+@class CC3CacheEntry;
+
 /**
  * Instances of CC3Cache hold cachable objects, which are stored and retrieved by name.
  *
@@ -62,14 +113,31 @@
  * first remove the existing object from the cache.
  *
  * CC3Cache implements the NSLocking protocol, and all access to the cache contents is thread-safe.
+ * The contents are divided by name across a number of shards. Retrieving an object takes no lock.
+ * Each shard publishes its contents as an immutable dictionary, which is replaced whenever an object
+ * is added to, or removed from, the shard. Lookups from the rendering thread therefore never wait
+ * for each other, or for background loaders that are adding objects. Changes to each shard are
+ * serialized by a lock, and the NSLocking methods block all changes, but not lookups.
  *
  * Each object may be held either strongly or weakly by this cache, depending on the value
  * of the isWeak property at the time the object was added to the cache.
+ *
+ * The memory held by the cache can be limited by setting the byteBudget property. See the notes
+ * of that property for how the budget applies to strongly and weakly cached objects.
  */
 @interface CC3Cache : NSObject <NSLocking> {
-	NSMutableDictionary* _objectsByName;
+	CC3CacheShard _shards[kCC3CacheShardCount];
 	NSString* _typeName;
-	pthread_mutex_t _mutex;
+	NSUInteger _byteBudget;
+	volatile int64_t _residentBytes;
+	volatile int64_t _accessClock;
+	volatile int64_t _hitCount;
+	volatile int64_t _missCount;
+	volatile int64_t _evictionCount;
+	pthread_mutex_t _evictionMutex;
+	CC3CacheEntry** _lruEntries;
+	NSUInteger _lruCount;
+	NSUInteger _lruCapacity;
 	BOOL _isWeak : 1;
 }
 
@@ -163,6 +231,98 @@
 @property(nonatomic, assign) BOOL isWeak;
 
 
+#pragma mark Memory budget and statistics
+
+/**
+ * The maximum number of bytes that the objects in this cache should occupy, as determined by
+ * the cacheCost property of each object.
+ *
+ * While this cache has a budget, it also retains each weakly cached object when the object is
+ * added to this cache, or retrieved from it. Recently used weakly cached objects, such as textures
+ * that are loaded and released repeatedly, therefore remain in this cache, within the budget,
+ * after they have been released everywhere else.
+ *
+ * Whenever an object is added to this cache, the cost of each object in this cache is refreshed,
+ * and if the residentBytes property exceeds the value of this property, objects are released in
+ * least-recently-used order, until the residentBytes property is within this budget. Strongly
+ * cached objects are removed from this cache. Weakly cached objects are released by this cache,
+ * and remain in this cache for as long as they are retained elsewhere. Weakly cached objects that
+ * this cache is not retaining cannot be released, but their cost is included in the value of the
+ * residentBytes property. The same occurs when the updateCostOfObject: method reports that the
+ * cost of an object has grown. An object is never evicted by its own addition, or by a change to
+ * its own cost. The objects are kept in a heap, ordered by their most recent use, so evicting an
+ * object takes logarithmic time, regardless of the number of objects in this cache.
+ *
+ * Setting this property to a value lower than the current value of the residentBytes property
+ * immediately releases objects to bring the cache within the new budget. Setting this property
+ * to zero releases all weakly cached objects that are retained by this cache.
+ *
+ * The initial value of this property is zero, indicating that this cache has no budget,
+ * that objects will never be evicted, and that weakly cached objects are never retained.
+ */
+@property(nonatomic, assign) NSUInteger byteBudget;
+
+/**
+ * The total cacheCost of all objects in this cache, as of when each object was added, or its
+ * cost was most recently refreshed.
+ */
+@property(nonatomic, readonly) NSUInteger residentBytes;
+
+/**
+ * Notifies this cache that the cacheCost of the specified object may have changed, such as when
+ * content is loaded into the GL engine, or a mipmap is generated.
+ *
+ * The cost of the object is re-read, the residentBytes property is adjusted accordingly, and if
+ * the cache is now over its byteBudget, other objects are evicted. The specified object itself is
+ * not evicted. Does nothing if the specified object is not in this cache.
+ */
+-(void) updateCostOfObject: (id<CC3Cacheable>) obj;
+
+/** The number of objects in this cache. */
+@property(nonatomic, readonly) NSUInteger objectCount;
+
+/**
+ * The number of times the getObjectNamed: method has found the requested object,
+ * since this cache was created, or the resetStatistics method was last invoked.
+ */
+@property(nonatomic, readonly) NSUInteger hitCount;
+
+/**
+ * The number of times the getObjectNamed: method did not find the requested object,
+ * since this cache was created, or the resetStatistics method was last invoked.
+ */
+@property(nonatomic, readonly) NSUInteger missCount;
+
+/**
+ * The fraction of requests made to the getObjectNamed: method that found the requested object,
+ * calculated by dividing the hitCount property by the sum of the hitCount and missCount properties.
+ */
+@property(nonatomic, readonly) GLfloat hitRate;
+
+/**
+ * The number of objects that have been evicted from this cache to keep it within its byteBudget,
+ * since this cache was created, or the resetStatistics method was last invoked.
+ */
+@property(nonatomic, readonly) NSUInteger evictionCount;
+
+/** Resets the hitCount, missCount and evictionCount properties to zero. */
+-(void) resetStatistics;
+
+/** Returns a description of the contents, memory usage and effectiveness of this cache. */
+-(NSString*) statisticsDescription;
+
+/**
+ * Returns a breakdown of the memory held by the objects in this cache, as a dictionary
+ * that can be serialized to JSON using NSJSONSerialization.
+ *
+ * The dictionary contains the typeName, objectCount, residentBytes and byteBudget of this
+ * cache, the total applicationMemoryBytes and glMemoryBytes of the objects in this cache, and
+ * an array containing the name, class, applicationMemoryBytes and glMemoryBytes of each object,
+ * ordered from the object holding the most memory to the object holding the least.
+ */
+-(NSDictionary*) memoryFootprint;
+
+
 #pragma mark Allocation and initialization
 
 /** 
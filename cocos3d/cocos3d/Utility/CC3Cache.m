@@ -30,16 +30,145 @@
  */
 
 #import "CC3Cache.h"
+#import <sched.h>
+
+
+#pragma mark CC3CacheEntry
+
+/** Holds a cached object, together with the cost and recency information used for eviction. */
+@interface CC3CacheEntry : NSObject {
+@public
+	id _wrap;
+	NSString* _name;
+	NSUInteger _cost;
+	volatile int64_t _lastAccess;
+	int64_t _lruStamp;
+	NSUInteger _lruIndex;
+	id volatile _heldObject;
+	volatile BOOL _isRemoved;
+	BOOL _isWeak : 1;
+}
+@end
+
+@implementation CC3CacheEntry
+
+-(void) dealloc {
+	[_wrap release];
+	[_name release];
+	[_heldObject release];
+	[super dealloc];
+}
+
+-(id) initWithObject: (id<CC3Cacheable>) obj asWeak: (BOOL) isWeak {
+	if ( (self = [super init]) ) {
+		// If this is a weak entry, wrap the object in an NSValue weakly.
+		_wrap = [(isWeak ? [obj asWeakReference] : obj) retain];		// retained
+		_name = [obj.name retain];										// retained
+		_cost = [obj respondsToSelector: @selector(cacheCost)] ? obj.cacheCost : 0;
+		_lastAccess = 0;
+		_lruStamp = 0;
+		_lruIndex = NSNotFound;
+		_heldObject = nil;
+		_isRemoved = NO;
+		_isWeak = isWeak;
+	}
+	return self;
+}
+
+@end
+
+
+#pragma mark CC3CacheShard
+
+/**
+ * Begins a lock-free read of the entries of the specified shard, and returns the reader slot
+ * to pass to CC3CacheShardEndRead. Between the two calls, the entries dictionary of the shard
+ * is guaranteed not to be deallocated, even if a writer replaces it.
+ *
+ * The reader registers in the slot of the current epoch. If a writer changes the epoch before
+ * the registration is visible, the writer may not wait for this reader, so the reader retries.
+ */
+static inline uint32_t CC3CacheShardBeginRead(CC3CacheShard* shard) {
+	while (YES) {
+		uint32_t epoch = shard->epoch;
+		uint32_t slot = epoch & 1;
+		__sync_add_and_fetch(&shard->readerCounts[slot], 1);
+		if (shard->epoch == epoch) return slot;
+		__sync_sub_and_fetch(&shard->readerCounts[slot], 1);
+	}
+}
+
+/** Ends a lock-free read of the entries of the specified shard, started by CC3CacheShardBeginRead. */
+static inline void CC3CacheShardEndRead(CC3CacheShard* shard, uint32_t slot) {
+	__sync_sub_and_fetch(&shard->readerCounts[slot], 1);
+}
+
+/**
+ * Replaces the entries of the specified shard, whose write lock must be held, with the specified
+ * dictionary, which is retained by the caller and must not be modified afterwards. Readers that
+ * began before the replacement may still be using the previous dictionary, so this function waits
+ * for them to finish, then autoreleases the previous dictionary, so that the removed entries, and
+ * any objects they hold, are released outside of the lock.
+ */
+static void CC3CacheShardPublish(CC3CacheShard* shard, NSDictionary* entries) {
+	NSDictionary* oldEntries = shard->entriesByName;
+	__sync_synchronize();
+	shard->entriesByName = entries;
+	uint32_t oldSlot = __sync_fetch_and_add(&shard->epoch, 1) & 1;
+	while (shard->readerCounts[oldSlot] > 0) sched_yield();
+	[oldEntries autorelease];
+}
+
+
+#pragma mark CC3Cache LRU heap
+
+/** Swaps the entries at the specified indices of the specified LRU heap. */
+static inline void CC3CacheLRUSwap(CC3CacheEntry** heap, NSUInteger idx1, NSUInteger idx2) {
+	CC3CacheEntry* entry = heap[idx1];
+	heap[idx1] = heap[idx2];
+	heap[idx2] = entry;
+	heap[idx1]->_lruIndex = idx1;
+	heap[idx2]->_lruIndex = idx2;
+}
+
+/** Moves the entry at the specified index toward the root of the LRU heap, to restore heap order. */
+static void CC3CacheLRUSiftUp(CC3CacheEntry** heap, NSUInteger idx) {
+	while (idx > 0) {
+		NSUInteger parentIdx = (idx - 1) / 2;
+		if (heap[parentIdx]->_lruStamp <= heap[idx]->_lruStamp) return;
+		CC3CacheLRUSwap(heap, idx, parentIdx);
+		idx = parentIdx;
+	}
+}
+
+/** Moves the entry at the specified index away from the root of the LRU heap, to restore heap order. */
+static void CC3CacheLRUSiftDown(CC3CacheEntry** heap, NSUInteger count, NSUInteger idx) {
+	while (YES) {
+		NSUInteger minIdx = idx;
+		NSUInteger childIdx = (2 * idx) + 1;
+		if (childIdx < count && heap[childIdx]->_lruStamp < heap[minIdx]->_lruStamp) minIdx = childIdx;
+		childIdx++;
+		if (childIdx < count && heap[childIdx]->_lruStamp < heap[minIdx]->_lruStamp) minIdx = childIdx;
+		if (minIdx == idx) return;
+		CC3CacheLRUSwap(heap, idx, minIdx);
+		idx = minIdx;
+	}
+}
 
 
 #pragma mark CC3Cache
 
 @implementation CC3Cache
 
-@synthesize isWeak=_isWeak, typeName=_typeName;
+@synthesize isWeak=_isWeak, typeName=_typeName, byteBudget=_byteBudget;
 
 -(void) dealloc {
-	[_objectsByName release];
+	[self releaseHeldObjects];
+	for (NSUInteger sIdx = 0; sIdx < kCC3CacheShardCount; sIdx++) {
+		[_shards[sIdx].entriesByName release];
+		pthread_mutex_destroy(&_shards[sIdx].writeLock);
+	}
+	free(_lruEntries);
 	[_typeName release];
 	
 	[self deleteLock];
@@ -47,82 +176,182 @@
 	[super dealloc];
 }
 
+/** Returns the shard that holds the object with the specified name. */
+-(CC3CacheShard*) shardForName: (NSString*) name {
+	return &_shards[name.hash % kCC3CacheShardCount];
+}
+
+/**
+ * Returns the current entries of the specified shard, read without locking. The returned
+ * dictionary is autoreleased, and remains valid even if the shard is changed.
+ */
+-(NSDictionary*) entriesOfShard: (CC3CacheShard*) shard {
+	uint32_t slot = CC3CacheShardBeginRead(shard);
+	NSDictionary* entries = [shard->entriesByName retain];
+	CC3CacheShardEndRead(shard, slot);
+	return [entries autorelease];
+}
+
+/** Returns the entry with the specified name, read without locking, or nil if there is no such entry. */
+-(CC3CacheEntry*) entryNamed: (NSString*) name {
+	CC3CacheShard* shard = [self shardForName: name];
+	uint32_t slot = CC3CacheShardBeginRead(shard);
+	CC3CacheEntry* entry = [[shard->entriesByName objectForKey: name] retain];
+	CC3CacheShardEndRead(shard, slot);
+	return [entry autorelease];
+}
+
 -(void) addObject: (id<CC3Cacheable>) obj {
 	if ( !obj ) return;
 	NSString* objName = obj.name;
 	CC3Assert(objName, @"%@ cannot be added to the %@ cache because its name property is nil.", obj, _typeName);
-	CC3Assert( ![self getObjectNamed: objName], @"%@ cannot be added to the %@ cache because the"
+	CC3Assert( ![[self wrapperNamed: objName] resolveWeakReference], @"%@ cannot be added to the %@ cache because the"
 			  @" cache already contains a %@ named %@. Remove it first before adding another.",
 			  obj, _typeName, _typeName, objName);
 
-	// If this is a weak cache, wrap the object in an NSValue weakly.
-	id wrap = _isWeak ? [obj asWeakReference] : obj;
+	// Any entry remaining under the name holds an object that has been deallocated. Remove it,
+	// so that its cost is no longer counted, and it is no longer a candidate for eviction.
+	[self removeObjectNamed: objName];
 
-	[self lock];
-	[_objectsByName setObject: wrap forKey: objName];
-	[self unlock];
+	CC3CacheEntry* entry = [[CC3CacheEntry alloc] initWithObject: obj asWeak: _isWeak];
+	entry->_lastAccess = __sync_add_and_fetch(&_accessClock, 1);
+	if (_isWeak && _byteBudget) entry->_heldObject = [obj retain];	// Recently used, so hold within budget
+
+	// Count the cost before the entry becomes visible, so that a concurrent
+	// cost refresh or removal always applies to a cost that has been counted.
+	__sync_add_and_fetch(&_residentBytes, entry->_cost);
+
+	CC3CacheShard* shard = [self shardForName: objName];
+	pthread_mutex_lock(&shard->writeLock);
+	NSMutableDictionary* entries = [shard->entriesByName mutableCopy];		// retained
+	[entries setObject: entry forKey: objName];
+	CC3CacheShardPublish(shard, entries);
+	pthread_mutex_unlock(&shard->writeLock);
 
 	LogRez(@"Added %@ to the %@ cache.", obj, _typeName);
+
+	if (_byteBudget) [self evictToBudgetSparing: entry];
+	[entry release];
 }
 
 -(id<CC3Cacheable>) getObjectNamed: (NSString*) name {
-	[self lock];
-	id obj = [_objectsByName objectForKey: name];
-	[self unlock];
+	if ( !name ) return nil;
+
+	CC3CacheEntry* entry = [self entryNamed: name];
+	if ( !entry ) {
+		__sync_add_and_fetch(&_missCount, 1);
+		return nil;
+	}
+	__sync_add_and_fetch(&_hitCount, 1);
+
+	if (_byteBudget) {
+		entry->_lastAccess = __sync_add_and_fetch(&_accessClock, 1);
+		if (entry->_isWeak) [self holdObjectOfEntry: entry];
+	}
+	return [entry->_wrap resolveWeakReference];
+}
+
+/**
+ * Returns the object or weak wrapper cached under the specified name, without affecting
+ * the recency of the entry or the statistics of this cache.
+ */
+-(id) wrapperNamed: (NSString*) name {
+	CC3CacheEntry* entry = [self entryNamed: name];
+	return entry ? [[entry->_wrap retain] autorelease] : nil;
+}
+
+/**
+ * Retains the weakly cached object of the specified entry, if it is not already retained,
+ * so that the object remains in this cache, while this cache is within its byteBudget,
+ * even if it is released everywhere else.
+ */
+-(void) holdObjectOfEntry: (CC3CacheEntry*) entry {
+	if (entry->_heldObject) return;
+
+	id obj = [[entry->_wrap resolveWeakReference] retain];
+	if ( !obj ) return;
+	if ( !__sync_bool_compare_and_swap(&entry->_heldObject, nil, obj) ) {
+		[obj release];		// Another thread is already holding the object
+		return;
+	}
 
-	return [obj resolveWeakReference];
+	// If the entry was removed while the object was being retained, let the object go again.
+	if (entry->_isRemoved) [__sync_lock_test_and_set(&entry->_heldObject, nil) autorelease];
 }
 
 -(void) removeObject: (id<CC3Cacheable>) obj { [self removeObjectNamed: obj.name]; }
 
 -(void) removeObjectNamed: (NSString*) name {
-	if ( !name ) return;
-	
-	[self lock];
+	CC3CacheEntry* entry = [self detachEntry: nil named: name];
+	if ( !entry ) return;
+
+	pthread_mutex_lock(&_evictionMutex);
+	[self removeLRUEntry: entry];
+	pthread_mutex_unlock(&_evictionMutex);
+}
+
+/**
+ * Removes the entry with the specified name from the cache, and returns the removed entry,
+ * or nil if no entry was removed. If the specified entry is not nil, the cached entry is only
+ * removed if it is the same as the specified entry.
+ *
+ * The removed entry is not removed from the LRU heap. The caller must do so.
+ */
+-(CC3CacheEntry*) detachEntry: (CC3CacheEntry*) expectedEntry named: (NSString*) name {
+	if ( !name ) return nil;
 	
-	// If this cache is the only thing referencing the object, it will be deallocated immediately,
-	// which may interfere with with further processing of the removed object on this loop,
-	// including the auto-removal of weakly-cached objects from within the dealloc method of
-	// the removed object itself, resulting in a deadlock. To avoid this deadlock, the object
-	// is retained before removing it from the cache, and then autoreleased. In the case of a
-	// weakly-held value, we are careful to retain the NSValue wrapper, not the object itself,
-	// in case this removal is occurring from within the dealloc method of the object itself.
-	id obj = [[_objectsByName objectForKey: name] retain];
+	CC3CacheShard* shard = [self shardForName: name];
+	pthread_mutex_lock(&shard->writeLock);
 	
-	[_objectsByName removeObjectForKey: name];
-	[self unlock];
+	// If this cache is the only thing referencing the object, it will be deallocated when the
+	// entry is released, which may interfere with with further processing of the removed object
+	// on this loop, including the auto-removal of weakly-cached objects from within the dealloc
+	// method of the removed object itself, resulting in a deadlock. To avoid this, the entry is
+	// autoreleased, along with the dictionary that held it, and any object that was held by it.
+	CC3CacheEntry* entry = [shard->entriesByName objectForKey: name];
+	if (expectedEntry && entry != expectedEntry) entry = nil;
+	if (entry) {
+		[[entry retain] autorelease];
+		NSMutableDictionary* entries = [shard->entriesByName mutableCopy];		// retained
+		[entries removeObjectForKey: name];
+		CC3CacheShardPublish(shard, entries);
+		entry->_isRemoved = YES;
+		[__sync_lock_test_and_set(&entry->_heldObject, nil) autorelease];
+	}
+	pthread_mutex_unlock(&shard->writeLock);
 	
-	LogRezIf(obj != nil, @"Removed %@ named '%@' from the %@ cache.", [[obj resolveWeakReference] class], name, _typeName);
-	[obj autorelease];		// Let the object go once the loop is done
+	if ( !entry ) return nil;
+
+	__sync_sub_and_fetch(&_residentBytes, entry->_cost);
+	LogRez(@"Removed %@ named '%@' from the %@ cache.", [[entry->_wrap resolveWeakReference] class], name, _typeName);
+	return entry;
 }
 
 -(void) removeAllObjects { [self removeAllObjectsOfType: NSObject.class]; }
 
 -(void) removeAllObjectsOfType: (Class) type {
-	[self lock];
-	NSArray* names = [_objectsByName allKeys];
-	[self unlock];
-
-	for (NSString* name in names) {
-		[self lock];
-		id wrap = [_objectsByName objectForKey: name];
-		[self unlock];
-		if ( [[wrap resolveWeakReference] isKindOfClass: type] ) {
-			LogInfoIf([wrap isKindOfClass: NSValue.class],
-					  @"%@ is being removed from the %@ cache, but is may be retained elsewhere in your app."
-					  @" You should verify your app logic to ensure this is not the result of a memory leak.",
-					  [wrap resolveWeakReference], _typeName);
-			[self removeObjectNamed: name];
+	for (NSUInteger sIdx = 0; sIdx < kCC3CacheShardCount; sIdx++) {
+		for (NSString* name in [self entriesOfShard: &_shards[sIdx]]) {
+			id wrap = [self wrapperNamed: name];
+			if ( [[wrap resolveWeakReference] isKindOfClass: type] ) {
+				LogInfoIf([wrap isKindOfClass: NSValue.class],
+						  @"%@ is being removed from the %@ cache, but is may be retained elsewhere in your app."
+						  @" You should verify your app logic to ensure this is not the result of a memory leak.",
+						  [wrap resolveWeakReference], _typeName);
+				[self removeObjectNamed: name];
+			}
 		}
 	}
 }
 
 -(void) enumerateObjectsUsingBlock: (void (^) (id<CC3Cacheable> obj, BOOL* stop)) block {
-	[self lock];
-	[_objectsByName enumerateKeysAndObjectsUsingBlock: ^(id key, id obj, BOOL* stop) {
-		block([obj resolveWeakReference], stop);
-	}];
-	[self unlock];
+	__block BOOL shouldStop = NO;
+	for (NSUInteger sIdx = 0; sIdx < kCC3CacheShardCount && !shouldStop; sIdx++) {
+		[[self entriesOfShard: &_shards[sIdx]] enumerateKeysAndObjectsUsingBlock: ^(id key, CC3CacheEntry* entry, BOOL* stop) {
+			block([entry->_wrap resolveWeakReference], &shouldStop);
+			*stop = shouldStop;
+		}];
+	}
 }
 
 // Dummy implementation to keep compiler happy with @selector(caseInsensitiveCompare:)
@@ -131,14 +360,9 @@
 
 -(NSArray*) objectsSortedByName {
 
-	// Extract the cached wrappers
-	[self lock];
-	NSArray* wrappers = _objectsByName.allValues;
-	[self unlock];
-	
-	// Extracts the object from each wrapper
-	NSMutableArray* objs = [NSMutableArray arrayWithCapacity: wrappers.count];
-	for (NSObject* wpr in wrappers) [objs addObject: wpr.resolveWeakReference];
+	// Extract the objects from the cached wrappers
+	NSMutableArray* objs = [NSMutableArray array];
+	[self enumerateObjectsUsingBlock: ^(id<CC3Cacheable> obj, BOOL* stop) { if (obj) [objs addObject: obj]; }];
 
 	// Sort the resulting objects
 	NSSortDescriptor* sorter = [NSSortDescriptor sortDescriptorWithKey: @"name"
@@ -148,15 +372,239 @@
 }
 
 
+#pragma mark Memory budget and statistics
+
+-(void) setByteBudget: (NSUInteger) byteBudget {
+	_byteBudget = byteBudget;
+	if (_byteBudget)
+		[self evictToBudgetSparing: nil];
+	else
+		[self releaseHeldObjects];
+}
+
+/**
+ * Re-reads the cacheCost of the object held by the specified entry, and adjusts the residentBytes
+ * property by any change. The entry cost is only changed while holding both the eviction mutex
+ * and the write lock on the shard containing the entry, so that detachEntry:named: always
+ * subtracts the same cost that was most recently added to the residentBytes property.
+ */
+-(void) refreshCostOfEntry: (CC3CacheEntry*) entry {
+	id<CC3Cacheable> obj = [entry->_wrap resolveWeakReference];
+	if ( !obj ) return;
+	NSUInteger cost = [obj respondsToSelector: @selector(cacheCost)] ? obj.cacheCost : 0;
+	if (cost == entry->_cost) return;
+	__sync_add_and_fetch(&_residentBytes, (int64_t)cost - (int64_t)entry->_cost);
+	entry->_cost = cost;
+}
+
+-(void) updateCostOfObject: (id<CC3Cacheable>) obj {
+	NSString* name = obj.name;
+	if ( !name ) return;
+
+	pthread_mutex_lock(&_evictionMutex);
+	CC3CacheShard* shard = [self shardForName: name];
+	pthread_mutex_lock(&shard->writeLock);
+	CC3CacheEntry* entry = [[shard->entriesByName objectForKey: name] retain];
+	if (entry && [entry->_wrap resolveWeakReference] == obj)
+		[self refreshCostOfEntry: entry];
+	else {
+		[entry release];
+		entry = nil;
+	}
+	pthread_mutex_unlock(&shard->writeLock);
+	pthread_mutex_unlock(&_evictionMutex);
+
+	if (entry && _byteBudget && self.residentBytes > _byteBudget) [self evictToBudgetSparing: entry];
+	[entry release];
+}
+
+-(NSUInteger) residentBytes { return (NSUInteger)MAX(_residentBytes, 0); }
+
+-(NSUInteger) objectCount {
+	NSUInteger objCnt = 0;
+	for (NSUInteger sIdx = 0; sIdx < kCC3CacheShardCount; sIdx++)
+		objCnt += [self entriesOfShard: &_shards[sIdx]].count;
+	return objCnt;
+}
+
+-(NSUInteger) hitCount { return (NSUInteger)_hitCount; }
+
+-(NSUInteger) missCount { return (NSUInteger)_missCount; }
+
+-(NSUInteger) evictionCount { return (NSUInteger)_evictionCount; }
+
+-(GLfloat) hitRate {
+	int64_t reqCnt = _hitCount + _missCount;
+	return reqCnt ? ((GLfloat)_hitCount / (GLfloat)reqCnt) : 0.0f;
+}
+
+-(void) resetStatistics {
+	_hitCount = 0;
+	_missCount = 0;
+	_evictionCount = 0;
+}
+
+/** Adds the specified entry to the LRU heap. The eviction mutex must be held. */
+-(void) addLRUEntry: (CC3CacheEntry*) entry {
+	if (_lruCount == _lruCapacity) {
+		_lruCapacity = MAX(_lruCapacity * 2, 16);
+		_lruEntries = realloc(_lruEntries, _lruCapacity * sizeof(CC3CacheEntry*));
+	}
+	entry->_lruStamp = entry->_lastAccess;
+	entry->_lruIndex = _lruCount;
+	_lruEntries[_lruCount++] = entry;
+	CC3CacheLRUSiftUp(_lruEntries, entry->_lruIndex);
+}
+
+/** Removes the specified entry from the LRU heap, if it is in the heap. The eviction mutex must be held. */
+-(void) removeLRUEntry: (CC3CacheEntry*) entry {
+	NSUInteger idx = entry->_lruIndex;
+	if (idx == NSNotFound) return;
+
+	entry->_lruIndex = NSNotFound;
+	if (--_lruCount == idx) return;
+
+	_lruEntries[idx] = _lruEntries[_lruCount];
+	_lruEntries[idx]->_lruIndex = idx;
+	CC3CacheLRUSiftDown(_lruEntries, _lruCount, idx);
+	CC3CacheLRUSiftUp(_lruEntries, _lruEntries[idx]->_lruIndex);
+}
+
+/** Empties the LRU heap, and releases every weakly cached object that is held by this cache. */
+-(void) releaseHeldObjects {
+	pthread_mutex_lock(&_evictionMutex);
+	while (_lruCount) [self removeLRUEntry: _lruEntries[_lruCount - 1]];
+	pthread_mutex_unlock(&_evictionMutex);
+
+	for (NSUInteger sIdx = 0; sIdx < kCC3CacheShardCount; sIdx++)
+		for (CC3CacheEntry* entry in [self entriesOfShard: &_shards[sIdx]].objectEnumerator)
+			[__sync_lock_test_and_set(&entry->_heldObject, nil) release];
+}
+
+/**
+ * Refreshes the cost of every entry, to catch objects whose cacheCost has changed since they
+ * were added, then releases objects, in least-recently-used order, until the residentBytes
+ * property is within the byteBudget property. Strongly cached objects are removed from this
+ * cache. Weakly cached objects that are held by this cache are released by it, and remain in
+ * this cache for as long as they are retained elsewhere.
+ *
+ * Candidates for eviction are kept in a binary heap, ordered by the time each was last used.
+ * Retrieving an object only updates the access time of its entry, without locking, so the
+ * position of an entry in the heap may be out of date. When an entry reaches the top of the
+ * heap, and it has been used since it was positioned, it is repositioned instead of evicted.
+ *
+ * The specified entry, which may be nil, is never evicted. This is used to ensure that an
+ * object is never evicted by its own addition, or by a change to its own cost.
+ */
+-(void) evictToBudgetSparing: (CC3CacheEntry*) sparedEntry {
+	pthread_mutex_lock(&_evictionMutex);
+
+	// Refresh the entry costs, and add new strongly cached, or newly held, entries to the heap.
+	for (NSUInteger sIdx = 0; sIdx < kCC3CacheShardCount; sIdx++) {
+		CC3CacheShard* shard = &_shards[sIdx];
+		pthread_mutex_lock(&shard->writeLock);
+		for (CC3CacheEntry* entry in shard->entriesByName.objectEnumerator) {
+			[self refreshCostOfEntry: entry];
+			if (entry->_lruIndex == NSNotFound && ( !entry->_isWeak || entry->_heldObject ))
+				[self addLRUEntry: entry];
+		}
+		pthread_mutex_unlock(&shard->writeLock);
+	}
+
+	// Set the spared entry aside while evicting
+	BOOL shouldRestoreSparedEntry = (sparedEntry && sparedEntry->_lruIndex != NSNotFound);
+	if (shouldRestoreSparedEntry) [self removeLRUEntry: sparedEntry];
+
+	// Held objects are autoreleased, and their cost leaves residentBytes once they are deallocated.
+	int64_t releasedBytes = 0;
+	while (_lruCount && (_residentBytes - releasedBytes) > (int64_t)_byteBudget) {
+		CC3CacheEntry* entry = _lruEntries[0];
+		if (entry->_lruStamp != entry->_lastAccess) {		// Used since it was positioned
+			entry->_lruStamp = entry->_lastAccess;
+			CC3CacheLRUSiftDown(_lruEntries, _lruCount, 0);
+			continue;
+		}
+		[self removeLRUEntry: entry];
+
+		if (entry->_isWeak) {
+			id heldObj = __sync_lock_test_and_set(&entry->_heldObject, nil);
+			if ( !heldObj ) continue;
+			releasedBytes += entry->_cost;
+			[heldObj autorelease];
+		} else if ( ![self detachEntry: entry named: entry->_name] ) continue;
+
+		__sync_add_and_fetch(&_evictionCount, 1);
+		LogRez(@"Evicted %@ named '%@' from the %@ cache to remain within its budget of %lu bytes.",
+			   [[entry->_wrap resolveWeakReference] class], entry->_name, _typeName, (unsigned long)_byteBudget);
+	}
+
+	if (shouldRestoreSparedEntry && !sparedEntry->_isRemoved) [self addLRUEntry: sparedEntry];
+
+	pthread_mutex_unlock(&_evictionMutex);
+}
+
+-(NSString*) statisticsDescription {
+	return [NSString stringWithFormat: @"%@ cache with %lu objects using %lu bytes (budget %lu),"
+			@" hit rate %.1f%% (%lu hits, %lu misses), %lu evictions",
+			_typeName, (unsigned long)self.objectCount, (unsigned long)self.residentBytes,
+			(unsigned long)_byteBudget, self.hitRate * 100.0f, (unsigned long)self.hitCount,
+			(unsigned long)self.missCount, (unsigned long)self.evictionCount];
+}
+
+-(NSDictionary*) memoryFootprint {
+	__block NSUInteger totalAppBytes = 0;
+	__block NSUInteger totalGLBytes = 0;
+	NSMutableArray* objFootprints = [NSMutableArray array];
+	[self enumerateObjectsUsingBlock: ^(id<CC3Cacheable> obj, BOOL* stop) {
+		if ( !obj ) return;
+		NSUInteger appBytes = [obj respondsToSelector: @selector(applicationMemoryBytes)] ? obj.applicationMemoryBytes : 0;
+		NSUInteger glBytes = [obj respondsToSelector: @selector(glMemoryBytes)] ? obj.glMemoryBytes : 0;
+		totalAppBytes += appBytes;
+		totalGLBytes += glBytes;
+		[objFootprints addObject: [NSDictionary dictionaryWithObjectsAndKeys:
+								   (obj.name ? obj.name : @""), @"name",
+								   NSStringFromClass([(NSObject*)obj class]), @"class",
+								   [NSNumber numberWithUnsignedInteger: appBytes], @"applicationBytes",
+								   [NSNumber numberWithUnsignedInteger: glBytes], @"glBytes",
+								   nil]];
+	}];
+	[objFootprints sortUsingComparator: ^NSComparisonResult(NSDictionary* fp1, NSDictionary* fp2) {
+		NSUInteger b1 = [[fp1 objectForKey: @"applicationBytes"] unsignedIntegerValue] + [[fp1 objectForKey: @"glBytes"] unsignedIntegerValue];
+		NSUInteger b2 = [[fp2 objectForKey: @"applicationBytes"] unsignedIntegerValue] + [[fp2 objectForKey: @"glBytes"] unsignedIntegerValue];
+		return (b1 > b2) ? NSOrderedAscending : ((b1 < b2) ? NSOrderedDescending : NSOrderedSame);
+	}];
+	return [NSDictionary dictionaryWithObjectsAndKeys:
+			_typeName, @"type",
+			[NSNumber numberWithUnsignedInteger: objFootprints.count], @"objectCount",
+			[NSNumber numberWithUnsignedInteger: self.residentBytes], @"residentBytes",
+			[NSNumber numberWithUnsignedInteger: _byteBudget], @"byteBudget",
+			[NSNumber numberWithUnsignedInteger: totalAppBytes], @"applicationBytes",
+			[NSNumber numberWithUnsignedInteger: totalGLBytes], @"glBytes",
+			objFootprints, @"objects",
+			nil];
+}
+
+
 #pragma mark NSLocking implementation
 
--(void) lock { pthread_mutex_lock(&_mutex); }
+/**
+ * Acquires the write lock on every shard, in shard order, to block all changes to this cache.
+ * Retrieving objects does not lock, and is not blocked.
+ */
+-(void) lock {
+	for (NSUInteger sIdx = 0; sIdx < kCC3CacheShardCount; sIdx++) pthread_mutex_lock(&_shards[sIdx].writeLock);
+}
 
--(void) unlock { pthread_mutex_unlock(&_mutex); }
+-(void) unlock {
+	for (NSUInteger sIdx = kCC3CacheShardCount; sIdx > 0; sIdx--) pthread_mutex_unlock(&_shards[sIdx - 1].writeLock);
+}
 
--(void) initLock { pthread_mutex_init(&_mutex, NULL); }
+-(void) initLock {
+	for (NSUInteger sIdx = 0; sIdx < kCC3CacheShardCount; sIdx++) pthread_mutex_init(&_shards[sIdx].writeLock, NULL);
+	pthread_mutex_init(&_evictionMutex, NULL);
+}
 
--(void) deleteLock { pthread_mutex_destroy(&_mutex); }
+-(void) deleteLock { pthread_mutex_destroy(&_evictionMutex); }
 
 
 #pragma mark Allocation and initialization
@@ -165,9 +613,21 @@
 
 -(id) initAsWeakCache: (BOOL) isWeak forType: (NSString*) typeName {
 	if ( (self = [super init]) ) {
-		_objectsByName = [NSMutableDictionary new];		// retained
+		for (NSUInteger sIdx = 0; sIdx < kCC3CacheShardCount; sIdx++) {
+			_shards[sIdx].entriesByName = [NSDictionary new];		// retained
+			_shards[sIdx].readerCounts[0] = 0;
+			_shards[sIdx].readerCounts[1] = 0;
+			_shards[sIdx].epoch = 0;
+		}
+		_lruEntries = NULL;
+		_lruCount = 0;
+		_lruCapacity = 0;
 		_typeName = [typeName retain];					// retained
 		_isWeak = isWeak;
+		_byteBudget = 0;
+		_residentBytes = 0;
+		_accessClock = 0;
+		[self resetStatistics];
 		[self initLock];
 	}
 	return self;
@@ -596,6 +596,24 @@ static inline CC3Vector CC3VectorLerp(CC3Vector v1, CC3Vector v2, GLfloat blendF
 	return CC3VectorAdd(v1, CC3VectorScaleUniform(CC3VectorDifference(v2, v1), blendFactor));
 }
 
+/**
+ * Returns a vector whose components are random values drawn from the specified stream, each
+ * between the corresponding components of the specified min inclusive and max exclusive.
+ */
+static inline CC3Vector CC3RandomStreamVectorBetween(CC3RandomStream* stream, CC3Vector min, CC3Vector max) {
+	return cc3v(CC3RandomStreamFloatBetween(stream, min.x, max.x),
+				CC3RandomStreamFloatBetween(stream, min.y, max.y),
+				CC3RandomStreamFloatBetween(stream, min.z, max.z));
+}
+
+/**
+ * Fills the specified array of vectors with random vectors drawn from the specified stream.
+ * The components of each vector are between the corresponding components of the specified
+ * min inclusive and max exclusive.
+ */
+void CC3RandomStreamFillVectorsBetween(CC3RandomStream* stream, CC3Vector* vectors, NSUInteger count,
+									   CC3Vector min, CC3Vector max);
+
 /** 
  * Minimum acceptable absolute value for a scale transformation component.
  *
@@ -873,6 +891,142 @@ static inline CC3Vector4 CC3Vector4Difference(CC3Vector4 minuend, CC3Vector4 sub
 }
 
 
+#pragma mark -
+#pragma mark SIMD vector support
+
+#if CC3_NEON
+#	import <arm_neon.h>
+#elif CC3_SSE
+#	import <xmmintrin.h>
+#endif
+
+#if CC3_SIMD
+
+/**
+ * Four GLfloats held in a single NEON or SSE vector register.
+ *
+ * The functions that operate on this type perform each multiply and add as a separate,
+ * rounded operation, so a calculation built from them produces results that are bit-for-bit
+ * identical to the same calculation performed one GLfloat at a time, in the same order, as long
+ * as the scalar calculation is compiled with floating-point contraction disabled. Otherwise,
+ * the compiler may fuse scalar multiplies and adds into FMA instructions, which round once,
+ * and the results may then differ by a few ULPs. The matrix implementation files that use
+ * these functions disable contraction with #pragma STDC FP_CONTRACT OFF.
+ */
+#if CC3_NEON
+typedef float32x4_t CC3SIMDFloat4;
+#else
+typedef __m128 CC3SIMDFloat4;
+#endif
+
+/** Loads four consecutive GLfloats, which need not be aligned, from the specified memory. */
+static inline CC3SIMDFloat4 CC3SIMDFloat4Load(const GLfloat* p) {
+#if CC3_NEON
+	return vld1q_f32(p);
+#else
+	return _mm_loadu_ps(p);
+#endif
+}
+
+/** Stores four consecutive GLfloats, which need not be aligned, into the specified memory. */
+static inline void CC3SIMDFloat4Store(GLfloat* p, CC3SIMDFloat4 v) {
+#if CC3_NEON
+	vst1q_f32(p, v);
+#else
+	_mm_storeu_ps(p, v);
+#endif
+}
+
+/** Returns a SIMD vector with all four elements set to the specified value. */
+static inline CC3SIMDFloat4 CC3SIMDFloat4Splat(GLfloat f) {
+#if CC3_NEON
+	return vdupq_n_f32(f);
+#else
+	return _mm_set1_ps(f);
+#endif
+}
+
+/** Returns the element-by-element sum of the specified SIMD vectors. */
+static inline CC3SIMDFloat4 CC3SIMDFloat4Add(CC3SIMDFloat4 a, CC3SIMDFloat4 b) {
+#if CC3_NEON
+	return vaddq_f32(a, b);
+#else
+	return _mm_add_ps(a, b);
+#endif
+}
+
+/** Returns the element-by-element product of the specified SIMD vectors. */
+static inline CC3SIMDFloat4 CC3SIMDFloat4Multiply(CC3SIMDFloat4 a, CC3SIMDFloat4 b) {
+#if CC3_NEON
+	return vmulq_f32(a, b);
+#else
+	return _mm_mul_ps(a, b);
+#endif
+}
+
+/** Returns the element-by-element difference of the specified SIMD vectors. */
+static inline CC3SIMDFloat4 CC3SIMDFloat4Subtract(CC3SIMDFloat4 a, CC3SIMDFloat4 b) {
+#if CC3_NEON
+	return vsubq_f32(a, b);
+#else
+	return _mm_sub_ps(a, b);
+#endif
+}
+
+/** Returns the element-by-element minimum of the specified SIMD vectors. */
+static inline CC3SIMDFloat4 CC3SIMDFloat4Minimize(CC3SIMDFloat4 a, CC3SIMDFloat4 b) {
+#if CC3_NEON
+	return vminq_f32(a, b);
+#else
+	return _mm_min_ps(a, b);
+#endif
+}
+
+/** Returns the element-by-element maximum of the specified SIMD vectors. */
+static inline CC3SIMDFloat4 CC3SIMDFloat4Maximize(CC3SIMDFloat4 a, CC3SIMDFloat4 b) {
+#if CC3_NEON
+	return vmaxq_f32(a, b);
+#else
+	return _mm_max_ps(a, b);
+#endif
+}
+
+/**
+ * Returns a four-bit mask, in which each bit is set if the corresponding element of the
+ * specified SIMD vector is greater than zero. The first element is held in the lowest bit.
+ */
+static inline GLuint CC3SIMDFloat4PositiveMask(CC3SIMDFloat4 v) {
+#if CC3_NEON
+	static const uint32_t elementBits[4] = { 1, 2, 4, 8 };
+	uint32x4_t bits = vandq_u32(vcgtq_f32(v, vdupq_n_f32(0.0f)), vld1q_u32(elementBits));
+	uint32x2_t pairs = vadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+	return vget_lane_u32(vpadd_u32(pairs, pairs), 0);
+#else
+	return (GLuint)_mm_movemask_ps(_mm_cmpgt_ps(v, _mm_setzero_ps()));
+#endif
+}
+
+/**
+ * Transposes the 4x4 matrix held in the four specified SIMD vectors, so that on return,
+ * each of the specified vectors holds what was previously the corresponding column.
+ */
+static inline void CC3SIMDFloat4Transpose(CC3SIMDFloat4* v1, CC3SIMDFloat4* v2,
+										  CC3SIMDFloat4* v3, CC3SIMDFloat4* v4) {
+#if CC3_NEON
+	float32x4x2_t t12 = vtrnq_f32(*v1, *v2);
+	float32x4x2_t t34 = vtrnq_f32(*v3, *v4);
+	*v1 = vcombine_f32(vget_low_f32(t12.val[0]), vget_low_f32(t34.val[0]));
+	*v2 = vcombine_f32(vget_low_f32(t12.val[1]), vget_low_f32(t34.val[1]));
+	*v3 = vcombine_f32(vget_high_f32(t12.val[0]), vget_high_f32(t34.val[0]));
+	*v4 = vcombine_f32(vget_high_f32(t12.val[1]), vget_high_f32(t34.val[1]));
+#else
+	_MM_TRANSPOSE4_PS(*v1, *v2, *v3, *v4);
+#endif
+}
+
+#endif	// CC3_SIMD
+
+
 #pragma mark -
 #pragma mark Quaternions
 
@@ -1281,6 +1435,17 @@ static inline BOOL CC3BoxContainsLocation(CC3Box bb, CC3Vector aLoc) {
  */
 CC3Box CC3BoxEngulfLocation(CC3Box bb, CC3Vector aLoc);
 
+/**
+ * Returns the smallest CC3Box that contains the specified number of locations.
+ *
+ * Consecutive locations are separated by the specified stride, in bytes, allowing the locations
+ * to be interleaved with other vertex content. A stride of zero indicates that the locations are
+ * tightly packed CC3Vectors. Only the first three GLfloats of each location are used.
+ *
+ * If the location count is zero, returns the null bounding box.
+ */
+CC3Box CC3BoxFromLocations(const GLvoid* locations, GLuint stride, GLuint locationCount);
+
 /**
  * Returns the smallest CC3Box that contains the two specified bounding boxes.
  * If either bounding box is the null bounding box, simply returns the other bounding box
@@ -1922,6 +2087,16 @@ static inline BOOL CC3DoesSphereIntersectSphere(CC3Sphere sphereOne, CC3Sphere s
 	return CC3IsLocationWithinSphere(sphereTwo.center, bigSphere);
 }
 
+/**
+ * Returns the smallest CC3Sphere, centered at the specified location, that contains the
+ * specified number of locations.
+ *
+ * Consecutive locations are separated by the specified stride, in bytes, allowing the locations
+ * to be interleaved with other vertex content. A stride of zero indicates that the locations are
+ * tightly packed CC3Vectors. Only the first three GLfloats of each location are used.
+ */
+CC3Sphere CC3SphereAroundLocations(CC3Vector center, const GLvoid* locations, GLuint stride, GLuint locationCount);
+
 /** Returns the smallest CC3Sphere that contains the two specified spheres. */
 CC3Sphere CC3SphereUnion(CC3Sphere s1, CC3Sphere s2);
 
@@ -2357,6 +2532,25 @@ static inline ccColor4F RandomCCC4FBetween(ccColor4F min, ccColor4F max) {
 				 CC3RandomFloatBetween(min.a, max.a));
 }
 
+/**
+ * Returns a random ccColor4F drawn from the specified stream, where each component value is
+ * between the corresponding components of the specified min inclusive and max exclusive.
+ */
+static inline ccColor4F CC3RandomStreamColorBetween(CC3RandomStream* stream, ccColor4F min, ccColor4F max) {
+	return ccc4f(CC3RandomStreamFloatBetween(stream, min.r, max.r),
+				 CC3RandomStreamFloatBetween(stream, min.g, max.g),
+				 CC3RandomStreamFloatBetween(stream, min.b, max.b),
+				 CC3RandomStreamFloatBetween(stream, min.a, max.a));
+}
+
+/**
+ * Fills the specified array of colors with random colors drawn from the specified stream.
+ * The components of each color are between the corresponding components of the specified
+ * min inclusive and max exclusive.
+ */
+void CC3RandomStreamFillColorsBetween(CC3RandomStream* stream, ccColor4F* colors, NSUInteger count,
+									  ccColor4F min, ccColor4F max);
+
 
 #pragma mark -
 #pragma mark ccColor4B constants and functions
@@ -2517,6 +2711,16 @@ static inline void CC3SetBit(GLbitfield* bits, GLuint bitIdx, BOOL val) {
 		*bits &= ~marker;
 }
 
+/**
+ * Returns the 16-bit IEEE 754 half-precision representation of the specified float value,
+ * rounded to the nearest representable value. Values too large to be represented become
+ * infinity, and values too small to be represented become zero.
+ */
+GLushort CC3HalfFloatFromFloat(GLfloat value);
+
+/** Returns the float value of the specified 16-bit IEEE 754 half-precision value. */
+GLfloat CC3FloatFromHalfFloat(GLushort halfValue);
+
 /**
  * Reverses the order of the rows in the specified data block.
  * The transformation is performed in-place.
@@ -2529,9 +2733,45 @@ static inline void CC3SetBit(GLbitfield* bits, GLuint bitIdx, BOOL val) {
  * The specified data block is assumed to be in row-major order, containing the specified
  * number of rows, and with the specified number of bytes in each row. The total number of
  * bytes in the data block must be at least (bytesPerRow * rowCount).
+ *
+ * Large data blocks are split into groups of rows that are processed concurrently.
  */
 void CC3FlipVertically(GLubyte* rowMajorData, GLuint rowCount, GLuint bytesPerRow);
 
+/**
+ * Reverses the order of the pixels within each row of the specified data block.
+ * The transformation is performed in-place.
+ *
+ * The specified data block is assumed to be in row-major order, containing the specified
+ * number of rows, and with the specified number of bytes in each row. Each row contains
+ * as many pixels of the specified size as will fit in the row. Any padding at the end of
+ * each row is left untouched.
+ *
+ * Large data blocks are split into groups of rows that are processed concurrently.
+ */
+void CC3FlipHorizontally(GLubyte* rowMajorData, GLuint rowCount, GLuint bytesPerRow, GLuint bytesPerPixel);
+
+/**
+ * Rotates the pixels in the specified data block by 180 degrees, in-place, in a single pass.
+ * This is equivalent to invoking both the CC3FlipVertically and CC3FlipHorizontally functions.
+ *
+ * The structure of the data block is as described for the CC3FlipHorizontally function.
+ */
+void CC3RotateHalfCircle(GLubyte* rowMajorData, GLuint rowCount, GLuint bytesPerRow, GLuint bytesPerPixel);
+
+/**
+ * Converts the specified array of 32-bit RGBA pixels, in-place, to the specified OpenGL pixel
+ * format and type, and packs the converted pixels tightly at the start of the array.
+ *
+ * The pixelFormat and pixelType may be any of the combinations supported for texture content.
+ * Conversions to GL_LUMINANCE and GL_LUMINANCE_ALPHA use BT.709 luminosity weights, as with
+ * the CC3LuminosityBT709 function. If the pixel format and type are GL_RGBA and GL_UNSIGNED_BYTE,
+ * or are not recognized, the pixels are left unchanged.
+ *
+ * Large arrays are split into groups of pixels that are converted concurrently.
+ */
+void CC3ConvertRGBA8888Pixels(ccColor4B* pixels, GLuint pixelCount, GLenum pixelFormat, GLenum pixelType);
+
 /** Temporarily turn off compiler warnings for hidden variable shadowing. */
 #define CC3_PUSH_NOSHADOW	_Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Wshadow\"")
 
@@ -84,6 +84,48 @@ CC3Box CC3BoxEngulfLocation(CC3Box bb, CC3Vector aLoc) {
 	return bbOut;
 }
 
+CC3Box CC3BoxFromLocations(const GLvoid* locations, GLuint stride, GLuint locationCount) {
+	if (locationCount == 0) return kCC3BoxNull;
+	if (stride == 0) stride = sizeof(CC3Vector);
+
+	const GLbyte* pLoc = locations;
+#if CC3_SIMD
+	// Four GLfloats are read from each location, and the fourth, which belongs to the next
+	// location, is ignored. The first and last locations are staged through a CC3Vector4,
+	// to avoid reading beyond the end of the last location.
+	GLuint lastIdx = locationCount - 1;
+	CC3Vector4 loc4 = CC3Vector4FromLocation(*(CC3Vector*)pLoc);
+	CC3SIMDFloat4 vlMin = CC3SIMDFloat4Load(&loc4.x);
+	CC3SIMDFloat4 vlMax = vlMin;
+	for (GLuint i = 1; i < lastIdx; i++) {
+		pLoc += stride;
+		CC3SIMDFloat4 vl = CC3SIMDFloat4Load((const GLfloat*)pLoc);
+		vlMin = CC3SIMDFloat4Minimize(vlMin, vl);
+		vlMax = CC3SIMDFloat4Maximize(vlMax, vl);
+	}
+	if (lastIdx > 0) {
+		loc4 = CC3Vector4FromLocation(*(CC3Vector*)((const GLbyte*)locations + (lastIdx * stride)));
+		CC3SIMDFloat4 vl = CC3SIMDFloat4Load(&loc4.x);
+		vlMin = CC3SIMDFloat4Minimize(vlMin, vl);
+		vlMax = CC3SIMDFloat4Maximize(vlMax, vl);
+	}
+	CC3Vector4 bbMin, bbMax;
+	CC3SIMDFloat4Store(&bbMin.x, vlMin);
+	CC3SIMDFloat4Store(&bbMax.x, vlMax);
+	return CC3BoxFromMinMax(bbMin.v, bbMax.v);
+#else
+	CC3Vector vlMin = *(CC3Vector*)pLoc;
+	CC3Vector vlMax = vlMin;
+	for (GLuint i = 1; i < locationCount; i++) {
+		pLoc += stride;
+		CC3Vector vl = *(CC3Vector*)pLoc;
+		vlMin = CC3VectorMinimize(vlMin, vl);
+		vlMax = CC3VectorMaximize(vlMax, vl);
+	}
+	return CC3BoxFromMinMax(vlMin, vlMax);
+#endif	// CC3_SIMD
+}
+
 CC3Vector4 CC3RayIntersectionWithBoxSide(CC3Ray aRay, CC3Box bb, CC3Vector sideNormal, CC3Vector4 prevHit) {
 	
 	// Determine which corner to use from the direction of the edge plane normal,
@@ -387,6 +429,45 @@ GLfloat CC3DistanceFromNormalizedPlane(CC3Plane p, CC3Vector v) { return CC3Dist
 #pragma mark -
 #pragma mark Sphere structure and functions
 
+CC3Sphere CC3SphereAroundLocations(CC3Vector center, const GLvoid* locations, GLuint stride, GLuint locationCount) {
+	if (stride == 0) stride = sizeof(CC3Vector);
+
+	// Work with the square of the radius so that all distances can be compared
+	// without having to run expensive square-root calculations.
+	const GLbyte* pLoc = locations;
+	GLfloat radiusSq = 0.0f;
+	GLuint locIdx = 0;
+#if CC3_SIMD
+	// Measure four locations at a time, transposed so that each SIMD vector holds a single
+	// axis of the four locations. Four GLfloats are read from each location, so the last
+	// location is always left to the loop below, to avoid reading beyond its end.
+	CC3SIMDFloat4 cx = CC3SIMDFloat4Splat(center.x);
+	CC3SIMDFloat4 cy = CC3SIMDFloat4Splat(center.y);
+	CC3SIMDFloat4 cz = CC3SIMDFloat4Splat(center.z);
+	CC3SIMDFloat4 maxDistSq = CC3SIMDFloat4Splat(0.0f);
+	for ( ; locIdx + 4 < locationCount; locIdx += 4, pLoc += (stride * 4)) {
+		CC3SIMDFloat4 vx = CC3SIMDFloat4Load((const GLfloat*)pLoc);
+		CC3SIMDFloat4 vy = CC3SIMDFloat4Load((const GLfloat*)(pLoc + stride));
+		CC3SIMDFloat4 vz = CC3SIMDFloat4Load((const GLfloat*)(pLoc + (stride * 2)));
+		CC3SIMDFloat4 vw = CC3SIMDFloat4Load((const GLfloat*)(pLoc + (stride * 3)));
+		CC3SIMDFloat4Transpose(&vx, &vy, &vz, &vw);
+		CC3SIMDFloat4 dx = CC3SIMDFloat4Subtract(vx, cx);
+		CC3SIMDFloat4 dy = CC3SIMDFloat4Subtract(vy, cy);
+		CC3SIMDFloat4 dz = CC3SIMDFloat4Subtract(vz, cz);
+		CC3SIMDFloat4 distSq = CC3SIMDFloat4Add(CC3SIMDFloat4Multiply(dx, dx), CC3SIMDFloat4Multiply(dy, dy));
+		distSq = CC3SIMDFloat4Add(distSq, CC3SIMDFloat4Multiply(dz, dz));
+		maxDistSq = CC3SIMDFloat4Maximize(maxDistSq, distSq);
+	}
+	GLfloat maxDistSqs[4];
+	CC3SIMDFloat4Store(maxDistSqs, maxDistSq);
+	radiusSq = MAX(MAX(maxDistSqs[0], maxDistSqs[1]), MAX(maxDistSqs[2], maxDistSqs[3]));
+#endif	// CC3_SIMD
+	for ( ; locIdx < locationCount; locIdx++, pLoc += stride)
+		radiusSq = MAX(radiusSq, CC3VectorDistanceSquared(*(CC3Vector*)pLoc, center));
+
+	return CC3SphereMake(center, sqrtf(radiusSq));		// Now finally take the square-root
+}
+
 CC3Sphere CC3SphereUnion(CC3Sphere s1, CC3Sphere s2) {
 	CC3Vector uc, mc, is1, is2, epF, epB;
 
@@ -487,23 +568,617 @@ CC3Vector CC3RayIntersectionOfSphere(CC3Ray aRay, CC3Sphere aSphere) {
 }
 
 
+#pragma mark -
+#pragma mark Random number generation
+
+volatile BOOL CC3RandomIsSeeded = NO;
+
+static uint64_t _randomState = 0;
+
+void CC3RandomSeed(uint64_t seed) { CC3RandomSetState(seed); }
+
+void CC3RandomUnseed(void) { CC3RandomIsSeeded = NO; }
+
+uint64_t CC3RandomGetState(void) { return _randomState; }
+
+void CC3RandomSetState(uint64_t state) {
+	_randomState = state;
+	CC3RandomIsSeeded = YES;
+}
+
+/** SplitMix64: advances the state by a fixed odd increment, and returns a scramble of the state. */
+uint32_t CC3RandomNextSeededUInt(void) {
+	uint64_t z = (_randomState += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return (uint32_t)((z ^ (z >> 31)) >> 32);
+}
+
+void CC3RandomStreamSeed(CC3RandomStream* stream, uint64_t seed, uint64_t sequence) {
+	stream->state = 0;
+	stream->increment = (sequence << 1) | 1;
+	CC3RandomStreamUInt(stream);
+	stream->state += seed;
+	CC3RandomStreamUInt(stream);
+}
+
+void CC3RandomStreamFillFloatsBetween(CC3RandomStream* stream, float* values, NSUInteger count,
+									  float min, float max) {
+	float range = max - min;
+	for (NSUInteger i = 0; i < count; i++)
+		values[i] = min + (CC3RandomStreamFloat(stream) * range);
+}
+
+void CC3RandomStreamFillVectorsBetween(CC3RandomStream* stream, CC3Vector* vectors, NSUInteger count,
+									   CC3Vector min, CC3Vector max) {
+	CC3Vector range = CC3VectorDifference(max, min);
+	for (NSUInteger i = 0; i < count; i++) {
+		vectors[i].x = min.x + (CC3RandomStreamFloat(stream) * range.x);
+		vectors[i].y = min.y + (CC3RandomStreamFloat(stream) * range.y);
+		vectors[i].z = min.z + (CC3RandomStreamFloat(stream) * range.z);
+	}
+}
+
+void CC3RandomStreamFillColorsBetween(CC3RandomStream* stream, ccColor4F* colors, NSUInteger count,
+									  ccColor4F min, ccColor4F max) {
+	ccColor4F range = ccc4f(max.r - min.r, max.g - min.g, max.b - min.b, max.a - min.a);
+	for (NSUInteger i = 0; i < count; i++) {
+		colors[i].r = min.r + (CC3RandomStreamFloat(stream) * range.r);
+		colors[i].g = min.g + (CC3RandomStreamFloat(stream) * range.g);
+		colors[i].b = min.b + (CC3RandomStreamFloat(stream) * range.b);
+		colors[i].a = min.a + (CC3RandomStreamFloat(stream) * range.a);
+	}
+}
+
+
 #pragma mark -
 #pragma mark Miscellaneous extensions and functionality
 
+GLushort CC3HalfFloatFromFloat(GLfloat value) {
+	union { GLfloat f; GLuint u; } fltBits;
+	fltBits.f = value;
+	GLushort sign = (fltBits.u >> 16) & 0x8000;
+	GLuint absBits = fltBits.u & 0x7FFFFFFF;
+
+	if (absBits >= 0x7F800000) return sign | ((absBits > 0x7F800000) ? 0x7E00 : 0x7C00);	// NaN or infinity
+	if (absBits >= 0x477FF000) return sign | 0x7C00;		// Rounds beyond the largest half float
+	if (absBits < 0x33000000) return sign;					// Rounds to zero
+
+	// Round the discarded mantissa bits to nearest, with ties to even.
+	// A carry out of the mantissa correctly bumps the exponent.
+	GLuint halfBits, remBits, halfway;
+	if (absBits < 0x38800000) {		// Denormalized half float
+		GLuint shift = 126 - (absBits >> 23);
+		GLuint mant = (absBits & 0x007FFFFF) | 0x00800000;
+		halfBits = mant >> shift;
+		remBits = mant & ((1u << shift) - 1);
+		halfway = 1u << (shift - 1);
+	} else {
+		halfBits = (absBits - 0x38000000) >> 13;			// Rebias exponent from 127 to 15
+		remBits = absBits & 0x1FFF;
+		halfway = 0x1000;
+	}
+	if (remBits > halfway || (remBits == halfway && (halfBits & 1))) halfBits++;
+	return sign | (GLushort)halfBits;
+}
+
+GLfloat CC3FloatFromHalfFloat(GLushort halfValue) {
+	GLuint sign = (GLuint)(halfValue & 0x8000) << 16;
+	GLuint exp = (halfValue >> 10) & 0x1F;
+	GLuint mant = halfValue & 0x03FF;
+
+	if (exp == 0) {			// Zero or denormalized half float
+		GLfloat value = ldexpf((GLfloat)mant, -24);
+		return sign ? -value : value;
+	}
+
+	union { GLfloat f; GLuint u; } fltBits;
+	if (exp == 31)
+		fltBits.u = sign | 0x7F800000 | (mant << 13);		// NaN or infinity
+	else
+		fltBits.u = sign | ((exp + 112) << 23) | (mant << 13);
+	return fltBits.f;
+}
+
+#pragma mark Pixel content
+
+#if CC3_SSE
+#	import <emmintrin.h>
+#endif
+
+/** Pixel content occupying at least this many bytes is processed concurrently, in chunks. */
+#define kCC3PixelConcurrentByteCount		(1024 * 1024)
+
+/** The number of bytes of pixel content processed in each concurrent chunk. */
+#define kCC3PixelConcurrentChunkByteCount	(256 * 1024)
+
+/**
+ * Returns the number of items of the specified size to process in each chunk, when processing
+ * the specified number of items. If the items occupy fewer than kCC3PixelConcurrentByteCount
+ * bytes, all of the items are processed in a single chunk.
+ */
+static GLuint CC3PixelChunkItemCount(GLuint itemCount, GLuint bytesPerItem) {
+	if ((size_t)itemCount * bytesPerItem < kCC3PixelConcurrentByteCount) return itemCount;
+	return MAX(kCC3PixelConcurrentChunkByteCount / bytesPerItem, 1);
+}
+
+/**
+ * Invokes the specified block on each consecutive chunk of the specified number of items,
+ * passing the index of the first item in the chunk, and the number of items in the chunk.
+ * If there is more than one chunk, the chunks are processed concurrently, and this function
+ * returns once all chunks have been processed.
+ */
+static void CC3PixelChunksApply(GLuint itemCount, GLuint chunkItemCount,
+								void (^block)(GLuint startIdx, GLuint itemCnt)) {
+	if (itemCount == 0) return;
+	if (chunkItemCount >= itemCount) {
+		block(0, itemCount);
+		return;
+	}
+	size_t chunkCnt = (itemCount + chunkItemCount - 1) / chunkItemCount;
+	dispatch_apply(chunkCnt, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t chunkIdx) {
+		GLuint startIdx = (GLuint)chunkIdx * chunkItemCount;
+		block(startIdx, MIN(chunkItemCount, itemCount - startIdx));
+	});
+}
+
+/**
+ * Loads and stores 32-bit and 16-bit pixels through memcpy, so that in-place conversions,
+ * which read and write the same memory through different types, are not reordered.
+ */
+static inline GLuint CC3PixelLoad32(const GLubyte* p) { GLuint v; memcpy(&v, p, 4); return v; }
+static inline void CC3PixelStore32(GLubyte* p, GLuint v) { memcpy(p, &v, 4); }
+static inline void CC3PixelStore16(GLubyte* p, GLushort v) { memcpy(p, &v, 2); }
+
+/*
+ * Each RGBA8888 pixel is read as a little-endian 32-bit value, with R in the low byte and
+ * A in the high byte. The following functions pack that value into the other pixel formats.
+ */
+
+static inline GLushort CC3PixelRGB565(GLuint p) {
+	return ((p << 8) & 0xF800) | ((p >> 5) & 0x07E0) | ((p >> 19) & 0x001F);
+}
+
+static inline GLushort CC3PixelRGBA4444(GLuint p) {
+	return ((p << 8) & 0xF000) | ((p >> 4) & 0x0F00) | ((p >> 16) & 0x00F0) | (p >> 28);
+}
+
+static inline GLushort CC3PixelRGBA5551(GLuint p) {
+	return ((p << 8) & 0xF800) | ((p >> 5) & 0x07C0) | ((p >> 18) & 0x003E) | (p >> 31);
+}
+
+/*
+ * BT.709 luminosity weights, scaled by 2^24. Together with the rounding bias, the resulting
+ * luminance byte is identical to that of CCColorByteFromFloat(CC3LuminosityBT709(...)) for
+ * every RGB combination. The weighted sum of any pixel fits within 32 bits.
+ */
+#define kCC3LumaWeightR		3566836
+#define kCC3LumaWeightG		11999065
+#define kCC3LumaWeightB		1211315
+#define kCC3LumaBias		512
+
+static inline GLuint CC3PixelLuminance(GLuint p) {
+	return ((p & 0xFF) * kCC3LumaWeightR +
+			((p >> 8) & 0xFF) * kCC3LumaWeightG +
+			((p >> 16) & 0xFF) * kCC3LumaWeightB +
+			kCC3LumaBias) >> 24;
+}
+
+#if CC3_SIMD
+
+/** Four 32-bit pixels held in a single NEON or SSE vector register. */
+#if CC3_NEON
+typedef uint32x4_t CC3SIMDPixel4;
+#else
+typedef __m128i CC3SIMDPixel4;
+#endif
+
+/** Loads 16 bytes, which need not be aligned, from the specified memory. */
+static inline CC3SIMDPixel4 CC3SIMDPixel4Load(const GLubyte* p) {
+#if CC3_NEON
+	return vreinterpretq_u32_u8(vld1q_u8(p));
+#else
+	return _mm_loadu_si128((const __m128i*)p);
+#endif
+}
+
+/** Stores 16 bytes, which need not be aligned, into the specified memory. */
+static inline void CC3SIMDPixel4Store(GLubyte* p, CC3SIMDPixel4 v) {
+#if CC3_NEON
+	vst1q_u8(p, vreinterpretq_u8_u32(v));
+#else
+	_mm_storeu_si128((__m128i*)p, v);
+#endif
+}
+
+/** Shifts each 32-bit element left or right by the specified constant number of bits. */
+#if CC3_NEON
+#	define CC3SIMDPixel4ShiftLeft(v, n)		vshlq_n_u32((v), (n))
+#	define CC3SIMDPixel4ShiftRight(v, n)	vshrq_n_u32((v), (n))
+#else
+#	define CC3SIMDPixel4ShiftLeft(v, n)		_mm_slli_epi32((v), (n))
+#	define CC3SIMDPixel4ShiftRight(v, n)	_mm_srli_epi32((v), (n))
+#endif
+
+/** Returns the bitwise AND of each 32-bit element with the specified mask. */
+static inline CC3SIMDPixel4 CC3SIMDPixel4Mask(CC3SIMDPixel4 v, GLuint mask) {
+#if CC3_NEON
+	return vandq_u32(v, vdupq_n_u32(mask));
+#else
+	return _mm_and_si128(v, _mm_set1_epi32(mask));
+#endif
+}
+
+/** Returns the bitwise OR of the specified vectors. */
+static inline CC3SIMDPixel4 CC3SIMDPixel4Or(CC3SIMDPixel4 a, CC3SIMDPixel4 b) {
+#if CC3_NEON
+	return vorrq_u32(a, b);
+#else
+	return _mm_or_si128(a, b);
+#endif
+}
+
+/** Returns the element-by-element 32-bit sum of the specified vectors. */
+static inline CC3SIMDPixel4 CC3SIMDPixel4Add(CC3SIMDPixel4 a, CC3SIMDPixel4 b) {
+#if CC3_NEON
+	return vaddq_u32(a, b);
+#else
+	return _mm_add_epi32(a, b);
+#endif
+}
+
+/** Returns the low 32 bits of the product of each element with the specified value. */
+static inline CC3SIMDPixel4 CC3SIMDPixel4Multiply(CC3SIMDPixel4 v, GLuint n) {
+#if CC3_NEON
+	return vmulq_n_u32(v, n);
+#else
+	// SSE2 has no 32-bit low multiply, so multiply the even and odd elements separately
+	__m128i vn = _mm_set1_epi32(n);
+	__m128i even = _mm_mul_epu32(v, vn);
+	__m128i odd = _mm_mul_epu32(_mm_srli_si128(v, 4), vn);
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+							  _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+}
+
+/**
+ * Narrows each 32-bit element of the two vectors, whose values must fit within 16 bits,
+ * into a single vector of eight 16-bit elements, with the elements of a first.
+ */
+static inline CC3SIMDPixel4 CC3SIMDPixel4Narrow32(CC3SIMDPixel4 a, CC3SIMDPixel4 b) {
+#if CC3_NEON
+	return vreinterpretq_u32_u16(vcombine_u16(vmovn_u32(a), vmovn_u32(b)));
+#else
+	// Sign-extend the low 16 bits, so that the saturating pack leaves them unchanged
+	return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16),
+						   _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+#endif
+}
+
+/**
+ * Narrows each 16-bit element of the two vectors, whose values must fit within 8 bits,
+ * into a single vector of sixteen 8-bit elements, with the elements of a first.
+ */
+static inline CC3SIMDPixel4 CC3SIMDPixel4Narrow16(CC3SIMDPixel4 a, CC3SIMDPixel4 b) {
+#if CC3_NEON
+	return vreinterpretq_u32_u8(vcombine_u8(vmovn_u16(vreinterpretq_u16_u32(a)),
+											vmovn_u16(vreinterpretq_u16_u32(b))));
+#else
+	return _mm_packus_epi16(a, b);
+#endif
+}
+
+/** Reverses the order of the elements of the specified size (1, 2 or 4 bytes) in the vector. */
+static inline CC3SIMDPixel4 CC3SIMDPixel4Reverse(CC3SIMDPixel4 v, GLuint elementSize) {
+#if CC3_NEON
+	uint8x16_t r;
+	switch (elementSize) {
+		case 1: r = vrev64q_u8(vreinterpretq_u8_u32(v)); break;
+		case 2: r = vreinterpretq_u8_u16(vrev64q_u16(vreinterpretq_u16_u32(v))); break;
+		default: r = vreinterpretq_u8_u32(vrev64q_u32(v)); break;
+	}
+	return vreinterpretq_u32_u8(vcombine_u8(vget_high_u8(r), vget_low_u8(r)));
+#else
+	if (elementSize == 4) return _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+	v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+	v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+	v = _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+	if (elementSize == 1) v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+	return v;
+#endif
+}
+
+static inline CC3SIMDPixel4 CC3SIMDPixel4RGB565(CC3SIMDPixel4 p) {
+	return CC3SIMDPixel4Or(CC3SIMDPixel4Or(CC3SIMDPixel4Mask(CC3SIMDPixel4ShiftLeft(p, 8), 0xF800),
+										   CC3SIMDPixel4Mask(CC3SIMDPixel4ShiftRight(p, 5), 0x07E0)),
+						   CC3SIMDPixel4Mask(CC3SIMDPixel4ShiftRight(p, 19), 0x001F));
+}
+
+static inline CC3SIMDPixel4 CC3SIMDPixel4RGBA4444(CC3SIMDPixel4 p) {
+	return CC3SIMDPixel4Or(CC3SIMDPixel4Or(CC3SIMDPixel4Mask(CC3SIMDPixel4ShiftLeft(p, 8), 0xF000),
+										   CC3SIMDPixel4Mask(CC3SIMDPixel4ShiftRight(p, 4), 0x0F00)),
+						   CC3SIMDPixel4Or(CC3SIMDPixel4Mask(CC3SIMDPixel4ShiftRight(p, 16), 0x00F0),
+										   CC3SIMDPixel4ShiftRight(p, 28)));
+}
+
+static inline CC3SIMDPixel4 CC3SIMDPixel4RGBA5551(CC3SIMDPixel4 p) {
+	return CC3SIMDPixel4Or(CC3SIMDPixel4Or(CC3SIMDPixel4Mask(CC3SIMDPixel4ShiftLeft(p, 8), 0xF800),
+										   CC3SIMDPixel4Mask(CC3SIMDPixel4ShiftRight(p, 5), 0x07C0)),
+						   CC3SIMDPixel4Or(CC3SIMDPixel4Mask(CC3SIMDPixel4ShiftRight(p, 18), 0x003E),
+										   CC3SIMDPixel4ShiftRight(p, 31)));
+}
+
+static inline CC3SIMDPixel4 CC3SIMDPixel4Luminance(CC3SIMDPixel4 p) {
+	CC3SIMDPixel4 sum = CC3SIMDPixel4Multiply(CC3SIMDPixel4Mask(p, 0xFF), kCC3LumaWeightR);
+	sum = CC3SIMDPixel4Add(sum, CC3SIMDPixel4Multiply(CC3SIMDPixel4Mask(CC3SIMDPixel4ShiftRight(p, 8), 0xFF),
+													  kCC3LumaWeightG));
+	sum = CC3SIMDPixel4Add(sum, CC3SIMDPixel4Multiply(CC3SIMDPixel4Mask(CC3SIMDPixel4ShiftRight(p, 16), 0xFF),
+													  kCC3LumaWeightB));
+#if CC3_NEON
+	sum = CC3SIMDPixel4Add(sum, vdupq_n_u32(kCC3LumaBias));
+#else
+	sum = CC3SIMDPixel4Add(sum, _mm_set1_epi32(kCC3LumaBias));
+#endif
+	return CC3SIMDPixel4ShiftRight(sum, 24);
+}
+
+#endif	// CC3_SIMD
+
+/** The conversions performed by CC3ConvertRGBA8888Pixels. */
+typedef enum {
+	kCC3PixelConversionNone,
+	kCC3PixelConversionRGB888,
+	kCC3PixelConversionA8,
+	kCC3PixelConversionL8,
+	kCC3PixelConversionLA88,
+	kCC3PixelConversionRGB565,
+	kCC3PixelConversionRGBA4444,
+	kCC3PixelConversionRGBA5551,
+} CC3PixelConversion;
+
+static CC3PixelConversion CC3PixelConversionFor(GLenum pixelFormat, GLenum pixelType) {
+	switch (pixelType) {
+		case GL_UNSIGNED_BYTE:
+			switch (pixelFormat) {
+				case GL_RGB: return kCC3PixelConversionRGB888;
+				case GL_ALPHA: return kCC3PixelConversionA8;
+				case GL_LUMINANCE: return kCC3PixelConversionL8;
+				case GL_LUMINANCE_ALPHA: return kCC3PixelConversionLA88;
+				default: return kCC3PixelConversionNone;
+			}
+		case GL_UNSIGNED_SHORT_5_6_5: return kCC3PixelConversionRGB565;
+		case GL_UNSIGNED_SHORT_4_4_4_4: return kCC3PixelConversionRGBA4444;
+		case GL_UNSIGNED_SHORT_5_5_5_1: return kCC3PixelConversionRGBA5551;
+		default: return kCC3PixelConversionNone;
+	}
+}
+
+static GLuint CC3PixelConversionBytesPerPixel(CC3PixelConversion conversion) {
+	switch (conversion) {
+		case kCC3PixelConversionRGB888: return 3;
+		case kCC3PixelConversionA8:
+		case kCC3PixelConversionL8: return 1;
+		case kCC3PixelConversionNone: return 4;
+		default: return 2;
+	}
+}
+
+/**
+ * Converts the specified run of RGBA8888 pixels, writing the converted pixels tightly packed
+ * at the start of the run. Each group of pixels is loaded before the converted group is stored,
+ * and the converted pixels never extend beyond the end of the group that was loaded.
+ */
+static void CC3ConvertPixelRun(CC3PixelConversion conversion, GLubyte* pixels, GLuint pixelCount) {
+	GLuint pixIdx = 0;
+	switch (conversion) {
+		case kCC3PixelConversionRGB565:
+		case kCC3PixelConversionRGBA4444:
+		case kCC3PixelConversionRGBA5551:
+#if CC3_SIMD
+			for (; pixIdx + 8 <= pixelCount; pixIdx += 8) {
+				CC3SIMDPixel4 p1 = CC3SIMDPixel4Load(pixels + (pixIdx * 4));
+				CC3SIMDPixel4 p2 = CC3SIMDPixel4Load(pixels + (pixIdx * 4) + 16);
+				if (conversion == kCC3PixelConversionRGB565) {
+					p1 = CC3SIMDPixel4RGB565(p1);
+					p2 = CC3SIMDPixel4RGB565(p2);
+				} else if (conversion == kCC3PixelConversionRGBA4444) {
+					p1 = CC3SIMDPixel4RGBA4444(p1);
+					p2 = CC3SIMDPixel4RGBA4444(p2);
+				} else {
+					p1 = CC3SIMDPixel4RGBA5551(p1);
+					p2 = CC3SIMDPixel4RGBA5551(p2);
+				}
+				CC3SIMDPixel4Store(pixels + (pixIdx * 2), CC3SIMDPixel4Narrow32(p1, p2));
+			}
+#endif
+			for (; pixIdx < pixelCount; pixIdx++) {
+				GLuint p = CC3PixelLoad32(pixels + (pixIdx * 4));
+				GLushort packed = ((conversion == kCC3PixelConversionRGB565) ? CC3PixelRGB565(p)
+								   : ((conversion == kCC3PixelConversionRGBA4444) ? CC3PixelRGBA4444(p)
+									  : CC3PixelRGBA5551(p)));
+				CC3PixelStore16(pixels + (pixIdx * 2), packed);
+			}
+			break;
+
+		case kCC3PixelConversionA8:
+		case kCC3PixelConversionL8:
+#if CC3_SIMD
+			for (; pixIdx + 16 <= pixelCount; pixIdx += 16) {
+				GLubyte* src = pixels + (pixIdx * 4);
+				CC3SIMDPixel4 p[4];
+				for (GLuint i = 0; i < 4; i++) {
+					p[i] = CC3SIMDPixel4Load(src + (i * 16));
+					p[i] = ((conversion == kCC3PixelConversionA8)
+							? CC3SIMDPixel4ShiftRight(p[i], 24)
+							: CC3SIMDPixel4Luminance(p[i]));
+				}
+				CC3SIMDPixel4Store(pixels + pixIdx,
+								   CC3SIMDPixel4Narrow16(CC3SIMDPixel4Narrow32(p[0], p[1]),
+														 CC3SIMDPixel4Narrow32(p[2], p[3])));
+			}
+#endif
+			for (; pixIdx < pixelCount; pixIdx++) {
+				GLuint p = CC3PixelLoad32(pixels + (pixIdx * 4));
+				pixels[pixIdx] = (conversion == kCC3PixelConversionA8) ? (p >> 24) : CC3PixelLuminance(p);
+			}
+			break;
+
+		case kCC3PixelConversionLA88:
+#if CC3_SIMD
+			for (; pixIdx + 8 <= pixelCount; pixIdx += 8) {
+				CC3SIMDPixel4 p1 = CC3SIMDPixel4Load(pixels + (pixIdx * 4));
+				CC3SIMDPixel4 p2 = CC3SIMDPixel4Load(pixels + (pixIdx * 4) + 16);
+				p1 = CC3SIMDPixel4Or(CC3SIMDPixel4Luminance(p1),
+									 CC3SIMDPixel4Mask(CC3SIMDPixel4ShiftRight(p1, 16), 0xFF00));
+				p2 = CC3SIMDPixel4Or(CC3SIMDPixel4Luminance(p2),
+									 CC3SIMDPixel4Mask(CC3SIMDPixel4ShiftRight(p2, 16), 0xFF00));
+				CC3SIMDPixel4Store(pixels + (pixIdx * 2), CC3SIMDPixel4Narrow32(p1, p2));
+			}
+#endif
+			for (; pixIdx < pixelCount; pixIdx++) {
+				GLuint p = CC3PixelLoad32(pixels + (pixIdx * 4));
+				pixels[pixIdx * 2] = CC3PixelLuminance(p);
+				pixels[(pixIdx * 2) + 1] = p >> 24;
+			}
+			break;
+
+		case kCC3PixelConversionRGB888:
+#if CC3_NEON
+			for (; pixIdx + 16 <= pixelCount; pixIdx += 16) {
+				uint8x16x4_t rgba = vld4q_u8(pixels + (pixIdx * 4));
+				uint8x16x3_t rgb = { { rgba.val[0], rgba.val[1], rgba.val[2] } };
+				vst3q_u8(pixels + (pixIdx * 3), rgb);
+			}
+#endif
+			// Pack four pixels into three 32-bit words at a time
+			for (; pixIdx + 4 <= pixelCount; pixIdx += 4) {
+				GLubyte* src = pixels + (pixIdx * 4);
+				GLuint p0 = CC3PixelLoad32(src);
+				GLuint p1 = CC3PixelLoad32(src + 4);
+				GLuint p2 = CC3PixelLoad32(src + 8);
+				GLuint p3 = CC3PixelLoad32(src + 12);
+				GLubyte* dst = pixels + (pixIdx * 3);
+				CC3PixelStore32(dst, (p0 & 0x00FFFFFF) | (p1 << 24));
+				CC3PixelStore32(dst + 4, ((p1 >> 8) & 0x0000FFFF) | (p2 << 16));
+				CC3PixelStore32(dst + 8, ((p2 >> 16) & 0x000000FF) | (p3 << 8));
+			}
+			for (; pixIdx < pixelCount; pixIdx++)
+				memmove(pixels + (pixIdx * 3), pixels + (pixIdx * 4), 3);
+			break;
+
+		default:
+			break;
+	}
+}
+
+void CC3ConvertRGBA8888Pixels(ccColor4B* pixels, GLuint pixelCount, GLenum pixelFormat, GLenum pixelType) {
+	CC3PixelConversion conversion = CC3PixelConversionFor(pixelFormat, pixelType);
+	if ( !pixels || conversion == kCC3PixelConversionNone ) return;
+
+	GLubyte* pixBytes = (GLubyte*)pixels;
+	GLuint dstBPP = CC3PixelConversionBytesPerPixel(conversion);
+	GLuint chunkPixCnt = CC3PixelChunkItemCount(pixelCount, 4);
+
+	// Convert each chunk in place, at the start of its own range, so that the
+	// concurrent chunks never touch each other's memory...
+	CC3PixelChunksApply(pixelCount, chunkPixCnt, ^(GLuint startIdx, GLuint pixCnt) {
+		CC3ConvertPixelRun(conversion, pixBytes + (startIdx * 4), pixCnt);
+	});
+
+	// ...then move each converted chunk, in order, down to its final position.
+	for (GLuint startIdx = chunkPixCnt; startIdx < pixelCount; startIdx += chunkPixCnt)
+		memmove(pixBytes + (startIdx * dstBPP), pixBytes + (startIdx * 4),
+				MIN(chunkPixCnt, pixelCount - startIdx) * dstBPP);
+}
+
+/** Swaps the specified number of bytes between the two specified non-overlapping memory blocks. */
+static void CC3SwapBytes(GLubyte* a, GLubyte* b, GLuint byteCount) {
+	GLuint byteIdx = 0;
+#if CC3_SIMD
+	for (; byteIdx + 16 <= byteCount; byteIdx += 16) {
+		CC3SIMDPixel4 va = CC3SIMDPixel4Load(a + byteIdx);
+		CC3SIMDPixel4 vb = CC3SIMDPixel4Load(b + byteIdx);
+		CC3SIMDPixel4Store(a + byteIdx, vb);
+		CC3SIMDPixel4Store(b + byteIdx, va);
+	}
+#endif
+	for (; byteIdx < byteCount; byteIdx++) {
+		GLubyte tmp = a[byteIdx];
+		a[byteIdx] = b[byteIdx];
+		b[byteIdx] = tmp;
+	}
+}
+
+/**
+ * Swaps the specified number of pixels, starting at loPixels and moving forward, with the
+ * same number of pixels, ending at hiPixelsEnd and moving backward. The two ranges must either
+ * not overlap, or must be the two halves of the same range, to reverse that range in place.
+ */
+static void CC3SwapReversedPixels(GLubyte* loPixels, GLubyte* hiPixelsEnd, GLuint pixelCount, GLuint bytesPerPixel) {
+	GLuint pixIdx = 0;
+#if CC3_SIMD
+	if (bytesPerPixel == 4 || bytesPerPixel == 2 || bytesPerPixel == 1) {
+		GLuint vecPixCnt = 16 / bytesPerPixel;
+		for (; pixIdx + vecPixCnt <= pixelCount; pixIdx += vecPixCnt) {
+			GLubyte* lo = loPixels + (pixIdx * bytesPerPixel);
+			GLubyte* hi = hiPixelsEnd - ((pixIdx + vecPixCnt) * bytesPerPixel);
+			CC3SIMDPixel4 vLo = CC3SIMDPixel4Load(lo);
+			CC3SIMDPixel4 vHi = CC3SIMDPixel4Load(hi);
+			CC3SIMDPixel4Store(lo, CC3SIMDPixel4Reverse(vHi, bytesPerPixel));
+			CC3SIMDPixel4Store(hi, CC3SIMDPixel4Reverse(vLo, bytesPerPixel));
+		}
+	}
+#endif
+	for (; pixIdx < pixelCount; pixIdx++)
+		CC3SwapBytes(loPixels + (pixIdx * bytesPerPixel),
+					 hiPixelsEnd - ((pixIdx + 1) * bytesPerPixel), bytesPerPixel);
+}
+
 void CC3FlipVertically(GLubyte* rowMajorData, GLuint rowCount, GLuint bytesPerRow) {
 	if ( !rowMajorData ) return;		// If no data, nothing to flip!
 	
-	GLubyte tmpRow[bytesPerRow];
 	GLuint lastRowIdx = rowCount - 1;
 	GLuint halfRowCnt = rowCount / 2;
-	for (GLuint rowIdx = 0; rowIdx < halfRowCnt; rowIdx++) {
-		GLubyte* lowerRow = rowMajorData + (bytesPerRow * rowIdx);
-		GLubyte* upperRow = rowMajorData + (bytesPerRow * (lastRowIdx - rowIdx));
-		memcpy(tmpRow, upperRow, bytesPerRow);
-		memcpy(upperRow, lowerRow, bytesPerRow);
-		memcpy(lowerRow, tmpRow, bytesPerRow);
-		LogTrace(@"Swapped %u bytes in %p between row %u at %p and row %u at %p",
-				 bytesPerRow, rowMajorData, rowIdx, lowerRow, (lastRowIdx - rowIdx), upperRow);
+	CC3PixelChunksApply(halfRowCnt, CC3PixelChunkItemCount(halfRowCnt, bytesPerRow * 2), ^(GLuint startIdx, GLuint rowCnt) {
+		for (GLuint rowIdx = startIdx; rowIdx < startIdx + rowCnt; rowIdx++)
+			CC3SwapBytes(rowMajorData + (bytesPerRow * rowIdx),
+						 rowMajorData + (bytesPerRow * (lastRowIdx - rowIdx)), bytesPerRow);
+	});
+}
+
+void CC3FlipHorizontally(GLubyte* rowMajorData, GLuint rowCount, GLuint bytesPerRow, GLuint bytesPerPixel) {
+	if ( !rowMajorData || !bytesPerPixel ) return;		// If no data, nothing to flip!
+
+	GLuint pixPerRow = bytesPerRow / bytesPerPixel;
+	GLuint pixBytesPerRow = pixPerRow * bytesPerPixel;
+	CC3PixelChunksApply(rowCount, CC3PixelChunkItemCount(rowCount, bytesPerRow), ^(GLuint startIdx, GLuint rowCnt) {
+		for (GLuint rowIdx = startIdx; rowIdx < startIdx + rowCnt; rowIdx++) {
+			GLubyte* row = rowMajorData + (bytesPerRow * rowIdx);
+			CC3SwapReversedPixels(row, row + pixBytesPerRow, pixPerRow / 2, bytesPerPixel);
+		}
+	});
+}
+
+void CC3RotateHalfCircle(GLubyte* rowMajorData, GLuint rowCount, GLuint bytesPerRow, GLuint bytesPerPixel) {
+	if ( !rowMajorData || !bytesPerPixel ) return;		// If no data, nothing to rotate!
+
+	GLuint pixPerRow = bytesPerRow / bytesPerPixel;
+	GLuint pixBytesPerRow = pixPerRow * bytesPerPixel;
+	GLuint lastRowIdx = rowCount - 1;
+	GLuint halfRowCnt = rowCount / 2;
+
+	// Swap each row in the lower half with its mirror row in the upper half, reversing both
+	CC3PixelChunksApply(halfRowCnt, CC3PixelChunkItemCount(halfRowCnt, bytesPerRow * 2), ^(GLuint startIdx, GLuint rowCnt) {
+		for (GLuint rowIdx = startIdx; rowIdx < startIdx + rowCnt; rowIdx++)
+			CC3SwapReversedPixels(rowMajorData + (bytesPerRow * rowIdx),
+								  rowMajorData + (bytesPerRow * (lastRowIdx - rowIdx)) + pixBytesPerRow,
+								  pixPerRow, bytesPerPixel);
+	});
+
+	// If there is an odd number of rows, reverse the middle row in place
+	if (rowCount & 1) {
+		GLubyte* midRow = rowMajorData + (bytesPerRow * halfRowCnt);
+		CC3SwapReversedPixels(midRow, midRow + pixBytesPerRow, pixPerRow / 2, bytesPerPixel);
 	}
 }
 
@@ -192,8 +192,54 @@ static inline bool CC3IsWithinTolerance(float value, float benchmarkValue, float
 
 #define kRandomUIntMax 0x100000000LL
 
-/** Returns a random unsigned integer over the full unsigned interger range (between 0 and 0xFFFFFFFF). */
-static inline NSUInteger CC3RandomUInt() { return arc4random(); }
+/**
+ * Indicates whether the random number functions are drawing from the reproducible sequence
+ * established by the CC3RandomSeed function, instead of from arc4random().
+ *
+ * Do not set this flag directly. Use the CC3RandomSeed and CC3RandomUnseed functions.
+ */
+extern volatile BOOL CC3RandomIsSeeded;
+
+/**
+ * Seeds the random number functions, such as CC3RandomUInt and CC3RandomFloat, so that they
+ * return a sequence of values that is reproduced each time this function is invoked with the
+ * same seed. This is useful when testing, or when replaying a recording of a scene that emits
+ * particles with random characteristics.
+ *
+ * The seeded sequence is not thread-safe, and should only be drawn from the main thread.
+ * It is not suitable for cryptographic purposes.
+ */
+void CC3RandomSeed(uint64_t seed);
+
+/**
+ * Reverts the random number functions to drawing from arc4random(), which cannot be
+ * seeded, and is not reproducible.
+ */
+void CC3RandomUnseed(void);
+
+/**
+ * Returns the current state of the reproducible random sequence established by the CC3RandomSeed
+ * function. Passing the returned value to the CC3RandomSetState function resumes the sequence
+ * from the position at which this function was invoked.
+ */
+uint64_t CC3RandomGetState(void);
+
+/** Sets the current state of the reproducible random sequence, and marks the sequence as seeded. */
+void CC3RandomSetState(uint64_t state);
+
+/**
+ * Returns the next value from the reproducible random sequence established by the CC3RandomSeed
+ * function. Rather than invoking this function directly, you should use CC3RandomUInt.
+ */
+uint32_t CC3RandomNextSeededUInt(void);
+
+/** 
+ * Returns a random unsigned integer over the full unsigned interger range (between 0 and 0xFFFFFFFF).
+ *
+ * The value is drawn from arc4random(), unless a reproducible sequence has been established
+ * using the CC3RandomSeed function.
+ */
+static inline NSUInteger CC3RandomUInt() { return CC3RandomIsSeeded ? CC3RandomNextSeededUInt() : arc4random(); }
 
 /** Returns a random unsigned integer between 0 inclusive and the specified max exclusive. */
 static inline NSUInteger CC3RandomUIntBelow(NSUInteger max) { return CC3RandomUInt() % max; }
@@ -213,3 +259,61 @@ static inline float CC3RandomFloat() { return (float)CC3RandomDouble(); }
 static inline float CC3RandomFloatBetween(float min, float max) {
 	return (float)CC3RandomDoubleBetween(min, max);
 }
+
+
+#pragma mark Random number streams
+
+/**
+ * A stream of random numbers that is reproduced each time the stream is seeded with the same
+ * seed and sequence, using the PCG32 (XSH-RR) generator.
+ *
+ * Unlike the CC3RandomUInt family of functions, which share a single global sequence, each
+ * stream is independent, so an object that holds its own stream, such as a particle emitter,
+ * produces the same values regardless of the activity of other objects. A stream is not
+ * synchronized, but streams held by different objects may be drawn from concurrently on
+ * different threads. Drawing from a stream does not involve any system call, which makes
+ * streams suitable for initializing large bursts of particles.
+ *
+ * Streams are not suitable for cryptographic purposes.
+ */
+typedef struct {
+	uint64_t state;				/**< The current state of the generator. */
+	uint64_t increment;			/**< The odd increment that selects the sequence of the generator. */
+} CC3RandomStream;
+
+/**
+ * Seeds the specified stream. Streams seeded with different sequence values produce
+ * independent sequences of random numbers, even if they are seeded with the same seed.
+ */
+void CC3RandomStreamSeed(CC3RandomStream* stream, uint64_t seed, uint64_t sequence);
+
+/** Returns a random unsigned integer from the specified stream, over the full 32-bit range. */
+static inline uint32_t CC3RandomStreamUInt(CC3RandomStream* stream) {
+	uint64_t oldState = stream->state;
+	stream->state = (oldState * 6364136223846793005ULL) + stream->increment;
+	uint32_t xorShifted = (uint32_t)(((oldState >> 18) ^ oldState) >> 27);
+	uint32_t rot = (uint32_t)(oldState >> 59);
+	return (xorShifted >> rot) | (xorShifted << ((-rot) & 31));
+}
+
+/** Returns a random unsigned integer from the specified stream, between 0 inclusive and the specified max exclusive. */
+static inline uint32_t CC3RandomStreamUIntBelow(CC3RandomStream* stream, uint32_t max) {
+	return (uint32_t)(((uint64_t)CC3RandomStreamUInt(stream) * max) >> 32);
+}
+
+/** Returns a random float from the specified stream, between 0.0 inclusive and 1.0 exclusive. */
+static inline float CC3RandomStreamFloat(CC3RandomStream* stream) {
+	return (float)(CC3RandomStreamUInt(stream) >> 8) * (1.0f / 16777216.0f);
+}
+
+/** Returns a random float from the specified stream, between the specified min inclusive and the specified max exclusive. */
+static inline float CC3RandomStreamFloatBetween(CC3RandomStream* stream, float min, float max) {
+	return min + (CC3RandomStreamFloat(stream) * (max - min));
+}
+
+/**
+ * Fills the specified array of floats with random values from the specified stream, each
+ * between the specified min inclusive and the specified max exclusive.
+ */
+void CC3RandomStreamFillFloatsBetween(CC3RandomStream* stream, float* values, NSUInteger count,
+									  float min, float max);
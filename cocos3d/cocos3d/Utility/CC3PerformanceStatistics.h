@@ -34,6 +34,119 @@
 #import "CC3CC2Extensions.h"
 
 
+#pragma mark -
+#pragma mark Performance phases
+
+/**
+ * The phases of the updating and drawing of the 3D scene that are timed individually
+ * by CC3PerformanceStatistics.
+ *
+ * The phases form a hierarchy, as indicated by the CC3PerformancePhaseParent function.
+ * The time spent in each phase is also included in the time spent in its parent phase.
+ */
+typedef enum {
+	kCC3PerformancePhaseUpdateScene,			/**< The updateScene: method of CC3Scene. */
+	kCC3PerformancePhaseUpdateNodes,			/**< The update visit of the nodes, including animation and transforms. */
+	kCC3PerformancePhaseUpdateCamera,			/**< The updateCamera: method of CC3Scene. */
+	kCC3PerformancePhaseUpdateBillboards,		/**< The updateBillboards: method of CC3Scene. */
+	kCC3PerformancePhaseUpdateShadows,			/**< The updateShadows: method of CC3Scene. */
+	kCC3PerformancePhaseUpdateDrawSequence,		/**< The sorting of the nodes into drawing order. */
+	kCC3PerformancePhaseDrawScene,				/**< The drawSceneWithVisitor: method of CC3Scene. */
+	kCC3PerformancePhaseDrawNodes,				/**< The lighting, backdrop and drawing visit of the nodes. */
+	kCC3PerformancePhaseDrawShadows,			/**< The drawing of the shadows cast by the lights. */
+	kCC3PerformancePhaseEnvironmentMapSnapshot,	/**< The rendering of a snapshot into an environment map. */
+	kCC3PerformancePhaseCount,					/**< The number of timed phases. */
+} CC3PerformancePhase;
+
+/** Returns a string description of the specified performance phase. */
+NSString* NSStringFromCC3PerformancePhase(CC3PerformancePhase phase);
+
+/**
+ * Returns the phase within which the specified performance phase is performed,
+ * or returns kCC3PerformancePhaseCount if the specified phase is not performed
+ * within another phase.
+ *
+ * Drawing phases that are performed while an environment map snapshot is being rendered
+ * are also included in the kCC3PerformancePhaseEnvironmentMapSnapshot phase.
+ */
+CC3PerformancePhase CC3PerformancePhaseParent(CC3PerformancePhase phase);
+
+/**
+ * Returns the current time, in seconds, from a monotonic clock that is inexpensive to
+ * read, and that is unaffected by changes to the system clock. The value returned is
+ * only meaningful when compared with another value returned by this function.
+ */
+CCTime CC3PerformanceTimestamp(void);
+
+
+#pragma mark -
+#pragma mark Allocation tracking
+
+/**
+ * Set this switch to enable or disable the ability to count the memory allocations made while
+ * each performance phase is being timed. This can be set either here or via the compiler build
+ * setting GCC_PREPROCESSOR_DEFINITIONS in your build configuration. By default, this switch is
+ * enabled in debug builds only.
+ *
+ * When this switch is enabled, allocations are only counted while tracking has been started
+ * using the CC3AllocationTrackingStart function. When this switch is disabled, the allocation
+ * counts of all phases remain at zero, and timing a phase incurs no additional cost.
+ *
+ * Allocations are counted by installing a hook into the system memory allocator, and are
+ * therefore only counted on platforms whose allocator supports such a hook, currently iOS and OSX.
+ */
+#ifndef CC3_ALLOCATION_TRACKING_ENABLED
+#	if defined(DEBUG) && DEBUG
+#		define CC3_ALLOCATION_TRACKING_ENABLED	1
+#	else
+#		define CC3_ALLOCATION_TRACKING_ENABLED	0
+#	endif
+#endif
+
+/**
+ * Starts counting the memory allocations made on the current thread. Allocations made on other
+ * threads, such as by background tasks, are not counted. Counting continues until the
+ * CC3AllocationTrackingStop function is invoked.
+ *
+ * The counts returned by the CC3AllocationCount and CC3AllocatedBytes functions are not reset
+ * by this function. Measure allocations by comparing the counts before and after an activity.
+ *
+ * This function has no effect if CC3_ALLOCATION_TRACKING_ENABLED is disabled, or if the
+ * platform does not support counting allocations.
+ */
+void CC3AllocationTrackingStart(void);
+
+/** Stops counting memory allocations, as started by the CC3AllocationTrackingStart function. */
+void CC3AllocationTrackingStop(void);
+
+/** Returns whether memory allocations are currently being counted. */
+BOOL CC3AllocationTrackingIsActive(void);
+
+/** Returns the number of memory allocations counted while allocation tracking has been active. */
+NSUInteger CC3AllocationCount(void);
+
+/** Returns the number of bytes allocated while allocation tracking has been active. */
+NSUInteger CC3AllocatedBytes(void);
+
+/** The number of most recent samples of each phase used to determine percentile durations. */
+#define kCC3PerformancePhaseSampleCapacity	256
+
+/** The accumulated timing of a single performance phase. */
+typedef struct {
+	GLuint count;										/**< The number of times the phase was timed. */
+	GLuint depth;										/**< The nesting depth of the phase currently being timed. */
+	CCTime startTime;									/**< The time the outermost current timing started. */
+	CCTime totalDuration;								/**< The total duration of the phase. */
+	CCTime minimumDuration;								/**< The shortest duration of the phase. */
+	CCTime maximumDuration;								/**< The longest duration of the phase. */
+	GLfloat samples[kCC3PerformancePhaseSampleCapacity];	/**< The most recent durations, as a ring. */
+	NSUInteger allocationCount;							/**< The number of allocations made during the phase. */
+	NSUInteger allocatedBytes;							/**< The number of bytes allocated during the phase. */
+	NSUInteger startAllocationCount;					/**< The allocation count when the outermost current timing started. */
+	NSUInteger startAllocatedBytes;						/**< The allocated bytes when the outermost current timing started. */
+} CC3PerformancePhaseTiming;
+
+
 #pragma mark -
 #pragma mark CC3PerformanceStatistics
 
@@ -58,6 +171,21 @@
 	GLuint _nodesDrawn;
 	GLuint _drawingCallsMade;
 	GLuint _facesPresented;
+	
+	GLuint _backgroundTasksStarted;
+	CCTime _accumulatedBackgroundTaskLatency;
+	CCTime _peakBackgroundTaskLatency;
+	GLuint _accumulatedBackgroundTaskQueueDepth;
+	GLuint _peakBackgroundTaskQueueDepth;
+	
+	GLuint _shadowVolumesBuilt;
+	GLuint _shadowFacesClassified;
+	GLuint _shadowSilhouetteEdges;
+	GLuint _shadowVolumesReused;
+	GLuint _shadowSilhouettesReused;
+	CCTime _accumulatedShadowBuildTime;
+	
+	CC3PerformancePhaseTiming _phaseTimings[kCC3PerformancePhaseCount];
 }
 
 
@@ -171,6 +299,208 @@
 -(void) addSingleCallFacesPresented: (GLuint) faceCount;
 
 
+#pragma mark Accumulated background task statistics
+
+/**
+ * The number of tasks started by the worker pool of the CC3Backgrounder
+ * since the reset method was last invoked.
+ */
+@property(nonatomic, readonly) GLuint backgroundTasksStarted;
+
+/**
+ * The total time that background tasks started since the reset method was last invoked
+ * spent waiting in the CC3Backgrounder worker pool between being submitted and being started.
+ */
+@property(nonatomic, readonly) CCTime accumulatedBackgroundTaskLatency;
+
+/**
+ * The longest time that any single background task started since the reset method was last
+ * invoked spent waiting in the CC3Backgrounder worker pool before being started.
+ */
+@property(nonatomic, readonly) CCTime peakBackgroundTaskLatency;
+
+/**
+ * Adds the specified number of started background tasks to the backgroundTasksStarted property,
+ * adds the specified total latency to the accumulatedBackgroundTaskLatency property, and updates
+ * the peakBackgroundTaskLatency property from the specified peak latency.
+ *
+ * This method is invoked automatically by the collectStatisticsInto: method of CC3Backgrounder.
+ */
+-(void) addBackgroundTasksStarted: (GLuint) taskCount
+					  withLatency: (CCTime) totalLatency
+				   andPeakLatency: (CCTime) peakLatency;
+
+/**
+ * The largest number of tasks waiting in, or being run by, the CC3Backgrounder worker pool,
+ * as sampled on each update since the reset method was last invoked.
+ */
+@property(nonatomic, readonly) GLuint peakBackgroundTaskQueueDepth;
+
+/**
+ * Adds a sample of the number of tasks waiting in, or being run by, the CC3Backgrounder
+ * worker pool, and updates the peakBackgroundTaskQueueDepth property.
+ *
+ * This method is invoked automatically by the collectStatisticsInto: method of CC3Backgrounder.
+ */
+-(void) addBackgroundTaskQueueDepth: (GLuint) queueDepth;
+
+
+#pragma mark Accumulated shadow volume statistics
+
+/** The number of shadow volume meshes that have been built since the reset method was last invoked. */
+@property(nonatomic, readonly) GLuint shadowVolumesBuilt;
+
+/**
+ * The total number of shadow-casting faces that were classified as facing towards or away
+ * from a light, while building shadow volume meshes, since the reset method was last invoked.
+ */
+@property(nonatomic, readonly) GLuint shadowFacesClassified;
+
+/**
+ * The total number of terminator edges that were extruded to form the sides of shadow
+ * volume meshes since the reset method was last invoked.
+ */
+@property(nonatomic, readonly) GLuint shadowSilhouetteEdges;
+
+/**
+ * The total time spent building shadow volume meshes since the reset method was last invoked.
+ *
+ * When several shadow volumes are built concurrently, this is the sum of the time taken to
+ * build each, and may therefore be larger than the time that elapsed during the update.
+ */
+@property(nonatomic, readonly) CCTime accumulatedShadowBuildTime;
+
+/**
+ * Increments the shadowVolumesBuilt property by one, and adds the specified number of classified
+ * faces and terminator edges, and the specified build time, to the shadowFacesClassified,
+ * shadowSilhouetteEdges and accumulatedShadowBuildTime properties, respectively.
+ *
+ * This method is invoked automatically by the updateShadows:withStatistics: method of
+ * CC3ShadowVolumeMeshNode.
+ */
+-(void) addShadowVolumeBuildWithFacesClassified: (GLuint) faceCount
+								silhouetteEdges: (GLuint) edgeCount
+									   duration: (CCTime) buildTime;
+
+/**
+ * The number of times since the reset method was last invoked that a shadow volume needed
+ * updating, but was found to be unchanged, and was reused without being rebuilt.
+ *
+ * Shadow volumes that are reused are not included in the shadowVolumesBuilt property.
+ */
+@property(nonatomic, readonly) GLuint shadowVolumesReused;
+
+/** Increments the shadowVolumesReused property by one. */
+-(void) incrementShadowVolumesReused;
+
+/**
+ * The number of shadow volume meshes built since the reset method was last invoked, whose
+ * faces were lit exactly as they were during the previous build, and which therefore reused
+ * the previous terminator edges, and only rewrote their vertices.
+ *
+ * These shadow volumes are also included in the shadowVolumesBuilt property.
+ */
+@property(nonatomic, readonly) GLuint shadowSilhouettesReused;
+
+/** Increments the shadowSilhouettesReused property by one. */
+-(void) incrementShadowSilhouettesReused;
+
+
+#pragma mark Accumulated phase timing statistics
+
+/**
+ * Starts timing the specified phase. This must be paired with a subsequent invocation
+ * of the endPhase: method for the same phase.
+ *
+ * Phases may be nested within each other. If the specified phase is already being timed,
+ * the nested begin and end are ignored, and only the outermost timing is recorded.
+ *
+ * The CC3Scene invokes this method automatically for each of the phases defined in the
+ * CC3PerformancePhase enumeration. The application can also invoke this method directly,
+ * if it performs the activity of a phase outside the CC3Scene methods.
+ */
+-(void) beginPhase: (CC3PerformancePhase) phase;
+
+/**
+ * Stops timing the specified phase, which was started by a previous invocation of the
+ * beginPhase: method, and adds the elapsed time to the statistics of that phase, using
+ * the addDuration:toPhase: method.
+ */
+-(void) endPhase: (CC3PerformancePhase) phase;
+
+/**
+ * Adds the specified duration to the statistics of the specified phase, and increments
+ * the number of times the phase has been timed by one.
+ *
+ * This method is invoked automatically by the endPhase: method, and can also be invoked
+ * directly to add a duration that was timed elsewhere.
+ */
+-(void) addDuration: (CCTime) duration toPhase: (CC3PerformancePhase) phase;
+
+/** Returns the number of times the specified phase has been timed since the reset method was last invoked. */
+-(GLuint) countOfPhase: (CC3PerformancePhase) phase;
+
+/** Returns the total time spent in the specified phase since the reset method was last invoked. */
+-(CCTime) totalDurationOfPhase: (CC3PerformancePhase) phase;
+
+/** Returns the shortest time spent in the specified phase since the reset method was last invoked. */
+-(CCTime) minimumDurationOfPhase: (CC3PerformancePhase) phase;
+
+/** Returns the longest time spent in the specified phase since the reset method was last invoked. */
+-(CCTime) maximumDurationOfPhase: (CC3PerformancePhase) phase;
+
+/**
+ * Returns the average time spent in the specified phase, calculated by dividing the
+ * totalDurationOfPhase: by the countOfPhase:.
+ */
+-(CCTime) averageDurationOfPhase: (CC3PerformancePhase) phase;
+
+/**
+ * Returns the time within which the specified percentage of the timings of the specified phase
+ * completed, using the nearest-rank method. For example, if the specified percentile is 95,
+ * 95% of the timings of the phase took no longer than the returned duration.
+ *
+ * The percentile is calculated from the most recent kCC3PerformancePhaseSampleCapacity timings
+ * of the phase since the reset method was last invoked. Returns zero if the phase has not been timed.
+ */
+-(CCTime) durationOfPhase: (CC3PerformancePhase) phase atPercentile: (GLfloat) percentile;
+
+/**
+ * Returns the number of memory allocations made on the tracked thread while the specified phase
+ * was being timed, since the reset method was last invoked.
+ *
+ * Allocations are only counted while allocation tracking is active. See the notes for the
+ * CC3_ALLOCATION_TRACKING_ENABLED switch and the CC3AllocationTrackingStart function.
+ * This can be used to check whether the update and drawing phases of a steady-state scene
+ * allocate memory each frame.
+ */
+-(NSUInteger) allocationCountOfPhase: (CC3PerformancePhase) phase;
+
+/**
+ * Returns the number of bytes allocated on the tracked thread while the specified phase was
+ * being timed, since the reset method was last invoked.
+ *
+ * See the notes for the allocationCountOfPhase: method.
+ */
+-(NSUInteger) allocatedBytesOfPhase: (CC3PerformancePhase) phase;
+
+/**
+ * Returns the average number of memory allocations made each time the specified phase was
+ * timed, calculated by dividing the allocationCountOfPhase: by the countOfPhase:.
+ */
+-(GLfloat) averageAllocationCountOfPhase: (CC3PerformancePhase) phase;
+
+/**
+ * Returns a description of the timings of each phase that has been timed, as a hierarchy of
+ * the phases, listing the count, minimum, average, maximum, 50th, 95th and 99th percentile
+ * durations of each phase, in milliseconds.
+ *
+ * If CC3_ALLOCATION_TRACKING_ENABLED is enabled, the number of allocations and bytes
+ * allocated during each phase is also listed.
+ */
+@property(nonatomic, readonly) NSString* phaseDescription;
+
+
 #pragma mark Average update statistics
 
 /**
@@ -192,6 +522,32 @@
 @property(nonatomic, readonly) GLfloat averageNodesTransformedPerUpdate;
 
 
+#pragma mark Average background task statistics
+
+/**
+ * The average time that background tasks waited in the CC3Backgrounder worker pool before
+ * being started, calculated by dividing the accumulatedBackgroundTaskLatency property by
+ * the backgroundTasksStarted property.
+ */
+@property(nonatomic, readonly) GLfloat averageBackgroundTaskLatency;
+
+/**
+ * The average number of tasks waiting in, or being run by, the CC3Backgrounder worker pool
+ * per update, calculated by dividing the accumulated sampled queue depths by the
+ * updatesHandled property.
+ */
+@property(nonatomic, readonly) GLfloat averageBackgroundTaskQueueDepth;
+
+
+#pragma mark Average shadow volume statistics
+
+/**
+ * The average time taken to build a single shadow volume mesh, calculated by dividing
+ * the accumulatedShadowBuildTime property by the shadowVolumesBuilt property.
+ */
+@property(nonatomic, readonly) GLfloat averageShadowBuildTime;
+
+
 #pragma mark Average frame drawing statistics
 
 /**
@@ -266,6 +622,9 @@
 // Number of buckets in each of the histograms
 #define kCC3RateHistogramSize 80
 
+// Number of buckets in each of the phase duration histograms
+#define kCC3PhaseHistogramSize 64
+
 /**
  * Collects statistics about the updating and drawing performance of the 3D scene,
  * including a histogram for each of the raw updateRate and frameRate properties.
@@ -284,6 +643,7 @@
 @interface CC3PerformanceStatisticsHistogram : CC3PerformanceStatistics {
 	GLint _updateRateHistogram[kCC3RateHistogramSize];
 	GLint _frameRateHistogram[kCC3RateHistogramSize];
+	GLint _phaseHistograms[kCC3PerformancePhaseCount][kCC3PhaseHistogramSize];
 }
 
 /**
@@ -304,5 +664,111 @@
  */
 @property(nonatomic, readonly) GLint* frameRateHistogram;
 
+/**
+ * Returns a histogram of the durations of the specified phase, as timed each time the phase
+ * was performed. This provides more detail than the percentile durations of the phase, which
+ * are calculated only from the most recent timings.
+ *
+ * The histogram contains kCC3PhaseHistogramSize buckets, each a quarter of a doubling wider
+ * than the previous bucket. The bucket at index i counts durations of at least 2^(i/4)
+ * microseconds, and less than the duration of the next bucket. The first bucket also counts
+ * all shorter durations, and the last bucket also counts all longer durations.
+ *
+ * This histogram is cleared when the reset method is invoked.
+ */
+-(GLint*) histogramForPhase: (CC3PerformancePhase) phase;
+
+/** Returns the shortest duration counted by the phase histogram bucket at the specified index. */
+-(CCTime) durationOfPhaseHistogramBucket: (GLint) bucketIndex;
+
 @end
 
+
+
+#pragma mark -
+#pragma mark Trace events
+
+/**
+ * Set this switch to enable or disable the ability to record trace events. This can be set
+ * either here or via the compiler build setting GCC_PREPROCESSOR_DEFINITIONS in your build
+ * configuration.
+ *
+ * When this switch is enabled, trace events are only recorded while recording has been started
+ * using the CC3TraceStartRecording function. While recording is stopped, each CC3TraceBegin and
+ * CC3TraceEnd invocation costs only the test of a single global flag. When this switch is
+ * disabled, the CC3TraceBegin and CC3TraceEnd invocations are completely removed from the
+ * compiled code.
+ */
+#ifndef CC3_TRACING_ENABLED
+#	define CC3_TRACING_ENABLED		1
+#endif
+
+/** The default maximum number of trace events retained while recording. */
+#define kCC3TraceDefaultCapacity		(64 * 1024)
+
+/** The maximum length of the detail text that can be attached to a trace event. */
+#define kCC3TraceEventDetailLength		48
+
+/** 
+ * Indicates whether trace events are currently being recorded.
+ *
+ * Do not set this flag directly. Use the CC3TraceStartRecording and CC3TraceStopRecording functions.
+ */
+extern volatile BOOL CC3TraceIsRecording;
+
+/**
+ * Starts recording trace events, discarding any events that were previously recorded.
+ *
+ * Recorded events are held in a ring buffer that retains the specified number of the most
+ * recent events. Once the buffer is full, each new event replaces the oldest event. If the
+ * specified capacity is zero, kCC3TraceDefaultCapacity is used.
+ *
+ * This function should be invoked from the main thread.
+ */
+void CC3TraceStartRecording(GLuint capacity);
+
+/** 
+ * Stops recording trace events. The events that have been recorded are retained,
+ * and can be written to a file using the CC3TraceWriteToFile function.
+ */
+void CC3TraceStopRecording(void);
+
+/**
+ * Writes the recorded trace events to the file at the specified path, in the Chrome trace
+ * event JSON format, which can be opened by chrome://tracing and the Perfetto UI.
+ *
+ * Each event identifies the thread on which it was recorded. End events whose matching begin
+ * events have been overwritten in the ring buffer are not written. This function may be invoked
+ * while events are still being recorded.
+ *
+ * Returns whether the file was written successfully.
+ */
+BOOL CC3TraceWriteToFile(NSString* filePath);
+
+/**
+ * Records a trace event of the specified phase, which should be 'B' to begin, or 'E' to end,
+ * an activity on the current thread. This function may be invoked from any thread.
+ *
+ * The name and category must be string constants, or otherwise remain valid until the events
+ * have been written. The detail may be NULL, and is copied, and truncated if it is longer than
+ * kCC3TraceEventDetailLength.
+ *
+ * Rather than invoking this function directly, you should use the CC3TraceBegin and
+ * CC3TraceEnd macros, which avoid invoking this function when not recording.
+ */
+void CC3TraceRecordEvent(char phase, const char* name, const char* category, const char* detail);
+
+/**
+ * Records the beginning and end of an activity on the current thread, respectively, if trace
+ * events are being recorded. The arguments are not evaluated unless trace events are being
+ * recorded, so the detail may be safely derived from objects, such as a file name.
+ */
+#if CC3_TRACING_ENABLED
+#	define CC3TraceBegin(name, category, detail)	\
+		do { if (CC3TraceIsRecording) CC3TraceRecordEvent('B', (name), (category), (detail)); } while (0)
+#	define CC3TraceEnd(name, category)	\
+		do { if (CC3TraceIsRecording) CC3TraceRecordEvent('E', (name), (category), NULL); } while (0)
+#else
+#	define CC3TraceBegin(name, category, detail)
+#	define CC3TraceEnd(name, category)
+#endif
@@ -30,6 +30,152 @@
  */
 
 #import "CC3PerformanceStatistics.h"
+#import <pthread.h>
+#import <unistd.h>
+#if defined(__APPLE__)
+#	import <mach/mach_time.h>
+#else
+#	include <time.h>
+#	include <sys/syscall.h>
+#endif
+
+
+#pragma mark -
+#pragma mark Performance phases
+
+NSString* NSStringFromCC3PerformancePhase(CC3PerformancePhase phase) {
+	switch (phase) {
+		case kCC3PerformancePhaseUpdateScene: return @"UpdateScene";
+		case kCC3PerformancePhaseUpdateNodes: return @"UpdateNodes";
+		case kCC3PerformancePhaseUpdateCamera: return @"UpdateCamera";
+		case kCC3PerformancePhaseUpdateBillboards: return @"UpdateBillboards";
+		case kCC3PerformancePhaseUpdateShadows: return @"UpdateShadows";
+		case kCC3PerformancePhaseUpdateDrawSequence: return @"UpdateDrawSequence";
+		case kCC3PerformancePhaseDrawScene: return @"DrawScene";
+		case kCC3PerformancePhaseDrawNodes: return @"DrawNodes";
+		case kCC3PerformancePhaseDrawShadows: return @"DrawShadows";
+		case kCC3PerformancePhaseEnvironmentMapSnapshot: return @"EnvironmentMapSnapshot";
+		default: return [NSString stringWithFormat: @"Unknown performance phase (%u)", phase];
+	}
+}
+
+CC3PerformancePhase CC3PerformancePhaseParent(CC3PerformancePhase phase) {
+	switch (phase) {
+		case kCC3PerformancePhaseUpdateNodes:
+		case kCC3PerformancePhaseUpdateCamera:
+		case kCC3PerformancePhaseUpdateBillboards:
+		case kCC3PerformancePhaseUpdateShadows:
+		case kCC3PerformancePhaseUpdateDrawSequence:
+			return kCC3PerformancePhaseUpdateScene;
+		case kCC3PerformancePhaseDrawNodes:
+		case kCC3PerformancePhaseDrawShadows:
+			return kCC3PerformancePhaseDrawScene;
+		default:
+			return kCC3PerformancePhaseCount;
+	}
+}
+
+CCTime CC3PerformanceTimestamp(void) {
+#if defined(__APPLE__)
+	static double secondsPerTick = 0.0;
+	if ( !secondsPerTick ) {
+		mach_timebase_info_data_t timebase;
+		mach_timebase_info(&timebase);
+		secondsPerTick = (double)timebase.numer / (double)timebase.denom * 1.0e-9;
+	}
+	return (CCTime)(mach_absolute_time() * secondsPerTick);
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (CCTime)now.tv_sec + (CCTime)now.tv_nsec * 1.0e-9;
+#endif
+}
+
+
+#pragma mark -
+#pragma mark Allocation tracking
+
+#if CC3_ALLOCATION_TRACKING_ENABLED && defined(__APPLE__)
+
+/**
+ * The signature of the hook that the system allocator invokes on each allocation and
+ * deallocation, while the hook is installed in the malloc_logger variable.
+ */
+typedef void (CC3MallocLogger)(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3,
+							   uintptr_t result, uint32_t numHotFramesToSkip);
+
+/** The hook exported by the system allocator, as used by malloc stack logging. */
+extern CC3MallocLogger* malloc_logger;
+
+/** The flags of the type argument of the malloc_logger hook. */
+#define kCC3MallocLogTypeAllocate		2
+#define kCC3MallocLogTypeDeallocate		4
+#define kCC3MallocLogTypeHasZone		8
+
+static CC3MallocLogger* _previousMallocLogger = NULL;
+static pthread_t _allocationTrackingThread = NULL;
+static volatile BOOL _isAllocationTrackingActive = NO;
+static NSUInteger _allocationCount = 0;
+static NSUInteger _allocatedBytes = 0;
+
+/**
+ * Counts each allocation made by the tracked thread. Invoked by the system allocator on every
+ * thread, so this function must not allocate, and must not access thread-local storage.
+ */
+static void CC3AllocationLogger(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3,
+								uintptr_t result, uint32_t numHotFramesToSkip) {
+	if (_previousMallocLogger) _previousMallocLogger(type, arg1, arg2, arg3, result, numHotFramesToSkip + 1);
+
+	uint32_t zoneAlloc = kCC3MallocLogTypeAllocate | kCC3MallocLogTypeHasZone;
+	if ( (type & zoneAlloc) != zoneAlloc ) return;
+	if ( !_isAllocationTrackingActive || !pthread_equal(pthread_self(), _allocationTrackingThread) ) return;
+
+	// arg1 is the zone. A reallocation passes the old memory in arg2 and the new size in arg3.
+	_allocationCount++;
+	_allocatedBytes += (type & kCC3MallocLogTypeDeallocate) ? arg3 : arg2;
+}
+
+void CC3AllocationTrackingStart(void) {
+	_allocationTrackingThread = pthread_self();
+	if (malloc_logger != CC3AllocationLogger) {
+		_previousMallocLogger = malloc_logger;
+		malloc_logger = CC3AllocationLogger;
+	}
+	_isAllocationTrackingActive = YES;
+}
+
+void CC3AllocationTrackingStop(void) {
+	_isAllocationTrackingActive = NO;
+	if (malloc_logger == CC3AllocationLogger) malloc_logger = _previousMallocLogger;
+	_previousMallocLogger = NULL;
+}
+
+BOOL CC3AllocationTrackingIsActive(void) { return _isAllocationTrackingActive; }
+
+NSUInteger CC3AllocationCount(void) { return _allocationCount; }
+
+NSUInteger CC3AllocatedBytes(void) { return _allocatedBytes; }
+
+#else
+
+void CC3AllocationTrackingStart(void) {}
+
+void CC3AllocationTrackingStop(void) {}
+
+BOOL CC3AllocationTrackingIsActive(void) { return NO; }
+
+NSUInteger CC3AllocationCount(void) { return 0; }
+
+NSUInteger CC3AllocatedBytes(void) { return 0; }
+
+#endif	// CC3_ALLOCATION_TRACKING_ENABLED && defined(__APPLE__)
+
+/** Compares two GLfloats for sorting with qsort. */
+static int CC3PerformanceSampleCompare(const void* s1, const void* s2) {
+	GLfloat f1 = *(const GLfloat*)s1;
+	GLfloat f2 = *(const GLfloat*)s2;
+	return (f1 < f2) ? -1 : ((f1 > f2) ? 1 : 0);
+}
 
 
 #pragma mark -
@@ -42,6 +188,14 @@
 @synthesize framesHandled=_framesHandled, accumulatedFrameTime=_accumulatedFrameTime;
 @synthesize nodesDrawn=_nodesDrawn, nodesVisitedForDrawing=_nodesVisitedForDrawing;
 @synthesize drawingCallsMade=_drawingCallsMade, facesPresented=_facesPresented;
+@synthesize backgroundTasksStarted=_backgroundTasksStarted;
+@synthesize accumulatedBackgroundTaskLatency=_accumulatedBackgroundTaskLatency;
+@synthesize peakBackgroundTaskLatency=_peakBackgroundTaskLatency;
+@synthesize peakBackgroundTaskQueueDepth=_peakBackgroundTaskQueueDepth;
+@synthesize shadowVolumesBuilt=_shadowVolumesBuilt, shadowFacesClassified=_shadowFacesClassified;
+@synthesize shadowSilhouetteEdges=_shadowSilhouetteEdges;
+@synthesize shadowVolumesReused=_shadowVolumesReused, shadowSilhouettesReused=_shadowSilhouettesReused;
+@synthesize accumulatedShadowBuildTime=_accumulatedShadowBuildTime;
 
 
 #pragma mark Accumulated update statistics
@@ -85,6 +239,140 @@
 }
 
 
+#pragma mark Accumulated background task statistics
+
+-(void) addBackgroundTasksStarted: (GLuint) taskCount
+					  withLatency: (CCTime) totalLatency
+				   andPeakLatency: (CCTime) peakLatency {
+	_backgroundTasksStarted += taskCount;
+	_accumulatedBackgroundTaskLatency += totalLatency;
+	_peakBackgroundTaskLatency = MAX(_peakBackgroundTaskLatency, peakLatency);
+}
+
+-(void) addBackgroundTaskQueueDepth: (GLuint) queueDepth {
+	_accumulatedBackgroundTaskQueueDepth += queueDepth;
+	_peakBackgroundTaskQueueDepth = MAX(_peakBackgroundTaskQueueDepth, queueDepth);
+}
+
+
+#pragma mark Accumulated shadow volume statistics
+
+-(void) addShadowVolumeBuildWithFacesClassified: (GLuint) faceCount
+								silhouetteEdges: (GLuint) edgeCount
+									   duration: (CCTime) buildTime {
+	_shadowVolumesBuilt++;
+	_shadowFacesClassified += faceCount;
+	_shadowSilhouetteEdges += edgeCount;
+	_accumulatedShadowBuildTime += buildTime;
+}
+
+-(void) incrementShadowVolumesReused { _shadowVolumesReused++; }
+
+-(void) incrementShadowSilhouettesReused { _shadowSilhouettesReused++; }
+
+
+#pragma mark Accumulated phase timing statistics
+
+-(void) beginPhase: (CC3PerformancePhase) phase {
+	CC3Assert(phase < kCC3PerformancePhaseCount, @"%@ cannot time unknown phase %u", self, phase);
+	CC3PerformancePhaseTiming* timing = &_phaseTimings[phase];
+	if (timing->depth++ == 0) {
+#if CC3_ALLOCATION_TRACKING_ENABLED
+		timing->startAllocationCount = CC3AllocationCount();
+		timing->startAllocatedBytes = CC3AllocatedBytes();
+#endif
+		timing->startTime = CC3PerformanceTimestamp();
+	}
+}
+
+-(void) endPhase: (CC3PerformancePhase) phase {
+	CC3Assert(phase < kCC3PerformancePhaseCount, @"%@ cannot time unknown phase %u", self, phase);
+	CC3PerformancePhaseTiming* timing = &_phaseTimings[phase];
+	CC3Assert(timing->depth > 0, @"%@ ended phase %@ that was not begun", self, NSStringFromCC3PerformancePhase(phase));
+	if (--timing->depth == 0) {
+		[self addDuration: (CC3PerformanceTimestamp() - timing->startTime) toPhase: phase];
+#if CC3_ALLOCATION_TRACKING_ENABLED
+		timing->allocationCount += CC3AllocationCount() - timing->startAllocationCount;
+		timing->allocatedBytes += CC3AllocatedBytes() - timing->startAllocatedBytes;
+#endif
+	}
+}
+
+-(void) addDuration: (CCTime) duration toPhase: (CC3PerformancePhase) phase {
+	CC3PerformancePhaseTiming* timing = &_phaseTimings[phase];
+	timing->minimumDuration = timing->count ? MIN(timing->minimumDuration, duration) : duration;
+	timing->maximumDuration = MAX(timing->maximumDuration, duration);
+	timing->totalDuration += duration;
+	timing->samples[timing->count % kCC3PerformancePhaseSampleCapacity] = duration;
+	timing->count++;
+}
+
+-(GLuint) countOfPhase: (CC3PerformancePhase) phase { return _phaseTimings[phase].count; }
+
+-(CCTime) totalDurationOfPhase: (CC3PerformancePhase) phase { return _phaseTimings[phase].totalDuration; }
+
+-(CCTime) minimumDurationOfPhase: (CC3PerformancePhase) phase { return _phaseTimings[phase].minimumDuration; }
+
+-(CCTime) maximumDurationOfPhase: (CC3PerformancePhase) phase { return _phaseTimings[phase].maximumDuration; }
+
+-(CCTime) averageDurationOfPhase: (CC3PerformancePhase) phase {
+	CC3PerformancePhaseTiming* timing = &_phaseTimings[phase];
+	return timing->count ? (timing->totalDuration / timing->count) : 0.0;
+}
+
+-(CCTime) durationOfPhase: (CC3PerformancePhase) phase atPercentile: (GLfloat) percentile {
+	CC3PerformancePhaseTiming* timing = &_phaseTimings[phase];
+	GLuint sampleCnt = MIN(timing->count, kCC3PerformancePhaseSampleCapacity);
+	if ( !sampleCnt ) return 0.0;
+
+	GLfloat samples[kCC3PerformancePhaseSampleCapacity];
+	memcpy(samples, timing->samples, sampleCnt * sizeof(GLfloat));
+	qsort(samples, sampleCnt, sizeof(GLfloat), CC3PerformanceSampleCompare);
+
+	GLint rank = (GLint)ceilf(CLAMP(percentile, 0.0f, 100.0f) * 0.01f * sampleCnt);
+	return samples[CLAMP(rank - 1, 0, (GLint)sampleCnt - 1)];
+}
+
+-(NSUInteger) allocationCountOfPhase: (CC3PerformancePhase) phase { return _phaseTimings[phase].allocationCount; }
+
+-(NSUInteger) allocatedBytesOfPhase: (CC3PerformancePhase) phase { return _phaseTimings[phase].allocatedBytes; }
+
+-(GLfloat) averageAllocationCountOfPhase: (CC3PerformancePhase) phase {
+	CC3PerformancePhaseTiming* timing = &_phaseTimings[phase];
+	return timing->count ? ((GLfloat)timing->allocationCount / (GLfloat)timing->count) : 0.0;
+}
+
+/** Appends a line describing the specified phase, and then its child phases, to the specified description. */
+-(void) appendPhase: (CC3PerformancePhase) phase atDepth: (GLuint) depth toDescription: (NSMutableString*) desc {
+	if (_phaseTimings[phase].count) {
+		[desc appendFormat: @"\n\t%@%@: count %u, min %.3f, avg %.3f, max %.3f, p50 %.3f, p95 %.3f, p99 %.3f ms",
+		 [@"" stringByPaddingToLength: (depth * 2) withString: @" " startingAtIndex: 0],
+		 NSStringFromCC3PerformancePhase(phase), _phaseTimings[phase].count,
+		 [self minimumDurationOfPhase: phase] * 1000.0,
+		 [self averageDurationOfPhase: phase] * 1000.0,
+		 [self maximumDurationOfPhase: phase] * 1000.0,
+		 [self durationOfPhase: phase atPercentile: 50] * 1000.0,
+		 [self durationOfPhase: phase atPercentile: 95] * 1000.0,
+		 [self durationOfPhase: phase atPercentile: 99] * 1000.0];
+#if CC3_ALLOCATION_TRACKING_ENABLED
+		[desc appendFormat: @", allocs %lu (%lu bytes)",
+		 (unsigned long)_phaseTimings[phase].allocationCount, (unsigned long)_phaseTimings[phase].allocatedBytes];
+#endif
+	}
+	for (GLuint childPhase = 0; childPhase < kCC3PerformancePhaseCount; childPhase++)
+		if (CC3PerformancePhaseParent(childPhase) == phase)
+			[self appendPhase: childPhase atDepth: (depth + 1) toDescription: desc];
+}
+
+-(NSString*) phaseDescription {
+	NSMutableString* desc = [NSMutableString stringWithCapacity: 500];
+	for (GLuint phase = 0; phase < kCC3PerformancePhaseCount; phase++)
+		if (CC3PerformancePhaseParent(phase) == kCC3PerformancePhaseCount)
+			[self appendPhase: phase atDepth: 0 toDescription: desc];
+	return desc;
+}
+
+
 #pragma mark Averaged update statistics
 
 -(GLfloat) updateRate {
@@ -100,6 +388,24 @@
 }
 
 
+#pragma mark Average background task statistics
+
+-(GLfloat) averageBackgroundTaskLatency {
+	return _backgroundTasksStarted ? (_accumulatedBackgroundTaskLatency / (GLfloat)_backgroundTasksStarted) : 0.0;
+}
+
+-(GLfloat) averageBackgroundTaskQueueDepth {
+	return _updatesHandled ? ((GLfloat)_accumulatedBackgroundTaskQueueDepth / (GLfloat)_updatesHandled) : 0.0;
+}
+
+
+#pragma mark Average shadow volume statistics
+
+-(GLfloat) averageShadowBuildTime {
+	return _shadowVolumesBuilt ? (_accumulatedShadowBuildTime / (GLfloat)_shadowVolumesBuilt) : 0.0;
+}
+
+
 #pragma mark Average frame drawing statistics
 
 -(GLfloat) frameRate {
@@ -146,6 +452,33 @@
 	_nodesDrawn = 0;
 	_drawingCallsMade = 0;
 	_facesPresented = 0;
+	
+	_backgroundTasksStarted = 0;
+	_accumulatedBackgroundTaskLatency = 0.0;
+	_peakBackgroundTaskLatency = 0.0;
+	_accumulatedBackgroundTaskQueueDepth = 0;
+	_peakBackgroundTaskQueueDepth = 0;
+	
+	_shadowVolumesBuilt = 0;
+	_shadowFacesClassified = 0;
+	_shadowSilhouetteEdges = 0;
+	_shadowVolumesReused = 0;
+	_shadowSilhouettesReused = 0;
+	_accumulatedShadowBuildTime = 0.0;
+	
+	// Phases currently being timed remain open across a reset
+	for (GLuint phase = 0; phase < kCC3PerformancePhaseCount; phase++) {
+		CC3PerformancePhaseTiming* timing = &_phaseTimings[phase];
+		GLuint depth = timing->depth;
+		CCTime startTime = timing->startTime;
+		NSUInteger startAllocCnt = timing->startAllocationCount;
+		NSUInteger startAllocBytes = timing->startAllocatedBytes;
+		memset(timing, 0, sizeof(CC3PerformancePhaseTiming));
+		timing->depth = depth;
+		timing->startTime = startTime;
+		timing->startAllocationCount = startAllocCnt;
+		timing->startAllocatedBytes = startAllocBytes;
+	}
 }
 
 -(void) populateFrom: (CC3PerformanceStatistics*) another {
@@ -160,6 +493,20 @@
 	_nodesDrawn = another.nodesDrawn;
 	_drawingCallsMade = another.drawingCallsMade;
 	_facesPresented = another.facesPresented;
+	
+	_backgroundTasksStarted = another.backgroundTasksStarted;
+	_accumulatedBackgroundTaskLatency = another.accumulatedBackgroundTaskLatency;
+	_peakBackgroundTaskLatency = another.peakBackgroundTaskLatency;
+	_accumulatedBackgroundTaskQueueDepth = another->_accumulatedBackgroundTaskQueueDepth;
+	_peakBackgroundTaskQueueDepth = another.peakBackgroundTaskQueueDepth;
+	
+	_shadowVolumesBuilt = another.shadowVolumesBuilt;
+	_shadowFacesClassified = another.shadowFacesClassified;
+	_shadowSilhouetteEdges = another.shadowSilhouetteEdges;
+	_shadowVolumesReused = another.shadowVolumesReused;
+	_shadowSilhouettesReused = another.shadowSilhouettesReused;
+	memcpy(_phaseTimings, another->_phaseTimings, sizeof(_phaseTimings));
+	_accumulatedShadowBuildTime = another.accumulatedShadowBuildTime;
 }
 
 -(id) copyWithZone: (NSZone*) zone {
@@ -173,9 +520,10 @@
 }
 
 -(NSString*) fullDescription {
-	return [NSString stringWithFormat: @"%@ nodes drawn: %.0f, GL calls: %.0f, faces: %.0f",
+	return [NSString stringWithFormat: @"%@ nodes drawn: %.0f, GL calls: %.0f, faces: %.0f%@",
 			self.description, self.averageNodesDrawnPerFrame,
-			self.averageDrawingCallsMadePerFrame, self.averageFacesPresentedPerFrame];
+			self.averageDrawingCallsMadePerFrame, self.averageFacesPresentedPerFrame,
+			self.phaseDescription];
 }
 
 @end
@@ -194,6 +542,19 @@
 	return CLAMP((GLint)(1.0 / deltaTime), 0, kCC3RateHistogramSize - 1);
 }
 
+-(GLint*) histogramForPhase: (CC3PerformancePhase) phase { return _phaseHistograms[phase]; }
+
+/** Returns the index of the phase histogram bucket that counts the specified duration. */
+-(GLint) getIndexOfPhaseDuration: (CCTime) duration {
+	CCTime micros = duration * 1.0e6;
+	if (micros <= 1.0) return 0;
+	return CLAMP((GLint)(log2(micros) * 4.0), 0, kCC3PhaseHistogramSize - 1);
+}
+
+-(CCTime) durationOfPhaseHistogramBucket: (GLint) bucketIndex {
+	return (bucketIndex > 0) ? (exp2(bucketIndex * 0.25) * 1.0e-6) : 0.0;
+}
+
 
 #pragma mark Accumulated update statistics
 
@@ -211,18 +572,28 @@
 }
 
 
+#pragma mark Accumulated phase timing statistics
+
+-(void) addDuration: (CCTime) duration toPhase: (CC3PerformancePhase) phase {
+	[super addDuration: duration toPhase: phase];
+	_phaseHistograms[phase][[self getIndexOfPhaseDuration: duration]]++;
+}
+
+
 #pragma mark Allocation and initialization
 
 -(void) reset {
 	[super reset];
 	memset(_frameRateHistogram, 0, kCC3RateHistogramSize * sizeof(_frameRateHistogram[0]));
 	memset(_updateRateHistogram, 0, kCC3RateHistogramSize * sizeof(_updateRateHistogram[0]));
+	memset(_phaseHistograms, 0, sizeof(_phaseHistograms));
 }
 
 -(void) populateFrom: (CC3PerformanceStatisticsHistogram*) another {
 	[super populateFrom: another];
 	memcpy(_frameRateHistogram, another.frameRateHistogram, kCC3RateHistogramSize * sizeof(_frameRateHistogram[0]));
 	memcpy(_updateRateHistogram, another.updateRateHistogram, kCC3RateHistogramSize * sizeof(_updateRateHistogram[0]));
+	memcpy(_phaseHistograms, another->_phaseHistograms, sizeof(_phaseHistograms));
 }
 
 -(NSString*) fullDescription {
@@ -234,8 +605,189 @@
 		GLint upsCount = _updateRateHistogram[i];
 		if (fpsCount || upsCount) [desc appendFormat: @"\n\t%u\t%u\t%u", i, fpsCount, upsCount];
 	}
+	[desc appendString: self.phaseDescription];
+	for (GLuint phase = 0; phase < kCC3PerformancePhaseCount; phase++) {
+		if ( ![self countOfPhase: phase] ) continue;
+		[desc appendFormat: @"\n\t%@ ms\tCount", NSStringFromCC3PerformancePhase(phase)];
+		for (GLint i = 0; i < kCC3PhaseHistogramSize; i++) {
+			GLint phaseCount = _phaseHistograms[phase][i];
+			if (phaseCount) [desc appendFormat: @"\n\t%.3f\t%u", [self durationOfPhaseHistogramBucket: i] * 1000.0, phaseCount];
+		}
+	}
 	return desc;
 }
 
 @end
 
+
+
+#pragma mark -
+#pragma mark Trace events
+
+/** A single recorded trace event. */
+typedef struct {
+	volatile int64_t sequence;					/**< One more than the index of the event, or zero while being written. */
+	CCTime timestamp;							/**< The time of the event, relative to the start of recording. */
+	uint64_t threadID;							/**< The ID of the thread on which the event was recorded. */
+	const char* name;							/**< The name of the event. */
+	const char* category;						/**< The category of the event. */
+	char phase;									/**< The trace event phase ('B' or 'E'). */
+	char detail[kCC3TraceEventDetailLength];	/**< Optional detail text. */
+} CC3TraceEvent;
+
+/** The ring buffer holding recorded trace events. */
+typedef struct {
+	volatile int64_t eventCount;				/**< The total number of events recorded. */
+	GLuint capacity;							/**< The number of events that can be held. */
+	CC3TraceEvent events[];						/**< The events, indexed by event index modulo capacity. */
+} CC3TraceBuffer;
+
+volatile BOOL CC3TraceIsRecording = NO;
+
+static CC3TraceBuffer* volatile _traceBuffer = NULL;
+static CCTime _traceStartTime = 0.0;
+static uint64_t _traceMainThreadID = 0;
+
+/** Returns the ID of the current thread, as presented by the operating system. */
+static uint64_t CC3TraceCurrentThreadID(void) {
+	static __thread uint64_t threadID = 0;
+	if ( !threadID ) {
+#if defined(__APPLE__)
+		pthread_threadid_np(NULL, &threadID);
+#else
+		threadID = (uint64_t)syscall(SYS_gettid);
+#endif
+	}
+	return threadID;
+}
+
+void CC3TraceStartRecording(GLuint capacity) {
+	CC3TraceIsRecording = NO;
+	if ( !capacity ) capacity = kCC3TraceDefaultCapacity;
+
+	// An existing buffer is reused if large enough. A buffer that is too small is not freed,
+	// since a thread that tested the recording flag just before it was cleared may still be
+	// writing to it.
+	CC3TraceBuffer* buffer = _traceBuffer;
+	if ( !buffer || buffer->capacity < capacity ) {
+		buffer = calloc(1, sizeof(CC3TraceBuffer) + (capacity * sizeof(CC3TraceEvent)));
+		CC3AssertC(buffer, @"Could not allocate a trace event buffer holding %u events", capacity);
+		buffer->capacity = capacity;
+		_traceBuffer = buffer;
+	}
+	for (GLuint evtIdx = 0; evtIdx < buffer->capacity; evtIdx++) buffer->events[evtIdx].sequence = 0;
+	buffer->eventCount = 0;
+
+	_traceStartTime = CC3PerformanceTimestamp();
+	_traceMainThreadID = CC3TraceCurrentThreadID();
+	__sync_synchronize();
+	CC3TraceIsRecording = YES;
+}
+
+void CC3TraceStopRecording(void) { CC3TraceIsRecording = NO; }
+
+void CC3TraceRecordEvent(char phase, const char* name, const char* category, const char* detail) {
+	CC3TraceBuffer* buffer = _traceBuffer;
+	if ( !buffer ) return;
+
+	// Reserve the next slot, and mark it as being written until the event is complete
+	int64_t evtIdx = __sync_fetch_and_add(&buffer->eventCount, 1);
+	CC3TraceEvent* evt = &buffer->events[evtIdx % buffer->capacity];
+	evt->sequence = 0;
+	__sync_synchronize();
+
+	evt->timestamp = CC3PerformanceTimestamp() - _traceStartTime;
+	evt->threadID = CC3TraceCurrentThreadID();
+	evt->name = name;
+	evt->category = category;
+	evt->phase = phase;
+	if (detail) {
+		strncpy(evt->detail, detail, kCC3TraceEventDetailLength - 1);
+		evt->detail[kCC3TraceEventDetailLength - 1] = 0;
+	} else {
+		evt->detail[0] = 0;
+	}
+
+	__sync_synchronize();
+	evt->sequence = evtIdx + 1;
+}
+
+/** Writes the specified C string to the specified file as a JSON string, including quotes. */
+static void CC3TraceWriteJSONString(FILE* file, const char* str) {
+	fputc('"', file);
+	for (const char* pc = (str ? str : ""); *pc; pc++) {
+		unsigned char c = *pc;
+		if (c == '"' || c == '\\')
+			fprintf(file, "\\%c", c);
+		else if (c < 0x20)
+			fprintf(file, "\\u%04x", c);
+		else
+			fputc(c, file);
+	}
+	fputc('"', file);
+}
+
+BOOL CC3TraceWriteToFile(NSString* filePath) {
+	CC3TraceBuffer* buffer = _traceBuffer;
+	if ( !buffer ) {
+		LogError(@"No trace events have been recorded to write to %@", filePath);
+		return NO;
+	}
+
+	FILE* file = fopen(filePath.fileSystemRepresentation, "w");
+	if ( !file ) {
+		LogError(@"Could not open %@ to write trace events", filePath);
+		return NO;
+	}
+
+	int pid = getpid();
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%llu,\"args\":{\"name\":\"Main\"}}",
+			pid, (unsigned long long)_traceMainThreadID);
+
+	// Track the begin-end nesting of each thread, so that end events whose begin
+	// events have been overwritten in the ring buffer can be dropped.
+	NSMutableDictionary* threadDepths = [NSMutableDictionary dictionary];
+
+	int64_t evtCount = buffer->eventCount;
+	int64_t firstIdx = MAX(evtCount - (int64_t)buffer->capacity, 0);
+	for (int64_t evtIdx = firstIdx; evtIdx < evtCount; evtIdx++) {
+		CC3TraceEvent* slot = &buffer->events[evtIdx % buffer->capacity];
+
+		// Copy the event, and skip it if it was being written, or was overwritten while being copied
+		if (slot->sequence != evtIdx + 1) continue;
+		__sync_synchronize();
+		CC3TraceEvent evt = *slot;
+		__sync_synchronize();
+		if (slot->sequence != evtIdx + 1) continue;
+
+		NSNumber* tidKey = [NSNumber numberWithUnsignedLongLong: evt.threadID];
+		NSInteger depth = [[threadDepths objectForKey: tidKey] integerValue];
+		if (evt.phase == 'E') {
+			if (depth == 0) continue;
+			depth--;
+		} else {
+			depth++;
+		}
+		[threadDepths setObject: [NSNumber numberWithInteger: depth] forKey: tidKey];
+
+		fprintf(file, ",\n{\"name\":");
+		CC3TraceWriteJSONString(file, evt.name);
+		fprintf(file, ",\"cat\":");
+		CC3TraceWriteJSONString(file, evt.category);
+		fprintf(file, ",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,\"tid\":%llu",
+				evt.phase, evt.timestamp * 1.0e6, pid, (unsigned long long)evt.threadID);
+		if (evt.detail[0]) {
+			fprintf(file, ",\"args\":{\"detail\":");
+			CC3TraceWriteJSONString(file, evt.detail);
+			fprintf(file, "}");
+		}
+		fprintf(file, "}");
+	}
+	fprintf(file, "\n]}\n");
+
+	BOOL wasWritten = !ferror(file);
+	wasWritten = (fclose(file) == 0) && wasWritten;
+	LogErrorIf(!wasWritten, @"Could not write trace events to %@", filePath);
+	return wasWritten;
+}